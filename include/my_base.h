@@ -104,6 +104,15 @@ enum ha_storage_media {
   HA_SM_MEMORY=         2		/* MAIN MEMORY storage */
 };
 
+        /* Column formats, COLUMN_FORMAT of a column definition */
+
+enum column_format_type {
+  COLUMN_FORMAT_TYPE_DEFAULT=    0,	/* Not specified (engine default) */
+  COLUMN_FORMAT_TYPE_FIXED=      1,	/* FIXED format */
+  COLUMN_FORMAT_TYPE_DYNAMIC=    2,	/* DYNAMIC format */
+  COLUMN_FORMAT_TYPE_COMPRESSED= 3	/* COMPRESSED format */
+};
+
 	/* The following is parameter to ha_extra() */
 
 enum ha_extra_function {
@@ -194,7 +203,12 @@ enum ha_extra_function {
   HA_EXTRA_ADD_CHILDREN_LIST,
   HA_EXTRA_ATTACH_CHILDREN,
   HA_EXTRA_IS_ATTACHED_CHILDREN,
-  HA_EXTRA_DETACH_CHILDREN
+  HA_EXTRA_DETACH_CHILDREN,
+  /*
+    Prepare the table for FLUSH TABLES ... FOR EXPORT: make its files
+    consistent for copying while the table stays read locked.
+  */
+  HA_EXTRA_EXPORT
 };
 
 /* Compatible option, to be deleted in 6.0 */
@@ -549,6 +563,15 @@ typedef struct st_key_multi_range
 } KEY_MULTI_RANGE;
 
 
+/* Result of an index condition check done by the storage engine */
+
+typedef enum icp_result {
+  ICP_NO_MATCH,                 /* The row does not satisfy the condition */
+  ICP_MATCH,                    /* The row satisfies the condition */
+  ICP_OUT_OF_RANGE              /* The row is beyond the end of the range */
+} ICP_RESULT;
+
+
 /* For number of records */
 #ifdef BIG_TABLES
 #define rows2double(A)	ulonglong2double(A)
@@ -119,6 +119,7 @@ enum enum_server_command
                                            reserved by MySQL Cluster */
 #define FIELD_FLAGS_COLUMN_FORMAT 24    /* Field column format, bit 24-25,
                                            reserved by MySQL Cluster */
+#define FIELD_FLAGS_COLUMN_FORMAT_MASK (3 << FIELD_FLAGS_COLUMN_FORMAT)
 
 #define REFRESH_GRANT		1	/* Refresh grant tables */
 #define REFRESH_LOG		2	/* Start on new log file */
@@ -146,6 +147,7 @@ enum enum_server_command
 #define REFRESH_QUERY_CACHE_FREE 0x20000L /* pack query cache */
 #define REFRESH_DES_KEY_FILE	0x40000L
 #define REFRESH_USER_RESOURCES	0x80000L
+#define REFRESH_FOR_EXPORT	0x100000L /* FLUSH TABLES ... FOR EXPORT */
 #define REFRESH_TABLE_STATS    0x200000L /* Refresh table stats my_hash table */
 #define REFRESH_INDEX_STATS    0x400000L /* Refresh index stats my_hash table */
 #define REFRESH_USER_STATS     0x800000L /* Refresh user stats my_hash table */
@@ -0,0 +1,1505 @@
+/* Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Handler socket: a daemon plugin that serves simple key lookups and
+  modifications over its own TCP port.
+
+  Requests bypass the parser and the optimizer and go straight to the
+  handler interface of the opened tables.  They run with the privileges
+  of the account named by handler_socket_user, and the system schemas
+  cannot be opened.  The requests between a B and a C line form a batch:
+  the tables of a batch are opened and locked once, every request is run
+  through the handler, and the statement is committed once.  Any other
+  request runs alone.  The rows are binary logged as row events.  See
+  README for the protocol.
+*/
+
+#define MYSQL_SERVER 1
+#include "sql_priv.h"
+#include "unireg.h"
+#include "sql_class.h"                          // THD
+#include "sql_base.h"                           // open_and_lock_tables
+#include "sql_cache.h"                          // query_cache_invalidate3
+#include "transaction.h"                        // trans_commit_stmt
+#include "key.h"                                // key_copy
+#include "log.h"                                // sql_print_error
+#include "mysqld.h"                             // LOCK_thread_count
+#include "sql_acl.h"                            // acl_getroot, *_ACL
+#include "sql_parse.h"                          // check_table_access
+#include <mysql/plugin.h>
+
+#include <sys/socket.h>
+#include <netdb.h>
+#include <poll.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/** Milliseconds a thread waits on its socket before it checks for
+shutdown */
+#define HS_POLL_TIMEOUT 1000
+/** Bytes read from a socket at a time */
+#define HS_READ_SIZE 16384
+/** Number of index ids a connection can open */
+#define HS_MAX_INDEXES 256
+
+/** Error codes of the protocol */
+#define HS_ERR_REQUEST 1                        /* malformed request */
+#define HS_ERR_HANDLER 2                        /* table or handler error */
+
+/** Privileges of which any one lets a table be opened with P */
+#define HS_OPEN_ACL (SELECT_ACL | INSERT_ACL | UPDATE_ACL | DELETE_ACL)
+
+/* Plugin variables */
+static uint hs_port;
+static char *hs_address;
+static uint hs_max_connections;
+static char *hs_user;
+static char *hs_secret;
+
+/** User and host parts of handler_socket_user */
+static char hs_user_name[USERNAME_LENGTH + 1];
+static char hs_user_host[HOSTNAME_LENGTH + 1];
+
+/** Actual port the listener is bound to */
+static ulong hs_listen_port;
+
+/** Request counters, protected by LOCK_handler_socket */
+struct hs_stats_t
+{
+  ulonglong connections;
+  ulonglong batches;
+  ulonglong batch_time;
+  ulonglong errors;
+  ulonglong gets, get_time;
+  ulonglong puts, put_time;
+  ulonglong updates, update_time;
+  ulonglong deletes, delete_time;
+};
+
+static hs_stats_t hs_stats;
+
+/** An index opened with the P request */
+struct hs_index
+{
+  char db[NAME_LEN + 1];
+  char table_name[NAME_LEN + 1];
+  char key_name[NAME_LEN + 1];
+  char *columns;                 /* column names, NUL separated */
+  uint n_fields;
+  uint *fields;                  /* field numbers of the columns */
+  uint keynr;
+  ulong table_map_id;            /* share the numbers belong to, or 0 */
+  TABLE_LIST *table_list;        /* table of the current batch */
+  bool write;                    /* current batch modifies the table */
+  ulong want_access;             /* privileges the current batch needs */
+};
+
+/** A client connection and the thread that serves it */
+struct hs_conn
+{
+  hs_conn *next;
+  pthread_t thread;
+  int fd;
+  bool finished;                 /* protected by LOCK_handler_socket */
+  bool authenticated;            /* the secret was sent, or none is set */
+  THD *thd;
+  String in;                     /* unprocessed input */
+  String out;                    /* responses not yet sent */
+  hs_index *indexes[HS_MAX_INDEXES];
+
+  hs_conn() : next(NULL), fd(-1), finished(FALSE), authenticated(FALSE),
+              thd(NULL)
+  {
+    bzero(indexes, sizeof(indexes));
+  }
+};
+
+/** A field of a request line; str is NULL for SQL NULL */
+struct hs_field
+{
+  char *str;
+  size_t len;
+};
+
+enum hs_request_type
+{
+  HS_OPEN, HS_FIND, HS_INSERT
+};
+
+/** A parsed request line */
+struct hs_request
+{
+  enum hs_request_type type;
+  const char *error;             /* parse error, or NULL */
+  uint index_id;
+  char op;                       /* '=', '>', '<', 'G' (>=) or 'L' (<=) */
+  uint n_keys;
+  hs_field *keys;
+  ulong limit;
+  ulong offset;
+  char mod;                      /* 0, 'U' or 'D' */
+  uint n_values;
+  hs_field *values;
+};
+
+static int hs_listen_fd= -1;
+static pthread_t hs_listener_thread;
+static volatile bool hs_shutdown;
+
+/** Protects hs_conns, hs_n_conns and hs_stats */
+static mysql_mutex_t LOCK_handler_socket;
+static hs_conn *hs_conns;
+static uint hs_n_conns;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_handler_socket;
+
+static PSI_mutex_info all_handler_socket_mutexes[]=
+{
+  { &key_LOCK_handler_socket, "LOCK_handler_socket", PSI_FLAG_GLOBAL}
+};
+
+static void init_handler_socket_psi_keys(void)
+{
+  const char* category= "handler_socket";
+  int count;
+
+  if (PSI_server == NULL)
+    return;
+
+  count= array_elements(all_handler_socket_mutexes);
+  PSI_server->register_mutex(category, all_handler_socket_mutexes, count);
+}
+#endif /* HAVE_PSI_INTERFACE */
+
+
+/*
+  Encoding of fields.
+
+  Fields are separated by TAB and requests by LF.  A byte below 0x10 is
+  written as 0x01 followed by the byte plus 0x40, and a field that
+  consists of a single 0x00 byte is NULL.
+*/
+
+static void hs_append_escaped(String *out, const char *str, size_t len)
+{
+  const char *end= str + len;
+
+  for (const char *start= str; str < end; str++)
+  {
+    if ((uchar) *str < 0x10)
+    {
+      char esc[2]= { 0x01, (char) (*str + 0x40) };
+      out->append(start, str - start);
+      out->append(esc, 2);
+      start= str + 1;
+    }
+    if (str + 1 == end)
+      out->append(start, end - start);
+  }
+}
+
+
+static void hs_append_field(String *out, Field *field, String *buf)
+{
+  out->append('\t');
+  if (field->is_null())
+    out->append('\0');
+  else
+  {
+    String *val= field->val_str(buf, buf);
+    hs_append_escaped(out, val->ptr(), val->length());
+  }
+}
+
+
+static void hs_append_ulonglong(String *out, ulonglong nr)
+{
+  char buf[22];
+  out->append('\t');
+  out->append(buf, longlong10_to_str(nr, buf, 10) - buf);
+}
+
+
+static void hs_append_error(String *out, uint code, const char *msg)
+{
+  char buf[12];
+  out->append(buf, int10_to_str(code, buf, 10) - buf);
+  out->append(STRING_WITH_LEN("\t1\t"));
+  hs_append_escaped(out, msg, strlen(msg));
+  out->append('\n');
+}
+
+
+/**
+  Split a request line into fields and decode them in place.
+
+  @return number of fields, stored in thd memory at *fields
+*/
+
+static uint hs_split_line(THD *thd, char *line, char *end, hs_field **fields)
+{
+  uint n= 1;
+
+  for (char *p= line; p < end; p++)
+    if (*p == '\t')
+      n++;
+  if (!(*fields= (hs_field*) thd->alloc(n * sizeof(hs_field))))
+    return 0;
+
+  hs_field *f= *fields;
+  f->str= line;
+  for (char *p= line, *to= line;; p++)
+  {
+    if (p == end || *p == '\t')
+    {
+      f->len= to - f->str;
+      if (f->len == 1 && *f->str == '\0')
+        f->str= NULL;
+      if (p == end)
+        break;
+      (++f)->str= to= p + 1;
+    }
+    else if (*p == 0x01 && p + 1 < end)
+      *to++= *++p - 0x40;
+    else
+      *to++= *p;
+  }
+  return n;
+}
+
+
+static bool hs_parse_ulong(const hs_field *f, ulong *nr)
+{
+  ulong val= 0;
+
+  if (!f->str || !f->len || f->len > 9)
+    return TRUE;
+  for (size_t i= 0; i < f->len; i++)
+  {
+    if (!my_isdigit(&my_charset_latin1, f->str[i]))
+      return TRUE;
+    val= val * 10 + f->str[i] - '0';
+  }
+  *nr= val;
+  return FALSE;
+}
+
+
+/**
+  Parse the fields of a find, modify or insert request.
+
+    <id> + <n> <v1> ... <vn>
+    <id> <op> <n> <k1> ... <kn> [<limit> <offset>] [U <v1> ... | D]
+*/
+
+static void hs_parse_request(hs_request *req, hs_field *f, uint n)
+{
+  ulong id, nr;
+
+  req->error= "malformed request";
+  if (n < 3 || hs_parse_ulong(&f[0], &id) || id >= HS_MAX_INDEXES ||
+      !f[1].str || hs_parse_ulong(&f[2], &nr) || nr > n - 3)
+    return;
+  req->index_id= id;
+
+  if (f[1].len == 1 && f[1].str[0] == '+')
+  {
+    req->type= HS_INSERT;
+    req->n_values= nr;
+    req->values= f + 3;
+    if (n == 3 + nr)
+      req->error= NULL;
+    return;
+  }
+
+  req->type= HS_FIND;
+  if (f[1].len == 1 && strchr("=<>", f[1].str[0]))
+    req->op= f[1].str[0];
+  else if (f[1].len == 2 && f[1].str[1] == '=' && strchr("<>", f[1].str[0]))
+    req->op= f[1].str[0] == '>' ? 'G' : 'L';
+  else
+    return;
+  req->n_keys= nr;
+  req->keys= f + 3;
+  req->limit= 1;
+  req->offset= 0;
+  f+= 3 + nr;
+  n-= 3 + nr;
+
+  if (n >= 2 && !hs_parse_ulong(&f[0], &req->limit))
+  {
+    if (hs_parse_ulong(&f[1], &req->offset))
+      return;
+    f+= 2;
+    n-= 2;
+  }
+  if (n)
+  {
+    if (!f[0].str || f[0].len != 1 || !strchr("UD", f[0].str[0]) ||
+        (f[0].str[0] == 'D' && n > 1))
+      return;
+    req->mod= f[0].str[0];
+    req->n_values= n - 1;
+    req->values= f + 1;
+  }
+  if (req->n_keys)
+    req->error= NULL;
+}
+
+
+/**
+  Resolve the key and the column names of an index against the share of
+  the opened table.  This is skipped while the share is unchanged.
+
+  @return error message, or NULL
+*/
+
+static const char *hs_resolve_index(hs_index *idx, TABLE *table)
+{
+  if (idx->table_map_id == table->s->table_map_id)
+    return NULL;
+
+  int keynr= find_type(idx->key_name, &table->s->keynames,
+                       FIND_TYPE_NO_PREFIX) - 1;
+  if (keynr < 0)
+    return "no such index";
+
+  const char *name= idx->columns;
+  for (uint i= 0; i < idx->n_fields; i++, name+= strlen(name) + 1)
+  {
+    Field *field= find_field_in_table_sef(table, name);
+    if (!field)
+      return "no such column";
+    idx->fields[i]= field->field_index;
+  }
+
+  idx->keynr= keynr;
+  idx->table_map_id= table->s->table_map_id;
+  return NULL;
+}
+
+
+static void hs_store_field(Field *field, const hs_field *f)
+{
+  if (!f->str)
+  {
+    field->reset();
+    field->set_null();
+  }
+  else
+  {
+    field->set_notnull();
+    field->store(f->str, f->len, &my_charset_bin);
+  }
+}
+
+
+/**
+  Run an insert request on the opened table.
+
+  @return handler error
+*/
+
+static int hs_run_insert(hs_conn *conn, hs_index *idx, hs_request *req)
+{
+  TABLE *table= idx->table_list->table;
+  int error;
+
+  if (req->n_values > idx->n_fields)
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST, "too many values");
+    return 0;
+  }
+
+  restore_record(table, s->default_values);
+  for (uint i= 0; i < req->n_values; i++)
+    hs_store_field(table->field[idx->fields[i]], &req->values[i]);
+
+  table->next_number_field= table->found_next_number_field;
+  if (!(error= table->file->ha_write_row(table->record[0])))
+  {
+    conn->out.append('0');
+    hs_append_ulonglong(&conn->out, 1);
+    if (table->next_number_field)
+      hs_append_ulonglong(&conn->out, table->next_number_field->val_int());
+    conn->out.append('\n');
+  }
+  table->file->ha_release_auto_increment();
+  table->next_number_field= NULL;
+  return error;
+}
+
+
+/**
+  Run a find request on the opened table, and update or delete the rows
+  found if the request asks for it.
+
+  @return handler error
+*/
+
+static int hs_run_find(hs_conn *conn, hs_index *idx, hs_request *req)
+{
+  THD *thd= conn->thd;
+  TABLE *table= idx->table_list->table;
+  KEY *key_info= table->key_info + idx->keynr;
+  enum ha_rkey_function find_flag;
+  uint key_len= 0;
+  int error;
+
+  if (req->n_keys > key_info->key_parts)
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST, "too many key parts");
+    return 0;
+  }
+  if (req->mod == 'U' && req->n_values > idx->n_fields)
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST, "too many values");
+    return 0;
+  }
+
+  switch (req->op) {
+  case '=': find_flag= HA_READ_KEY_EXACT; break;
+  case 'G': find_flag= HA_READ_KEY_OR_NEXT; break;
+  case '>': find_flag= HA_READ_AFTER_KEY; break;
+  case 'L': find_flag= HA_READ_PREFIX_LAST_OR_PREV; break;
+  default:  find_flag= HA_READ_BEFORE_KEY; break;
+  }
+  if ((req->op == '<' || req->op == 'L') &&
+      !(table->file->index_flags(idx->keynr, 0, 1) & HA_READ_PREV))
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST,
+                    "index does not support reverse scans");
+    return 0;
+  }
+
+  for (uint i= 0; i < req->n_keys; i++)
+  {
+    KEY_PART_INFO *key_part= key_info->key_part + i;
+    hs_store_field(key_part->field, &req->keys[i]);
+    key_len+= key_part->store_length;
+  }
+  uchar *key= (uchar*) thd->alloc(key_len);
+  key_copy(key, table->record[0], key_info, key_len);
+
+  if ((error= table->file->ha_index_init(idx->keynr, 1)))
+    return error;
+
+  size_t start= conn->out.length();
+  ulong skip= req->offset;
+  ulonglong n_rows= 0;
+  char buf[MAX_FIELD_WIDTH];
+  String val(buf, sizeof(buf), &my_charset_bin);
+
+  if (!req->mod)
+  {
+    conn->out.append('0');
+    hs_append_ulonglong(&conn->out, idx->n_fields);
+  }
+
+  for (error= req->limit ?
+         table->file->index_read_map(table->record[0], key,
+                                     make_prev_keypart_map(req->n_keys),
+                                     find_flag) : HA_ERR_END_OF_FILE;;
+       error= req->op == '=' ?
+         table->file->index_next_same(table->record[0], key, key_len) :
+         req->op == '<' || req->op == 'L' ?
+         table->file->index_prev(table->record[0]) :
+         table->file->index_next(table->record[0]))
+  {
+    if (error == HA_ERR_RECORD_DELETED)
+      continue;
+    if (error)
+      break;
+    if (skip)
+    {
+      skip--;
+      continue;
+    }
+
+    if (req->mod == 'D')
+      error= table->file->ha_delete_row(table->record[0]);
+    else if (req->mod == 'U')
+    {
+      store_record(table, record[1]);
+      for (uint i= 0; i < req->n_values; i++)
+        hs_store_field(table->field[idx->fields[i]], &req->values[i]);
+      error= table->file->ha_update_row(table->record[1], table->record[0]);
+      if (error == HA_ERR_RECORD_IS_THE_SAME)
+        error= 0;
+    }
+    else
+    {
+      for (uint i= 0; i < idx->n_fields; i++)
+        hs_append_field(&conn->out, table->field[idx->fields[i]], &val);
+    }
+    if (error || ++n_rows == req->limit)
+      break;
+  }
+  table->file->ha_index_end();
+
+  if (error && error != HA_ERR_KEY_NOT_FOUND && error != HA_ERR_END_OF_FILE)
+  {
+    conn->out.length(start);
+    return error;
+  }
+
+  if (req->mod)
+  {
+    conn->out.append('0');
+    hs_append_ulonglong(&conn->out, 1);
+    hs_append_ulonglong(&conn->out, n_rows);
+  }
+  conn->out.append('\n');
+  return 0;
+}
+
+
+/** Whether a handler error ends the transaction of the batch */
+
+static bool hs_is_fatal(THD *thd, int error)
+{
+  return error == HA_ERR_LOCK_DEADLOCK || error == HA_ERR_LOCK_WAIT_TIMEOUT ||
+         thd->killed || thd->transaction_rollback_request;
+}
+
+
+/**
+  Run a batch of find, insert and modify requests as one statement.
+
+  The tables of the requests are opened and locked together, after the
+  privileges of handler_socket_user on them are checked.  A request that
+  fails with an ordinary handler error, such as a duplicate key, only
+  fails itself.  An error that aborts the transaction rolls back the
+  whole batch and fails every request of it.
+
+  @return TRUE if the batch was rolled back
+*/
+
+static bool hs_run_batch(hs_conn *conn, hs_request *reqs, uint n_reqs)
+{
+  THD *thd= conn->thd;
+  TABLE_LIST *tables= NULL;
+  TABLE_LIST **last= &tables;
+  const char *fatal= NULL;
+  char msg_buf[MYSQL_ERRMSG_SIZE];
+  enum enum_sql_command sql_command= SQLCOM_SELECT;
+  hs_stats_t stats;
+  ulonglong batch_start= my_micro_time();
+  size_t out_start= conn->out.length();
+  DBUG_ENTER("hs_run_batch");
+
+  bzero(&stats, sizeof(stats));
+
+  for (uint i= 0; i < n_reqs; i++)
+  {
+    hs_request *req= &reqs[i];
+    hs_index *idx;
+    if (req->error)
+      continue;
+    if (!(idx= conn->indexes[req->index_id]))
+    {
+      req->error= "index not open";
+      continue;
+    }
+    idx->table_list= NULL;
+    idx->write= FALSE;
+    idx->want_access= 0;
+  }
+
+  for (uint i= 0; i < n_reqs; i++)
+  {
+    hs_request *req= &reqs[i];
+    hs_index *idx;
+    if (req->error)
+      continue;
+    idx= conn->indexes[req->index_id];
+    if (req->type == HS_OPEN)
+      continue;
+    if (req->type == HS_INSERT)
+    {
+      sql_command= SQLCOM_INSERT;
+      idx->want_access|= INSERT_ACL;
+    }
+    else if (!req->mod)
+    {
+      idx->want_access|= SELECT_ACL;
+      continue;
+    }
+    else
+    {
+      if (sql_command == SQLCOM_SELECT)
+        sql_command= SQLCOM_UPDATE;
+      idx->want_access|= SELECT_ACL |
+        (req->mod == 'U' ? UPDATE_ACL : DELETE_ACL);
+    }
+    idx->write= TRUE;
+  }
+
+  lex_start(thd);
+  thd->lex->sql_command= sql_command;
+  thd->set_query_id(next_query_id());
+  thd->warning_info->opt_clear_warning_info(thd->query_id);
+  thd->set_time();
+  thd->reset_current_stmt_binlog_format_row();
+
+  for (uint i= 0; i < n_reqs && !fatal; i++)
+  {
+    hs_request *req= &reqs[i];
+    hs_index *idx;
+    if (req->error)
+      continue;
+    idx= conn->indexes[req->index_id];
+    if (!idx->table_list)
+    {
+      TABLE_LIST *table_list= (TABLE_LIST*) thd->calloc(sizeof(TABLE_LIST));
+      table_list->init_one_table(idx->db, strlen(idx->db),
+                                 idx->table_name, strlen(idx->table_name),
+                                 idx->table_name,
+                                 idx->write ? TL_WRITE : TL_READ);
+      idx->table_list= *last= table_list;
+      table_list->next_local= table_list->next_global= NULL;
+      last= &table_list->next_global;
+
+      /* An open request needs any privilege on the table */
+      if (idx->want_access ?
+          check_table_access(thd, idx->want_access, table_list,
+                             FALSE, 1, FALSE) :
+          check_table_access(thd, HS_OPEN_ACL, table_list,
+                             TRUE, 1, FALSE))
+      {
+        strmake(msg_buf, thd->stmt_da->message(), sizeof(msg_buf) - 1);
+        fatal= msg_buf;
+      }
+    }
+  }
+  for (TABLE_LIST *table_list= tables; table_list;
+       table_list= table_list->next_global)
+    table_list->next_local= table_list->next_global;
+
+  if (!fatal && tables && open_and_lock_tables(thd, tables, FALSE, 0))
+  {
+    strmake(msg_buf, thd->is_error() ? thd->stmt_da->message() :
+            "cannot open tables", sizeof(msg_buf) - 1);
+    fatal= msg_buf;
+  }
+
+  for (uint i= 0; i < n_reqs && !fatal; i++)
+  {
+    hs_request *req= &reqs[i];
+    hs_index *idx;
+    TABLE *table;
+    ulonglong start= my_micro_time();
+    int error= 0;
+
+    if (req->error)
+    {
+      hs_append_error(&conn->out, HS_ERR_REQUEST, req->error);
+      stats.errors++;
+      continue;
+    }
+    idx= conn->indexes[req->index_id];
+    table= idx->table_list->table;
+    table->use_all_columns();
+    if (const char *msg= hs_resolve_index(idx, table))
+    {
+      hs_append_error(&conn->out, HS_ERR_HANDLER, msg);
+      stats.errors++;
+      continue;
+    }
+
+    if (req->type == HS_OPEN)
+    {
+      conn->out.append(STRING_WITH_LEN("0\t1\n"));
+      continue;
+    }
+    if (req->type == HS_INSERT)
+      error= hs_run_insert(conn, idx, req);
+    else
+      error= hs_run_find(conn, idx, req);
+
+    if (error)
+    {
+      table->file->print_error(error, MYF(0));
+      strmake(msg_buf, thd->is_error() ? thd->stmt_da->message() :
+              "handler error", sizeof(msg_buf) - 1);
+      thd->clear_error();
+      if (hs_is_fatal(thd, error))
+      {
+        fatal= msg_buf;
+        break;
+      }
+      hs_append_error(&conn->out, HS_ERR_HANDLER, msg_buf);
+      stats.errors++;
+    }
+
+    ulonglong time= my_micro_time() - start;
+    if (req->type == HS_INSERT)
+      stats.puts++, stats.put_time+= time;
+    else if (req->mod == 'U')
+      stats.updates++, stats.update_time+= time;
+    else if (req->mod == 'D')
+      stats.deletes++, stats.delete_time+= time;
+    else
+      stats.gets++, stats.get_time+= time;
+  }
+
+  if (!fatal && sql_command != SQLCOM_SELECT)
+    query_cache_invalidate3(thd, tables, FALSE);
+
+  if (fatal || thd->is_error())
+    trans_rollback_stmt(thd);
+  else
+    trans_commit_stmt(thd);
+  close_thread_tables(thd);
+  if (thd->transaction_rollback_request)
+    trans_rollback_implicit(thd);
+  thd->mdl_context.release_transactional_locks();
+  thd->clear_error();
+  lex_end(thd->lex);
+  free_root(thd->mem_root, MYF(MY_KEEP_PREALLOC));
+
+  if (fatal)
+  {
+    conn->out.length(out_start);
+    for (uint i= 0; i < n_reqs; i++)
+      hs_append_error(&conn->out, HS_ERR_HANDLER, fatal);
+    stats.errors+= n_reqs;
+  }
+
+  mysql_mutex_lock(&LOCK_handler_socket);
+  hs_stats.batches++;
+  hs_stats.batch_time+= my_micro_time() - batch_start;
+  hs_stats.errors+= stats.errors;
+  hs_stats.gets+= stats.gets;
+  hs_stats.get_time+= stats.get_time;
+  hs_stats.puts+= stats.puts;
+  hs_stats.put_time+= stats.put_time;
+  hs_stats.updates+= stats.updates;
+  hs_stats.update_time+= stats.update_time;
+  hs_stats.deletes+= stats.deletes;
+  hs_stats.delete_time+= stats.delete_time;
+  mysql_mutex_unlock(&LOCK_handler_socket);
+  DBUG_RETURN(fatal != NULL);
+}
+
+
+static void hs_free_index(hs_index *idx)
+{
+  if (idx)
+  {
+    my_free(idx->fields);
+    my_free(idx->columns);
+    my_free(idx);
+  }
+}
+
+
+/**
+  Open an index for later requests.
+
+    P <id> <db> <table> <index> <column>[,<column>...]
+
+  The table is opened once to check the names.
+*/
+
+static void hs_open_index(hs_conn *conn, hs_field *f, uint n)
+{
+  hs_index *idx;
+  ulong id;
+  hs_request req;
+  const char *msg= NULL;
+
+  if (n != 6 || hs_parse_ulong(&f[1], &id) || id >= HS_MAX_INDEXES ||
+      !f[2].str || !f[3].str || !f[4].str || !f[5].str ||
+      f[2].len > NAME_LEN || f[3].len > NAME_LEN || f[4].len > NAME_LEN)
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST, "malformed request");
+    return;
+  }
+
+  hs_free_index(conn->indexes[id]);
+  conn->indexes[id]= NULL;
+  if (!(idx= (hs_index*) my_malloc(sizeof(hs_index), MYF(MY_ZEROFILL))) ||
+      !(idx->columns= (char*) my_malloc(f[5].len + 1, MYF(0))))
+  {
+    my_free(idx);
+    hs_append_error(&conn->out, HS_ERR_HANDLER, "out of memory");
+    return;
+  }
+
+  memcpy(idx->db, f[2].str, f[2].len);
+  memcpy(idx->table_name, f[3].str, f[3].len);
+  memcpy(idx->key_name, f[4].str, f[4].len);
+  memcpy(idx->columns, f[5].str, f[5].len);
+  idx->columns[f[5].len]= '\0';
+  idx->n_fields= 1;
+  for (char *p= idx->columns; *p; p++)
+  {
+    if (*p == ',')
+    {
+      *p= '\0';
+      idx->n_fields++;
+    }
+  }
+
+  LEX_STRING db= { idx->db, f[2].len };
+  if (lower_case_table_names)
+  {
+    my_casedn_str(files_charset_info, idx->db);
+    my_casedn_str(files_charset_info, idx->table_name);
+  }
+  if (check_db_name(&db) || check_table_name(idx->table_name, f[3].len, FALSE))
+    msg= "incorrect table name";
+  else if (!my_strcasecmp(system_charset_info, idx->db,
+                          MYSQL_SCHEMA_NAME.str) ||
+           is_infoschema_db(idx->db) ||
+           !my_strcasecmp(system_charset_info, idx->db,
+                          PERFORMANCE_SCHEMA_DB_NAME.str))
+    msg= "system schema";
+  else if (!(idx->fields= (uint*) my_malloc(idx->n_fields * sizeof(uint),
+                                            MYF(0))))
+    msg= "out of memory";
+  else
+  {
+    conn->indexes[id]= idx;
+    bzero(&req, sizeof(req));
+    req.type= HS_OPEN;
+    req.index_id= id;
+    hs_run_batch(conn, &req, 1);
+    if (idx->table_map_id)
+      return;
+    conn->indexes[id]= NULL;
+    msg= NULL;
+  }
+
+  hs_free_index(idx);
+  if (msg)
+    hs_append_error(&conn->out, HS_ERR_HANDLER, msg);
+}
+
+
+/**
+  Tell whether a request line is a batch delimiter.
+
+  @return 'B' or 'C' for a begin or commit line, or 0
+*/
+
+static char hs_line_type(const char *line, const char *eol)
+{
+  if (eol > line && eol[-1] == '\r')
+    eol--;
+  if (eol - line == 1 && (*line == 'B' || *line == 'C'))
+    return *line;
+  return 0;
+}
+
+
+/** Compare a field with handler_socket_secret in constant time */
+
+static bool hs_check_secret(const hs_field *f)
+{
+  size_t len= strlen(hs_secret);
+  uint diff= f->len != len;
+
+  if (!f->str)
+    return FALSE;
+  for (size_t i= 0; i < f->len && i < len; i++)
+    diff|= (uchar) f->str[i] ^ (uchar) hs_secret[i];
+  return !diff;
+}
+
+
+/**
+  Run the complete request lines of the input and keep the rest for the
+  next read.  The requests between a B and a C line form a batch, which
+  runs when its C line has arrived, however the lines were split over
+  reads.  Any other request runs alone.
+
+  @return TRUE if the connection is to be closed
+*/
+
+static bool hs_process_input(hs_conn *conn)
+{
+  THD *thd= conn->thd;
+  char *line= (char*) conn->in.ptr();
+  char *end= line + conn->in.length();
+  char *stop= line;
+  hs_request *reqs;
+  uint n_lines= 0;
+  uint n_complete= 0;
+  uint n_reqs= 0;
+  bool in_batch= FALSE;
+  bool close= FALSE;
+  DBUG_ENTER("hs_process_input");
+
+  /* Keep a batch whose C line has not arrived yet for the next read */
+  for (char *p= line, *eol; (eol= (char*) memchr(p, '\n', end - p));
+       p= eol + 1)
+  {
+    n_lines++;
+    switch (hs_line_type(p, eol)) {
+    case 'B': in_batch= TRUE; break;
+    case 'C': in_batch= FALSE; break;
+    }
+    if (!in_batch)
+    {
+      n_complete= n_lines;
+      stop= eol + 1;
+    }
+  }
+  /* Running a request frees the memory of thd, so this is not in it */
+  if (!(reqs= (hs_request*) my_malloc(ulong(n_complete + 1) *
+                                      sizeof(hs_request), MYF(0))))
+  {
+    n_complete= 0;
+    stop= line;
+    close= TRUE;
+  }
+
+  in_batch= FALSE;
+  for (uint i= 0; i < n_complete && !close; i++)
+  {
+    char *eol= (char*) memchr(line, '\n', end - line);
+    char *line_end= eol > line && eol[-1] == '\r' ? eol - 1 : eol;
+    char type= hs_line_type(line, eol);
+    hs_field *f;
+    uint n= hs_split_line(thd, line, line_end, &f);
+    line= eol + 1;
+
+    if (!conn->authenticated)
+    {
+      if (n == 2 && f[0].str && f[0].len == 1 && f[0].str[0] == 'A' &&
+          hs_check_secret(&f[1]))
+      {
+        conn->authenticated= TRUE;
+        conn->out.append(STRING_WITH_LEN("0\t1\n"));
+      }
+      else
+      {
+        hs_append_error(&conn->out, HS_ERR_REQUEST,
+                        "authentication required");
+        close= TRUE;
+      }
+    }
+    else if (type == 'B')
+    {
+      if (in_batch)
+        hs_append_error(&conn->out, HS_ERR_REQUEST, "batch already begun");
+      else
+      {
+        in_batch= TRUE;
+        n_reqs= 0;
+        conn->out.append(STRING_WITH_LEN("0\t1\n"));
+      }
+    }
+    else if (type == 'C')
+    {
+      if (!in_batch)
+        hs_append_error(&conn->out, HS_ERR_REQUEST, "no batch begun");
+      else if (n_reqs && hs_run_batch(conn, reqs, n_reqs))
+        hs_append_error(&conn->out, HS_ERR_HANDLER, "batch rolled back");
+      else
+        conn->out.append(STRING_WITH_LEN("0\t1\n"));
+      in_batch= FALSE;
+    }
+    else if (n && f[0].str && f[0].len == 1 && f[0].str[0] == 'P')
+    {
+      if (in_batch)
+        hs_append_error(&conn->out, HS_ERR_REQUEST,
+                        "open request in a batch");
+      else
+        hs_open_index(conn, f, n);
+    }
+    else
+    {
+      hs_request *req= &reqs[n_reqs];
+      bzero(req, sizeof(hs_request));
+      if (n)
+        hs_parse_request(req, f, n);
+      else
+        req->error= "out of memory";
+      if (in_batch)
+        n_reqs++;
+      else
+        hs_run_batch(conn, req, 1);
+    }
+  }
+  my_free(reqs);
+  free_root(thd->mem_root, MYF(MY_KEEP_PREALLOC));
+
+  memmove((char*) conn->in.ptr(), stop, end - stop);
+  conn->in.length(end - stop);
+  DBUG_RETURN(close);
+}
+
+
+static bool hs_send(hs_conn *conn)
+{
+  const char *p= conn->out.ptr();
+  size_t left= conn->out.length();
+
+  while (left)
+  {
+    ssize_t len= send(conn->fd, p, left, MSG_NOSIGNAL);
+    if (len < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return TRUE;
+    }
+    p+= len;
+    left-= len;
+  }
+  conn->out.length(0);
+  return FALSE;
+}
+
+
+extern void delete_thd(THD *);
+
+/**
+  Give a connection the privileges of handler_socket_user, like a stored
+  program with that definer.
+
+  @return TRUE if the account does not exist
+*/
+
+static bool hs_login(THD *thd)
+{
+  /* Security_context::destroy() frees the user and host names */
+  char *user= my_strdup(hs_user_name, MYF(MY_WME));
+  char *host= my_strdup(hs_user_host, MYF(MY_WME));
+  char *ip= my_strdup(hs_user_host, MYF(MY_WME));
+
+  if (!user || !host || !ip)
+  {
+    my_free(user);
+    my_free(host);
+    my_free(ip);
+    return TRUE;
+  }
+  if (acl_getroot(thd->security_ctx, user, host, ip, NULL))
+  {
+    sql_print_error("Handler socket: the account '%s'@'%s' of "
+                    "handler_socket_user does not exist",
+                    hs_user_name, hs_user_host);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+  Serve one connection.  The thread has a THD of its own, like the event
+  scheduler threads, so that it shows in SHOW PROCESSLIST and can be
+  killed.
+*/
+
+pthread_handler_t hs_worker(void *arg)
+{
+  hs_conn *conn= (hs_conn*) arg;
+  THD *thd;
+  char buf[HS_READ_SIZE];
+
+  my_thread_init();
+  thd= conn->thd= new THD;
+  thd->thread_stack= (char*) &thd;
+  thd->command= COM_DAEMON;
+  /* There is no statement text that a slave could replay */
+  thd->variables.binlog_format= BINLOG_FORMAT_ROW;
+  conn->authenticated= !hs_secret || !*hs_secret;
+  mysql_mutex_lock(&LOCK_thread_count);
+  thd->thread_id= thd->variables.pseudo_thread_id= thread_id++;
+  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_thread_set_psi_id(thd->thread_id);
+
+  if (init_thr_lock() || thd->store_globals())
+  {
+    sql_print_error("Handler socket: cannot initialize a connection thread");
+    close(conn->fd);
+    delete thd;
+    goto end;
+  }
+  thd->init_for_queries();
+
+  if (hs_login(thd))
+  {
+    hs_append_error(&conn->out, HS_ERR_REQUEST, "no such account");
+    hs_send(conn);
+    thd->killed= THD::KILL_CONNECTION;
+  }
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  threads.append(thd);
+  thread_count++;
+  mysql_mutex_unlock(&LOCK_thread_count);
+
+  while (!hs_shutdown && !abort_loop && !thd->killed)
+  {
+    struct pollfd pfd= { conn->fd, POLLIN, 0 };
+    ssize_t len;
+
+    thd_proc_info(thd, "Waiting for requests");
+    if (poll(&pfd, 1, HS_POLL_TIMEOUT) <= 0)
+      continue;
+    if ((len= recv(conn->fd, buf, sizeof(buf), 0)) <= 0)
+    {
+      if (len < 0 && errno == EINTR)
+        continue;
+      break;
+    }
+    if (conn->in.append(buf, len))
+      break;
+    if (memchr(buf, '\n', len))
+    {
+      thd_proc_info(thd, "Executing");
+      bool close= hs_process_input(conn);
+      if (hs_send(conn) || close)
+        break;
+    }
+    if (conn->in.length() > thd->variables.max_allowed_packet)
+      break;
+  }
+
+  for (uint i= 0; i < HS_MAX_INDEXES; i++)
+    hs_free_index(conn->indexes[i]);
+  conn->in.free();
+  conn->out.free();
+  close(conn->fd);
+
+  mysql_mutex_lock(&LOCK_thd_remove);
+  mysql_mutex_lock(&LOCK_thread_count);
+  delete_thd(thd);
+  mysql_cond_broadcast(&COND_thread_count);
+  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_mutex_unlock(&LOCK_thd_remove);
+
+end:
+  mysql_mutex_lock(&LOCK_handler_socket);
+  conn->finished= TRUE;
+  mysql_mutex_unlock(&LOCK_handler_socket);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Join the threads of finished connections, or of all the connections.
+*/
+
+static void hs_reap_connections(bool all)
+{
+  hs_conn *reaped= NULL;
+
+  mysql_mutex_lock(&LOCK_handler_socket);
+  for (hs_conn **prev= &hs_conns; *prev;)
+  {
+    hs_conn *conn= *prev;
+    if (all || conn->finished)
+    {
+      *prev= conn->next;
+      conn->next= reaped;
+      reaped= conn;
+      hs_n_conns--;
+    }
+    else
+      prev= &conn->next;
+  }
+  mysql_mutex_unlock(&LOCK_handler_socket);
+
+  while (reaped)
+  {
+    hs_conn *conn= reaped;
+    reaped= conn->next;
+    pthread_join(conn->thread, NULL);
+    delete conn;
+  }
+}
+
+
+static void hs_start_connection(int fd)
+{
+  hs_conn *conn;
+  struct timeval timeout= { (long) global_system_variables.net_write_timeout,
+                            0 };
+
+  mysql_mutex_lock(&LOCK_handler_socket);
+  if (hs_n_conns >= hs_max_connections || !(conn= new hs_conn))
+  {
+    mysql_mutex_unlock(&LOCK_handler_socket);
+    close(fd);
+    return;
+  }
+  conn->fd= fd;
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  if (pthread_create(&conn->thread, NULL, hs_worker, conn))
+  {
+    mysql_mutex_unlock(&LOCK_handler_socket);
+    close(fd);
+    delete conn;
+    return;
+  }
+  conn->next= hs_conns;
+  hs_conns= conn;
+  hs_n_conns++;
+  hs_stats.connections++;
+  mysql_mutex_unlock(&LOCK_handler_socket);
+}
+
+
+pthread_handler_t hs_listener(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+  while (!hs_shutdown && !abort_loop)
+  {
+    struct pollfd pfd= { hs_listen_fd, POLLIN, 0 };
+    int fd;
+
+    hs_reap_connections(FALSE);
+    if (poll(&pfd, 1, HS_POLL_TIMEOUT) <= 0)
+      continue;
+    if ((fd= accept(hs_listen_fd, NULL, NULL)) >= 0)
+      hs_start_connection(fd);
+  }
+  my_thread_end();
+  return 0;
+}
+
+
+/*
+  Initialize the handler socket at server start or plugin installation.
+
+  SYNOPSIS
+    handler_socket_plugin_init()
+
+  DESCRIPTION
+    Binds the listening socket and starts the listener thread.
+
+  RETURN VALUE
+    0                    success
+    1                    failure
+*/
+
+static int handler_socket_plugin_init(void *p __attribute__((unused)))
+{
+  struct addrinfo hints, *res;
+  struct sockaddr_storage addr;
+  socklen_t addr_len= sizeof(addr);
+  char port[8];
+  int on= 1;
+  int error;
+  DBUG_ENTER("handler_socket_plugin_init");
+
+#ifdef HAVE_PSI_INTERFACE
+  init_handler_socket_psi_keys();
+#endif
+
+  const char *at= hs_user ? strrchr(hs_user, '@') : NULL;
+  size_t user_len= at ? at - hs_user : hs_user ? strlen(hs_user) : 0;
+  const char *host= at ? at + 1 : "%";
+  if (!user_len || user_len > USERNAME_LENGTH ||
+      strlen(host) > HOSTNAME_LENGTH)
+  {
+    sql_print_error("Handler socket: handler_socket_user must name the "
+                    "account whose privileges the requests have, as "
+                    "user@host");
+    DBUG_RETURN(1);
+  }
+  strmake(hs_user_name, hs_user, user_len);
+  strmake(hs_user_host, host, HOSTNAME_LENGTH);
+
+  bzero(&hints, sizeof(hints));
+  hints.ai_family= AF_UNSPEC;
+  hints.ai_socktype= SOCK_STREAM;
+  hints.ai_flags= AI_PASSIVE;
+  my_snprintf(port, sizeof(port), "%u", hs_port);
+  if ((error= getaddrinfo(hs_address, port, &hints, &res)))
+  {
+    sql_print_error("Handler socket: cannot resolve '%s': %s",
+                    hs_address, gai_strerror(error));
+    DBUG_RETURN(1);
+  }
+
+  hs_listen_fd= socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (hs_listen_fd < 0 ||
+      setsockopt(hs_listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) ||
+      bind(hs_listen_fd, res->ai_addr, res->ai_addrlen) ||
+      listen(hs_listen_fd, 128) ||
+      getsockname(hs_listen_fd, (struct sockaddr*) &addr, &addr_len))
+  {
+    sql_print_error("Handler socket: cannot listen on %s port %u (errno: %d)",
+                    hs_address, hs_port, errno);
+    if (hs_listen_fd >= 0)
+      close(hs_listen_fd);
+    hs_listen_fd= -1;
+    freeaddrinfo(res);
+    DBUG_RETURN(1);
+  }
+  freeaddrinfo(res);
+
+  if (addr.ss_family == AF_INET6)
+    hs_listen_port= ntohs(((struct sockaddr_in6*) &addr)->sin6_port);
+  else
+    hs_listen_port= ntohs(((struct sockaddr_in*) &addr)->sin_port);
+
+  mysql_mutex_init(key_LOCK_handler_socket, &LOCK_handler_socket,
+                   MY_MUTEX_INIT_FAST);
+  bzero(&hs_stats, sizeof(hs_stats));
+  hs_shutdown= FALSE;
+
+  if (pthread_create(&hs_listener_thread, NULL, hs_listener, NULL))
+  {
+    sql_print_error("Handler socket: cannot create the listener thread");
+    mysql_mutex_destroy(&LOCK_handler_socket);
+    close(hs_listen_fd);
+    hs_listen_fd= -1;
+    DBUG_RETURN(1);
+  }
+
+  sql_print_information("Handler socket: listening on %s port %lu",
+                        hs_address, hs_listen_port);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Terminate the handler socket at server shutdown or plugin deinstallation.
+
+  SYNOPSIS
+    handler_socket_plugin_deinit()
+
+  DESCRIPTION
+    Stops the listener and waits for the connection threads to finish
+    their current batch.
+
+  RETURN VALUE
+    0                    success
+*/
+
+static int handler_socket_plugin_deinit(void *p __attribute__((unused)))
+{
+  DBUG_ENTER("handler_socket_plugin_deinit");
+
+  hs_shutdown= TRUE;
+  pthread_join(hs_listener_thread, NULL);
+  hs_reap_connections(TRUE);
+  close(hs_listen_fd);
+  hs_listen_fd= -1;
+  mysql_mutex_destroy(&LOCK_handler_socket);
+
+  DBUG_RETURN(0);
+}
+
+
+static MYSQL_SYSVAR_UINT(port, hs_port,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "TCP port the handler socket listens on. 0 lets the system pick a free "
+  "port, which is shown in Handler_socket_port.",
+  NULL, NULL, 9998, 0, 65535, 0);
+
+static MYSQL_SYSVAR_STR(address, hs_address,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Address the handler socket listens on.",
+  NULL, NULL, "127.0.0.1");
+
+static MYSQL_SYSVAR_STR(user, hs_user,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Account, as user@host, whose privileges the handler socket requests "
+  "have. The plugin does not start without it.",
+  NULL, NULL, NULL);
+
+/* Not a server variable, so that it cannot be read with SELECT */
+static MYSQL_SYSVAR_STR(secret, hs_secret,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY | PLUGIN_VAR_NOSYSVAR,
+  "Secret that a client must send in an A request before any other "
+  "request. Without it, any client that can reach the socket has the "
+  "privileges of handler_socket_user.",
+  NULL, NULL, NULL);
+
+static MYSQL_SYSVAR_UINT(max_connections, hs_max_connections,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of concurrent handler socket connections.",
+  NULL, NULL, 64, 1, 100000, 0);
+
+static struct st_mysql_sys_var* handler_socket_system_vars[]= {
+  MYSQL_SYSVAR(port),
+  MYSQL_SYSVAR(address),
+  MYSQL_SYSVAR(max_connections),
+  MYSQL_SYSVAR(user),
+  MYSQL_SYSVAR(secret),
+  NULL
+};
+
+/* Times are in microseconds */
+static SHOW_VAR handler_socket_status_vars[]= {
+  {"Handler_socket_port",
+   (char*) &hs_listen_port, SHOW_LONG},
+  {"Handler_socket_connections",
+   (char*) &hs_stats.connections, SHOW_LONGLONG},
+  {"Handler_socket_batches",
+   (char*) &hs_stats.batches, SHOW_LONGLONG},
+  {"Handler_socket_batch_time",
+   (char*) &hs_stats.batch_time, SHOW_LONGLONG},
+  {"Handler_socket_errors",
+   (char*) &hs_stats.errors, SHOW_LONGLONG},
+  {"Handler_socket_gets",
+   (char*) &hs_stats.gets, SHOW_LONGLONG},
+  {"Handler_socket_get_time",
+   (char*) &hs_stats.get_time, SHOW_LONGLONG},
+  {"Handler_socket_puts",
+   (char*) &hs_stats.puts, SHOW_LONGLONG},
+  {"Handler_socket_put_time",
+   (char*) &hs_stats.put_time, SHOW_LONGLONG},
+  {"Handler_socket_updates",
+   (char*) &hs_stats.updates, SHOW_LONGLONG},
+  {"Handler_socket_update_time",
+   (char*) &hs_stats.update_time, SHOW_LONGLONG},
+  {"Handler_socket_deletes",
+   (char*) &hs_stats.deletes, SHOW_LONGLONG},
+  {"Handler_socket_delete_time",
+   (char*) &hs_stats.delete_time, SHOW_LONGLONG},
+  {NULL, NULL, SHOW_LONG}
+};
+
+
+struct st_mysql_daemon handler_socket_plugin=
+{ MYSQL_DAEMON_INTERFACE_VERSION  };
+
+/*
+  Plugin library descriptor
+*/
+
+mysql_declare_plugin(handler_socket)
+{
+  MYSQL_DAEMON_PLUGIN,
+  &handler_socket_plugin,
+  "handler_socket",
+  "Oracle Corporation",
+  "Key lookups and modifications through the handler interface over TCP",
+  PLUGIN_LICENSE_GPL,
+  handler_socket_plugin_init,   /* Plugin Init */
+  handler_socket_plugin_deinit, /* Plugin Deinit */
+  0x0100 /* 1.0 */,
+  handler_socket_status_vars,   /* status variables                */
+  handler_socket_system_vars,   /* system variables                */
+  NULL,                         /* config options                  */
+  0,                            /* flags                           */
+}
+mysql_declare_plugin_end;
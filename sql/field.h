@@ -294,6 +294,11 @@ public:
      Signals that this field is NULL-able.
   */
   inline bool real_maybe_null(void) { return null_ptr != 0; }
+  inline enum column_format_type column_format() const
+  {
+    return (enum column_format_type)
+      ((flags >> FIELD_FLAGS_COLUMN_FORMAT) & 3);
+  }
 
   enum {
     LAST_NULL_BYTE_UNDEF= 0
@@ -2184,6 +2189,12 @@ public:
   {
     return (flags & (BINCMP_FLAG | BINARY_FLAG)) != 0;
   }
+
+  enum column_format_type column_format() const
+  {
+    return (enum column_format_type)
+      ((flags >> FIELD_FLAGS_COLUMN_FORMAT) & 3);
+  }
 private:
   const String empty_set_string;
 };
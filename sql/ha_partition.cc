@@ -6368,6 +6368,9 @@ int ha_partition::extra(enum ha_extra_function operation)
     /* Special actions for MERGE tables. Ignore. */
     break;
   }
+    /* Category 10) Not supported for partitioned tables */
+  case HA_EXTRA_EXPORT:
+    DBUG_RETURN(HA_ERR_WRONG_COMMAND);
   /*
     http://dev.mysql.com/doc/refman/5.1/en/partitioning-limitations.html
     says we no longer support logging to partitioned tables, so we fail
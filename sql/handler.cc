@@ -4877,6 +4877,323 @@ scan_it_again:
 }
 
 
+/****************************************************************************
+  Disk-sweep multi-range read
+****************************************************************************/
+
+/**
+  Check whether disk-sweep multi-range reads are enabled for a session.
+  A handler only requests the range buffer that the sweep sorts its row
+  ids in (HA_NEED_READ_RANGE_BUFFER) when they are.
+
+  @param thd  Session
+
+  @retval TRUE   The "mrr" optimizer_switch flag is set
+  @retval FALSE  It is not
+*/
+
+bool DsMrr_impl::enabled(THD *thd)
+{
+  return test(thd->variables.optimizer_switch & OPTIMIZER_SWITCH_MRR);
+}
+
+
+/**
+  Check whether the ranges of an index are read with a disk sweep.
+
+  @param keyno   Index whose ranges are read
+  @param sorted  Whether the rows must be returned in index order
+
+  @note
+    Locking reads keep the default implementation: unlock_row() would
+    release the lock on the row that was read with rnd_pos(), but not
+    the lock on the index record that the scanning handler took.
+
+  @retval TRUE   The rows are read in row id order
+  @retval FALSE  The rows are read in index order
+*/
+
+bool DsMrr_impl::choose(uint keyno, bool sorted)
+{
+  return (!sorted && enabled(table->in_use) &&
+          !table->key_read &&
+          !(keyno == table->s->primary_key &&
+            h->primary_key_is_clustered()) &&
+          (table->reginfo.lock_type == TL_READ ||
+           table->reginfo.lock_type == TL_READ_HIGH_PRIORITY));
+}
+
+
+/**
+  Start the scan of an index with the handler that scans the index.
+  The handler and its column bitmap are created by the first scan after
+  reset(), and kept until the next reset().
+
+  @param keyno  Index to scan
+
+  @retval 0  OK
+  @retval #  Error code
+*/
+
+int DsMrr_impl::setup_scan(uint keyno)
+{
+  THD *thd= table->in_use;
+  MY_BITMAP *save_read_set= table->read_set;
+  MY_BITMAP *save_write_set= table->write_set;
+  KEY_PART_INFO *key_part, *key_part_end;
+  int res;
+  DBUG_ENTER("DsMrr_impl::setup_scan");
+
+  DBUG_ASSERT(!h2_active);
+
+  if (!h2)
+  {
+    my_bitmap_map *bitmap_buf;
+
+    if (!(bitmap_buf= (my_bitmap_map*)
+          alloc_root(thd->mem_root, bitmap_buffer_size(table->s->fields))) ||
+        !(h2= h->clone(table->s->normalized_path.str, thd->mem_root)))
+      DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+    bitmap_init(&h2_columns, bitmap_buf, table->s->fields, FALSE);
+  }
+
+  /*
+    h2 reads the columns that position() needs and the index columns
+    that the pushed index condition may refer to. Column prefixes are
+    left out, as they would make h2 read the whole row.
+  */
+  bitmap_clear_all(&h2_columns);
+  key_part= table->key_info[keyno].key_part;
+  key_part_end= key_part + table->key_info[keyno].key_parts;
+  for (; key_part != key_part_end; key_part++)
+  {
+    if (!(key_part->key_part_flag & HA_PART_KEY_SEG))
+      bitmap_set_bit(&h2_columns, key_part->fieldnr - 1);
+  }
+  if (table->s->primary_key < MAX_KEY)
+    table->mark_columns_used_by_index_no_reset(table->s->primary_key,
+                                               &h2_columns);
+
+  table->column_bitmaps_set_no_signal(&h2_columns, &h2_columns);
+
+  if ((res= h2->ha_external_lock(thd, F_RDLCK)))
+    goto err;
+  h2->extra(HA_EXTRA_KEYREAD);
+  if ((res= h2->ha_index_init(keyno, FALSE)))
+  {
+    h2->ha_external_lock(thd, F_UNLCK);
+    goto err;
+  }
+  h2->cancel_pushed_idx_cond();
+  if (h->pushed_idx_cond && h->pushed_idx_cond_keyno == keyno)
+    h2->idx_cond_push(keyno, h->pushed_idx_cond);
+  h2_active= TRUE;
+
+  table->column_bitmaps_set_no_signal(save_read_set, save_write_set);
+  DBUG_RETURN(0);
+
+err:
+  table->column_bitmaps_set_no_signal(save_read_set, save_write_set);
+  reset();
+  DBUG_RETURN(res);
+}
+
+
+/**
+  End the index scan of the handler that scans the index, and unlock
+  it. The handler is kept for the next scan.
+*/
+
+void DsMrr_impl::end_scan()
+{
+  DBUG_ENTER("DsMrr_impl::end_scan");
+  if (h2_active)
+  {
+    h2->ha_index_or_rnd_end();
+    h2->ha_external_lock(table->in_use, F_UNLCK);
+    h2_active= FALSE;
+  }
+  use_default_impl= TRUE;
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Release the handler that scans the index.
+*/
+
+void DsMrr_impl::reset()
+{
+  DBUG_ENTER("DsMrr_impl::reset");
+  end_scan();
+  if (h2)
+  {
+    h2->close();
+    delete h2;
+    h2= NULL;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+static int dsmrr_rowid_cmp(void *h, uchar *a, uchar *b)
+{
+  return ((handler*) h)->cmp_ref(a, b);
+}
+
+
+/**
+  Collect the row ids of the next rows in the ranges into the buffer,
+  each followed by a pointer to its range, and sort them.
+
+  @retval 0  OK. rowids_cur == rowids_end if there were no more rows.
+  @retval #  Error code
+*/
+
+int DsMrr_impl::fill_buffer()
+{
+  MY_BITMAP *save_read_set= table->read_set;
+  MY_BITMAP *save_write_set= table->write_set;
+  uint ref_length= h->ref_length;
+  uint elem_size= ref_length + sizeof(KEY_MULTI_RANGE*);
+  KEY_MULTI_RANGE *range;
+  int res= 0;
+  DBUG_ENTER("DsMrr_impl::fill_buffer");
+
+  table->column_bitmaps_set_no_signal(&h2_columns, &h2_columns);
+
+  for (rowids_end= rowids_buf; rowids_end + elem_size <= rowids_buf_end;
+       rowids_end+= elem_size)
+  {
+    /* Save a call if there can be only one row in the range. */
+    if (in_range && ranges_cur[-1].range_flag != (UNIQUE_RANGE | EQ_RANGE))
+      res= h2->read_range_next();
+    else
+      res= HA_ERR_END_OF_FILE;
+
+    while (res == HA_ERR_END_OF_FILE && ranges_cur < ranges_end)
+    {
+      res= h2->read_range_first(ranges_cur->start_key.keypart_map ?
+                                &ranges_cur->start_key : 0,
+                                ranges_cur->end_key.keypart_map ?
+                                &ranges_cur->end_key : 0,
+                                test(ranges_cur->range_flag & EQ_RANGE),
+                                FALSE);
+      ranges_cur++;
+    }
+
+    if (res)
+      break;
+
+    in_range= TRUE;
+    range= ranges_cur - 1;
+    h2->position(table->record[0]);
+    memcpy(rowids_end, h2->ref, ref_length);
+    memcpy(rowids_end + ref_length, &range, sizeof(range));
+  }
+
+  table->column_bitmaps_set_no_signal(save_read_set, save_write_set);
+
+  if (res == HA_ERR_END_OF_FILE)
+  {
+    in_range= FALSE;
+    scan_eof= TRUE;
+  }
+  else if (res)
+    DBUG_RETURN(res);
+
+  my_qsort2(rowids_buf, (rowids_end - rowids_buf) / elem_size, elem_size,
+            (qsort2_cmp) dsmrr_rowid_cmp, h);
+  rowids_cur= rowids_buf;
+  DBUG_RETURN(0);
+}
+
+
+/**
+  Read the first row of a multi-range set with a disk sweep, or with
+  handler::read_multi_range_first() if choose() declines it or the
+  buffer cannot hold a row id.
+
+  @note
+    Each row id is stored in the buffer with the range that it was found
+    in, so *found_range_p is valid also for a sweep.
+
+  @see handler::read_multi_range_first()
+*/
+
+int DsMrr_impl::read_first(KEY_MULTI_RANGE **found_range_p,
+                           KEY_MULTI_RANGE *ranges, uint range_count,
+                           bool sorted, HANDLER_BUFFER *buffer)
+{
+  uint keyno= h->active_index;
+  int res;
+  DBUG_ENTER("DsMrr_impl::read_first");
+
+  if (h2_active && h2->active_index != keyno)
+    end_scan();
+
+  if (!choose(keyno, sorted) || !buffer ||
+      buffer->buffer_end - buffer->buffer <
+      (ptrdiff_t) (h->ref_length + sizeof(KEY_MULTI_RANGE*)))
+  {
+    use_default_impl= TRUE;
+    DBUG_RETURN(h->handler::read_multi_range_first(found_range_p, ranges,
+                                                   range_count, sorted,
+                                                   buffer));
+  }
+
+  if (!h2_active && (res= setup_scan(keyno)))
+    DBUG_RETURN(res);
+
+  use_default_impl= FALSE;
+  ranges_cur= ranges;
+  ranges_end= ranges + range_count;
+  in_range= FALSE;
+  scan_eof= FALSE;
+  rowids_buf= buffer->buffer;
+  rowids_buf_end= buffer->buffer_end;
+  rowids_cur= rowids_end= rowids_buf;
+
+  DBUG_RETURN(read_next(found_range_p));
+}
+
+
+/**
+  Read the next row of a multi-range set.
+
+  @see handler::read_multi_range_next()
+*/
+
+int DsMrr_impl::read_next(KEY_MULTI_RANGE **found_range_p)
+{
+  int res;
+  DBUG_ENTER("DsMrr_impl::read_next");
+
+  if (use_default_impl)
+    DBUG_RETURN(h->handler::read_multi_range_next(found_range_p));
+
+  do
+  {
+    if (rowids_cur == rowids_end)
+    {
+      if (scan_eof)
+        DBUG_RETURN(HA_ERR_END_OF_FILE);
+      if ((res= fill_buffer()))
+        DBUG_RETURN(res);
+      if (rowids_cur == rowids_end)
+        DBUG_RETURN(HA_ERR_END_OF_FILE);
+    }
+
+    res= h->rnd_pos(table->record[0], rowids_cur);
+    memcpy(found_range_p, rowids_cur + h->ref_length, sizeof(*found_range_p));
+    rowids_cur+= h->ref_length + sizeof(*found_range_p);
+    /* Skip the rows that were deleted after the index was scanned. */
+  } while (res == HA_ERR_RECORD_DELETED || res == HA_ERR_KEY_NOT_FOUND);
+
+  DBUG_RETURN(res);
+}
+
+
 /**
   Read first row between two ranges.
   Store ranges for future calls to read_range_next.
@@ -5014,6 +5331,40 @@ int handler::compare_key(key_range *range)
 }
 
 
+/**
+  Check the pushed index condition on the index entry that the storage
+  engine has read into table->record[0].
+
+  @param h_arg  The handler that the condition was pushed to
+
+  @note
+    The columns of the index that the engine has not read are stale, so
+    the condition must have been built by make_cond_for_index().
+
+  @retval ICP_NO_MATCH      The entry does not match; skip the row
+  @retval ICP_MATCH         The entry matches; read the rest of the row
+  @retval ICP_OUT_OF_RANGE  The entry is beyond the end of the range scan
+*/
+
+ICP_RESULT handler_index_cond_check(void *h_arg)
+{
+  handler *h= (handler*) h_arg;
+  THD *thd= h->table->in_use;
+
+  DBUG_ASSERT(h->pushed_idx_cond);
+  DBUG_ASSERT(h->active_index == h->pushed_idx_cond_keyno);
+
+  if (h->end_range && h->compare_key(h->end_range) > 0)
+    return ICP_OUT_OF_RANGE;
+
+  status_var_increment(thd->status_var.ha_icp_attempts);
+  if (!h->pushed_idx_cond->val_int())
+    return ICP_NO_MATCH;
+  status_var_increment(thd->status_var.ha_icp_match);
+  return ICP_MATCH;
+}
+
+
 int handler::index_read_idx_map(uchar * buf, uint index, const uchar * key,
                                 key_part_map keypart_map,
                                 enum ha_rkey_function find_flag)
@@ -5418,6 +5769,7 @@ int handler::ha_reset()
   /* reset the bitmaps to point to defaults */
   table->default_column_bitmaps();
   pushed_cond= NULL;
+  cancel_pushed_idx_cond();
   DBUG_RETURN(reset());
 }
 
@@ -167,6 +167,11 @@
   will report ER_TABLE_NEEDS_UPGRADE, otherwise ER_TABLE_NEED_REBUILD.
 */
 #define HA_CAN_REPAIR                    (LL(1) << 37)
+/*
+  Engine supports FLUSH TABLES ... FOR EXPORT: the table files can be
+  copied while the table is locked, and imported into another server.
+*/
+#define HA_CAN_EXPORT                    (LL(1) << 38)
 
 /*
   Set of all binlog flags. Currently only contain the capabilities
@@ -246,6 +251,12 @@
 */
 #define HA_KEY_SCAN_NOT_ROR     128 
 
+/*
+  The index can evaluate a pushed index condition on its entries before
+  the rest of the row is read. See handler::idx_cond_push().
+*/
+#define HA_DO_INDEX_COND_PUSHDOWN 256
+
 /* operations for disable/enable indexes */
 #define HA_KEY_SWITCH_NONUNIQ      0
 #define HA_KEY_SWITCH_ALL          1
@@ -1179,8 +1190,8 @@ typedef struct st_ha_check_opt
 
 typedef struct st_handler_buffer
 {
-  const uchar *buffer;         /* Buffer one can start using */
-  const uchar *buffer_end;     /* End of buffer */
+  uchar *buffer;               /* Buffer one can start using */
+  uchar *buffer_end;           /* End of buffer */
   uchar *end_of_used_area;     /* End of area that was used by handler */
 } HANDLER_BUFFER;
 
@@ -1279,6 +1290,7 @@ public:
 
 class handler :public Sql_alloc
 {
+  friend ICP_RESULT handler_index_cond_check(void *h_arg);
 public:
   typedef ulonglong Table_flags;
 protected:
@@ -1320,6 +1332,10 @@ public:
   bool locked;
   bool implicit_emptied;                /* Can be !=0 only if HEAP */
   const COND *pushed_cond;
+  /** Index condition pushed by idx_cond_push(), or NULL */
+  Item *pushed_idx_cond;
+  /** Index that pushed_idx_cond refers to, or MAX_KEY */
+  uint pushed_idx_cond_keyno;
   ulonglong rows_read;
   ulonglong rows_changed;
   ulonglong index_rows_read[MAX_KEY];
@@ -1375,7 +1391,8 @@ public:
     ref_length(sizeof(my_off_t)),
     ft_handler(0), inited(NONE),
     locked(FALSE), implicit_emptied(0),
-    pushed_cond(0), rows_read(0), rows_changed(0), next_insert_id(0), insert_id_for_cur_row(0),
+    pushed_cond(0), pushed_idx_cond(NULL), pushed_idx_cond_keyno(MAX_KEY),
+    rows_read(0), rows_changed(0), next_insert_id(0), insert_id_for_cur_row(0),
     auto_inc_intervals_count(0),
     m_psi(NULL)
     {
@@ -1402,6 +1419,7 @@ public:
     int result;
     DBUG_ENTER("ha_index_init");
     DBUG_ASSERT(inited==NONE);
+    end_range= NULL;
     if (!(result= index_init(idx, sorted)))
       inited=INDEX;
     DBUG_RETURN(result);
@@ -1662,6 +1680,13 @@ public:
                                      KEY_MULTI_RANGE *ranges, uint range_count,
                                      bool sorted, HANDLER_BUFFER *buffer);
   virtual int read_multi_range_next(KEY_MULTI_RANGE **found_range_p);
+  /**
+    Whether read_multi_range_first() on index keyno returns the rows in
+    row id order rather than in index order (see DsMrr_impl). Used by
+    EXPLAIN.
+  */
+  virtual bool read_multi_range_sweeps(uint keyno, bool sorted)
+  { return FALSE; }
   virtual int read_range_first(const key_range *start_key,
                                const key_range *end_key,
                                bool eq_range, bool sorted);
@@ -2024,6 +2049,35 @@ public:
    Pops the top if condition stack, if stack is not empty.
  */
  virtual void cond_pop() { return; };
+
+ /**
+   Push an index condition down to the table handler.
+
+   @param  keyno     Index that the condition is on
+   @param  idx_cond  Condition that refers only to columns of that index,
+                     to constants and to columns of tables that precede
+                     this one in the join
+
+   @return
+     The part of idx_cond that the handler did not accept and that the
+     caller must check itself. idx_cond means that nothing was pushed.
+
+   @note
+   The handler checks the accepted condition with
+   handler_index_cond_check() on each entry of index keyno that it reads
+   into table->record[0], before it reads the rest of the row, and skips
+   the entries that do not match. Only one index condition can be pushed
+   at a time. ha_reset() and cancel_pushed_idx_cond() remove it.
+ */
+ virtual Item *idx_cond_push(uint keyno, Item *idx_cond) { return idx_cond; }
+ /**
+   Remove the condition that was pushed with idx_cond_push().
+ */
+ virtual void cancel_pushed_idx_cond()
+ {
+   pushed_idx_cond= NULL;
+   pushed_idx_cond_keyno= MAX_KEY;
+ }
  virtual bool check_if_incompatible_data(HA_CREATE_INFO *create_info,
 					 uint table_changes)
  { return COMPATIBLE_DATA_NO; }
@@ -2272,6 +2326,77 @@ private:
   { return HA_ERR_WRONG_COMMAND; }
 };
 
+
+/**
+  Disk-sweep multi-range read.
+
+  The ranges are scanned with a second, index-only handler object, the
+  row ids that it finds are collected with their ranges into the
+  HANDLER_BUFFER that was passed to read_multi_range_first(), sorted,
+  and the rows are then read with rnd_pos() in row id order. When the
+  buffer is full, the rows of the collected row ids are returned before
+  the scan continues. For a table with a clustered primary key, this
+  turns the lookups of a secondary index scan into one sweep over the
+  clustered index.
+
+  A handler that uses it calls init() when it is opened, forwards
+  read_multi_range_first(), read_multi_range_next() and
+  read_multi_range_sweeps() to it, calls end_scan() when its index scan
+  ends, and reset() in its own reset() and close(). The second handler
+  object is kept until reset(), so that an index that is scanned many
+  times in a statement, as in a join, is only cloned once. It only
+  requests the range buffer (HA_NEED_READ_RANGE_BUFFER) when enabled()
+  holds. The rows are not returned in index order, so the sweep is only
+  done when the caller did not ask for sorted output.
+*/
+
+class DsMrr_impl
+{
+public:
+  DsMrr_impl()
+    : h(NULL), table(NULL), h2(NULL), h2_active(FALSE),
+      use_default_impl(TRUE) {}
+  ~DsMrr_impl() { DBUG_ASSERT(h2 == NULL); }
+
+  void init(handler *h_arg, TABLE *table_arg)
+  {
+    h= h_arg;
+    table= table_arg;
+  }
+  static bool enabled(THD *thd);
+  bool choose(uint keyno, bool sorted);
+  int read_first(KEY_MULTI_RANGE **found_range_p, KEY_MULTI_RANGE *ranges,
+                 uint range_count, bool sorted, HANDLER_BUFFER *buffer);
+  int read_next(KEY_MULTI_RANGE **found_range_p);
+  void end_scan();
+  void reset();
+private:
+  /** The handler that reads the rows with rnd_pos() */
+  handler *h;
+  TABLE *table;
+  /** The handler that scans the index, or NULL */
+  handler *h2;
+  /** Whether h2 is locked and its index scan is initialized */
+  bool h2_active;
+  /** Columns that h2 reads: the index columns and the row id columns */
+  MY_BITMAP h2_columns;
+  /** The next range that h2 starts, and the end of the ranges */
+  KEY_MULTI_RANGE *ranges_cur, *ranges_end;
+  /** Whether h2 is positioned in the range before ranges_cur */
+  bool in_range;
+  /** Whether h2 has scanned all the ranges */
+  bool scan_eof;
+  /** Whether the current ranges are read with the default implementation */
+  bool use_default_impl;
+  /** The row id buffer */
+  uchar *rowids_buf, *rowids_buf_end;
+  /** The next row id to read, and the end of the collected row ids */
+  uchar *rowids_cur, *rowids_end;
+
+  int setup_scan(uint keyno);
+  int fill_buffer();
+};
+
 #define ha_macro_statistic_inc(m) ha_statistic_increment(&HOS::m, &SSV::m)
 
 	/* Some extern variables used with handlers */
@@ -2378,6 +2503,7 @@ int ha_release_savepoint(THD *thd, SAVEPOINT *sv);
 
 /* these are called by storage engines */
 void trans_register_ha(THD *thd, bool all, handlerton *ht);
+ICP_RESULT handler_index_cond_check(void *h_arg);
 
 /*
   Storage engine has to assume the transaction will end up with 2pc if
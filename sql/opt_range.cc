@@ -8835,8 +8835,10 @@ int QUICK_RANGE_SELECT::get_next()
       mrange_slot->range_flag= last_range->flag;
     }
 
+    /* A ROR-merged scan needs the rows of each range in row id order. */
     result= file->read_multi_range_first(&mrange, multi_range, count,
-                                         sorted, multi_range_buff);
+                                         sorted || in_ror_merged_scan,
+                                         multi_range_buff);
     if (result != HA_ERR_END_OF_FILE)
       goto end;
     in_range= FALSE; /* No matching rows; go to next set of ranges. */
@@ -550,6 +550,8 @@ typedef struct system_status_var
   ulong ha_discover_count;
   ulong ha_savepoint_count;
   ulong ha_savepoint_rollback_count;
+  ulong ha_icp_attempts;
+  ulong ha_icp_match;
 
   /* KEY_CACHE parts. These are copies of the original */
   ulong key_blocks_changed;
@@ -511,4 +511,71 @@ error:
 }
 
 
+/**
+  Implementation of FLUSH TABLES <table_list> FOR EXPORT statement.
+
+  Read locks the tables like FLUSH TABLES <table_list> WITH READ LOCK
+  and asks the storage engine to make the files of each table
+  consistent, so that they can be copied and imported into another
+  server with ALTER TABLE ... IMPORT TABLESPACE.  The engine keeps the
+  files consistent until the tables are unlocked with UNLOCK TABLES.
+
+  Only tables of engines that report HA_CAN_EXPORT can be exported.
+  Merge tables and views are not supported.
+*/
+
+bool flush_tables_for_export(THD *thd, TABLE_LIST *all_tables)
+{
+  Lock_tables_prelocking_strategy lock_tables_prelocking_strategy;
+  TABLE_LIST *table_list;
+
+  /*
+    This is called from SQLCOM_FLUSH, the transaction has
+    been committed implicitly.
+  */
+
+  if (thd->locked_tables_mode)
+  {
+    my_error(ER_LOCK_OR_ACTIVE_TRANSACTION, MYF(0));
+    return TRUE;
+  }
+
+  /*
+    Acquire SNW locks on tables to be exported. Don't acquire global
+    IX and database-scope IX locks on the tables as this will make
+    this statement incompatible with FLUSH TABLES WITH READ LOCK.
+  */
+  if (open_and_lock_tables(thd, all_tables, FALSE,
+                           MYSQL_OPEN_SKIP_SCOPED_MDL_LOCK,
+                           &lock_tables_prelocking_strategy))
+    return TRUE;
+
+  for (table_list= all_tables; table_list;
+       table_list= table_list->next_global)
+  {
+    handler *file= table_list->table->file;
+    int error;
+
+    if (!(file->ha_table_flags() & HA_CAN_EXPORT))
+    {
+      my_error(ER_ILLEGAL_HA, MYF(0), table_list->table_name);
+      return TRUE;
+    }
+
+    if ((error= file->extra(HA_EXTRA_EXPORT)))
+    {
+      file->print_error(error, MYF(0));
+      return TRUE;
+    }
+  }
+
+  if (thd->locked_tables_list.init_locked_tables(thd))
+    return TRUE;
+
+  thd->variables.option_bits|= OPTION_TABLE_LOCK;
+
+  return FALSE;
+}
+
+
 
@@ -150,6 +150,8 @@ evaluate_null_complemented_join_record(JOIN *join, JOIN_TAB *join_tab);
 static enum_nested_loop_state
 flush_cached_records(JOIN *join, JOIN_TAB *join_tab, bool skip_last);
 static enum_nested_loop_state
+flush_cached_records_bka(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state
 end_send(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_send_group(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
@@ -6174,6 +6176,10 @@ JOIN::make_simple_join(JOIN *parent, TABLE *temp_table)
   do_send_rows= row_limit ? 1 : 0;
 
   join_tab->cache.buff=0;			/* No caching */
+  join_tab->cache.bka= FALSE;
+  join_tab->cache.ranges= 0;
+  join_tab->cache.max_ranges= 0;
+  join_tab->cache.mrr_buff= 0;
   join_tab->table=temp_table;
   join_tab->select=0;
   join_tab->select_cond=0;
@@ -6885,6 +6891,318 @@ pick_table_access_method(JOIN_TAB *tab)
 }
 
 
+/**
+  Check if an expression can be evaluated on the columns of an index only.
+
+  @param item           Expression to check
+  @param tbl            The table the index belongs to
+  @param keyno          The index number
+  @param other_tbls_ok  TRUE <=> fields of other tables are allowed, as
+                        their values do not change while the index is read
+
+  @note
+    The pushed condition is evaluated by the storage engine while it holds
+    latches on the index page, so expressions that may read other tables,
+    block or have side effects (subqueries, stored and user defined
+    functions, user variable assignments, RAND() and the like) are never
+    pushed.
+
+  @retval TRUE   The expression only refers to the index columns
+  @retval FALSE  Otherwise
+*/
+
+static bool uses_index_fields_only(Item *item, TABLE *tbl, uint keyno,
+                                   bool other_tbls_ok)
+{
+  if (item->has_subquery() || (item->used_tables() & RAND_TABLE_BIT))
+    return FALSE;
+  if (item->const_item())
+    return TRUE;
+
+  switch (item->type()) {
+  case Item::FUNC_ITEM:
+  {
+    Item_func *item_func= (Item_func*) item;
+    switch (item_func->functype()) {
+    case Item_func::TRIG_COND_FUNC:
+    case Item_func::FUNC_SP:
+    case Item_func::UDF_FUNC:
+    case Item_func::SUSERVAR_FUNC:
+    case Item_func::FT_FUNC:
+    case Item_func::MULT_EQUAL_FUNC:
+      return FALSE;
+    default:
+      break;
+    }
+    Item **child= item_func->arguments();
+    Item **item_end= child + item_func->argument_count();
+    for (; child != item_end; child++)
+    {
+      if (!uses_index_fields_only(*child, tbl, keyno, other_tbls_ok))
+        return FALSE;
+    }
+    return TRUE;
+  }
+  case Item::COND_ITEM:
+  {
+    List_iterator<Item> li(*((Item_cond*) item)->argument_list());
+    Item *child;
+    while ((child= li++))
+    {
+      if (!uses_index_fields_only(child, tbl, keyno, other_tbls_ok))
+        return FALSE;
+    }
+    return TRUE;
+  }
+  case Item::FIELD_ITEM:
+  {
+    Field *field= ((Item_field*) item)->field;
+    if (field->table != tbl)
+      return other_tbls_ok;
+    /* part_of_key is only set for columns that the index stores in full */
+    return field->part_of_key.is_set(keyno);
+  }
+  case Item::REF_ITEM:
+    return uses_index_fields_only(item->real_item(), tbl, keyno,
+                                  other_tbls_ok);
+  default:
+    return FALSE;
+  }
+}
+
+
+/**
+  Extract the part of a condition that can be checked on the index entries.
+
+  @param cond           The table condition
+  @param table          The table the index belongs to
+  @param keyno          The index number
+  @param other_tbls_ok  TRUE <=> fields of other tables are allowed
+
+  @note
+    The conjuncts of an AND are examined separately; any other condition,
+    an OR included, is either pushed as a whole or not at all.
+    make_cond_remainder() must extract exactly the complementary part.
+
+  @return
+    The index condition, or NULL if no part of cond can be pushed
+*/
+
+static COND *make_cond_for_index(COND *cond, TABLE *table, uint keyno,
+                                 bool other_tbls_ok)
+{
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    table_map used_tables= 0;
+    Item_cond_and *new_cond= new Item_cond_and;
+    if (!new_cond)
+      return (COND*) 0;
+    List_iterator<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+    {
+      Item *fix= make_cond_for_index(item, table, keyno, other_tbls_ok);
+      if (fix)
+      {
+        new_cond->argument_list()->push_back(fix);
+        used_tables|= fix->used_tables();
+      }
+    }
+    switch (new_cond->argument_list()->elements) {
+    case 0:
+      return (COND*) 0;
+    case 1:
+      return new_cond->argument_list()->head();
+    default:
+      new_cond->quick_fix_field();
+      new_cond->used_tables_cache= used_tables;
+      return new_cond;
+    }
+  }
+
+  if (!uses_index_fields_only(cond, table, keyno, other_tbls_ok))
+    return (COND*) 0;
+  return cond;
+}
+
+
+/**
+  Extract the part of a condition that make_cond_for_index() leaves out,
+  which must still be checked on the complete rows.
+
+  @return
+    The remaining condition, or NULL if all of cond was pushed
+*/
+
+static COND *make_cond_remainder(COND *cond, TABLE *table, uint keyno,
+                                 bool other_tbls_ok)
+{
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    table_map used_tables= 0;
+    Item_cond_and *new_cond= new Item_cond_and;
+    if (!new_cond)
+      return cond;                              // Check it all at the top
+    List_iterator<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+    {
+      Item *fix= make_cond_remainder(item, table, keyno, other_tbls_ok);
+      if (fix)
+      {
+        new_cond->argument_list()->push_back(fix);
+        used_tables|= fix->used_tables();
+      }
+    }
+    switch (new_cond->argument_list()->elements) {
+    case 0:
+      return (COND*) 0;
+    case 1:
+      return new_cond->argument_list()->head();
+    default:
+      new_cond->quick_fix_field();
+      new_cond->used_tables_cache= used_tables;
+      ((Item_cond*) new_cond)->top_level_item();
+      return new_cond;
+    }
+  }
+
+  if (uses_index_fields_only(cond, table, keyno, other_tbls_ok))
+    return (COND*) 0;
+  return cond;
+}
+
+
+/**
+  Push the part of a table condition that only refers to the columns of
+  the index used to read the table down to the storage engine, so that
+  index entries that do not satisfy it are skipped before the rest of the
+  row is read.
+
+  @param tab            A join tab that reads its rows through an index
+  @param keyno          The index that the rows are read through
+  @param other_tbls_ok  TRUE <=> the condition may refer to fields of the
+                        preceding tables
+*/
+
+static void push_index_cond(JOIN_TAB *tab, uint keyno, bool other_tbls_ok)
+{
+  TABLE *table= tab->table;
+  THD *thd= tab->join->thd;
+  COND *idx_cond;
+  COND *idx_remainder_cond;
+  COND *row_cond;
+  DBUG_ENTER("push_index_cond");
+
+  if (!tab->select_cond ||
+      !(thd->variables.optimizer_switch &
+        OPTIMIZER_SWITCH_INDEX_CONDITION_PUSHDOWN) ||
+      !(table->file->index_flags(keyno, 0, 1) & HA_DO_INDEX_COND_PUSHDOWN) ||
+      table->key_read ||
+      thd->lex->sql_command == SQLCOM_UPDATE_MULTI ||
+      thd->lex->sql_command == SQLCOM_DELETE_MULTI ||
+      (keyno == table->s->primary_key &&
+       table->file->primary_key_is_clustered()))
+    DBUG_VOID_RETURN;
+
+  /* A guarded ref access may fall back to a full scan of the index */
+  for (uint i= 0; i < tab->ref.key_parts; i++)
+  {
+    if (tab->ref.cond_guards[i])
+      DBUG_VOID_RETURN;
+  }
+
+  if (!(idx_cond= make_cond_for_index(tab->select_cond, table, keyno,
+                                      other_tbls_ok)))
+    DBUG_VOID_RETURN;
+
+  idx_remainder_cond= table->file->idx_cond_push(keyno, idx_cond);
+  if (idx_remainder_cond == idx_cond)
+    DBUG_VOID_RETURN;                           // Nothing was pushed
+
+  DBUG_EXECUTE("where",
+               print_where(idx_cond, "index condition", QT_ORDINARY););
+
+  row_cond= make_cond_remainder(tab->select_cond, table, keyno,
+                                other_tbls_ok);
+  if ((row_cond= and_conds(row_cond, idx_remainder_cond)) && !row_cond->fixed)
+    row_cond->quick_fix_field();
+
+  if (tab->select)
+  {
+    if (tab->select->cond == tab->select_cond)
+      tab->select->cond= row_cond;
+    else if (tab->select->cond)
+    {
+      COND *sel_cond= make_cond_remainder(tab->select->cond, table, keyno,
+                                          other_tbls_ok);
+      if ((sel_cond= and_conds(sel_cond, idx_remainder_cond)) &&
+          !sel_cond->fixed)
+        sel_cond->quick_fix_field();
+      tab->select->cond= sel_cond;
+    }
+  }
+  tab->select_cond= row_cond;
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Take back the index condition that push_index_cond() pushed for a join
+  tab if the tab is no longer read through a range or ref access on that
+  index, e.g. because test_if_skip_sort_order() chose another index.
+
+  @param tab            The join tab whose access method may have changed
+*/
+
+static void revise_pushed_index_cond(JOIN_TAB *tab)
+{
+  handler *file= tab->table->file;
+  COND *idx_cond= file->pushed_idx_cond;
+  uint keyno= MAX_KEY;
+
+  if (!idx_cond)
+    return;
+
+  switch (tab->type) {
+  case JT_EQ_REF:
+  case JT_REF:
+  case JT_REF_OR_NULL:
+    keyno= tab->ref.key;
+    break;
+  case JT_ALL:
+    if (tab->use_quick != 2 && tab->select && tab->select->quick &&
+        (tab->select->quick->get_type() == QUICK_SELECT_I::QS_TYPE_RANGE ||
+         tab->select->quick->get_type() ==
+         QUICK_SELECT_I::QS_TYPE_RANGE_DESC))
+      keyno= tab->select->quick->index;
+    break;
+  default:
+    break;
+  }
+
+  if (keyno == file->pushed_idx_cond_keyno)
+    return;
+
+  file->cancel_pushed_idx_cond();
+
+  COND *old_select_cond= tab->select_cond;
+  if ((tab->select_cond= and_conds(old_select_cond, idx_cond)) &&
+      !tab->select_cond->fixed)
+    tab->select_cond->quick_fix_field();
+  if (tab->select)
+  {
+    if (tab->select->cond == old_select_cond)
+      tab->select->cond= tab->select_cond;
+    else if ((tab->select->cond= and_conds(tab->select->cond, idx_cond)) &&
+             !tab->select->cond->fixed)
+      tab->select->cond->quick_fix_field();
+  }
+}
+
+
 static void
 make_join_readinfo(JOIN *join, ulonglong options)
 {
@@ -6937,9 +7255,48 @@ make_join_readinfo(JOIN *join, ulonglong options)
       tab->quick=0;
       /* fall through */
     case JT_CONST:				// Only happens with left join
+      /*
+        Batched key access: cache the records of the preceding tables
+        like for a full join, and read the keys of all of them with one
+        multi-range read.
+      */
+      if ((tab->type == JT_REF || tab->type == JT_EQ_REF) &&
+          i != join->const_tables && !(options & SELECT_NO_JOIN_CACHE) &&
+          (join->thd->variables.optimizer_switch & OPTIMIZER_SWITCH_BKA) &&
+          !tab->first_inner && !ordered_set &&
+          (tab->ref.depend_map & ~OUTER_REF_TABLE_BIT))
+      {
+        uint part;
+        for (part= 0; part < tab->ref.key_parts; part++)
+        {
+          if (tab->ref.cond_guards[part])
+            break;
+        }
+        if (part == tab->ref.key_parts)
+        {
+          tab->cache.bka= TRUE;
+          if ((options & SELECT_DESCRIBE) ||
+              !join_init_cache(join->thd,join->join_tab+join->const_tables,
+                               i-join->const_tables))
+            tab[-1].next_select=sub_select_cache; /* Patch previous */
+          else
+            tab->cache.bka= FALSE;
+        }
+      }
       if (table->covering_keys.is_set(tab->ref.key) &&
 	  !table->no_keyread)
         table->set_keyread(TRUE);
+      else if (tab->type != JT_CONST)
+      {
+        /*
+          An eq_ref access caches the row it found for a key value, and a
+          batched key access reads the rows for many records of the
+          preceding tables at once, so their index conditions must not
+          depend on the preceding tables.
+        */
+        push_index_cond(tab, tab->ref.key,
+                        tab->type != JT_EQ_REF && !tab->cache.bka);
+      }
       break;
     case JT_ALL:
       /*
@@ -7020,6 +7377,10 @@ make_join_readinfo(JOIN *join, ulonglong options)
 	    tab->type=JT_NEXT;		// Read with index_first / index_next
 	  }
 	}
+        if (tab->select && tab->select->quick &&
+            tab->select->quick->get_type() == QUICK_SELECT_I::QS_TYPE_RANGE &&
+            !table->key_read)
+          push_index_cond(tab, tab->select->quick->index, FALSE);
       }
       break;
     case JT_FT:
@@ -7083,6 +7444,11 @@ void JOIN_TAB::cleanup()
   quick= 0;
   my_free(cache.buff);
   cache.buff= 0;
+  my_free(cache.ranges);
+  cache.ranges= 0;
+  cache.max_ranges= 0;
+  my_free(cache.mrr_buff);
+  cache.mrr_buff= 0;
   limit= 0;
   if (table)
   {
@@ -12082,6 +12448,11 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skip_last)
   join_tab->table->null_row= 0;
   if (!join_tab->cache.records)
     return NESTED_LOOP_OK;                      /* Nothing to do */
+  if (join_tab->cache.bka)
+  {
+    DBUG_ASSERT(!skip_last);
+    return flush_cached_records_bka(join, join_tab);
+  }
   if (skip_last)
     (void) store_record_in_cache(&join_tab->cache); // Must save this for later
   if (join_tab->use_quick == 2)
@@ -12162,6 +12533,145 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skip_last)
 }
 
 
+/**
+  Join the records in the join buffer with a ref or eq_ref table by
+  batched key access.
+
+  The key of each cached record is built into a key equality range, the
+  ranges are read with one multi-range read of the inner table, and each
+  row that it returns is joined with the cached record of its range. This
+  lets a handler that sorts the rows of a multi-range read by their
+  position (see DsMrr_impl) read the inner table in one sweep.
+
+  @param join      Join
+  @param join_tab  The inner table; its cache holds the records of the
+                   preceding tables
+*/
+
+static enum_nested_loop_state
+flush_cached_records_bka(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  TABLE *table= join_tab->table;
+  TABLE_REF *ref= &join_tab->ref;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  KEY_MULTI_RANGE *range;
+  uint n_ranges= 0;
+  int error= HA_ERR_END_OF_FILE;
+
+  if (cache->records > cache->max_ranges)
+  {
+    uint count= cache->records;
+    my_free(cache->ranges);
+    cache->max_ranges= 0;
+    if (!(cache->ranges= (KEY_MULTI_RANGE*)
+          my_multi_malloc(MYF(MY_WME),
+                          &cache->ranges, count * sizeof(KEY_MULTI_RANGE),
+                          &cache->range_records, count * sizeof(uint),
+                          &cache->range_keys, count * ref->key_length,
+                          NullS)))
+    {
+      reset_cache_write(cache);
+      return NESTED_LOOP_ERROR;
+    }
+    cache->max_ranges= count;
+  }
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+
+  /* Build the key of each cached record, as join_read_always_key() does */
+  reset_cache_read(cache);
+  for (uint i= 0; i < cache->records; i++)
+  {
+    uchar *record= cache->pos;
+    uchar *key;
+    uint part;
+
+    read_cached_record(join_tab);
+    for (part= 0; part < ref->key_parts; part++)
+    {
+      if ((ref->null_rejecting & ((key_part_map)1 << part)) &&
+          ref->items[part]->is_null())
+        break;
+    }
+    if (part < ref->key_parts || cp_buffer_from_ref(join->thd, table, ref))
+      continue;                                 // Matches no row
+
+    key= cache->range_keys + n_ranges * ref->key_length;
+    memcpy(key, ref->key_buff, ref->key_length);
+    range= cache->ranges + n_ranges;
+    range->start_key.key= key;
+    range->start_key.length= ref->key_length;
+    range->start_key.keypart_map= make_prev_keypart_map(ref->key_parts);
+    range->start_key.flag= HA_READ_KEY_EXACT;
+    range->end_key= range->start_key;
+    range->end_key.flag= HA_READ_AFTER_KEY;
+    range->range_flag= EQ_RANGE;
+    if (join_tab->type == JT_EQ_REF)
+      range->range_flag|= UNIQUE_RANGE;
+    range->ptr= (char*) record;
+    cache->range_records[n_ranges++]= i;
+  }
+
+  if (n_ranges)
+  {
+    if (!table->file->inited &&
+        (error= table->file->ha_index_init(ref->key, 0)))
+      goto end;
+
+    error= table->file->read_multi_range_first(&range, cache->ranges,
+                                               n_ranges, FALSE,
+                                               cache->mrr_buff);
+    while (!error)
+    {
+      if (join->thd->killed)
+      {
+        join->thd->send_kill_message();
+        rc= NESTED_LOOP_KILLED;
+        break;
+      }
+
+      /* Restore the cached record that the row was found for */
+      cache->pos= (uchar*) range->ptr;
+      cache->record_nr= cache->range_records[range - cache->ranges];
+      read_cached_record(join_tab);
+      table->status= 0;
+      table->null_row= 0;
+
+      if (!join_tab->select_cond || join_tab->select_cond->val_int())
+      {
+        rc= (join_tab->next_select)(join, join_tab+1, 0);
+        if (rc != NESTED_LOOP_OK)
+          break;
+      }
+      else if (join->thd->is_error())
+      {
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+      error= table->file->read_multi_range_next(&range);
+    }
+  }
+
+end:
+  reset_cache_write(cache);
+  if (rc == NESTED_LOOP_OK && error != HA_ERR_END_OF_FILE)
+  {
+    report_error(table, error);
+    return NESTED_LOOP_ERROR;
+  }
+  if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+    return rc;
+  for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+    tmp2->table->status=tmp2->status;
+  return NESTED_LOOP_OK;
+}
+
+
 /*****************************************************************************
   The different ways to read a record
   Returns -1 if row was not found, 0 if row was found and 1 on errors
@@ -14143,6 +14653,7 @@ skipped_filesort:
     delete save_quick;
     save_quick= NULL;
   }
+  revise_pushed_index_cond(tab);
   DBUG_RETURN(1);
 
 use_filesort:
@@ -14152,6 +14663,7 @@ use_filesort:
     delete select->quick;
     select->quick= save_quick;
   }
+  revise_pushed_index_cond(tab);
   DBUG_RETURN(0);
 }
 
@@ -14798,6 +15310,29 @@ join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count)
   if (!(cache->buff=(uchar*) my_malloc(size,MYF(0))))
     DBUG_RETURN(1);				/* Don't use cache */ /* purecov: inspected */
   cache->end=cache->buff+size;
+
+  cache->ranges= 0;
+  cache->max_ranges= 0;
+  cache->mrr_buff= 0;
+  if (cache->bka &&
+      (tables[table_count].table->file->ha_table_flags() &
+       HA_NEED_READ_RANGE_BUFFER))
+  {
+    uchar *mrr_buff;
+    size= thd->variables.read_rnd_buff_size;
+    if (!my_multi_malloc(MYF(0),
+                         &cache->mrr_buff, (uint) sizeof(*cache->mrr_buff),
+                         &mrr_buff, (uint) size,
+                         NullS))
+    {
+      my_free(cache->buff);
+      cache->buff= 0;
+      DBUG_RETURN(1);
+    }
+    cache->mrr_buff->buffer= mrr_buff;
+    cache->mrr_buff->buffer_end= mrr_buff + size;
+    cache->mrr_buff->end_of_used_area= mrr_buff;
+  }
   reset_cache_write(cache);
   DBUG_RETURN(0);
 }
@@ -17201,6 +17736,8 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
           extra.append(STRING_WITH_LEN("; Using "));
           tab->select->quick->add_info_string(&extra);
         }
+        if (table->file->pushed_idx_cond)
+          extra.append(STRING_WITH_LEN("; Using index condition"));
 	if (tab->select)
 	{
 	  if (tab->use_quick == 2)
@@ -17261,6 +17798,10 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
           else
             extra.append(STRING_WITH_LEN("; Using index"));
         }
+        else if (quick_type == QUICK_SELECT_I::QS_TYPE_RANGE &&
+                 table->file->read_multi_range_sweeps(tab->select->quick->index,
+                                                      tab->select->quick->sorted))
+          extra.append(STRING_WITH_LEN("; Using MRR"));
 	if (table->reginfo.not_exists_optimize)
 	  extra.append(STRING_WITH_LEN("; Not exists"));
 	if (need_tmp_table)
@@ -17285,7 +17826,11 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
           }
         }
         if (i > 0 && tab[-1].next_select == sub_select_cache)
+        {
           extra.append(STRING_WITH_LEN("; Using join buffer"));
+          if (tab->cache.bka)
+            extra.append(STRING_WITH_LEN(" (Batched Key Access)"));
+        }
         
         /* Skip initial "; "*/
         const char *str= extra.ptr();
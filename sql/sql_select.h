@@ -124,6 +124,21 @@ typedef struct st_join_cache {
   uint records,record_nr,ptr_record,fields,length,blobs;
   CACHE_FIELD *field,**blob_ptr;
   SQL_SELECT *select;
+  /**
+    Batched key access: the inner table is a ref or eq_ref table that is
+    read with one multi-range read for all the cached records
+  */
+  bool bka;
+  /** Number of records that ranges, range_records and range_keys hold */
+  uint max_ranges;
+  /** One key equality range per cached record, ptr is the record */
+  KEY_MULTI_RANGE *ranges;
+  /** Number of the cached record of each range */
+  uint *range_records;
+  /** Key values of the ranges */
+  uchar *range_keys;
+  /** Buffer for the multi-range read, or NULL */
+  HANDLER_BUFFER *mrr_buff;
 } JOIN_CACHE;
 
 
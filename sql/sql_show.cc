@@ -1350,6 +1350,20 @@ int store_create_info(THD *thd, TABLE_LIST *table_list, String *packet,
         !(thd->variables.sql_mode & MODE_NO_FIELD_OPTIONS))
       packet->append(STRING_WITH_LEN(" AUTO_INCREMENT"));
 
+    switch (field->column_format()) {
+    case COLUMN_FORMAT_TYPE_DEFAULT:
+      break;
+    case COLUMN_FORMAT_TYPE_FIXED:
+      packet->append(STRING_WITH_LEN(" COLUMN_FORMAT FIXED"));
+      break;
+    case COLUMN_FORMAT_TYPE_DYNAMIC:
+      packet->append(STRING_WITH_LEN(" COLUMN_FORMAT DYNAMIC"));
+      break;
+    case COLUMN_FORMAT_TYPE_COMPRESSED:
+      packet->append(STRING_WITH_LEN(" COLUMN_FORMAT COMPRESSED"));
+      break;
+    }
+
     if (field->comment.length)
     {
       packet->append(STRING_WITH_LEN(" COMMENT "));
@@ -5045,6 +5045,13 @@ mysql_compare_tables(TABLE *table,
       DBUG_RETURN(0);
     }
 
+    /* The storage engine may store the columns of a format differently */
+    if (tmp_new_field->column_format() != field->column_format())
+    {
+      *need_copy_table= ALTER_TABLE_DATA_CHANGED;
+      DBUG_RETURN(0);
+    }
+
     /* Don't pack rows in old tables if the user has requested this. */
     if (create_info->row_type == ROW_TYPE_DYNAMIC ||
 	(tmp_new_field->flags & BLOB_FLAG) ||
@@ -879,6 +879,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
 %token  COLLATION_SYM                 /* SQL-2003-N */
 %token  COLUMNS
 %token  COLUMN_SYM                    /* SQL-2003-R */
+%token  COLUMN_FORMAT_SYM
 %token  COLUMN_NAME_SYM               /* SQL-2003-N */
 %token  COMMENT_SYM
 %token  COMMITTED_SYM                 /* SQL-2003-N */
@@ -973,6 +974,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
 %token  EXISTS                        /* SQL-2003-R */
 %token  EXIT_SYM
 %token  EXPANSION_SYM
+%token  EXPORT_SYM
 %token  EXTENDED_SYM
 %token  EXTENT_SIZE_SYM
 %token  EXTRACT_SYM                   /* SQL-2003-N */
@@ -1455,6 +1457,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
 
 %type <num>
         type type_with_opt_collate int_type real_type order_dir lock_option
+        column_format_type
         udf_type if_exists opt_local opt_table_options table_options
         table_option opt_if_not_exists opt_no_write_to_binlog
         opt_temporary all_or_any opt_distinct
@@ -5781,6 +5784,11 @@ attribute:
             lex->alter_info.flags|= ALTER_ADD_INDEX; 
           }
         | COMMENT_SYM TEXT_STRING_sys { Lex->comment= $2; }
+        | COLUMN_FORMAT_SYM column_format_type
+          {
+            Lex->type&= ~(FIELD_FLAGS_COLUMN_FORMAT_MASK);
+            Lex->type|= ($2 << FIELD_FLAGS_COLUMN_FORMAT);
+          }
         | COLLATE_SYM collation_name
           {
             if (Lex->charset && !my_charset_same(Lex->charset,$2))
@@ -5796,6 +5804,12 @@ attribute:
           }
         ;
 
+column_format_type:
+          DEFAULT        { $$= COLUMN_FORMAT_TYPE_DEFAULT; }
+        | FIXED_SYM      { $$= COLUMN_FORMAT_TYPE_FIXED; }
+        | DYNAMIC_SYM    { $$= COLUMN_FORMAT_TYPE_DYNAMIC; }
+        | COMPRESSED_SYM { $$= COLUMN_FORMAT_TYPE_COMPRESSED; }
+        ;
 
 type_with_opt_collate:
         type opt_collate
@@ -11534,6 +11548,23 @@ opt_with_read_lock:
               tables->open_type= OT_BASE_ONLY;      /* Ignore temporary tables. */
             }
           }
+        | FOR_SYM EXPORT_SYM
+          {
+            TABLE_LIST *tables= Lex->query_tables;
+            if (tables == NULL)
+            {
+              /* FLUSH TABLES FOR EXPORT requires a table list. */
+              my_parse_error(ER(ER_SYNTAX_ERROR));
+              MYSQL_YYABORT;
+            }
+            Lex->type|= REFRESH_FOR_EXPORT;
+            for (; tables; tables= tables->next_global)
+            {
+              tables->mdl_request.set_type(MDL_SHARED_NO_WRITE);
+              tables->required_type= FRMTYPE_TABLE; /* Don't try to flush views. */
+              tables->open_type= OT_BASE_ONLY;      /* Ignore temporary tables. */
+            }
+          }
         ;
 
 flush_options_list:
@@ -12737,6 +12768,7 @@ keyword_sp:
         | COALESCE                 {}
         | CODE_SYM                 {}
         | COLLATION_SYM            {}
+        | COLUMN_FORMAT_SYM        {}
         | COLUMN_NAME_SYM          {}
         | COLUMNS                  {}
         | COMMITTED_SYM            {}
@@ -12781,6 +12813,7 @@ keyword_sp:
         | EVENTS_SYM               {}
         | EVERY_SYM                {}
         | EXPANSION_SYM            {}
+        | EXPORT_SYM               {}
         | EXTENDED_SYM             {}
         | EXTENT_SIZE_SYM          {}
         | FAULTS_SYM               {}
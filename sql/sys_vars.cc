@@ -1550,7 +1550,7 @@ static const char *optimizer_switch_names[]=
 {
   "index_merge", "index_merge_union", "index_merge_sort_union",
   "index_merge_intersection", "engine_condition_pushdown",
-  "default", NullS
+  "index_condition_pushdown", "mrr", "batched_key_access", "default", NullS
 };
 /** propagates changes to @@engine_condition_pushdown */
 static bool fix_optimizer_switch(sys_var *self, THD *thd,
@@ -1565,7 +1565,8 @@ static Sys_var_flagset Sys_optimizer_switch(
        "optimizer_switch",
        "optimizer_switch=option=val[,option=val...], where option is one of "
        "{index_merge, index_merge_union, index_merge_sort_union, "
-       "index_merge_intersection, engine_condition_pushdown}"
+       "index_merge_intersection, engine_condition_pushdown, "
+       "index_condition_pushdown, mrr, batched_key_access}"
        " and val is one of {on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
@@ -1738,7 +1739,8 @@ static Sys_var_mybool Sys_thread_statistics(
 static Sys_var_ulong Sys_read_rnd_buff_size(
        "read_rnd_buffer_size",
        "When reading rows in sorted order after a sort, the rows are read "
-       "through this buffer to avoid a disk seeks",
+       "through this buffer to avoid a disk seeks. A multi-range read "
+       "sorts the row ids that it collects in a buffer of this size",
        SESSION_VAR(read_rnd_buff_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(1, INT_MAX32), DEFAULT(256*1024), BLOCK_SIZE(1));
 
@@ -1494,7 +1494,8 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
       DBUG_PRINT("debug", ("field flags: %u, storage: %u, column_format: %u",
                            field_flags, field_storage, field_column_format));
       (void)field_storage; /* Reserved by and used in MySQL Cluster */
-      (void)field_column_format; /* Reserved by and used in MySQL Cluster */
+      reg_field->flags|= ((uint) (field_column_format & 3)
+                          << FIELD_FLAGS_COLUMN_FORMAT);
     }
   }
   *field_ptr=0;					// End marker
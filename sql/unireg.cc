@@ -399,7 +399,7 @@ bool mysql_create_frm(THD *thd, const char *file_name,
     while ((field=it++))
     {
       const uchar field_storage= 0; /* Used in MySQL Cluster */
-      const uchar field_column_format= 0; /* Used in MySQL Cluster */
+      const uchar field_column_format= (uchar) field->column_format();
       const uchar field_flags=
         field_storage + (field_column_format << COLUMN_FORMAT_SHIFT);
       *ptr= field_flags;
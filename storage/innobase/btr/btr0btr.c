@@ -886,7 +886,7 @@ btr_get_next_user_rec(
 /**************************************************************//**
 Creates a new index page (not the root, and also not
 used in page reorganization).  @see btr_page_empty(). */
-static
+UNIV_INTERN
 void
 btr_page_create(
 /*============*/
@@ -1047,15 +1047,18 @@ btr_get_size(
 	dict_index_t*	index,	/*!< in: index */
 	ulint		flag,	/*!< in: BTR_N_LEAF_PAGES or BTR_TOTAL_SIZE */
 	mtr_t*		mtr)	/*!< in/out: mini-transaction where index
-				is s-latched */
+				is sx-latched */
 {
 	fseg_header_t*	seg_header;
 	page_t*		root;
 	ulint		n;
 	ulint		dummy;
 
+	/* The root page is latched before the tablespace latch, while a
+	structure modification takes them in the opposite order.  An
+	s-latch on the tree would not exclude the modification. */
 	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_S_LOCK));
+				MTR_MEMO_SX_LOCK));
 
 	if (index->page == FIL_NULL
 	    || index->to_be_dropped
@@ -1255,8 +1258,7 @@ btr_page_get_father_node_ptr_func(
 	page_no = buf_block_get_page_no(btr_cur_get_block(cursor));
 	index = btr_cur_get_index(cursor);
 
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 
 	ut_ad(dict_index_get_page(index) != page_no);
 
@@ -1800,7 +1802,7 @@ btr_parse_page_reorganize(
 #ifndef UNIV_HOTBACKUP
 /*************************************************************//**
 Empties an index page.  @see btr_page_create(). */
-static
+UNIV_INTERN
 void
 btr_page_empty(
 /*===========*/
@@ -1889,8 +1891,7 @@ btr_root_raise_and_insert(
 
 	ut_a(dict_index_get_page(index) == page_get_page_no(root));
 #endif /* UNIV_BTR_DEBUG */
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 	ut_ad(mtr_memo_contains(mtr, root_block, MTR_MEMO_PAGE_X_FIX));
 
 	/* Allocate a new page to the tree. Root splitting is done by first
@@ -2580,8 +2581,9 @@ btr_page_tuple_smaller(
 
 /*************************************************************//**
 Splits an index page to halves and inserts the tuple. It is assumed
-that mtr holds an x-latch to the index tree. NOTE: the tree x-latch is
-released within this function! NOTE that the operation of this
+that mtr holds an x-latch or sx-latch to the index tree. NOTE: the tree
+latch is released within this function, unless
+BTR_PAGE_SPLIT_KEEP_TREE_LATCH_FLAG is set! NOTE that the operation of this
 function must always succeed, we cannot reverse it: therefore enough
 free disk space (2 pages) must be guaranteed to be available before
 this function is called.
@@ -2630,10 +2632,10 @@ func_start:
 	mem_heap_empty(heap);
 	offsets = NULL;
 
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(cursor->index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(cursor->index, mtr));
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_EX));
+	ut_ad(rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_EX)
+	      || rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_SX));
 #endif /* UNIV_SYNC_DEBUG */
 
 	block = btr_cur_get_block(cursor);
@@ -2760,10 +2762,11 @@ insert_empty:
 						NULL, tuple, n_ext, heap);
 	}
 
-	if (insert_will_fit && page_is_leaf(page)) {
+	if (insert_will_fit && page_is_leaf(page)
+	    && !(flags & BTR_PAGE_SPLIT_KEEP_TREE_LATCH_FLAG)) {
 
 		mtr_memo_release(mtr, dict_index_get_lock(cursor->index),
-				 MTR_MEMO_X_LOCK);
+				 BTR_TREE_MODIFY_MEMO(cursor->index));
 	}
 
 	/* 5. Move then the records to the new page */
@@ -3349,8 +3352,7 @@ btr_compress(
 
 	btr_assert_not_corrupted(block, index);
 
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
 	space = dict_index_get_space(index);
 	zip_size = dict_table_zip_size(index->table);
@@ -3705,8 +3707,7 @@ btr_discard_page(
 	index = btr_cur_get_index(cursor);
 
 	ut_ad(dict_index_get_page(index) != buf_block_get_page_no(block));
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
 	space = dict_index_get_space(index);
 	zip_size = dict_table_zip_size(index->table);
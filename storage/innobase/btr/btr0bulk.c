@@ -0,0 +1,828 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.c
+Bottom-up B-tree bulk load
+*******************************************************/
+
+#include "btr0bulk.h"
+
+#ifndef UNIV_HOTBACKUP
+
+#include "btr0btr.h"
+#include "buf0flu.h"
+#include "dict0dict.h"
+#include "fil0fil.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
+#include "lock0lock.h"
+#include "log0log.h"
+#include "mtr0mtr.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "rem0rec.h"
+#include "srv0srv.h"
+
+/** One level of an index tree that is being built */
+typedef struct btr_bulk_level_struct	btr_bulk_level_t;
+
+/** One level of an index tree that is being built */
+struct btr_bulk_level_struct {
+	mtr_t		mtr[2];		/*!< mini-transactions without redo
+					logging; mtr[cur] latches block, and
+					the other one is used for allocating
+					the next page of the level */
+	ulint		cur;		/*!< index of the active mtr */
+	buf_block_t*	block;		/*!< page being filled, or NULL */
+	page_cur_t	page_cur;	/*!< the last record inserted to
+					block */
+	ulint		first_page_no;	/*!< leftmost page of the level,
+					or FIL_NULL */
+	mem_heap_t*	heap;		/*!< node pointers to the pages of
+					this level */
+};
+
+/** Bulk load of an index tree */
+struct btr_bulk_struct {
+	dict_index_t*	index;		/*!< index */
+	trx_id_t	trx_id;		/*!< PAGE_MAX_TRX_ID of secondary
+					index leaf pages */
+	ulint		fill_limit;	/*!< a page is not filled beyond
+					this many bytes */
+	ulint		n_levels;	/*!< number of levels started */
+	btr_bulk_level_t*levels[BTR_MAX_LEVELS];/*!< the levels, leaf first */
+	ulint		top_page_no;	/*!< after btr_bulk_end(): the only
+					page of the highest level, or
+					FIL_NULL if the tree is empty */
+	ibool		ended;		/*!< TRUE after btr_bulk_end() */
+	byte*		write_buf;	/*!< aligned buffer for writing a
+					finished page to the data file */
+	mem_heap_t*	heap;		/*!< memory heap for this struct
+					and the levels */
+};
+
+/*********************************************************************//**
+Checks whether an index tree can be bulk loaded. The tree must be empty,
+uncompressed, and every entry must fit on an index page without storing
+any column externally.
+@return	TRUE if btr_bulk_create() can be used on the index */
+UNIV_INTERN
+ibool
+btr_bulk_is_applicable(
+/*===================*/
+	dict_index_t*	index)	/*!< in: index */
+{
+	ulint		comp	= dict_table_is_comp(index->table);
+	ulint		size;
+	ulint		i;
+	mtr_t		mtr;
+	const page_t*	root;
+	ibool		empty;
+
+	if (dict_index_is_ibuf(index)
+	    || dict_table_zip_size(index->table)
+	    || index->to_be_dropped) {
+
+		return(FALSE);
+	}
+
+	/* Bound the size of an entry from above. An entry that may
+	exceed half of an empty page could need externally stored
+	columns, which are not supported here, and would also break
+	the guarantee that every page of the tree holds at least two
+	records. */
+
+	size = comp
+		? REC_N_NEW_EXTRA_BYTES + UT_BITS_IN_BYTES(index->n_nullable)
+		: REC_N_OLD_EXTRA_BYTES;
+
+	for (i = 0; i < dict_index_get_n_fields(index); i++) {
+		const dict_field_t*	field
+			= dict_index_get_nth_field(index, i);
+		ulint			max_size
+			= dict_col_get_max_size(dict_field_get_col(field));
+
+		if (field->prefix_len && field->prefix_len < max_size) {
+			max_size = field->prefix_len;
+		}
+
+		if (max_size >= UNIV_PAGE_SIZE) {
+
+			return(FALSE);
+		}
+
+		/* Two bytes for the length or the end offset */
+		size += max_size + 2;
+	}
+
+	if (size > page_get_free_space_of_empty(comp) / 2) {
+
+		return(FALSE);
+	}
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+	root = btr_root_get(index, &mtr);
+	empty = page_is_leaf(root) && !page_get_n_recs(root);
+	mtr_commit(&mtr);
+
+	return(empty);
+}
+
+/*********************************************************************//**
+Starts a bulk load of an empty index tree. The pages of the new tree are
+not reachable from the root page before btr_bulk_publish(), so they are
+only latched by the mini-transactions that fill them; the index tree latch
+is acquired only for allocating pages.
+@return	own: bulk load */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index, btr_bulk_is_applicable() */
+	trx_id_t	trx_id)	/*!< in: PAGE_MAX_TRX_ID of secondary index
+				leaf pages */
+{
+	btr_bulk_t*	bulk;
+	mem_heap_t*	heap;
+	ulint		free_space;
+
+	heap = mem_heap_create(sizeof *bulk + 2 * sizeof(btr_bulk_level_t)
+			       + 2 * UNIV_PAGE_SIZE);
+	bulk = mem_heap_zalloc(heap, sizeof *bulk);
+
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->top_page_no = FIL_NULL;
+	bulk->heap = heap;
+	bulk->write_buf = ut_align(mem_heap_alloc(heap, 2 * UNIV_PAGE_SIZE),
+				   UNIV_PAGE_SIZE);
+
+	/* Leave the same space free for updates as the B-tree code
+	does for consecutive inserts (innodb_index_fill_factor). */
+	free_space = page_get_free_space_of_empty(
+		dict_table_is_comp(index->table));
+
+	bulk->fill_limit = free_space > dict_index_get_space_reserve()
+		? free_space - dict_index_get_space_reserve()
+		: 0;
+
+	return(bulk);
+}
+
+/*********************************************************************//**
+Writes a finished page of the new tree to the data file, because its
+contents are not redo logged. The page is not reachable before
+btr_bulk_publish(), so a torn write of it is harmless and the doublewrite
+buffer is not needed. The page also stays dirty in the buffer pool and is
+written again by the normal flushing. */
+static
+void
+btr_bulk_page_write(
+/*================*/
+	btr_bulk_t*		bulk,	/*!< in/out: bulk load */
+	const buf_block_t*	block)	/*!< in: x-latched finished page */
+{
+	memcpy(bulk->write_buf, buf_block_get_frame(block), UNIV_PAGE_SIZE);
+
+	/* Stamp the page with the current LSN, so that recovery does
+	not apply redo log records that were written for the page
+	before it was freed and allocated to this tree. */
+	buf_flush_init_for_writing(bulk->write_buf, NULL, log_get_lsn());
+
+	fil_io(OS_FILE_WRITE, TRUE, buf_block_get_space(block), 0,
+	       buf_block_get_page_no(block), 0, UNIV_PAGE_SIZE,
+	       bulk->write_buf, NULL);
+}
+
+/*********************************************************************//**
+Writes the current page of a level to the data file and commits the
+mini-transaction that latches it. The page is added to the flush list
+without any redo log. */
+static
+void
+btr_bulk_page_release(
+/*==================*/
+	btr_bulk_t*		bulk,	/*!< in/out: bulk load */
+	btr_bulk_level_t*	lvl,	/*!< in/out: level */
+	ulint			level)	/*!< in: level number */
+{
+	ut_ad(lvl->block);
+
+	if (level == 0 && !dict_index_is_clust(bulk->index)) {
+		/* Stale free bits could let the insert buffer
+		buffer changes that do not fit on the page. */
+		ibuf_reset_free_bits(lvl->block);
+	}
+
+	btr_bulk_page_write(bulk, lvl->block);
+
+	mtr_commit(&lvl->mtr[lvl->cur]);
+}
+
+/*********************************************************************//**
+Appends an entry to a level of the tree that is being built.
+@return	DB_SUCCESS or error code */
+static
+ulint
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	entry,	/*!< in: index entry or node pointer */
+	ulint		level);	/*!< in: level number */
+
+/*********************************************************************//**
+Releases the current page of a level, and appends a node pointer to it
+to the level above.
+@return	DB_SUCCESS or error code */
+static
+ulint
+btr_bulk_page_finish(
+/*=================*/
+	btr_bulk_t*		bulk,	/*!< in/out: bulk load */
+	btr_bulk_level_t*	lvl,	/*!< in/out: level */
+	ulint			level)	/*!< in: level number */
+{
+	const page_t*	page	= buf_block_get_frame(lvl->block);
+	dtuple_t*	node_ptr;
+	ulint		err;
+
+	ut_ad(page_get_n_recs(page) > 0);
+
+	/* The node pointer is copied to lvl->heap and stays valid
+	after the page latch is released. */
+	node_ptr = dict_index_build_node_ptr(
+		bulk->index, page_rec_get_next_const(page_get_infimum_rec(page)),
+		buf_block_get_page_no(lvl->block), lvl->heap, level);
+
+	btr_bulk_page_release(bulk, lvl, level);
+
+	err = btr_bulk_insert_low(bulk, node_ptr, level + 1);
+
+	mem_heap_empty(lvl->heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Allocates the next page of a level and makes it the current page. The
+previous page of the level is linked to it and finished.
+@return	DB_SUCCESS or error code */
+static
+ulint
+btr_bulk_page_start(
+/*================*/
+	btr_bulk_t*		bulk,	/*!< in/out: bulk load */
+	btr_bulk_level_t*	lvl,	/*!< in/out: level */
+	ulint			level)	/*!< in: level number */
+{
+	dict_index_t*	index		= bulk->index;
+	ulint		space		= dict_index_get_space(index);
+	ulint		prev_page_no	= FIL_NULL;
+	ulint		next_cur	= 0;
+	ulint		n_reserved;
+	ulint		err		= DB_SUCCESS;
+	mtr_t		alloc_mtr;
+	mtr_t*		mtr;
+	buf_block_t*	block;
+	page_t*		page;
+
+	if (lvl->block) {
+		prev_page_no = buf_block_get_page_no(lvl->block);
+		next_cur = !lvl->cur;
+	}
+
+	mtr = &lvl->mtr[next_cur];
+	mtr_start(mtr);
+	mtr_set_log_mode(mtr, MTR_LOG_NONE);
+
+	/* The allocation of the page is redo logged, but its
+	initialization and contents are not. Allocating a page of
+	the index segments requires the index tree latch, as in
+	btr_page_split_and_insert(). */
+	mtr_start(&alloc_mtr);
+	mtr_x_lock(dict_index_get_lock(index), &alloc_mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, space, 1,
+				      FSP_NORMAL, &alloc_mtr)) {
+		mtr_commit(&alloc_mtr);
+		mtr_commit(mtr);
+
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	block = btr_page_alloc(index,
+			       prev_page_no == FIL_NULL ? 0 : prev_page_no + 1,
+			       FSP_UP, level, &alloc_mtr, mtr);
+
+	fil_space_release_free_extents(space, n_reserved);
+	mtr_commit(&alloc_mtr);
+
+	if (UNIV_UNLIKELY(block == NULL)) {
+		mtr_commit(mtr);
+
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	page = buf_block_get_frame(block);
+
+	btr_page_create(block, NULL, index, level, mtr);
+	btr_page_set_next(page, NULL, FIL_NULL, mtr);
+	btr_page_set_prev(page, NULL, prev_page_no, mtr);
+
+	if (level == 0 && !dict_index_is_clust(index)) {
+		page_update_max_trx_id(block, NULL, bulk->trx_id, mtr);
+	}
+
+	if (lvl->block) {
+		btr_page_set_next(buf_block_get_frame(lvl->block), NULL,
+				  buf_block_get_page_no(block),
+				  &lvl->mtr[lvl->cur]);
+
+		err = btr_bulk_page_finish(bulk, lvl, level);
+	} else {
+		lvl->first_page_no = buf_block_get_page_no(block);
+	}
+
+	/* Even if finishing the previous page failed, the new page
+	is reachable from it, so that btr_bulk_abort() frees it. */
+	lvl->cur = next_cur;
+	lvl->block = block;
+	page_cur_set_before_first(block, &lvl->page_cur);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Appends an entry to a level of the tree that is being built.
+@return	DB_SUCCESS or error code */
+static
+ulint
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	entry,	/*!< in: index entry or node pointer */
+	ulint		level)	/*!< in: level number */
+{
+	dict_index_t*		index	= bulk->index;
+	btr_bulk_level_t*	lvl;
+	rec_t*			rec;
+	ulint			err;
+
+	if (level == bulk->n_levels) {
+		ut_a(level < BTR_MAX_LEVELS);
+
+		lvl = mem_heap_zalloc(bulk->heap, sizeof *lvl);
+		lvl->first_page_no = FIL_NULL;
+		lvl->heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+
+		bulk->levels[level] = lvl;
+		bulk->n_levels++;
+	} else {
+		lvl = bulk->levels[level];
+	}
+
+	if (lvl->block == NULL) {
+		err = btr_bulk_page_start(bulk, lvl, level);
+	} else {
+		const page_t*	page = buf_block_get_frame(lvl->block);
+		ulint		used;
+
+		used = page_get_free_space_of_empty(page_is_comp(page))
+			- page_get_max_insert_size(page, 1);
+
+		/* Every page gets at least two records, so that each
+		level has fewer pages than the one below it. */
+		if (page_get_n_recs(page) >= 2
+		    && used + rec_get_converted_size(index, entry, 0)
+		    > bulk->fill_limit) {
+
+			err = btr_bulk_page_start(bulk, lvl, level);
+		} else {
+			err = DB_SUCCESS;
+		}
+	}
+
+	if (err != DB_SUCCESS) {
+
+		return(err);
+	}
+
+	rec = page_cur_tuple_insert(&lvl->page_cur, entry, index, 0,
+				    &lvl->mtr[lvl->cur]);
+
+	if (UNIV_UNLIKELY(rec == NULL)
+	    && page_get_n_recs(buf_block_get_frame(lvl->block)) > 0) {
+		/* The fill limit is an estimate. Start a new page
+		if the entry did not fit. */
+		err = btr_bulk_page_start(bulk, lvl, level);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		rec = page_cur_tuple_insert(&lvl->page_cur, entry, index, 0,
+					    &lvl->mtr[lvl->cur]);
+	}
+
+	if (UNIV_UNLIKELY(rec == NULL)) {
+
+		return(DB_TOO_BIG_RECORD);
+	}
+
+	page_cur_position(rec, lvl->block, &lvl->page_cur);
+
+	if (level > 0
+	    && buf_block_get_page_no(lvl->block) == lvl->first_page_no
+	    && page_get_n_recs(buf_block_get_frame(lvl->block)) == 1) {
+		/* The first node pointer of each non-leaf level */
+		btr_set_min_rec_mark(rec, &lvl->mtr[lvl->cur]);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Appends an entry to the index tree that is being built. The entries must
+be passed in ascending order.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	entry)	/*!< in: index entry */
+{
+	ut_ad(!bulk->ended);
+
+	return(btr_bulk_insert_low(bulk, entry, 0));
+}
+
+/*********************************************************************//**
+Finishes the last page of every level of the tree and writes it to the
+data file. The tree is not reachable before btr_bulk_publish().
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_end(
+/*=========*/
+	btr_bulk_t*	bulk)	/*!< in/out: bulk load */
+{
+	ulint	level;
+	ulint	err	= DB_SUCCESS;
+
+	ut_ad(!bulk->ended);
+
+	/* Finishing the last page of a level may start a new page
+	on the level above it, or even a new level. */
+	for (level = 0; level < bulk->n_levels; level++) {
+		btr_bulk_level_t*	lvl = bulk->levels[level];
+
+		if (level + 1 == bulk->n_levels) {
+			ut_ad(lvl->first_page_no
+			      == buf_block_get_page_no(lvl->block));
+
+			bulk->top_page_no = lvl->first_page_no;
+			btr_bulk_page_release(bulk, lvl, level);
+			lvl->block = NULL;
+			break;
+		}
+
+		err = btr_bulk_page_finish(bulk, lvl, level);
+		lvl->block = NULL;
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	bulk->ended = TRUE;
+
+	return(err);
+}
+
+/*********************************************************************//**
+Frees the levels of a bulk load and the bulk load. */
+static
+void
+btr_bulk_free(
+/*==========*/
+	btr_bulk_t*	bulk)	/*!< in,own: bulk load */
+{
+	ulint	level;
+
+	for (level = 0; level < bulk->n_levels; level++) {
+		ut_ad(bulk->levels[level]->block == NULL);
+		mem_heap_free(bulk->levels[level]->heap);
+	}
+
+	mem_heap_free(bulk->heap);
+}
+
+/*********************************************************************//**
+Makes the trees of ended bulk loads reachable from the root pages of their
+indexes, writes the redo log of that to disk, and frees the bulk loads.
+All the trees are published in one mini-transaction, so that after a crash
+either all or none of the indexes of a table contain the loaded entries. */
+UNIV_INTERN
+void
+btr_bulk_publish(
+/*=============*/
+	btr_bulk_t**	bulk,	/*!< in,own: ended bulk loads */
+	ulint		n_bulk)	/*!< in: number of elements in bulk */
+{
+	ulint	i;
+	ulint	space		= ULINT_UNDEFINED;
+	mtr_t	mtr;
+
+	/* The pages were written to the data files as they were
+	finished. Make the writes durable before the log record that
+	makes the pages reachable can be. */
+	for (i = 0; i < n_bulk; i++) {
+		ut_ad(bulk[i]->ended);
+
+		if (bulk[i]->top_page_no != FIL_NULL
+		    && dict_index_get_space(bulk[i]->index) != space) {
+
+			space = dict_index_get_space(bulk[i]->index);
+			fil_flush(space);
+		}
+	}
+
+	mtr_start(&mtr);
+
+	/* Acquire the index tree latches before any page latch. */
+	for (i = 0; i < n_bulk; i++) {
+		if (bulk[i]->top_page_no != FIL_NULL) {
+			mtr_x_lock(dict_index_get_lock(bulk[i]->index), &mtr);
+		}
+	}
+
+	for (i = 0; i < n_bulk; i++) {
+		dict_index_t*	index	= bulk[i]->index;
+		ulint		zip_size = dict_table_zip_size(index->table);
+		buf_block_t*	root_block;
+		buf_block_t*	top_block;
+		page_t*		top_page;
+
+		if (bulk[i]->top_page_no == FIL_NULL) {
+			/* No entries were inserted. */
+			continue;
+		}
+
+		root_block = btr_block_get(dict_index_get_space(index),
+					   zip_size,
+					   dict_index_get_page(index),
+					   RW_X_LATCH, index, &mtr);
+		top_block = btr_block_get(dict_index_get_space(index),
+					  zip_size, bulk[i]->top_page_no,
+					  RW_X_LATCH, index, &mtr);
+		top_page = buf_block_get_frame(top_block);
+
+		ut_ad(!page_get_n_recs(buf_block_get_frame(root_block)));
+
+		/* The root page stays in place: copy the top page of
+		the new tree to it. These are the only redo logged page
+		modifications of the load, and they make all the other
+		pages reachable. */
+		btr_page_empty(root_block, NULL, index,
+			       btr_page_get_level(top_page, &mtr), &mtr);
+
+		page_copy_rec_list_end(root_block, top_block,
+				       page_get_infimum_rec(top_page),
+				       index, &mtr);
+	}
+
+	/* Free the top pages only after every root page has been
+	latched, so that no tree page is latched after the file
+	space latch. */
+	for (i = 0; i < n_bulk; i++) {
+		dict_index_t*	index	= bulk[i]->index;
+
+		if (bulk[i]->top_page_no != FIL_NULL) {
+			btr_page_free(index,
+				      btr_block_get(
+					      dict_index_get_space(index),
+					      dict_table_zip_size(
+						      index->table),
+					      bulk[i]->top_page_no,
+					      RW_X_LATCH, index, &mtr),
+				      &mtr);
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	/* Nothing else in the transaction may cause the log to be
+	written at commit. */
+	log_write_up_to(mtr.end_lsn, LOG_WAIT_ONE_GROUP, TRUE);
+
+	for (i = 0; i < n_bulk; i++) {
+		btr_bulk_free(bulk[i]);
+	}
+}
+
+/*********************************************************************//**
+Frees the pages that a bulk load has allocated, and the bulk load. The
+index tree stays empty. */
+UNIV_INTERN
+void
+btr_bulk_abort(
+/*===========*/
+	btr_bulk_t*	bulk)	/*!< in,own: bulk load */
+{
+	dict_index_t*	index		= bulk->index;
+	ulint		space		= dict_index_get_space(index);
+	ulint		zip_size	= dict_table_zip_size(index->table);
+	ulint		level;
+
+	for (level = 0; level < bulk->n_levels; level++) {
+		btr_bulk_level_t*	lvl = bulk->levels[level];
+
+		if (lvl->block) {
+			mtr_commit(&lvl->mtr[lvl->cur]);
+			lvl->block = NULL;
+		}
+	}
+
+	for (level = 0; level < bulk->n_levels; level++) {
+		ulint	page_no = bulk->levels[level]->first_page_no;
+
+		while (page_no != FIL_NULL) {
+			buf_block_t*	block;
+			mtr_t		mtr;
+
+			mtr_start(&mtr);
+			mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+			block = btr_block_get(space, zip_size, page_no,
+					      RW_X_LATCH, index, &mtr);
+			page_no = btr_page_get_next(
+				buf_block_get_frame(block), &mtr);
+
+			btr_page_free_low(index, block, level, &mtr);
+
+			mtr_commit(&mtr);
+		}
+	}
+
+	btr_bulk_free(bulk);
+}
+
+/*********************************************************************//**
+Empties an index tree in the rollback of a bulk insert into an empty
+table (TRX_UNDO_EMPTY). The root page is emptied first, so that the tree
+is empty to any later search, and then the other pages are freed level by
+level, which makes the stored cursor positions on them invalid. Last, any
+pages that are left in the file segments of the tree are freed: if the
+server was killed while an earlier rollback was freeing the pages, or
+before a load was published, the tree does not reach them. */
+UNIV_INTERN
+void
+btr_bulk_empty(
+/*===========*/
+	dict_index_t*	index)	/*!< in: index */
+{
+	ulint		space		= dict_index_get_space(index);
+	ulint		zip_size	= dict_table_zip_size(index->table);
+	ulint		root_page_no	= dict_index_get_page(index);
+	ulint		first_page_no[BTR_MAX_LEVELS];
+	ulint		n_levels;
+	ulint		level;
+	buf_block_t*	root_block;
+	buf_block_t*	block;
+	page_t*		root;
+	const rec_t*	rec;
+	ulint		used;
+	ibool		finished;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	mtr_t		mtr;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_block_get(space, zip_size, root_page_no,
+				   RW_X_LATCH, index, &mtr);
+	root = buf_block_get_frame(root_block);
+	n_levels = btr_page_get_level(root, &mtr);
+
+	/* Find the leftmost page of each level below the root. */
+	block = root_block;
+
+	for (level = n_levels; level > 0; level--) {
+		rec = page_rec_get_next_const(
+			page_get_infimum_rec(buf_block_get_frame(block)));
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		first_page_no[level - 1] = btr_node_ptr_get_child_page_no(
+			rec, offsets);
+
+		if (level > 1) {
+			block = btr_block_get(space, zip_size,
+					      first_page_no[level - 1],
+					      RW_S_LATCH, index, &mtr);
+		}
+	}
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	if (n_levels == 0) {
+		/* Let the supremum inherit the locks of the records. */
+		for (rec = page_rec_get_next_const(page_get_infimum_rec(root));
+		     !page_rec_is_supremum(rec);
+		     rec = page_rec_get_next_const(rec)) {
+
+			lock_update_delete(root_block, rec);
+		}
+	}
+
+	if (n_levels > 0 || page_get_n_recs(root) > 0) {
+		btr_page_empty(root_block, buf_block_get_page_zip(root_block),
+			       index, 0, &mtr);
+
+		if (!dict_index_is_clust(index)) {
+			ibuf_reset_free_bits(root_block);
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	for (level = 0; level < n_levels; level++) {
+		ulint	page_no = first_page_no[level];
+
+		while (page_no != FIL_NULL) {
+			mtr_start(&mtr);
+			mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+			root_block = btr_block_get(space, zip_size,
+						   root_page_no, RW_X_LATCH,
+						   index, &mtr);
+			block = btr_block_get(space, zip_size, page_no,
+					      RW_X_LATCH, index, &mtr);
+			page_no = btr_page_get_next(
+				buf_block_get_frame(block), &mtr);
+
+			lock_update_discard(root_block,
+					    PAGE_HEAP_NO_SUPREMUM, block);
+			btr_page_free_low(index, block, level, &mtr);
+
+			mtr_commit(&mtr);
+		}
+	}
+
+	/* The root page is not in the leaf segment, which is empty
+	in an empty tree. */
+	for (;;) {
+		mtr_start(&mtr);
+		mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+		root = btr_root_get(index, &mtr);
+
+		if (!fseg_n_reserved_pages(root + PAGE_HEADER
+					   + PAGE_BTR_SEG_LEAF,
+					   &used, &mtr)) {
+			mtr_commit(&mtr);
+			break;
+		}
+
+		fseg_free_step_not_header(root + PAGE_HEADER
+					  + PAGE_BTR_SEG_LEAF, &mtr);
+		mtr_commit(&mtr);
+	}
+
+	do {
+		mtr_start(&mtr);
+		mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+		root = btr_root_get(index, &mtr);
+
+		finished = fseg_free_step_not_header(
+			root + PAGE_HEADER + PAGE_BTR_SEG_TOP, &mtr);
+		mtr_commit(&mtr);
+	} while (!finished);
+}
+#endif /* !UNIV_HOTBACKUP */
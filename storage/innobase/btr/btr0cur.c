@@ -41,6 +41,9 @@ by crashing the database and doing a roll-forward.
 Created 10/16/1994 Heikki Tuuri
 *******************************************************/
 
+#include "m_string.h" /* for my_sys.h */
+#include "my_sys.h" /* DEBUG_SYNC_C */
+#include "mysql/plugin.h" /* thd_get_current_thd() */
 #include "btr0cur.h"
 
 #ifdef UNIV_NONINL
@@ -57,6 +60,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "buf0lru.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
+#include "btr0pcur.h"
 #include "row0purge.h"
 #include "row0upd.h"
 #include "trx0rec.h"
@@ -90,6 +94,9 @@ UNIV_INTERN ulint	btr_cur_n_non_sea	= 0;
 /** Number of successful adaptive hash index lookups in
 btr_cur_search_to_nth_level(). */
 UNIV_INTERN ulint	btr_cur_n_sea		= 0;
+/** Number of times a descent down the B-tree restarted from the root
+because it could not latch a page without waiting. */
+UNIV_INTERN ulint	btr_cur_n_restarts	= 0;
 /** Old value of btr_cur_n_non_sea.  Copied by
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
@@ -119,15 +126,19 @@ can be released by page reorganize, then it is reorganized */
 #define BTR_BLOB_HDR_SIZE		8	/*!< Size of a BLOB
 						part header, in bytes */
 
+/** Size of the uncompressed length that precedes the zlib stream of a
+BLOB stored with BTR_EXTERN_COMPRESSED_FLAG, in bytes */
+#define BTR_BLOB_COMPRESSED_LEN_SIZE	4
+
 /** Estimated table level stats from sampled value.
 @param value		sampled stats
-@param index		index being sampled
+@param n_leaf		number of leaf pages in the index being sampled
 @param sample		number of sampled rows
 @param ext_size		external stored data size
 @param not_empty	table not empty
 @return estimated table wide stats from sampled value */
-#define BTR_TABLE_STATS_FROM_SAMPLE(value, index, sample, ext_size, not_empty)\
-	(((value) * (ib_int64_t) index->stat_n_leaf_pages		\
+#define BTR_TABLE_STATS_FROM_SAMPLE(value, n_leaf, sample, ext_size, not_empty)\
+	(((value) * (ib_int64_t) (n_leaf)				\
 	  + (sample) - 1 + (ext_size) + (not_empty)) / ((sample) + (ext_size)))
 
 /* @} */
@@ -337,6 +348,231 @@ btr_cur_latch_leaves(
 	ut_error;
 }
 
+/********************************************************************//**
+Waits for the latch of a page that could not be latched without waiting,
+releases the page and counts a restart of the search from the root. */
+static
+void
+btr_cur_restart(
+/*============*/
+	buf_block_t*	block,		/*!< in: buffer-fixed page */
+	ulint		savepoint,	/*!< in: savepoint of block */
+	ulint		rw_latch,	/*!< in: RW_S_LATCH or RW_X_LATCH */
+	mtr_t*		mtr)		/*!< in/out: mtr */
+{
+#ifdef ENABLED_DEBUG_SYNC
+	/* Background threads have no THD for the sync point. */
+	if (thd_get_current_thd() != NULL) {
+		DEBUG_SYNC_C("btr_cur_restart");
+	}
+#endif /* ENABLED_DEBUG_SYNC */
+
+	if (rw_latch == RW_S_LATCH) {
+		rw_lock_s_lock(&block->lock);
+		rw_lock_s_unlock(&block->lock);
+	} else {
+		ut_ad(rw_latch == RW_X_LATCH);
+		rw_lock_x_lock(&block->lock);
+		rw_lock_x_unlock(&block->lock);
+	}
+
+	mtr_release_block_at_savepoint(mtr, savepoint, block);
+
+	btr_cur_n_restarts++;
+}
+
+/********************************************************************//**
+Latches a child page that was buffer-fixed while its parent page was
+latched, and releases the parent page.  The child page is latched without
+waiting, because a structure modification may hold its latch while
+waiting for the parent page latch.  If that fails, the parent page is
+released, the child page latch is waited for and released again, and the
+caller must search again from the root, because the child page may have
+been split, merged or freed in the meantime.
+@return	TRUE if the child page was latched */
+static
+ibool
+btr_cur_latch_child(
+/*================*/
+	buf_block_t*	parent_block,	/*!< in: latched parent page */
+	ulint		parent_savepoint,/*!< in: savepoint of parent_block */
+	buf_block_t*	block,		/*!< in: buffer-fixed child page */
+	ulint		savepoint,	/*!< in: savepoint of block */
+	ulint		rw_latch,	/*!< in: RW_S_LATCH or RW_X_LATCH */
+	const char*	file,		/*!< in: file name */
+	ulint		line,		/*!< in: line where called */
+	mtr_t*		mtr)		/*!< in/out: mtr */
+{
+	ibool	success;
+
+	success = mtr_block_latch_nowait_at_savepoint(
+		mtr, savepoint, block, rw_latch, file, line);
+
+	mtr_release_block_at_savepoint(mtr, parent_savepoint, parent_block);
+
+	if (UNIV_LIKELY(success)) {
+
+		return(TRUE);
+	}
+
+	btr_cur_restart(block, savepoint, rw_latch, mtr);
+
+	return(FALSE);
+}
+
+/********************************************************************//**
+Latches the left sibling of a leaf page that a coupled BTR_SEARCH_PREV
+descent has s-latched.  The latch on the leaf page keeps the left sibling
+from being freed, but the left sibling is latched after it, against the
+latching order, and therefore without waiting.  If that fails, the leaf
+page is released, the latch of the left sibling is waited for and
+released again, and the caller must search again from the root.
+@return	TRUE if the left sibling, if any, was latched */
+static
+ibool
+btr_cur_latch_left_sibling(
+/*=======================*/
+	buf_block_t*	block,		/*!< in: s-latched leaf page */
+	ulint		savepoint,	/*!< in: savepoint of block */
+	btr_cur_t*	cursor,		/*!< in/out: cursor; left_block is
+					set to the left sibling */
+	const char*	file,		/*!< in: file name */
+	ulint		line,		/*!< in: line where called */
+	mtr_t*		mtr)		/*!< in/out: mtr */
+{
+	ulint		left_page_no;
+	ulint		left_savepoint;
+	buf_block_t*	left_block;
+
+	left_page_no = btr_page_get_prev(buf_block_get_frame(block), mtr);
+
+	if (left_page_no == FIL_NULL) {
+
+		return(TRUE);
+	}
+
+	left_savepoint = mtr_set_savepoint(mtr);
+
+	left_block = buf_page_get_gen(
+		buf_block_get_space(block), buf_block_get_zip_size(block),
+		left_page_no, RW_NO_LATCH, NULL, BUF_GET, file, line, mtr);
+
+	if (UNIV_LIKELY(mtr_block_latch_nowait_at_savepoint(
+				mtr, left_savepoint, left_block,
+				RW_S_LATCH, file, line))) {
+
+		buf_block_dbg_add_level(left_block, SYNC_TREE_NODE);
+#ifdef UNIV_BTR_DEBUG
+		ut_a(page_is_comp(left_block->frame)
+		     == page_is_comp(block->frame));
+		ut_a(btr_page_get_next(left_block->frame, mtr)
+		     == buf_block_get_page_no(block));
+#endif /* UNIV_BTR_DEBUG */
+		left_block->check_index_page_at_flush = TRUE;
+		cursor->left_block = left_block;
+
+		return(TRUE);
+	}
+
+	mtr_release_block_at_savepoint(mtr, savepoint, block);
+
+	btr_cur_restart(left_block, left_savepoint, RW_S_LATCH, mtr);
+
+	return(FALSE);
+}
+
+/********************************************************************//**
+Determines whether a descent to the leaf level latches the pages from the
+root down, releasing each parent page once its child page is latched.
+This is done for the leaf latch modes and for BTR_SEARCH_PREV on all but
+the insert buffer tree, whose structure modifications x-latch the tree;
+only btr_cur_search_to_nth_level() supports BTR_SEARCH_PREV.  The pages
+are latched
+top-down, while a structure modification that holds the index tree
+sx-latch latches them bottom-up; therefore, a coupled descent must never
+wait for a page latch while holding the parent page latch.
+@return	TRUE if the page latches are coupled */
+UNIV_INLINE
+ibool
+btr_cur_latch_coupling(
+/*===================*/
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			level,	/*!< in: level of the search */
+	ulint			latch_mode)/*!< in: BTR_SEARCH_LEAF, ... */
+{
+	return(level == 0
+	       && (latch_mode == BTR_SEARCH_LEAF
+		   || latch_mode == BTR_MODIFY_LEAF
+		   || latch_mode == BTR_SEARCH_PREV)
+	       && !dict_index_is_ibuf(index));
+}
+
+/********************************************************************//**
+Latches the index tree for a descent in latch_mode.
+@return	TRUE if the tree was sx-latched */
+static
+ibool
+btr_cur_latch_tree(
+/*===============*/
+	dict_index_t*	index,		/*!< in: index */
+	ulint		latch_mode,	/*!< in: BTR_SEARCH_LEAF, ... */
+	mtr_t*		mtr)		/*!< in: mtr */
+{
+	switch (latch_mode) {
+	case BTR_MODIFY_TREE:
+		btr_tree_modify_latch(index, mtr);
+		return(FALSE);
+	case BTR_CONT_MODIFY_TREE:
+		/* Do nothing */
+		ut_ad(btr_tree_latched_for_modify(index, mtr));
+		return(FALSE);
+	case BTR_MODIFY_PREV:
+		if (!dict_index_is_ibuf(index)) {
+			/* BTR_MODIFY_PREV is only used when a cursor
+			for modification moves to the previous page,
+			which is rare.  Exclude structure modifications
+			while latching the left sibling before the leaf
+			page, but still allow readers. */
+			mtr_sx_lock(dict_index_get_lock(index), mtr);
+			return(TRUE);
+		}
+		/* fall through */
+	default:
+		/* BTR_SEARCH_PREV latches the left sibling after the
+		leaf page; see btr_cur_latch_left_sibling(). */
+		mtr_s_lock(dict_index_get_lock(index), mtr);
+		return(FALSE);
+	}
+}
+
+/********************************************************************//**
+Releases the index tree latch that btr_cur_latch_tree() acquired for a
+leaf latch mode, after the leaf page or pages have been latched. */
+UNIV_INLINE
+void
+btr_cur_release_tree(
+/*=================*/
+	dict_index_t*	index,		/*!< in: index */
+	ulint		latch_mode,	/*!< in: BTR_SEARCH_LEAF, ... */
+	ibool		tree_sx,	/*!< in: return value of
+					btr_cur_latch_tree() */
+	ulint		savepoint,	/*!< in: savepoint of the tree latch */
+	mtr_t*		mtr)		/*!< in: mtr */
+{
+	if (latch_mode == BTR_MODIFY_TREE
+	    || latch_mode == BTR_CONT_MODIFY_TREE) {
+		return;
+	}
+
+	if (tree_sx) {
+		mtr_release_sx_latch_at_savepoint(
+			mtr, savepoint, dict_index_get_lock(index));
+	} else {
+		mtr_release_s_latch_at_savepoint(
+			mtr, savepoint, dict_index_get_lock(index));
+	}
+}
+
 /********************************************************************//**
 Searches an index tree and positions a tree cursor on a given level.
 NOTE: n_fields_cmp in tuple must be set so that it cannot be compared
@@ -400,6 +636,13 @@ btr_cur_search_to_nth_level(
 	page_cur_t*	page_cursor;
 	btr_op_t	btr_op;
 	ulint		root_height = 0; /* remove warning */
+	ibool		tree_sx;
+	ibool		couple;
+	ulint		root_latch;
+	ulint		leaf_latch;
+	buf_block_t*	parent_block;
+	ulint		parent_savepoint = 0; /* remove warning */
+	ulint		block_savepoint;
 
 #ifdef BTR_CUR_ADAPT
 	btr_search_t*	info;
@@ -526,21 +769,23 @@ btr_cur_search_to_nth_level(
 
 	savepoint = mtr_set_savepoint(mtr);
 
-	if (latch_mode == BTR_MODIFY_TREE) {
-		mtr_x_lock(dict_index_get_lock(index), mtr);
-
-	} else if (latch_mode == BTR_CONT_MODIFY_TREE) {
-		/* Do nothing */
-		ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-					MTR_MEMO_X_LOCK));
-	} else {
-		mtr_s_lock(dict_index_get_lock(index), mtr);
-	}
+	tree_sx = btr_cur_latch_tree(index, latch_mode, mtr);
 
 	page_cursor = btr_cur_get_page_cur(cursor);
 
 	space = dict_index_get_space(index);
+	zip_size = dict_table_zip_size(index->table);
+
+	/* If the page latches are coupled, the root page is s-latched,
+	unless it turns out to be the leaf page.  BTR_SEARCH_PREV
+	s-latches the leaf page before its left sibling. */
+	couple = btr_cur_latch_coupling(index, level, latch_mode);
+	root_latch = RW_S_LATCH;
+	leaf_latch = latch_mode == BTR_SEARCH_PREV ? RW_S_LATCH : latch_mode;
+
+search_from_root:
 	page_no = dict_index_get_page(index);
+	parent_block = NULL;
 
 	up_match = 0;
 	up_bytes = 0;
@@ -579,6 +824,10 @@ search_loop:
 
 	if (height != 0) {
 		/* We are about to fetch the root or a non-leaf page. */
+		if (couple) {
+			rw_latch = height == ULINT_UNDEFINED
+				? root_latch : RW_S_LATCH;
+		}
 	} else if (latch_mode <= BTR_MODIFY_LEAF) {
 		rw_latch = latch_mode;
 
@@ -592,13 +841,19 @@ search_loop:
 				? BUF_GET_IF_IN_POOL_OR_WATCH
 				: BUF_GET_IF_IN_POOL;
 		}
+	} else if (couple) {
+		rw_latch = leaf_latch;
 	}
 
-	zip_size = dict_table_zip_size(index->table);
-
 retry_page_get:
+	block_savepoint = mtr_set_savepoint(mtr);
+
+	/* Below the root, a coupled descent latches the page only
+	after it has been buffer-fixed, so that it can avoid waiting
+	for the latch while holding the parent page latch. */
 	block = buf_page_get_gen(
-		space, zip_size, page_no, rw_latch, guess, buf_mode,
+		space, zip_size, page_no,
+		parent_block ? RW_NO_LATCH : rw_latch, guess, buf_mode,
 		file, line, mtr);
 
 	if (block == NULL) {
@@ -673,6 +928,20 @@ retry_page_get:
 		goto retry_page_get;
 	}
 
+	if (parent_block) {
+		ut_ad(couple);
+
+		if (UNIV_UNLIKELY(!btr_cur_latch_child(
+					  parent_block, parent_savepoint,
+					  block, block_savepoint, rw_latch,
+					  file, line, mtr))) {
+			guess = NULL;
+			goto search_from_root;
+		}
+
+		parent_block = NULL;
+	}
+
 	block->check_index_page_at_flush = TRUE;
 	page = buf_block_get_frame(block);
 
@@ -705,21 +974,34 @@ retry_page_get:
 	}
 
 	if (height == 0) {
+		if (couple && rw_latch != leaf_latch) {
+			/* The root page is the leaf page, and it must be
+			latched in the leaf latch mode. */
+			ut_ad(rw_latch == root_latch);
+			mtr_release_block_at_savepoint(
+				mtr, block_savepoint, block);
+			root_latch = leaf_latch;
+			guess = NULL;
+			goto search_from_root;
+		}
+
 		if (rw_latch == RW_NO_LATCH) {
 
 			btr_cur_latch_leaves(
 				page, space, zip_size, page_no, latch_mode,
 				cursor, mtr);
+		} else if (latch_mode == BTR_SEARCH_PREV
+			   && UNIV_UNLIKELY(!btr_cur_latch_left_sibling(
+						    block, block_savepoint,
+						    cursor, file, line,
+						    mtr))) {
+			guess = NULL;
+			goto search_from_root;
 		}
 
-		if (latch_mode != BTR_MODIFY_TREE
-		    && latch_mode != BTR_CONT_MODIFY_TREE) {
-
-			/* Release the tree s-latch */
-
-			mtr_release_s_latch_at_savepoint(
-				mtr, savepoint, dict_index_get_lock(index));
-		}
+		/* Release the tree s-latch or sx-latch */
+		btr_cur_release_tree(index, latch_mode, tree_sx,
+				     savepoint, mtr);
 
 		page_mode = mode;
 	}
@@ -753,6 +1035,11 @@ retry_page_get:
 		/* Go to the child node */
 		page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
 
+		if (couple) {
+			parent_block = block;
+			parent_savepoint = block_savepoint;
+		}
+
 		if (UNIV_UNLIKELY(height == 0 && dict_index_is_ibuf(index))) {
 			/* We're doing a search on an ibuf tree and we're one
 			level above the leaf page. */
@@ -834,6 +1121,11 @@ btr_cur_open_at_index_side_func(
 	rec_t*		node_ptr;
 	ulint		estimate;
 	ulint		savepoint;
+	ibool		tree_sx;
+	ibool		couple;
+	ulint		root_latch;
+	buf_block_t*	parent_block;
+	ulint		parent_savepoint = 0; /* remove warning */
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
@@ -841,38 +1133,73 @@ btr_cur_open_at_index_side_func(
 
 	estimate = latch_mode & BTR_ESTIMATE;
 	latch_mode = latch_mode & ~BTR_ESTIMATE;
+	ut_ad(latch_mode != BTR_SEARCH_PREV);
 
 	/* Store the position of the tree latch we push to mtr so that we
 	know how to release it when we have latched the leaf node */
 
 	savepoint = mtr_set_savepoint(mtr);
 
-	if (latch_mode == BTR_MODIFY_TREE) {
-		mtr_x_lock(dict_index_get_lock(index), mtr);
-	} else {
-		mtr_s_lock(dict_index_get_lock(index), mtr);
-	}
+	tree_sx = btr_cur_latch_tree(index, latch_mode, mtr);
 
 	page_cursor = btr_cur_get_page_cur(cursor);
 	cursor->index = index;
 
 	space = dict_index_get_space(index);
 	zip_size = dict_table_zip_size(index->table);
+
+	couple = btr_cur_latch_coupling(index, 0, latch_mode);
+	root_latch = RW_S_LATCH;
+
+search_from_root:
 	page_no = dict_index_get_page(index);
+	parent_block = NULL;
 
 	height = ULINT_UNDEFINED;
 
 	for (;;) {
 		buf_block_t*	block;
 		page_t*		page;
+		ulint		rw_latch;
+		ulint		block_savepoint;
+
+		if (!couple) {
+			rw_latch = RW_NO_LATCH;
+		} else if (height == ULINT_UNDEFINED) {
+			rw_latch = root_latch;
+		} else {
+			rw_latch = height ? RW_S_LATCH : latch_mode;
+		}
+
+		block_savepoint = mtr_set_savepoint(mtr);
+
 		block = buf_page_get_gen(space, zip_size, page_no,
-					 RW_NO_LATCH, NULL, BUF_GET,
-					 file, line, mtr);
+					 parent_block
+					 ? RW_NO_LATCH : rw_latch,
+					 NULL, BUF_GET, file, line, mtr);
+
+		if (parent_block) {
+			if (UNIV_UNLIKELY(!btr_cur_latch_child(
+						  parent_block,
+						  parent_savepoint,
+						  block, block_savepoint,
+						  rw_latch, file, line,
+						  mtr))) {
+				goto search_from_root;
+			}
+
+			parent_block = NULL;
+		}
+
 		page = buf_block_get_frame(block);
 		ut_ad(index->id == btr_page_get_index_id(page));
 
 		block->check_index_page_at_flush = TRUE;
 
+		if (rw_latch != RW_NO_LATCH) {
+			buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+		}
+
 		if (height == ULINT_UNDEFINED) {
 			/* We are in the root node */
 
@@ -881,8 +1208,19 @@ btr_cur_open_at_index_side_func(
 		}
 
 		if (height == 0) {
-			btr_cur_latch_leaves(page, space, zip_size, page_no,
-					     latch_mode, cursor, mtr);
+			if (!couple) {
+				btr_cur_latch_leaves(
+					page, space, zip_size, page_no,
+					latch_mode, cursor, mtr);
+			} else if (rw_latch != (ulint) latch_mode) {
+				/* The root page is the leaf page, and
+				it must be latched in the leaf latch
+				mode. */
+				mtr_release_block_at_savepoint(
+					mtr, block_savepoint, block);
+				root_latch = latch_mode;
+				goto search_from_root;
+			}
 
 			/* In versions <= 3.23.52 we had forgotten to
 			release the tree latch here. If in an index scan
@@ -890,15 +1228,8 @@ btr_cur_open_at_index_side_func(
 			current transaction, that could starve others
 			waiting for the tree latch. */
 
-			if ((latch_mode != BTR_MODIFY_TREE)
-			    && (latch_mode != BTR_CONT_MODIFY_TREE)) {
-
-				/* Release the tree s-latch */
-
-				mtr_release_s_latch_at_savepoint(
-					mtr, savepoint,
-					dict_index_get_lock(index));
-			}
+			btr_cur_release_tree(index, latch_mode, tree_sx,
+					     savepoint, mtr);
 		}
 
 		if (from_left) {
@@ -935,6 +1266,11 @@ btr_cur_open_at_index_side_func(
 					  ULINT_UNDEFINED, &heap);
 		/* Go to the child node */
 		page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
+
+		if (couple) {
+			parent_block = block;
+			parent_savepoint = block_savepoint;
+		}
 	}
 
 	if (UNIV_LIKELY_NULL(heap)) {
@@ -961,36 +1297,75 @@ btr_cur_open_at_rnd_pos_func(
 	ulint		zip_size;
 	ulint		height;
 	rec_t*		node_ptr;
+	ibool		couple;
+	ulint		root_latch;
+	buf_block_t*	parent_block;
+	ulint		parent_savepoint = 0; /* remove warning */
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
 	rec_offs_init(offsets_);
 
-	if (latch_mode == BTR_MODIFY_TREE) {
-		mtr_x_lock(dict_index_get_lock(index), mtr);
-	} else {
-		mtr_s_lock(dict_index_get_lock(index), mtr);
-	}
+	ut_ad(latch_mode != BTR_SEARCH_PREV);
+
+	btr_cur_latch_tree(index, latch_mode, mtr);
 
 	page_cursor = btr_cur_get_page_cur(cursor);
 	cursor->index = index;
 
 	space = dict_index_get_space(index);
 	zip_size = dict_table_zip_size(index->table);
+
+	couple = btr_cur_latch_coupling(index, 0, latch_mode);
+	root_latch = RW_S_LATCH;
+
+search_from_root:
 	page_no = dict_index_get_page(index);
+	parent_block = NULL;
 
 	height = ULINT_UNDEFINED;
 
 	for (;;) {
 		buf_block_t*	block;
 		page_t*		page;
+		ulint		rw_latch;
+		ulint		block_savepoint;
+
+		if (!couple) {
+			rw_latch = RW_NO_LATCH;
+		} else if (height == ULINT_UNDEFINED) {
+			rw_latch = root_latch;
+		} else {
+			rw_latch = height ? RW_S_LATCH : latch_mode;
+		}
+
+		block_savepoint = mtr_set_savepoint(mtr);
 
 		block = buf_page_get_gen(space, zip_size, page_no,
-					 RW_NO_LATCH, NULL, BUF_GET,
-					 file, line, mtr);
+					 parent_block
+					 ? RW_NO_LATCH : rw_latch,
+					 NULL, BUF_GET, file, line, mtr);
+
+		if (parent_block) {
+			if (UNIV_UNLIKELY(!btr_cur_latch_child(
+						  parent_block,
+						  parent_savepoint,
+						  block, block_savepoint,
+						  rw_latch, file, line,
+						  mtr))) {
+				goto search_from_root;
+			}
+
+			parent_block = NULL;
+		}
+
 		page = buf_block_get_frame(block);
 		ut_ad(index->id == btr_page_get_index_id(page));
 
+		if (rw_latch != RW_NO_LATCH) {
+			buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+		}
+
 		if (height == ULINT_UNDEFINED) {
 			/* We are in the root node */
 
@@ -998,8 +1373,19 @@ btr_cur_open_at_rnd_pos_func(
 		}
 
 		if (height == 0) {
-			btr_cur_latch_leaves(page, space, zip_size, page_no,
-					     latch_mode, cursor, mtr);
+			if (!couple) {
+				btr_cur_latch_leaves(
+					page, space, zip_size, page_no,
+					latch_mode, cursor, mtr);
+			} else if (rw_latch != (ulint) latch_mode) {
+				/* The root page is the leaf page, and
+				it must be latched in the leaf latch
+				mode. */
+				mtr_release_block_at_savepoint(
+					mtr, block_savepoint, block);
+				root_latch = latch_mode;
+				goto search_from_root;
+			}
 		}
 
 		page_cur_open_on_rnd_user_rec(block, page_cursor);
@@ -1018,6 +1404,11 @@ btr_cur_open_at_rnd_pos_func(
 					  ULINT_UNDEFINED, &heap);
 		/* Go to the child node */
 		page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
+
+		if (couple) {
+			parent_block = block;
+			parent_savepoint = block_savepoint;
+		}
 	}
 
 	if (UNIV_LIKELY_NULL(heap)) {
@@ -1507,9 +1898,7 @@ btr_cur_pessimistic_insert(
 
 	*big_rec = NULL;
 
-	ut_ad(mtr_memo_contains(mtr,
-				dict_index_get_lock(btr_cur_get_index(cursor)),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(btr_cur_get_index(cursor), mtr));
 	ut_ad(mtr_memo_contains(mtr, btr_cur_get_block(cursor),
 				MTR_MEMO_PAGE_X_FIX));
 
@@ -1567,6 +1956,10 @@ btr_cur_pessimistic_insert(
 
 	split_flags = get_page_split_flags(thr);
 
+	if (flags & BTR_KEEP_TREE_LATCH_FLAG) {
+		split_flags |= BTR_PAGE_SPLIT_KEEP_TREE_LATCH_FLAG;
+	}
+
 	if (dict_index_get_page(index)
 	    == buf_block_get_page_no(btr_cur_get_block(cursor))) {
 
@@ -2314,8 +2707,7 @@ btr_cur_pessimistic_update(
 	rec = btr_cur_get_rec(cursor);
 	index = cursor->index;
 
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
 #ifdef UNIV_ZIP_DEBUG
 	ut_a(!page_zip || page_zip_validate(page_zip, page, index));
@@ -2514,15 +2906,6 @@ make_external:
 		ut_ad(page_is_leaf(page));
 		ut_ad(dict_index_is_clust(index));
 		ut_ad(flags & BTR_KEEP_POS_FLAG);
-
-		/* btr_page_split_and_insert() in
-		btr_cur_pessimistic_insert() invokes
-		mtr_memo_release(mtr, index->lock, MTR_MEMO_X_LOCK).
-		We must keep the index->lock when we created a
-		big_rec, so that row_upd_clust_rec() can store the
-		big_rec in the same mini-transaction. */
-
-		mtr_x_lock(dict_index_get_lock(index), mtr);
 	}
 
 	/* Was the record to be updated positioned as the first user
@@ -2534,9 +2917,19 @@ make_external:
 	btr_cur_optimistic_insert() because
 	btr_cur_insert_if_possible() already failed above. */
 
+	/* btr_page_split_and_insert() in
+	btr_cur_pessimistic_insert() may release index->lock. We must
+	keep the index->lock when we created a big_rec, so that
+	row_upd_clust_rec() can store the big_rec in the same
+	mini-transaction. The tree latch cannot be acquired again here,
+	because sx-latches are not recursive, and because we already
+	hold page latches. */
+
 	err = btr_cur_pessimistic_insert(BTR_NO_UNDO_LOG_FLAG
 					 | BTR_NO_LOCKING_FLAG
-					 | BTR_KEEP_SYS_FLAG,
+					 | BTR_KEEP_SYS_FLAG
+					 | (big_rec_vec
+					    ? BTR_KEEP_TREE_LATCH_FLAG : 0),
 					 cursor, new_entry, &rec,
 					 &dummy_big_rec, n_ext, NULL, mtr);
 	ut_a(rec);
@@ -2984,9 +3377,7 @@ btr_cur_compress_if_useful(
 				cursor position even if compression occurs */
 	mtr_t*		mtr)	/*!< in/out: mini-transaction */
 {
-	ut_ad(mtr_memo_contains(mtr,
-				dict_index_get_lock(btr_cur_get_index(cursor)),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(btr_cur_get_index(cursor), mtr));
 	ut_ad(mtr_memo_contains(mtr, btr_cur_get_block(cursor),
 				MTR_MEMO_PAGE_X_FIX));
 
@@ -3128,8 +3519,7 @@ btr_cur_pessimistic_delete(
 	page = buf_block_get_frame(block);
 	index = btr_cur_get_index(cursor);
 
-	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, mtr));
 	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
 	if (!has_reserved_extents) {
 		/* First reserve enough free space for the file segments
@@ -3643,18 +4033,143 @@ btr_record_not_null_field_in_rec(
 	}
 }
 
+/*******************************************************************//**
+Counts the exact number of different key values in a given index, for
+each n-column prefix of the index where n <= dict_index_get_n_unique(index),
+by scanning all of its leaf pages in order. Only one leaf page is latched
+at a time, so concurrent readers and writers of the index are not blocked
+for the duration of the scan. */
+static
+void
+btr_count_different_key_vals(
+/*=========================*/
+	dict_index_t*	index,		/*!< in: index */
+	ulint		n_cols,		/*!< in: dict_index_get_n_unique() */
+	ibool		stats_null_not_equal,
+					/*!< in: TRUE if NULLs are to be
+					treated as different values */
+	ib_int64_t*	n_diff,		/*!< out: number of different values
+					for each n-column prefix */
+	ib_int64_t*	n_not_null)	/*!< in/out: number of non-null
+					values for each n-column prefix,
+					or NULL */
+{
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	const rec_t*	rec;
+	const rec_t*	prev_rec	= NULL;
+	byte*		prev_buf;
+	ulint		j;
+	mem_heap_t*	heap		= NULL;
+	ulint*		offsets_rec	= NULL;
+	ulint*		offsets_prev_rec = NULL;
+
+	/* The last record of each leaf page is copied here, so that it
+	can be compared with the first record of the next page after the
+	latch on its page has been released. */
+	prev_buf = mem_alloc(UNIV_PAGE_SIZE);
+
+	mtr_start(&mtr);
+
+	btr_pcur_open_at_index_side(TRUE, index, BTR_SEARCH_LEAF,
+				    &pcur, TRUE, &mtr);
+
+	while (btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+		ulint	matched_fields	= 0;
+		ulint	matched_bytes	= 0;
+
+		rec = btr_pcur_get_rec(&pcur);
+
+		offsets_rec = rec_get_offsets(rec, index, offsets_rec,
+					      ULINT_UNDEFINED, &heap);
+
+		btr_record_not_null_field_in_rec(
+			n_cols, offsets_rec, n_not_null);
+
+		if (prev_rec != NULL) {
+			cmp_rec_rec_with_match(
+				rec, prev_rec,
+				offsets_rec, offsets_prev_rec,
+				index, stats_null_not_equal,
+				&matched_fields, &matched_bytes);
+		}
+
+		for (j = matched_fields + 1; j <= n_cols; j++) {
+			/* The first record, and any record whose
+			prefix differs from the previous record,
+			starts a new key value. */
+			n_diff[j]++;
+		}
+
+		prev_rec = rec;
+
+		{
+			ulint*	offsets_tmp = offsets_prev_rec;
+			offsets_prev_rec = offsets_rec;
+			offsets_rec = offsets_tmp;
+		}
+
+		if (!page_rec_is_supremum(page_rec_get_next_const(rec))) {
+
+			continue;
+		}
+
+		ut_ad(rec_offs_size(offsets_prev_rec) <= UNIV_PAGE_SIZE);
+
+		prev_rec = rec_copy(prev_buf, rec, offsets_prev_rec);
+		rec_offs_make_valid(prev_rec, index, offsets_prev_rec);
+
+		/* Commit the mini-transaction at the end of each leaf
+		page, so that its memo does not grow with the size of
+		the index. */
+
+		btr_pcur_store_position(&pcur, &mtr);
+		mtr_commit(&mtr);
+
+		mtr_start(&mtr);
+		btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur, &mtr);
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	mem_free(prev_buf);
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+}
+
 /*******************************************************************//**
 Estimates the number of different key values in a given index, for
 each n-column prefix of the index where n <= dict_index_get_n_unique(index).
-The estimates are stored in the array index->stat_n_diff_key_vals.
+The estimates are stored in the array n_diff_key_vals.
 If innodb_stats_method is "nulls_ignored", we also record the number of
 non-null values for each prefix and store the estimates in
-array index->stat_n_non_null_key_vals. */
+array n_non_null_key_vals. If n_sample_pages is ULINT_UNDEFINED, all leaf
+pages are scanned and the values are exact rather than estimated. */
 UNIV_INTERN
 void
 btr_estimate_number_of_different_key_vals(
 /*======================================*/
-	dict_index_t*	index)	/*!< in: index */
+	dict_index_t*	index,		/*!< in: index */
+	ulint		n_sample_pages_arg,
+					/*!< in: number of leaf pages to
+					sample, or ULINT_UNDEFINED to count
+					the values exactly */
+	ulint		index_size,	/*!< in: number of pages in the
+					index */
+	ulint		n_leaf_pages,	/*!< in: number of leaf pages in
+					the index */
+	ib_int64_t*	n_diff_key_vals,/*!< out: number of different
+					values for each n-column prefix,
+					n_unique + 1 elements */
+	ib_int64_t*	n_non_null_key_vals)
+					/*!< out: number of non-null values
+					for each n-column prefix, n_unique + 1
+					elements; only written if
+					innodb_stats_method is
+					"nulls_ignored" */
 {
 	btr_cur_t	cursor;
 	page_t*		page;
@@ -3711,16 +4226,33 @@ btr_estimate_number_of_different_key_vals(
 		ut_error;
         }
 
+	if (n_sample_pages_arg == ULINT_UNDEFINED) {
+		btr_count_different_key_vals(index, n_cols,
+					     stats_null_not_equal,
+					     n_diff, n_not_null);
+
+		for (j = 0; j <= n_cols; j++) {
+			n_diff_key_vals[j] = n_diff[j];
+
+			if (n_not_null != NULL && j < n_cols) {
+				n_non_null_key_vals[j] = n_not_null[j];
+			}
+		}
+
+		mem_heap_free(heap);
+		return;
+	}
+
 	/* It makes no sense to test more pages than are contained
 	in the index, thus we lower the number if it is too high */
-	if (srv_stats_sample_pages > index->stat_index_size) {
-		if (index->stat_index_size > 0) {
-			n_sample_pages = index->stat_index_size;
+	if (n_sample_pages_arg > index_size) {
+		if (index_size > 0) {
+			n_sample_pages = index_size;
 		} else {
 			n_sample_pages = 1;
 		}
 	} else {
-		n_sample_pages = srv_stats_sample_pages;
+		n_sample_pages = n_sample_pages_arg;
 	}
 
 	/* We sample some pages in the index to get an estimate */
@@ -3824,17 +4356,17 @@ btr_estimate_number_of_different_key_vals(
 
 	/* If we saw k borders between different key values on
 	n_sample_pages leaf pages, we can estimate how many
-	there will be in index->stat_n_leaf_pages */
+	there will be in n_leaf_pages */
 
 	/* We must take into account that our sample actually represents
 	also the pages used for external storage of fields (those pages are
-	included in index->stat_n_leaf_pages) */
+	included in n_leaf_pages) */
 
 	for (j = 0; j <= n_cols; j++) {
-		index->stat_n_diff_key_vals[j]
+		n_diff_key_vals[j]
 			= BTR_TABLE_STATS_FROM_SAMPLE(
-				n_diff[j], index, n_sample_pages,
-				total_external_size, not_empty_flag); 
+				n_diff[j], n_leaf_pages, n_sample_pages,
+				total_external_size, not_empty_flag);
 
 		/* If the tree is small, smaller than
 		10 * n_sample_pages + total_external_size, then
@@ -3844,7 +4376,7 @@ btr_estimate_number_of_different_key_vals(
 		different key values, or even more. Let us try to approximate
 		that: */
 
-		add_on = index->stat_n_leaf_pages
+		add_on = n_leaf_pages
 			/ (10 * (n_sample_pages
 				 + total_external_size));
 
@@ -3852,16 +4384,15 @@ btr_estimate_number_of_different_key_vals(
 			add_on = n_sample_pages;
 		}
 
-		index->stat_n_diff_key_vals[j] += add_on;
+		n_diff_key_vals[j] += add_on;
 
-		/* Update the stat_n_non_null_key_vals[] with our
-		sampled result. stat_n_non_null_key_vals[] is created
-		and initialized to zero in dict_index_add_to_cache(),
-		along with stat_n_diff_key_vals[] array */
+		/* Update the n_non_null_key_vals[] with our
+		sampled result. */
 		if (n_not_null != NULL && (j < n_cols)) {
-			index->stat_n_non_null_key_vals[j] =
+			n_non_null_key_vals[j] =
 				 BTR_TABLE_STATS_FROM_SAMPLE(
-					n_not_null[j], index, n_sample_pages,
+					n_not_null[j], n_leaf_pages,
+					n_sample_pages,
 					total_external_size, not_empty_flag);
 		}
 	}
@@ -4202,6 +4733,60 @@ btr_blob_free(
 	mutex_exit(&block->mutex);
 }
 
+/*******************************************************************//**
+Compresses the externally stored part of a column that was declared with
+COLUMN_FORMAT COMPRESSED.  The zlib stream is preceded by the length of
+the uncompressed data, written in BTR_BLOB_COMPRESSED_LEN_SIZE bytes.
+@return	the compressed data, or NULL if it would not be shorter than
+the uncompressed data */
+static
+const byte*
+btr_blob_deflate(
+/*=============*/
+	const byte*	data,	/*!< in: externally stored part */
+	ulint		len,	/*!< in: length of data, in bytes */
+	ulint*		out_len,/*!< out: length of the compressed data */
+	mem_heap_t*	heap)	/*!< in/out: heap for the compressed data
+				and for the zlib state */
+{
+	z_stream	c_stream;
+	byte*		buf;
+	int		err;
+
+	if (len <= BTR_BLOB_COMPRESSED_LEN_SIZE) {
+		return(NULL);
+	}
+
+	buf = mem_heap_alloc(heap, len);
+	mach_write_to_4(buf, len);
+
+	page_zip_set_alloc(&c_stream, heap);
+
+	err = deflateInit2(&c_stream, Z_DEFAULT_COMPRESSION,
+			   Z_DEFLATED, 15, 7, Z_DEFAULT_STRATEGY);
+	ut_a(err == Z_OK);
+
+	c_stream.next_in = (byte*) data;
+	c_stream.avail_in = len;
+	c_stream.next_out = buf + BTR_BLOB_COMPRESSED_LEN_SIZE;
+	c_stream.avail_out = len - BTR_BLOB_COMPRESSED_LEN_SIZE;
+
+	/* Unless the whole stream fits in the output buffer, the
+	compressed data would not be shorter than the original. */
+	err = deflate(&c_stream, Z_FINISH);
+	ut_a(err == Z_OK || err == Z_STREAM_END || err == Z_BUF_ERROR);
+
+	*out_len = BTR_BLOB_COMPRESSED_LEN_SIZE + c_stream.total_out;
+
+	deflateEnd(&c_stream);
+
+	if (err != Z_STREAM_END || *out_len >= len) {
+		return(NULL);
+	}
+
+	return(buf);
+}
+
 /*******************************************************************//**
 Stores the fields in big_rec_vec to the tablespace and puts pointers to
 them in rec.  The extern flags in rec will have to be set beforehand.
@@ -4239,6 +4824,7 @@ btr_store_big_rec_extern_fields(
 	mtr_t		mtr;
 	mtr_t*		alloc_mtr;
 	mem_heap_t*	heap = NULL;
+	mem_heap_t*	blob_heap	= NULL;
 	page_zip_des_t*	page_zip;
 	z_stream	c_stream;
 	buf_block_t**	freed_pages	= NULL;
@@ -4248,8 +4834,7 @@ btr_store_big_rec_extern_fields(
 	ut_ad(rec_offs_validate(rec, index, offsets));
 	ut_ad(rec_offs_any_extern(offsets));
 	ut_ad(btr_mtr);
-	ut_ad(mtr_memo_contains(btr_mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, btr_mtr));
 	ut_ad(mtr_memo_contains(btr_mtr, rec_block, MTR_MEMO_PAGE_X_FIX));
 	ut_ad(buf_block_get_frame(rec_block) == page_align(rec));
 	ut_a(dict_index_is_clust(index));
@@ -4339,6 +4924,10 @@ btr_store_big_rec_extern_fields(
 	for each field and put the pointer to the field in rec */
 
 	for (i = 0; i < big_rec_vec->n_fields; i++) {
+		const byte*	field_data;
+		ulint		field_len;
+		ulint		len_flags	= 0;
+
 		field_ref = btr_rec_get_field_ref(
 			rec, offsets, big_rec_vec->fields[i].field_no);
 #if defined UNIV_DEBUG || defined UNIV_BLOB_LIGHT_DEBUG
@@ -4346,11 +4935,40 @@ btr_store_big_rec_extern_fields(
 		ut_a(!memcmp(field_ref, field_ref_zero,
 			     BTR_EXTERN_FIELD_REF_SIZE));
 #endif /* UNIV_DEBUG || UNIV_BLOB_LIGHT_DEBUG */
-		extern_len = big_rec_vec->fields[i].len;
-		UNIV_MEM_ASSERT_RW(big_rec_vec->fields[i].data,
-				   extern_len);
+		field_data = big_rec_vec->fields[i].data;
+		field_len = big_rec_vec->fields[i].len;
+		UNIV_MEM_ASSERT_RW(field_data, field_len);
+
+		ut_a(field_len > 0);
+
+		/* ROW_FORMAT=COMPRESSED compresses all BLOB pages
+		anyway; elsewhere, compress the columns that were
+		declared with COLUMN_FORMAT COMPRESSED. */
+		if (!page_zip
+		    && (dict_index_get_nth_col(
+				index, big_rec_vec->fields[i].field_no)
+			->prtype & DATA_COMPRESSED)) {
+			const byte*	deflated;
+			ulint		deflated_len;
+
+			if (blob_heap == NULL) {
+				blob_heap = mem_heap_create(250000);
+			} else {
+				mem_heap_empty(blob_heap);
+			}
 
-		ut_a(extern_len > 0);
+			deflated = btr_blob_deflate(field_data, field_len,
+						    &deflated_len, blob_heap);
+
+			if (deflated) {
+				field_data = deflated;
+				field_len = deflated_len;
+				len_flags = (ulint) BTR_EXTERN_COMPRESSED_FLAG
+					<< 24;
+			}
+		}
+
+		extern_len = field_len;
 
 		prev_page_no = FIL_NULL;
 
@@ -4582,10 +5200,8 @@ next_zip_page:
 
 				mlog_write_string(page + FIL_PAGE_DATA
 						  + BTR_BLOB_HDR_SIZE,
-						  (const byte*)
-						  big_rec_vec->fields[i].data
-						  + big_rec_vec->fields[i].len
-						  - extern_len,
+						  field_data
+						  + field_len - extern_len,
 						  store_len, &mtr);
 				mlog_write_ulint(page + FIL_PAGE_DATA
 						 + BTR_BLOB_HDR_PART_LEN,
@@ -4606,12 +5222,12 @@ next_zip_page:
 						SYNC_NO_ORDER_CHECK);
 				}
 
-				mlog_write_ulint(field_ref + BTR_EXTERN_LEN, 0,
+				mlog_write_ulint(field_ref + BTR_EXTERN_LEN,
+						 len_flags,
 						 MLOG_4BYTES, alloc_mtr);
 				mlog_write_ulint(field_ref
 						 + BTR_EXTERN_LEN + 4,
-						 big_rec_vec->fields[i].len
-						 - extern_len,
+						 field_len - extern_len,
 						 MLOG_4BYTES, alloc_mtr);
 
 				if (prev_page_no == FIL_NULL) {
@@ -4672,6 +5288,10 @@ func_exit:
 		mem_heap_free(heap);
 	}
 
+	if (blob_heap != NULL) {
+		mem_heap_free(blob_heap);
+	}
+
 #if defined UNIV_DEBUG || defined UNIV_BLOB_LIGHT_DEBUG
 	/* All pointers to externally stored columns in the record
 	must be valid. */
@@ -4773,8 +5393,7 @@ btr_free_externally_stored_field(
 	ulint		next_page_no;
 	mtr_t		mtr;
 
-	ut_ad(mtr_memo_contains(local_mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+	ut_ad(btr_tree_latched_for_modify(index, local_mtr));
 	ut_ad(mtr_memo_contains_page(local_mtr, field_ref,
 				     MTR_MEMO_PAGE_X_FIX));
 	ut_ad(!rec || rec_offs_validate(rec, index, offsets));
@@ -5083,6 +5702,106 @@ btr_copy_blob_prefix(
 	}
 }
 
+/*******************************************************************//**
+Copies the prefix of an uncompressed-page BLOB that was stored with
+BTR_EXTERN_COMPRESSED_FLAG.  Only as much of the zlib stream is
+inflated as is needed to fill buf.  The clustered index record that
+points to this BLOB must be protected by a lock or a page latch.
+@return	number of bytes written to buf */
+static
+ulint
+btr_copy_cblob_prefix(
+/*==================*/
+	byte*		buf,	/*!< out: the externally stored part of
+				the field, or a prefix of it */
+	ulint		len,	/*!< in: length of buf, in bytes */
+	ulint		space_id,/*!< in: space id of the BLOB pages */
+	ulint		page_no,/*!< in: page number of the first BLOB page */
+	ulint		offset)	/*!< in: offset on the first BLOB page */
+{
+	ulint		skip	= BTR_BLOB_COMPRESSED_LEN_SIZE;
+	mem_heap_t*	heap;
+	int		err;
+	z_stream	d_stream;
+
+	d_stream.next_out = buf;
+	d_stream.avail_out = len;
+	d_stream.next_in = Z_NULL;
+	d_stream.avail_in = 0;
+
+	/* Zlib inflate needs 32 kilobytes for the default
+	window size, plus a few kilobytes for small objects. */
+	heap = mem_heap_create(40000);
+	page_zip_set_alloc(&d_stream, heap);
+
+	err = inflateInit(&d_stream);
+	ut_a(err == Z_OK);
+
+	for (;;) {
+		mtr_t		mtr;
+		buf_block_t*	block;
+		const page_t*	page;
+		const byte*	blob_header;
+		ulint		part_len;
+
+		mtr_start(&mtr);
+
+		block = buf_page_get(space_id, 0, page_no, RW_S_LATCH, &mtr);
+		buf_block_dbg_add_level(block, SYNC_EXTERN_STORAGE);
+		page = buf_block_get_frame(block);
+
+		btr_check_blob_fil_page_type(space_id, page_no, page, TRUE);
+
+		blob_header = page + offset;
+		part_len = btr_blob_get_part_len(blob_header);
+		ut_a(part_len >= skip);
+
+		/* The uncompressed length at the start of the first
+		part is not needed for copying a prefix. */
+		d_stream.next_in = (byte*) blob_header + BTR_BLOB_HDR_SIZE
+			+ skip;
+		d_stream.avail_in = part_len - skip;
+		skip = 0;
+
+		err = inflate(&d_stream, Z_NO_FLUSH);
+
+		page_no = btr_blob_get_next_page_no(blob_header);
+
+		mtr_commit(&mtr);
+
+		if (err == Z_STREAM_END || !d_stream.avail_out) {
+			break;
+		} else if (err != Z_OK && err != Z_BUF_ERROR) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: inflate() of"
+				" compressed column BLOB"
+				" page %lu space %lu returned %d (%s)\n",
+				(ulong) page_no, (ulong) space_id,
+				err, d_stream.msg);
+			break;
+		} else if (page_no == FIL_NULL) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: unexpected end of"
+				" compressed column BLOB"
+				" space %lu\n",
+				(ulong) space_id);
+			break;
+		}
+
+		/* On other BLOB pages except the first the BLOB header
+		always is at the page data start: */
+
+		offset = FIL_PAGE_DATA;
+	}
+
+	inflateEnd(&d_stream);
+	mem_heap_free(heap);
+	UNIV_MEM_ASSERT_RW(buf, d_stream.total_out);
+	return(d_stream.total_out);
+}
+
 /*******************************************************************//**
 Copies the prefix of a compressed BLOB.  The clustered index record
 that points to this BLOB must be protected by a lock or a page latch.
@@ -5249,6 +5968,8 @@ btr_copy_externally_stored_field_prefix_low(
 	ulint		len,	/*!< in: length of buf, in bytes */
 	ulint		zip_size,/*!< in: nonzero=compressed BLOB page size,
 				zero for uncompressed BLOBs */
+	ibool		deflated,/*!< in: TRUE if BTR_EXTERN_COMPRESSED_FLAG
+				is set in the BLOB pointer */
 	ulint		space_id,/*!< in: space id of the first BLOB page */
 	ulint		page_no,/*!< in: page number of the first BLOB page */
 	ulint		offset)	/*!< in: offset on the first BLOB page */
@@ -5260,6 +5981,9 @@ btr_copy_externally_stored_field_prefix_low(
 	if (UNIV_UNLIKELY(zip_size)) {
 		return(btr_copy_zblob_prefix(buf, len, zip_size,
 					     space_id, page_no, offset));
+	} else if (UNIV_UNLIKELY(deflated)) {
+		return(btr_copy_cblob_prefix(buf, len, space_id,
+					     page_no, offset));
 	} else {
 		return(btr_copy_blob_prefix(buf, len, space_id,
 					    page_no, offset));
@@ -5318,11 +6042,10 @@ btr_copy_externally_stored_field_prefix(
 	offset = mach_read_from_4(data + BTR_EXTERN_OFFSET);
 
 	return(local_len
-	       + btr_copy_externally_stored_field_prefix_low(buf + local_len,
-							     len - local_len,
-							     zip_size,
-							     space_id, page_no,
-							     offset));
+	       + btr_copy_externally_stored_field_prefix_low(
+		       buf + local_len, len - local_len, zip_size,
+		       data[BTR_EXTERN_LEN] & BTR_EXTERN_COMPRESSED_FLAG,
+		       space_id, page_no, offset));
 }
 
 /*******************************************************************//**
@@ -5347,6 +6070,7 @@ btr_copy_externally_stored_field(
 	ulint	page_no;
 	ulint	offset;
 	ulint	extern_len;
+	ibool	deflated;
 	byte*	buf;
 
 	ut_a(local_len >= BTR_EXTERN_FIELD_REF_SIZE);
@@ -5364,6 +6088,25 @@ btr_copy_externally_stored_field(
 
 	extern_len = mach_read_from_4(data + local_len + BTR_EXTERN_LEN + 4);
 
+	deflated = !zip_size
+		&& (data[local_len + BTR_EXTERN_LEN]
+		    & BTR_EXTERN_COMPRESSED_FLAG);
+
+	if (UNIV_UNLIKELY(deflated)) {
+		byte	uncompressed_len[BTR_BLOB_COMPRESSED_LEN_SIZE];
+
+		/* The stored length is that of the zlib stream.
+		Allocate the buffer for the uncompressed data. */
+		if (btr_copy_blob_prefix(uncompressed_len,
+					 sizeof uncompressed_len,
+					 space_id, page_no, offset)
+		    == sizeof uncompressed_len) {
+			extern_len = mach_read_from_4(uncompressed_len);
+		} else {
+			extern_len = 0;
+		}
+	}
+
 	buf = mem_heap_alloc(heap, local_len + extern_len);
 
 	memcpy(buf, data, local_len);
@@ -5371,6 +6114,7 @@ btr_copy_externally_stored_field(
 		+ btr_copy_externally_stored_field_prefix_low(buf + local_len,
 							      extern_len,
 							      zip_size,
+							      deflated,
 							      space_id,
 							      page_no, offset);
 
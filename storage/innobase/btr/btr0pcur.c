@@ -169,6 +169,7 @@ btr_pcur_store_position(
 
 	cursor->block_when_stored = block;
 	cursor->modify_clock = buf_block_get_modify_clock(block);
+	cursor->withdraw_clock = buf_withdraw_clock;
 }
 
 /**************************************************************//**
@@ -261,9 +262,12 @@ btr_pcur_restore_position_func(
 	ut_a(cursor->old_rec);
 	ut_a(cursor->old_n_fields);
 
-	if (UNIV_LIKELY(latch_mode == BTR_SEARCH_LEAF)
-	    || UNIV_LIKELY(latch_mode == BTR_MODIFY_LEAF)) {
-		/* Try optimistic restoration. */
+	if ((UNIV_LIKELY(latch_mode == BTR_SEARCH_LEAF)
+	     || UNIV_LIKELY(latch_mode == BTR_MODIFY_LEAF))
+	    && !buf_pool_is_obsolete(cursor->withdraw_clock)) {
+		/* Try optimistic restoration.  It is not possible if
+		the stored block may have been freed by a buffer pool
+		resize. */
 
 		if (buf_page_optimistic_get(latch_mode,
 					    cursor->block_when_stored,
@@ -360,6 +364,7 @@ btr_pcur_restore_position_func(
 			cursor->modify_clock =
 				buf_block_get_modify_clock(
 					cursor->block_when_stored);
+			cursor->withdraw_clock = buf_withdraw_clock;
 			cursor->old_stored = BTR_PCUR_OLD_STORED;
 
 			mem_heap_free(heap);
@@ -591,3 +596,148 @@ btr_pcur_open_on_user_rec_func(
 		ut_error;
 	}
 }
+
+/**************************************************************//**
+Looks up the leaf pages that follow the stored position of a persistent
+cursor in the direction of a scan, in key order, by reading the node
+pointers on the parent of the current leaf page.  The parent is latched
+alone, never together with a leaf page, so this cannot deadlock with a
+tree modification.  Only the children of the current parent page are
+returned.
+@return	number of page numbers stored in page_nos */
+UNIV_INTERN
+ulint
+btr_pcur_get_next_leaves(
+/*=====================*/
+	btr_pcur_t*	cursor,		/*!< in: detached persistent cursor
+					whose position is stored */
+	ibool		moves_up,	/*!< in: TRUE if the scan moves to
+					the next records, FALSE if to the
+					previous ones */
+	ulint*		page_nos,	/*!< out: page numbers of the next
+					leaf pages, in the order of the scan */
+	ulint		n_pages)	/*!< in: size of page_nos */
+{
+	btr_path_t	path[BTR_PATH_ARRAY_N_SLOTS];
+	dict_index_t*	index;
+	btr_cur_t	btr_cur;
+	page_cur_t	page_cur;
+	dtuple_t*	tuple;
+	mem_heap_t*	heap;
+	buf_block_t*	block;
+	const page_t*	page;
+	const rec_t*	rec;
+	ulint*		offsets	= NULL;
+	ulint		space;
+	ulint		zip_size;
+	ulint		parent_page_no;
+	ulint		leaf_page_no;
+	ulint		n	= 0;
+	mtr_t		mtr;
+
+	ut_ad(cursor->old_stored == BTR_PCUR_OLD_STORED);
+
+	if (cursor->rel_pos == BTR_PCUR_AFTER_LAST_IN_TREE
+	    || cursor->rel_pos == BTR_PCUR_BEFORE_FIRST_IN_TREE) {
+
+		return(0);
+	}
+
+	index = btr_cur_get_index(btr_pcur_get_btr_cur(cursor));
+	space = dict_index_get_space(index);
+	zip_size = dict_table_zip_size(index->table);
+
+	heap = mem_heap_create(256);
+
+	tuple = dict_index_build_data_tuple(index, cursor->old_rec,
+					    cursor->old_n_fields, heap);
+
+	/* Find the current leaf page and its parent.  The path of the
+	search records the page number on each level. */
+
+	mtr_start(&mtr);
+
+	btr_cur.path_arr = path;
+
+	btr_cur_search_to_nth_level(index, 0, tuple, PAGE_CUR_LE,
+				    BTR_SEARCH_LEAF | BTR_ESTIMATE,
+				    &btr_cur, 0, __FILE__, __LINE__, &mtr);
+
+	leaf_page_no = buf_block_get_page_no(btr_cur_get_block(&btr_cur));
+
+	mtr_commit(&mtr);
+
+	if (btr_cur.tree_height < 2
+	    || btr_cur.tree_height >= BTR_PATH_ARRAY_N_SLOTS) {
+
+		goto func_exit;
+	}
+
+	parent_page_no = path[btr_cur.tree_height - 2].page_no;
+
+	/* Read the node pointers that follow the one of the leaf page */
+
+	mtr_start(&mtr);
+
+	block = buf_page_get_gen(space, zip_size, parent_page_no,
+				 RW_S_LATCH, NULL, BUF_GET_IF_IN_POOL,
+				 __FILE__, __LINE__, &mtr);
+
+	if (block == NULL) {
+
+		goto commit_exit;
+	}
+
+	buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+
+	page = buf_block_get_frame(block);
+
+	/* The tree may have changed after the search */
+
+	if (fil_page_get_type(page) != FIL_PAGE_INDEX
+	    || btr_page_get_index_id(page) != index->id
+	    || btr_page_get_level_low(page) != 1) {
+
+		goto commit_exit;
+	}
+
+	page_cur_search(block, index, tuple, PAGE_CUR_LE, &page_cur);
+
+	rec = page_cur_get_rec(&page_cur);
+
+	if (!page_rec_is_user_rec(rec)) {
+
+		goto commit_exit;
+	}
+
+	offsets = rec_get_offsets(rec, index, offsets, ULINT_UNDEFINED,
+				  &heap);
+
+	if (btr_node_ptr_get_child_page_no(rec, offsets) != leaf_page_no) {
+
+		goto commit_exit;
+	}
+
+	for (;;) {
+		rec = moves_up
+			? page_rec_get_next_const(rec)
+			: page_rec_get_prev_const(rec);
+
+		if (n >= n_pages || !page_rec_is_user_rec(rec)) {
+
+			break;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		page_nos[n++] = btr_node_ptr_get_child_page_no(rec, offsets);
+	}
+
+commit_exit:
+	mtr_commit(&mtr);
+func_exit:
+	mem_heap_free(heap);
+
+	return(n);
+}
@@ -42,6 +42,7 @@ Created 2/17/1996 Heikki Tuuri
 #include "btr0pcur.h"
 #include "btr0btr.h"
 #include "ha0ha.h"
+#include "srv0mon.h"
 
 /** Flag: has the search system been enabled?
 Protected by btr_search_latch. */
@@ -198,6 +199,30 @@ btr_search_sys_free(void)
 	btr_search_sys = NULL;
 }
 
+/*****************************************************************//**
+Resizes the hash table of the adaptive search system.  The adaptive
+hash index must be disabled and empty. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size)	/*!< in: hash index hash table size */
+{
+	hash_table_t*	hash_index;
+
+	rw_lock_x_lock(&btr_search_latch);
+
+	ut_a(!btr_search_enabled);
+
+	hash_index = btr_search_sys->hash_index;
+	btr_search_sys->hash_index = ha_create(hash_size, 0, 0);
+
+	mem_heap_free(hash_index->heap);
+	hash_table_free(hash_index);
+
+	rw_lock_x_unlock(&btr_search_latch);
+}
+
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
 UNIV_INTERN
@@ -247,6 +272,13 @@ btr_search_enable(void)
 {
 	rw_lock_x_lock(&btr_search_latch);
 
+	/* The buffer pool resize enables the adaptive hash index
+	again when it has completed. */
+	if (buf_pool_resizing) {
+		rw_lock_x_unlock(&btr_search_latch);
+		return;
+	}
+
 	btr_search_enabled = TRUE;
 
 	rw_lock_x_unlock(&btr_search_latch);
@@ -1163,6 +1195,8 @@ next_rec:
 
 	block->index = NULL;
 
+	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_REMOVED);
+
 cleanup:
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 	if (UNIV_UNLIKELY(block->n_pointers)) {
@@ -1224,6 +1258,70 @@ btr_search_drop_page_hash_when_freed(
 	mtr_commit(&mtr);
 }
 
+/********************************************************************//**
+Checks if any index of a table has pages in the adaptive hash index.
+@return	TRUE if some page of the table is hashed */
+static
+ibool
+btr_search_table_is_hashed(
+/*=======================*/
+	const dict_table_t*	table)	/*!< in: table */
+{
+	const dict_index_t*	index;
+
+	for (index = dict_table_get_first_index(table); index;
+	     index = dict_table_get_next_index(index)) {
+
+		if (btr_search_info_get_ref_count(index->search_info)) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/********************************************************************//**
+Drops the page hash index entries of all pages of a table that is stored
+in a single-table tablespace, before the tablespace is discarded without
+evicting its pages from the buffer pool. The cost is proportional to the
+size of the tablespace, not of the buffer pool, and the scan stops as soon
+as no page of the table is hashed any more. */
+UNIV_INTERN
+void
+btr_search_drop_page_hash_for_table(
+/*================================*/
+	dict_table_t*	table)	/*!< in: table */
+{
+	ulint	space	= table->space;
+	ulint	zip_size;
+	ulint	size;
+	ulint	page_no;
+
+	ut_ad(space != 0);
+
+	zip_size = fil_space_get_zip_size(space);
+
+	if (zip_size == ULINT_UNDEFINED) {
+
+		return;
+	}
+
+	size = fil_space_get_size(space);
+
+	for (page_no = 0; page_no < size; page_no++) {
+
+		/* Checking the ref_count acquires btr_search_latch;
+		do it only once in a while. */
+		if (page_no % 64 == 0 && !btr_search_table_is_hashed(table)) {
+
+			break;
+		}
+
+		btr_search_drop_page_hash_when_freed(space, zip_size, page_no);
+	}
+}
+
 /********************************************************************//**
 Builds a hash index on a page with the given parameters. If the page already
 has a hash index with different parameters, the old hash index is removed.
@@ -1412,6 +1510,8 @@ btr_search_build_page_hash_index(
 		ha_insert_for_fold(table, folds[i], block, recs[i]);
 	}
 
+	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
+
 exit_func:
 	rw_lock_x_unlock(&btr_search_latch);
 
@@ -125,6 +125,13 @@ buf_buddy_alloc_zip(
 
 	bpage = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
 
+	/* Do not allocate from the frames that are being withdrawn. */
+	while (bpage != NULL
+	       && UNIV_UNLIKELY(buf_frame_will_withdrawn(
+					buf_pool, (byte*) bpage))) {
+		bpage = UT_LIST_GET_NEXT(list, bpage);
+	}
+
 	if (bpage) {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_ZIP_FREE);
 
@@ -453,8 +460,10 @@ recombine:
 
 	/* Do not recombine blocks if there are few free blocks.
 	We may waste up to 15360*max_len bytes to free blocks
-	(1024 + 2048 + 4096 + 8192 = 15360) */
-	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16) {
+	(1024 + 2048 + 4096 + 8192 = 15360).  While the buffer pool
+	is being shrunk, recombine so that withdrawn frames get freed. */
+	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16
+	    && buf_pool->n_chunks_new >= buf_pool->n_chunks) {
 		goto func_exit;
 	}
 
@@ -500,10 +509,12 @@ buddy_nonfree:
 
 	ut_d(BUF_BUDDY_LIST_VALIDATE(buf_pool, i));
 
-	/* The buddy is not free. Is there a free block of this size? */
+	/* The buddy is not free. Is there a free block of this size?
+	Do not relocate while the buffer pool is being shrunk: the
+	free block could be in a withdrawn frame. */
 	bpage = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
 
-	if (bpage) {
+	if (bpage && buf_pool->n_chunks_new >= buf_pool->n_chunks) {
 
 		/* Remove the block from the free list, because a successful
 		buf_buddy_relocate() will overwrite bpage->list. */
@@ -529,3 +540,107 @@ func_exit:
 	bpage->state = BUF_BLOCK_ZIP_FREE;
 	buf_buddy_add_to_free(buf_pool, bpage, i);
 }
+
+/**********************************************************************//**
+Try to relocate a compressed page frame out of a chunk that is being
+withdrawn from the buffer pool.  The thread calling this function must
+hold buf_pool->mutex and must not hold buf_pool->zip_mutex or any
+block->mutex.  The buf_pool->mutex will not be released.
+@return	TRUE if relocated */
+UNIV_INTERN
+ibool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	void*		buf,		/*!< in: compressed page frame */
+	ulint		size)		/*!< in: compressed page size */
+{
+	ulint		i	= buf_buddy_get_slot(size);
+	buf_block_t*	block;
+	void*		dst;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(!mutex_own(&buf_pool->zip_mutex));
+	ut_ad(i >= buf_buddy_get_slot(PAGE_ZIP_MIN_SIZE));
+	ut_ad(i < BUF_BUDDY_SIZES);
+
+	dst = buf_buddy_alloc_zip(buf_pool, i);
+
+	if (dst == NULL) {
+		block = buf_LRU_get_free_only(buf_pool);
+
+		if (block == NULL) {
+
+			return(FALSE);
+		}
+
+		buf_buddy_block_register(block);
+
+		dst = buf_buddy_alloc_from(
+			buf_pool, block->frame, i, BUF_BUDDY_SIZES);
+	}
+
+	buf_pool->buddy_stat[i].used++;
+
+	if (buf_buddy_relocate(buf_pool, buf, dst, i)) {
+		buf_buddy_free_low(buf_pool, buf, i);
+
+		return(TRUE);
+	}
+
+	buf_buddy_free_low(buf_pool, dst, i);
+
+	return(FALSE);
+}
+
+/**********************************************************************//**
+Recombine the free blocks of the frames that are being withdrawn from
+the buffer pool with their free buddies, so that the frames can be
+freed when all their compressed pages have been relocated. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	ulint		i;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool->n_chunks_new < buf_pool->n_chunks);
+
+	for (i = buf_buddy_get_slot(PAGE_ZIP_MIN_SIZE);
+	     i < BUF_BUDDY_SIZES; i++) {
+		buf_page_t*	bpage;
+scan_again:
+		for (bpage = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
+		     bpage != NULL;
+		     bpage = UT_LIST_GET_NEXT(list, bpage)) {
+
+			buf_page_t*	buddy;
+			buf_page_t*	b;
+
+			if (!buf_frame_will_withdrawn(
+				    buf_pool, (byte*) bpage)) {
+				continue;
+			}
+
+			buddy = (buf_page_t*) buf_buddy_get(
+				(byte*) bpage, BUF_BUDDY_LOW << i);
+
+			for (b = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
+			     b != NULL && b != buddy;
+			     b = UT_LIST_GET_NEXT(list, b)) {
+			}
+
+			if (b != NULL) {
+				/* Both are free: buf_buddy_free_low()
+				will recombine them. */
+				buf_buddy_remove_from_free(buf_pool, bpage, i);
+				buf_pool->buddy_stat[i].used++;
+				buf_buddy_free_low(buf_pool, bpage, i);
+
+				goto scan_again;
+			}
+		}
+	}
+}
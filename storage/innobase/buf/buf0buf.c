@@ -48,6 +48,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
@@ -249,6 +250,23 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 UNIV_INTERN buf_pool_t*	buf_pool_ptr;
 
+/** Incremented each time buffer pool chunks are added or removed;
+protected by all buf_pool->mutex */
+UNIV_INTERN ulint		buf_withdraw_clock;
+/** TRUE while blocks are being withdrawn from the buffer pool
+in order to shrink it */
+UNIV_INTERN volatile ibool	buf_pool_withdrawing;
+/** TRUE while the buffer pool is being resized; the adaptive hash
+index cannot be enabled meanwhile */
+UNIV_INTERN volatile ibool	buf_pool_resizing;
+/** Event to signal buf_resize_thread() */
+UNIV_INTERN os_event_t		buf_resize_event;
+/** TRUE if buf_resize_thread() is active */
+UNIV_INTERN ibool		buf_resize_thread_active;
+/** Progress of the last buffer pool resize, for
+Innodb_buffer_pool_resize_status */
+UNIV_INTERN char		buf_pool_resize_status[512];
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 static ulint	buf_dbg_counter	= 0; /*!< This is used to insert validation
 					operations in execution in the
@@ -420,6 +438,12 @@ buf_get_total_stat(
 		tot_stat->n_ra_pages_read_rnd += buf_stat->n_ra_pages_read_rnd;
 		tot_stat->n_ra_pages_read += buf_stat->n_ra_pages_read;
 		tot_stat->n_ra_pages_evicted += buf_stat->n_ra_pages_evicted;
+		tot_stat->n_ra_pages_read_logical +=
+			buf_stat->n_ra_pages_read_logical;
+		tot_stat->n_ra_pages_logical_hit +=
+			buf_stat->n_ra_pages_logical_hit;
+		tot_stat->n_ra_pages_logical_evicted +=
+			buf_stat->n_ra_pages_logical_evicted;
 		tot_stat->n_pages_made_young += buf_stat->n_pages_made_young;
 
 		tot_stat->n_pages_not_made_young +=
@@ -1056,6 +1080,30 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Frees a chunk of buffer frames that was allocated by buf_chunk_init(). */
+static
+void
+buf_chunk_free(
+/*===========*/
+	buf_chunk_t*	chunk)	/*!< in/out: chunk of buffers */
+{
+	buf_block_t*	block;
+	ulint		i;
+
+	block = chunk->blocks;
+
+	for (i = chunk->size; i--; block++) {
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+
+	os_mem_free_large(chunk->mem, chunk->mem_size);
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1165,8 +1213,10 @@ buf_chunk_not_freed(
 Set buffer pool size variables after resizing it */
 static
 void
-buf_pool_set_sizes(void)
-/*====================*/
+buf_pool_set_sizes(
+/*===============*/
+	ulint	size)	/*!< in: the innodb_buffer_pool_size that
+			the buffer pool was resized to */
 {
 	ulint	i;
 	ulint	curr_size = 0;
@@ -1181,7 +1231,7 @@ buf_pool_set_sizes(void)
 	}
 
 	srv_buf_pool_curr_size = curr_size;
-	srv_buf_pool_old_size = srv_buf_pool_size;
+	srv_buf_pool_old_size = size;
 
 	buf_pool_mutex_exit_all();
 }
@@ -1199,6 +1249,7 @@ buf_pool_init_instance(
 	ulint		instance_no)	/*!< in: id of the instance */
 {
 	ulint		i;
+	ulint		chunk_size;
 	buf_chunk_t*	chunk;
 
 	/* 1. Initialize general fields
@@ -1211,23 +1262,51 @@ buf_pool_init_instance(
 	buf_pool_mutex_enter(buf_pool);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
-		buf_pool->chunks = chunk = mem_zalloc(sizeof *chunk);
+		/* The pool is allocated in chunks of
+		innodb_buffer_pool_chunk_size, so that it can be
+		resized online one chunk at a time. */
+		chunk_size = ut_min(buf_pool_size, srv_buf_pool_chunk_unit);
+
+		buf_pool->n_chunks = buf_pool_size / chunk_size;
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+		buf_pool->n_chunks_old = buf_pool->n_chunks;
+		buf_pool->chunks_heap = mem_heap_create(
+			buf_pool->n_chunks * sizeof *chunk);
+		buf_pool->chunks = mem_heap_zalloc(
+			buf_pool->chunks_heap,
+			buf_pool->n_chunks * sizeof *chunk);
 
 		UT_LIST_INIT(buf_pool->free);
+		UT_LIST_INIT(buf_pool->withdraw);
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size, populate)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+		buf_pool->curr_size = 0;
 
-			buf_pool_mutex_exit(buf_pool);
+		for (chunk = buf_pool->chunks;
+		     chunk < buf_pool->chunks + buf_pool->n_chunks;
+		     chunk++) {
 
-			return(DB_ERROR);
+			if (!buf_chunk_init(buf_pool, chunk, chunk_size,
+					    populate)) {
+
+				while (--chunk >= buf_pool->chunks) {
+					buf_chunk_free(chunk);
+				}
+
+				mem_heap_free(buf_pool->chunks_heap);
+				buf_pool->chunks_heap = NULL;
+				buf_pool->chunks = NULL;
+				buf_pool->n_chunks = 0;
+
+				buf_pool_mutex_exit(buf_pool);
+
+				return(DB_ERROR);
+			}
+
+			buf_pool->curr_size += chunk->size;
 		}
 
 		buf_pool->instance_no = instance_no;
 		buf_pool->old_pool_size = buf_pool_size;
-		buf_pool->curr_size = chunk->size;
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
 
 		buf_pool->page_hash = hash_create(2 * buf_pool->curr_size);
@@ -1294,7 +1373,7 @@ buf_pool_free_instance(
 		os_mem_free_large(chunk->mem, chunk->mem_size);
 	}
 
-	mem_free(buf_pool->chunks);
+	mem_heap_free(buf_pool->chunks_heap);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
 }
@@ -1334,11 +1413,13 @@ buf_pool_init(
 		}
 	}
 
-	buf_pool_set_sizes();
+	buf_pool_set_sizes(srv_buf_pool_size);
 	buf_LRU_old_ratio_update(100 * 3/ 8, FALSE);
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_resize_event = os_event_create(NULL);
+
 	return(DB_SUCCESS);
 }
 
@@ -1357,6 +1438,9 @@ buf_pool_free(
 		buf_pool_free_instance(buf_pool_from_array(i));
 	}
 
+	/* buf_resize_event was freed by os_sync_free() */
+	buf_resize_event = NULL;
+
 	mem_free(buf_pool_ptr);
 	buf_pool_ptr = NULL;
 }
@@ -1489,6 +1573,710 @@ buf_relocate(
 	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold, dpage);
 }
 
+/********************************************************************//**
+Determines if a block is in a chunk that is being withdrawn from the
+buffer pool.
+@return	TRUE if the block will be removed along with its chunk */
+UNIV_INTERN
+ibool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block */
+{
+	const buf_chunk_t*	chunk;
+	const buf_chunk_t*	echunk;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	if (UNIV_LIKELY(buf_pool->n_chunks_new >= buf_pool->n_chunks)) {
+
+		return(FALSE);
+	}
+
+	chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (block >= chunk->blocks
+		    && block < chunk->blocks + chunk->size) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/********************************************************************//**
+Determines if a frame is in a chunk that is being withdrawn from the
+buffer pool.
+@return	TRUE if the frame will be removed along with its chunk */
+UNIV_INTERN
+ibool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr)		/*!< in: pointer into a frame */
+{
+	const buf_chunk_t*	chunk;
+	const buf_chunk_t*	echunk;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	if (UNIV_LIKELY(buf_pool->n_chunks_new >= buf_pool->n_chunks)) {
+
+		return(FALSE);
+	}
+
+	chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (ptr >= chunk->blocks->frame
+		    && ptr < chunk->blocks->frame
+		    + chunk->size * UNIV_PAGE_SIZE) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/********************************************************************//**
+Relocates a file page from a chunk that is being withdrawn to a free
+block of the remaining chunks.  The page is moved to the same position
+of the LRU list, the unzip_LRU list and the flush list.
+@return	TRUE if the page was relocated */
+static
+ibool
+buf_page_realloc(
+/*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_block_t*	block)		/*!< in/out: block to relocate */
+{
+	buf_block_t*	new_block;
+	buf_page_t*	b;
+	buf_page_t*	bpage;
+	ulint		fold;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+	ut_ad(!btr_search_enabled);
+
+	new_block = buf_LRU_get_free_only(buf_pool);
+
+	if (new_block == NULL) {
+
+		return(FALSE);
+	}
+
+	ut_ad(!buf_block_will_withdrawn(buf_pool, new_block));
+
+	mutex_enter(&block->mutex);
+	mutex_enter(&new_block->mutex);
+
+	/* buf_page_optimistic_get() may buffer-fix the block
+	without holding buf_pool->mutex. */
+	if (!buf_page_can_relocate(&block->page)) {
+		mutex_exit(&block->mutex);
+
+		buf_LRU_block_free_non_file_page(new_block);
+		mutex_exit(&new_block->mutex);
+
+		return(FALSE);
+	}
+
+	ut_ad(block->page.in_LRU_list);
+	ut_ad(block->page.in_page_hash);
+	ut_ad(!block->page.in_zip_hash);
+	ut_ad(block->index == NULL);
+
+	memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
+	memcpy(&new_block->page, &block->page, sizeof block->page);
+
+	/* relocate buf_pool->LRU */
+	ut_d(block->page.in_LRU_list = FALSE);
+
+	b = UT_LIST_GET_PREV(LRU, &block->page);
+	UT_LIST_REMOVE(LRU, buf_pool->LRU, &block->page);
+
+	if (b) {
+		UT_LIST_INSERT_AFTER(LRU, buf_pool->LRU, b, &new_block->page);
+	} else {
+		UT_LIST_ADD_FIRST(LRU, buf_pool->LRU, &new_block->page);
+	}
+
+	if (UNIV_UNLIKELY(buf_pool->LRU_old == &block->page)) {
+		buf_pool->LRU_old = &new_block->page;
+	}
+
+	/* relocate buf_pool->unzip_LRU */
+	if (block->page.zip.data != NULL) {
+		buf_block_t*	prev = UT_LIST_GET_PREV(unzip_LRU, block);
+
+		ut_ad(block->in_unzip_LRU_list);
+		ut_d(block->in_unzip_LRU_list = FALSE);
+		UT_LIST_REMOVE(unzip_LRU, buf_pool->unzip_LRU, block);
+		ut_d(new_block->in_unzip_LRU_list = TRUE);
+
+		if (prev) {
+			UT_LIST_INSERT_AFTER(unzip_LRU, buf_pool->unzip_LRU,
+					     prev, new_block);
+		} else {
+			UT_LIST_ADD_FIRST(unzip_LRU, buf_pool->unzip_LRU,
+					  new_block);
+		}
+	}
+
+	/* relocate buf_pool->page_hash */
+	bpage = &block->page;
+	fold = buf_page_address_fold(bpage->space, bpage->offset);
+	HASH_DELETE(buf_page_t, hash, buf_pool->page_hash, fold, bpage);
+	ut_d(bpage->in_page_hash = FALSE);
+	bpage = &new_block->page;
+	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold, bpage);
+
+	/* relocate buf_pool->flush_list */
+	if (block->page.oldest_modification) {
+		buf_flush_relocate_on_flush_list(&block->page,
+						 &new_block->page);
+	}
+
+	new_block->lock_hash_val = block->lock_hash_val;
+	new_block->check_index_page_at_flush
+		= block->check_index_page_at_flush;
+	new_block->modify_clock = block->modify_clock;
+	new_block->n_hash_helps = 0;
+	new_block->index = NULL;
+
+	mutex_exit(&new_block->mutex);
+
+	/* Invalidate the optimistic cursor positions on the old block
+	and free it, like buf_LRU_block_remove_hashed_page() does. The
+	compressed page frame now belongs to new_block. */
+	buf_block_modify_clock_inc(block);
+	memset(block->frame + FIL_PAGE_OFFSET, 0xff, 4);
+	memset(block->frame + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID, 0xff, 4);
+	UNIV_MEM_INVALID(block->frame, UNIV_PAGE_SIZE);
+	buf_block_set_state(block, BUF_BLOCK_REMOVE_HASH);
+	page_zip_des_init(&block->page.zip);
+	block->page.oldest_modification = 0;
+
+	buf_block_set_state(block, BUF_BLOCK_MEMORY);
+	buf_LRU_block_free_non_file_page(block);
+
+	mutex_exit(&block->mutex);
+
+	return(TRUE);
+}
+
+/********************************************************************//**
+Sets the progress of the buffer pool resize that is shown in
+Innodb_buffer_pool_resize_status and writes it to the error log. */
+static
+void
+buf_resize_status(
+/*==============*/
+	const char*	fmt,	/*!< in: printf(3) format string */
+	...)			/*!< in: arguments corresponding to fmt */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+#ifdef __WIN__
+	_vsnprintf(buf_pool_resize_status,
+		   sizeof buf_pool_resize_status - 1, fmt, ap);
+#else
+	vsnprintf(buf_pool_resize_status,
+		  sizeof buf_pool_resize_status, fmt, ap);
+#endif /* __WIN__ */
+	va_end(ap);
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, "  InnoDB: %s\n", buf_pool_resize_status);
+}
+
+/********************************************************************//**
+Withdraws the blocks of the chunks that are being removed from a buffer
+pool instance.  Free blocks are moved to buf_pool->withdraw.  Pages are
+evicted from the tail of the LRU list to make room, and the file pages
+and compressed pages that remain in the withdrawn chunks are relocated
+to the other chunks.  Pages that are in use are skipped.
+@return	TRUE if some blocks could not be withdrawn yet */
+static
+ibool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_page_t*	bpage;
+	buf_page_t*	next_bpage;
+	ulint		n_free = 0;
+	ulint		n_withdrawn;
+	ulint		i;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	/* Recombine the free compressed page fragments, so that
+	the withdrawn frames of the buddy allocator become free. */
+	buf_buddy_condense_free(buf_pool);
+
+	for (bpage = UT_LIST_GET_FIRST(buf_pool->free);
+	     bpage != NULL; bpage = next_bpage) {
+
+		next_bpage = UT_LIST_GET_NEXT(list, bpage);
+
+		if (buf_block_will_withdrawn(
+			    buf_pool, (buf_block_t*) bpage)) {
+
+			ut_ad(bpage->in_free_list);
+			ut_d(bpage->in_free_list = FALSE);
+			UT_LIST_REMOVE(list, buf_pool->free, bpage);
+			UT_LIST_ADD_LAST(list, buf_pool->withdraw, bpage);
+		} else {
+			n_free++;
+		}
+	}
+
+	n_withdrawn = UT_LIST_GET_LEN(buf_pool->withdraw);
+
+	buf_pool_mutex_exit(buf_pool);
+
+	/* Make sure that there are enough free blocks to relocate
+	the remaining pages to.  Evicting a page of a withdrawn
+	chunk also withdraws its block. */
+	for (i = n_withdrawn + n_free; i < buf_pool->withdraw_target; i++) {
+		if (!buf_LRU_search_and_free_block(buf_pool, 0)) {
+			/* The tail of the LRU list is dirty. */
+			buf_flush_LRU(buf_pool, buf_pool->withdraw_target - i);
+			buf_flush_wait_batch_end(buf_pool, BUF_FLUSH_LRU);
+			break;
+		}
+	}
+
+	buf_pool_mutex_enter(buf_pool);
+
+	for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU);
+	     bpage != NULL; bpage = next_bpage) {
+
+		next_bpage = UT_LIST_GET_NEXT(LRU, bpage);
+
+		if (bpage->zip.data != NULL
+		    && buf_frame_will_withdrawn(buf_pool, bpage->zip.data)) {
+
+			buf_pool_mutex_exit_forbid(buf_pool);
+			buf_buddy_realloc(buf_pool, bpage->zip.data,
+					  page_zip_get_size(&bpage->zip));
+			buf_pool_mutex_exit_allow(buf_pool);
+		}
+
+		if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE
+		    && buf_block_will_withdrawn(
+			    buf_pool, (buf_block_t*) bpage)) {
+
+			buf_pool_mutex_exit_forbid(buf_pool);
+			buf_page_realloc(buf_pool, (buf_block_t*) bpage);
+			buf_pool_mutex_exit_allow(buf_pool);
+		}
+	}
+
+	n_withdrawn = UT_LIST_GET_LEN(buf_pool->withdraw);
+
+	buf_pool_mutex_exit(buf_pool);
+
+	ut_ad(n_withdrawn <= buf_pool->withdraw_target);
+
+	return(n_withdrawn < buf_pool->withdraw_target);
+}
+
+/********************************************************************//**
+Puts the withdrawn blocks of a buffer pool instance back to the free
+list, when a shrink of the buffer pool is abandoned. */
+static
+void
+buf_pool_withdraw_cancel(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_page_t*	bpage;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	buf_pool->n_chunks_new = buf_pool->n_chunks;
+	buf_pool->withdraw_target = 0;
+
+	while ((bpage = UT_LIST_GET_FIRST(buf_pool->withdraw)) != NULL) {
+		UT_LIST_REMOVE(list, buf_pool->withdraw, bpage);
+		UT_LIST_ADD_LAST(list, buf_pool->free, bpage);
+		ut_d(bpage->in_free_list = TRUE);
+	}
+
+	buf_pool_mutex_exit(buf_pool);
+}
+
+/** Fold function of buf_page_t for HASH_MIGRATE() */
+#define BUF_PAGE_HASH_FOLD_BPAGE(b)	\
+	buf_page_address_fold((b)->space, (b)->offset)
+
+/********************************************************************//**
+Rebuilds buf_pool->page_hash and buf_pool->zip_hash for the current
+size of a buffer pool instance. */
+static
+void
+buf_pool_resize_hash(
+/*=================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	hash_table_t*	new_hash_table;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+	HASH_MIGRATE(buf_pool->page_hash, new_hash_table, buf_page_t, hash,
+		     BUF_PAGE_HASH_FOLD_BPAGE);
+	hash_table_free(buf_pool->page_hash);
+	buf_pool->page_hash = new_hash_table;
+
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+	HASH_MIGRATE(buf_pool->zip_hash, new_hash_table, buf_page_t, hash,
+		     BUF_POOL_ZIP_FOLD_BPAGE);
+	hash_table_free(buf_pool->zip_hash);
+	buf_pool->zip_hash = new_hash_table;
+}
+
+/********************************************************************//**
+Adds or removes chunks of a buffer pool instance, after the blocks of
+the removed chunks have been withdrawn.
+@return	TRUE if all the chunks could be allocated */
+static
+ibool
+buf_pool_resize_chunks(
+/*===================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	buf_chunk_t*	chunk;
+	ulint		n_cells;
+	ibool		success	= TRUE;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	if (buf_pool->n_chunks_new < buf_pool->n_chunks) {
+		ut_a(UT_LIST_GET_LEN(buf_pool->withdraw)
+		     == buf_pool->withdraw_target);
+
+		/* The memory of the removed chunks is freed by
+		buf_pool_resize_chunks_free(), because threads that
+		do not hold buf_pool->mutex may still be looking at
+		chunks[n_chunks_new..n_chunks-1]. */
+		buf_pool->n_chunks_old = buf_pool->n_chunks;
+		buf_pool->n_chunks = buf_pool->n_chunks_new;
+
+		UT_LIST_INIT(buf_pool->withdraw);
+		buf_pool->withdraw_target = 0;
+
+	} else if (buf_pool->n_chunks_new > buf_pool->n_chunks) {
+		buf_chunk_t*	new_chunks;
+		mem_heap_t*	new_heap;
+		ulint		n;
+
+		new_heap = mem_heap_create(
+			buf_pool->n_chunks_new * sizeof *chunk);
+		new_chunks = mem_heap_zalloc(
+			new_heap, buf_pool->n_chunks_new * sizeof *chunk);
+		memcpy(new_chunks, buf_pool->chunks,
+		       buf_pool->n_chunks * sizeof *chunk);
+
+		for (n = buf_pool->n_chunks; n < buf_pool->n_chunks_new; n++) {
+			if (!buf_chunk_init(buf_pool, new_chunks + n,
+					    srv_buf_pool_chunk_unit,
+					    srv_buf_pool_populate)) {
+
+				buf_pool->n_chunks_new = n;
+				success = FALSE;
+				break;
+			}
+		}
+
+		/* Publish the array before the count, so that
+		buf_block_align_instance(), which reads them in the
+		opposite order, never reads past the end of chunks[].
+		The old array is freed by buf_pool_resize_chunks_free(). */
+		buf_pool->chunks = new_chunks;
+		os_wmb;
+		buf_pool->n_chunks = buf_pool->n_chunks_new;
+		buf_pool->n_chunks_old = buf_pool->n_chunks;
+
+		buf_pool->chunks_old_heap = buf_pool->chunks_heap;
+		buf_pool->chunks_heap = new_heap;
+	}
+
+	buf_pool->old_pool_size = buf_pool->curr_pool_size;
+	buf_pool->curr_size = 0;
+
+	for (chunk = buf_pool->chunks;
+	     chunk < buf_pool->chunks + buf_pool->n_chunks;
+	     chunk++) {
+		buf_pool->curr_size += chunk->size;
+	}
+
+	buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+
+	/* Rebuild the page hash tables if they are now more than
+	twice too big or too small. */
+	n_cells = hash_get_n_cells(buf_pool->page_hash);
+
+	if (n_cells > 4 * buf_pool->curr_size
+	    || n_cells < buf_pool->curr_size) {
+
+		buf_pool_resize_hash(buf_pool);
+	}
+
+	return(success);
+}
+
+/********************************************************************//**
+Frees the chunks and the chunk array that buf_pool_resize_chunks()
+removed from a buffer pool instance.  It must be called after
+buf_withdraw_clock has been incremented, when no thread can be
+looking at them any more. */
+static
+void
+buf_pool_resize_chunks_free(
+/*========================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	while (buf_pool->n_chunks_old > buf_pool->n_chunks) {
+		buf_chunk_free(buf_pool->chunks
+			       + --buf_pool->n_chunks_old);
+	}
+
+	if (buf_pool->chunks_old_heap != NULL) {
+		mem_heap_free(buf_pool->chunks_old_heap);
+		buf_pool->chunks_old_heap = NULL;
+	}
+}
+
+/********************************************************************//**
+Resizes the buffer pool to innodb_buffer_pool_size.  When shrinking,
+the blocks of the last chunks of each instance are withdrawn first,
+while the pool stays in use.  The adaptive hash index is disabled
+during the resize, and it is rebuilt for the new size. */
+static
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	ulint	i;
+	ulint	size		= srv_buf_pool_size;
+	ulint	n_chunks	= size / srv_buf_pool_instances
+				/ srv_buf_pool_chunk_unit;
+	ibool	shrink		= FALSE;
+	ibool	success		= TRUE;
+	ibool	btr_search_was_enabled;
+	ulint	retry		= 0;
+
+	ut_a(n_chunks > 0);
+
+	buf_resize_status("Resizing buffer pool from %lu to %lu"
+			  " (unit=%lu).",
+			  (ulong) srv_buf_pool_old_size, (ulong) size,
+			  (ulong) srv_buf_pool_chunk_unit);
+
+	/* The adaptive hash index points to the frames of the blocks,
+	and its hash table is sized for the buffer pool. */
+	buf_pool_resizing = TRUE;
+	btr_search_was_enabled = btr_search_enabled;
+
+	if (btr_search_was_enabled) {
+		buf_resize_status("Disabling adaptive hash index.");
+		btr_search_disable();
+	}
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		ulint		n;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		ut_ad(buf_pool->n_chunks_new == buf_pool->n_chunks);
+		ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw) == 0);
+
+		buf_pool->n_chunks_new = n_chunks;
+		buf_pool->withdraw_target = 0;
+
+		for (n = n_chunks; n < buf_pool->n_chunks; n++) {
+			buf_pool->withdraw_target += buf_pool->chunks[n].size;
+			shrink = TRUE;
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	if (shrink) {
+		buf_pool_withdrawing = TRUE;
+	}
+
+	while (shrink) {
+		ibool	should_retry	= FALSE;
+		ulint	n_withdrawn	= 0;
+		ulint	n_target	= 0;
+
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+			buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+			if (buf_pool->withdraw_target == 0) {
+				continue;
+			}
+
+			if (buf_pool_withdraw_blocks(buf_pool)) {
+				should_retry = TRUE;
+			}
+
+			n_withdrawn += UT_LIST_GET_LEN(buf_pool->withdraw);
+			n_target += buf_pool->withdraw_target;
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE
+		    || size != srv_buf_pool_size) {
+			/* Give up: the server is shutting down, or
+			another size was requested meanwhile, which
+			buf_resize_thread() will resize to next. */
+			for (i = 0; i < srv_buf_pool_instances; i++) {
+				buf_pool_withdraw_cancel(
+					buf_pool_from_array(i));
+			}
+
+			buf_pool_withdrawing = FALSE;
+			buf_pool_resizing = FALSE;
+
+			if (btr_search_was_enabled) {
+				btr_search_enable();
+			}
+
+			buf_resize_status("Resizing buffer pool to %lu was"
+					  " interrupted.", (ulong) size);
+			return;
+		}
+
+		if (!should_retry) {
+			break;
+		}
+
+		retry++;
+		buf_resize_status("Withdrawing blocks to be shrunken."
+				  " (%lu/%lu), retry %lu.",
+				  (ulong) n_withdrawn, (ulong) n_target,
+				  (ulong) retry);
+
+		os_thread_sleep(ut_min(retry, 10) * 100000);
+	}
+
+	buf_resize_status("Resizing the chunks of buffer pool.");
+
+	buf_pool_mutex_enter_all();
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		if (!buf_pool_resize_chunks(buf_pool_from_array(i))) {
+			success = FALSE;
+		}
+	}
+
+	/* Pointers to blocks that were obtained before this point
+	may point to freed memory. */
+	buf_withdraw_clock++;
+	buf_pool_withdrawing = FALSE;
+
+	buf_pool_mutex_exit_all();
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_resize_chunks_free(buf_pool_from_array(i));
+	}
+
+	buf_pool_set_sizes(size);
+
+	ibuf_max_size_update();
+
+	btr_search_sys_resize(buf_pool_get_curr_size() / sizeof(void*) / 64);
+
+	buf_pool_resizing = FALSE;
+
+	if (btr_search_was_enabled) {
+		buf_resize_status("Re-enabling adaptive hash index.");
+		btr_search_enable();
+	}
+
+	if (!success) {
+		buf_resize_status("Could not allocate memory for all the"
+				  " chunks; the buffer pool size is %lu.",
+				  (ulong) buf_pool_get_curr_size());
+		return;
+	}
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, "  InnoDB: Completed resizing buffer pool"
+		" to %lu.\n", (ulong) size);
+
+	{
+		char	time_buf[20];
+
+		ut_sprintf_timestamp(time_buf);
+
+		ut_snprintf(buf_pool_resize_status,
+			    sizeof buf_pool_resize_status,
+			    "Completed resizing buffer pool to %lu at %s.",
+			    (ulong) size, time_buf);
+	}
+}
+
+/********************************************************************//**
+A thread which resizes the buffer pool to innodb_buffer_pool_size
+after SET GLOBAL innodb_buffer_pool_size.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_resize_thread(
+/*==============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ib_int64_t	sig_count;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(buf_resize_thread_key);
+#endif
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		sig_count = os_event_reset(buf_resize_event);
+
+		if (srv_buf_pool_old_size == srv_buf_pool_size) {
+			os_event_wait_low(buf_resize_event, sig_count);
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		if (srv_buf_pool_old_size == srv_buf_pool_size) {
+			continue;
+		}
+
+		buf_pool_resize();
+	}
+
+	buf_resize_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /********************************************************************//**
 Determine if a block is a sentinel for a buffer pool watch.
 @return	TRUE if a sentinel for a buffer pool watch, FALSE if not */
@@ -2052,9 +2840,13 @@ buf_block_align_instance(
 	buf_chunk_t*	chunk;
 	ulint		i;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	/* The caller need not hold buf_pool->mutex.  Read the count
+	before the array, which buf_pool_resize_chunks() publishes
+	in the opposite order. */
+	i = buf_pool->n_chunks;
+	os_rmb;
+
+	for (chunk = buf_pool->chunks; i--; chunk++) {
 		ulint	offs;
 
 		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
@@ -2166,19 +2958,21 @@ buf_pointer_is_block_field_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	const void*	ptr)		/*!< in: pointer not dereferenced */
 {
-	const buf_chunk_t*		chunk	= buf_pool->chunks;
-	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
+	const buf_chunk_t*	chunk;
+	const buf_chunk_t*	echunk;
+	ulint			n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	while (chunk < echunk) {
+	/* See buf_block_align_instance(). */
+	n_chunks = buf_pool->n_chunks;
+	os_rmb;
+
+	for (chunk = buf_pool->chunks, echunk = chunk + n_chunks;
+	     chunk < echunk; chunk++) {
 		if (ptr >= (void *)chunk->blocks
 		    && ptr < (void *)(chunk->blocks + chunk->size)) {
 
 			return(TRUE);
 		}
-
-		chunk++;
 	}
 
 	return(FALSE);
@@ -2985,6 +3779,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->read_ahead_logical = FALSE;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	HASH_INVALIDATE(bpage, hash);
@@ -3515,6 +4310,7 @@ buf_page_io_complete(
 	buf_pool_t*	buf_pool = buf_pool_from_bpage(bpage);
 	const ibool	uncompressed = (buf_page_get_state(bpage)
 					== BUF_BLOCK_FILE_PAGE);
+	ulint		written_space = ULINT_UNDEFINED;
 
 	ut_a(buf_page_in_file(bpage));
 
@@ -3698,6 +4494,8 @@ corrupt:
 		/* Write means a flush operation: call the completion
 		routine in the flush system */
 
+		written_space = buf_page_get_space(bpage);
+
 		buf_flush_write_complete(bpage);
 
 		if (uncompressed) {
@@ -3725,6 +4523,12 @@ corrupt:
 	mutex_exit(buf_page_get_mutex(bpage));
 	buf_pool_mutex_exit(buf_pool);
 
+	if (written_space != ULINT_UNDEFINED) {
+		/* Let a pending DROP of the tablespace proceed;
+		see buf_flush_page(). */
+		fil_decr_pending_ops(written_space);
+	}
+
 	return(TRUE);
 }
 
@@ -4052,7 +4856,8 @@ buf_pool_validate_instance(
 	}
 
 	ut_a(UT_LIST_GET_LEN(buf_pool->LRU) == n_lru);
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
 		fprintf(stderr, "Free list len %lu, free blocks %lu\n",
 			(ulong) UT_LIST_GET_LEN(buf_pool->free),
 			(ulong) n_free);
@@ -717,7 +717,7 @@ and also wakes up the aio thread if simulated aio is used. It is very
 important to call this function after a batch of writes has been posted,
 and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
-static
+UNIV_INTERN
 void
 buf_flush_buffered_writes(void)
 /*===========================*/
@@ -1212,6 +1212,11 @@ buf_flush_page_try(
 		return(FALSE);
 	}
 
+	/* Pin the tablespace as in buf_flush_page(). */
+	if (fil_inc_pending_ops(buf_block_get_space(block), FALSE)) {
+		return(FALSE);
+	}
+
 	buf_pool->init_flush[BUF_FLUSH_LRU] = TRUE;
 
 	buf_page_set_io_fix(&block->page, BUF_IO_WRITE);
@@ -1267,9 +1272,11 @@ NOTE: in simulated aio we must call
 os_aio_simulated_wake_handler_threads after we have posted a batch of
 writes! NOTE: buf_pool->mutex and buf_page_get_mutex(bpage) must be
 held upon entering this function, and they will be released by this
-function. */
+function.
+@return TRUE if the write was queued, FALSE if the tablespace has been
+dropped and the page was removed from the flush list instead */
 static
-void
+ibool
 buf_flush_page(
 /*===========*/
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
@@ -1289,6 +1296,20 @@ buf_flush_page(
 
 	ut_ad(buf_flush_ready_for_flush(bpage, flush_type));
 
+	/* Pin the tablespace until the write completes, so that
+	fil_delete_tablespace() need not look for pages that are being
+	written. The pin is released in buf_page_io_complete(). DROP
+	TABLE leaves the dirty pages of the tablespace in the buffer
+	pool, and their modifications are discarded here. */
+	if (fil_inc_pending_ops(buf_page_get_space(bpage), FALSE)) {
+		buf_flush_remove(bpage);
+
+		mutex_exit(block_mutex);
+		buf_pool_mutex_exit(buf_pool);
+
+		return(FALSE);
+	}
+
 	buf_page_set_io_fix(bpage, BUF_IO_WRITE);
 
 	buf_page_set_flush_type(bpage, flush_type);
@@ -1374,6 +1395,29 @@ buf_flush_page(
 	}
 #endif /* UNIV_DEBUG */
 	buf_flush_write_block_low(bpage);
+
+	return(TRUE);
+}
+
+/********************************************************************//**
+Writes a dirty page outside of a flush batch.  This is used for writing
+the pages of a single tablespace.  The write may stay in the doublewrite
+memory buffer until buf_flush_buffered_writes() is called.
+NOTE: buf_pool->mutex and buf_page_get_mutex(bpage) must be held upon
+entering this function, and they will be released by this function.
+@return TRUE if the write was queued, FALSE if the tablespace has been
+dropped and the page was removed from the flush list instead */
+UNIV_INTERN
+ibool
+buf_flush_single_page(
+/*==================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_page_t*	bpage)		/*!< in: dirty page, ready for
+					BUF_FLUSH_LIST */
+{
+	ut_ad(buf_flush_ready_for_flush(bpage, BUF_FLUSH_LIST));
+
+	return(buf_flush_page(buf_pool, bpage, BUF_FLUSH_LIST));
 }
 
 /***********************************************************//**
@@ -1395,6 +1439,7 @@ buf_flush_try_neighbors(
 	ulint		i;
 	ulint		low;
 	ulint		high;
+	ulint		space_size;
 	ulint		count = 0;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 
@@ -1423,8 +1468,15 @@ buf_flush_try_neighbors(
 
 	/* fprintf(stderr, "Flush area: low %lu high %lu\n", low, high); */
 
-	if (high > fil_space_get_size(space)) {
-		high = fil_space_get_size(space);
+	space_size = fil_space_get_size(space);
+
+	if (offset >= space_size) {
+		/* The tablespace has been dropped. Let buf_flush_page()
+		discard the victim. */
+		low = offset;
+		high = offset + 1;
+	} else if (high > space_size) {
+		high = space_size;
 	}
 
 	for (i = low; i < high; i++) {
@@ -1482,10 +1534,12 @@ buf_flush_try_neighbors(
 				doublewrite buffer before we start
 				waiting. */
 
-				buf_flush_page(buf_pool, bpage, flush_type);
+				if (buf_flush_page(buf_pool, bpage,
+						   flush_type)) {
+					count++;
+				}
 				ut_ad(!mutex_own(block_mutex));
 				ut_ad(!buf_pool_mutex_own(buf_pool));
-				count++;
 				continue;
 			} else {
 				mutex_exit(block_mutex);
@@ -255,6 +255,7 @@ buf_LRU_drop_page_hash_for_tablespace(
 	ulint*		page_arr;
 	ulint		num_entries;
 	ulint		zip_size;
+	ulint		withdraw_clock;
 
 	zip_size = fil_space_get_zip_size(id);
 
@@ -313,6 +314,8 @@ next_page:
 
 		/* Array full. We release the buf_pool->mutex to obey
 		the latching order. */
+		withdraw_clock = buf_withdraw_clock;
+
 		buf_pool_mutex_exit(buf_pool);
 
 		buf_LRU_drop_page_hash_batch(
@@ -322,6 +325,12 @@ next_page:
 
 		buf_pool_mutex_enter(buf_pool);
 
+		/* The chunk of bpage may have been freed by a resize
+		of the buffer pool. */
+		if (withdraw_clock != buf_withdraw_clock) {
+			goto scan_again;
+		}
+
 		/* Note that we released the buf_pool mutex above
 		after reading the prev_bpage during processing of a
 		page_hash_batch (i.e.: when the array was full).
@@ -439,14 +448,18 @@ buf_flush_try_yield(
 
 /******************************************************************//**
 Removes a single page from a given tablespace inside a specific
-buffer pool instance.
-@return TRUE if page was removed. */
+buffer pool instance, or writes it to disk.  If the page is written,
+buf_pool->mutex and the flush list mutex are released and acquired
+again.
+@return TRUE if page was removed or its write was queued. */
 static
 ibool
 buf_flush_or_remove_page(
 /*=====================*/
 	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
-	buf_page_t*	bpage)		/*!< in/out: bpage to remove */
+	buf_page_t*	bpage,		/*!< in/out: bpage to remove */
+	ibool		flush)		/*!< in: TRUE to write the page
+					instead of removing it */
 {
 	mutex_t*	block_mutex;
 	ibool		processed = FALSE;
@@ -466,6 +479,24 @@ buf_flush_or_remove_page(
 		yet; maybe the system is currently reading it
 		in, or flushing the modifications to the file */
 
+	} else if (flush) {
+
+		buf_flush_list_mutex_exit(buf_pool);
+
+		mutex_enter(block_mutex);
+
+		ut_ad(bpage->oldest_modification != 0);
+
+		/* This releases buf_pool->mutex and block_mutex. */
+		buf_flush_single_page(buf_pool, bpage);
+
+		processed = TRUE;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		buf_flush_list_mutex_enter(buf_pool);
+
+		return(processed);
 	} else {
 
 		/* We have to release the flush_list_mutex to obey the
@@ -499,16 +530,18 @@ buf_flush_or_remove_page(
 /******************************************************************//**
 Remove all dirty pages belonging to a given tablespace inside a specific
 buffer pool instance when we are deleting the data file(s) of that
-tablespace. The pages still remain a part of LRU and are evicted from
-the list as they age towards the tail of the LRU.
-@return TRUE if all freed. */
+tablespace, or write them to disk. The pages still remain a part of LRU
+and are evicted from the list as they age towards the tail of the LRU.
+@return TRUE if all freed or written. */
 static
 ibool
 buf_flush_or_remove_pages(
 /*======================*/
 	buf_pool_t*	buf_pool,	/*!< buffer pool instance */
-	ulint		id)		/*!< in: target space id for which
+	ulint		id,		/*!< in: target space id for which
 					to remove or flush pages */
+	ibool		flush)		/*!< in: TRUE to write the pages
+					instead of removing them */
 {
 	buf_page_t*	prev;
 	buf_page_t*	bpage;
@@ -517,6 +550,8 @@ buf_flush_or_remove_pages(
 
 	buf_flush_list_mutex_enter(buf_pool);
 
+rescan:
+
 	for (bpage = UT_LIST_GET_LAST(buf_pool->flush_list);
 	     bpage != NULL;
 	     bpage = prev) {
@@ -534,12 +569,19 @@ buf_flush_or_remove_pages(
 			/* Skip this block, as it does not belong to
 			the target space. */
 
-		} else if (!buf_flush_or_remove_page(buf_pool, bpage)) {
+		} else if (!buf_flush_or_remove_page(buf_pool, bpage, flush)) {
 
 			/* Remove was unsuccessful, we have to try again
 			by scanning the entire list from the end. */
 
 			all_freed = FALSE;
+
+		} else if (flush) {
+
+			/* The mutexes were released for the write:
+			prev may no longer be in the flush list. */
+
+			goto rescan;
 		}
 
 		++processed;
@@ -569,19 +611,29 @@ void
 buf_flush_dirty_pages(
 /*==================*/
 	buf_pool_t*	buf_pool,	/*!< buffer pool instance */
-	ulint		id)		/*!< in: space id */
+	ulint		id,		/*!< in: space id */
+	ibool		flush)		/*!< in: TRUE to write the pages
+					and wait for the writes */
 {
 	ibool	all_freed;
 
 	do {
 		buf_pool_mutex_enter(buf_pool);
 
-		all_freed = buf_flush_or_remove_pages(buf_pool, id);
+		all_freed = buf_flush_or_remove_pages(buf_pool, id, flush);
 
 		buf_pool_mutex_exit(buf_pool);
 
 		ut_ad(buf_flush_validate(buf_pool));
 
+		if (flush) {
+			/* Post the writes that are waiting in the
+			doublewrite buffer.  A page leaves the flush
+			list when its write completes; until then it
+			is io-fixed and the scan is repeated. */
+			buf_flush_buffered_writes();
+		}
+
 		if (!all_freed) {
 			os_thread_sleep(20000);
 		}
@@ -761,7 +813,19 @@ buf_LRU_flush_or_remove_pages(
 			removed. No need to evict all pages from LRU
 			list. Just evict pages from flush list without
 			writing. */
-			buf_flush_dirty_pages(buf_pool, id);
+			buf_flush_dirty_pages(buf_pool, id, FALSE);
+			break;
+
+		case BUF_REMOVE_FLUSH_WRITE:
+			/* An EXPORT case. Write the dirty pages and
+			leave them in the buffer pool. */
+			buf_flush_dirty_pages(buf_pool, id, TRUE);
+			break;
+
+		case BUF_REMOVE_NONE:
+			/* A lazy DROP or TRUNCATE. The pages are
+			discarded by buf_flush_page() or evicted by
+			the normal LRU replacement. */
 			break;
 		}
 	}
@@ -896,6 +960,7 @@ buf_LRU_free_from_common_LRU_list(
 	     bpage = UT_LIST_GET_PREV(LRU, bpage), distance--) {
 
 		unsigned	accessed;
+		ibool		logical;
 		mutex_t*	block_mutex = buf_page_get_mutex(bpage);
 
 		scanned++;
@@ -905,6 +970,7 @@ buf_LRU_free_from_common_LRU_list(
 
 		mutex_enter(block_mutex);
 		accessed = buf_page_is_accessed(bpage);
+		logical = bpage->read_ahead_logical;
 		freed = buf_LRU_free_block(bpage, TRUE);
 		mutex_exit(block_mutex);
 
@@ -914,6 +980,11 @@ buf_LRU_free_from_common_LRU_list(
 			the effectiveness of readahead */
 			if (!accessed) {
 				++buf_pool->stat.n_ra_pages_evicted;
+
+				if (logical) {
+					++buf_pool->stat
+						.n_ra_pages_logical_evicted;
+				}
 			}
 			break;
 		}
@@ -1053,6 +1124,18 @@ buf_LRU_get_free_only(
 
 	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
 
+	/* Do not hand out the blocks of chunks that are being
+	withdrawn; move them to buf_pool->withdraw instead. */
+	while (block != NULL
+	       && UNIV_UNLIKELY(buf_block_will_withdrawn(buf_pool, block))) {
+		ut_ad(block->page.in_free_list);
+		ut_d(block->page.in_free_list = FALSE);
+		UT_LIST_REMOVE(list, buf_pool->free, (&block->page));
+		UT_LIST_ADD_LAST(list, buf_pool->withdraw, (&block->page));
+
+		block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
+	}
+
 	if (block) {
 
 		ut_ad(block->page.in_free_list);
@@ -1962,8 +2045,13 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
-	UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
-	ut_d(block->page.in_free_list = TRUE);
+	if (UNIV_UNLIKELY(buf_block_will_withdrawn(buf_pool, block))) {
+		/* The chunk of the block is being withdrawn. */
+		UT_LIST_ADD_LAST(list, buf_pool->withdraw, (&block->page));
+	} else {
+		UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
+		ut_d(block->page.in_free_list = TRUE);
+	}
 
 	UNIV_MEM_ASSERT_AND_FREE(block->frame, UNIV_PAGE_SIZE);
 }
@@ -119,7 +119,8 @@ buf_read_page_low(
 			treat the tablespace as dropped; this is a timestamp we
 			use to stop dangling page reads from a tablespace
 			which we have DISCARDed + IMPORTed back */
-	ulint	offset)	/*!< in: page number */
+	ulint	offset,	/*!< in: page number */
+	ibool	logical)/*!< in: TRUE if this is a logical read-ahead */
 {
 	buf_page_t*	bpage;
 	ulint		wake_later;
@@ -168,6 +169,14 @@ buf_read_page_low(
 		return(0);
 	}
 
+	if (logical) {
+		mutex_t*	block_mutex = buf_page_get_mutex(bpage);
+
+		mutex_enter(block_mutex);
+		bpage->read_ahead_logical = TRUE;
+		mutex_exit(block_mutex);
+	}
+
 #ifdef UNIV_DEBUG
 	if (buf_debug_prints) {
 		fprintf(stderr,
@@ -346,7 +355,7 @@ read_ahead:
 				&err, FALSE,
 				ibuf_mode | OS_AIO_SIMULATED_WAKE_LATER,
 				space, zip_size, FALSE,
-				tablespace_version, i);
+				tablespace_version, i, FALSE);
 			if (err == DB_TABLESPACE_DELETED) {
 				ut_print_timestamp(stderr);
 				fprintf(stderr,
@@ -410,7 +419,7 @@ buf_read_page(
 
 	count = buf_read_page_low(&err, TRUE, BUF_READ_ANY_PAGE, space,
 				  zip_size, FALSE,
-				  tablespace_version, offset);
+				  tablespace_version, offset, FALSE);
 	srv_buf_pool_reads += count;
 	if (err == DB_TABLESPACE_DELETED) {
 		ut_print_timestamp(stderr);
@@ -672,7 +681,8 @@ buf_read_ahead_linear(
 			count += buf_read_page_low(
 				&err, FALSE,
 				ibuf_mode,
-				space, zip_size, FALSE, tablespace_version, i);
+				space, zip_size, FALSE, tablespace_version, i,
+				FALSE);
 			if (err == DB_TABLESPACE_DELETED) {
 				ut_print_timestamp(stderr);
 				fprintf(stderr,
@@ -711,6 +721,82 @@ buf_read_ahead_linear(
 	return(count);
 }
 
+/********************************************************************//**
+Applies a logical read-ahead: issues asynchronous read requests for the
+leaf pages that a B-tree scan will visit next, in key order.  Unlike
+buf_read_ahead_linear(), this does not depend on the leaf pages being
+physically contiguous.  The caller must not hold any page latches.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_logical(
+/*===================*/
+	ulint		space,		/*!< in: space id */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes, or 0 */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					in the order of the scan */
+	ulint		n_stored)	/*!< in: number of page numbers
+					in the array */
+{
+	ib_int64_t	tablespace_version;
+	ulint		count;
+	ulint		err;
+	ulint		i;
+
+	if (srv_startup_is_before_trx_rollback_phase) {
+		/* No read-ahead to avoid thread deadlocks */
+		return(0);
+	}
+
+	tablespace_version = fil_space_get_version(space);
+
+	count = 0;
+
+	os_aio_simulated_put_read_threads_to_sleep();
+
+	for (i = 0; i < n_stored; i++) {
+		buf_pool_t*	buf_pool = buf_pool_get(space, page_nos[i]);
+
+		if (buf_pool->n_pend_reads
+		    > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+
+			break;
+		}
+
+		if (buf_read_page_low(&err, FALSE,
+				      BUF_READ_ANY_PAGE
+				      | OS_AIO_SIMULATED_WAKE_LATER,
+				      space, zip_size, FALSE,
+				      tablespace_version, page_nos[i], TRUE)) {
+
+			buf_pool->stat.n_ra_pages_read_logical++;
+			count++;
+		}
+
+		if (err == DB_TABLESPACE_DELETED) {
+
+			break;
+		}
+	}
+
+	os_aio_simulated_wake_handler_threads();
+
+#ifdef UNIV_DEBUG
+	if (buf_debug_prints && (count > 0)) {
+		fprintf(stderr,
+			"LOGICAL read-ahead space %lu pages %lu\n",
+			(ulong) space, (ulong) count);
+	}
+#endif /* UNIV_DEBUG */
+
+	/* Read ahead is considered one I/O operation for the purpose of
+	LRU policy decision. */
+	buf_LRU_stat_inc_io();
+
+	return(count);
+}
+
 /********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
@@ -765,7 +851,7 @@ buf_read_ibuf_merge_pages(
 		buf_read_page_low(&err, sync && (i + 1 == n_stored),
 				  BUF_READ_ANY_PAGE, space_ids[i],
 				  zip_size, TRUE, space_versions[i],
-				  page_nos[i]);
+				  page_nos[i], FALSE);
 
 		if (UNIV_UNLIKELY(err == DB_TABLESPACE_DELETED)) {
 tablespace_deleted:
@@ -872,12 +958,13 @@ buf_read_pages(
 		if ((i + 1 == n_stored) && sync) {
 			buf_read_page_low(&err, TRUE, BUF_READ_ANY_PAGE, space,
 					  zip_size, TRUE, tablespace_version,
-					  page_nos[i]);
+					  page_nos[i], FALSE);
 		} else {
 			buf_read_page_low(&err, FALSE, BUF_READ_ANY_PAGE
 					  | OS_AIO_SIMULATED_WAKE_LATER,
 					  space, zip_size, TRUE,
-					  tablespace_version, page_nos[i]);
+					  tablespace_version, page_nos[i],
+					  FALSE);
 		}
 	}
 
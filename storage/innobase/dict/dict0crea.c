@@ -35,6 +35,7 @@ Created 1/8/1996 Heikki Tuuri
 #include "mach0data.h"
 #include "dict0boot.h"
 #include "dict0dict.h"
+#include "ibuf0ibuf.h"
 #include "que0que.h"
 #include "row0ins.h"
 #include "row0mysql.h"
@@ -306,14 +307,13 @@ dict_build_table_def_step(
 			is_path = FALSE;
 		}
 
-		ut_ad(dict_table_get_format(table) <= DICT_TF_FORMAT_MAX);
+		ut_ad(dict_table_get_format(table) <= DICT_TF_FORMAT_TABLE_MAX);
 		ut_ad(!dict_table_zip_size(table)
 		      || dict_table_get_format(table) >= DICT_TF_FORMAT_ZIP);
 
-		flags = table->flags & ~(~0 << DICT_TF_BITS);
+		flags = dict_table_get_space_flags(table);
 		error = fil_create_new_single_table_tablespace(
-			space, path_or_name, is_path,
-			flags == DICT_TF_COMPACT ? 0 : flags,
+			space, path_or_name, is_path, flags,
 			table->initial_size);
 		table->space = (unsigned int) space;
 
@@ -706,6 +706,7 @@ dict_drop_index_tree(
 	ulint		root_page_no;
 	ulint		space;
 	ulint		zip_size;
+	index_id_t	index_id;
 	const byte*	ptr;
 	ulint		len;
 
@@ -729,6 +730,13 @@ dict_drop_index_tree(
 	ut_ad(len == 4);
 
 	space = mtr_read_ulint(ptr, MLOG_4BYTES, mtr);
+
+	ptr = rec_get_nth_field_old(rec, 1, &len);
+	ut_ad(len == 8);
+	index_id = mach_read_from_8(ptr);
+
+	ibuf_index_count_remove_index(space, index_id);
+
 	zip_size = fil_space_get_zip_size(space);
 
 	if (UNIV_UNLIKELY(zip_size == ULINT_UNDEFINED)) {
@@ -837,6 +845,8 @@ dict_truncate_index_tree(
 		goto create;
 	}
 
+	ibuf_index_count_remove_index(space, index_id);
+
 	/* We free all the pages but the root page first; this operation
 	may span several mini-transactions */
 
@@ -55,12 +55,14 @@ ib_warn_row_too_big(const dict_table_t*	table);
 #include "dict0boot.h"
 #include "dict0mem.h"
 #include "dict0crea.h"
+#include "dict0stats.h"
 #include "trx0undo.h"
 #include "btr0btr.h"
 #include "btr0cur.h"
 #include "btr0sea.h"
 #include "page0zip.h"
 #include "page0page.h"
+#include "fsp0fsp.h"
 #include "pars0pars.h"
 #include "pars0sym.h"
 #include "que0que.h"
@@ -111,6 +113,7 @@ static char	dict_ibfk[] = "_ibfk_";
 
 /** array of rw locks protecting
 dict_table_t::stat_initialized
+dict_table_t::stat_persistent
 dict_table_t::stat_n_rows (*)
 dict_table_t::stat_clustered_index_size
 dict_table_t::stat_sum_of_other_index_sizes
@@ -419,7 +422,20 @@ dict_table_autoinc_initialize(
 {
 	ut_ad(mutex_own(&table->autoinc_mutex));
 
+#ifdef HAVE_IB_GCC_ATOMIC_BUILTINS
+	/* Concurrent dict_table_autoinc_compare_and_swap() calls do
+	not acquire the mutex. */
+	for (;;) {
+		ib_uint64_t	old_value = table->autoinc;
+
+		if (os_compare_and_swap(&table->autoinc,
+					old_value, value)) {
+			break;
+		}
+	}
+#else /* HAVE_IB_GCC_ATOMIC_BUILTINS */
 	table->autoinc = value;
+#endif /* HAVE_IB_GCC_ATOMIC_BUILTINS */
 }
 
 /********************************************************************//**
@@ -450,10 +466,109 @@ dict_table_autoinc_update_if_greater(
 {
 	ut_ad(mutex_own(&table->autoinc_mutex));
 
+#ifdef HAVE_IB_GCC_ATOMIC_BUILTINS
+	/* Concurrent dict_table_autoinc_compare_and_swap() calls do
+	not acquire the mutex. */
+	for (;;) {
+		ib_uint64_t	old_value = table->autoinc;
+
+		if (value <= old_value
+		    || os_compare_and_swap(&table->autoinc,
+					   old_value, value)) {
+			break;
+		}
+	}
+#else /* HAVE_IB_GCC_ATOMIC_BUILTINS */
 	if (value > table->autoinc) {
 
 		table->autoinc = value;
 	}
+#endif /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+}
+
+/********************************************************************//**
+Reads the next autoinc value without acquiring the autoinc lock.  The
+value may be stale; it is meant to be passed to
+dict_table_autoinc_compare_and_swap().
+@return	value for a new row, or 0 */
+UNIV_INTERN
+ib_uint64_t
+dict_table_autoinc_peek(
+/*====================*/
+	dict_table_t*	table)	/*!< in: table */
+{
+#ifdef HAVE_IB_GCC_ATOMIC_BUILTINS
+	/* A plain 64-bit read could tear on a 32-bit platform. */
+	return(os_atomic_increment(&table->autoinc, 0));
+#else /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+	ib_uint64_t	value;
+
+	mutex_enter(&table->autoinc_mutex);
+	value = table->autoinc;
+	mutex_exit(&table->autoinc_mutex);
+
+	return(value);
+#endif /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+}
+
+/********************************************************************//**
+Replaces the autoinc counter if it still has the expected value.  This
+reserves AUTOINC values without holding the autoinc lock across the
+computation of the interval.  The caller must not hold the autoinc lock.
+@return	TRUE if the counter was replaced */
+UNIV_INTERN
+ibool
+dict_table_autoinc_compare_and_swap(
+/*================================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ib_uint64_t	old_value,	/*!< in: expected counter value */
+	ib_uint64_t	new_value)	/*!< in: new counter value */
+{
+#ifdef HAVE_IB_GCC_ATOMIC_BUILTINS
+	return(os_compare_and_swap(&table->autoinc, old_value, new_value));
+#else /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+	ibool	swapped;
+
+	mutex_enter(&table->autoinc_mutex);
+
+	swapped = table->autoinc == old_value;
+
+	if (swapped) {
+		table->autoinc = new_value;
+	}
+
+	mutex_exit(&table->autoinc_mutex);
+
+	return(swapped);
+#endif /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+}
+
+/********************************************************************//**
+Replaces the autoinc counter if it still has the expected value, which
+the caller read while holding the autoinc lock.  Concurrent
+dict_table_autoinc_compare_and_swap() calls do not acquire the lock,
+and they may have moved the counter since.
+@return	TRUE if the counter was replaced */
+UNIV_INTERN
+ibool
+dict_table_autoinc_replace(
+/*=======================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ib_uint64_t	old_value,	/*!< in: expected counter value */
+	ib_uint64_t	new_value)	/*!< in: new counter value */
+{
+	ut_ad(mutex_own(&table->autoinc_mutex));
+
+#ifdef HAVE_IB_GCC_ATOMIC_BUILTINS
+	return(os_compare_and_swap(&table->autoinc, old_value, new_value));
+#else /* HAVE_IB_GCC_ATOMIC_BUILTINS */
+	/* Without atomics, dict_table_autoinc_compare_and_swap()
+	acquires the autoinc lock, and the counter cannot have moved. */
+	ut_a(table->autoinc == old_value);
+	table->autoinc = new_value;
+
+	return(TRUE);
+#endif /* HAVE_IB_GCC_ATOMIC_BUILTINS */
 }
 
 /********************************************************************//**
@@ -1809,8 +1924,8 @@ too_big:
 		checked for below. */
 		break;
 
-#if DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_MAX
-# error "DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_MAX"
+#if DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_TABLE_MAX
+# error "DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_TABLE_MAX"
 #endif
 	}
 
@@ -1868,6 +1983,8 @@ undo_size_ok:
 	new_index->table = table;
 	new_index->table_name = table->name;
 
+	dict_index_build_fixed_offs(new_index);
+
 	new_index->search_info = btr_search_info_create(new_index->heap);
 
 	new_index->stat_index_size = 1;
@@ -2083,6 +2200,76 @@ dict_index_add_col(
 	}
 }
 
+/*******************************************************************//**
+Computes the offsets of the leading NOT NULL fixed-length fields of an
+index in ROW_FORMAT=COMPACT or newer, which are the same in every record,
+and sets index->n_fixed_prefix, index->n_norm_prefix and
+index->fixed_offs. */
+UNIV_INTERN
+void
+dict_index_build_fixed_offs(
+/*========================*/
+	dict_index_t*		index)		/*!< in/out: index whose
+						fields are all defined */
+{
+	ulint*	offs;
+	ulint	end	= 0;
+	ulint	n;
+	ulint	i;
+
+	index->n_fixed_prefix = 0;
+	index->n_norm_prefix = 0;
+	index->fixed_offs = NULL;
+
+	if (!dict_table_is_comp(index->table)) {
+		/* The field end offsets of a ROW_FORMAT=REDUNDANT
+		record are stored in the record itself. */
+		return;
+	}
+
+	for (n = 0; n < index->n_fields; n++) {
+		const dict_field_t*	field
+			= dict_index_get_nth_field(index, n);
+
+		if (!field->fixed_len
+		    || !(dict_field_get_col(field)->prtype & DATA_NOT_NULL)) {
+			break;
+		}
+	}
+
+	if (n == 0) {
+		return;
+	}
+
+	offs = mem_heap_alloc(index->heap, n * sizeof *offs);
+
+	for (i = 0; i < n; i++) {
+		end += dict_index_get_nth_field(index, i)->fixed_len;
+		offs[i] = end;
+	}
+
+	index->fixed_offs = offs;
+	index->n_fixed_prefix = (unsigned) n;
+
+	/* cmp_dtuple_rec_with_match() compares these types byte by
+	byte without a collation, and the padding does not matter when
+	the lengths are equal. */
+	for (n = 0; n < index->n_fixed_prefix; n++) {
+		switch (dict_index_get_nth_col(index, n)->mtype) {
+		case DATA_FIXBINARY:
+		case DATA_BINARY:
+		case DATA_INT:
+		case DATA_SYS_CHILD:
+		case DATA_SYS:
+			continue;
+		}
+
+		break;
+	}
+
+	index->n_norm_prefix = (unsigned) n;
+}
+
 #ifndef UNIV_HOTBACKUP
 /*******************************************************************//**
 Copies fields contained in index2 to index1. */
@@ -2138,6 +2325,91 @@ dict_index_copy_types(
 	}
 }
 
+/********************************************************************//**
+Determine the flags of the single-table tablespace of a table: the table
+flags, and for ROW_FORMAT=COMPRESSED the page compression codec and level.
+@return	tablespace flags (FSP_SPACE_FLAGS) */
+UNIV_INTERN
+ulint
+dict_table_get_space_flags(
+/*=======================*/
+	const dict_table_t*	table)	/*!< in: table */
+{
+	ulint	flags = table->flags & ~(~0U << DICT_TF_BITS);
+
+	/* The tablespace flags are 0 for ROW_FORMAT=COMPACT and
+	ROW_FORMAT=REDUNDANT. */
+	if (flags == DICT_TF_COMPACT) {
+		return(0);
+	}
+
+	if (dict_table_zip_size(table)) {
+		flags |= table->zip_codec << FSP_FLAGS_POS_ZIP_CODEC
+			| table->zip_level << FSP_FLAGS_POS_ZIP_LEVEL;
+	}
+
+	return(flags);
+}
+
+/********************************************************************//**
+Determine the file format that the system tablespace must be tagged
+with before the tablespace of a table is written.  This is the format
+of the table, or DICT_TF_FORMAT_CODEC if the table is compressed with
+a codec or level other than the default or has a column declared
+COLUMN_FORMAT COMPRESSED.
+@return	file format id */
+UNIV_INTERN
+ulint
+dict_table_get_format_tag(
+/*======================*/
+	const dict_table_t*	table)	/*!< in: table */
+{
+	ulint	i;
+
+	if (dict_table_zip_size(table)
+	    && (table->zip_codec != PAGE_ZIP_CODEC_ZLIB
+		|| table->zip_level)) {
+		/* Older servers would refuse the tablespace flags. */
+		return(DICT_TF_FORMAT_CODEC);
+	}
+
+	for (i = 0; i < table->n_def; i++) {
+		if (dict_table_get_nth_col(table, i)->prtype
+		    & DATA_COMPRESSED) {
+			/* Older servers would not inflate the
+			externally stored part of the column. */
+			return(DICT_TF_FORMAT_CODEC);
+		}
+	}
+
+	return(dict_table_get_format(table));
+}
+
+/********************************************************************//**
+Set the page compression codec and level of a table from the flags of
+its tablespace. */
+UNIV_INTERN
+void
+dict_table_set_zip_compression(
+/*===========================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ulint		space_flags)	/*!< in: tablespace flags,
+					or ULINT_UNDEFINED */
+{
+	if (space_flags == ULINT_UNDEFINED
+	    || !dict_table_zip_size(table)
+	    || FSP_FLAGS_GET_ZIP_CODEC(space_flags) >= PAGE_ZIP_N_CODECS) {
+		/* Compress with the defaults. The pages can be
+		decompressed whatever codec they were written with. */
+		table->zip_codec = PAGE_ZIP_CODEC_ZLIB;
+		table->zip_level = 0;
+		return;
+	}
+
+	table->zip_codec = FSP_FLAGS_GET_ZIP_CODEC(space_flags);
+	table->zip_level = FSP_FLAGS_GET_ZIP_LEVEL(space_flags);
+}
+
 /*******************************************************************//**
 Copies types of columns contained in table to tuple and sets all
 fields of the tuple to the SQL NULL value.  This function should
@@ -4554,9 +4826,135 @@ dict_index_calc_min_rec_len(
 	return(sum);
 }
 
+/*********************************************************************//**
+Calculates new estimates for the statistics of a single index. If the
+index tree cannot be accessed because of a high innodb_force_recovery
+setting, or the tree is corrupt, bogus statistics are returned so that
+the index can still be used by the optimizer. */
+UNIV_INTERN
+void
+dict_index_calc_statistics(
+/*=======================*/
+	dict_index_t*	index,		/*!< in: index */
+	ulint		n_sample_pages,	/*!< in: number of leaf pages to
+					sample, or ULINT_UNDEFINED to count
+					the values exactly */
+	ulint*		index_size,	/*!< out: number of pages in the
+					index */
+	ulint*		n_leaf_pages,	/*!< out: number of leaf pages in
+					the index */
+	ib_int64_t*	n_diff_key_vals,/*!< out: number of different
+					values for each n-column prefix,
+					n_unique + 1 elements */
+	ib_int64_t*	n_non_null_key_vals)
+					/*!< out: number of non-null values
+					for each n-column prefix, n_unique + 1
+					elements */
+{
+	ulint	i;
+
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+	if (ibuf_debug && !dict_index_is_clust(index)) {
+		goto fake_statistics;
+	}
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+
+	if (UNIV_LIKELY
+	    (srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE
+	     || (srv_force_recovery < SRV_FORCE_NO_LOG_REDO
+		 && dict_index_is_clust(index)))) {
+		mtr_t	mtr;
+		ulint	size;
+
+		mtr_start(&mtr);
+		mtr_sx_lock(dict_index_get_lock(index), &mtr);
+
+		size = btr_get_size(index, BTR_TOTAL_SIZE, &mtr);
+
+		if (size != ULINT_UNDEFINED) {
+			*index_size = size;
+			size = btr_get_size(index, BTR_N_LEAF_PAGES, &mtr);
+		}
+
+		mtr_commit(&mtr);
+
+		switch (size) {
+		case ULINT_UNDEFINED:
+			goto fake_statistics;
+		case 0:
+			/* The root node of the tree is a leaf */
+			size = 1;
+		}
+
+		*n_leaf_pages = size;
+
+		btr_estimate_number_of_different_key_vals(
+			index, n_sample_pages, *index_size, *n_leaf_pages,
+			n_diff_key_vals, n_non_null_key_vals);
+
+		return;
+	}
+
+	/* If we have set a high innodb_force_recovery level, do not
+	calculate statistics, as a badly corrupted index can cause a
+	crash in it. Initialize some bogus index cardinality
+	statistics, so that the data can be queried in various means,
+	also via secondary indexes. */
+
+fake_statistics:
+	*index_size = *n_leaf_pages = 1;
+
+	for (i = dict_index_get_n_unique(index); i; ) {
+		n_diff_key_vals[i--] = 1;
+	}
+
+	memset(n_non_null_key_vals, 0,
+	       (1 + dict_index_get_n_unique(index))
+	       * sizeof(*n_non_null_key_vals));
+}
+
+/*********************************************************************//**
+Sums up the table level statistics from the statistics of the indexes of
+the table. The caller must hold the statistics latch in X mode. */
+UNIV_INTERN
+void
+dict_table_sum_index_statistics(
+/*============================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	dict_index_t*	index;
+	ulint		sum_of_index_sizes	= 0;
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (index->name[0] != TEMP_INDEX_PREFIX) {
+			sum_of_index_sizes += index->stat_index_size;
+		}
+	}
+
+	index = dict_table_get_first_index(table);
+
+	table->stat_n_rows = index->stat_n_diff_key_vals[
+		dict_index_get_n_unique(index)];
+
+	table->stat_clustered_index_size = index->stat_index_size;
+
+	table->stat_sum_of_other_index_sizes = sum_of_index_sizes
+		- index->stat_index_size;
+
+	table->stat_initialized = TRUE;
+
+	table->stat_modified_counter = 0;
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. The statistics
-are used in query optimization. */
+are used in query optimization. If innodb_stats_persistent is enabled,
+the statistics are loaded from SYS_STATS when they are first needed, and
+recalculations caused by row changes are left to the background
+statistics thread instead of being done here. */
 UNIV_INTERN
 void
 dict_update_statistics(
@@ -4572,7 +4970,8 @@ dict_update_statistics(
 					last stats update/recalc */
 {
 	dict_index_t*	index;
-	ulint		sum_of_index_sizes	= 0;
+	ibool		persistent;
+	ulint		n_sample_pages;
 
 	DBUG_EXECUTE_IF("skip_innodb_statistics", return;);
 
@@ -4599,6 +4998,27 @@ dict_update_statistics(
 		return;
 	}
 
+	persistent = dict_stats_is_persistent_enabled(table);
+
+	if (persistent && only_calc_if_changed_too_much) {
+		/* Do not make the user thread pay for the
+		recalculation; the background thread will pick
+		the table up. */
+
+		if (DICT_TABLE_CHANGED_TOO_MUCH(table)) {
+			dict_stats_enqueue(table);
+		}
+
+		return;
+	}
+
+	if (persistent && only_calc_if_missing_stats
+	    && !table->stat_initialized
+	    && dict_stats_fetch(table)) {
+
+		return;
+	}
+
 	dict_table_stats_lock(table, RW_X_LATCH);
 
 	if ((only_calc_if_missing_stats && table->stat_initialized)
@@ -4609,6 +5029,9 @@ dict_update_statistics(
 		return;
 	}
 
+	n_sample_pages = srv_stats_sample_pages < ULINT_UNDEFINED
+		? (ulint) srv_stats_sample_pages : ULINT_UNDEFINED - 1;
+
 	for (; index != NULL; index = dict_table_get_next_index(index)) {
 
 		/* Skip incomplete indexes. */
@@ -4616,82 +5039,26 @@ dict_update_statistics(
 			continue;
 		}
 
-#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
-		if (ibuf_debug && !dict_index_is_clust(index)) {
-			goto fake_statistics;
-		}
-#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
-
-		if (UNIV_LIKELY
-		    (srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE
-		     || (srv_force_recovery < SRV_FORCE_NO_LOG_REDO
-			 && dict_index_is_clust(index)))) {
-			mtr_t	mtr;
-			ulint	size;
-
-			mtr_start(&mtr);
-			mtr_s_lock(dict_index_get_lock(index), &mtr);
-
-			size = btr_get_size(index, BTR_TOTAL_SIZE, &mtr);
-
-			if (size != ULINT_UNDEFINED) {
-				sum_of_index_sizes += size;
-				index->stat_index_size = size;
-				size = btr_get_size(
-					index, BTR_N_LEAF_PAGES, &mtr);
-			}
-
-			mtr_commit(&mtr);
-
-			switch (size) {
-			case ULINT_UNDEFINED:
-				goto fake_statistics;
-			case 0:
-				/* The root node of the tree is a leaf */
-				size = 1;
-			}
-
-			index->stat_n_leaf_pages = size;
-
-			btr_estimate_number_of_different_key_vals(index);
-		} else {
-			/* If we have set a high innodb_force_recovery
-			level, do not calculate statistics, as a badly
-			corrupted index can cause a crash in it.
-			Initialize some bogus index cardinality
-			statistics, so that the data can be queried in
-			various means, also via secondary indexes. */
-			ulint	i;
-
-fake_statistics:
-			sum_of_index_sizes++;
-			index->stat_index_size = index->stat_n_leaf_pages = 1;
-
-			for (i = dict_index_get_n_unique(index); i; ) {
-				index->stat_n_diff_key_vals[i--] = 1;
-			}
-
-			memset(index->stat_n_non_null_key_vals, 0,
-			       (1 + dict_index_get_n_unique(index))
-                               * sizeof(*index->stat_n_non_null_key_vals));
-		}
+		dict_index_calc_statistics(
+			index, n_sample_pages,
+			&index->stat_index_size, &index->stat_n_leaf_pages,
+			index->stat_n_diff_key_vals,
+			index->stat_n_non_null_key_vals);
 	}
 
-	index = dict_table_get_first_index(table);
-
-	table->stat_n_rows = index->stat_n_diff_key_vals[
-		dict_index_get_n_unique(index)];
-
-	table->stat_clustered_index_size = index->stat_index_size;
+	dict_table_sum_index_statistics(table);
 
-	table->stat_sum_of_other_index_sizes = sum_of_index_sizes
-		- index->stat_index_size;
+	table->stat_persistent = FALSE;
 
-	table->stat_initialized = TRUE;
+	dict_table_stats_unlock(table, RW_X_LATCH);
 
-	table->stat_modified_counter = 0;
+	if (persistent) {
+		/* These were calculated from the small transient
+		sample; have the background thread replace them with
+		a bigger sample and store that in SYS_STATS. */
 
-	dict_table_stats_unlock(table, RW_X_LATCH);
+		dict_stats_enqueue(table);
+	}
 }
 
 #ifndef UNIV_HOTBACKUP
@@ -630,8 +630,8 @@ dict_sys_tables_get_flags(
 		return(ULINT_UNDEFINED);
 
 	case DICT_TF_FORMAT_ZIP << DICT_TF_FORMAT_SHIFT | DICT_TF_COMPACT:
-#if DICT_TF_FORMAT_MAX > DICT_TF_FORMAT_ZIP
-# error "missing case labels for DICT_TF_FORMAT_ZIP .. DICT_TF_FORMAT_MAX"
+#if DICT_TF_FORMAT_TABLE_MAX > DICT_TF_FORMAT_ZIP
+# error "missing case labels for DICT_TF_FORMAT_ZIP .. DICT_TF_FORMAT_TABLE_MAX"
 #endif
 		/* We support this format. */
 		break;
@@ -1848,6 +1848,13 @@ err_exit:
 		}
 	}
 
+	if (dict_table_zip_size(table) && !table->ibd_file_missing) {
+		/* The page compression codec is only stored
+		in the tablespace flags. */
+		dict_table_set_zip_compression(
+			table, fil_space_get_flags(table->space));
+	}
+
 	btr_pcur_close(&pcur);
 	mtr_commit(&mtr);
 
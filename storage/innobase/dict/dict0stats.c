@@ -0,0 +1,1042 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file dict/dict0stats.c
+Persistent index statistics
+*******************************************************/
+
+#include "dict0stats.h"
+
+#ifndef UNIV_HOTBACKUP
+
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "dict0load.h"
+#include "mach0data.h"
+#include "pars0pars.h"
+#include "que0que.h"
+#include "rem0rec.h"
+#include "row0mysql.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "sync0sync.h"
+#include "trx0roll.h"
+#include "trx0trx.h"
+
+/** Number of tables that can wait for the background statistics thread;
+further requests are dropped until the queue drains */
+#define DICT_STATS_QUEUE_SIZE		1024
+
+/** How often the background statistics thread wakes up on its own,
+in microseconds */
+#define DICT_STATS_WAKEUP_INTERVAL	10000000
+
+/** How long DDL sleeps before checking again whether the background
+statistics thread has stopped sampling a table, in microseconds */
+#define DICT_STATS_BG_YIELD_USEC	250000
+
+/** Number of columns in SYS_STATS, excluding the system columns */
+#define DICT_STATS_SYS_N_COLS		4
+
+/** Field numbers of the SYS_STATS clustered index records */
+/* @{ */
+#define DICT_STATS_FLD_INDEX_ID		0
+#define DICT_STATS_FLD_KEY_COLS		1
+#define DICT_STATS_FLD_DIFF_VALS	4
+#define DICT_STATS_FLD_NON_NULL_VALS	5
+/* @} */
+
+/** The SYS_STATS table, or NULL if innodb_stats_persistent has never
+been enabled. It is opened at startup or when the variable is first
+enabled, and its open handle count is never decremented, so that it stays
+in the dictionary cache. */
+static dict_table_t*	dict_stats_sys_table	= NULL;
+
+/** Circular queue of ids of the tables waiting for the background
+statistics thread */
+static table_id_t	dict_stats_queue[DICT_STATS_QUEUE_SIZE];
+
+/** Position of the first entry in dict_stats_queue */
+static ulint		dict_stats_queue_first	= 0;
+
+/** Number of entries in dict_stats_queue */
+static ulint		dict_stats_queue_len	= 0;
+
+/** Mutex protecting dict_stats_queue and dict_table_t::stat_bg_queued */
+static mutex_t		dict_stats_queue_mutex;
+
+#ifdef UNIV_PFS_MUTEX
+UNIV_INTERN mysql_pfs_key_t	dict_stats_queue_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
+/** TRUE while the background statistics thread is running */
+UNIV_INTERN ibool	dict_stats_thread_active	= FALSE;
+
+/** Event to wake up the background statistics thread */
+UNIV_INTERN os_event_t	dict_stats_event		= NULL;
+
+/** Statistics of one index, calculated or loaded before they are
+published in the dictionary cache */
+typedef struct dict_stats_index_struct {
+	ulint		index_size;	/*!< dict_index_t::stat_index_size */
+	ulint		n_leaf_pages;	/*!< dict_index_t::stat_n_leaf_pages */
+	ib_int64_t*	n_diff_key_vals;/*!< dict_index_t::
+					stat_n_diff_key_vals[] */
+	ib_int64_t*	n_non_null_key_vals;
+					/*!< dict_index_t::
+					stat_n_non_null_key_vals[] */
+} dict_stats_index_t;
+
+/*********************************************************************//**
+Initializes the background statistics queue. */
+UNIV_INTERN
+void
+dict_stats_init(void)
+/*=================*/
+{
+	mutex_create(dict_stats_queue_mutex_key,
+		     &dict_stats_queue_mutex, SYNC_ANY_LATCH);
+
+	dict_stats_event = os_event_create(NULL);
+}
+
+/*********************************************************************//**
+Frees the background statistics queue at shutdown. */
+UNIV_INTERN
+void
+dict_stats_close(void)
+/*==================*/
+{
+	mutex_free(&dict_stats_queue_mutex);
+
+	os_event_free(dict_stats_event);
+	dict_stats_event = NULL;
+
+	dict_stats_sys_table = NULL;
+}
+
+/*********************************************************************//**
+Opens the SYS_STATS system table, creating it first if it does not exist
+yet and create is TRUE, and keeps it open for the lifetime of the server.
+It is created when innodb_stats_persistent is first enabled.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_create_or_check_sys_table(
+/*=================================*/
+	ibool	create)	/*!< in: TRUE if a missing table is to be
+			created; FALSE to only open an existing one */
+{
+	dict_table_t*	table;
+	ulint		error;
+	trx_t*		trx;
+
+	mutex_enter(&(dict_sys->mutex));
+
+	if (dict_stats_sys_table != NULL) {
+		mutex_exit(&(dict_sys->mutex));
+
+		return(DB_SUCCESS);
+	}
+
+	table = dict_table_get_low("SYS_STATS", DICT_ERR_IGNORE_NONE);
+
+	if (table
+	    && UT_LIST_GET_LEN(table->indexes) == 1
+	    && table->n_cols == DICT_STATS_SYS_N_COLS + DATA_N_SYS_COLS) {
+
+		/* The statistics table has already been created,
+		and it is ok */
+
+		goto func_exit;
+	}
+
+	mutex_exit(&(dict_sys->mutex));
+
+	if (!create) {
+		/* Without the table there are no rows to keep in step
+		with dropped indexes. */
+
+		return(DB_SUCCESS);
+	}
+
+	trx = trx_allocate_for_mysql();
+
+	trx->op_info = "creating statistics sys table";
+
+	row_mysql_lock_data_dictionary(trx);
+
+	if (table) {
+		fprintf(stderr,
+			"InnoDB: dropping incompletely created"
+			" SYS_STATS table\n");
+		row_drop_table_for_mysql("SYS_STATS", trx, TRUE);
+	}
+
+	fprintf(stderr, "InnoDB: Creating index statistics system table\n");
+
+	/* NOTE: dict_stats_fetch_index() relies on the field numbers of
+	the clustered index records of this table, see DICT_STATS_FLD_* */
+
+	error = que_eval_sql(NULL,
+			     "PROCEDURE CREATE_STATS_SYS_TABLE_PROC () IS\n"
+			     "BEGIN\n"
+			     "CREATE TABLE\n"
+			     "SYS_STATS(INDEX_ID BINARY(8), KEY_COLS INT,"
+			     " DIFF_VALS BINARY(8),"
+			     " NON_NULL_VALS BINARY(8));\n"
+			     "CREATE UNIQUE CLUSTERED INDEX ID_IND"
+			     " ON SYS_STATS (INDEX_ID, KEY_COLS);\n"
+			     "END;\n"
+			     , FALSE, trx);
+
+	if (error != DB_SUCCESS) {
+		fprintf(stderr, "InnoDB: error %lu in creation\n",
+			(ulong) error);
+
+		ut_a(error == DB_OUT_OF_FILE_SPACE
+		     || error == DB_TOO_MANY_CONCURRENT_TRXS);
+
+		fprintf(stderr,
+			"InnoDB: creation failed\n"
+			"InnoDB: tablespace is full\n"
+			"InnoDB: dropping incompletely created"
+			" SYS_STATS table\n");
+
+		row_drop_table_for_mysql("SYS_STATS", trx, TRUE);
+
+		error = DB_MUST_GET_MORE_FILE_SPACE;
+	}
+
+	trx_commit_for_mysql(trx);
+
+	row_mysql_unlock_data_dictionary(trx);
+
+	trx_free_for_mysql(trx);
+
+	if (error != DB_SUCCESS) {
+
+		return(error);
+	}
+
+	fprintf(stderr, "InnoDB: Index statistics system table created\n");
+
+	mutex_enter(&(dict_sys->mutex));
+
+	table = dict_table_get_low("SYS_STATS", DICT_ERR_IGNORE_NONE);
+
+	ut_a(table != NULL);
+
+func_exit:
+	ut_a(!dict_table_is_comp(table));
+
+	table->n_mysql_handles_opened++;
+
+	dict_stats_sys_table = table;
+
+	mutex_exit(&(dict_sys->mutex));
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Checks whether the statistics of a table are to be kept in SYS_STATS.
+@return	TRUE if innodb_stats_persistent applies to the table */
+UNIV_INTERN
+ibool
+dict_stats_is_persistent_enabled(
+/*=============================*/
+	const dict_table_t*	table)	/*!< in: table */
+{
+	/* The InnoDB internal tables have no database name. Temporary
+	tables are created and dropped too often to be worth it. */
+
+	return(srv_stats_persistent
+	       && dict_stats_sys_table != NULL
+	       && srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE
+	       && strchr(table->name, '/') != NULL
+	       && !((table->flags >> DICT_TF2_SHIFT) & DICT_TF2_TEMPORARY)
+	       && strstr(table->name, TEMP_TABLE_PATH_PREFIX) == NULL);
+}
+
+/*********************************************************************//**
+Allocates private buffers for the statistics of all indexes of a table.
+Indexes that are being created are appended to table->indexes, so when
+the dictionary is not locked, the callers must not look past the first
+*n_stats indexes.
+@return	array with one element per index, in the order of table->indexes */
+static
+dict_stats_index_t*
+dict_stats_alloc(
+/*=============*/
+	const dict_table_t*	table,	/*!< in: table */
+	mem_heap_t*		heap,	/*!< in: memory heap */
+	ulint*			n_stats)/*!< out: number of elements */
+{
+	const dict_index_t*	index;
+	dict_stats_index_t*	stats;
+	ulint			i;
+
+	*n_stats = UT_LIST_GET_LEN(table->indexes);
+
+	stats = mem_heap_zalloc(heap, *n_stats * sizeof *stats);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && i < *n_stats;
+	     index = dict_table_get_next_index(index), i++) {
+
+		ulint	n_uniq = dict_index_get_n_unique(index);
+
+		stats[i].n_diff_key_vals = mem_heap_zalloc(
+			heap, (n_uniq + 1) * sizeof(ib_int64_t));
+		stats[i].n_non_null_key_vals = mem_heap_zalloc(
+			heap, (n_uniq + 1) * sizeof(ib_int64_t));
+	}
+
+	return(stats);
+}
+
+/*********************************************************************//**
+Copies the statistics from private buffers to the dictionary cache. The
+caller must hold the statistics latch of the table in X mode. */
+static
+void
+dict_stats_publish(
+/*===============*/
+	dict_table_t*			table,	/*!< in/out: table */
+	const dict_stats_index_t*	stats,	/*!< in: statistics from
+						dict_stats_alloc() */
+	ulint				n_stats)/*!< in: number of
+						elements in stats */
+{
+	dict_index_t*	index;
+	ulint		i;
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && i < n_stats;
+	     index = dict_table_get_next_index(index), i++) {
+
+		ulint	n_uniq = dict_index_get_n_unique(index);
+
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		index->stat_index_size = stats[i].index_size;
+		index->stat_n_leaf_pages = stats[i].n_leaf_pages;
+
+		memcpy(index->stat_n_diff_key_vals,
+		       stats[i].n_diff_key_vals,
+		       (n_uniq + 1) * sizeof(ib_int64_t));
+		memcpy(index->stat_n_non_null_key_vals,
+		       stats[i].n_non_null_key_vals,
+		       (n_uniq + 1) * sizeof(ib_int64_t));
+	}
+
+	dict_table_sum_index_statistics(table);
+
+	table->stat_persistent = TRUE;
+}
+
+/*********************************************************************//**
+Reads the SYS_STATS rows of an index.
+@return	TRUE if a row was found for every n-column prefix of the index */
+static
+ibool
+dict_stats_fetch_index(
+/*===================*/
+	const dict_index_t*	index,	/*!< in: index */
+	dict_stats_index_t*	stats,	/*!< out: statistics */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	dict_index_t*	sys_index;
+	btr_pcur_t	pcur;
+	dtuple_t*	tuple;
+	dfield_t*	dfield;
+	byte*		id_buf;
+	const rec_t*	rec;
+	const byte*	field;
+	ulint		len;
+	ulint		n_uniq;
+	ulint		n_found	= 0;
+	mtr_t		mtr;
+
+	n_uniq = dict_index_get_n_unique(index);
+
+	sys_index = UT_LIST_GET_FIRST(dict_stats_sys_table->indexes);
+
+	id_buf = mem_heap_alloc(heap, 8);
+	mach_write_to_8(id_buf, index->id);
+
+	tuple = dtuple_create(heap, 1);
+	dfield = dtuple_get_nth_field(tuple, 0);
+
+	dfield_set_data(dfield, id_buf, 8);
+	dict_index_copy_types(tuple, sys_index, 1);
+
+	mtr_start(&mtr);
+
+	btr_pcur_open_on_user_rec(sys_index, tuple, PAGE_CUR_GE,
+				  BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	for (; btr_pcur_is_on_user_rec(&pcur);
+	     btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+		ulint	key_cols;
+
+		rec = btr_pcur_get_rec(&pcur);
+
+		field = rec_get_nth_field_old(
+			rec, DICT_STATS_FLD_INDEX_ID, &len);
+
+		if (len != 8 || ut_memcmp(field, id_buf, 8) != 0) {
+			break;
+		}
+
+		if (rec_get_deleted_flag(rec, 0)) {
+			continue;
+		}
+
+		field = rec_get_nth_field_old(
+			rec, DICT_STATS_FLD_KEY_COLS, &len);
+		ut_a(len == 4);
+
+		key_cols = mach_read_from_4(field);
+
+		if (key_cols == 0 || key_cols > n_uniq) {
+			/* The index definition does not match; ignore
+			the row, it will be overwritten by the next
+			recalculation. */
+			continue;
+		}
+
+		field = rec_get_nth_field_old(
+			rec, DICT_STATS_FLD_DIFF_VALS, &len);
+		ut_a(len == 8);
+
+		stats->n_diff_key_vals[key_cols] = mach_read_from_8(field);
+
+		field = rec_get_nth_field_old(
+			rec, DICT_STATS_FLD_NON_NULL_VALS, &len);
+		ut_a(len == 8);
+
+		stats->n_non_null_key_vals[key_cols - 1]
+			= mach_read_from_8(field);
+
+		n_found++;
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	return(n_found == n_uniq);
+}
+
+/*********************************************************************//**
+Loads the statistics of a table from SYS_STATS into the dictionary cache.
+Only the index sizes are read from the tablespace; no leaf pages are
+sampled.
+@return	TRUE if statistics for all indexes were found */
+UNIV_INTERN
+ibool
+dict_stats_fetch(
+/*=============*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	dict_index_t*		index;
+	dict_stats_index_t*	stats;
+	mem_heap_t*		heap;
+	ulint			i;
+	ulint			n_stats;
+	ibool			found	= TRUE;
+
+	ut_ad(dict_stats_is_persistent_enabled(table));
+
+	heap = mem_heap_create(1024);
+
+	stats = dict_stats_alloc(table, heap, &n_stats);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && i < n_stats && found;
+	     index = dict_table_get_next_index(index), i++) {
+
+		mtr_t	mtr;
+
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		found = dict_stats_fetch_index(index, &stats[i], heap);
+
+		if (!found) {
+			break;
+		}
+
+		/* The sizes are not stored, because they can be read
+		cheaply from the segment headers. */
+
+		mtr_start(&mtr);
+		mtr_sx_lock(dict_index_get_lock(index), &mtr);
+
+		stats[i].index_size = btr_get_size(
+			index, BTR_TOTAL_SIZE, &mtr);
+
+		if (stats[i].index_size != ULINT_UNDEFINED) {
+			stats[i].n_leaf_pages = btr_get_size(
+				index, BTR_N_LEAF_PAGES, &mtr);
+		}
+
+		mtr_commit(&mtr);
+
+		switch (stats[i].n_leaf_pages) {
+		case ULINT_UNDEFINED:
+			found = FALSE;
+			break;
+		case 0:
+			/* The root node of the tree is a leaf */
+			stats[i].n_leaf_pages = 1;
+		}
+
+		if (stats[i].index_size == ULINT_UNDEFINED) {
+			found = FALSE;
+		}
+	}
+
+	if (found) {
+		dict_table_stats_lock(table, RW_X_LATCH);
+
+		/* Another thread may have initialized the statistics
+		while we were reading them. */
+
+		if (!table->stat_initialized) {
+			dict_stats_publish(table, stats, n_stats);
+		}
+
+		dict_table_stats_unlock(table, RW_X_LATCH);
+	}
+
+	mem_heap_free(heap);
+
+	return(found);
+}
+
+/*********************************************************************//**
+Recalculates the statistics of a table into a private buffer and then
+publishes them in the dictionary cache. The statistics latch is held only
+while publishing, so queries that read the statistics are not blocked for
+the duration of the calculation. */
+UNIV_INTERN
+void
+dict_stats_recalc(
+/*==============*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ulint		n_sample_pages)	/*!< in: number of leaf pages to
+					sample per index, or ULINT_UNDEFINED
+					to count the values exactly */
+{
+	dict_index_t*		index;
+	dict_stats_index_t*	stats;
+	mem_heap_t*		heap;
+	ulint			i;
+	ulint			n_stats;
+
+	if (table->ibd_file_missing
+	    || dict_table_get_first_index(table) == NULL) {
+
+		/* Let dict_update_statistics() print the error */
+		dict_update_statistics(table, FALSE, FALSE);
+		return;
+	}
+
+	heap = mem_heap_create(1024);
+
+	stats = dict_stats_alloc(table, heap, &n_stats);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && i < n_stats;
+	     index = dict_table_get_next_index(index), i++) {
+
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		dict_index_calc_statistics(
+			index, n_sample_pages,
+			&stats[i].index_size, &stats[i].n_leaf_pages,
+			stats[i].n_diff_key_vals,
+			stats[i].n_non_null_key_vals);
+	}
+
+	dict_table_stats_lock(table, RW_X_LATCH);
+
+	/* Do not replace an exact count that ANALYZE TABLE published
+	while we were sampling. */
+
+	if (n_sample_pages == ULINT_UNDEFINED
+	    || !table->stat_persistent
+	    || DICT_TABLE_CHANGED_TOO_MUCH(table)) {
+
+		dict_stats_publish(table, stats, n_stats);
+	}
+
+	dict_table_stats_unlock(table, RW_X_LATCH);
+
+	mem_heap_free(heap);
+}
+
+/*********************************************************************//**
+Adds a table to the queue of the background statistics thread, unless it
+is already there. If the queue is full the request is dropped; the table
+will be queued again by the next change. */
+UNIV_INTERN
+void
+dict_stats_enqueue(
+/*===============*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	/* Dirty read: this is called for every row change of a table
+	that has changed too much, until the thread has processed it. */
+	if (table->stat_bg_queued) {
+
+		return;
+	}
+
+	mutex_enter(&dict_stats_queue_mutex);
+
+	if (!table->stat_bg_queued
+	    && dict_stats_queue_len < DICT_STATS_QUEUE_SIZE) {
+
+		dict_stats_queue[(dict_stats_queue_first
+				  + dict_stats_queue_len)
+				 % DICT_STATS_QUEUE_SIZE] = table->id;
+
+		dict_stats_queue_len++;
+
+		table->stat_bg_queued = TRUE;
+	}
+
+	mutex_exit(&dict_stats_queue_mutex);
+
+	os_event_set(dict_stats_event);
+}
+
+/*********************************************************************//**
+Removes the first table id from the queue of the background statistics
+thread.
+@return	TRUE if a table id was returned, FALSE if the queue is empty */
+static
+ibool
+dict_stats_dequeue(
+/*===============*/
+	table_id_t*	table_id)	/*!< out: table id */
+{
+	ibool	ret = FALSE;
+
+	mutex_enter(&dict_stats_queue_mutex);
+
+	if (dict_stats_queue_len > 0) {
+		*table_id = dict_stats_queue[dict_stats_queue_first];
+
+		dict_stats_queue_first = (dict_stats_queue_first + 1)
+			% DICT_STATS_QUEUE_SIZE;
+		dict_stats_queue_len--;
+
+		ret = TRUE;
+	}
+
+	mutex_exit(&dict_stats_queue_mutex);
+
+	return(ret);
+}
+
+/*********************************************************************//**
+Executes a statement on SYS_STATS.
+@return	DB_SUCCESS or error code */
+static
+ulint
+dict_stats_eval_sql(
+/*================*/
+	pars_info_t*	info,	/*!< in: info struct */
+	const char*	sql,	/*!< in: SQL string to evaluate */
+	trx_t*		trx)	/*!< in/out: dictionary transaction */
+{
+	ulint	error;
+
+	error = que_eval_sql(info, sql, FALSE, trx);
+
+	if (error != DB_SUCCESS) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Error %lu while updating SYS_STATS\n",
+			(ulong) error);
+
+		/* The next call of que_eval_sql() requires a clean
+		error state; the caller rolls back. */
+		trx->error_state = DB_SUCCESS;
+	}
+
+	return(error);
+}
+
+/*********************************************************************//**
+Deletes the SYS_STATS rows of an index id.
+@return	DB_SUCCESS or error code */
+static
+ulint
+dict_stats_delete_index_rows(
+/*=========================*/
+	index_id_t	index_id,	/*!< in: index id */
+	trx_t*		trx)		/*!< in/out: dictionary transaction */
+{
+	pars_info_t*	info;
+
+	info = pars_info_create();
+
+	pars_info_add_ull_literal(info, "index_id", index_id);
+
+	return(dict_stats_eval_sql(
+		       info,
+		       "PROCEDURE DELETE_INDEX_STATS_PROC () IS\n"
+		       "BEGIN\n"
+		       "DELETE FROM SYS_STATS WHERE INDEX_ID = :index_id;\n"
+		       "END;\n", trx));
+}
+
+/*********************************************************************//**
+Deletes the SYS_STATS rows of an index that is being dropped. The caller
+must have locked the data dictionary in X mode.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_delete_index_stats(
+/*==========================*/
+	const dict_index_t*	index,	/*!< in: index */
+	trx_t*			trx)	/*!< in/out: dictionary transaction */
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	if (dict_stats_sys_table == NULL
+	    || index->table == dict_stats_sys_table
+	    || strchr(index->table->name, '/') == NULL) {
+
+		return(DB_SUCCESS);
+	}
+
+	return(dict_stats_delete_index_rows(index->id, trx));
+}
+
+/*********************************************************************//**
+Deletes the SYS_STATS rows of all indexes of a table that is being
+dropped or truncated. The caller must have locked the data dictionary
+in X mode.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_delete_table_stats(
+/*==========================*/
+	const dict_table_t*	table,	/*!< in: table */
+	trx_t*			trx)	/*!< in/out: dictionary transaction */
+{
+	const dict_index_t*	index;
+	ulint			error	= DB_SUCCESS;
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL && error == DB_SUCCESS;
+	     index = dict_table_get_next_index(index)) {
+
+		error = dict_stats_delete_index_stats(index, trx);
+	}
+
+	return(error);
+}
+
+/*********************************************************************//**
+Waits until the background statistics thread has stopped sampling a
+table, so that its indexes can be dropped or their trees freed. The
+caller must have locked the data dictionary in X mode; the latch is
+released while waiting. */
+UNIV_INTERN
+void
+dict_stats_wait_bg_to_stop_using_table(
+/*===================================*/
+	dict_table_t*	table,	/*!< in: table */
+	trx_t*		trx)	/*!< in/out: transaction that holds
+				the dictionary latch */
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	/* The flag is only set while dict_sys->mutex is held, so it
+	cannot be set again before we release the dictionary. */
+
+	while (table->stat_bg_in_progress) {
+		row_mysql_unlock_data_dictionary(trx);
+		os_thread_sleep(DICT_STATS_BG_YIELD_USEC);
+		row_mysql_lock_data_dictionary(trx);
+	}
+}
+
+/*********************************************************************//**
+Stores the statistics of a table from the dictionary cache in SYS_STATS.
+The caller must have locked the data dictionary in X mode, which also
+serializes the writers of SYS_STATS.
+@return	DB_SUCCESS or error code */
+static
+ulint
+dict_stats_save(
+/*============*/
+	dict_table_t*	table,	/*!< in: table */
+	trx_t*		trx)	/*!< in/out: dictionary transaction */
+{
+	dict_index_t*		index;
+	dict_stats_index_t*	stats;
+	mem_heap_t*		heap;
+	ulint			i;
+	ulint			j;
+	ulint			n_stats;
+	ulint			error	= DB_SUCCESS;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	heap = mem_heap_create(1024);
+
+	stats = dict_stats_alloc(table, heap, &n_stats);
+
+	/* The indexes cannot change while the dictionary is locked */
+	ut_ad(n_stats == UT_LIST_GET_LEN(table->indexes));
+
+	/* Copy the statistics, because we must not hold the statistics
+	latch while modifying SYS_STATS. */
+
+	dict_table_stats_lock(table, RW_S_LATCH);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		ulint	n_uniq = dict_index_get_n_unique(index);
+
+		memcpy(stats[i].n_diff_key_vals,
+		       index->stat_n_diff_key_vals,
+		       (n_uniq + 1) * sizeof(ib_int64_t));
+		memcpy(stats[i].n_non_null_key_vals,
+		       index->stat_n_non_null_key_vals,
+		       (n_uniq + 1) * sizeof(ib_int64_t));
+	}
+
+	dict_table_stats_unlock(table, RW_S_LATCH);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && error == DB_SUCCESS;
+	     index = dict_table_get_next_index(index), i++) {
+
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		error = dict_stats_delete_index_rows(index->id, trx);
+
+		for (j = 1;
+		     j <= dict_index_get_n_unique(index)
+		     && error == DB_SUCCESS;
+		     j++) {
+
+			pars_info_t*	info = pars_info_create();
+
+			pars_info_add_ull_literal(
+				info, "index_id", index->id);
+			pars_info_add_int4_literal(
+				info, "key_cols", (lint) j);
+			pars_info_add_ull_literal(
+				info, "diff_vals",
+				stats[i].n_diff_key_vals[j]);
+			pars_info_add_ull_literal(
+				info, "non_null_vals",
+				stats[i].n_non_null_key_vals[j - 1]);
+
+			error = dict_stats_eval_sql(
+				info,
+				"PROCEDURE INSERT_INDEX_STATS_PROC () IS\n"
+				"BEGIN\n"
+				"INSERT INTO SYS_STATS VALUES"
+				" (:index_id, :key_cols, :diff_vals,"
+				" :non_null_vals);\n"
+				"END;\n", trx);
+		}
+	}
+
+	mem_heap_free(heap);
+
+	return(error);
+}
+
+/*********************************************************************//**
+Recalculates the statistics of a queued table if they are stale or came
+from the transient sample, and stores them in SYS_STATS. */
+static
+void
+dict_stats_process_table(
+/*=====================*/
+	table_id_t	table_id,	/*!< in: id of the queued table */
+	ibool		only_save)	/*!< in: TRUE if the statistics are
+					to be stored only if they need no
+					recalculation */
+{
+	dict_table_t*	table;
+	trx_t*		trx;
+	ulint		error;
+	ibool		recalc	= FALSE;
+
+	trx = trx_allocate_for_background();
+
+	trx->op_info = "recalculating persistent statistics";
+
+	mutex_enter(&(dict_sys->mutex));
+
+	table = dict_table_get_on_id_low(table_id);
+
+	if (table == NULL) {
+		/* The table has been dropped */
+
+		mutex_exit(&(dict_sys->mutex));
+		goto func_exit;
+	}
+
+	mutex_enter(&dict_stats_queue_mutex);
+	table->stat_bg_queued = FALSE;
+	mutex_exit(&dict_stats_queue_mutex);
+
+	if (!dict_stats_is_persistent_enabled(table)
+	    || table->ibd_file_missing
+	    || (only_save && !table->stat_persistent)) {
+
+		mutex_exit(&(dict_sys->mutex));
+		goto func_exit;
+	}
+
+	if (!only_save
+	    && (!table->stat_persistent
+		|| DICT_TABLE_CHANGED_TOO_MUCH(table))) {
+
+		/* Sample the indexes without holding the dictionary
+		latch, so that DDL on other tables is not blocked for
+		the duration of the sampling. DDL that would free the
+		index trees of this table waits for the flag to be
+		cleared. */
+
+		table->stat_bg_in_progress = TRUE;
+		recalc = TRUE;
+	}
+
+	mutex_exit(&(dict_sys->mutex));
+
+	if (recalc) {
+		ulint	n_sample_pages = srv_stats_persistent_sample_pages;
+
+		/* ULINT_UNDEFINED would request an exact count, which
+		is reserved for ANALYZE TABLE */
+		if (n_sample_pages == ULINT_UNDEFINED) {
+			n_sample_pages--;
+		}
+
+		dict_stats_recalc(table, n_sample_pages);
+
+		mutex_enter(&(dict_sys->mutex));
+		table->stat_bg_in_progress = FALSE;
+		mutex_exit(&(dict_sys->mutex));
+	}
+
+	row_mysql_lock_data_dictionary(trx);
+
+	/* The table may have been dropped while we did not hold the
+	dictionary latch */
+
+	table = dict_table_get_on_id_low(table_id);
+
+	if (table != NULL) {
+		error = dict_stats_save(table, trx);
+
+		if (error == DB_SUCCESS) {
+			trx_commit_for_mysql(trx);
+		} else {
+			trx_general_rollback_for_mysql(trx, NULL);
+		}
+	}
+
+	row_mysql_unlock_data_dictionary(trx);
+
+func_exit:
+	trx_free_for_background(trx);
+}
+
+/*********************************************************************//**
+A thread which recalculates the statistics of queued tables with
+innodb_stats_persistent_sample_pages and stores them in SYS_STATS.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+dict_stats_thread(
+/*==============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	table_id_t	table_id;
+	ib_int64_t	sig_count;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(dict_stats_thread_key);
+#endif
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		sig_count = os_event_reset(dict_stats_event);
+
+		if (dict_stats_queue_len == 0) {
+			os_event_wait_time_low(dict_stats_event,
+					       DICT_STATS_WAKEUP_INTERVAL,
+					       sig_count);
+		}
+
+		while (srv_shutdown_state == SRV_SHUTDOWN_NONE
+		       && dict_stats_dequeue(&table_id)) {
+
+			dict_stats_process_table(table_id, FALSE);
+		}
+	}
+
+	/* Store what ANALYZE TABLE has calculated but we have not saved
+	yet, so that it is not lost. Tables that would need to be sampled
+	are skipped to keep the shutdown fast. */
+
+	while (dict_stats_dequeue(&table_id)) {
+
+		dict_stats_process_table(table_id, TRUE);
+	}
+
+	dict_stats_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+#endif /* !UNIV_HOTBACKUP */
@@ -102,7 +102,22 @@ file at the end of the LRU-list. When an i/o-operation is pending on a file,
 the file cannot be closed. We take the file nodes with pending i/o-operations
 out of the LRU-list and keep a count of pending operations. When an operation
 completes, we decrement the count and return the file node to the LRU-list if
-the count drops to zero. */
+the count drops to zero.
+
+The spaces are distributed to FIL_N_SHARDS shards by their id. Each
+shard has its own mutex, hash table of spaces, LRU list of open files
+and list of unflushed spaces. An i/o on an open file only needs the
+mutex of the shard of the space, and i/o's on spaces of different shards
+do not contend on any mutex in this module. The fil_system->mutex is
+needed for creating, deleting and renaming spaces, and for opening and
+closing files. The fields that the i/o path reads without the
+fil_system->mutex (the hash chain, the file chain and sizes, open,
+handle, name, flags, stop_ios, stop_new_ops) are modified only when
+holding both the fil_system->mutex and the shard mutex; the i/o
+bookkeeping (pending counts, modification and flush counters, the LRU
+and unflushed lists, the statistics) is protected by the shard mutex
+alone. The fil_system->mutex must be acquired before a shard mutex, and
+a thread may hold at most one shard mutex at a time. */
 
 /** When mysqld is run, the default directory "." is the mysqld datadir,
 but in the MySQL Embedded Server Library and ibbackup it is not the default
@@ -128,6 +143,8 @@ UNIV_INTERN fil_addr_t	fil_addr_null = {FIL_NULL, 0};
 #ifdef UNIV_PFS_MUTEX
 /* Key to register fil_system_mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	fil_system_mutex_key;
+/* Key to register the fil_shard_t mutexes with performance schema */
+UNIV_INTERN mysql_pfs_key_t	fil_shard_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
 #ifdef UNIV_PFS_RWLOCK
@@ -163,7 +180,8 @@ struct fil_node_struct {
 	UT_LIST_NODE_T(fil_node_t) chain;
 				/*!< link field for the file chain */
 	UT_LIST_NODE_T(fil_node_t) LRU;
-				/*!< link field for the LRU list */
+				/*!< link field for the LRU list of
+				the shard */
 	ulint		magic_n;/*!< FIL_NODE_MAGIC_N */
 };
 
@@ -223,15 +241,16 @@ struct fil_space_struct {
 				trying to read a block.
 				Dropping of the tablespace is forbidden
 				if this is positive */
-	hash_node_t	hash;	/*!< hash chain node */
+	hash_node_t	hash;	/*!< hash chain node in the shard */
 	hash_node_t	name_hash;/*!< hash chain the name_hash table */
 #ifndef UNIV_HOTBACKUP
 	rw_lock_t	latch;	/*!< latch protecting the file space storage
 				allocation */
 #endif /* !UNIV_HOTBACKUP */
 	UT_LIST_NODE_T(fil_space_t) unflushed_spaces;
-				/*!< list of spaces with at least one unflushed
-				file we have written to */
+				/*!< list of spaces of the shard with at
+				least one unflushed file we have written
+				to */
 	ibool		is_in_unflushed_spaces; /*!< TRUE if this space is
 				currently in unflushed_spaces */
 	UT_LIST_NODE_T(fil_space_t) space_list;
@@ -243,22 +262,23 @@ struct fil_space_struct {
 /** Value of fil_space_struct::magic_n */
 #define	FIL_SPACE_MAGIC_N	89472
 
-/** The tablespace memory cache */
-typedef	struct fil_system_struct	fil_system_t;
+/** Number of shards of the tablespace memory cache */
+#define FIL_N_SHARDS		64
 
-/** The tablespace memory cache; also the totality of logs (the log
-data space) is stored here; below we talk about tablespaces, but also
-the ib_logfiles form a 'space' and it is handled here */
+/** A shard of the tablespace memory cache: the spaces whose id modulo
+FIL_N_SHARDS is the same */
+typedef	struct fil_shard_struct		fil_shard_t;
 
-struct fil_system_struct {
+/** A shard of the tablespace memory cache */
+struct fil_shard_struct {
 #ifndef UNIV_HOTBACKUP
-	mutex_t		mutex;		/*!< The mutex protecting the cache */
+	mutex_t		mutex;		/*!< The mutex protecting the i/o
+					bookkeeping of the spaces of the
+					shard and their files */
 #endif /* !UNIV_HOTBACKUP */
-	hash_table_t*	spaces;		/*!< The hash table of spaces in the
-					system; they are hashed on the space
-					id */
-	hash_table_t*	name_hash;	/*!< hash table based on the space
-					name */
+	hash_table_t*	spaces;		/*!< The hash table of the spaces of
+					the shard; they are hashed on the
+					space id */
 	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
 					/*!< base node for the LRU list of the
 					most recently used open files with no
@@ -276,11 +296,34 @@ struct fil_system_struct {
 					unflushed writes; those spaces have
 					at least one file node where
 					modification_counter > flush_counter */
+	ib_int64_t	modification_counter;/*!< when we write to a file we
+					increment this by one */
+};
+
+/** The tablespace memory cache */
+typedef	struct fil_system_struct	fil_system_t;
+
+/** The tablespace memory cache; also the totality of logs (the log
+data space) is stored here; below we talk about tablespaces, but also
+the ib_logfiles form a 'space' and it is handled here */
+
+struct fil_system_struct {
+#ifndef UNIV_HOTBACKUP
+	mutex_t		mutex;		/*!< The mutex protecting the cache
+					against creating, deleting and
+					renaming spaces and opening and
+					closing files */
+#endif /* !UNIV_HOTBACKUP */
+	fil_shard_t	shards[FIL_N_SHARDS];
+					/*!< The shards of the cache */
+	ulint		LRU_shard;	/*!< the shard whose LRU list is
+					tried first when a file must be
+					closed */
+	hash_table_t*	name_hash;	/*!< hash table based on the space
+					name */
 	ulint		n_open;		/*!< number of files currently open */
 	ulint		max_n_open;	/*!< n_open is not allowed to exceed
 					this */
-	ib_int64_t	modification_counter;/*!< when we write to a file we
-					increment this by one */
 	ulint		max_assigned_id;/*!< maximum space id in the existing
 					tables, or assigned during the time
 					mysqld has been up; at an InnoDB
@@ -307,6 +350,18 @@ struct fil_system_struct {
 initialized. */
 static fil_system_t*	fil_system	= NULL;
 
+/*******************************************************************//**
+Returns the shard of the tablespace memory cache that a space belongs to.
+@return	shard */
+UNIV_INLINE
+fil_shard_t*
+fil_shard_get(
+/*==========*/
+	ulint	id)	/*!< in: space id */
+{
+	return(&fil_system->shards[id % FIL_N_SHARDS]);
+}
+
 #ifdef UNIV_DEBUG
 /** Try fil_validate() every this many times */
 # define FIL_VALIDATE_SKIP	17
@@ -362,12 +417,13 @@ fil_account_close(
 }
 
 /********************************************************************//**
-NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
+NOTE: if the file may be closed, you must call
+fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex. */
+pending i/o's field in the node and the shard appropriately. Takes the node
+off the LRU list if it is in the LRU list. The caller must hold the shard
+mutex, and also the fil_sys mutex if the file is closed. */
 static
 void
 fil_node_prepare_for_io(
@@ -377,13 +433,14 @@ fil_node_prepare_for_io(
 	fil_space_t*	space);	/*!< in: space */
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+shard mutex. */
 static
 void
 fil_node_complete_io(
 /*=================*/
 	fil_node_t*	node,	/*!< in: file node */
-	fil_system_t*	system,	/*!< in: tablespace memory cache */
+	fil_shard_t*	shard,	/*!< in: shard of the space of the node */
 	ulint		type);	/*!< in: OS_FILE_WRITE or OS_FILE_READ; marks
 				the node as modified if
 				type == OS_FILE_WRITE */
@@ -468,7 +525,8 @@ fil_write(
 }
 
 /*******************************************************************//**
-Returns the table space by a given id, NULL if not found. */
+Returns the table space by a given id, NULL if not found. The caller must
+hold the fil_sys mutex or the mutex of the shard of the space. */
 UNIV_INLINE
 fil_space_t*
 fil_space_get_by_id(
@@ -476,10 +534,11 @@ fil_space_get_by_id(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard	= fil_shard_get(id);
 
-	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(mutex_own(&fil_system->mutex) || mutex_own(&shard->mutex));
 
-	HASH_SEARCH(hash, fil_system->spaces, id,
+	HASH_SEARCH(hash, shard->spaces, id,
 		    fil_space_t*, space,
 		    ut_ad(space->magic_n == FIL_SPACE_MAGIC_N),
 		    space->id == id);
@@ -522,11 +581,14 @@ fil_space_get_version(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 	ib_int64_t	version		= -1;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -534,7 +596,7 @@ fil_space_get_version(
 		version = space->tablespace_version;
 	}
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(version);
 }
@@ -550,10 +612,13 @@ fil_space_get_latch(
 	ulint*	flags)	/*!< out: tablespace flags */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -563,7 +628,7 @@ fil_space_get_latch(
 		*flags = space->flags;
 	}
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(&(space->latch));
 }
@@ -578,16 +643,19 @@ fil_space_get_type(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
 	ut_a(space);
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(space->purpose);
 }
@@ -595,7 +663,7 @@ fil_space_get_type(
 
 /**********************************************************************//**
 Checks if all the file nodes in a space are flushed. The caller must hold
-the fil_system mutex.
+the shard mutex.
 @return	TRUE if all are flushed */
 static
 ibool
@@ -605,7 +673,7 @@ fil_space_is_flushed(
 {
 	fil_node_t*	node;
 
-	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(mutex_own(&fil_shard_get(space->id)->mutex));
 
 	node = UT_LIST_GET_FIRST(space->chain);
 
@@ -676,12 +744,16 @@ fil_node_create(
 		return;
 	}
 
+	mutex_enter(&fil_shard_get(id)->mutex);
+
 	space->size += size;
 
 	node->space = space;
 
 	UT_LIST_ADD_LAST(chain, space->chain, node);
 
+	mutex_exit(&fil_shard_get(id)->mutex);
+
 	if (id < SRV_LOG_SPACE_FIRST_ID && fil_system->max_assigned_id < id) {
 
 		fil_system->max_assigned_id = id;
@@ -692,7 +764,7 @@ fil_node_create(
 
 /********************************************************************//**
 Opens a the file of a node of a tablespace. The caller must own the fil_system
-mutex. */
+mutex and the mutex of the shard of the space. */
 static
 void
 fil_node_open_file(
@@ -712,6 +784,7 @@ fil_node_open_file(
 	ulint		flags;
 
 	ut_ad(mutex_own(&(system->mutex)));
+	ut_ad(mutex_own(&fil_shard_get(space->id)->mutex));
 	ut_a(node->n_pending == 0);
 	ut_a(node->open == FALSE);
 
@@ -808,7 +881,10 @@ fil_node_open_file(
 			ut_error;
 		}
 
-		if (UNIV_UNLIKELY(space->flags != flags)) {
+		if (UNIV_UNLIKELY((space->flags
+				   & ~FSP_FLAGS_MASK_ZIP_COMPRESSION)
+				  != (flags
+				      & ~FSP_FLAGS_MASK_ZIP_COMPRESSION))) {
 			fprintf(stderr,
 				"InnoDB: Error: table flags are %lx"
 				" in the data dictionary\n"
@@ -818,6 +894,10 @@ fil_node_open_file(
 			ut_error;
 		}
 
+		/* The page compression codec is not stored in
+		the data dictionary. */
+		space->flags = flags;
+
 		if (size_bytes >= 1024 * 1024) {
 			/* Truncate the size to whole megabytes. */
 			size_bytes = ut_2pow_round(size_bytes, 1024 * 1024);
@@ -869,12 +949,13 @@ add_size:
 
 	if (space->purpose == FIL_TABLESPACE && space->id != 0) {
 		/* Put the node to the LRU list */
-		UT_LIST_ADD_FIRST(LRU, system->LRU, node);
+		UT_LIST_ADD_FIRST(LRU, fil_shard_get(space->id)->LRU, node);
 	}
 }
 
 /**********************************************************************//**
-Closes a file. */
+Closes a file. The caller must own the fil_system mutex and the mutex of
+the shard of the space. */
 static
 void
 fil_node_close_file(
@@ -882,10 +963,15 @@ fil_node_close_file(
 	fil_node_t*	node,	/*!< in: file node */
 	fil_system_t*	system)	/*!< in: tablespace memory cache */
 {
-	ibool	ret;
+	ibool		ret;
+	fil_shard_t*	shard;
 
 	ut_ad(node && system);
 	ut_ad(mutex_own(&(system->mutex)));
+
+	shard = fil_shard_get(node->space->id);
+
+	ut_ad(mutex_own(&shard->mutex));
 	ut_a(node->open);
 	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
@@ -904,39 +990,31 @@ fil_node_close_file(
 	fil_account_close(system);
 
 	if (node->space->purpose == FIL_TABLESPACE && node->space->id != 0) {
-		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
+		ut_a(UT_LIST_GET_LEN(shard->LRU) > 0);
 
 		/* The node is in the LRU list, remove it */
-		UT_LIST_REMOVE(LRU, system->LRU, node);
+		UT_LIST_REMOVE(LRU, shard->LRU, node);
 	}
 }
 
 /********************************************************************//**
-Tries to close a file in the LRU list. The caller must hold the fil_sys
-mutex.
-@return TRUE if success, FALSE if should retry later; since i/o's
-generally complete in < 100 ms, and as InnoDB writes at most 128 pages
-from the buffer pool in a batch, and then immediately flushes the
-files, there is a good chance that the next time we find a suitable
-node from the LRU list */
+Tries to close a file in the LRU list of a shard. The caller must hold
+the fil_sys mutex and the shard mutex.
+@return	TRUE if a file was closed */
 static
 ibool
-fil_try_to_close_file_in_LRU(
-/*=========================*/
-	ibool	print_info)	/*!< in: if TRUE, prints information why it
-				cannot close a file */
+fil_try_to_close_file_in_shard_LRU(
+/*===============================*/
+	fil_shard_t*	shard,		/*!< in: shard */
+	ibool		print_info)	/*!< in: if TRUE, prints information
+					why it cannot close a file */
 {
 	fil_node_t*	node;
 
 	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(mutex_own(&shard->mutex));
 
-	node = UT_LIST_GET_LAST(fil_system->LRU);
-
-	if (print_info) {
-		fprintf(stderr,
-			"InnoDB: fil_sys open file LRU len %lu\n",
-			(ulong) UT_LIST_GET_LEN(fil_system->LRU));
-	}
+	node = UT_LIST_GET_LAST(shard->LRU);
 
 	while (node != NULL) {
 		if (node->modification_counter == node->flush_counter
@@ -970,6 +1048,58 @@ fil_try_to_close_file_in_LRU(
 	return(FALSE);
 }
 
+/********************************************************************//**
+Tries to close a file in the LRU lists of the shards. The shards are
+tried in a round-robin fashion, starting from the shard after the one
+where a file was closed the last time. The caller must hold the fil_sys
+mutex and must not hold any shard mutex.
+@return TRUE if success, FALSE if should retry later; since i/o's
+generally complete in < 100 ms, and as InnoDB writes at most 128 pages
+from the buffer pool in a batch, and then immediately flushes the
+files, there is a good chance that the next time we find a suitable
+node from the LRU list */
+static
+ibool
+fil_try_to_close_file_in_LRU(
+/*=========================*/
+	ibool	print_info)	/*!< in: if TRUE, prints information why it
+				cannot close a file */
+{
+	ulint	i;
+
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	for (i = 0; i < FIL_N_SHARDS; i++) {
+		ulint		n	= (fil_system->LRU_shard + i)
+			% FIL_N_SHARDS;
+		fil_shard_t*	shard	= &fil_system->shards[n];
+		ibool		success;
+
+		mutex_enter(&shard->mutex);
+
+		if (print_info && UT_LIST_GET_LEN(shard->LRU) > 0) {
+			fprintf(stderr,
+				"InnoDB: fil_sys open file LRU len %lu"
+				" in shard %lu\n",
+				(ulong) UT_LIST_GET_LEN(shard->LRU),
+				(ulong) n);
+		}
+
+		success = fil_try_to_close_file_in_shard_LRU(
+			shard, print_info);
+
+		mutex_exit(&shard->mutex);
+
+		if (success) {
+			fil_system->LRU_shard = (n + 1) % FIL_N_SHARDS;
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
 /*******************************************************************//**
 Reserves the fil_system mutex and tries to make sure we can open at least one
 file while holding it. This should be called before calling
@@ -1109,7 +1239,8 @@ close_more:
 }
 
 /*******************************************************************//**
-Frees a file node object from a tablespace memory cache. */
+Frees a file node object from a tablespace memory cache. The caller must
+own the fil_system mutex and the mutex of the shard of the space. */
 static
 void
 fil_node_free(
@@ -1120,6 +1251,7 @@ fil_node_free(
 {
 	ut_ad(node && system && space);
 	ut_ad(mutex_own(&(system->mutex)));
+	ut_ad(mutex_own(&fil_shard_get(space->id)->mutex));
 	ut_a(node->magic_n == FIL_NODE_MAGIC_N);
 	ut_a(node->n_pending == 0);
 
@@ -1135,7 +1267,8 @@ fil_node_free(
 			space->is_in_unflushed_spaces = FALSE;
 
 			UT_LIST_REMOVE(unflushed_spaces,
-				       system->unflushed_spaces,
+				       fil_shard_get(space->id)
+				       ->unflushed_spaces,
 				       space);
 		}
 
@@ -1172,6 +1305,8 @@ fil_space_truncate_start(
 
 	ut_a(space);
 
+	mutex_enter(&fil_shard_get(id)->mutex);
+
 	while (trunc_len > 0) {
 		node = UT_LIST_GET_FIRST(space->chain);
 
@@ -1182,6 +1317,8 @@ fil_space_truncate_start(
 		fil_node_free(node, fil_system, space);
 	}
 
+	mutex_exit(&fil_shard_get(id)->mutex);
+
 	mutex_exit(&fil_system->mutex);
 }
 #endif /* UNIV_LOG_ARCHIVE */
@@ -1207,9 +1344,11 @@ fil_space_create(
 	((table->flags & ~(~0 << DICT_TF_BITS)) == DICT_TF_COMPACT) and
 	ROW_FORMAT=REDUNDANT (table->flags == 0).  For any other
 	format, the tablespace flags should equal
-	(table->flags & ~(~0 << DICT_TF_BITS)). */
+	(table->flags & ~(~0 << DICT_TF_BITS)), plus the page compression
+	codec and level of ROW_FORMAT=COMPRESSED. */
 	ut_a(flags != DICT_TF_COMPACT);
-	ut_a(!(flags & (~0UL << DICT_TF_BITS)));
+	ut_a(!(flags & (~0UL << DICT_TF_BITS)
+	       & ~FSP_FLAGS_MASK_ZIP_COMPRESSION));
 
 try_again:
 	/*printf(
@@ -1332,7 +1471,9 @@ try_again:
 
 	rw_lock_create(fil_space_latch_key, &space->latch, SYNC_FSP);
 
-	HASH_INSERT(fil_space_t, hash, fil_system->spaces, id, space);
+	mutex_enter(&fil_shard_get(id)->mutex);
+	HASH_INSERT(fil_space_t, hash, fil_shard_get(id)->spaces, id, space);
+	mutex_exit(&fil_shard_get(id)->mutex);
 
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(name), space);
@@ -1422,6 +1563,7 @@ fil_space_free(
 	fil_space_t*	space;
 	fil_space_t*	namespace;
 	fil_node_t*	fil_node;
+	fil_shard_t*	shard;
 
 	ut_ad(mutex_own(&fil_system->mutex));
 
@@ -1437,7 +1579,11 @@ fil_space_free(
 		return(FALSE);
 	}
 
-	HASH_DELETE(fil_space_t, hash, fil_system->spaces, id, space);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
+
+	HASH_DELETE(fil_space_t, hash, shard->spaces, id, space);
 
 	namespace = fil_space_get_by_name(space->name);
 	ut_a(namespace);
@@ -1449,7 +1595,7 @@ fil_space_free(
 	if (space->is_in_unflushed_spaces) {
 		space->is_in_unflushed_spaces = FALSE;
 
-		UT_LIST_REMOVE(unflushed_spaces, fil_system->unflushed_spaces,
+		UT_LIST_REMOVE(unflushed_spaces, shard->unflushed_spaces,
 			       space);
 	}
 
@@ -1468,6 +1614,8 @@ fil_space_free(
 
 	ut_a(0 == UT_LIST_GET_LEN(space->chain));
 
+	mutex_exit(&shard->mutex);
+
 	if (x_latched) {
 		rw_lock_x_unlock(&space->latch);
 	}
@@ -1492,16 +1640,19 @@ fil_space_get_size(
 {
 	fil_node_t*	node;
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 	ulint		size;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
 	if (space == NULL) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return(0);
 	}
@@ -1511,7 +1662,9 @@ fil_space_get_size(
 
 		ut_a(1 == UT_LIST_GET_LEN(space->chain));
 
-		mutex_exit(&fil_system->mutex);
+		/* Opening the file requires the fil_system->mutex,
+		which must be acquired before the shard mutex. */
+		mutex_exit(&shard->mutex);
 
 		/* It is possible that the space gets evicted at this point
 		before the fil_mutex_enter_and_prepare_for_io() acquires
@@ -1519,11 +1672,14 @@ fil_space_get_size(
 		call to fil_mutex_enter_and_prepare_for_io(). */
 		fil_mutex_enter_and_prepare_for_io(id);
 
+		mutex_enter(&shard->mutex);
+
 		/* We are still holding the fil_system->mutex. Check if
 		the space is still in memory cache. */
 		space = fil_space_get_by_id(id);
 
 		if (space == NULL) {
+			mutex_exit(&shard->mutex);
 			mutex_exit(&fil_system->mutex);
 			return(0);
 		}
@@ -1535,12 +1691,14 @@ fil_space_get_size(
 		size fields */
 
 		fil_node_prepare_for_io(node, fil_system, space);
-		fil_node_complete_io(node, fil_system, OS_FILE_READ);
+		fil_node_complete_io(node, shard, OS_FILE_READ);
+
+		mutex_exit(&fil_system->mutex);
 	}
 
 	size = space->size;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(size);
 }
@@ -1557,6 +1715,7 @@ fil_space_get_flags(
 {
 	fil_node_t*	node;
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 	ulint		flags;
 
 	ut_ad(fil_system);
@@ -1565,12 +1724,14 @@ fil_space_get_flags(
 		return(0);
 	}
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
 	if (space == NULL) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return(ULINT_UNDEFINED);
 	}
@@ -1580,7 +1741,9 @@ fil_space_get_flags(
 
 		ut_a(1 == UT_LIST_GET_LEN(space->chain));
 
-		mutex_exit(&fil_system->mutex);
+		/* Opening the file requires the fil_system->mutex,
+		which must be acquired before the shard mutex. */
+		mutex_exit(&shard->mutex);
 
 		/* It is possible that the space gets evicted at this point
 		before the fil_mutex_enter_and_prepare_for_io() acquires
@@ -1588,11 +1751,14 @@ fil_space_get_flags(
 		call to fil_mutex_enter_and_prepare_for_io(). */
 		fil_mutex_enter_and_prepare_for_io(id);
 
+		mutex_enter(&shard->mutex);
+
 		/* We are still holding the fil_system->mutex. Check if
 		the space is still in memory cache. */
 		space = fil_space_get_by_id(id);
 
 		if (space == NULL) {
+			mutex_exit(&shard->mutex);
 			mutex_exit(&fil_system->mutex);
 			return(0);
 		}
@@ -1604,12 +1770,14 @@ fil_space_get_flags(
 		size fields */
 
 		fil_node_prepare_for_io(node, fil_system, space);
-		fil_node_complete_io(node, fil_system, OS_FILE_READ);
+		fil_node_complete_io(node, shard, OS_FILE_READ);
+
+		mutex_exit(&fil_system->mutex);
 	}
 
 	flags = space->flags;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(flags);
 }
@@ -1664,6 +1832,8 @@ fil_init(
 	ulint	hash_size,	/*!< in: hash table size */
 	ulint	max_n_open)	/*!< in: max number of open files */
 {
+	ulint	i;
+
 	ut_a(fil_system == NULL);
 
 	ut_a(hash_size > 0);
@@ -1674,10 +1844,19 @@ fil_init(
 	mutex_create(fil_system_mutex_key,
 		     &fil_system->mutex, SYNC_ANY_LATCH);
 
-	fil_system->spaces = hash_create(hash_size);
-	fil_system->name_hash = hash_create(hash_size);
+	for (i = 0; i < FIL_N_SHARDS; i++) {
+		fil_shard_t*	shard = &fil_system->shards[i];
+
+		mutex_create(fil_shard_mutex_key,
+			     &shard->mutex, SYNC_FIL_SHARD);
 
-	UT_LIST_INIT(fil_system->LRU);
+		shard->spaces = hash_create(hash_size / FIL_N_SHARDS + 1);
+
+		UT_LIST_INIT(shard->LRU);
+		UT_LIST_INIT(shard->unflushed_spaces);
+	}
+
+	fil_system->name_hash = hash_create(hash_size);
 
 	fil_system->max_n_open = max_n_open;
 }
@@ -1706,8 +1885,12 @@ fil_open_log_and_system_tablespace_files(void)
 
 			while (node != NULL) {
 				if (!node->open) {
+					mutex_enter(&fil_shard_get(space->id)
+						    ->mutex);
 					fil_node_open_file(node, fil_system,
 							   space);
+					mutex_exit(&fil_shard_get(space->id)
+						   ->mutex);
 				}
 				if (fil_system->max_n_open
 				    < 10 + fil_system->n_open) {
@@ -1758,6 +1941,8 @@ fil_close_all_files(void)
 		fil_node_t*	node;
 		fil_space_t*	prev_space = space;
 
+		mutex_enter(&fil_shard_get(space->id)->mutex);
+
 		for (node = UT_LIST_GET_FIRST(space->chain);
 		     node != NULL;
 		     node = UT_LIST_GET_NEXT(chain, node)) {
@@ -1767,6 +1952,8 @@ fil_close_all_files(void)
 			}
 		}
 
+		mutex_exit(&fil_shard_get(space->id)->mutex);
+
 		space = UT_LIST_GET_NEXT(space_list, space);
 
 		fil_space_free(prev_space->id, FALSE);
@@ -2024,15 +2211,18 @@ UNIV_INTERN
 ibool
 fil_inc_pending_ops(
 /*================*/
-	ulint	id)	/*!< in: space id */
+	ulint	id,		/*!< in: space id */
+	ibool	print_err)	/*!< in: whether to report a dropped
+				tablespace */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard	= fil_shard_get(id);
 
-	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
-	if (space == NULL) {
+	if (space == NULL && print_err) {
 		fprintf(stderr,
 			"InnoDB: Error: trying to do an operation on a"
 			" dropped tablespace %lu\n",
@@ -2040,14 +2230,14 @@ fil_inc_pending_ops(
 	}
 
 	if (space == NULL || space->stop_new_ops) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return(TRUE);
 	}
 
 	space->n_pending_ops++;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(FALSE);
 }
@@ -2061,8 +2251,9 @@ fil_decr_pending_ops(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard	= fil_shard_get(id);
 
-	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -2077,7 +2268,7 @@ fil_decr_pending_ops(
 		space->n_pending_ops--;
 	}
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 }
 #endif /* !UNIV_HOTBACKUP */
 
@@ -2285,7 +2476,8 @@ fil_op_log_parse_or_replay(
 	switch (type) {
 	case MLOG_FILE_DELETE:
 		if (fil_tablespace_exists_in_mem(space_id)) {
-			ut_a(fil_delete_tablespace(space_id, TRUE));
+			ut_a(fil_delete_tablespace(
+				     space_id, BUF_REMOVE_ALL_NO_WRITE));
 		}
 
 		break;
@@ -2355,19 +2547,23 @@ UNIV_INTERN
 ibool
 fil_delete_tablespace(
 /*==================*/
-	ulint	id,		/*!< in: space id */
-	ibool	evict_all)	/*!< in: TRUE if we want all pages
-				evicted from LRU. */
+	ulint			id,		/*!< in: space id */
+	enum buf_remove_t	buf_remove)	/*!< in: how to remove the
+						pages from the buffer pool */
 {
 	ibool		success;
 	fil_space_t*	space;
 	fil_node_t*	node;
+	fil_shard_t*	shard;
 	ulint		count		= 0;
 	char*		path;
 
 	ut_a(id != 0);
+
+	shard = fil_shard_get(id);
 stop_new_ops:
 	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -2375,6 +2571,7 @@ stop_new_ops:
 		space->stop_new_ops = TRUE;
 
 		if (space->n_pending_ops == 0) {
+			mutex_exit(&shard->mutex);
 			mutex_exit(&fil_system->mutex);
 
 			count = 0;
@@ -2395,6 +2592,7 @@ stop_new_ops:
 					(ulong) count);
 			}
 
+			mutex_exit(&shard->mutex);
 			mutex_exit(&fil_system->mutex);
 
 			os_thread_sleep(20000);
@@ -2404,11 +2602,13 @@ stop_new_ops:
 		}
 	}
 
+	mutex_exit(&shard->mutex);
 	mutex_exit(&fil_system->mutex);
 	count = 0;
 
 try_again:
 	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -2420,6 +2620,7 @@ try_again:
 			" tablespace memory cache.\n",
 			(ulong) id);
 
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 
 		return(FALSE);
@@ -2445,6 +2646,7 @@ try_again:
 				(ulong) node->n_pending,
 				(ulong) count);
 		}
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 		os_thread_sleep(20000);
 
@@ -2453,6 +2655,8 @@ try_again:
 		goto try_again;
 	}
 
+	mutex_exit(&shard->mutex);
+
 	path = mem_strdup(space->name);
 
 	mutex_exit(&fil_system->mutex);
@@ -2480,24 +2684,27 @@ try_again:
 	before the flag was set and has not yet incremented ::n_pending
 	when we checked it above.
 
-	A write request can be issued any time because we don't check
-	the ::stop_new_ops flag when queueing a block for write.
-
-	We deal with pending write requests in the following function
-	where we'd minimally evict all dirty pages belonging to this
-	space from the flush_list. Not that if a block is IO-fixed
-	we'll wait for IO to complete.
-
-	To deal with potential read requests by checking the
+	A write request is only queued by buf_flush_page() after
+	fil_inc_pending_ops() has succeeded, and ::n_pending_ops is
+	decremented when the write completes. Thus no write can be in
+	flight here, and every later attempt to flush a dirty page of
+	this space finds it gone and drops the page from the flush_list
+	without writing it. With BUF_REMOVE_NONE we rely on that alone
+	and leave the pages to age out of the LRU list, so that the
+	cost of the drop does not depend on the buffer pool size.
+	The space id is never reused, except by IMPORT TABLESPACE after
+	a DISCARD, which evicts all the pages.
+
+	We deal with potential read requests by checking the
 	::stop_new_ops flag in fil_io() */
-	buf_LRU_flush_or_remove_pages(
-		id, evict_all
-		? BUF_REMOVE_ALL_NO_WRITE
-		: BUF_REMOVE_FLUSH_NO_WRITE);
+	if (buf_remove != BUF_REMOVE_NONE) {
+		buf_LRU_flush_or_remove_pages(id, buf_remove);
+	}
 #endif
 	/* printf("Deleting tablespace %s id %lu\n", space->name, id); */
 
 	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	/* Double check the sanity of pending ops after reacquiring
 	the fil_system::mutex. */
@@ -2508,6 +2715,8 @@ try_again:
 		ut_a(node->n_pending == 0);
 	}
 
+	mutex_exit(&shard->mutex);
+
 	success = fil_space_free(id, TRUE);
 
 	mutex_exit(&fil_system->mutex);
@@ -2557,9 +2766,10 @@ fil_tablespace_is_being_deleted(
 	ulint		id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard	= fil_shard_get(id);
 	ibool		is_being_deleted;
 
-	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -2567,7 +2777,7 @@ fil_tablespace_is_being_deleted(
 
 	is_being_deleted = space->stop_new_ops;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(is_being_deleted);
 }
@@ -2586,11 +2796,13 @@ UNIV_INTERN
 ibool
 fil_discard_tablespace(
 /*===================*/
-	ulint	id)	/*!< in: space id */
+	ulint			id,		/*!< in: space id */
+	enum buf_remove_t	buf_remove)	/*!< in: how to remove the
+						pages from the buffer pool */
 {
 	ibool	success;
 
-	success = fil_delete_tablespace(id, TRUE);
+	success = fil_delete_tablespace(id, buf_remove);
 
 	if (!success) {
 		fprintf(stderr,
@@ -2645,12 +2857,17 @@ fil_rename_tablespace_in_mem(
 
 	HASH_DELETE(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(space->name), space);
+
+	mutex_enter(&fil_shard_get(space->id)->mutex);
+
 	mem_free(space->name);
 	mem_free(node->name);
 
 	space->name = mem_strdup(path);
 	node->name = mem_strdup(path);
 
+	mutex_exit(&fil_shard_get(space->id)->mutex);
+
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(path), space);
 	return(TRUE);
@@ -2660,7 +2877,7 @@ fil_rename_tablespace_in_mem(
 Allocates a file name for a single-table tablespace. The string must be freed
 by caller with mem_free().
 @return	own: file name */
-static
+UNIV_INTERN
 char*
 fil_make_ibd_name(
 /*==============*/
@@ -2688,6 +2905,26 @@ fil_make_ibd_name(
 	return(filename);
 }
 
+/*******************************************************************//**
+Allocates the name of the metadata file that FLUSH TABLES ... FOR EXPORT
+writes next to the .ibd file of a table. The string must be freed by
+caller with mem_free().
+@return	own: file name */
+UNIV_INTERN
+char*
+fil_make_cfg_name(
+/*==============*/
+	const char*	name)	/*!< in: table name */
+{
+	char*	filename	= fil_make_ibd_name(name, FALSE);
+	ulint	len		= strlen(filename);
+
+	ut_ad(len > 4 && !strcmp(filename + len - 4, ".ibd"));
+	memcpy(filename + len - 4, ".cfg", 4);
+
+	return(filename);
+}
+
 /*******************************************************************//**
 Renames a single-table tablespace. The tablespace must be cached in the
 tablespace memory cache.
@@ -2708,6 +2945,7 @@ fil_rename_tablespace(
 	ibool		success;
 	fil_space_t*	space;
 	fil_node_t*	node;
+	fil_shard_t*	shard;
 	ulint		count		= 0;
 	char*		path;
 	ibool		old_name_was_specified		= TRUE;
@@ -2715,6 +2953,8 @@ fil_rename_tablespace(
 
 	ut_a(id != 0);
 
+	shard = fil_shard_get(id);
+
 	if (old_name == NULL) {
 		old_name = "(name not specified)";
 		old_name_was_specified = FALSE;
@@ -2747,8 +2987,11 @@ retry:
 		return(FALSE);
 	}
 
+	mutex_enter(&shard->mutex);
+
 	if (count > 25000) {
 		space->stop_ios = FALSE;
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 
 		return(FALSE);
@@ -2767,6 +3010,7 @@ retry:
 		/* There are pending i/o's or flushes, sleep for a while and
 		retry */
 
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 
 		os_thread_sleep(20000);
@@ -2776,6 +3020,7 @@ retry:
 	} else if (node->modification_counter > node->flush_counter) {
 		/* Flush the space */
 
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 
 		os_thread_sleep(20000);
@@ -2790,6 +3035,8 @@ retry:
 		fil_node_close_file(node, fil_system);
 	}
 
+	mutex_exit(&shard->mutex);
+
 	/* Check that the old name in the space is right */
 
 	if (old_name_was_specified) {
@@ -2820,7 +3067,9 @@ retry:
 	mem_free(path);
 	mem_free(old_path);
 
+	mutex_enter(&shard->mutex);
 	space->stop_ios = FALSE;
+	mutex_exit(&shard->mutex);
 
 	mutex_exit(&fil_system->mutex);
 
@@ -2877,9 +3126,11 @@ fil_create_new_single_table_tablespace(
 	((table->flags & ~(~0 << DICT_TF_BITS)) == DICT_TF_COMPACT) and
 	ROW_FORMAT=REDUNDANT (table->flags == 0).  For any other
 	format, the tablespace flags should equal
-	(table->flags & ~(~0 << DICT_TF_BITS)). */
+	(table->flags & ~(~0 << DICT_TF_BITS)), plus the page compression
+	codec and level of ROW_FORMAT=COMPRESSED. */
 	ut_a(flags != DICT_TF_COMPACT);
-	ut_a(!(flags & (~0UL << DICT_TF_BITS)));
+	ut_a(!(flags & (~0UL << DICT_TF_BITS)
+	       & ~FSP_FLAGS_MASK_ZIP_COMPRESSION));
 
 	path = fil_make_ibd_name(tablename, is_temp);
 
@@ -3037,180 +3288,6 @@ error_exit2:
 }
 
 #ifndef UNIV_HOTBACKUP
-/********************************************************************//**
-It is possible, though very improbable, that the lsn's in the tablespace to be
-imported have risen above the current system lsn, if a lengthy purge, ibuf
-merge, or rollback was performed on a backup taken with ibbackup. If that is
-the case, reset page lsn's in the file. We assume that mysqld was shut down
-after it performed these cleanup operations on the .ibd file, so that it at
-the shutdown stamped the latest lsn to the FIL_PAGE_FILE_FLUSH_LSN in the
-first page of the .ibd file, and we can determine whether we need to reset the
-lsn's just by looking at that flush lsn.
-@return	TRUE if success */
-UNIV_INTERN
-ibool
-fil_reset_too_high_lsns(
-/*====================*/
-	const char*	name,		/*!< in: table name in the
-					databasename/tablename format */
-	ib_uint64_t	current_lsn)	/*!< in: reset lsn's if the lsn stamped
-					to FIL_PAGE_FILE_FLUSH_LSN in the
-					first page is too high */
-{
-	os_file_t	file;
-	char*		filepath;
-	byte*		page;
-	byte*		buf2;
-	ib_uint64_t	flush_lsn;
-	ulint		space_id;
-	ib_int64_t	file_size;
-	ib_int64_t	offset;
-	ulint		zip_size;
-	ibool		success;
-	page_zip_des_t	page_zip;
-
-	filepath = fil_make_ibd_name(name, FALSE);
-
-	file = os_file_create_simple_no_error_handling(
-		innodb_file_data_key, filepath, OS_FILE_OPEN,
-		OS_FILE_READ_WRITE, &success);
-	if (!success) {
-		/* The following call prints an error message */
-		os_file_get_last_error(TRUE);
-
-		ut_print_timestamp(stderr);
-
-		fputs("  InnoDB: Error: trying to open a table,"
-		      " but could not\n"
-		      "InnoDB: open the tablespace file ", stderr);
-		ut_print_filename(stderr, filepath);
-		fputs("!\n", stderr);
-		mem_free(filepath);
-
-		return(FALSE);
-	}
-
-	/* Read the first page of the tablespace */
-
-	buf2 = ut_malloc(3 * UNIV_PAGE_SIZE);
-	/* Align the memory for file i/o if we might have O_DIRECT set */
-	page = ut_align(buf2, UNIV_PAGE_SIZE);
-
-	success = os_file_read(file, page, 0, 0, UNIV_PAGE_SIZE);
-	if (!success) {
-
-		goto func_exit;
-	}
-
-	/* We have to read the file flush lsn from the header of the file */
-
-	flush_lsn = mach_read_from_8(page + FIL_PAGE_FILE_FLUSH_LSN);
-
-	if (current_lsn >= flush_lsn) {
-		/* Ok */
-		success = TRUE;
-
-		goto func_exit;
-	}
-
-	space_id = fsp_header_get_space_id(page);
-	zip_size = fsp_header_get_zip_size(page);
-
-	page_zip_des_init(&page_zip);
-	page_zip_set_size(&page_zip, zip_size);
-	if (zip_size) {
-		page_zip.data = page + UNIV_PAGE_SIZE;
-	}
-
-	ut_print_timestamp(stderr);
-	fprintf(stderr,
-		"  InnoDB: Flush lsn in the tablespace file %lu"
-		" to be imported\n"
-		"InnoDB: is %llu, which exceeds current"
-		" system lsn %llu.\n"
-		"InnoDB: We reset the lsn's in the file ",
-		(ulong) space_id,
-		flush_lsn, current_lsn);
-	ut_print_filename(stderr, filepath);
-	fputs(".\n", stderr);
-
-	ut_a(ut_is_2pow(zip_size));
-	ut_a(zip_size <= UNIV_PAGE_SIZE);
-
-	/* Loop through all the pages in the tablespace and reset the lsn and
-	the page checksum if necessary */
-
-	file_size = os_file_get_size_as_iblonglong(file);
-
-	for (offset = 0; offset < file_size;
-	     offset += zip_size ? zip_size : UNIV_PAGE_SIZE) {
-		success = os_file_read(file, page,
-				       (ulint)(offset & 0xFFFFFFFFUL),
-				       (ulint)(offset >> 32),
-				       zip_size ? zip_size : UNIV_PAGE_SIZE);
-		if (!success) {
-
-			goto func_exit;
-		}
-		if (mach_read_from_8(page + FIL_PAGE_LSN) > current_lsn) {
-			/* We have to reset the lsn */
-
-			if (zip_size) {
-				memcpy(page_zip.data, page, zip_size);
-				buf_flush_init_for_writing(
-					page, &page_zip, current_lsn);
-				success = os_file_write(
-					filepath, file, page_zip.data,
-					(ulint) offset & 0xFFFFFFFFUL,
-					(ulint) (offset >> 32), zip_size);
-			} else {
-				buf_flush_init_for_writing(
-					page, NULL, current_lsn);
-				success = os_file_write(
-					filepath, file, page,
-					(ulint)(offset & 0xFFFFFFFFUL),
-					(ulint)(offset >> 32),
-					UNIV_PAGE_SIZE);
-			}
-
-			if (!success) {
-
-				goto func_exit;
-			}
-		}
-	}
-
-	success = os_file_flush(file);
-	if (!success) {
-
-		goto func_exit;
-	}
-
-	/* We now update the flush_lsn stamp at the start of the file */
-	success = os_file_read(file, page, 0, 0,
-			       zip_size ? zip_size : UNIV_PAGE_SIZE);
-	if (!success) {
-
-		goto func_exit;
-	}
-
-	mach_write_to_8(page + FIL_PAGE_FILE_FLUSH_LSN, current_lsn);
-
-	success = os_file_write(filepath, file, page, 0, 0,
-				zip_size ? zip_size : UNIV_PAGE_SIZE);
-	if (!success) {
-
-		goto func_exit;
-	}
-	success = os_file_flush(file);
-func_exit:
-	os_file_close(file);
-	ut_free(buf2);
-	mem_free(filepath);
-
-	return(success);
-}
-
 /********************************************************************//**
 Tries to open a single-table tablespace and optionally checks the space id is
 right in it. If does not succeed, prints an error message to the .err log. This
@@ -3289,6 +3366,7 @@ fil_open_single_table_tablespace(
 
 	if (!check_space_id) {
 		space_id = id;
+		space_flags = flags;
 
 		goto skip_check;
 	}
@@ -3323,7 +3401,8 @@ fil_open_single_table_tablespace(
 	}
 
 	if (space_id != id
-	    || space_flags != (flags & ~(~0 << DICT_TF_BITS))) {
+	    || (space_flags & ~FSP_FLAGS_MASK_ZIP_COMPRESSION)
+	    != (flags & ~(~0UL << DICT_TF_BITS))) {
 		ut_print_timestamp(stderr);
 
 		fputs("  InnoDB: Error: tablespace id and flags in file ",
@@ -3347,7 +3426,8 @@ fil_open_single_table_tablespace(
 	}
 
 skip_check:
-	success = fil_space_create(filepath, space_id, flags, FIL_TABLESPACE);
+	success = fil_space_create(filepath, space_id, space_flags,
+				   FIL_TABLESPACE);
 
 	if (!success) {
 		goto func_exit;
@@ -3858,27 +3938,30 @@ fil_tablespace_deleted_or_being_deleted_in_mem(
 				parameter is ignored */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
 	if (space == NULL || space->stop_new_ops) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return(TRUE);
 	}
 
 	if (version != ((ib_int64_t)-1)
 	    && space->tablespace_version != version) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return(TRUE);
 	}
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(FALSE);
 }
@@ -3893,14 +3976,17 @@ fil_tablespace_exists_in_mem(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(space != NULL);
 }
@@ -4109,10 +4195,15 @@ fil_extend_space_to_desired_size(
 	ulint		offset_high;
 	ulint		offset_low;
 	ulint		page_size;
+	fil_shard_t*	shard;
 	ibool		success		= TRUE;
 
 	fil_mutex_enter_and_prepare_for_io(space_id);
 
+	shard = fil_shard_get(space_id);
+
+	mutex_enter(&shard->mutex);
+
 	space = fil_space_get_by_id(space_id);
 	ut_a(space);
 
@@ -4121,6 +4212,7 @@ fil_extend_space_to_desired_size(
 
 		*actual_size = space->size;
 
+		mutex_exit(&shard->mutex);
 		mutex_exit(&fil_system->mutex);
 
 		return(TRUE);
@@ -4138,6 +4230,11 @@ fil_extend_space_to_desired_size(
 	start_page_no = space->size;
 	file_start_page_no = space->size - node->size;
 
+	/* The sizes can only change while holding the fil_system->mutex,
+	which we keep. Release the shard mutex during the writes, so that
+	i/o's on the other spaces of the shard can proceed. */
+	mutex_exit(&shard->mutex);
+
 	/* Extend at most 64 pages at a time */
 	buf_size = ut_min(64, size_after_extend - start_page_no) * page_size;
 	buf2 = mem_alloc(buf_size + page_size);
@@ -4165,14 +4262,7 @@ fil_extend_space_to_desired_size(
 				 page_size * n_pages,
 				 NULL, NULL);
 #endif
-		space->stat.n_extend_bytes += n_pages * page_size;
-
-		if (success) {
-			node->size += n_pages;
-			space->size += n_pages;
-
-			os_has_said_disk_full = FALSE;
-		} else {
+		if (!success) {
 			/* Let us measure the size of the file to determine
 			how much we were able to extend it */
 
@@ -4180,19 +4270,31 @@ fil_extend_space_to_desired_size(
 				   (os_file_get_size_as_iblonglong(
 					   node->handle)
 				    / page_size)) - node->size;
+		}
+
+		mutex_enter(&shard->mutex);
+
+		space->stat.n_extend_bytes += n_pages * page_size;
+
+		node->size += n_pages;
+		space->size += n_pages;
 
-			node->size += n_pages;
-			space->size += n_pages;
+		mutex_exit(&shard->mutex);
 
+		if (!success) {
 			break;
 		}
 
+		os_has_said_disk_full = FALSE;
+
 		start_page_no += n_pages;
 	}
 
 	mem_free(buf2);
 
-	fil_node_complete_io(node, fil_system, OS_FILE_WRITE);
+	mutex_enter(&shard->mutex);
+
+	fil_node_complete_io(node, shard, OS_FILE_WRITE);
 
 	*actual_size = space->size;
 	space->stat.n_extension++;
@@ -4212,6 +4314,7 @@ fil_extend_space_to_desired_size(
 	/*
 	printf("Extended %s to %lu, actual size %lu pages\n", space->name,
 	size_after_extend, *actual_size); */
+	mutex_exit(&shard->mutex);
 	mutex_exit(&fil_system->mutex);
 
 	fil_flush(space_id);
@@ -4296,11 +4399,14 @@ fil_space_reserve_free_extents(
 	ulint	n_to_reserve)	/*!< in: how many one wants to reserve */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 	ibool		success;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -4313,7 +4419,7 @@ fil_space_reserve_free_extents(
 		success = TRUE;
 	}
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(success);
 }
@@ -4328,10 +4434,13 @@ fil_space_release_free_extents(
 	ulint	n_reserved)	/*!< in: how many one reserved */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -4340,7 +4449,7 @@ fil_space_release_free_extents(
 
 	space->n_reserved_extents -= n_reserved;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 }
 
 /*******************************************************************//**
@@ -4353,11 +4462,14 @@ fil_space_get_n_reserved_extents(
 	ulint	id)		/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard;
 	ulint		n;
 
 	ut_ad(fil_system);
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(id);
 
@@ -4365,7 +4477,7 @@ fil_space_get_n_reserved_extents(
 
 	n = space->n_reserved_extents;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 
 	return(n);
 }
@@ -4373,12 +4485,13 @@ fil_space_get_n_reserved_extents(
 /*============================ FILE I/O ================================*/
 
 /********************************************************************//**
-NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
+NOTE: if the file may be closed, you must call
+fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex. */
+pending i/o's field in the node and the shard appropriately. Takes the node
+off the LRU list if it is in the LRU list. The caller must hold the shard
+mutex, and also the fil_sys mutex if the file is closed. */
 static
 void
 fil_node_prepare_for_io(
@@ -4387,22 +4500,28 @@ fil_node_prepare_for_io(
 	fil_system_t*	system,	/*!< in: tablespace memory cache */
 	fil_space_t*	space)	/*!< in: space */
 {
+	fil_shard_t*	shard;
+
 	ut_ad(node && system && space);
-	ut_ad(mutex_own(&(system->mutex)));
 
-	if (system->n_open > system->max_n_open + 5) {
-		ut_print_timestamp(stderr);
-		fprintf(stderr,
-			"  InnoDB: Warning: open files %lu"
-			" exceeds the limit %lu\n",
-			(ulong) system->n_open,
-			(ulong) system->max_n_open);
-	}
+	shard = fil_shard_get(space->id);
+
+	ut_ad(mutex_own(&shard->mutex));
 
 	if (node->open == FALSE) {
 		/* File is closed: open it */
+		ut_ad(mutex_own(&(system->mutex)));
 		ut_a(node->n_pending == 0);
 
+		if (system->n_open > system->max_n_open + 5) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: Warning: open files %lu"
+				" exceeds the limit %lu\n",
+				(ulong) system->n_open,
+				(ulong) system->max_n_open);
+		}
+
 		fil_node_open_file(node, system, space);
 	}
 
@@ -4410,9 +4529,9 @@ fil_node_prepare_for_io(
 	    && space->id != 0) {
 		/* The node is in the LRU list, remove it */
 
-		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
+		ut_a(UT_LIST_GET_LEN(shard->LRU) > 0);
 
-		UT_LIST_REMOVE(LRU, system->LRU, node);
+		UT_LIST_REMOVE(LRU, shard->LRU, node);
 	}
 
 	node->n_pending++;
@@ -4420,34 +4539,35 @@ fil_node_prepare_for_io(
 
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+shard mutex. */
 static
 void
 fil_node_complete_io(
 /*=================*/
 	fil_node_t*	node,	/*!< in: file node */
-	fil_system_t*	system,	/*!< in: tablespace memory cache */
+	fil_shard_t*	shard,	/*!< in: shard of the space of the node */
 	ulint		type)	/*!< in: OS_FILE_WRITE or OS_FILE_READ; marks
 				the node as modified if
 				type == OS_FILE_WRITE */
 {
 	ut_ad(node);
-	ut_ad(system);
-	ut_ad(mutex_own(&(system->mutex)));
+	ut_ad(shard == fil_shard_get(node->space->id));
+	ut_ad(mutex_own(&shard->mutex));
 
 	ut_a(node->n_pending > 0);
 
 	node->n_pending--;
 
 	if (type == OS_FILE_WRITE) {
-		system->modification_counter++;
-		node->modification_counter = system->modification_counter;
+		shard->modification_counter++;
+		node->modification_counter = shard->modification_counter;
 
 		if (!node->space->is_in_unflushed_spaces) {
 
 			node->space->is_in_unflushed_spaces = TRUE;
 			UT_LIST_ADD_FIRST(unflushed_spaces,
-					  system->unflushed_spaces,
+					  shard->unflushed_spaces,
 					  node->space);
 		}
 	}
@@ -4455,7 +4575,7 @@ fil_node_complete_io(
 	if (node->n_pending == 0 && node->space->purpose == FIL_TABLESPACE
 	    && node->space->id != 0) {
 		/* The node must be put back to the LRU list */
-		UT_LIST_ADD_FIRST(LRU, system->LRU, node);
+		UT_LIST_ADD_FIRST(LRU, shard->LRU, node);
 	}
 }
 
@@ -4524,6 +4644,8 @@ fil_io(
 	ulint		mode;
 	fil_space_t*	space;
 	fil_node_t*	node;
+	fil_shard_t*	shard;
+	ibool		sys_mutex_owned	= FALSE;
 	ulint		offset_high;
 	ulint		offset_low;
 	ibool		ret;
@@ -4574,17 +4696,25 @@ fil_io(
 		srv_data_written+= len;
 	}
 
-	/* Reserve the fil_system mutex and make sure that we can open at
-	least one file while holding it, if the file is not already open */
+	/* An i/o on an open file only needs the shard mutex. If the file
+	must be opened or the space is being renamed, we acquire the
+	fil_system mutex and make sure that we can open at least one file
+	while holding it. */
 
-	fil_mutex_enter_and_prepare_for_io(space_id);
+	shard = fil_shard_get(space_id);
 
+	mutex_enter(&shard->mutex);
+retry:
 	space = fil_space_get_by_id(space_id);
 
 	/* If we are deleting a tablespace we don't allow any read
 	operations on that. However, we do allow write operations. */
 	if (!space || (type == OS_FILE_READ && space->stop_new_ops)) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
+
+		if (sys_mutex_owned) {
+			mutex_exit(&fil_system->mutex);
+		}
 
 		ut_print_timestamp(stderr);
 		fprintf(stderr,
@@ -4598,14 +4728,6 @@ fil_io(
 		return(DB_TABLESPACE_DELETED);
 	}
 
-	if (type == OS_FILE_READ) {
-		space->stat.n_read++;
-		space->stat.n_data_read+= len;
-	} else if (type == OS_FILE_WRITE) {
-		space->stat.n_wrtn++;
-		space->stat.n_data_wrtn+= len;
-	}
-
 	ut_ad((mode != OS_AIO_IBUF) || (space->purpose == FIL_TABLESPACE));
 
 	node = UT_LIST_GET_FIRST(space->chain);
@@ -4635,6 +4757,28 @@ fil_io(
 		}
 	}
 
+	if (!sys_mutex_owned && (!node->open || space->stop_ios)) {
+		/* Opening the file, or waiting for the rename of the
+		file to complete, requires the fil_system mutex, which
+		must be acquired before the shard mutex */
+		mutex_exit(&shard->mutex);
+
+		fil_mutex_enter_and_prepare_for_io(space_id);
+		sys_mutex_owned = TRUE;
+
+		mutex_enter(&shard->mutex);
+
+		goto retry;
+	}
+
+	if (type == OS_FILE_READ) {
+		space->stat.n_read++;
+		space->stat.n_data_read+= len;
+	} else if (type == OS_FILE_WRITE) {
+		space->stat.n_wrtn++;
+		space->stat.n_data_wrtn+= len;
+	}
+
 	/* Open file if closed */
 	fil_node_prepare_for_io(node, fil_system, space);
 
@@ -4651,7 +4795,11 @@ fil_io(
 	}
 
 	/* Now we have made the changes in the data structures of fil_system */
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
+
+	if (sys_mutex_owned) {
+		mutex_exit(&fil_system->mutex);
+	}
 
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
@@ -4705,11 +4853,11 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
+		mutex_enter(&shard->mutex);
 
-		fil_node_complete_io(node, fil_system, type);
+		fil_node_complete_io(node, shard, type);
 
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		ut_ad(fil_validate_skip());
 	}
@@ -4732,11 +4880,19 @@ fil_aio_wait(
 {
 	ibool		ret;
 	fil_node_t*	fil_node;
+	fil_shard_t*	shard;
 	void*		message;
 	ulint		type;
 
 	ut_ad(fil_validate_skip());
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		srv_set_io_thread_op_info(segment, "io_uring handle");
+		ret = os_aio_uring_handle(segment, &fil_node,
+					  &message, &type);
+	} else
+#endif /* LINUX_IO_URING */
 	if (srv_use_native_aio) {
 		srv_set_io_thread_op_info(segment, "native aio handle");
 #ifdef WIN_ASYNC_IO
@@ -4764,11 +4920,13 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
+	shard = fil_shard_get(fil_node->space->id);
 
-	fil_node_complete_io(fil_node, fil_system, type);
+	mutex_enter(&shard->mutex);
 
-	mutex_exit(&fil_system->mutex);
+	fil_node_complete_io(fil_node, shard, type);
+
+	mutex_exit(&shard->mutex);
 
 	ut_ad(fil_validate_skip());
 
@@ -4802,13 +4960,14 @@ fil_flush(
 	fil_node_t*	node;
 	os_file_t	file;
 	ib_int64_t	old_mod_counter;
+	fil_shard_t*	shard	= fil_shard_get(space_id);
 
-	mutex_enter(&fil_system->mutex);
+	mutex_enter(&shard->mutex);
 
 	space = fil_space_get_by_id(space_id);
 
 	if (!space || space->stop_new_ops) {
-		mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
 		return;
 	}
@@ -4826,10 +4985,13 @@ fil_flush(
 			old_mod_counter = node->modification_counter;
 
 			if (space->purpose == FIL_TABLESPACE) {
-				fil_n_pending_tablespace_flushes++;
+				os_atomic_increment_ulint(
+					&fil_n_pending_tablespace_flushes, 1);
 			} else {
-				fil_n_pending_log_flushes++;
-				fil_n_log_flushes++;
+				os_atomic_increment_ulint(
+					&fil_n_pending_log_flushes, 1);
+				os_atomic_increment_ulint(
+					&fil_n_log_flushes, 1);
 			}
 #ifdef __WIN__
 			if (node->is_raw_disk) {
@@ -4844,11 +5006,11 @@ retry:
 				not know what bugs OS's may contain in file
 				i/o; sleep for a while */
 
-				mutex_exit(&fil_system->mutex);
+				mutex_exit(&shard->mutex);
 
 				os_thread_sleep(20000);
 
-				mutex_enter(&fil_system->mutex);
+				mutex_enter(&shard->mutex);
 
 				if (node->flush_counter >= old_mod_counter) {
 
@@ -4863,14 +5025,14 @@ retry:
 			node->n_pending_flushes++;
 			space->stat.n_flush++;
 
-			mutex_exit(&fil_system->mutex);
+			mutex_exit(&shard->mutex);
 
 			/* fprintf(stderr, "Flushing to file %s\n",
 			node->name); */
 
 			os_file_flush(file);
 
-			mutex_enter(&fil_system->mutex);
+			mutex_enter(&shard->mutex);
 
 			node->n_pending_flushes--;
 skip_flush:
@@ -4884,15 +5046,17 @@ skip_flush:
 
 					UT_LIST_REMOVE(
 						unflushed_spaces,
-						fil_system->unflushed_spaces,
+						shard->unflushed_spaces,
 						space);
 				}
 			}
 
 			if (space->purpose == FIL_TABLESPACE) {
-				fil_n_pending_tablespace_flushes--;
+				os_atomic_increment_ulint(
+					&fil_n_pending_tablespace_flushes, -1);
 			} else {
-				fil_n_pending_log_flushes--;
+				os_atomic_increment_ulint(
+					&fil_n_pending_log_flushes, -1);
 			}
 		}
 
@@ -4901,7 +5065,7 @@ skip_flush:
 
 	space->n_pending_flushes--;
 
-	mutex_exit(&fil_system->mutex);
+	mutex_exit(&shard->mutex);
 }
 
 /**********************************************************************//**
@@ -4913,48 +5077,55 @@ fil_flush_file_spaces(
 /*==================*/
 	ulint	purpose)	/*!< in: FIL_TABLESPACE, FIL_LOG */
 {
-	fil_space_t*	space;
-	ulint*		space_ids;
-	ulint		n_space_ids;
-	ulint		i;
+	ulint	i;
 
-	mutex_enter(&fil_system->mutex);
+	for (i = 0; i < FIL_N_SHARDS; i++) {
+		fil_shard_t*	shard	= &fil_system->shards[i];
+		fil_space_t*	space;
+		ulint*		space_ids;
+		ulint		n_space_ids;
+		ulint		j;
 
-	n_space_ids = UT_LIST_GET_LEN(fil_system->unflushed_spaces);
-	if (n_space_ids == 0) {
+		mutex_enter(&shard->mutex);
 
-		mutex_exit(&fil_system->mutex);
-		return;
-	}
+		n_space_ids = UT_LIST_GET_LEN(shard->unflushed_spaces);
+		if (n_space_ids == 0) {
+
+			mutex_exit(&shard->mutex);
+			continue;
+		}
 
-	/* Assemble a list of space ids to flush.  Previously, we
-	traversed fil_system->unflushed_spaces and called UT_LIST_GET_NEXT()
-	on a space that was just removed from the list by fil_flush().
-	Thus, the space could be dropped and the memory overwritten. */
-	space_ids = mem_alloc(n_space_ids * sizeof *space_ids);
+		/* Assemble a list of space ids to flush.  Previously, we
+		traversed the unflushed_spaces list and called
+		UT_LIST_GET_NEXT() on a space that was just removed from
+		the list by fil_flush().  Thus, the space could be dropped
+		and the memory overwritten. */
+		space_ids = mem_alloc(n_space_ids * sizeof *space_ids);
 
-	n_space_ids = 0;
+		n_space_ids = 0;
 
-	for (space = UT_LIST_GET_FIRST(fil_system->unflushed_spaces);
-	     space;
-	     space = UT_LIST_GET_NEXT(unflushed_spaces, space)) {
+		for (space = UT_LIST_GET_FIRST(shard->unflushed_spaces);
+		     space;
+		     space = UT_LIST_GET_NEXT(unflushed_spaces, space)) {
 
-		if (space->purpose == purpose && !space->stop_new_ops) {
+			if (space->purpose == purpose
+			    && !space->stop_new_ops) {
 
-			space_ids[n_space_ids++] = space->id;
+				space_ids[n_space_ids++] = space->id;
+			}
 		}
-	}
 
-	mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
 
-	/* Flush the spaces.  It will not hurt to call fil_flush() on
-	a non-existing space id. */
-	for (i = 0; i < n_space_ids; i++) {
+		/* Flush the spaces.  It will not hurt to call fil_flush()
+		on a non-existing space id. */
+		for (j = 0; j < n_space_ids; j++) {
 
-		fil_flush(space_ids[i]);
-	}
+			fil_flush(space_ids[j]);
+		}
 
-	mem_free(space_ids);
+		mem_free(space_ids);
+	}
 }
 
 /******************************************************************//**
@@ -4969,51 +5140,65 @@ fil_validate(void)
 	fil_node_t*	fil_node;
 	ulint		n_open		= 0;
 	ulint		i;
+	ulint		j;
 
 	mutex_enter(&fil_system->mutex);
 
-	/* Look for spaces in the hash table */
+	for (j = 0; j < FIL_N_SHARDS; j++) {
+		fil_shard_t*	shard	= &fil_system->shards[j];
 
-	for (i = 0; i < hash_get_n_cells(fil_system->spaces); i++) {
+		mutex_enter(&shard->mutex);
 
-		space = HASH_GET_FIRST(fil_system->spaces, i);
+		/* Look for spaces in the hash table */
 
-		while (space != NULL) {
-			UT_LIST_VALIDATE(chain, fil_node_t, space->chain,
-					 ut_a(ut_list_node_313->open
-					      || !ut_list_node_313->n_pending));
+		for (i = 0; i < hash_get_n_cells(shard->spaces); i++) {
 
-			fil_node = UT_LIST_GET_FIRST(space->chain);
+			space = HASH_GET_FIRST(shard->spaces, i);
 
-			while (fil_node != NULL) {
-				if (fil_node->n_pending > 0) {
-					ut_a(fil_node->open);
-				}
+			while (space != NULL) {
+				ut_a(fil_shard_get(space->id) == shard);
+
+				UT_LIST_VALIDATE(
+					chain, fil_node_t, space->chain,
+					ut_a(ut_list_node_313->open
+					     || !ut_list_node_313->n_pending));
 
-				if (fil_node->open) {
-					n_open++;
+				fil_node = UT_LIST_GET_FIRST(space->chain);
+
+				while (fil_node != NULL) {
+					if (fil_node->n_pending > 0) {
+						ut_a(fil_node->open);
+					}
+
+					if (fil_node->open) {
+						n_open++;
+					}
+					fil_node = UT_LIST_GET_NEXT(
+						chain, fil_node);
 				}
-				fil_node = UT_LIST_GET_NEXT(chain, fil_node);
+				space = HASH_GET_NEXT(hash, space);
 			}
-			space = HASH_GET_NEXT(hash, space);
 		}
-	}
 
-	ut_a(fil_system->n_open == n_open);
+		UT_LIST_VALIDATE(LRU, fil_node_t, shard->LRU, (void) 0);
 
-	UT_LIST_VALIDATE(LRU, fil_node_t, fil_system->LRU, (void) 0);
+		fil_node = UT_LIST_GET_FIRST(shard->LRU);
 
-	fil_node = UT_LIST_GET_FIRST(fil_system->LRU);
+		while (fil_node != NULL) {
+			ut_a(fil_node->n_pending == 0);
+			ut_a(fil_node->open);
+			ut_a(fil_node->space->purpose == FIL_TABLESPACE);
+			ut_a(fil_node->space->id != 0);
+			ut_a(fil_shard_get(fil_node->space->id) == shard);
 
-	while (fil_node != NULL) {
-		ut_a(fil_node->n_pending == 0);
-		ut_a(fil_node->open);
-		ut_a(fil_node->space->purpose == FIL_TABLESPACE);
-		ut_a(fil_node->space->id != 0);
+			fil_node = UT_LIST_GET_NEXT(LRU, fil_node);
+		}
 
-		fil_node = UT_LIST_GET_NEXT(LRU, fil_node);
+		mutex_exit(&shard->mutex);
 	}
 
+	ut_a(fil_system->n_open == n_open);
+
 	mutex_exit(&fil_system->mutex);
 
 	return(TRUE);
@@ -5091,17 +5276,24 @@ void
 fil_close(void)
 /*===========*/
 {
+	ulint	i;
+
 #ifndef UNIV_HOTBACKUP
 	/* The mutex should already have been freed. */
 	ut_ad(fil_system->mutex.magic_n == 0);
 #endif /* !UNIV_HOTBACKUP */
 
-	hash_table_free(fil_system->spaces);
+	for (i = 0; i < FIL_N_SHARDS; i++) {
+		fil_shard_t*	shard	= &fil_system->shards[i];
+
+		hash_table_free(shard->spaces);
+
+		ut_a(UT_LIST_GET_LEN(shard->LRU) == 0);
+		ut_a(UT_LIST_GET_LEN(shard->unflushed_spaces) == 0);
+	}
 
 	hash_table_free(fil_system->name_hash);
 
-	ut_a(UT_LIST_GET_LEN(fil_system->LRU) == 0);
-	ut_a(UT_LIST_GET_LEN(fil_system->unflushed_spaces) == 0);
 	ut_a(UT_LIST_GET_LEN(fil_system->space_list) == 0);
 
 	mem_free(fil_system);
@@ -5193,12 +5385,16 @@ fil_get_space_stat(
 	fil_space_t*	space;
 	ulint		count = 0;
 
-	mutex_enter(&fil_system->mutex);
-
 	while (size--) {
-		space = fil_space_get_by_id(*space_ids++);
+		ulint		id	= *space_ids++;
+		fil_shard_t*	shard	= fil_shard_get(id);
+
+		mutex_enter(&shard->mutex);
+
+		space = fil_space_get_by_id(id);
 
 		if (space == NULL) {
+			mutex_exit(&shard->mutex);
 			continue;
 		}
 
@@ -5207,9 +5403,9 @@ fil_get_space_stat(
 		stat->space_id = space->id;
 		count++;
 		stat++;
-	}
 
-	mutex_exit(&fil_system->mutex);
+		mutex_exit(&shard->mutex);
+	}
 
 	return(count);
 }
@@ -1026,6 +1026,41 @@ fsp_header_get_zip_size(
 }
 
 #ifndef UNIV_HOTBACKUP
+/**********************************************************************//**
+Checks if a page is free according to the extent descriptor page that
+describes it. This is used on tablespace files that are not open, such
+as in IMPORT TABLESPACE, where the descriptor page is not in the buffer
+pool.
+@return	TRUE if the page is free */
+UNIV_INTERN
+ibool
+fsp_descr_page_is_free(
+/*===================*/
+	const page_t*	descr_page,	/*!< in: extent descriptor page
+					describing page_no */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes; 0 for uncompressed pages */
+	ulint		page_no)	/*!< in: page number */
+{
+	const xdes_t*	descr;
+	ulint		index;
+
+	descr = descr_page + XDES_ARR_OFFSET
+		+ XDES_SIZE * xdes_calc_descriptor_index(zip_size, page_no);
+
+	if (!mach_read_from_4(descr + XDES_STATE)) {
+		/* The descriptor has not been initialized: the extent
+		is above the free limit of the space. */
+
+		return(TRUE);
+	}
+
+	index = XDES_FREE_BIT
+		+ XDES_BITS_PER_PAGE * (page_no % FSP_EXTENT_SIZE);
+
+	return(ut_bit_get_nth(descr[XDES_BITMAP + index / 8], index % 8));
+}
+
 /**********************************************************************//**
 Increases the space size field of a space. */
 UNIV_INTERN
@@ -78,6 +78,7 @@ extern "C" {
 #include "os0thread.h"
 #include "srv0start.h"
 #include "srv0srv.h"
+#include "srv0mon.h"
 #include "trx0roll.h"
 #include "trx0trx.h"
 #include "trx0sys.h"
@@ -89,6 +90,7 @@ extern "C" {
 #include "log0log.h"
 #include "lock0lock.h"
 #include "dict0crea.h"
+#include "dict0stats.h"
 #include "btr0cur.h"
 #include "btr0btr.h"
 #include "fsp0fsp.h"
@@ -96,6 +98,8 @@ extern "C" {
 #include "fil0fil.h"
 #include "trx0xa.h"
 #include "row0merge.h"
+#include "row0import.h"
+#include "row0quiesce.h"
 #include "dict0boot.h"
 #include "ha_prototypes.h"
 #include "ut0mem.h"
@@ -168,6 +172,10 @@ static char*	innobase_data_file_path			= NULL;
 static char*	innobase_log_group_home_dir		= NULL;
 static char*	innobase_file_format_name		= NULL;
 static char*	innobase_change_buffering		= NULL;
+static char*	innobase_monitor_enable			= NULL;
+static char*	innobase_monitor_disable		= NULL;
+static char*	innobase_monitor_reset			= NULL;
+static char*	innobase_monitor_reset_all		= NULL;
 
 /* The highest file format being used in the database. The value can be
 set by user, however, it will be adjusted to the newer file format if
@@ -218,6 +226,22 @@ static TYPELIB innodb_stats_method_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_lock_schedule_algorithm",
+in the order of srv_lock_schedule_enum */
+static const char* innodb_lock_schedule_algorithm_names[] = {
+	"fcfs",
+	"oldest",
+	"most_locks",
+	NullS
+};
+
+static TYPELIB innodb_lock_schedule_algorithm_typelib = {
+	array_elements(innodb_lock_schedule_algorithm_names) - 1,
+	"innodb_lock_schedule_algorithm_typelib",
+	innodb_lock_schedule_algorithm_names,
+	NULL
+};
+
 /** List of values for system variable "innodb_index_page_split_mode". */
 static const char* innodb_index_page_split_mode_names[] = {
 	"symmetric",
@@ -226,6 +250,14 @@ static const char* innodb_index_page_split_mode_names[] = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_compression_codec" */
+static TYPELIB innodb_compression_codec_typelib = {
+	PAGE_ZIP_N_CODECS,
+	"innodb_compression_codec_typelib",
+	page_zip_codec_names,
+	NULL
+};
+
 static TYPELIB innodb_index_page_split_mode_typelib = {
 	array_elements(innodb_index_page_split_mode_names) - 1,
 	"innodb_index_page_split_mode_typelib",
@@ -286,8 +318,10 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&cache_last_read_mutex_key, "cache_last_read_mutex", 0},
 	{&dict_foreign_err_mutex_key, "dict_foreign_err_mutex", 0},
 	{&dict_sys_mutex_key, "dict_sys_mutex", 0},
+	{&dict_stats_queue_mutex_key, "dict_stats_queue_mutex", 0},
 	{&file_format_max_mutex_key, "file_format_max_mutex", 0},
 	{&fil_system_mutex_key, "fil_system_mutex", 0},
+	{&fil_shard_mutex_key, "fil_shard_mutex", 0},
 	{&flush_list_mutex_key, "flush_list_mutex", 0},
 	{&log_flush_order_mutex_key, "log_flush_order_mutex", 0},
 	{&hash_table_mutex_key, "hash_table_mutex", 0},
@@ -308,11 +342,13 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 #  ifdef UNIV_SYNC_DEBUG
 	{&rw_lock_debug_mutex_key, "rw_lock_debug_mutex", 0},
 #  endif /* UNIV_SYNC_DEBUG */
+	{&row_import_mutex_key, "row_import_mutex", 0},
 	{&rw_lock_list_mutex_key, "rw_lock_list_mutex", 0},
 	{&rw_lock_mutex_key, "rw_lock_mutex", 0},
 	{&srv_dict_tmpfile_mutex_key, "srv_dict_tmpfile_mutex", 0},
 	{&srv_innodb_monitor_mutex_key, "srv_innodb_monitor_mutex", 0},
 	{&srv_misc_tmpfile_mutex_key, "srv_misc_tmpfile_mutex", 0},
+	{&srv_mon_mutex_key, "srv_mon_mutex", 0},
 	{&srv_monitor_file_mutex_key, "srv_monitor_file_mutex", 0},
 	{&syn_arr_mutex_key, "syn_arr_mutex", 0},
 #  ifdef UNIV_SYNC_DEBUG
@@ -340,6 +376,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 #  endif /* UNIV_SYNC_DEBUG */
 	{&dict_operation_lock_key, "dict_operation_lock", 0},
 	{&fil_space_latch_key, "fil_space_latch", 0},
+	{&ibuf_index_counts_latch_key, "ibuf_index_counts_latch", 0},
 	{&checkpoint_lock_key, "checkpoint_lock", 0},
 	{&trx_i_s_cache_lock_key, "trx_i_s_cache_lock", 0},
 	{&trx_purge_latch_key, "trx_purge_latch", 0},
@@ -359,7 +396,12 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&srv_error_monitor_thread_key, "srv_error_monitor_thread", 0},
 	{&srv_monitor_thread_key, "srv_monitor_thread", 0},
 	{&srv_master_thread_key, "srv_master_thread", 0},
-	{&srv_purge_thread_key, "srv_purge_thread", 0}
+	{&srv_purge_thread_key, "srv_purge_thread", 0},
+	{&dict_stats_thread_key, "dict_stats_thread", 0},
+	{&log_flush_thread_key, "log_flush_thread", 0},
+	{&buf_resize_thread_key, "buf_resize_thread", 0},
+	{&ibuf_merge_thread_key, "ibuf_merge_thread", 0},
+	{&row_import_thread_key, "row_import_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -407,6 +449,16 @@ void
 innobase_commit_concurrency_init_default(void);
 /*==========================================*/
 
+/*************************************************************//**
+Turn on the monitor counters listed in innodb_monitor_enable at startup.
+The list is separated by commas, semicolons or spaces.  Names that do
+not match any counter are reported and ignored. */
+static
+void
+innodb_enable_monitor_at_startup(
+/*=============================*/
+	const char*	str);	/*!< in: value of innodb_monitor_enable */
+
 /************************************************************//**
 Validate the file format name and return its corresponding id.
 @return	valid file format id */
@@ -568,10 +620,61 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 1, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_ULONG(logical_read_ahead, PLUGIN_VAR_RQCMDARG,
+  "Number of leaf pages that index scans read ahead in key order, "
+  "looked up on the parent page of the current leaf page. "
+  "0 disables the logical read-ahead.",
+  NULL, NULL, 0, 0, 1024, 0);
+
 static MYSQL_THDVAR_SET(index_page_split_mode, PLUGIN_VAR_RQCMDARG,
   "Index page split behavior.", NULL, innodb_index_page_split_mode_update,
   0, &innodb_index_page_split_mode_typelib);
 
+static MYSQL_THDVAR_ENUM(compression_codec, PLUGIN_VAR_RQCMDARG,
+  "Page compression codec of ROW_FORMAT=COMPRESSED tables being created: "
+  "zlib at innodb_compression_level, lz (fast LZ77) or none. "
+  "It is stored in the tablespace.",
+  NULL, NULL, PAGE_ZIP_CODEC_ZLIB, &innodb_compression_codec_typelib);
+
+static MYSQL_THDVAR_UINT(compression_level, PLUGIN_VAR_RQCMDARG,
+  "zlib compression level of ROW_FORMAT=COMPRESSED tables being created "
+  "with innodb_compression_codec=zlib: 1 is the fastest, 9 the smallest.",
+  NULL, NULL, 6, 1, 9, 0);
+
+static MYSQL_THDVAR_BOOL(async_commit, PLUGIN_VAR_OPCMDARG,
+  "With innodb_flush_log_at_trx_commit=1, write the log at commit but "
+  "leave flushing it to the log flush thread (see innodb_flush_log_interval "
+  "and innodb_flush_log_up_to).",
+  NULL, NULL, FALSE);
+
+/****************************************************************//**
+Flushes the log to disk up to the lsn that innodb_flush_log_up_to is
+being set to, and stores the lsn. */
+static
+void
+innodb_flush_log_up_to_update(
+/*==========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	ulonglong	lsn = *static_cast<const ulonglong*>(save);
+
+	*static_cast<ulonglong*>(var_ptr) = lsn;
+
+	log_flush_up_to(lsn);
+}
+
+static MYSQL_THDVAR_ULONGLONG(flush_log_up_to, PLUGIN_VAR_RQCMDARG,
+  "Setting this waits until the log is flushed to disk up to the given "
+  "log sequence number, e.g. Innodb_last_commit_lsn after an "
+  "asynchronous commit.",
+  NULL, innodb_flush_log_up_to_update, 0, 0, ~0ULL, 0);
+
 static handler *innobase_create_handler(handlerton *hton,
                                         TABLE_SHARE *table,
                                         MEM_ROOT *mem_root)
@@ -749,7 +852,22 @@ innobase_commit_low(
 /*================*/
 	trx_t*	trx);	/*!< in: transaction handle */
 
+/*********************************************************************//**
+Returns the lsn of the last commit of the transaction of a connection
+that wrote log records, as Innodb_last_commit_lsn. */
+static
+int
+show_innodb_last_commit_lsn(
+/*========================*/
+	THD*		thd,	/*!< in: connection */
+	SHOW_VAR*	var,	/*!< out: status variable */
+	char*		buff);	/*!< out: buffer for the value */
+
 static SHOW_VAR innodb_status_variables[]= {
+  {"autoinc_values_reserved",
+  (char*) &export_vars.innodb_autoinc_values_reserved,	  SHOW_LONG},
+  {"autoinc_values_unused",
+  (char*) &export_vars.innodb_autoinc_values_unused,	  SHOW_LONG},
   {"buffer_pool_LRU_search_scanned",
   (char*) &export_vars.innodb_buffer_pool_LRU_search_scanned,	SHOW_LONG},
   {"buffer_pool_LRU_unzip_search_scanned",
@@ -796,12 +914,22 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_pages_misc,	  SHOW_LONG},
   {"buffer_pool_pages_total",
   (char*) &export_vars.innodb_buffer_pool_pages_total,	  SHOW_LONG},
+  {"buffer_pool_resize_status",
+  (char*) export_vars.innodb_buffer_pool_resize_status,	  SHOW_CHAR},
   {"buffer_pool_read_ahead_rnd",
   (char*) &export_vars.innodb_buffer_pool_read_ahead_rnd, SHOW_LONG},
   {"buffer_pool_read_ahead",
   (char*) &export_vars.innodb_buffer_pool_read_ahead,	  SHOW_LONG},
   {"buffer_pool_read_ahead_evicted",
   (char*) &export_vars.innodb_buffer_pool_read_ahead_evicted, SHOW_LONG},
+  {"buffer_pool_read_ahead_logical",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical, SHOW_LONG},
+  {"buffer_pool_read_ahead_logical_hits",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical_hits,
+  SHOW_LONG},
+  {"buffer_pool_read_ahead_logical_evicted",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical_evicted,
+  SHOW_LONG},
   {"buffer_pool_read_requests",
   (char*) &export_vars.innodb_buffer_pool_read_requests,  SHOW_LONG},
   {"buffer_pool_reads",
@@ -860,6 +988,16 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_ibuf_merged_pages,	  SHOW_LONG},
   {"ibuf_pages",
   (char*) &export_vars.innodb_ibuf_pages,		  SHOW_LONG},
+  {"last_commit_lsn",
+  (char*) &show_innodb_last_commit_lsn,			  SHOW_FUNC},
+  {"lock_deadlock_check_aborts",
+  (char*) &export_vars.innodb_lock_deadlock_check_aborts, SHOW_LONG},
+  {"lock_deadlock_check_max_steps",
+  (char*) &export_vars.innodb_lock_deadlock_check_max_steps, SHOW_LONG},
+  {"lock_deadlock_check_steps",
+  (char*) &export_vars.innodb_lock_deadlock_check_steps,  SHOW_LONG},
+  {"lock_deadlock_checks",
+  (char*) &export_vars.innodb_lock_deadlock_checks,	  SHOW_LONG},
   {"lock_deadlocks",
   (char*) &export_vars.innodb_lock_deadlocks,		  SHOW_LONG},
   {"log_waits",
@@ -918,18 +1056,34 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_row_lock_time_max,	  SHOW_LONG},
   {"row_lock_waits",
   (char*) &export_vars.innodb_row_lock_waits,		  SHOW_LONG},
+  {"row_lock_waits_under_1ms",
+  (char*) &export_vars.innodb_row_lock_wait_hist[0],	  SHOW_LONG},
+  {"row_lock_waits_under_10ms",
+  (char*) &export_vars.innodb_row_lock_wait_hist[1],	  SHOW_LONG},
+  {"row_lock_waits_under_100ms",
+  (char*) &export_vars.innodb_row_lock_wait_hist[2],	  SHOW_LONG},
+  {"row_lock_waits_under_1s",
+  (char*) &export_vars.innodb_row_lock_wait_hist[3],	  SHOW_LONG},
+  {"row_lock_waits_under_10s",
+  (char*) &export_vars.innodb_row_lock_wait_hist[4],	  SHOW_LONG},
+  {"row_lock_waits_over_10s",
+  (char*) &export_vars.innodb_row_lock_wait_hist[5],	  SHOW_LONG},
   {"rows_deleted",
   (char*) &export_vars.innodb_rows_deleted,		  SHOW_LONG},
   {"rows_inserted",
   (char*) &export_vars.innodb_rows_inserted,		  SHOW_LONG},
   {"rows_read",
   (char*) &export_vars.innodb_rows_read,		  SHOW_LONG},
+  {"rows_read_cached",
+  (char*) &export_vars.innodb_rows_read_cached,		  SHOW_LONG},
   {"rows_updated",
   (char*) &export_vars.innodb_rows_updated,		  SHOW_LONG},
   {"rows_search_btree_index",
   (char*) &export_vars.innodb_btree_row_searches,         SHOW_LONG},
   {"rows_search_hash_index",
   (char*) &export_vars.innodb_hash_row_searches,       	  SHOW_LONG},
+  {"rows_search_btree_restarts",
+  (char*) &export_vars.innodb_btree_search_restarts,	  SHOW_LONG},
   {"semaphore_stalls",
   (char*) &export_vars.innodb_semaphore_stalls,		  SHOW_LONG},
   {"tablespace_files_open",
@@ -1081,6 +1235,22 @@ thd_lock_wait_timeout(
 	return(THDVAR((THD*) thd, lock_wait_timeout));
 }
 
+/******************************************************************//**
+Returns the number of leaf pages to read ahead in index scans of the
+current connection.
+@return	innodb_logical_read_ahead, or 0 if disabled */
+extern "C" UNIV_INTERN
+ulint
+thd_logical_read_ahead(
+/*===================*/
+	void*	thd)	/*!< in: thread handle (THD*), or NULL to query
+			the global innodb_logical_read_ahead */
+{
+	/* According to <mysql/plugin.h>, passing thd == NULL
+	returns the global value of the session variable. */
+	return(THDVAR((THD*) thd, logical_read_ahead));
+}
+
 /******************************************************************//**
 Get the set of flags specified in innodb_index_page_split_mode.
 @return	set of flags that are set */
@@ -1359,7 +1529,10 @@ convert_error_code_to_mysql(
 	case DB_OUT_OF_MEMORY:
 		return(HA_ERR_OUT_OF_MEM);
 	case DB_IDENTIFIER_TOO_LONG:
+	case DB_IO_ERROR:
 		return(HA_ERR_INTERNAL_ERROR);
+	case DB_SCHEMA_MISMATCH:
+		return(HA_ERR_TABLE_DEF_CHANGED);
 	}
 }
 
@@ -1960,7 +2133,7 @@ ha_innobase::ha_innobase(handlerton *hton, TABLE_SHARE *table_arg)
 		  HA_PRIMARY_KEY_IN_READ_INDEX |
 		  HA_BINLOG_ROW_CAPABLE |
 		  HA_CAN_GEOMETRY | HA_PARTIAL_COLUMN_READ |
-		  HA_TABLE_SCAN_ON_INDEX),
+		  HA_TABLE_SCAN_ON_INDEX | HA_CAN_EXPORT),
   start_of_scan(0),
   num_write_row(0)
 {}
@@ -2417,6 +2590,21 @@ trx_is_strict(
 	       && THDVAR((THD*) trx->mysql_thd, strict_mode));
 }
 
+/**********************************************************************//**
+Determines if the currently running transaction commits asynchronously,
+that is, writes but does not flush the log at commit although
+innodb_flush_log_at_trx_commit=1.
+@return	TRUE if innodb_async_commit is set for the transaction */
+extern "C" UNIV_INTERN
+ibool
+trx_is_async_commit(
+/*================*/
+	trx_t*	trx)	/*!< in: transaction */
+{
+	return(trx && trx->mysql_thd
+	       && THDVAR((THD*) trx->mysql_thd, async_commit));
+}
+
 /**************************************************************//**
 Resets some fields of a prebuilt struct. The template is used in fast
 retrieval of just those column values MySQL needs in its processing. */
@@ -2972,9 +3160,24 @@ innobase_change_buffering_inited_ok:
 #endif /* UNIV_LOG_ARCHIVE */
 	srv_log_buffer_size = (ulint) innobase_log_buffer_size;
 
-	srv_buf_pool_size = (ulint) innobase_buffer_pool_size;
 	srv_buf_pool_instances = (ulint) innobase_buffer_pool_instances;
 
+	/* A small buffer pool is made of one chunk per instance. */
+	if ((ulonglong) srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > (ulonglong) innobase_buffer_pool_size) {
+		srv_buf_pool_chunk_unit = ut_max(
+			(ulong) (innobase_buffer_pool_size
+				 / srv_buf_pool_instances)
+			/ (1024 * 1024) * (1024 * 1024),
+			1024 * 1024);
+	}
+
+	/* The buffer pool is resized in chunks, and its size is a
+	multiple of innodb_buffer_pool_chunk_size * instances. */
+	srv_buf_pool_size = buf_pool_size_align(
+		(ulint) innobase_buffer_pool_size);
+	innobase_buffer_pool_size = (long long) srv_buf_pool_size;
+
 	srv_mem_pool_size = (ulint) innobase_additional_mem_pool_size;
 
 	srv_n_file_io_threads = (ulint) innobase_file_io_threads;
@@ -2995,6 +3198,20 @@ innobase_change_buffering_inited_ok:
 
 	srv_locks_unsafe_for_binlog = (ibool) innobase_locks_unsafe_for_binlog;
 
+	if (innobase_autoinc_lock_mode == AUTOINC_NO_LOCKING
+	    && opt_bin_log
+	    && global_system_variables.binlog_format != BINLOG_FORMAT_ROW) {
+		/* Concurrent inserts get interleaved intervals, while
+		a statement-based binlog only records the first value. */
+		sql_print_warning("InnoDB: innodb_autoinc_lock_mode=2 is"
+				  " unsafe with binlog_format=%s: a slave"
+				  " may assign different AUTO_INCREMENT"
+				  " values.  Use binlog_format=ROW.",
+				  global_system_variables.binlog_format
+				  == BINLOG_FORMAT_MIXED
+				  ? "MIXED" : "STATEMENT");
+	}
+
 	srv_max_n_open_files = (ulint) innobase_open_files;
 	srv_innodb_status = (ibool) innobase_create_status_file;
 
@@ -3074,6 +3291,12 @@ innobase_change_buffering_inited_ok:
 		innobase_do_overwrite_relay_log_info();
 	}
 
+	/* Turn on the monitor counters that were requested in the
+	configuration file or on the command line. */
+	if (innobase_monitor_enable) {
+		innodb_enable_monitor_at_startup(innobase_monitor_enable);
+	}
+
 	innobase_old_blocks_pct = buf_LRU_old_ratio_update(
 		innobase_old_blocks_pct, TRUE);
 
@@ -3230,7 +3453,7 @@ setup_and_prefetch_pages(
 	}
 
 	/* Prevent the tablespace from being deleted while prefetching pages. */
-	if (fil_inc_pending_ops(space)) {
+	if (fil_inc_pending_ops(space, TRUE)) {
 		my_error(ER_HTON_CONTROL_INVALID_ARGUMENT, MYF(0));
 		return(-1);
 	}
@@ -3820,8 +4043,8 @@ ha_innobase::get_row_type() const
 			} else {
 				return(ROW_TYPE_DYNAMIC);
 			}
-#if DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_MAX
-# error "DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_MAX"
+#if DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_TABLE_MAX
+# error "DICT_TF_FORMAT_ZIP != DICT_TF_FORMAT_TABLE_MAX"
 #endif
 		}
 	}
@@ -3842,9 +4065,15 @@ ha_innobase::table_flags() const
        /* Need to use tx_isolation here since table flags is (also)
           called before prebuilt is inited. */
         ulong const tx_isolation = thd_tx_isolation(ha_thd());
+        Table_flags flags = int_table_flags;
+
+        /* Only ask for the range buffer when a disk-sweep
+        multi-range read may use it. */
+        if (DsMrr_impl::enabled(ha_thd()))
+                flags |= HA_NEED_READ_RANGE_BUFFER;
         if (tx_isolation <= ISO_READ_COMMITTED)
-                return int_table_flags;
-        return int_table_flags | HA_BINLOG_STMT_CAPABLE;
+                return flags;
+        return flags | HA_BINLOG_STMT_CAPABLE;
 }
 
 /****************************************************************//**
@@ -3895,13 +4124,22 @@ UNIV_INTERN
 ulong
 ha_innobase::index_flags(
 /*=====================*/
-	uint,
+	uint	key,
 	uint,
 	bool)
 const
 {
-	return(HA_READ_NEXT | HA_READ_PREV | HA_READ_ORDER
-	       | HA_READ_RANGE | HA_KEYREAD_ONLY);
+	ulong	flags = HA_READ_NEXT | HA_READ_PREV | HA_READ_ORDER
+		| HA_READ_RANGE | HA_KEYREAD_ONLY;
+
+	/* The records of the clustered index contain the whole row,
+	so there is nothing to gain from checking the pushed index
+	condition before the row is read. */
+	if (key != table_share->primary_key) {
+		flags |= HA_DO_INDEX_COND_PUSHDOWN;
+	}
+
+	return(flags);
 }
 
 /****************************************************************//**
@@ -3961,6 +4199,88 @@ ha_innobase::primary_key_is_clustered()
 	return(true);
 }
 
+/****************************************************************//**
+Accepts an index condition for a secondary index. row_search_for_mysql()
+checks it on the secondary index records through innobase_index_cond()
+and skips the records that do not match without looking up the clustered
+index record.
+@return	NULL, as the whole condition is checked */
+UNIV_INTERN
+Item*
+ha_innobase::idx_cond_push(
+/*=======================*/
+	uint	keyno,		/*!< in: index number */
+	Item*	idx_cond)	/*!< in: condition on the index columns */
+{
+	DBUG_ENTER("ha_innobase::idx_cond_push");
+	DBUG_ASSERT(keyno != MAX_KEY);
+	DBUG_ASSERT(idx_cond != NULL);
+
+	pushed_idx_cond = idx_cond;
+	pushed_idx_cond_keyno = keyno;
+
+	DBUG_RETURN(NULL);
+}
+
+/****************************************************************//**
+Reads the first row of a set of ranges. On a secondary index, the
+primary keys of the index records are collected and sorted, so that the
+clustered index records are looked up in key order (see DsMrr_impl).
+@return	0, HA_ERR_END_OF_FILE or error number */
+UNIV_INTERN
+int
+ha_innobase::read_multi_range_first(
+/*================================*/
+	KEY_MULTI_RANGE**	found_range_p,	/*!< out: range of the row */
+	KEY_MULTI_RANGE*	ranges,		/*!< in: ranges to read */
+	uint			range_count,	/*!< in: number of ranges */
+	bool			sorted,		/*!< in: whether the rows
+						must be in index order */
+	HANDLER_BUFFER*		buffer)		/*!< in: row id buffer */
+{
+	return(ds_mrr.read_first(found_range_p, ranges, range_count,
+				 sorted, buffer));
+}
+
+/****************************************************************//**
+Reads the next row of a set of ranges.
+@return	0, HA_ERR_END_OF_FILE or error number */
+UNIV_INTERN
+int
+ha_innobase::read_multi_range_next(
+/*===============================*/
+	KEY_MULTI_RANGE**	found_range_p)	/*!< out: range of the row */
+{
+	return(ds_mrr.read_next(found_range_p));
+}
+
+/****************************************************************//**
+Tells whether read_multi_range_first() reads the rows of an index in
+primary key order.
+@return	true if the clustered index records are read in key order */
+UNIV_INTERN
+bool
+ha_innobase::read_multi_range_sweeps(
+/*=================================*/
+	uint	keyno,	/*!< in: index number */
+	bool	sorted)	/*!< in: whether the rows must be in index order */
+{
+	return(ds_mrr.choose(keyno, sorted));
+}
+
+/****************************************************************//**
+Checks the index condition that was pushed to a handler on the index
+columns that row_search_for_mysql() has stored into the row buffer.
+@return	ICP_NO_MATCH, ICP_MATCH or ICP_OUT_OF_RANGE */
+extern "C" UNIV_INTERN
+enum icp_result
+innobase_index_cond(
+/*================*/
+	const void*	file)	/*!< in: ha_innobase handler */
+{
+	return(handler_index_cond_check((void*) file));
+}
+
 /** Always normalize table name to lower case on Windows */
 #ifdef __WIN__
 #define normalize_table_name(norm_name, name)		\
@@ -4793,7 +5113,7 @@ table_opened:
 
 		trx_sys_file_format_max_upgrade(
 			(const char**) &innobase_file_format_max,
-			dict_table_get_format(prebuilt->table));
+			dict_table_get_format_tag(prebuilt->table));
 	}
 
 	/* Only if the table has an AUTOINC column. */
@@ -4814,6 +5134,8 @@ table_opened:
 
 	info(HA_STATUS_NO_LOCK | HA_STATUS_VARIABLE | HA_STATUS_CONST);
 
+	ds_mrr.init(this, table);
+
 	DBUG_RETURN(0);
 }
 
@@ -4870,6 +5192,8 @@ ha_innobase::close(void)
 		innobase_release_temporary_latches(ht, thd);
 	}
 
+	ds_mrr.reset();
+
 	row_prebuilt_free(prebuilt, FALSE);
 
 	if (upd_buf != NULL) {
@@ -5449,6 +5773,7 @@ build_template(
 {
 	dict_index_t*	index;
 	dict_index_t*	clust_index;
+	dict_index_t*	icp_index;
 	mysql_row_templ_t* templ;
 	Field*		field;
 	ulint		n_fields;
@@ -5515,6 +5840,15 @@ build_template(
 		the clustered index */
 	}
 
+	/* The pushed index condition is checked on the records of the
+	secondary index that is searched, even if the template is built
+	on the clustered index. */
+	if (prebuilt->index != NULL && !dict_index_is_clust(prebuilt->index)) {
+		icp_index = prebuilt->index;
+	} else {
+		icp_index = NULL;
+	}
+
 	n_fields = (ulint)table->s->fields; /* number of columns */
 
 	if (!prebuilt->mysql_template) {
@@ -5526,6 +5860,7 @@ build_template(
 	prebuilt->null_bitmap_len = table->s->null_bytes;
 
 	prebuilt->templ_contains_blob = FALSE;
+	prebuilt->idx_cond = NULL;
 
 	/* Note that in InnoDB, i is the column number. MySQL calls columns
 	'fields'. */
@@ -5590,6 +5925,13 @@ include_field:
 			}
 		}
 
+		if (icp_index) {
+			templ->icp_rec_field_no = dict_index_get_nth_col_pos(
+				icp_index, i);
+		} else {
+			templ->icp_rec_field_no = ULINT_UNDEFINED;
+		}
+
 		if (field->null_ptr) {
 			templ->mysql_null_byte_offset =
 				(ulint) ((char*) field->null_ptr
@@ -5642,6 +5984,38 @@ skip_field:
 	}
 }
 
+/********************************************************************//**
+Determines the AUTOINC lock mode to use for the current statement.  In
+innodb_autoinc_lock_mode=1 the table AUTO-INC lock only serves to keep
+the values of a bulk insert (INSERT ... SELECT, LOAD DATA) consecutive,
+so that a statement-based binlog can replay them.  A bulk insert that is
+not binlogged in STATEMENT or MIXED format reserves its intervals as in
+innodb_autoinc_lock_mode=2, so that concurrent bulk inserts into the
+same table do not wait for each other.
+@return	AUTOINC_OLD_STYLE_LOCKING, AUTOINC_NEW_STYLE_LOCKING or
+AUTOINC_NO_LOCKING */
+static
+long
+innobase_autoinc_mode(
+/*==================*/
+	THD*	thd)	/*!< in: user thread handle */
+{
+	if (innobase_autoinc_lock_mode == AUTOINC_NEW_STYLE_LOCKING
+	    && thd_sql_command(thd) != SQLCOM_INSERT
+	    && thd_sql_command(thd) != SQLCOM_REPLACE) {
+
+		switch (thd_binlog_format(thd)) {
+		case BINLOG_FORMAT_UNSPEC:
+		case BINLOG_FORMAT_ROW:
+			return(AUTOINC_NO_LOCKING);
+		default:
+			break;
+		}
+	}
+
+	return(innobase_autoinc_lock_mode);
+}
+
 /********************************************************************//**
 This special handling is really to overcome the limitations of MySQL's
 binlogging. We need to eliminate the non-determinism that will arise in
@@ -5656,7 +6030,7 @@ ha_innobase::innobase_lock_autoinc(void)
 {
 	ulint		error = DB_SUCCESS;
 
-	switch (innobase_autoinc_lock_mode) {
+	switch (innobase_autoinc_mode(user_thd)) {
 	case AUTOINC_NO_LOCKING:
 		/* Acquire only the AUTOINC mutex. */
 		dict_table_autoinc_lock(prebuilt->table);
@@ -5887,6 +6261,12 @@ no_commit:
 		}
 
 		auto_inc_used = TRUE;
+
+		/* A value was taken from an interval that
+		innobase_reserve_autoinc() reserved. */
+		if (insert_id_for_cur_row && prebuilt->autoinc_n_reserved) {
+			prebuilt->autoinc_n_reserved--;
+		}
 	}
 
 	if (prebuilt->mysql_template == NULL
@@ -5900,7 +6280,20 @@ no_commit:
 
 	innodb_srv_conc_enter_innodb(prebuilt->trx);
 
-	error = row_insert_for_mysql((byte*) record, prebuilt);
+	if (UNIV_UNLIKELY(prebuilt->bulk_requested)) {
+		error = row_bulk_start_for_mysql(prebuilt, table);
+
+		if (error != DB_SUCCESS) {
+			innodb_srv_conc_exit_innodb(prebuilt->trx);
+			goto report_error;
+		}
+	}
+
+	if (UNIV_LIKELY_NULL(prebuilt->bulk)) {
+		error = row_bulk_insert_for_mysql((byte*) record, prebuilt);
+	} else {
+		error = row_insert_for_mysql((byte*) record, prebuilt);
+	}
 
 #ifdef EXTENDED_FOR_USERSTAT
 	if (UNIV_LIKELY(error == DB_SUCCESS)) {
@@ -6155,6 +6548,76 @@ calc_row_difference(
 	return(0);
 }
 
+/*****************************************************************//**
+MySQL calls this before LOAD DATA or INSERT...SELECT writes its rows.
+With innodb_bulk_load, the rows of a statement that does not handle
+duplicate keys by itself are sorted and loaded bottom-up in
+end_bulk_insert(), if the table is empty at the first row. Instead of the
+rows, the emptiness of the table is undo logged, so that the statement or
+the transaction can be rolled back after end_bulk_insert(). */
+UNIV_INTERN
+void
+ha_innobase::start_bulk_insert(
+/*===========================*/
+	ha_rows	rows)	/*!< in: number of rows to insert, 0 if unknown */
+{
+	THD*	thd = ha_thd();
+
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+
+	prebuilt->bulk_requested = FALSE;
+
+	switch (thd_sql_command(thd)) {
+	case SQLCOM_LOAD:
+	case SQLCOM_INSERT_SELECT:
+		break;
+	default:
+		DBUG_VOID_RETURN;
+	}
+
+	prebuilt->bulk_requested = srv_bulk_load
+		&& thd->lex->duplicates == DUP_ERROR
+		&& !thd->lex->ignore;
+
+	DBUG_VOID_RETURN;
+}
+
+/*****************************************************************//**
+Loads the rows buffered by a bulk insert into the index trees, or discards
+them if the statement failed.
+@return	0 or error number */
+UNIV_INTERN
+int
+ha_innobase::end_bulk_insert()
+/*===========================*/
+{
+	THD*	thd = ha_thd();
+	int	error;
+	int	error_result = 0;
+
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	if (!prebuilt->bulk) {
+		prebuilt->bulk_requested = FALSE;
+		DBUG_RETURN(0);
+	}
+
+	innodb_srv_conc_enter_innodb(prebuilt->trx);
+
+	error = row_bulk_end_for_mysql(
+		prebuilt, !thd->is_error() && !thd_killed(thd));
+
+	innodb_srv_conc_exit_innodb(prebuilt->trx);
+
+	if (error != DB_SUCCESS) {
+		error_result = convert_error_code_to_mysql(
+			error, prebuilt->table->flags, thd);
+		my_errno = error_result;
+	}
+
+	DBUG_RETURN(error_result);
+}
+
 /**********************************************************************//**
 Updates a row given as a parameter to a new value. Note that we are given
 whole rows, not just the fields which are updated: this incurs some
@@ -6425,7 +6888,8 @@ ha_innobase::index_init(
 }
 
 /******************************************************************//**
-Currently does nothing.
+Ends the use of an index, and the index scan of a disk-sweep
+multi-range read.
 @return	0 */
 UNIV_INTERN
 int
@@ -6434,6 +6898,7 @@ ha_innobase::index_end(void)
 {
 	int	error	= 0;
 	DBUG_ENTER("index_end");
+	ds_mrr.end_scan();
 	active_index=MAX_KEY;
 	DBUG_RETURN(error);
 }
@@ -6633,6 +7098,20 @@ ha_innobase::index_read(
 
 	last_match_mode = (uint) match_mode;
 
+	/* Check the pushed index condition on the secondary index
+	records, unless the row is not read into record[0] that the
+	condition refers to. */
+
+	if (pushed_idx_cond != NULL
+	    && active_index == pushed_idx_cond_keyno
+	    && buf == table->record[0]
+	    && !dict_index_is_clust(index)) {
+
+		prebuilt->idx_cond = this;
+	} else {
+		prebuilt->idx_cond = NULL;
+	}
+
 	if (mode != PAGE_CUR_UNSUPP) {
 
 		innodb_srv_conc_enter_innodb(prebuilt->trx);
@@ -7214,6 +7693,7 @@ create_table_def(
 	ulint		unsigned_type;
 	ulint		binary_type;
 	ulint		long_true_varchar;
+	ulint		compressed;
 	ulint		charset_no;
 	ulint		i;
 
@@ -7242,6 +7722,39 @@ create_table_def(
 
 	table->initial_size = size;
 
+	if (flags & DICT_TF_ZSSIZE_MASK) {
+		THD*	thd = (THD*) trx->mysql_thd;
+
+		table->zip_codec = THDVAR(thd, compression_codec);
+		table->zip_level = table->zip_codec == PAGE_ZIP_CODEC_ZLIB
+			? THDVAR(thd, compression_level) : 0;
+
+		if (table->zip_level == 6) {
+			/* This is what Z_DEFAULT_COMPRESSION means. */
+			table->zip_level = 0;
+		}
+
+		if (dict_table_get_format_tag(table) > srv_file_format) {
+			/* Older servers cannot open such a tablespace. */
+			push_warning_printf(
+				thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+				ER_ILLEGAL_HA_CREATE_OPTION,
+				"InnoDB: innodb_compression_codec and"
+				" innodb_compression_level require"
+				" innodb_file_format > %s.",
+				trx_sys_file_format_id_to_name(
+					DICT_TF_FORMAT_ZIP));
+			table->zip_codec = PAGE_ZIP_CODEC_ZLIB;
+			table->zip_level = 0;
+		} else {
+			/* Tag the system tablespace before the
+			tablespace flags are written. */
+			trx_sys_file_format_max_upgrade(
+				(const char**) &innobase_file_format_max,
+				dict_table_get_format_tag(table));
+		}
+	}
+
 	if (path_of_temp_table) {
 		table->dir_path_of_temp_table =
 			mem_heap_strdup(table->heap, path_of_temp_table);
@@ -7319,6 +7832,39 @@ create_table_def(
 			}
 		}
 
+		compressed = 0;
+
+		if (field->column_format() == COLUMN_FORMAT_TYPE_COMPRESSED) {
+			if (col_type != DATA_BLOB) {
+				push_warning_printf(
+					(THD*) trx->mysql_thd,
+					MYSQL_ERROR::WARN_LEVEL_WARN,
+					ER_ILLEGAL_HA_CREATE_OPTION,
+					"InnoDB: COLUMN_FORMAT COMPRESSED"
+					" requires a BLOB or TEXT column;"
+					" column '%s' is not one.",
+					(char*) field->field_name);
+				goto err_col;
+			}
+
+			if (DICT_TF_FORMAT_CODEC > srv_file_format) {
+				/* Older servers would return the
+				compressed stream as the column value. */
+				push_warning_printf(
+					(THD*) trx->mysql_thd,
+					MYSQL_ERROR::WARN_LEVEL_WARN,
+					ER_ILLEGAL_HA_CREATE_OPTION,
+					"InnoDB: COLUMN_FORMAT COMPRESSED"
+					" requires innodb_file_format > %s;"
+					" column '%s' is not compressed.",
+					trx_sys_file_format_id_to_name(
+						DICT_TF_FORMAT_ZIP),
+					(char*) field->field_name);
+			} else {
+				compressed = DATA_COMPRESSED;
+			}
+		}
+
 		/* First check whether the column to be added has a
 		system reserved name. */
 		if (dict_col_name_is_reserved(field->field_name)){
@@ -7338,11 +7884,18 @@ err_col:
 			dtype_form_prtype(
 				(ulint)field->type()
 				| nulls_allowed | unsigned_type
-				| binary_type | long_true_varchar,
+				| binary_type | long_true_varchar
+				| compressed,
 				charset_no),
 			col_len);
 	}
 
+	/* Tag the system tablespace before any compressed column
+	is written. */
+	trx_sys_file_format_max_upgrade(
+		(const char**) &innobase_file_format_max,
+		dict_table_get_format_tag(table));
+
 	error = row_create_table_for_mysql(table, trx);
 
 	if (error == DB_DUPLICATE_KEY) {
@@ -8049,7 +8602,7 @@ ha_innobase::create(
 
 		trx_sys_file_format_max_upgrade(
 			(const char**) &innobase_file_format_max,
-			dict_table_get_format(innobase_table));
+			dict_table_get_format_tag(innobase_table));
 	}
 
 	/* Note: We can't call update_thd() as prebuilt will not be
@@ -8127,6 +8680,14 @@ ha_innobase::discard_or_import_tablespace(
 		err = row_discard_tablespace_for_mysql(dict_table->name, trx);
 	} else {
 		err = row_import_tablespace_for_mysql(dict_table->name, trx);
+
+		if (err == DB_SUCCESS) {
+			/* The imported tablespace may use a page
+			compression codec. */
+			trx_sys_file_format_max_upgrade(
+				(const char**) &innobase_file_format_max,
+				dict_table_get_format_tag(dict_table));
+		}
 	}
 
 	err = convert_error_code_to_mysql(err, dict_table->flags, NULL);
@@ -8857,9 +9418,29 @@ ha_innobase::info_low(
 	ib_table = prebuilt->table;
 
 	if (flag & HA_STATUS_TIME) {
-		if (called_from_analyze || innobase_stats_on_metadata) {
+		if (called_from_analyze
+		    && dict_stats_is_persistent_enabled(ib_table)) {
+			/* Count the key values exactly, without holding
+			the statistics latch, and have the background
+			thread store the result in SYS_STATS */
+
+			prebuilt->trx->op_info = "calculating table statistics";
+
+			DEBUG_SYNC_C("info_before_stats_update");
+
+			dict_stats_recalc(ib_table, ULINT_UNDEFINED);
+
+			dict_stats_enqueue(ib_table);
+
+			prebuilt->trx->op_info = "returning various info to MySQL";
+		} else if (called_from_analyze
+			   || (innobase_stats_on_metadata
+			       && !dict_stats_is_persistent_enabled(
+				       ib_table))) {
 			/* In sql_show we call with this flag: update
-			then statistics so that they are up-to-date */
+			then statistics so that they are up-to-date.
+			Persistent statistics are only changed by
+			ANALYZE TABLE and the background thread. */
 
 			prebuilt->trx->op_info = "updating table statistics";
 
@@ -9315,6 +9896,7 @@ ha_innobase::check(
 		prebuilt->template_type = ROW_MYSQL_DUMMY_TEMPLATE;
 		prebuilt->n_template = 0;
 		prebuilt->need_to_access_clustered = FALSE;
+		prebuilt->idx_cond = NULL;
 
 		dtuple_set_n_fields(prebuilt->search_tuple, 0);
 
@@ -9842,6 +10424,33 @@ ha_innobase::extra(
 		case HA_EXTRA_WRITE_CANNOT_REPLACE:
 			thd_to_trx(ha_thd())->duplicates &= ~TRX_DUP_REPLACE;
 			break;
+		case HA_EXTRA_EXPORT:
+			/* FLUSH TABLES ... FOR EXPORT has opened and read
+			locked the table in this thread; the export ends
+			when the lock is released in external_lock(). */
+			if (!prebuilt->exporting) {
+				ulint	err;
+
+				update_thd(ha_thd());
+
+				err = row_quiesce_table_start(
+					prebuilt->table, prebuilt->trx);
+
+				if (err != DB_SUCCESS) {
+					return(convert_error_code_to_mysql(
+						(int) err, prebuilt->table->flags,
+						ha_thd()));
+				}
+
+				prebuilt->exporting = TRUE;
+
+				push_warning_printf(
+					ha_thd(), MYSQL_ERROR::WARN_LEVEL_WARN,
+					HA_ERR_GENERIC,
+					"InnoDB: Purge is stopped for all"
+					" tables until UNLOCK TABLES.");
+			}
+			break;
 		default:/* Do nothing */
 			;
 	}
@@ -9857,6 +10466,11 @@ ha_innobase::reset()
 		row_mysql_prebuilt_free_blob_heap(prebuilt);
 	}
 
+	/* Discard the rows of a bulk insert that was not ended. */
+	row_bulk_end_for_mysql(prebuilt, FALSE);
+
+	ds_mrr.reset();
+
 	reset_template(prebuilt);
 
 	/* TODO: This should really be reset in reset_template() but for now
@@ -10115,6 +10729,12 @@ ha_innobase::external_lock(
 	trx->n_mysql_tables_in_use--;
 	prebuilt->mysql_has_locked = FALSE;
 
+	if (prebuilt->exporting) {
+		/* UNLOCK TABLES after FLUSH TABLES ... FOR EXPORT */
+		row_quiesce_table_complete(prebuilt->table, trx);
+		prebuilt->exporting = FALSE;
+	}
+
 	/* Release a possible FIFO ticket and search latch. Since we
 	may reserve the kernel mutex, we have to release the search
 	system latch first to obey the latching order. */
@@ -10874,9 +11494,9 @@ ha_innobase::innobase_peek_autoinc(void)
 
 	innodb_table = prebuilt->table;
 
-	dict_table_autoinc_lock(innodb_table);
-
-	auto_inc = dict_table_autoinc_read(innodb_table);
+	/* Do not wait for a statement that holds the autoinc mutex
+	while it computes its interval. */
+	auto_inc = dict_table_autoinc_peek(innodb_table);
 
 	if (auto_inc == 0) {
 		ut_print_timestamp(stderr);
@@ -10884,8 +11504,6 @@ ha_innobase::innobase_peek_autoinc(void)
 			"is disabled for '%s'\n", innodb_table->name);
 	}
 
-	dict_table_autoinc_unlock(innodb_table);
-
 	return(auto_inc);
 }
 
@@ -10909,10 +11527,18 @@ ha_innobase::get_auto_increment(
 	trx_t*		trx;
 	ulint		error;
 	ulonglong	autoinc = 0;
+	ulonglong	requested_value = *first_value;
+	ibool		first_call;
 
 	/* Prepare prebuilt->trx in the table handle */
 	update_thd(ha_thd());
 
+	if (innobase_autoinc_mode(user_thd) == AUTOINC_NO_LOCKING) {
+		innobase_reserve_autoinc(offset, increment, nb_desired_values,
+					 first_value, nb_reserved_values);
+		return;
+	}
+
 	error = innobase_get_autoinc(&autoinc);
 
 	if (error != DB_SUCCESS) {
@@ -10940,8 +11566,10 @@ ha_innobase::get_auto_increment(
 	ulonglong	col_max_value = innobase_get_int_col_max_value(
 		table->next_number_field);
 
+	first_call = trx->n_autoinc_rows == 0;
+
 	/* Called for the first time ? */
-	if (trx->n_autoinc_rows == 0) {
+	if (first_call) {
 
 		trx->n_autoinc_rows = (ulint) nb_desired_values;
 
@@ -10951,7 +11579,14 @@ ha_innobase::get_auto_increment(
 
 			trx->n_autoinc_rows = 1;
 		}
+	}
+
+	DEBUG_SYNC_C("ha_innobase_get_auto_increment_read");
 
+retry:
+	*first_value = requested_value;
+
+	if (first_call) {
 		set_if_bigger(*first_value, autoinc);
 	/* Not in the middle of a mult-row INSERT. */
 	} else if (prebuilt->autoinc_last_value == 0) {
@@ -10970,6 +11605,7 @@ ha_innobase::get_auto_increment(
 	if (innobase_autoinc_lock_mode != AUTOINC_OLD_STYLE_LOCKING) {
 		ulonglong	current;
 		ulonglong	next_value;
+		ulonglong	counter = autoinc;
 
 		current = *first_value > col_max_value ? autoinc : *first_value;
 
@@ -10983,7 +11619,7 @@ ha_innobase::get_auto_increment(
 			current = innobase_next_autoinc(
 				current, 1, increment, 1, col_max_value);
 
-			dict_table_autoinc_initialize(prebuilt->table, current);
+			counter = current;
 
 			*first_value = current;
 		}
@@ -10993,15 +11629,26 @@ ha_innobase::get_auto_increment(
 			current, *nb_reserved_values, increment, offset,
 			col_max_value);
 
-		prebuilt->autoinc_last_value = next_value;
-
-		if (prebuilt->autoinc_last_value < *first_value) {
+		if (next_value < *first_value) {
 			*first_value = (~(ulonglong) 0);
 		} else {
-			/* Update the table autoinc variable */
-			dict_table_autoinc_update_if_greater(
-				prebuilt->table, prebuilt->autoinc_last_value);
+			set_if_bigger(counter, next_value);
+
+			/* Update the table autoinc variable.  Statements
+			that reserve their intervals with
+			innobase_reserve_autoinc() do not acquire the
+			autoinc mutex; if one of them moved the counter
+			after it was read, compute the interval again. */
+			if (!dict_table_autoinc_replace(
+				    prebuilt->table, autoinc, counter)) {
+
+				autoinc = dict_table_autoinc_read(
+					prebuilt->table);
+				goto retry;
+			}
 		}
+
+		prebuilt->autoinc_last_value = next_value;
 	} else {
 		/* This will force write_row() into attempting an update
 		of the table's AUTOINC counter. */
@@ -11018,14 +11665,109 @@ ha_innobase::get_auto_increment(
 	dict_table_autoinc_unlock(prebuilt->table);
 }
 
-/*******************************************************************//**
-Reset the auto-increment counter to the given value, i.e. the next row
-inserted will get the given value. This is called e.g. after TRUNCATE
-is emulated by doing a 'DELETE FROM t'. HA_ERR_WRONG_COMMAND is
-returned by storage engines that don't support this operation.
-@return	0 or error code */
+/*********************************************************************//**
+Reserves an interval of AUTOINC values for a statement that does not
+take the table AUTO-INC lock (see innobase_autoinc_mode()).  Neither the table AUTO-INC lock nor the autoinc mutex is held while the
+interval is computed: the interval is claimed by a compare-and-swap of
+the table's autoinc counter, and retried if another statement claimed
+an interval first.  Concurrent multi-row and bulk inserts therefore get
+interleaved intervals.  *first_value is set to -1 on error. */
 UNIV_INTERN
-int
+void
+ha_innobase::innobase_reserve_autoinc(
+/*==================================*/
+        ulonglong	offset,              /*!< in: table autoinc offset */
+        ulonglong	increment,           /*!< in: table autoinc increment */
+        ulonglong	nb_desired_values,   /*!< in: number of values reqd */
+        ulonglong	*first_value,        /*!< out: the autoinc value */
+        ulonglong	*nb_reserved_values) /*!< out: count of reserved values */
+{
+	trx_t*		trx = prebuilt->trx;
+	dict_table_t*	innodb_table = prebuilt->table;
+	ulonglong	col_max_value;
+	ulonglong	current;
+	ulonglong	next_value;
+
+	col_max_value = innobase_get_int_col_max_value(
+		table->next_number_field);
+
+	/* As in get_auto_increment(), nb_desired_values is only
+	meaningful for the first call of a multi-row INSERT; later
+	calls count down from it. */
+	if (trx->n_autoinc_rows == 0) {
+
+		trx->n_autoinc_rows = nb_desired_values
+			? (ulint) nb_desired_values : 1;
+	}
+
+	do {
+		current = dict_table_autoinc_peek(innodb_table);
+
+		/* It should have been initialized during open. */
+		if (current == 0) {
+			prebuilt->autoinc_error = DB_UNSUPPORTED;
+			*first_value = (~(ulonglong) 0);
+			return;
+		}
+
+		/* Compute the last value in the interval */
+		next_value = innobase_next_autoinc(
+			current, trx->n_autoinc_rows, increment, offset,
+			col_max_value);
+
+		if (next_value < current) {
+			*first_value = (~(ulonglong) 0);
+			return;
+		}
+	} while (!dict_table_autoinc_compare_and_swap(
+			 innodb_table, current, next_value));
+
+	*first_value = current;
+	*nb_reserved_values = trx->n_autoinc_rows;
+
+	prebuilt->autoinc_last_value = next_value;
+	prebuilt->autoinc_offset = offset;
+	prebuilt->autoinc_increment = increment;
+	prebuilt->autoinc_n_reserved += trx->n_autoinc_rows;
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_atomic_increment_ulint(&srv_n_autoinc_reserved,
+				  trx->n_autoinc_rows);
+#else /* HAVE_ATOMIC_BUILTINS */
+	srv_n_autoinc_reserved += trx->n_autoinc_rows;
+#endif /* HAVE_ATOMIC_BUILTINS */
+}
+
+/*********************************************************************//**
+Called by MySQL at the end of a statement that inserted rows.  Counts the
+AUTOINC values that innobase_reserve_autoinc() reserved for the statement
+but that no row was given; they are gaps in the sequence. */
+UNIV_INTERN
+void
+ha_innobase::release_auto_increment(void)
+/*=====================================*/
+{
+	ulint	n_unused = (ulint) prebuilt->autoinc_n_reserved;
+
+	if (n_unused) {
+		prebuilt->autoinc_n_reserved = 0;
+
+#ifdef HAVE_ATOMIC_BUILTINS
+		os_atomic_increment_ulint(&srv_n_autoinc_unused, n_unused);
+#else /* HAVE_ATOMIC_BUILTINS */
+		srv_n_autoinc_unused += n_unused;
+#endif /* HAVE_ATOMIC_BUILTINS */
+	}
+}
+
+/*******************************************************************//**
+Reset the auto-increment counter to the given value, i.e. the next row
+inserted will get the given value. This is called e.g. after TRUNCATE
+is emulated by doing a 'DELETE FROM t'. HA_ERR_WRONG_COMMAND is
+returned by storage engines that don't support this operation.
+@return	0 or error code */
+UNIV_INTERN
+int
 ha_innobase::reset_auto_increment(
 /*==============================*/
 	ulonglong	value)		/*!< in: new value for table autoinc */
@@ -11956,6 +12698,16 @@ innodb_adaptive_hash_index_update(
 	const void*			save)		/*!< in: immediate result
 							from check function */
 {
+	if (buf_pool_resizing) {
+		/* buf_pool_resize() disabled the adaptive hash index
+		and will enable it again if it was enabled. */
+		push_warning(thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+			     ER_WRONG_ARGUMENTS,
+			     "innodb_adaptive_hash_index cannot be changed"
+			     " while the buffer pool is being resized");
+		return;
+	}
+
 	if (*(my_bool*) save) {
 		btr_search_enable();
 	} else {
@@ -11963,6 +12715,81 @@ innodb_adaptive_hash_index_update(
 	}
 }
 
+/****************************************************************//**
+Update the system variable innodb_stats_persistent using the "saved"
+value. The SYS_STATS table is created when the variable is first
+enabled. This function is registered as a callback with MySQL. */
+static
+void
+innodb_stats_persistent_update(
+/*===========================*/
+	THD*				thd,		/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,		/*!< in: pointer to
+							system variable */
+	void*				var_ptr,	/*!< out: where the
+							formal string goes */
+	const void*			save)		/*!< in: immediate result
+							from check function */
+{
+	my_bool	persistent = *static_cast<const my_bool*>(save) != 0;
+
+	if (persistent
+	    && dict_stats_create_or_check_sys_table(TRUE) != DB_SUCCESS) {
+		push_warning(thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+			     ER_WRONG_ARGUMENTS,
+			     "InnoDB: cannot create the SYS_STATS table;"
+			     " innodb_stats_persistent stays OFF");
+		persistent = FALSE;
+	}
+
+	*static_cast<my_bool*>(var_ptr) = persistent;
+}
+
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_size using the "saved"
+value and start resizing the buffer pool.  The size is rounded up to a
+multiple of innodb_buffer_pool_chunk_size * innodb_buffer_pool_instances.
+This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	long long	in_val = *static_cast<const long long*>(save);
+	ulint		size;
+
+	if (sizeof(ulint) == 4 && in_val > (long long) UINT_MAX32) {
+		push_warning(thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+			     ER_WRONG_ARGUMENTS,
+			     "innodb_buffer_pool_size can't be over 4GB"
+			     " on 32-bit systems");
+		return;
+	}
+
+	size = buf_pool_size_align((ulint) in_val);
+
+	if (size != (ulint) in_val) {
+		push_warning_printf(thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size must be a multiple"
+				    " of innodb_buffer_pool_chunk_size *"
+				    " innodb_buffer_pool_instances; using %lu",
+				    (ulong) size);
+	}
+
+	*static_cast<long long*>(var_ptr) = (long long) size;
+	srv_buf_pool_size = size;
+
+	os_event_set(buf_resize_event);
+}
+
 /****************************************************************//**
 Update the system variable innodb_old_blocks_pct using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -12084,6 +12911,309 @@ innodb_change_buffering_update(
 		 *static_cast<const char*const*>(save);
 }
 
+/*************************************************************//**
+Find a monitor counter or module by name.  The name is compared case
+insensitively.
+@return	counter or module, or NUM_MONITOR if not found */
+static
+monitor_id_t
+innodb_monitor_id_by_name(
+/*======================*/
+	const char*	name)	/*!< in: counter or module name */
+{
+	for (ulint i = 0; i < NUM_MONITOR; i++) {
+		monitor_id_t	id = (monitor_id_t) i;
+
+		if (!innobase_strcasecmp(name,
+					 srv_mon_get_info(id)->monitor_name)) {
+			return(id);
+		}
+	}
+
+	return(NUM_MONITOR);
+}
+
+/*************************************************************//**
+Check if a monitor counter name matches a wildcard pattern.
+@return	TRUE if the name matches */
+static
+ibool
+innodb_monitor_name_match(
+/*======================*/
+	const char*	name,		/*!< in: counter name */
+	const char*	pattern)	/*!< in: pattern with '%' */
+{
+	return(!my_wildcmp(system_charset_info,
+			   name, name + strlen(name),
+			   pattern, pattern + strlen(pattern),
+			   '\\', '_', '%'));
+}
+
+/*************************************************************//**
+Check if a value of innodb_monitor_enable, innodb_monitor_disable,
+innodb_monitor_reset or innodb_monitor_reset_all names at least one
+monitor counter.  The value is "all", a counter name, a module name,
+or a pattern with the '%' wildcard that matches counter names.
+@return	TRUE if the value is valid */
+static
+ibool
+innodb_monitor_name_valid(
+/*======================*/
+	const char*	name)	/*!< in: value of the variable */
+{
+	if (!innobase_strcasecmp(name, "all")) {
+		return(TRUE);
+	}
+
+	if (!strchr(name, '%')) {
+		return(innodb_monitor_id_by_name(name) != NUM_MONITOR);
+	}
+
+	for (ulint i = 0; i < NUM_MONITOR; i++) {
+		const monitor_info_t*	info;
+
+		info = srv_mon_get_info((monitor_id_t) i);
+
+		if (!(info->monitor_type & MONITOR_MODULE)
+		    && innodb_monitor_name_match(info->monitor_name, name)) {
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/*************************************************************//**
+Check if it is a valid value of innodb_monitor_enable,
+innodb_monitor_disable, innodb_monitor_reset or innodb_monitor_reset_all.
+This function is registered as a callback with MySQL.
+@return	0 for a valid value */
+static
+int
+innodb_monitor_validate(
+/*====================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value)	/*!< in: incoming string */
+{
+	const char*	name;
+	char		buff[STRING_BUFFER_USUAL_SIZE];
+	int		len = sizeof(buff);
+
+	ut_a(save != NULL);
+	ut_a(value != NULL);
+
+	name = value->val_str(value, buff, &len);
+
+	if (name == NULL) {
+		/* NULL does not name any counter and has no effect. */
+		*static_cast<const char**>(save) = NULL;
+		return(0);
+	}
+
+	if (!innodb_monitor_name_valid(name)) {
+		return(1);
+	}
+
+	*static_cast<const char**>(save) = thd_strmake(thd, name, len);
+
+	return(0);
+}
+
+/*************************************************************//**
+Apply an operation to the monitor counters named by a validated value
+of one of the innodb_monitor_* variables.  A counter that is on is not
+affected by MONITOR_RESET_ALL_VALUE; if it was named explicitly, a
+warning is pushed to thd. */
+static
+void
+innodb_monitor_set_option(
+/*======================*/
+	THD*		thd,		/*!< in: thread handle, or NULL
+					at startup */
+	const char*	name,		/*!< in: validated value */
+	mon_option_t	set_option)	/*!< in: operation */
+{
+	monitor_id_t	id;
+
+	if (!innobase_strcasecmp(name, "all")) {
+		srv_mon_set_module_control(NUM_MONITOR, set_option);
+		return;
+	}
+
+	if (strchr(name, '%')) {
+		for (ulint i = 0; i < NUM_MONITOR; i++) {
+			const monitor_info_t*	info;
+
+			info = srv_mon_get_info((monitor_id_t) i);
+
+			if (!(info->monitor_type & MONITOR_MODULE)
+			    && innodb_monitor_name_match(
+				    info->monitor_name, name)) {
+
+				srv_mon_set_option((monitor_id_t) i,
+						   set_option);
+			}
+		}
+
+		return;
+	}
+
+	id = innodb_monitor_id_by_name(name);
+	ut_a(id != NUM_MONITOR);
+
+	if (srv_mon_get_info(id)->monitor_type & MONITOR_MODULE) {
+		srv_mon_set_module_control(id, set_option);
+		return;
+	}
+
+	if (set_option == MONITOR_RESET_ALL_VALUE && MONITOR_IS_ON(id)
+	    && thd) {
+		push_warning_printf(thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "InnoDB: Monitor counter %s is enabled;"
+				    " disable it before resetting all its"
+				    " values.", name);
+	}
+
+	srv_mon_set_option(id, set_option);
+}
+
+/*************************************************************//**
+Turn on the monitor counters listed in innodb_monitor_enable at startup.
+The list is separated by commas, semicolons or spaces.  Names that do
+not match any counter are reported and ignored. */
+static
+void
+innodb_enable_monitor_at_startup(
+/*=============================*/
+	const char*	str)	/*!< in: value of innodb_monitor_enable */
+{
+	char*	list = my_strdup(str, MYF(0));
+	char*	last;
+
+	if (list == NULL) {
+		return;
+	}
+
+	for (char* name = strtok_r(list, " ,;", &last);
+	     name != NULL;
+	     name = strtok_r(NULL, " ,;", &last)) {
+
+		if (innodb_monitor_name_valid(name)) {
+			innodb_monitor_set_option(NULL, name,
+						  MONITOR_TURN_ON);
+		} else {
+			sql_print_warning("InnoDB: innodb_monitor_enable:"
+					  " unknown monitor counter '%s'",
+					  name);
+		}
+	}
+
+	my_free(list);
+}
+
+/****************************************************************//**
+Update one of the innodb_monitor_* system variables using the "saved"
+value and apply the operation to the monitor counters. */
+static
+void
+innodb_monitor_update(
+/*==================*/
+	THD*		thd,		/*!< in: thread handle */
+	void*		var_ptr,	/*!< out: where the
+					formal string goes */
+	const void*	save,		/*!< in: immediate result
+					from check function */
+	mon_option_t	set_option)	/*!< in: operation */
+{
+	const char*	name = *static_cast<const char*const*>(save);
+
+	ut_a(var_ptr != NULL);
+
+	if (name != NULL) {
+		innodb_monitor_set_option(thd, name, set_option);
+	}
+
+	/* PLUGIN_VAR_MEMALLOC: the server owns the copy of the string. */
+	*static_cast<const char**>(var_ptr) = name;
+}
+
+/****************************************************************//**
+Update the system variable innodb_monitor_enable.  This function is
+registered as a callback with MySQL. */
+static
+void
+innodb_enable_monitor_update(
+/*=========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	innodb_monitor_update(thd, var_ptr, save, MONITOR_TURN_ON);
+}
+
+/****************************************************************//**
+Update the system variable innodb_monitor_disable.  This function is
+registered as a callback with MySQL. */
+static
+void
+innodb_disable_monitor_update(
+/*==========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	innodb_monitor_update(thd, var_ptr, save, MONITOR_TURN_OFF);
+}
+
+/****************************************************************//**
+Update the system variable innodb_monitor_reset.  This function is
+registered as a callback with MySQL. */
+static
+void
+innodb_reset_monitor_update(
+/*========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	innodb_monitor_update(thd, var_ptr, save, MONITOR_RESET_VALUE);
+}
+
+/****************************************************************//**
+Update the system variable innodb_monitor_reset_all.  This function is
+registered as a callback with MySQL. */
+static
+void
+innodb_reset_all_monitor_update(
+/*============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	innodb_monitor_update(thd, var_ptr, save, MONITOR_RESET_ALL_VALUE);
+}
+
 #ifndef DBUG_OFF
 static char* srv_buffer_pool_evict;
 
@@ -12147,6 +13277,27 @@ static int show_innodb_vars(THD *thd, SHOW_VAR *var, char *buff)
   return 0;
 }
 
+/*********************************************************************//**
+Returns the lsn of the last commit of the transaction of a connection
+that wrote log records, as Innodb_last_commit_lsn. */
+static
+int
+show_innodb_last_commit_lsn(
+/*========================*/
+	THD*		thd,	/*!< in: connection */
+	SHOW_VAR*	var,	/*!< out: status variable */
+	char*		buff)	/*!< out: buffer for the value */
+{
+	trx_t*	trx = thd_to_trx(thd);
+
+	*reinterpret_cast<ulonglong*>(buff) = trx ? trx->commit_lsn : 0;
+
+	var->type = SHOW_LONGLONG;
+	var->value = buff;
+
+	return(0);
+}
+
 /*********************************************************************//**
 This function checks each index name for a table against reserved
 system default primary index name 'GEN_CLUST_INDEX'. If a name
@@ -12293,9 +13444,37 @@ static MYSQL_SYSVAR_ULONG(flush_log_at_trx_commit, srv_flush_log_at_trx_commit,
   PLUGIN_VAR_OPCMDARG,
   "Set to 0 (write and flush once per second),"
   " 1 (write and flush at each commit)"
-  " or 2 (write at commit, flush once per second).",
+  " or 2 (write at commit, flush once per second)."
+  " The flush interval is set by innodb_flush_log_interval.",
   NULL, NULL, 1, 0, 2, 0);
 
+/****************************************************************//**
+Updates innodb_flush_log_interval and wakes up the log flush thread so
+that a shorter interval takes effect immediately. */
+static
+void
+innodb_flush_log_interval_update(
+/*=============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	srv_flush_log_interval = *static_cast<const ulong*>(save);
+
+	os_event_set(log_sys->flush_timer_event);
+}
+
+static MYSQL_SYSVAR_ULONG(flush_log_interval, srv_flush_log_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Milliseconds between the writes and flushes of the log by the log flush"
+  " thread, which bound the loss of transactions at a crash with"
+  " innodb_flush_log_at_trx_commit=0 or 2 or with innodb_async_commit.",
+  NULL, innodb_flush_log_interval_update, 1000, 10, 60000, 0);
+
 static MYSQL_SYSVAR_STR(flush_method, innobase_file_flush_method,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "With which method to flush data.", NULL, NULL, NULL);
@@ -12339,6 +13518,13 @@ static MYSQL_SYSVAR_BOOL(adaptive_flushing, srv_adaptive_flushing,
   "Attempt flushing dirty pages to avoid IO bursts at checkpoints.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(change_buffer_background_merge,
+  srv_ibuf_background_merge,
+  PLUGIN_VAR_NOCMDARG,
+  "Merge the change buffer in a background thread, at a rate that adapts"
+  " to the change buffer size and the unused innodb_io_capacity.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_ULONG(max_purge_lag, srv_max_purge_lag,
   PLUGIN_VAR_RQCMDARG,
   "Desired maximum length of the purge queue (0 = no limit)",
@@ -12364,6 +13550,27 @@ static MYSQL_SYSVAR_ULONGLONG(stats_sample_pages, srv_stats_sample_pages,
   "The number of index pages to sample when calculating statistics (default 8)",
   NULL, NULL, 8, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_BOOL(stats_persistent, srv_stats_persistent,
+  PLUGIN_VAR_OPCMDARG,
+  "Store index statistics in the SYS_STATS table and recalculate them in a "
+  "background thread instead of at table open and after row changes; "
+  "ANALYZE TABLE then counts the key values exactly (off by default)",
+  NULL, innodb_stats_persistent_update, FALSE);
+
+static MYSQL_SYSVAR_ULONG(stats_persistent_sample_pages,
+  srv_stats_persistent_sample_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "The number of index pages to sample when the background thread "
+  "recalculates persistent statistics (default 20)",
+  NULL, NULL, 20, 1, ~0UL, 0);
+
+static MYSQL_SYSVAR_BOOL(bulk_load, srv_bulk_load,
+  PLUGIN_VAR_OPCMDARG,
+  "Sort the rows of LOAD DATA and INSERT...SELECT into an empty table and "
+  "build the indexes bottom-up with minimal redo and undo logging, without "
+  "IGNORE or REPLACE (off by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default).  "
@@ -12394,9 +13601,15 @@ static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
 #endif /* !DBUG_OFF */
 
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
-  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  PLUGIN_VAR_RQCMDARG,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  NULL, innodb_buffer_pool_size_update,
+  128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Size of the chunks that the buffer pool is allocated and resized in.",
+  NULL, NULL, 128*1024*1024L, 1024*1024L, LONG_MAX, 1024*1024L);
 
 static MYSQL_SYSVAR_BOOL(buffer_pool_populate, srv_buf_pool_populate,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -12419,6 +13632,13 @@ static MYSQL_SYSVAR_BOOL(flush_neighbors, srv_flush_neighbors,
   "Flush neighbors from buffer pool when flushing a block.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(lazy_drop_table, srv_lazy_drop_table,
+  PLUGIN_VAR_NOCMDARG,
+  "Leave the pages of a dropped or truncated file-per-table tablespace in "
+  "the buffer pool, to be discarded by the page flushes and LRU eviction, "
+  "instead of scanning the whole buffer pool for them.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_ULONG(concurrency_tickets, srv_n_free_tickets_to_enter,
   PLUGIN_VAR_RQCMDARG,
   "Number of times a thread is allowed to enter InnoDB within the same SQL query after it has once got the ticket",
@@ -12511,7 +13731,8 @@ static MYSQL_SYSVAR_LONG(autoinc_lock_mode, innobase_autoinc_lock_mode,
   "The AUTOINC lock modes supported by InnoDB:               "
   "0 => Old style AUTOINC locking (for backward"
   " compatibility)                                           "
-  "1 => New style AUTOINC locking                            "
+  "1 => New style AUTOINC locking; bulk inserts that are not"
+  " binlogged in statement format do not lock the table      "
   "2 => No AUTOINC locking (unsafe for SBR)",
   NULL, NULL,
   AUTOINC_NEW_STYLE_LOCKING,	/* Default setting */
@@ -12532,6 +13753,12 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring for asynchronous reads and writes if it is supported on"
+  " this platform, falling back to native or simulated AIO otherwise.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   PLUGIN_VAR_RQCMDARG,
   "Buffer changes to reduce random access: "
@@ -12539,6 +13766,34 @@ static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   innodb_change_buffering_validate,
   innodb_change_buffering_update, "all");
 
+static MYSQL_SYSVAR_STR(monitor_enable, innobase_monitor_enable,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Turn on a monitor counter of INFORMATION_SCHEMA.INNODB_METRICS:"
+  " a counter name, a module name, a pattern with '%' or 'all'.",
+  innodb_monitor_validate,
+  innodb_enable_monitor_update, NULL);
+
+static MYSQL_SYSVAR_STR(monitor_disable, innobase_monitor_disable,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Turn off a monitor counter of INFORMATION_SCHEMA.INNODB_METRICS:"
+  " a counter name, a module name, a pattern with '%' or 'all'.",
+  innodb_monitor_validate,
+  innodb_disable_monitor_update, NULL);
+
+static MYSQL_SYSVAR_STR(monitor_reset, innobase_monitor_reset,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Reset the COUNT_RESET value of a monitor counter:"
+  " a counter name, a module name, a pattern with '%' or 'all'.",
+  innodb_monitor_validate,
+  innodb_reset_monitor_update, NULL);
+
+static MYSQL_SYSVAR_STR(monitor_reset_all, innobase_monitor_reset_all,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Reset all the values of a monitor counter that is disabled:"
+  " a counter name, a module name, a pattern with '%' or 'all'.",
+  innodb_monitor_validate,
+  innodb_reset_all_monitor_update, NULL);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should "
@@ -12609,7 +13864,8 @@ static MYSQL_SYSVAR_DOUBLE(index_fill_factor, srv_index_fill_factor,
   "The percentage of how much to fill a leaf page when inserting data, "
   "the remaining space being reserved to accommodate row expansion (e.g. "
   "update). InnoDB might perform page splits to maintain the percentage "
-  "of free space. Only applies to clustered indexes.",
+  "of free space. Only applies to clustered indexes and to indexes that "
+  "are built bottom-up.",
   NULL, NULL, 93.75, 0.0, 100.0, 0);
 
 static MYSQL_SYSVAR_BOOL(lease_fragment_extents, srv_lease_fragment_extents,
@@ -12640,6 +13896,14 @@ static MYSQL_SYSVAR_BOOL(deadlock_check, srv_deadlock_check,
   "Enableds deadlock checking.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ENUM(lock_schedule_algorithm, srv_lock_schedule_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The order in which waiting row locks are granted when a lock is "
+  "released. Possible values are FCFS (default, in the order of the "
+  "requests), OLDEST (the transaction that started first) and MOST_LOCKS "
+  "(the transaction that holds the most locks).",
+  NULL, NULL, SRV_LOCK_SCHEDULE_FCFS, &innodb_lock_schedule_algorithm_typelib);
+
 static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(additional_mem_pool_size),
   MYSQL_SYSVAR(autoextend_increment),
@@ -12647,15 +13911,18 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* !DBUG_OFF */
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(buffer_pool_populate),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(flush_neighbors),
+  MYSQL_SYSVAR(lazy_drop_table),
   MYSQL_SYSVAR(checksums),
   MYSQL_SYSVAR(commit_concurrency),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(deadlock_check),
+  MYSQL_SYSVAR(lock_schedule_algorithm),
   MYSQL_SYSVAR(doublewrite),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(file_io_threads),
@@ -12665,13 +13932,19 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(file_format),
   MYSQL_SYSVAR(file_format_check),
   MYSQL_SYSVAR(file_format_max),
+  MYSQL_SYSVAR(compression_codec),
+  MYSQL_SYSVAR(compression_level),
   MYSQL_SYSVAR(flush_log_at_trx_commit),
+  MYSQL_SYSVAR(flush_log_interval),
+  MYSQL_SYSVAR(async_commit),
+  MYSQL_SYSVAR(flush_log_up_to),
   MYSQL_SYSVAR(flush_method),
   MYSQL_SYSVAR(force_recovery),
   MYSQL_SYSVAR(large_prefix),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(logical_read_ahead),
 #ifdef UNIV_LOG_ARCHIVE
   MYSQL_SYSVAR(log_arch_dir),
   MYSQL_SYSVAR(log_archive),
@@ -12691,6 +13964,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(rollback_on_timeout),
   MYSQL_SYSVAR(stats_on_metadata),
   MYSQL_SYSVAR(stats_sample_pages),
+  MYSQL_SYSVAR(stats_persistent),
+  MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(bulk_load),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
@@ -12706,7 +13982,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_sys_malloc),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
   MYSQL_SYSVAR(change_buffering),
+  MYSQL_SYSVAR(change_buffer_background_merge),
+  MYSQL_SYSVAR(monitor_enable),
+  MYSQL_SYSVAR(monitor_disable),
+  MYSQL_SYSVAR(monitor_reset),
+  MYSQL_SYSVAR(monitor_reset_all),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
@@ -12760,7 +14042,9 @@ i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
 i_s_innodb_buffer_stats,
 i_s_innodb_buffer_page_basic,
-i_s_innodb_space_stats
+i_s_innodb_space_stats,
+i_s_innodb_metrics,
+i_s_innodb_change_buffer_indexes
 mysql_declare_plugin_end;
 
 /** @brief Initialize the default value of innodb_commit_concurrency.
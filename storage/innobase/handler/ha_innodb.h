@@ -97,6 +97,7 @@ class ha_innobase: public handler
 					ROW_SEL_EXACT, ROW_SEL_EXACT_PREFIX,
 					or undefined */
 	uint		num_write_row;	/*!< number of write_row() calls */
+	DsMrr_impl	ds_mrr;		/*!< disk-sweep multi-range read */
 
 	uint store_key_val_for_row(uint keynr, char* buff, uint buff_len,
                                    const uchar* record);
@@ -109,6 +110,10 @@ class ha_innobase: public handler
 	ulint innobase_set_max_autoinc(ulonglong auto_inc);
 	ulint innobase_reset_autoinc(ulonglong auto_inc);
 	ulint innobase_get_autoinc(ulonglong* value);
+	void innobase_reserve_autoinc(ulonglong offset, ulonglong increment,
+				      ulonglong nb_desired_values,
+				      ulonglong* first_value,
+				      ulonglong* nb_reserved_values);
 	ulint innobase_update_autoinc(ulonglong	auto_inc);
 	void innobase_initialize_autoinc();
 	dict_index_t* innobase_get_index(uint keynr);
@@ -140,6 +145,8 @@ class ha_innobase: public handler
 	double scan_time();
 	double read_time(uint index, uint ranges, ha_rows rows);
 
+	void start_bulk_insert(ha_rows rows);
+	int end_bulk_insert();
 	int write_row(uchar * buf);
 	int update_row(const uchar * old_data, uchar * new_data);
 	int delete_row(const uchar * buf);
@@ -202,6 +209,7 @@ class ha_innobase: public handler
                                         ulonglong nb_desired_values,
                                         ulonglong *first_value,
                                         ulonglong *nb_reserved_values);
+	virtual void release_auto_increment();
 	int reset_auto_increment(ulonglong value);
 
 	virtual bool get_error_message(int error, String *buf);
@@ -218,6 +226,12 @@ class ha_innobase: public handler
 	static ulonglong get_mysql_bin_log_pos();
 	bool primary_key_is_clustered();
 	int cmp_ref(const uchar *ref1, const uchar *ref2);
+	Item* idx_cond_push(uint keyno, Item* idx_cond);
+	int read_multi_range_first(KEY_MULTI_RANGE** found_range_p,
+				   KEY_MULTI_RANGE* ranges, uint range_count,
+				   bool sorted, HANDLER_BUFFER* buffer);
+	int read_multi_range_next(KEY_MULTI_RANGE** found_range_p);
+	bool read_multi_range_sweeps(uint keyno, bool sorted);
 	/** Fast index creation (smart ALTER TABLE) @see handler0alter.cc @{ */
 	int add_index(TABLE *table_arg, KEY *key_info, uint num_of_keys,
 		      handler_add_index **add);
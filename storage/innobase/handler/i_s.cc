@@ -50,6 +50,7 @@ extern "C" {
 #include "btr0btr.h"
 #include "page0zip.h"
 #include "log0log.h"
+#include "srv0mon.h"
 }
 
 /** structure associates a name string with a file page type and/or buffer
@@ -1356,6 +1357,14 @@ static ST_FIELD_INFO	i_s_cmp_fields_info[] =
 		    " in Seconds"),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+	{STRUCT_FLD(field_name,		"codec"),
+	 STRUCT_FLD(field_length,	8),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Compression Codec"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -1387,34 +1396,41 @@ i_s_cmp_fill_low(
 	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
 
 	for (uint i = 0; i < PAGE_ZIP_NUM_SSIZE - 1; i++) {
-		page_zip_stat_t*	zip_stat = &page_zip_stat[i];
-
-		table->field[0]->store(PAGE_ZIP_MIN_SIZE << i);
-
-		/* The cumulated counts are not protected by any
-		mutex.  Thus, some operation in page0zip.c could
-		increment a counter between the time we read it and
-		clear it.  We could introduce mutex protection, but it
-		could cause a measureable performance hit in
-		page0zip.c. */
-		table->field[1]->store(zip_stat->compressed);
-		table->field[2]->store(zip_stat->compressed_ok);
-		table->field[3]->store(
-			(ulong) (zip_stat->compressed_usec / 1000000));
-		table->field[4]->store(zip_stat->decompressed);
-		table->field[5]->store(
-			(ulong) (zip_stat->decompressed_usec / 1000000));
-
-		if (reset) {
-			memset(zip_stat, 0, sizeof *zip_stat);
-		}
+		for (uint codec = 0; codec < PAGE_ZIP_N_CODECS; codec++) {
+			page_zip_stat_t*	zip_stat
+				= &page_zip_stat[i][codec];
+
+			table->field[0]->store(PAGE_ZIP_MIN_SIZE << i);
+
+			/* The cumulated counts are not protected by any
+			mutex.  Thus, some operation in page0zip.c could
+			increment a counter between the time we read it and
+			clear it.  We could introduce mutex protection, but
+			it could cause a measureable performance hit in
+			page0zip.c. */
+			table->field[1]->store(zip_stat->compressed);
+			table->field[2]->store(zip_stat->compressed_ok);
+			table->field[3]->store(
+				(ulong) (zip_stat->compressed_usec / 1000000));
+			table->field[4]->store(zip_stat->decompressed);
+			table->field[5]->store(
+				(ulong) (zip_stat->decompressed_usec
+					 / 1000000));
+			OK(field_store_string(table->field[6],
+					      page_zip_codec_names[codec]));
 
-		if (schema_table_store_record(thd, table)) {
-			status = 1;
-			break;
+			if (reset) {
+				memset(zip_stat, 0, sizeof *zip_stat);
+			}
+
+			if (schema_table_store_record(thd, table)) {
+				status = 1;
+				goto func_exit;
+			}
 		}
 	}
 
+func_exit:
 	DBUG_RETURN(status);
 }
 
@@ -2710,8 +2726,10 @@ i_s_innodb_buffer_page_fill(
 
 			/* Copy the index/table name under mutex. We
 			do not want to hold the InnoDB mutex while
-			filling the IS table */
-			if (index) {
+			filling the IS table. Pages of a truncated
+			tablespace keep the index id but belong to no
+			table. */
+			if (index && index->space == page_info->space_id) {
 				const char*	name_ptr = index->name;
 
 				if (name_ptr[0] == TEMP_INDEX_PREFIX) {
@@ -3034,9 +3052,12 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
-	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+	/* The chunks may be freed by a buffer pool resize while the
+	mutex is released; stop the scan if that happens. */
+	const ulint		withdraw_clock = buf_withdraw_clock;
+
+	/* Go through each chunk of buffer pool */
+	for (ulint n = 0; n < buf_pool->n_chunks && !status; n++) {
 		const buf_block_t*	block;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
@@ -3070,6 +3091,12 @@ i_s_innodb_fill_buffer_pool(
 			release mutex periodically */
 			buf_pool_mutex_enter(buf_pool);
 
+			if (buf_withdraw_clock != withdraw_clock) {
+				buf_pool_mutex_exit(buf_pool);
+				mem_heap_free(heap);
+				DBUG_RETURN(status);
+			}
+
 			/* GO through each block in the chunk */
 			for (n_blocks = num_to_process; n_blocks--; block++) {
 				i_s_innodb_buffer_page_get_info(
@@ -3489,8 +3516,10 @@ i_s_innodb_buf_page_lru_fill(
 
 			/* Copy the index/table name under mutex. We
 			do not want to hold the InnoDB mutex while
-			filling the IS table */
-			if (index) {
+			filling the IS table. Pages of a truncated
+			tablespace keep the index id but belong to no
+			table. */
+			if (index && index->space == page_info->space_id) {
 				const char*	name_ptr = index->name;
 
 				if (name_ptr[0] == TEMP_INDEX_PREFIX) {
@@ -3871,6 +3900,7 @@ i_s_innodb_buffer_page_basic_fill(
 	ulint			num_page;
 	ulint			chunk_size;
 	ulint			batch_size;
+	const ulint		withdraw_clock = buf_withdraw_clock;
 
 	DBUG_ENTER("i_s_innodb_buffer_page_basic_fill");
 
@@ -3892,6 +3922,12 @@ i_s_innodb_buffer_page_basic_fill(
 		so the mutex can be released periodically */
 		buf_pool_mutex_enter(buf_pool);
 
+		/* Stop if the chunk was freed by a buffer pool resize */
+		if (buf_withdraw_clock != withdraw_clock) {
+			buf_pool_mutex_exit(buf_pool);
+			break;
+		}
+
 		/* Fetch information from pages in this buffer chunk */
 		num_page = i_s_innodb_buffer_page_basic_fetch(
 					block, batch_size, page_info);
@@ -3935,6 +3971,7 @@ i_s_innodb_buffer_page_basic_fill_table(
 	mem_heap_t*		heap;
 	buf_pool_t*		buf_pool;
 	ulint			i, n;
+	int			error = 0;
 
 	DBUG_ENTER("i_s_innodb_buffer_page_fill_table");
 
@@ -3949,27 +3986,24 @@ i_s_innodb_buffer_page_basic_fill_table(
 	for (i = 0; i < srv_buf_pool_instances; i++) {
 		buf_pool = buf_pool_from_array(i);
 
-		/* Go through each chunk of the buffer pool. Currently, there
-		is only one chunk for each buffer pool */
-		for (n = 0; n < buf_pool->n_chunks; n++) {
+		/* Go through each chunk of the buffer pool */
+		for (n = 0; n < buf_pool->n_chunks && !error; n++) {
 
 			/* Fetch information from pages in this buffer pool
 			chunk and fill the I_S table */
-			if (i_s_innodb_buffer_page_basic_fill(thd, tables,
-							buf_pool, n, heap)) {
-				break;
-			}
+			error = i_s_innodb_buffer_page_basic_fill(
+				thd, tables, buf_pool, n, heap);
 		}
 
 		/* If something went wrong, break the loop */
-		if (n < buf_pool->n_chunks) {
+		if (error) {
 			break;
 		}
 	}
 
 	mem_heap_free(heap);
 
-	DBUG_RETURN(i < srv_buf_pool_instances);
+	DBUG_RETURN(error);
 }
 
 /*******************************************************************//**
@@ -4334,3 +4368,576 @@ UNIV_INTERN struct st_mysql_plugin	i_s_innodb_space_stats =
 	/* unsigned long */
 	STRUCT_FLD(flags, 0UL),
 };
+
+/* Fields of the dynamic table INNODB_METRICS. */
+static ST_FIELD_INFO	i_s_innodb_metrics_fields_info[] =
+{
+#define IDX_METRIC_NAME		0
+	{STRUCT_FLD(field_name,		"NAME"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_SUBSYS		1
+	{STRUCT_FLD(field_name,		"SUBSYSTEM"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_VALUE		2
+	{STRUCT_FLD(field_name,		"COUNT"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_MAX_VALUE	3
+	{STRUCT_FLD(field_name,		"MAX_COUNT"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_MIN_VALUE	4
+	{STRUCT_FLD(field_name,		"MIN_COUNT"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_AVG_VALUE	5
+	{STRUCT_FLD(field_name,		"AVG_COUNT"),
+	 STRUCT_FLD(field_length,	MAX_FLOAT_STR_LENGTH),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_FLOAT),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_VALUE_RESET	6
+	{STRUCT_FLD(field_name,		"COUNT_RESET"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_START_TIME	7
+	{STRUCT_FLD(field_name,		"TIME_ENABLED"),
+	 STRUCT_FLD(field_length,	0),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_DATETIME),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_STOP_TIME	8
+	{STRUCT_FLD(field_name,		"TIME_DISABLED"),
+	 STRUCT_FLD(field_length,	0),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_DATETIME),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_TIME_ELAPSED	9
+	{STRUCT_FLD(field_name,		"TIME_ELAPSED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_RESET_TIME	10
+	{STRUCT_FLD(field_name,		"TIME_RESET"),
+	 STRUCT_FLD(field_length,	0),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_DATETIME),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_STATUS		11
+	{STRUCT_FLD(field_name,		"STATUS"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_TYPE		12
+	{STRUCT_FLD(field_name,		"TYPE"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_METRIC_DESC		13
+	{STRUCT_FLD(field_name,		"COMMENT"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Store the value of a monitor counter in a nullable MYSQL_TYPE_LONGLONG
+field.
+@return	0 on success */
+static
+int
+field_store_mon_value(
+/*==================*/
+	Field*		field,	/*!< in/out: target field for storage */
+	mon_type_t	value,	/*!< in: value to store */
+	bool		is_null)/*!< in: whether to store NULL instead */
+{
+	if (is_null) {
+		field->set_null();
+		return(0);
+	}
+
+	field->set_notnull();
+
+	return(field->store((longlong) value, false));
+}
+
+/*******************************************************************//**
+Store a time in a nullable MYSQL_TYPE_DATETIME field.  A time of 0
+is stored as NULL.
+@return	0 on success */
+static
+int
+field_store_mon_time(
+/*=================*/
+	Field*		field,	/*!< in/out: target field for storage */
+	ib_time_t	time)	/*!< in: time to store, or 0 */
+{
+	if (!time) {
+		field->set_null();
+		return(0);
+	}
+
+	field->set_notnull();
+
+	return(field_store_time_t(field, (time_t) time));
+}
+
+/*******************************************************************//**
+Fill the INFORMATION_SCHEMA.INNODB_METRICS table with one row per
+monitor counter.  The module entries are not shown.
+@return	0 on success, 1 on failure */
+static
+int
+i_s_innodb_metrics_fill_table(
+/*==========================*/
+	THD*		thd,		/*!< in: thread */
+	TABLE_LIST*	tables,		/*!< in/out: tables to fill */
+	Item*		)		/*!< in: condition (ignored) */
+{
+	TABLE*	table = tables->table;
+	Field**	fields = table->field;
+	ib_time_t	now = ut_time();
+
+	DBUG_ENTER("i_s_innodb_metrics_fill_table");
+
+	/* Deny access to users without PROCESS privilege. */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	for (ulint i = 0; i < NUM_MONITOR; i++) {
+		monitor_id_t		id = (monitor_id_t) i;
+		const monitor_info_t*	info = srv_mon_get_info(id);
+		monitor_value_t		mon;
+		bool			is_gauge;
+		mon_type_t		value;
+		ib_time_t		elapsed;
+		const char*		type;
+
+		if (info->monitor_type & MONITOR_MODULE) {
+			continue;
+		}
+
+		is_gauge = (info->monitor_type & MONITOR_DISPLAY_CURRENT) != 0;
+		value = srv_mon_get_value(id, &mon);
+
+		if (!mon.mon_start_time) {
+			elapsed = 0;
+		} else if (mon.mon_status == MONITOR_STARTED) {
+			elapsed = now - mon.mon_start_time;
+		} else {
+			elapsed = mon.mon_stop_time - mon.mon_start_time;
+		}
+
+		OK(field_store_string(fields[IDX_METRIC_NAME],
+				      info->monitor_name));
+		OK(field_store_string(fields[IDX_METRIC_SUBSYS],
+				      info->monitor_module));
+		OK(fields[IDX_METRIC_VALUE]->store((longlong) value, false));
+		OK(field_store_mon_value(fields[IDX_METRIC_MAX_VALUE],
+					 mon.mon_max_value,
+					 !is_gauge || !mon.mon_status));
+		OK(field_store_mon_value(fields[IDX_METRIC_MIN_VALUE],
+					 mon.mon_min_value,
+					 !is_gauge || !mon.mon_status));
+
+		if (is_gauge || elapsed <= 0) {
+			fields[IDX_METRIC_AVG_VALUE]->set_null();
+		} else {
+			OK(fields[IDX_METRIC_AVG_VALUE]->store(
+				   (double) value / (double) elapsed));
+			fields[IDX_METRIC_AVG_VALUE]->set_notnull();
+		}
+
+		OK(fields[IDX_METRIC_VALUE_RESET]->store(
+			   (longlong) (value - mon.mon_value_reset), false));
+		OK(field_store_mon_time(fields[IDX_METRIC_START_TIME],
+					mon.mon_start_time));
+		OK(field_store_mon_time(fields[IDX_METRIC_STOP_TIME],
+					mon.mon_stop_time));
+		OK(field_store_mon_value(fields[IDX_METRIC_TIME_ELAPSED],
+					 (mon_type_t) elapsed,
+					 !mon.mon_start_time));
+		OK(field_store_mon_time(fields[IDX_METRIC_RESET_TIME],
+					mon.mon_reset_time));
+		OK(field_store_string(fields[IDX_METRIC_STATUS],
+				      MONITOR_IS_ON(id)
+				      ? "enabled" : "disabled"));
+
+		if (is_gauge) {
+			type = "value";
+		} else if (info->monitor_type & MONITOR_EXISTING) {
+			type = "status_counter";
+		} else {
+			type = "counter";
+		}
+
+		OK(field_store_string(fields[IDX_METRIC_TYPE], type));
+		OK(field_store_string(fields[IDX_METRIC_DESC],
+				      info->monitor_desc));
+		OK(schema_table_store_record(thd, table));
+	}
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_METRICS.
+@return	0 on success */
+static
+int
+i_s_innodb_metrics_init(
+/*====================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("i_s_innodb_metrics_init");
+
+	schema = reinterpret_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = i_s_innodb_metrics_fields_info;
+	schema->fill_table = i_s_innodb_metrics_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_mysql_plugin	i_s_innodb_metrics =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_METRICS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, "Twitter, Inc."),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB Metrics Info"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_BSD),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_innodb_metrics_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, NULL),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
+/* Fields of the dynamic table INNODB_CHANGE_BUFFER_INDEXES. */
+static ST_FIELD_INFO	i_s_innodb_change_buffer_indexes_fields_info[] =
+{
+#define IDX_IBUF_INDEX_TABLE_NAME	0
+	{STRUCT_FLD(field_name,		"TABLE_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_INDEX_NAME	1
+	{STRUCT_FLD(field_name,		"INDEX_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_SPACE		2
+	{STRUCT_FLD(field_name,		"SPACE"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_INDEX_ID		3
+	{STRUCT_FLD(field_name,		"INDEX_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_INSERTS		4
+	{STRUCT_FLD(field_name,		"INSERTS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_DELETE_MARKS	5
+	{STRUCT_FLD(field_name,		"DELETE_MARKS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_IBUF_INDEX_DELETES		6
+	{STRUCT_FLD(field_name,		"DELETES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		NULL),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill the INFORMATION_SCHEMA.INNODB_CHANGE_BUFFER_INDEXES table with one
+row per index that has changes in the change buffer which were buffered
+since the server was started.
+@return	0 on success, 1 on failure */
+static
+int
+i_s_innodb_change_buffer_indexes_fill_table(
+/*========================================*/
+	THD*		thd,		/*!< in: thread */
+	TABLE_LIST*	tables,		/*!< in/out: tables to fill */
+	Item*		)		/*!< in: condition (ignored) */
+{
+	TABLE*			table = tables->table;
+	Field**			fields = table->field;
+	mem_heap_t*		heap;
+	ibuf_index_stat_t*	stats;
+	ulint			n_stats;
+	int			rv = 0;
+
+	DBUG_ENTER("i_s_innodb_change_buffer_indexes_fill_table");
+
+	/* Deny access to users without PROCESS privilege. */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	heap = mem_heap_create(1024);
+
+	/* Copy the counts, so that no mutex is held while the
+	dictionary is looked up and the rows are stored. */
+	n_stats = ibuf_get_index_stats(heap, &stats);
+
+	for (ulint i = 0; i < n_stats && rv == 0; i++) {
+		const ibuf_index_stat_t*	stat = &stats[i];
+		const dict_index_t*		index;
+		const char*			table_name = NULL;
+		const char*			index_name = NULL;
+
+		mutex_enter(&dict_sys->mutex);
+
+		index = dict_index_get_if_in_cache_low(stat->index_id);
+
+		/* The index may have been evicted from the dictionary
+		cache or dropped. */
+		if (index != NULL && index->space == stat->space) {
+			const char*	name_ptr = index->name;
+
+			if (name_ptr[0] == TEMP_INDEX_PREFIX) {
+				name_ptr++;
+			}
+
+			index_name = mem_heap_strdup(heap, name_ptr);
+			table_name = mem_heap_strdup(heap, index->table_name);
+		}
+
+		mutex_exit(&dict_sys->mutex);
+
+		if (field_store_string(fields[IDX_IBUF_INDEX_TABLE_NAME],
+				       table_name)
+		    || field_store_string(fields[IDX_IBUF_INDEX_INDEX_NAME],
+					  index_name)
+		    || fields[IDX_IBUF_INDEX_SPACE]->store(stat->space)
+		    || fields[IDX_IBUF_INDEX_INDEX_ID]->store(
+			    (longlong) stat->index_id, true)
+		    || fields[IDX_IBUF_INDEX_INSERTS]->store(
+			    stat->n_ops[IBUF_OP_INSERT])
+		    || fields[IDX_IBUF_INDEX_DELETE_MARKS]->store(
+			    stat->n_ops[IBUF_OP_DELETE_MARK])
+		    || fields[IDX_IBUF_INDEX_DELETES]->store(
+			    stat->n_ops[IBUF_OP_DELETE])
+		    || schema_table_store_record(thd, table)) {
+
+			rv = 1;
+		}
+	}
+
+	mem_heap_free(heap);
+
+	DBUG_RETURN(rv);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_CHANGE_BUFFER_INDEXES.
+@return	0 on success */
+static
+int
+i_s_innodb_change_buffer_indexes_init(
+/*==================================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("i_s_innodb_change_buffer_indexes_init");
+
+	schema = reinterpret_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = i_s_innodb_change_buffer_indexes_fields_info;
+	schema->fill_table = i_s_innodb_change_buffer_indexes_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_mysql_plugin	i_s_innodb_change_buffer_indexes =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_CHANGE_BUFFER_INDEXES"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, "Twitter, Inc."),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB Change Buffer Contents Per Index"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_BSD),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_innodb_change_buffer_indexes_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, NULL),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
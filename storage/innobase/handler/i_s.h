@@ -40,5 +40,7 @@ extern struct st_mysql_plugin	i_s_innodb_buffer_page_lru;
 extern struct st_mysql_plugin	i_s_innodb_buffer_stats;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page_basic;
 extern struct st_mysql_plugin	i_s_innodb_space_stats;
+extern struct st_mysql_plugin	i_s_innodb_metrics;
+extern struct st_mysql_plugin	i_s_innodb_change_buffer_indexes;
 
 #endif /* i_s_h */
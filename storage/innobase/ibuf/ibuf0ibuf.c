@@ -57,6 +57,8 @@ Created 7/19/1997 Heikki Tuuri
 #include "que0que.h"
 #include "srv0start.h" /* srv_shutdown_state */
 #include "rem0cmp.h"
+#include "log0log.h"
+#include "hash0hash.h"
 
 /*	STRUCTURE OF AN INSERT BUFFER RECORD
 
@@ -205,6 +207,15 @@ UNIV_INTERN mysql_pfs_key_t	ibuf_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	ibuf_bitmap_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+#ifdef UNIV_PFS_RWLOCK
+UNIV_INTERN mysql_pfs_key_t	ibuf_index_counts_latch_key;
+#endif /* UNIV_PFS_RWLOCK */
+
+/** Event to wake up ibuf_merge_thread() */
+UNIV_INTERN os_event_t	ibuf_merge_event	= NULL;
+/** TRUE if ibuf_merge_thread() is active */
+UNIV_INTERN ibool	ibuf_merge_thread_active	= FALSE;
+
 #ifdef UNIV_IBUF_COUNT_DEBUG
 /** Number of tablespaces in the ibuf_counts array */
 #define IBUF_COUNT_N_SPACES	4
@@ -294,6 +305,42 @@ static mutex_t	ibuf_mutex;
 /** The mutex protecting the insert buffer bitmaps */
 static mutex_t	ibuf_bitmap_mutex;
 
+/** Operations buffered for an index, in the hash table
+ibuf_index_counts */
+typedef struct ibuf_index_count_struct	ibuf_index_count_t;
+
+/** Operations buffered for an index */
+struct ibuf_index_count_struct{
+	ibuf_index_stat_t	stat;	/*!< space id, index id and the
+					number of buffered operations */
+	ibuf_index_count_t*	hash;	/*!< hash chain node */
+};
+
+/** The latch protecting ibuf_index_counts.  Adding and removing
+entries needs an X-latch.  With atomic builtins, a buffered operation
+is counted under an S-latch, so that the threads that buffer changes
+for different indexes do not wait for each other. */
+static rw_lock_t	ibuf_index_counts_latch;
+
+/** The operations buffered for each index, keyed by (space id, index id).
+The counts cover the operations buffered since the server was started;
+entries that were already in the change buffer at startup are not
+counted, and the counts are not allowed to go below zero when such
+entries are merged. */
+static hash_table_t*	ibuf_index_counts;
+
+/** Number of cells in ibuf_index_counts */
+#define IBUF_INDEX_COUNTS_HASH_SIZE	1024
+
+/** Wait between two batches of ibuf_merge_thread(), in microseconds */
+#define IBUF_MERGE_THREAD_INTERVAL	1000000
+
+/** When the change buffer is filled to this percentage of its maximum
+size, ibuf_merge_thread() uses at least half of innodb_io_capacity even
+if the server is busy, so that the foreground threads do not have to
+merge before they can buffer more changes */
+#define IBUF_MERGE_URGENT_PCT		80
+
 /** The area in pages from which contract looks for page numbers for merge */
 #define	IBUF_MERGE_AREA			8
 
@@ -459,6 +506,8 @@ void
 ibuf_close(void)
 /*============*/
 {
+	ulint	i;
+
 	mutex_free(&ibuf_pessimistic_insert_mutex);
 	memset(&ibuf_pessimistic_insert_mutex,
 	       0x0, sizeof(ibuf_pessimistic_insert_mutex));
@@ -469,6 +518,27 @@ ibuf_close(void)
 	mutex_free(&ibuf_bitmap_mutex);
 	memset(&ibuf_bitmap_mutex, 0x0, sizeof(ibuf_mutex));
 
+	for (i = 0; i < hash_get_n_cells(ibuf_index_counts); i++) {
+		ibuf_index_count_t*	count;
+
+		count = HASH_GET_FIRST(ibuf_index_counts, i);
+
+		while (count != NULL) {
+			ibuf_index_count_t*	next;
+
+			next = HASH_GET_NEXT(hash, count);
+			mem_free(count);
+			count = next;
+		}
+	}
+
+	hash_table_free(ibuf_index_counts);
+	ibuf_index_counts = NULL;
+
+	rw_lock_free(&ibuf_index_counts_latch);
+	memset(&ibuf_index_counts_latch, 0x0,
+	       sizeof(ibuf_index_counts_latch));
+
 	mem_free(ibuf);
 	ibuf = NULL;
 }
@@ -532,6 +602,13 @@ ibuf_init_at_db_start(void)
 	mutex_create(ibuf_bitmap_mutex_key,
 		     &ibuf_bitmap_mutex, SYNC_IBUF_BITMAP_MUTEX);
 
+	rw_lock_create(ibuf_index_counts_latch_key,
+		       &ibuf_index_counts_latch, SYNC_ANY_LATCH);
+
+	ibuf_index_counts = hash_create(IBUF_INDEX_COUNTS_HASH_SIZE);
+
+	ibuf_merge_event = os_event_create(NULL);
+
 	mtr_start(&mtr);
 
 	mutex_enter(&ibuf_mutex);
@@ -591,6 +668,262 @@ ibuf_init_at_db_start(void)
 
 	ibuf->index = dict_table_get_first_index(table);
 }
+
+/*********************************************************************//**
+Updates the maximum size of the insert buffer after the buffer pool
+has been resized. */
+UNIV_INTERN
+void
+ibuf_max_size_update(void)
+/*======================*/
+{
+	ulint	new_size = buf_pool_get_curr_size() / UNIV_PAGE_SIZE
+		/ IBUF_POOL_SIZE_PER_MAX_SIZE;
+
+	mutex_enter(&ibuf_mutex);
+	ibuf->max_size = new_size;
+	mutex_exit(&ibuf_mutex);
+}
+
+/******************************************************************//**
+Looks up the buffered operation counts of an index.
+@return	the counts, or NULL if not found and create == FALSE */
+static
+ibuf_index_count_t*
+ibuf_index_count_get(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	index_id_t	index_id,	/*!< in: index id */
+	ibool		create)		/*!< in: TRUE=create the entry
+					if it does not exist */
+{
+	ibuf_index_count_t*	count;
+	ulint			fold;
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&ibuf_index_counts_latch, RW_LOCK_EX)
+	      || (!create && rw_lock_own(&ibuf_index_counts_latch,
+					 RW_LOCK_SHARED)));
+#endif /* UNIV_SYNC_DEBUG */
+
+	fold = ut_fold_ulint_pair(space, ut_fold_ull(index_id));
+
+	HASH_SEARCH(hash, ibuf_index_counts, fold,
+		    ibuf_index_count_t*, count, ut_ad(1),
+		    count->stat.space == space
+		    && count->stat.index_id == index_id);
+
+	if (count == NULL && create) {
+		count = mem_alloc(sizeof(*count));
+		memset(count, 0, sizeof(*count));
+
+		count->stat.space = space;
+		count->stat.index_id = index_id;
+
+		HASH_INSERT(ibuf_index_count_t, hash, ibuf_index_counts,
+			    fold, count);
+	}
+
+	return(count);
+}
+
+/******************************************************************//**
+Removes the buffered operation counts of an index from the hash table. */
+static
+void
+ibuf_index_count_remove(
+/*====================*/
+	ibuf_index_count_t*	count)	/*!< in, own: counts to remove */
+{
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&ibuf_index_counts_latch, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	HASH_DELETE(ibuf_index_count_t, hash, ibuf_index_counts,
+		    ut_fold_ulint_pair(count->stat.space,
+				       ut_fold_ull(count->stat.index_id)),
+		    count);
+
+	mem_free(count);
+}
+
+/******************************************************************//**
+Counts an operation that was buffered for an index. */
+static
+void
+ibuf_index_count_inc(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	index_id_t	index_id,	/*!< in: index id */
+	ibuf_op_t	op)		/*!< in: operation type */
+{
+#ifdef HAVE_ATOMIC_BUILTINS
+	ibuf_index_count_t*	count;
+
+	rw_lock_s_lock(&ibuf_index_counts_latch);
+
+	count = ibuf_index_count_get(space, index_id, FALSE);
+
+	if (count != NULL) {
+		os_atomic_increment_ulint(&count->stat.n_ops[op], 1);
+	}
+
+	rw_lock_s_unlock(&ibuf_index_counts_latch);
+
+	if (count != NULL) {
+
+		return;
+	}
+#endif /* HAVE_ATOMIC_BUILTINS */
+
+	rw_lock_x_lock(&ibuf_index_counts_latch);
+
+	ibuf_index_count_get(space, index_id, TRUE)->stat.n_ops[op]++;
+
+	rw_lock_x_unlock(&ibuf_index_counts_latch);
+}
+
+/******************************************************************//**
+Subtracts the operations that were merged to a page of an index from
+its buffered operation counts. */
+static
+void
+ibuf_index_count_sub(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	index_id_t	index_id,	/*!< in: index id */
+	const ulint*	ops)		/*!< in: operations merged, indexed
+					by ibuf_op_t */
+{
+	ibuf_index_count_t*	count;
+	ulint			n_left	= 0;
+	ulint			i;
+
+	rw_lock_x_lock(&ibuf_index_counts_latch);
+
+	count = ibuf_index_count_get(space, index_id, FALSE);
+
+	if (count != NULL) {
+		for (i = 0; i < IBUF_OP_COUNT; i++) {
+			/* Operations buffered before the server was
+			started were not counted. */
+			if (count->stat.n_ops[i] > ops[i]) {
+				count->stat.n_ops[i] -= ops[i];
+			} else {
+				count->stat.n_ops[i] = 0;
+			}
+
+			n_left += count->stat.n_ops[i];
+		}
+
+		if (n_left == 0) {
+			ibuf_index_count_remove(count);
+		}
+	}
+
+	rw_lock_x_unlock(&ibuf_index_counts_latch);
+}
+
+/******************************************************************//**
+Forgets the buffered operation counts of all indexes in a tablespace. */
+static
+void
+ibuf_index_count_remove_space(
+/*==========================*/
+	ulint	space)	/*!< in: space id */
+{
+	ulint	i;
+
+	rw_lock_x_lock(&ibuf_index_counts_latch);
+
+	for (i = 0; i < hash_get_n_cells(ibuf_index_counts); i++) {
+		ibuf_index_count_t*	count;
+
+		count = HASH_GET_FIRST(ibuf_index_counts, i);
+
+		while (count != NULL) {
+			ibuf_index_count_t*	next;
+
+			next = HASH_GET_NEXT(hash, count);
+
+			if (count->stat.space == space) {
+				ibuf_index_count_remove(count);
+			}
+
+			count = next;
+		}
+	}
+
+	rw_lock_x_unlock(&ibuf_index_counts_latch);
+}
+
+/******************************************************************//**
+Forgets the buffered operation counts of an index whose tree is freed
+by DROP INDEX, DROP TABLE or TRUNCATE TABLE.  The change buffer entries
+of the index are discarded when their pages are read or reused. */
+UNIV_INTERN
+void
+ibuf_index_count_remove_index(
+/*==========================*/
+	ulint		space,		/*!< in: space id */
+	index_id_t	index_id)	/*!< in: index id */
+{
+	ibuf_index_count_t*	count;
+
+	rw_lock_x_lock(&ibuf_index_counts_latch);
+
+	count = ibuf_index_count_get(space, index_id, FALSE);
+
+	if (count != NULL) {
+		ibuf_index_count_remove(count);
+	}
+
+	rw_lock_x_unlock(&ibuf_index_counts_latch);
+}
+
+/******************************************************************//**
+Returns a snapshot of the operations buffered for each index since the
+server was started.
+@return	number of elements in *stats */
+UNIV_INTERN
+ulint
+ibuf_get_index_stats(
+/*=================*/
+	mem_heap_t*		heap,	/*!< in: memory heap for *stats */
+	ibuf_index_stat_t**	stats)	/*!< out: array of counts */
+{
+	ulint	n_stats	= 0;
+	ulint	n_alloc	= 16;
+	ulint	i;
+
+	*stats = mem_heap_alloc(heap, n_alloc * sizeof(**stats));
+
+	rw_lock_s_lock(&ibuf_index_counts_latch);
+
+	for (i = 0; i < hash_get_n_cells(ibuf_index_counts); i++) {
+		const ibuf_index_count_t*	count;
+
+		for (count = HASH_GET_FIRST(ibuf_index_counts, i);
+		     count != NULL;
+		     count = HASH_GET_NEXT(hash, count)) {
+
+			if (n_stats == n_alloc) {
+				ibuf_index_stat_t*	old = *stats;
+
+				n_alloc *= 2;
+				*stats = mem_heap_alloc(
+					heap, n_alloc * sizeof(**stats));
+				memcpy(*stats, old, n_stats * sizeof(*old));
+			}
+
+			(*stats)[n_stats++] = count->stat;
+		}
+	}
+
+	rw_lock_s_unlock(&ibuf_index_counts_latch);
+
+	return(n_stats);
+}
 #endif /* !UNIV_HOTBACKUP */
 /*********************************************************************//**
 Initializes an ibuf bitmap page. */
@@ -2745,6 +3078,116 @@ ibuf_contract_for_n_pages(
 	return(sum_bytes);
 }
 
+/*********************************************************************//**
+Computes how many pages ibuf_merge_thread() should merge in its next
+batch. The rate grows with the fill of the change buffer and is taken
+from the I/O capacity that the server did not use during the last
+interval.
+@return	number of pages to merge */
+static
+ulint
+ibuf_merge_thread_n_pages(
+/*======================*/
+	ulint	n_ios)	/*!< in: page reads, page writes and log writes
+			during the last interval */
+{
+	ulint	fill_pct;
+	ulint	free_ios;
+	ulint	n_pages;
+
+	/* Dirty reads: an inaccurate value only makes this batch
+	somewhat larger or smaller. */
+
+	if (ibuf->empty || ibuf->max_size == 0) {
+		return(0);
+	}
+
+	fill_pct = ut_min(ibuf->size * 100 / ibuf->max_size, 100);
+
+	free_ios = n_ios < srv_io_capacity ? srv_io_capacity - n_ios : 0;
+
+	/* Use the idle I/O capacity in proportion to the fill of the
+	change buffer, and keep merging at the rate of the master
+	thread (5% of the capacity every 10 seconds) when the server
+	is busy. */
+
+	n_pages = PCT_IO(5) / 10 + free_ios * fill_pct / 100;
+
+	if (fill_pct >= IBUF_MERGE_URGENT_PCT) {
+		n_pages = ut_max(n_pages, PCT_IO(50));
+	}
+
+	return(ut_max(n_pages, 1));
+}
+
+/*********************************************************************//**
+A thread which merges the change buffer in the background while
+innodb_change_buffer_background_merge is on. Once a second, it merges a
+batch whose size depends on the fill of the change buffer and on the
+unused innodb_io_capacity, so that fewer changes are left to be merged
+synchronously when the pages are read.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+ibuf_merge_thread(
+/*==============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ib_int64_t	sig_count;
+	buf_pool_stat_t	buf_stat;
+	ulint		n_ios;
+	ulint		n_ios_old;
+	ulint		n_pages;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(ibuf_merge_thread_key);
+#endif
+
+	buf_get_total_stat(&buf_stat);
+	n_ios_old = log_sys->n_log_ios + buf_stat.n_pages_read
+		+ buf_stat.n_pages_written;
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		sig_count = os_event_reset(ibuf_merge_event);
+
+		os_event_wait_time_low(ibuf_merge_event,
+				       IBUF_MERGE_THREAD_INTERVAL,
+				       sig_count);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		buf_get_total_stat(&buf_stat);
+		n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
+			+ buf_stat.n_pages_written;
+
+		n_pages = ibuf_merge_thread_n_pages(n_ios - n_ios_old);
+
+		if (srv_ibuf_background_merge && n_pages > 0
+		    && srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE) {
+
+			ibuf_contract_for_n_pages(FALSE, n_pages);
+		}
+
+		/* The merge reads count as I/O of the next interval. */
+
+		n_ios_old = n_ios;
+	}
+
+	ibuf_merge_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*********************************************************************//**
 Contract insert buffer trees after insert if they are too big. */
 UNIV_INLINE
@@ -2760,8 +3203,8 @@ ibuf_contract_after_insert(
 	ulint	max_size;
 
 	/* Perform dirty reads of ibuf->size and ibuf->max_size, to
-	reduce ibuf_mutex contention. ibuf->max_size remains constant
-	after ibuf_init_at_db_start(), but ibuf->size should be
+	reduce ibuf_mutex contention. ibuf->max_size only changes
+	when the buffer pool is resized, but ibuf->size should be
 	protected by ibuf_mutex. Given that ibuf->size fits in a
 	machine word, this should be OK; at worst we are doing some
 	excessive ibuf_contract() or occasionally skipping a
@@ -3397,8 +3840,8 @@ ibuf_insert_low(
 	do_merge = FALSE;
 
 	/* Perform dirty reads of ibuf->size and ibuf->max_size, to
-	reduce ibuf_mutex contention. ibuf->max_size remains constant
-	after ibuf_init_at_db_start(), but ibuf->size should be
+	reduce ibuf_mutex contention. ibuf->max_size only changes
+	when the buffer pool is resized, but ibuf->size should be
 	protected by ibuf_mutex. Given that ibuf->size fits in a
 	machine word, this should be OK; at worst we are doing some
 	excessive ibuf_contract() or occasionally skipping a
@@ -3815,6 +4258,8 @@ skip_watch:
 		/* fprintf(stderr, "Ibuf insert for page no %lu of index %s\n",
 		page_no, index->name); */
 #endif
+		ibuf_index_count_inc(space, index->id, op);
+
 		return(TRUE);
 
 	} else {
@@ -4495,7 +4940,7 @@ ibuf_merge_or_delete_for_page(
 		function. When the counter is > 0, that prevents tablespace
 		from being dropped. */
 
-		tablespace_being_deleted = fil_inc_pending_ops(space);
+		tablespace_being_deleted = fil_inc_pending_ops(space, TRUE);
 
 		if (UNIV_UNLIKELY(tablespace_being_deleted)) {
 			/* Do not try to read the bitmap page from space;
@@ -4828,6 +5273,22 @@ reset_bit:
 	mutex_exit(&ibuf_mutex);
 #endif /* HAVE_ATOMIC_BUILTINS */
 
+	if (block && !corruption_noticed) {
+		/* All the entries were for the index of the page.
+		Without the page, the index is unknown; the entries
+		were then discarded because the index was dropped or
+		the tablespace is being deleted. */
+		ulint	i;
+
+		for (i = 0; i < IBUF_OP_COUNT; i++) {
+			mops[i] += dops[i];
+		}
+
+		ibuf_index_count_sub(space,
+				     btr_page_get_index_id(block->frame),
+				     mops);
+	}
+
 	if (update_ibuf_bitmap && !tablespace_being_deleted) {
 
 		fil_decr_pending_ops(space);
@@ -4928,9 +5389,113 @@ leave_loop:
 	mutex_exit(&ibuf_mutex);
 #endif /* HAVE_ATOMIC_BUILTINS */
 
+	ibuf_index_count_remove_space(space);
+
+	mem_heap_free(heap);
+}
+
+/*********************************************************************//**
+Merges all entries in the insert buffer for a given space id to the
+pages of the space. This is used in FLUSH TABLES ... FOR EXPORT. The
+caller must prevent new entries from being buffered for the space. */
+UNIV_INTERN
+void
+ibuf_merge_space(
+/*=============*/
+	ulint	space)	/*!< in: space id */
+{
+	mem_heap_t*	heap;
+	btr_pcur_t	pcur;
+	dtuple_t*	search_tuple;
+	const rec_t*	ibuf_rec;
+	ulint		page_nos[IBUF_MAX_N_PAGES_MERGED];
+	ulint		space_ids[IBUF_MAX_N_PAGES_MERGED];
+	ib_int64_t	space_versions[IBUF_MAX_N_PAGES_MERGED];
+	ib_int64_t	version;
+	ulint		n_pages;
+	mtr_t		mtr;
+
+	heap = mem_heap_create(512);
+
+	/* Use page number 0 to build the search tuple so that we get the
+	cursor positioned at the first entry for this space id */
+
+	search_tuple = ibuf_new_search_tuple_build(space, 0, heap);
+
+	version = fil_space_get_version(space);
+
+	do {
+		n_pages = 0;
+
+		ibuf_mtr_start(&mtr);
+
+		btr_pcur_open_on_user_rec(
+			ibuf->index, search_tuple, PAGE_CUR_GE,
+			BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		/* Collect the page numbers of the next entries for the
+		space. The entries are in page number order. */
+
+		while (n_pages < IBUF_MAX_N_PAGES_MERGED
+		       && btr_pcur_is_on_user_rec(&pcur)) {
+			ulint	page_no;
+
+			ibuf_rec = btr_pcur_get_rec(&pcur);
+
+			if (ibuf_rec_get_space(&mtr, ibuf_rec) != space) {
+
+				break;
+			}
+
+			page_no = ibuf_rec_get_page_no(&mtr, ibuf_rec);
+
+			if (n_pages == 0 || page_nos[n_pages - 1] != page_no) {
+				page_nos[n_pages] = page_no;
+				space_ids[n_pages] = space;
+				space_versions[n_pages] = version;
+				n_pages++;
+			}
+
+			btr_pcur_move_to_next(&pcur, &mtr);
+		}
+
+		ibuf_mtr_commit(&mtr);
+		btr_pcur_close(&pcur);
+
+		/* Reading the pages merges the buffered entries to them.
+		Wait for the last page so that we make progress. */
+
+		if (n_pages > 0) {
+			buf_read_ibuf_merge_pages(TRUE, space_ids,
+						  space_versions,
+						  page_nos, n_pages);
+		}
+	} while (n_pages > 0);
+
 	mem_heap_free(heap);
 }
 
+/*********************************************************************//**
+Resets the bitmap on an insert buffer bitmap page of a tablespace that
+is being imported: no changes are buffered for the pages that the
+bitmap describes, and their free space is unknown. The page is not in
+the buffer pool and the change is not logged. */
+UNIV_INTERN
+void
+ibuf_bitmap_page_reset(
+/*===================*/
+	page_t*	page,		/*!< in/out: bitmap page */
+	ulint	zip_size)	/*!< in: compressed page size in bytes;
+				0 for uncompressed pages */
+{
+	ut_a(ut_is_2pow(zip_size));
+	ut_ad(fil_page_get_type(page) == FIL_PAGE_IBUF_BITMAP);
+
+	memset(page + IBUF_BITMAP, 0,
+	       UT_BITS_IN_BYTES((zip_size ? zip_size : UNIV_PAGE_SIZE)
+				* IBUF_BITS_PER_PAGE));
+}
+
 /******************************************************************//**
 Looks if the insert buffer is empty.
 @return	TRUE if empty */
@@ -105,6 +105,38 @@ point if it's above the largest value in the page. */
 point if it's below the smallest value in the page. */
 #define BTR_PAGE_SPLIT_LOWER_FLAG	4
 
+/** Keep the index tree latch until the end of the mini-transaction,
+instead of releasing it when the split does not propagate upwards. */
+#define BTR_PAGE_SPLIT_KEEP_TREE_LATCH_FLAG	8
+
+/** Latches an index tree for a structure modification. Readers
+latch-couple the pages of an index tree on their way down, so that the
+modification only needs an sx-latch, which lets them in. The insert
+buffer tree is searched without latch coupling, and it is x-latched.
+@param index	the B-tree index
+@param mtr	the mini-transaction */
+#define btr_tree_modify_latch(index, mtr)				\
+	(dict_index_is_ibuf(index)					\
+	 ? mtr_x_lock(dict_index_get_lock(index), mtr)			\
+	 : mtr_sx_lock(dict_index_get_lock(index), mtr))
+
+/** The mtr memo type of the latch taken by btr_tree_modify_latch().
+@param index	the B-tree index */
+#define BTR_TREE_MODIFY_MEMO(index)					\
+	(dict_index_is_ibuf(index) ? MTR_MEMO_X_LOCK : MTR_MEMO_SX_LOCK)
+
+#ifdef UNIV_DEBUG
+/** Checks if an index tree is latched for a structure modification.
+@param index	the B-tree index
+@param mtr	the mini-transaction
+@return	TRUE if the tree latch is held in x-mode or sx-mode */
+# define btr_tree_latched_for_modify(index, mtr)			\
+	(mtr_memo_contains(mtr, dict_index_get_lock(index),		\
+			   MTR_MEMO_X_LOCK)				\
+	 || mtr_memo_contains(mtr, dict_index_get_lock(index),		\
+			      MTR_MEMO_SX_LOCK))
+#endif /* UNIV_DEBUG */
+
 #endif /* UNIV_HOTBACKUP */
 
 /**************************************************************//**
@@ -463,8 +495,9 @@ btr_page_get_split_rec_to_right(
 				or NULL if tuple should be first */
 /*************************************************************//**
 Splits an index page to halves and inserts the tuple. It is assumed
-that mtr holds an x-latch to the index tree. NOTE: the tree x-latch is
-released within this function! NOTE that the operation of this
+that mtr holds an x-latch or sx-latch to the index tree. NOTE: the tree
+latch is released within this function, unless
+BTR_PAGE_SPLIT_KEEP_TREE_LATCH_FLAG is set! NOTE that the operation of this
 function must always succeed, we cannot reverse it: therefore enough
 free disk space (2 pages) must be guaranteed to be available before
 this function is called.
@@ -597,7 +630,7 @@ btr_get_size(
 	dict_index_t*	index,	/*!< in: index */
 	ulint		flag,	/*!< in: BTR_N_LEAF_PAGES or BTR_TOTAL_SIZE */
 	mtr_t*		mtr)	/*!< in/out: mini-transaction where index
-				is s-latched */
+				is sx-latched */
 	__attribute__((nonnull, warn_unused_result));
 /**************************************************************//**
 Allocates a new file page to be used in an index tree. NOTE: we assume
@@ -623,6 +656,29 @@ btr_page_alloc(
 					the page */
 	__attribute__((nonnull, warn_unused_result));
 /**************************************************************//**
+Creates a new index page (not the root, and also not
+used in page reorganization).  @see btr_page_empty(). */
+UNIV_INTERN
+void
+btr_page_create(
+/*============*/
+	buf_block_t*	block,	/*!< in/out: page to be created */
+	page_zip_des_t*	page_zip,/*!< in/out: compressed page, or NULL */
+	dict_index_t*	index,	/*!< in: index */
+	ulint		level,	/*!< in: the B-tree level of the page */
+	mtr_t*		mtr);	/*!< in: mtr */
+/*************************************************************//**
+Empties an index page.  @see btr_page_create(). */
+UNIV_INTERN
+void
+btr_page_empty(
+/*===========*/
+	buf_block_t*	block,	/*!< in: page to be emptied */
+	page_zip_des_t*	page_zip,/*!< out: compressed page, or NULL */
+	dict_index_t*	index,	/*!< in: index of the page */
+	ulint		level,	/*!< in: the B-tree level of the page */
+	mtr_t*		mtr);	/*!< in: mtr */
+/**************************************************************//**
 Frees a file page used in an index tree. NOTE: cannot free field external
 storage pages because the page must contain info on its level. */
 UNIV_INTERN
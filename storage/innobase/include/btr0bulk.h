@@ -0,0 +1,117 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up B-tree bulk load
+
+An empty index tree is built from index entries that arrive in ascending
+order. Each level of the tree is filled page by page from left to right,
+up to innodb_index_fill_factor, and a node pointer to every finished page
+is appended to the level above it. The page contents are not redo logged:
+only the page allocations are. Each page is written to the data file when
+it is finished. The finished trees of all the indexes of a table are then
+made reachable together, by copying their top pages to the root pages of
+the indexes in a single logged mini-transaction.
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+
+#ifndef UNIV_HOTBACKUP
+#include "data0types.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/** Bulk load of an index tree */
+typedef struct btr_bulk_struct	btr_bulk_t;
+
+/*********************************************************************//**
+Checks whether an index tree can be bulk loaded. The tree must be empty,
+uncompressed, and every entry must fit on an index page without storing
+any column externally.
+@return	TRUE if btr_bulk_create() can be used on the index */
+UNIV_INTERN
+ibool
+btr_bulk_is_applicable(
+/*===================*/
+	dict_index_t*	index);	/*!< in: index */
+/*********************************************************************//**
+Starts a bulk load of an empty index tree. The pages of the new tree are
+not reachable from the root page before btr_bulk_publish(), so they are
+only latched by the mini-transactions that fill them; the index tree latch
+is acquired only for allocating pages.
+@return	own: bulk load */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index, btr_bulk_is_applicable() */
+	trx_id_t	trx_id);/*!< in: PAGE_MAX_TRX_ID of secondary index
+				leaf pages */
+/*********************************************************************//**
+Appends an entry to the index tree that is being built. The entries must
+be passed in ascending order.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	entry);	/*!< in: index entry */
+/*********************************************************************//**
+Finishes the last page of every level of the tree and writes it to the
+data file. The tree is not reachable before btr_bulk_publish().
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_end(
+/*=========*/
+	btr_bulk_t*	bulk);	/*!< in/out: bulk load */
+/*********************************************************************//**
+Makes the trees of ended bulk loads reachable from the root pages of their
+indexes, writes the redo log of that to disk, and frees the bulk loads.
+All the trees are published in one mini-transaction, so that after a crash
+either all or none of the indexes of a table contain the loaded entries. */
+UNIV_INTERN
+void
+btr_bulk_publish(
+/*=============*/
+	btr_bulk_t**	bulk,	/*!< in,own: ended bulk loads */
+	ulint		n_bulk);/*!< in: number of elements in bulk */
+/*********************************************************************//**
+Frees the pages that a bulk load has allocated, and the bulk load. The
+index tree stays empty. */
+UNIV_INTERN
+void
+btr_bulk_abort(
+/*===========*/
+	btr_bulk_t*	bulk);	/*!< in,own: bulk load */
+/*********************************************************************//**
+Empties an index tree in the rollback of a bulk insert into an empty
+table (TRX_UNDO_EMPTY). The root page stays in place. */
+UNIV_INTERN
+void
+btr_bulk_empty(
+/*===========*/
+	dict_index_t*	index);	/*!< in: index */
+#endif /* !UNIV_HOTBACKUP */
+
+#endif /* btr0bulk_h */
@@ -39,6 +39,9 @@ Created 10/16/1994 Heikki Tuuri
 #define BTR_KEEP_POS_FLAG	8	/* btr_cur_pessimistic_update()
 					must keep cursor position when
 					moving columns to big_rec */
+#define BTR_KEEP_TREE_LATCH_FLAG 16	/* btr_cur_pessimistic_insert()
+					must keep the index tree latch
+					until the end of the mtr */
 
 #ifndef UNIV_HOTBACKUP
 #include "que0types.h"
@@ -474,15 +477,33 @@ btr_estimate_n_rows_in_range(
 /*******************************************************************//**
 Estimates the number of different key values in a given index, for
 each n-column prefix of the index where n <= dict_index_get_n_unique(index).
-The estimates are stored in the array index->stat_n_diff_key_vals.
+The estimates are stored in the array n_diff_key_vals.
 If innodb_stats_method is nulls_ignored, we also record the number of
 non-null values for each prefix and stored the estimates in
-array index->stat_n_non_null_key_vals. */
+array n_non_null_key_vals. If n_sample_pages is ULINT_UNDEFINED, all leaf
+pages are scanned and the values are exact rather than estimated. */
 UNIV_INTERN
 void
 btr_estimate_number_of_different_key_vals(
 /*======================================*/
-	dict_index_t*	index);	/*!< in: index */
+	dict_index_t*	index,		/*!< in: index */
+	ulint		n_sample_pages_arg,
+					/*!< in: number of leaf pages to
+					sample, or ULINT_UNDEFINED to count
+					the values exactly */
+	ulint		index_size,	/*!< in: number of pages in the
+					index */
+	ulint		n_leaf_pages,	/*!< in: number of leaf pages in
+					the index */
+	ib_int64_t*	n_diff_key_vals,/*!< out: number of different
+					values for each n-column prefix,
+					n_unique + 1 elements */
+	ib_int64_t*	n_non_null_key_vals);
+					/*!< out: number of non-null values
+					for each n-column prefix, n_unique + 1
+					elements; only written if
+					innodb_stats_method is
+					"nulls_ignored" */
 /*******************************************************************//**
 Marks non-updated off-page fields as disowned by this record. The ownership
 must be transferred to the updated record which is inserted elsewhere in the
@@ -788,7 +809,7 @@ stored part. */
 #define BTR_EXTERN_LEN			12	/*!< 8 bytes containing the
 						length of the externally
 						stored part of the BLOB.
-						The 2 highest bits are
+						The 3 highest bits are
 						reserved to the flags below. */
 /*-------------------------------------- @} */
 /* #define BTR_EXTERN_FIELD_REF_SIZE	20 // moved to btr0types.h */
@@ -804,12 +825,22 @@ it means that the externally stored field was inherited from an
 earlier version of the row.  In rollback we are not allowed to free an
 inherited external field. */
 #define BTR_EXTERN_INHERITED_FLAG	64
+/** If the third most significant bit of BTR_EXTERN_LEN is 1 then the
+externally stored part of an uncompressed-page BLOB is a zlib stream,
+preceded by the 4-byte length of the uncompressed data.  This is set
+for columns declared with COLUMN_FORMAT COMPRESSED (DATA_COMPRESSED),
+which need innodb_file_format=Cheetah (DICT_TF_FORMAT_CODEC): older
+servers ignore the flag, so there is no downgrade. */
+#define BTR_EXTERN_COMPRESSED_FLAG	32
 
 /** Number of searches down the B-tree in btr_cur_search_to_nth_level(). */
 extern ulint	btr_cur_n_non_sea;
 /** Number of successful adaptive hash index lookups in
 btr_cur_search_to_nth_level(). */
 extern ulint	btr_cur_n_sea;
+/** Number of times a descent down the B-tree restarted from the root
+because it could not latch a page without waiting. */
+extern ulint	btr_cur_n_restarts;
 /** Old value of btr_cur_n_non_sea.  Copied by
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
@@ -343,6 +343,25 @@ btr_pcur_move_backward_from_page(
 	btr_pcur_t*	cursor,	/*!< in: persistent cursor, must be on the
 				first record of the current page */
 	mtr_t*		mtr);	/*!< in: mtr */
+/**************************************************************//**
+Looks up the leaf pages that follow the stored position of a persistent
+cursor in the direction of a scan, in key order, by reading the node
+pointers on the parent of the current leaf page.  Only the children of
+the current parent page are returned.  The caller must not hold any
+page latches.
+@return	number of page numbers stored in page_nos */
+UNIV_INTERN
+ulint
+btr_pcur_get_next_leaves(
+/*=====================*/
+	btr_pcur_t*	cursor,		/*!< in: detached persistent cursor
+					whose position is stored */
+	ibool		moves_up,	/*!< in: TRUE if the scan moves to
+					the next records, FALSE if to the
+					previous ones */
+	ulint*		page_nos,	/*!< out: page numbers of the next
+					leaf pages, in the order of the scan */
+	ulint		n_pages);	/*!< in: size of page_nos */
 #ifdef UNIV_DEBUG
 /*********************************************************//**
 Returns the btr cursor component of a persistent cursor.
@@ -501,6 +520,8 @@ struct btr_pcur_struct{
 	ib_uint64_t	modify_clock;	/*!< the modify clock value of the
 					buffer block when the cursor position
 					was stored */
+	ulint		withdraw_clock;	/*!< buf_withdraw_clock when the
+					cursor position was stored */
 	enum pcur_pos_t	pos_state;	/*!< btr_pcur_store_position() and
 					btr_pcur_restore_position() state. */
 	ulint		search_mode;	/*!< PAGE_CUR_G, ... */
@@ -48,6 +48,15 @@ void
 btr_search_sys_free(void);
 /*=====================*/
 
+/*****************************************************************//**
+Resizes the hash table of the adaptive search system.  The adaptive
+hash index must be disabled and empty. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
+
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
 UNIV_INTERN
@@ -152,6 +161,17 @@ btr_search_drop_page_hash_when_freed(
 				or 0 for uncompressed pages */
 	ulint	page_no);	/*!< in: page number */
 /********************************************************************//**
+Drops the page hash index entries of all pages of a table that is stored
+in a single-table tablespace, before the tablespace is discarded without
+evicting its pages from the buffer pool. The cost is proportional to the
+size of the tablespace, not of the buffer pool, and the scan stops as soon
+as no page of the table is hashed any more. */
+UNIV_INTERN
+void
+btr_search_drop_page_hash_for_table(
+/*================================*/
+	dict_table_t*	table);	/*!< in: table */
+/********************************************************************//**
 Updates the page hash index when a single record is inserted on a page. */
 UNIV_INTERN
 void
@@ -70,6 +70,30 @@ buf_buddy_free(
 					up to UNIV_PAGE_SIZE */
 	__attribute__((nonnull));
 
+/**********************************************************************//**
+Try to relocate a compressed page frame out of a chunk that is being
+withdrawn from the buffer pool.  The thread calling this function must
+hold buf_pool->mutex and must not hold buf_pool->zip_mutex or any
+block->mutex.  The buf_pool->mutex will not be released.
+@return	TRUE if relocated */
+UNIV_INTERN
+ibool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	void*		buf,		/*!< in: compressed page frame */
+	ulint		size);		/*!< in: compressed page size */
+
+/**********************************************************************//**
+Recombine the free blocks of the frames that are being withdrawn from
+the buffer pool with their free buddies, so that the frames can be
+freed when all their compressed pages have been relocated. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool);	/*!< in/out: buffer pool instance */
+
 #ifndef UNIV_NONINL
 # include "buf0buddy.ic"
 #endif
@@ -88,6 +88,24 @@ extern ulint srv_buf_pool_write_requests; /*!< variable to count write request
 					  issued */
 extern ulint srv_buf_pool_instances;
 extern ulint srv_buf_pool_curr_size;
+extern ulong srv_buf_pool_chunk_unit;
+
+/** Incremented each time buffer pool chunks are added or removed;
+protected by all buf_pool->mutex */
+extern ulint		buf_withdraw_clock;
+/** TRUE while blocks are being withdrawn from the buffer pool
+in order to shrink it */
+extern volatile ibool	buf_pool_withdrawing;
+/** TRUE while the buffer pool is being resized; the adaptive hash
+index cannot be enabled meanwhile */
+extern volatile ibool	buf_pool_resizing;
+/** Event to signal buf_resize_thread() */
+extern os_event_t	buf_resize_event;
+/** TRUE if buf_resize_thread() is active */
+extern ibool		buf_resize_thread_active;
+/** Progress of the last buffer pool resize, for
+Innodb_buffer_pool_resize_status */
+extern char		buf_pool_resize_status[512];
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -241,6 +259,57 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances);	/*!< in: numbere of instances to free */
 
+/********************************************************************//**
+Rounds a buffer pool size up to a multiple of
+innodb_buffer_pool_chunk_size * innodb_buffer_pool_instances.
+@return	size in bytes that can be split into whole chunks */
+UNIV_INLINE
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: requested size in bytes */
+/********************************************************************//**
+Checks if pointers to blocks of the buffer pool that were obtained when
+buf_withdraw_clock had the given value may have become stale, because
+the buffer pool has been resized or is being shrunk since.
+@return	TRUE if buf_page_optimistic_get() must not be attempted */
+UNIV_INLINE
+ibool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);	/*!< in: buf_withdraw_clock
+					at the time of the guess */
+/********************************************************************//**
+Determines if a block is in a chunk that is being withdrawn from the
+buffer pool.
+@return	TRUE if the block will be removed along with its chunk */
+UNIV_INTERN
+ibool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block);		/*!< in: block */
+/********************************************************************//**
+Determines if a frame is in a chunk that is being withdrawn from the
+buffer pool.
+@return	TRUE if the frame will be removed along with its chunk */
+UNIV_INTERN
+ibool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr);		/*!< in: pointer into a frame */
+/********************************************************************//**
+A thread which resizes the buffer pool to innodb_buffer_pool_size
+after SET GLOBAL innodb_buffer_pool_size.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_resize_thread(
+/*==============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Clears the adaptive hash index on all pages in the buffer pool. */
 UNIV_INTERN
@@ -1529,6 +1598,11 @@ struct buf_page_struct{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	unsigned	read_ahead_logical:1;
+					/*!< TRUE if the page was read in
+					by buf_read_ahead_logical() and has
+					not been accessed yet. Protected by
+					block mutex */
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
 					/*!< this is set to TRUE when fsp
@@ -1700,6 +1774,13 @@ struct buf_pool_stat_struct{
 	ulint	n_ra_pages_evicted;/*!< number of read ahead
 				pages that are evicted without
 				being accessed */
+	ulint	n_ra_pages_read_logical;/*!< number of pages read in
+				as part of logical read ahead */
+	ulint	n_ra_pages_logical_hit;/*!< number of logical read
+				ahead pages that were accessed */
+	ulint	n_ra_pages_logical_evicted;/*!< number of logical
+				read ahead pages that are evicted
+				without being accessed */
 	ulint	n_pages_made_young; /*!< number of pages made young, in
 				calls to buf_LRU_make_block_young() */
 	ulint	n_pages_not_made_young; /*!< number of pages not made
@@ -1748,8 +1829,24 @@ struct buf_pool_struct{
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
-	ulint		n_chunks;	/*!< number of buffer pool chunks */
+	ulint		n_chunks;	/*!< number of buffer pool chunks;
+					buf_block_align() reads it and
+					chunks without holding the mutex */
+	ulint		n_chunks_new;	/*!< number of chunks after an
+					ongoing resize; while it is smaller
+					than n_chunks, the blocks of
+					chunks[n_chunks_new..n_chunks-1]
+					are being withdrawn */
 	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	mem_heap_t*	chunks_heap;	/*!< heap of chunks[] */
+	ulint		n_chunks_old;	/*!< number of chunks before the
+					last resize; while it is larger
+					than n_chunks, the removed
+					chunks[n_chunks..n_chunks_old-1]
+					are yet to be freed */
+	mem_heap_t*	chunks_old_heap;/*!< heap of the chunks[] array
+					that the last resize replaced,
+					or NULL */
 	ulint		curr_size;	/*!< current pool size in pages */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
@@ -1833,6 +1930,14 @@ struct buf_pool_struct{
 	UT_LIST_BASE_NODE_T(buf_page_t) free;
 					/*!< base node of the free
 					block list */
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the list of
+					free blocks of the chunks that
+					are being withdrawn */
+	ulint		withdraw_target;/*!< number of blocks in the
+					chunks being withdrawn; the
+					withdrawal is complete when
+					the withdraw list is this long */
 	UT_LIST_BASE_NODE_T(buf_page_t) LRU;
 					/*!< base node of the LRU list */
 	buf_page_t*	LRU_old;	/*!< pointer to the about
@@ -132,6 +132,31 @@ buf_flush_list(
 					smaller than this should be flushed
 					(if their number does not exceed
 					min_n), otherwise ignored */
+/********************************************************************//**
+Writes a dirty page outside of a flush batch.  This is used for writing
+the pages of a single tablespace.  The write may stay in the doublewrite
+memory buffer until buf_flush_buffered_writes() is called.
+NOTE: buf_pool->mutex and buf_page_get_mutex(bpage) must be held upon
+entering this function, and they will be released by this function.
+@return TRUE if the write was queued, FALSE if the tablespace has been
+dropped and the page was removed from the flush list instead */
+UNIV_INTERN
+ibool
+buf_flush_single_page(
+/*==================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_page_t*	bpage);		/*!< in: dirty page, ready for
+					BUF_FLUSH_LIST */
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+UNIV_INTERN
+void
+buf_flush_buffered_writes(void);
+/*===========================*/
 /******************************************************************//**
 Waits until a flush batch of the given type ends */
 UNIV_INTERN
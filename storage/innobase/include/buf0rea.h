@@ -100,6 +100,23 @@ buf_read_ahead_linear(
 	ulint	offset,		/*!< in: page number; see NOTE 3 above */
 	ibool	inside_ibuf);	/*!< in: TRUE if we are inside ibuf routine */
 /********************************************************************//**
+Applies a logical read-ahead: issues asynchronous read requests for the
+leaf pages that a B-tree scan will visit next, in key order.  Unlike
+buf_read_ahead_linear(), this does not depend on the leaf pages being
+physically contiguous.  The caller must not hold any page latches.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_logical(
+/*===================*/
+	ulint		space,		/*!< in: space id */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes, or 0 */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					in the order of the scan */
+	ulint		n_stored);	/*!< in: number of page numbers
+					in the array */
+/********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
 a read-ahead function. */
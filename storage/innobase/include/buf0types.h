@@ -68,8 +68,15 @@ enum buf_io_fix {
 enum buf_remove_t {
 	BUF_REMOVE_ALL_NO_WRITE,	/*!< Remove all pages from the buffer
 					pool, don't write or sync to disk */
-	BUF_REMOVE_FLUSH_NO_WRITE	/*!< Remove only, from the flush list,
+	BUF_REMOVE_FLUSH_NO_WRITE,	/*!< Remove only, from the flush list,
 					don't write or sync to disk */
+	BUF_REMOVE_FLUSH_WRITE,		/*!< Write all the dirty pages to
+					disk and sync the file, but leave
+					the pages in the buffer pool */
+	BUF_REMOVE_NONE			/*!< Leave the pages in the buffer
+					pool; dirty pages are discarded
+					when the flush finds the tablespace
+					gone, clean pages age out of the LRU */
 };
 
 /** Parameters of binary buddy system for compressed pages (buf0buddy.h) */
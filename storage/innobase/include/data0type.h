@@ -158,6 +158,10 @@ be less than 256 */
 				type when the column is true VARCHAR where
 				MySQL uses 2 bytes to store the data len;
 				for shorter VARCHARs MySQL uses only 1 byte */
+#define	DATA_COMPRESSED	8192	/* this is ORed to the precise data type
+				of a BLOB or TEXT column declared with
+				COLUMN_FORMAT COMPRESSED: the externally
+				stored part of the column is compressed */
 /*-------------------------------------------*/
 
 /* This many bytes we need to store the type information affecting the
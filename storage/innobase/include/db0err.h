@@ -115,6 +115,11 @@ enum db_err {
 	DB_TABLE_IN_FK_CHECK,		/* table is being used in foreign
 					key check */
 	DB_IDENTIFIER_TOO_LONG,		/* Identifier name too long */
+	DB_SCHEMA_MISMATCH,		/* the tablespace or the metadata
+					file to be imported does not
+					match the table definition */
+	DB_IO_ERROR,			/* a file could not be read or
+					written */
 
 	/* The following are partial failure codes */
 	DB_FAIL = 1000,
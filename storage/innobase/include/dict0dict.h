@@ -259,6 +259,41 @@ dict_table_autoinc_update_if_greater(
 	dict_table_t*	table,	/*!< in/out: table */
 	ib_uint64_t	value);	/*!< in: value which was assigned to a row */
 /********************************************************************//**
+Reads the next autoinc value without acquiring the autoinc lock.  The
+value may be stale; it is meant to be passed to
+dict_table_autoinc_compare_and_swap().
+@return	value for a new row, or 0 */
+UNIV_INTERN
+ib_uint64_t
+dict_table_autoinc_peek(
+/*====================*/
+	dict_table_t*	table);	/*!< in: table */
+/********************************************************************//**
+Replaces the autoinc counter if it still has the expected value.  This
+reserves AUTOINC values without holding the autoinc lock across the
+computation of the interval.  The caller must not hold the autoinc lock.
+@return	TRUE if the counter was replaced */
+UNIV_INTERN
+ibool
+dict_table_autoinc_compare_and_swap(
+/*================================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ib_uint64_t	old_value,	/*!< in: expected counter value */
+	ib_uint64_t	new_value);	/*!< in: new counter value */
+/********************************************************************//**
+Replaces the autoinc counter if it still has the expected value, which
+the caller read while holding the autoinc lock.  Concurrent
+dict_table_autoinc_compare_and_swap() calls do not acquire the lock,
+and they may have moved the counter since.
+@return	TRUE if the counter was replaced */
+UNIV_INTERN
+ibool
+dict_table_autoinc_replace(
+/*=======================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ib_uint64_t	old_value,	/*!< in: expected counter value */
+	ib_uint64_t	new_value);	/*!< in: new counter value */
+/********************************************************************//**
 Release the autoinc lock. */
 UNIV_INTERN
 void
@@ -748,6 +783,37 @@ ulint
 dict_table_zip_size(
 /*================*/
 	const dict_table_t*	table);	/*!< in: table */
+/********************************************************************//**
+Determine the flags of the single-table tablespace of a table: the table
+flags, and for ROW_FORMAT=COMPRESSED the page compression codec and level.
+@return	tablespace flags (FSP_SPACE_FLAGS) */
+UNIV_INTERN
+ulint
+dict_table_get_space_flags(
+/*=======================*/
+	const dict_table_t*	table);	/*!< in: table */
+/********************************************************************//**
+Determine the file format that the system tablespace must be tagged
+with before the tablespace of a table is written.  This is the format
+of the table, or DICT_TF_FORMAT_CODEC if the table is compressed with
+a codec or level other than the default or has a column declared
+COLUMN_FORMAT COMPRESSED.
+@return	file format id */
+UNIV_INTERN
+ulint
+dict_table_get_format_tag(
+/*======================*/
+	const dict_table_t*	table);	/*!< in: table */
+/********************************************************************//**
+Set the page compression codec and level of a table from the flags of
+its tablespace. */
+UNIV_INTERN
+void
+dict_table_set_zip_compression(
+/*===========================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ulint		space_flags);	/*!< in: tablespace flags,
+					or ULINT_UNDEFINED */
 #ifndef UNIV_HOTBACKUP
 /*********************************************************************//**
 Obtain exclusive locks on all index trees of the table. This is to prevent
@@ -970,6 +1036,17 @@ dict_index_add_col(
 	const dict_table_t*	table,		/*!< in: table */
 	dict_col_t*		col,		/*!< in: column */
 	ulint			prefix_len);	/*!< in: column prefix length */
+/*******************************************************************//**
+Computes the offsets of the leading NOT NULL fixed-length fields of an
+index in ROW_FORMAT=COMPACT or newer, which are the same in every record,
+and sets index->n_fixed_prefix, index->n_norm_prefix and
+index->fixed_offs. */
+UNIV_INTERN
+void
+dict_index_build_fixed_offs(
+/*========================*/
+	dict_index_t*		index);		/*!< in/out: index whose
+						fields are all defined */
 #ifndef UNIV_HOTBACKUP
 /*******************************************************************//**
 Copies types of fields contained in index to tuple. */
@@ -1135,8 +1212,43 @@ recalculated
 	((ib_int64_t) (t)->stat_modified_counter > 16 + (t)->stat_n_rows / 16)
 
 /*********************************************************************//**
+Calculates new estimates for the statistics of a single index. If the
+index tree cannot be accessed because of a high innodb_force_recovery
+setting, or the tree is corrupt, bogus statistics are returned so that
+the index can still be used by the optimizer. */
+UNIV_INTERN
+void
+dict_index_calc_statistics(
+/*=======================*/
+	dict_index_t*	index,		/*!< in: index */
+	ulint		n_sample_pages,	/*!< in: number of leaf pages to
+					sample, or ULINT_UNDEFINED to count
+					the values exactly */
+	ulint*		index_size,	/*!< out: number of pages in the
+					index */
+	ulint*		n_leaf_pages,	/*!< out: number of leaf pages in
+					the index */
+	ib_int64_t*	n_diff_key_vals,/*!< out: number of different
+					values for each n-column prefix,
+					n_unique + 1 elements */
+	ib_int64_t*	n_non_null_key_vals);
+					/*!< out: number of non-null values
+					for each n-column prefix, n_unique + 1
+					elements */
+/*********************************************************************//**
+Sums up the table level statistics from the statistics of the indexes of
+the table. The caller must hold the statistics latch in X mode. */
+UNIV_INTERN
+void
+dict_table_sum_index_statistics(
+/*============================*/
+	dict_table_t*	table);	/*!< in/out: table */
+/*********************************************************************//**
 Calculates new estimates for table and index statistics. The statistics
-are used in query optimization. */
+are used in query optimization. If innodb_stats_persistent is enabled,
+the statistics are loaded from SYS_STATS when they are first needed, and
+recalculations caused by row changes are left to the background
+statistics thread instead of being done here. */
 UNIV_INTERN
 void
 dict_update_statistics(
@@ -92,16 +92,31 @@ combination of types */
 #define DICT_TF_FORMAT_ZIP		1	/*!< InnoDB plugin for 5.1:
 						compressed tables,
 						new BLOB treatment */
+#define DICT_TF_FORMAT_CODEC		2	/*!< page compression codec
+						and level of compressed
+						tables in the tablespace
+						flags, and compressed
+						externally stored columns
+						(DATA_COMPRESSED,
+						BTR_EXTERN_COMPRESSED_FLAG).
+						The table flags
+						stay DICT_TF_FORMAT_ZIP;
+						only the system tablespace
+						is tagged, so that older
+						servers refuse to start.
+						There is no downgrade. */
 /** Maximum supported file format */
-#define DICT_TF_FORMAT_MAX		DICT_TF_FORMAT_ZIP
+#define DICT_TF_FORMAT_MAX		DICT_TF_FORMAT_CODEC
+/** Maximum file format in the table flags */
+#define DICT_TF_FORMAT_TABLE_MAX	DICT_TF_FORMAT_ZIP
 
 /** Minimum supported file format */
 #define DICT_TF_FORMAT_MIN		DICT_TF_FORMAT_51
 
 /* @} */
 #define DICT_TF_BITS			6	/*!< number of flag bits */
-#if (1 << (DICT_TF_BITS - DICT_TF_FORMAT_SHIFT)) <= DICT_TF_FORMAT_MAX
-# error "DICT_TF_BITS is insufficient for DICT_TF_FORMAT_MAX"
+#if (1 << (DICT_TF_BITS - DICT_TF_FORMAT_SHIFT)) <= DICT_TF_FORMAT_TABLE_MAX
+# error "DICT_TF_BITS is insufficient for DICT_TF_FORMAT_TABLE_MAX"
 #endif
 /* @} */
 
@@ -122,6 +137,20 @@ ROW_FORMAT=REDUNDANT. */
 						in table->flags. */
 /* @} */
 
+/** Values of dict_table_t::quiesce for FLUSH TABLES ... FOR EXPORT */
+/* @{ */
+#define DICT_QUIESCE_NONE		0	/*!< the table is not
+						being exported */
+#define DICT_QUIESCE_START		1	/*!< purge, the change
+						buffer and the buffer pool
+						are being flushed for the
+						table */
+#define DICT_QUIESCE_COMPLETE		2	/*!< the .ibd file is
+						consistent and the .cfg file
+						has been written; the table
+						can be copied */
+/* @} */
+
 /** Tables could be chained together with Foreign key constraint. When
 first load the parent table, we would load all of its descedents.
 This could result in rescursive calls and out of stack error eventually.
@@ -397,6 +426,19 @@ struct dict_index_struct{
 	unsigned	n_def:10;/*!< number of fields defined so far */
 	unsigned	n_fields:10;/*!< number of fields in the index */
 	unsigned	n_nullable:10;/*!< number of nullable fields */
+	unsigned	n_fixed_prefix:10;
+				/*!< number of fields from the beginning
+				that are NOT NULL and of a fixed length
+				in ROW_FORMAT=COMPACT or newer: they are at
+				the same offsets in every record; 0 for
+				ROW_FORMAT=REDUNDANT and for indexes that
+				are not in the dictionary cache */
+	unsigned	n_norm_prefix:10;
+				/*!< number of the first n_fixed_prefix
+				fields whose stored values compare like
+				memcmp() (integers and binary strings):
+				page_cur_search_with_match() compares them
+				as one normalized key */
 	unsigned	cached:1;/*!< TRUE if the index object is in the
 				dictionary cache */
 	unsigned	to_be_dropped:1;
@@ -406,6 +448,9 @@ struct dict_index_struct{
 				dict_sys->mutex, dict_operation_lock and
 				index->lock.*/
 	dict_field_t*	fields;	/*!< array of field descriptions */
+	const ulint*	fixed_offs;/*!< end offsets of the first
+				n_fixed_prefix fields from the origin of a
+				record, as in rec_get_offsets() */
 #ifndef UNIV_HOTBACKUP
 	UT_LIST_NODE_T(dict_index_t)
 			indexes;/*!< list of indexes of the table */
@@ -539,6 +584,18 @@ struct dict_table_struct{
 	unsigned	n_cols:10;/*!< number of columns */
 	unsigned	corrupted:1;
 				/*!< TRUE if table is corrupted */
+	unsigned	zip_codec:2;
+				/*!< page compression codec of
+				ROW_FORMAT=COMPRESSED, PAGE_ZIP_CODEC_ZLIB, ...;
+				FSP_FLAGS_ZIP_CODEC of the tablespace */
+	unsigned	zip_level:4;
+				/*!< zlib compression level, or 0 for the
+				default; FSP_FLAGS_ZIP_LEVEL of the
+				tablespace */
+	unsigned	quiesce:2;
+				/*!< DICT_QUIESCE_NONE, ...; protected by
+				the MDL lock that FLUSH TABLES ... FOR
+				EXPORT holds on the table */
 	dict_col_t*	cols;	/*!< array of column descriptions */
 	const char*	col_names;
 				/*!< Column names packed in a character string
@@ -630,6 +687,10 @@ struct dict_table_struct{
 	unsigned	stat_initialized:1; /*!< TRUE if statistics have
 				been calculated the first time
 				after database startup or table creation */
+	unsigned	stat_persistent:1; /*!< TRUE if the statistics
+				were loaded from SYS_STATS or calculated
+				for storing there, rather than estimated
+				from the small transient sample */
 	ib_int64_t	stat_n_rows;
 				/*!< approximate number of rows in the table;
 				we periodically calculate new estimates */
@@ -651,6 +712,18 @@ struct dict_table_struct{
 				calculation; this counter is not protected by
 				any latch, because this is only used for
 				heuristics */
+	ibool		stat_bg_queued;
+				/*!< TRUE if the table is in the queue of
+				the background statistics thread; protected
+				by the queue mutex in dict0stats.c */
+	ibool		stat_bg_in_progress;
+				/*!< TRUE while the background statistics
+				thread is sampling the indexes without
+				holding the dictionary latch; protected by
+				dict_sys->mutex. Operations that drop or
+				truncate the indexes must wait for this
+				to become FALSE with
+				dict_stats_wait_bg_to_stop_using_table() */
 				/* @} */
 	/*----------------------*/
 				/**!< The following fields are used by the
@@ -678,7 +751,10 @@ struct dict_table_struct{
 				if we do a large insert from a select */
 	mutex_t		autoinc_mutex;
 				/*!< mutex protecting the autoincrement
-				counter */
+				counter; statements that do not take
+				the AUTO-INC lock reserve their
+				intervals without it, by
+				dict_table_autoinc_compare_and_swap() */
 	ib_uint64_t	autoinc;/*!< autoinc counter value to give to the
 				next inserted row */
 	ulong		n_waiting_or_granted_auto_inc_locks;
@@ -0,0 +1,155 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/dict0stats.h
+Persistent index statistics
+
+The per-index cardinality estimates used by the optimizer are stored in
+the internal table SYS_STATS, one row per (index id, number of key
+columns) pair, so that they survive a restart and do not change every
+time a table is opened. Recalculation is done by a background thread
+with a bigger sample than the transient statistics, or exactly by
+ANALYZE TABLE.
+*******************************************************/
+
+#ifndef dict0stats_h
+#define dict0stats_h
+
+#include "univ.i"
+
+#ifndef UNIV_HOTBACKUP
+#include "dict0types.h"
+#include "trx0types.h"
+#include "os0thread.h"
+
+/** TRUE while the background statistics thread is running */
+extern ibool	dict_stats_thread_active;
+
+/** Event to wake up the background statistics thread */
+extern os_event_t	dict_stats_event;
+
+/*********************************************************************//**
+Opens the SYS_STATS system table, creating it first if it does not exist
+yet and create is TRUE, and keeps it open for the lifetime of the server.
+It is created when innodb_stats_persistent is first enabled.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_create_or_check_sys_table(
+/*=================================*/
+	ibool	create);/*!< in: TRUE if a missing table is to be
+			created; FALSE to only open an existing one */
+/*********************************************************************//**
+Checks whether the statistics of a table are to be kept in SYS_STATS.
+@return	TRUE if innodb_stats_persistent applies to the table */
+UNIV_INTERN
+ibool
+dict_stats_is_persistent_enabled(
+/*=============================*/
+	const dict_table_t*	table);	/*!< in: table */
+/*********************************************************************//**
+Loads the statistics of a table from SYS_STATS into the dictionary cache.
+Only the index sizes are read from the tablespace; no leaf pages are
+sampled.
+@return	TRUE if statistics for all indexes were found */
+UNIV_INTERN
+ibool
+dict_stats_fetch(
+/*=============*/
+	dict_table_t*	table);	/*!< in/out: table */
+/*********************************************************************//**
+Recalculates the statistics of a table into a private buffer and then
+publishes them in the dictionary cache. The statistics latch is held only
+while publishing, so queries that read the statistics are not blocked for
+the duration of the calculation. */
+UNIV_INTERN
+void
+dict_stats_recalc(
+/*==============*/
+	dict_table_t*	table,		/*!< in/out: table */
+	ulint		n_sample_pages);/*!< in: number of leaf pages to
+					sample per index, or ULINT_UNDEFINED
+					to count the values exactly */
+/*********************************************************************//**
+Adds a table to the queue of the background statistics thread, unless it
+is already there. If the queue is full the request is dropped; the table
+will be queued again by the next change. */
+UNIV_INTERN
+void
+dict_stats_enqueue(
+/*===============*/
+	dict_table_t*	table);	/*!< in/out: table */
+/*********************************************************************//**
+Deletes the SYS_STATS rows of an index that is being dropped. The caller
+must have locked the data dictionary in X mode.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_delete_index_stats(
+/*==========================*/
+	const dict_index_t*	index,	/*!< in: index */
+	trx_t*			trx);	/*!< in/out: dictionary transaction */
+/*********************************************************************//**
+Deletes the SYS_STATS rows of all indexes of a table that is being
+dropped or truncated. The caller must have locked the data dictionary
+in X mode.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_stats_delete_table_stats(
+/*==========================*/
+	const dict_table_t*	table,	/*!< in: table */
+	trx_t*			trx);	/*!< in/out: dictionary transaction */
+/*********************************************************************//**
+Waits until the background statistics thread has stopped sampling a
+table, so that its indexes can be dropped or their trees freed. The
+caller must have locked the data dictionary in X mode; the latch is
+released while waiting. */
+UNIV_INTERN
+void
+dict_stats_wait_bg_to_stop_using_table(
+/*===================================*/
+	dict_table_t*	table,	/*!< in: table */
+	trx_t*		trx);	/*!< in/out: transaction that holds
+				the dictionary latch */
+/*********************************************************************//**
+Initializes the background statistics queue. */
+UNIV_INTERN
+void
+dict_stats_init(void);
+/*=================*/
+/*********************************************************************//**
+Frees the background statistics queue at shutdown. */
+UNIV_INTERN
+void
+dict_stats_close(void);
+/*==================*/
+/*********************************************************************//**
+A thread which recalculates the statistics of queued tables with
+innodb_stats_persistent_sample_pages and stores them in SYS_STATS.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+dict_stats_thread(
+/*==============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+#endif /* !UNIV_HOTBACKUP */
+
+#endif /* dict0stats_h */
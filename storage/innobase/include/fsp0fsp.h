@@ -49,6 +49,40 @@ Created 12/18/1995 Heikki Tuuri
 		((flags & FSP_FLAGS_MASK_PAGE_SSIZE)		\
 		>> FSP_FLAGS_POS_PAGE_SSIZE)
 
+/** Number of flag bits used to indicate the page compression codec
+of ROW_FORMAT=COMPRESSED (PAGE_ZIP_CODEC_ZLIB, ...) */
+#define FSP_FLAGS_WIDTH_ZIP_CODEC	2
+/** Zero relative shift position of the ZIP_CODEC field */
+#define FSP_FLAGS_POS_ZIP_CODEC		11
+/** Bit mask of the ZIP_CODEC field */
+#define FSP_FLAGS_MASK_ZIP_CODEC				\
+		((~(~0U << FSP_FLAGS_WIDTH_ZIP_CODEC))		\
+		<< FSP_FLAGS_POS_ZIP_CODEC)
+/** Return the value of the ZIP_CODEC field */
+#define FSP_FLAGS_GET_ZIP_CODEC(flags)				\
+		((flags & FSP_FLAGS_MASK_ZIP_CODEC)		\
+		>> FSP_FLAGS_POS_ZIP_CODEC)
+
+/** Number of flag bits used to indicate the zlib compression level,
+1 to 9, or 0 for the zlib default */
+#define FSP_FLAGS_WIDTH_ZIP_LEVEL	4
+/** Zero relative shift position of the ZIP_LEVEL field */
+#define FSP_FLAGS_POS_ZIP_LEVEL		13
+/** Bit mask of the ZIP_LEVEL field */
+#define FSP_FLAGS_MASK_ZIP_LEVEL				\
+		((~(~0U << FSP_FLAGS_WIDTH_ZIP_LEVEL))		\
+		<< FSP_FLAGS_POS_ZIP_LEVEL)
+/** Return the value of the ZIP_LEVEL field */
+#define FSP_FLAGS_GET_ZIP_LEVEL(flags)				\
+		((flags & FSP_FLAGS_MASK_ZIP_LEVEL)		\
+		>> FSP_FLAGS_POS_ZIP_LEVEL)
+
+/** Bit mask of the tablespace flags that are not table flags:
+they only select how the pages are compressed, and pages are
+decompressed the same way whatever their values */
+#define FSP_FLAGS_MASK_ZIP_COMPRESSION				\
+		(FSP_FLAGS_MASK_ZIP_CODEC | FSP_FLAGS_MASK_ZIP_LEVEL)
+
 /* @} */
 
 /* @defgroup Tablespace Header Constants (moved from fsp0fsp.c) @{ */
@@ -177,6 +211,21 @@ fsp_header_get_zip_size(
 /*====================*/
 	const page_t*	page);	/*!< in: first page of a tablespace */
 /**********************************************************************//**
+Checks if a page is free according to the extent descriptor page that
+describes it. This is used on tablespace files that are not open, such
+as in IMPORT TABLESPACE, where the descriptor page is not in the buffer
+pool.
+@return	TRUE if the page is free */
+UNIV_INTERN
+ibool
+fsp_descr_page_is_free(
+/*===================*/
+	const page_t*	descr_page,	/*!< in: extent descriptor page
+					describing page_no */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes; 0 for uncompressed pages */
+	ulint		page_no);	/*!< in: page number */
+/**********************************************************************//**
 Writes the space id and compressed page size to a tablespace header.
 This function is used past the buffer pool when we in fil0fil.c create
 a new single-table tablespace. */
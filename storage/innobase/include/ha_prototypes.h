@@ -29,6 +29,7 @@ Created 5/11/2006 Osku Salerma
 
 #include "trx0types.h"
 #include "m_ctype.h" /* CHARSET_INFO */
+#include "my_base.h" /* enum icp_result */
 
 /*********************************************************************//**
 Wrapper around MySQL's copy_and_convert function.
@@ -277,6 +278,17 @@ thd_lock_wait_timeout(
 	void*	thd);	/*!< in: thread handle (THD*), or NULL to query
 			the global innodb_lock_wait_timeout */
 
+/******************************************************************//**
+Returns the number of leaf pages to read ahead in index scans of the
+current connection.
+@return	innodb_logical_read_ahead, or 0 if disabled */
+
+ulint
+thd_logical_read_ahead(
+/*===================*/
+	void*	thd);	/*!< in: thread handle (THD*), or NULL to query
+			the global innodb_logical_read_ahead */
+
 /******************************************************************//**
 Get the set of flags specified in innodb_index_page_split_mode.
 @return	set of flags that are set */
@@ -336,5 +348,14 @@ innobase_convert_to_filename_charset(
 	const char*     from,   /* in: identifier to convert */
 	ulint           len);   /* in: length of 'to', in bytes */
 
+/****************************************************************//**
+Checks the index condition that was pushed to a handler on the index
+columns that row_search_for_mysql() has stored into the row buffer.
+@return	ICP_NO_MATCH, ICP_MATCH or ICP_OUT_OF_RANGE */
+UNIV_INTERN
+enum icp_result
+innobase_index_cond(
+/*================*/
+	const void*	file);	/*!< in: ha_innobase handler */
 
 #endif
@@ -78,6 +78,16 @@ struct ibuf_stat_struct{
 					index being dropped */
 };
 
+/** Operations buffered for an index since the server was started */
+struct ibuf_index_stat_struct{
+	ulint		space;		/*!< space id */
+	index_id_t	index_id;	/*!< index id */
+	ulint		n_ops[IBUF_OP_COUNT];
+					/*!< number of operations of each
+					type that are buffered and not yet
+					merged or discarded */
+};
+
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
 /** Flag to control insert buffer debugging. */
 extern uint		ibuf_debug;
@@ -86,6 +96,11 @@ extern uint		ibuf_debug;
 /** The insert buffer control structure */
 extern ibuf_t*		ibuf;
 
+/** Event to wake up ibuf_merge_thread() */
+extern os_event_t	ibuf_merge_event;
+/** TRUE if ibuf_merge_thread() is active */
+extern ibool		ibuf_merge_thread_active;
+
 /* The purpose of the insert buffer is to reduce random disk access.
 When we wish to insert a record into a non-unique secondary index and
 the B-tree leaf page where the record belongs to is not in the buffer
@@ -113,6 +128,13 @@ void
 ibuf_init_at_db_start(void);
 /*=======================*/
 /*********************************************************************//**
+Updates the maximum size of the insert buffer after the buffer pool
+has been resized. */
+UNIV_INTERN
+void
+ibuf_max_size_update(void);
+/*======================*/
+/*********************************************************************//**
 Reads the biggest tablespace id from the high end of the insert buffer
 tree and updates the counter in fil_system. */
 UNIV_INTERN
@@ -373,6 +395,27 @@ ibuf_delete_for_discarded_space(
 /*============================*/
 	ulint	space);	/*!< in: space id */
 /*********************************************************************//**
+Merges all entries in the insert buffer for a given space id to the
+pages of the space. This is used in FLUSH TABLES ... FOR EXPORT. The
+caller must prevent new entries from being buffered for the space. */
+UNIV_INTERN
+void
+ibuf_merge_space(
+/*=============*/
+	ulint	space);	/*!< in: space id */
+/*********************************************************************//**
+Resets the bitmap on an insert buffer bitmap page of a tablespace that
+is being imported: no changes are buffered for the pages that the
+bitmap describes, and their free space is unknown. The page is not in
+the buffer pool and the change is not logged. */
+UNIV_INTERN
+void
+ibuf_bitmap_page_reset(
+/*===================*/
+	page_t*	page,		/*!< in/out: bitmap page */
+	ulint	zip_size);	/*!< in: compressed page size in bytes;
+				0 for uncompressed pages */
+/*********************************************************************//**
 Contracts insert buffer trees by reading pages to the buffer pool.
 @return a lower limit for the combined size in bytes of entries which
 will be merged from ibuf trees to the pages read, 0 if ibuf is
@@ -399,6 +442,16 @@ ibuf_contract_for_n_pages(
 	ulint	n_pages);/*!< in: try to read at least this many pages to
 			the buffer pool and merge the ibuf contents to
 			them */
+/*********************************************************************//**
+A thread which merges the change buffer in the background while
+innodb_change_buffer_background_merge is on.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+ibuf_merge_thread(
+/*==============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
 #endif /* !UNIV_HOTBACKUP */
 /*********************************************************************//**
 Parses a redo log record of an ibuf bitmap page init.
@@ -445,6 +498,25 @@ void
 ibuf_get_stats(
 /*===========*/
 	ibuf_stat_t*	stat);	/*!< out: ibuf stats */
+/******************************************************************//**
+Forgets the buffered operation counts of an index whose tree is freed
+by DROP INDEX, DROP TABLE or TRUNCATE TABLE. */
+UNIV_INTERN
+void
+ibuf_index_count_remove_index(
+/*==========================*/
+	ulint		space,		/*!< in: space id */
+	index_id_t	index_id);	/*!< in: index id */
+/******************************************************************//**
+Returns a snapshot of the operations buffered for each index since the
+server was started.
+@return	number of elements in *stats */
+UNIV_INTERN
+ulint
+ibuf_get_index_stats(
+/*=================*/
+	mem_heap_t*		heap,	/*!< in: memory heap for *stats */
+	ibuf_index_stat_t**	stats);	/*!< out: array of counts */
 /********************************************************************
 Read the first two bytes from a record's fourth field (counter field in new
 records; something else in older records).
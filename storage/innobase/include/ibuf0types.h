@@ -28,5 +28,6 @@ Created 7/29/1997 Heikki Tuuri
 
 typedef	struct ibuf_struct	ibuf_t;
 typedef	struct ibuf_stat_struct	ibuf_stat_t;
+typedef	struct ibuf_index_stat_struct	ibuf_index_stat_t;
 
 #endif
@@ -226,6 +226,27 @@ log_buffer_sync_in_background(
 /*==========================*/
 	ibool	flush);	/*<! in: flush the logs to disk */
 /****************************************************************//**
+Writes the log buffer to the log files and flushes them to disk up to
+the given lsn, or up to the current lsn if that is smaller. Waits for
+the flush to complete. */
+UNIV_INTERN
+void
+log_flush_up_to(
+/*============*/
+	ib_uint64_t	lsn);	/*!< in: lsn that must be on disk */
+/*********************************************************************//**
+A thread which writes and flushes the log buffer every
+innodb_flush_log_interval milliseconds, so that transactions committed
+with innodb_flush_log_at_trx_commit=0 or 2 or with innodb_async_commit
+become durable within that interval.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+log_flush_thread(
+/*=============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+/****************************************************************//**
 Advances the smallest lsn for which there are unflushed dirty blocks in the
 buffer pool and also may make a new checkpoint. NOTE: this function may only
 be called if the calling thread owns no synchronization objects!
@@ -573,6 +594,9 @@ log_mem_free(void);
 
 extern log_t*	log_sys;
 
+/** TRUE if log_flush_thread() is running */
+extern ibool	log_flush_thread_active;
+
 /* Values used as flags */
 #define LOG_FLUSH	7652559
 #define LOG_CHECKPOINT	78656949
@@ -861,6 +885,9 @@ struct log_struct{
 					first FALSE and becomes TRUE
 					when one log group has been
 					written or flushed */
+	os_event_t	flush_timer_event;/*!< set to wake up
+					log_flush_thread() before its
+					interval elapses */
 	os_event_t	one_flushed_event;/*!< this event is reset when the
 					flush or write has not yet completed
 					for any log group; e.g., this means
@@ -237,6 +237,19 @@ mlog_parse_index(
 	ibool		comp,	/*!< in: TRUE=compact record format */
 	dict_index_t**	index);	/*!< out, own: dummy index */
 
+/* The number of fields of an index in a log record written by
+mlog_open_and_write_index() never exceeds REC_MAX_N_FIELDS.  The
+remaining high-order bits of that field carry the page compression
+codec and level of the table, so that pages that are recompressed
+during redo apply come out identical to the logged ones.  They are 0
+for the default zlib compression. */
+/** Bit mask of the number of fields */
+#define MLOG_INDEX_N_MASK		0x3FFUL
+/** Zero relative shift position of the page compression codec */
+#define MLOG_INDEX_POS_ZIP_CODEC	10
+/** Zero relative shift position of the page compression level */
+#define MLOG_INDEX_POS_ZIP_LEVEL	12
+
 #ifndef UNIV_HOTBACKUP
 /* Insert, update, and maybe other functions may use this value to define an
 extra mlog buffer size for variable size data */
@@ -55,6 +55,7 @@ first 3 values must be RW_S_LATCH, RW_X_LATCH, RW_NO_LATCH */
 #endif /* UNIV_DEBUG */
 #define	MTR_MEMO_S_LOCK		55
 #define	MTR_MEMO_X_LOCK		56
+#define	MTR_MEMO_SX_LOCK	57
 
 /** @name Log item types
 The log items are declared 'byte' so that the compiler can warn if val
@@ -226,6 +227,42 @@ mtr_release_s_latch_at_savepoint(
 	mtr_t*		mtr,		/*!< in: mtr */
 	ulint		savepoint,	/*!< in: savepoint */
 	rw_lock_t*	lock);		/*!< in: latch to release */
+/**********************************************************//**
+Releases the (index tree) sx-latch stored in an mtr memo after a
+savepoint. */
+UNIV_INLINE
+void
+mtr_release_sx_latch_at_savepoint(
+/*==============================*/
+	mtr_t*		mtr,		/*!< in: mtr */
+	ulint		savepoint,	/*!< in: savepoint */
+	rw_lock_t*	lock);		/*!< in: latch to release */
+/**********************************************************//**
+Tries to latch a page that was buffer-fixed without a latch at a
+savepoint, without waiting. On success, the memo slot is converted to
+hold the page latch.
+@return	TRUE if the page was latched */
+UNIV_INTERN
+ibool
+mtr_block_latch_nowait_at_savepoint(
+/*================================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		savepoint,	/*!< in: savepoint of the
+					MTR_MEMO_BUF_FIX slot */
+	buf_block_t*	block,		/*!< in: buffer-fixed block */
+	ulint		rw_latch,	/*!< in: RW_S_LATCH or RW_X_LATCH */
+	const char*	file,		/*!< in: file name */
+	ulint		line);		/*!< in: line where called */
+/**********************************************************//**
+Releases the latch and the buffer-fix of a page stored in an mtr memo
+at a savepoint. The page must not have been modified by the mtr. */
+UNIV_INTERN
+void
+mtr_release_block_at_savepoint(
+/*===========================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		savepoint,	/*!< in: savepoint */
+	buf_block_t*	block);		/*!< in: block to release */
 #else /* !UNIV_HOTBACKUP */
 # define mtr_release_s_latch_at_savepoint(mtr,savepoint,lock) ((void) 0)
 #endif /* !UNIV_HOTBACKUP */
@@ -266,6 +303,10 @@ This macro locks an rw-lock in x-mode. */
 #define mtr_x_lock(B, MTR)	mtr_x_lock_func((B), __FILE__, __LINE__,\
 						(MTR))
 /*********************************************************************//**
+This macro locks an rw-lock in sx-mode. */
+#define mtr_sx_lock(B, MTR)	mtr_sx_lock_func((B), __FILE__, __LINE__,\
+						 (MTR))
+/*********************************************************************//**
 NOTE! Use the macro above!
 Locks a lock in s-mode. */
 UNIV_INLINE
@@ -287,6 +328,17 @@ mtr_x_lock_func(
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line number */
 	mtr_t*		mtr);	/*!< in: mtr */
+/*********************************************************************//**
+NOTE! Use the macro above!
+Locks a lock in sx-mode. */
+UNIV_INLINE
+void
+mtr_sx_lock_func(
+/*=============*/
+	rw_lock_t*	lock,	/*!< in: rw-lock */
+	const char*	file,	/*!< in: file name */
+	ulint		line,	/*!< in: line number */
+	mtr_t*		mtr);	/*!< in: mtr */
 #endif /* !UNIV_HOTBACKUP */
 
 /***************************************************//**
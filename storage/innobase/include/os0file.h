@@ -1228,6 +1228,30 @@ os_aio_linux_handle(
 	ulint*	type);		/*!< out: OS_FILE_WRITE or ..._READ */
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/**********************************************************************//**
+This function is only used with io_uring. Waits for an aio operation of
+a segment to complete. NOTE: this function will also take care of freeing
+the aio slot, therefore no other thread is allowed to do the freeing!
+@return	TRUE if the IO was successful */
+UNIV_INTERN
+ibool
+os_aio_uring_handle(
+/*================*/
+	ulint	global_seg,	/*!< in: segment number in the aio array
+				to wait for; segment 0 is the ibuf
+				i/o thread, segment 1 is log i/o thread,
+				then follow the non-ibuf read threads,
+				and the last are the non-ibuf write
+				threads. */
+	fil_node_t**message1,	/*!< out: the messages passed with the */
+	void**	message2,	/*!< aio request; note that in case the
+				aio operation failed, these output
+				parameters are valid and can be used to
+				restart the operation. */
+	ulint*	type);		/*!< out: OS_FILE_WRITE or ..._READ */
+#endif /* LINUX_IO_URING */
+
 #ifndef UNIV_NONINL
 #include "os0file.ic"
 #endif
@@ -76,6 +76,13 @@ struct os_event_struct {
 					/*!< list of all created events */
 };
 
+#ifdef LINUX_FUTEX
+/** A Linux futex that a latch embeds, so that its waiters can be
+suspended and woken without an os_event_t.  The value is incremented
+each time the waiters are woken. */
+typedef ib_uint32_t		os_futex_t;
+#endif /* LINUX_FUTEX */
+
 /** Denotes an infinite delay for os_event_wait_time() */
 #define OS_SYNC_INFINITE_TIME   ULINT_UNDEFINED
 
@@ -231,6 +238,35 @@ ulint
 os_fast_mutex_trylock(
 /*==================*/
 	os_fast_mutex_t*	fast_mutex);	/*!< in: mutex to acquire */
+#ifdef LINUX_FUTEX
+/**********************************************************//**
+Reads the value of a futex that a thread is about to wait for. The value
+is read with a full memory barrier, so that it is read before the
+caller announces that it is waiting.
+@return	value to pass to os_futex_wait() */
+UNIV_INLINE
+ib_uint32_t
+os_futex_reset(
+/*===========*/
+	os_futex_t*	futex);	/*!< in/out: futex */
+/**********************************************************//**
+Suspends the calling thread until the futex is woken, unless it has been
+woken after os_futex_reset() returned value. The thread may also return
+spuriously, and the caller must check its wait condition again. */
+UNIV_INLINE
+void
+os_futex_wait(
+/*==========*/
+	os_futex_t*	futex,	/*!< in: futex */
+	ib_uint32_t	value);	/*!< in: return value of os_futex_reset() */
+/**********************************************************//**
+Wakes all the threads that wait for a futex. */
+UNIV_INLINE
+void
+os_futex_wake(
+/*==========*/
+	os_futex_t*	futex);	/*!< in/out: futex */
+#endif /* LINUX_FUTEX */
 /**********************************************************//**
 Releases ownership of a fast mutex. */
 UNIV_INTERN
@@ -416,6 +452,24 @@ clobbered */
 	"Mutexes and rw_locks use InnoDB's own implementation"
 #endif
 
+/**********************************************************//**
+Memory barriers: os_rmb orders the loads before it before the loads
+after it, and os_wmb does the same for stores. */
+
+#if defined(HAVE_IB_GCC_ATOMIC_BUILTINS)
+# define os_rmb	__sync_synchronize()
+# define os_wmb	__sync_synchronize()
+#elif defined(HAVE_IB_SOLARIS_ATOMICS)
+# define os_rmb	membar_consumer()
+# define os_wmb	membar_producer()
+#elif defined(HAVE_WINDOWS_ATOMICS)
+# define os_rmb	MemoryBarrier()
+# define os_wmb	MemoryBarrier()
+#else
+# define os_rmb	do { } while (0)
+# define os_wmb	do { } while (0)
+#endif
+
 #ifndef UNIV_NONINL
 #include "os0sync.ic"
 #endif
@@ -80,7 +80,17 @@ struct page_zip_des_struct
 					PAGE_ZIP_MIN_SIZE << (ssize - 1). */
 };
 
-/** Compression statistics for a given page size */
+/** @name Page compression codecs of ROW_FORMAT=COMPRESSED tables,
+as stored in FSP_FLAGS_ZIP_CODEC */
+/* @{ */
+#define PAGE_ZIP_CODEC_ZLIB	0	/*!< zlib deflate, at the level
+					of FSP_FLAGS_ZIP_LEVEL */
+#define PAGE_ZIP_CODEC_LZ	1	/*!< fast LZ77 of ut0lz.h */
+#define PAGE_ZIP_CODEC_NONE	2	/*!< no compression */
+#define PAGE_ZIP_N_CODECS	3	/*!< number of codecs */
+/* @} */
+
+/** Compression statistics for a given page size and codec */
 struct page_zip_stat_struct {
 	/** Number of page compressions */
 	ulint		compressed;
@@ -97,8 +107,14 @@ struct page_zip_stat_struct {
 /** Compression statistics */
 typedef struct page_zip_stat_struct page_zip_stat_t;
 
-/** Statistics on compression, indexed by page_zip_des_struct::ssize - 1 */
-extern page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE - 1];
+/** Statistics on compression, indexed by page_zip_des_struct::ssize - 1
+and by the codec */
+extern page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE - 1]
+				    [PAGE_ZIP_N_CODECS];
+
+/** Names of the page compression codecs, indexed by PAGE_ZIP_CODEC_ZLIB,
+..., and terminated by NULL */
+extern const char* page_zip_codec_names[PAGE_ZIP_N_CODECS + 1];
 
 /**********************************************************************//**
 Write the "deleted" flag of a record on a compressed page.  The flag must
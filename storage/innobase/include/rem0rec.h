@@ -361,6 +361,56 @@ rec_get_offsets_func(
 #define rec_get_offsets(rec,index,offsets,n,heap)	\
 	rec_get_offsets_func(rec,index,offsets,n,heap,__FILE__,__LINE__)
 
+/** Offsets of the records of an index that a search compares one after
+another; see rec_get_offsets_cached() */
+typedef struct rec_offs_cache_struct	rec_offs_cache_t;
+
+/** Offsets of the records of an index that a search compares one after
+another */
+struct rec_offs_cache_struct{
+	const dict_index_t*	index;	/*!< index whose records all have
+					the offsets of the last record,
+					or NULL if they may differ */
+	ulint			status;	/*!< rec_get_status() of the last
+					record */
+	ulint			n_fields;/*!< n_fields that the offsets were
+					determined for */
+	ulint*			offsets;/*!< offsets of the last record,
+					or an array for rec_get_offsets() */
+};
+
+/******************************************************//**
+Initializes a cache of record offsets. */
+UNIV_INLINE
+void
+rec_offs_cache_init(
+/*================*/
+	rec_offs_cache_t*	cache,	/*!< out: offsets cache */
+	ulint*			offsets);/*!< in: array for
+					rec_get_offsets(), or NULL */
+/******************************************************//**
+Determines the offsets to each field in a record, like rec_get_offsets().
+When the fields are all NOT NULL and of a fixed length, the offsets are
+the same for all records of the index with the same status, and are
+returned without looking at the record.
+@return	the offsets of rec */
+UNIV_INLINE
+ulint*
+rec_get_offsets_cached_func(
+/*========================*/
+	const rec_t*		rec,	/*!< in: physical record */
+	const dict_index_t*	index,	/*!< in: record descriptor */
+	rec_offs_cache_t*	cache,	/*!< in/out: offsets cache */
+	ulint			n_fields,/*!< in: maximum number of
+					initialized fields
+					 (ULINT_UNDEFINED if all fields) */
+	mem_heap_t**		heap,	/*!< in/out: memory heap */
+	const char*		file,	/*!< in: file name where called */
+	ulint			line);	/*!< in: line number where called */
+
+#define rec_get_offsets_cached(rec,index,cache,n,heap)	\
+	rec_get_offsets_cached_func(rec,index,cache,n,heap,__FILE__,__LINE__)
+
 /******************************************************//**
 The following function determines the offsets to each field
 in the record.  It can reuse a previously allocated array. */
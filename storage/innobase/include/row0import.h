@@ -0,0 +1,52 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0import.h
+ALTER TABLE ... IMPORT TABLESPACE
+
+The .ibd file to be imported may come from another server.  Before it
+is opened, every used page of the file is rewritten: the space id and
+the index ids are replaced with those of the table in the data
+dictionary, the transaction ids in the clustered index are replaced
+with the id of the importing transaction and the page LSNs are reset
+to the current LSN.  The pages are converted by several threads, each
+of which reads, converts and writes back a range of pages at a time.
+The index ids and root pages of the file are taken from the .cfg file
+written by FLUSH TABLES ... FOR EXPORT, or from the root pages of the
+indexes in the data dictionary if there is no .cfg file.
+*******************************************************/
+
+#ifndef row0import_h
+#define row0import_h
+
+#include "univ.i"
+#include "trx0types.h"
+
+/*****************************************************************//**
+Imports a tablespace. The .ibd file can come from another server; it
+is converted to the space id and the index ids of the table.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_import_tablespace_for_mysql(
+/*============================*/
+	const char*	name,	/*!< in: table name */
+	trx_t*		trx);	/*!< in: transaction handle */
+
+#endif /* row0import_h */
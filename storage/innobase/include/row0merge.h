@@ -194,4 +194,52 @@ row_merge_build_indexes(
 	struct TABLE*	table);		/*!< in/out: MySQL table, for
 					reporting erroneous key value
 					if applicable */
+/*********************************************************************//**
+Checks whether the rows of an insert statement can be sorted and loaded
+into the index trees of a table bottom-up. The table must be empty, and
+an exclusive lock on it must be held.
+@return	TRUE if row_merge_bulk_create() can be used */
+UNIV_INTERN
+ibool
+row_merge_bulk_is_applicable(
+/*=========================*/
+	dict_table_t*	table);	/*!< in: table */
+/*********************************************************************//**
+Starts a bulk insert into an empty table.
+@return	own: bulk insert, or NULL if the temporary files could not be
+created */
+UNIV_INTERN
+row_merge_bulk_t*
+row_merge_bulk_create(
+/*==================*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_table_t*	table,		/*!< in: table,
+					row_merge_bulk_is_applicable() */
+	struct TABLE*	mysql_table);	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+/*********************************************************************//**
+Adds a row to a bulk insert. The entries of every index are buffered and
+written to the merge files in sorted runs.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_add(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk insert */
+	const dtuple_t*		row);	/*!< in: row, including the system
+					columns */
+/*********************************************************************//**
+Ends a bulk insert and frees it. If the rows are to be loaded, the
+entries of every index are merge sorted first, so that a duplicate key
+is found before any index tree is built, and then every index tree is
+built bottom-up. The trees are made visible together in one
+mini-transaction, after their pages have been written to disk.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_end(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in,own: bulk insert */
+	ibool			load);	/*!< in: TRUE to load the rows,
+					FALSE to discard them */
 #endif /* row0merge.h */
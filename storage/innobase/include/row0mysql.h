@@ -238,6 +238,43 @@ row_insert_for_mysql(
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct in MySQL
 					handle */
 /*********************************************************************//**
+Decides at the first row of an insert statement with
+prebuilt->bulk_requested whether its rows are loaded bottom-up. The table
+is locked in exclusive mode, and if it is empty and its indexes allow it,
+prebuilt->bulk is created.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_start_for_mysql(
+/*=====================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	struct TABLE*	mysql_table);	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+/*********************************************************************//**
+Buffers a row of an insert statement in prebuilt->bulk. The row becomes
+visible only in row_bulk_end_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_insert_for_mysql(
+/*======================*/
+	byte*		mysql_rec,	/*!< in: row in the MySQL format */
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct in
+					MySQL handle */
+/*********************************************************************//**
+Ends the bulk insert of an insert statement, if one was started, by
+loading the buffered rows into the index trees, or by discarding them if
+the statement failed.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_end_for_mysql(
+/*===================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	ibool		load);		/*!< in: FALSE to discard the rows */
+/*********************************************************************//**
 Builds a dummy query graph used in selects. */
 UNIV_INTERN
 void
@@ -473,16 +510,6 @@ row_discard_tablespace_for_mysql(
 /*=============================*/
 	const char*	name,	/*!< in: table name */
 	trx_t*		trx);	/*!< in: transaction handle */
-/*****************************************************************//**
-Imports a tablespace. The space id in the .ibd file must match the space id
-of the table in the data dictionary.
-@return	error code or DB_SUCCESS */
-UNIV_INTERN
-int
-row_import_tablespace_for_mysql(
-/*============================*/
-	const char*	name,	/*!< in: table name */
-	trx_t*		trx);	/*!< in: transaction handle */
 /*********************************************************************//**
 Drops a database for MySQL.
 @return	error code or DB_SUCCESS */
@@ -544,6 +571,13 @@ struct mysql_row_templ_struct {
 					Innobase record in the clustered index;
 					not defined if template_type is
 					ROW_MYSQL_WHOLE_ROW */
+	ulint	icp_rec_field_no;	/*!< field number of the column in an
+					Innobase record in prebuilt->index,
+					used when checking the pushed index
+					condition; ULINT_UNDEFINED if the
+					column is not stored in full in that
+					index or if it is the clustered
+					index */
 	ulint	mysql_col_offset;	/*!< offset of the column in the MySQL
 					row format */
 	ulint	mysql_col_len;		/*!< length of the column in the MySQL
@@ -575,7 +609,14 @@ struct mysql_row_templ_struct {
 					it is an unsigned integer type */
 };
 
+/* Number of rows in the first batch of fetch_cache after a cursor was
+positioned; every batch that fills the cache doubles the next one */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Most rows in one batch of fetch_cache */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	512
+/* Most bytes of rows in one batch of fetch_cache; long rows are cached
+in smaller batches */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(256 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -644,10 +685,18 @@ struct row_prebuilt_struct {
 					not to be confused with InnoDB
 					externally stored columns
 					(VARCHAR can be off-page too) */
+	unsigned	exporting:1;	/*!< TRUE if FLUSH TABLES ... FOR
+					EXPORT has quiesced the table
+					through this handle */
 	mysql_row_templ_t* mysql_template;/*!< template used to transform
 					rows fast between MySQL and Innobase
 					formats; memory for this template
 					is not allocated from 'heap' */
+	const void*	idx_cond;	/*!< the MySQL handler whose pushed
+					index condition row_search_for_mysql()
+					checks on the records of the
+					secondary index before looking up the
+					clustered index, or NULL */
 	mem_heap_t*	heap;		/*!< memory heap from which
 					these auxiliary structures are
 					allocated when needed */
@@ -740,16 +789,25 @@ struct row_prebuilt_struct {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
+					batch; an array of
+					MYSQL_FETCH_CACHE_MAX_SIZE pointers,
+					or NULL if nothing was cached yet;
+					we reserve mysql_row_len
 					bytes for each such row; these
 					pointers point 4 bytes past the
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_limit;/*!< number of rows to cache in
+					the current batch; grows from
+					MYSQL_FETCH_CACHE_SIZE while the
+					batches of a scan fill the cache */
+	ulint		fetch_cache_allocated;/*!< number of row buffers
+					allocated in fetch_cache */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -758,6 +816,11 @@ struct row_prebuilt_struct {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	ulint		lra_page_no;	/*!< leaf page of the scan when
+					row_sel_read_ahead_logical() was
+					last called, or FIL_NULL */
+	ulint		lra_n_pages;	/*!< number of leaf pages read ahead
+					that the scan has not reached yet */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	old_vers_heap;	/*!< memory heap where a previous
@@ -777,6 +840,18 @@ struct row_prebuilt_struct {
 					autoinc value from the table. We
 					store it here so that we can return
 					it to MySQL */
+	ulonglong	autoinc_n_reserved;
+					/*!< number of AUTOINC values that
+					were reserved in the current statement
+					without the AUTO-INC lock and not yet
+					given to a row */
+	/*----------------------*/
+	ibool		bulk_requested;	/*!< TRUE if the rows of the insert
+					statement may be loaded bottom-up
+					if the table turns out to be empty
+					at the first row */
+	row_merge_bulk_t* bulk;		/*!< bulk insert into an empty
+					table, or NULL */
 	/*----------------------*/
 	ulint		magic_n2;	/*!< this should be the same as
 					magic_n */
@@ -0,0 +1,80 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0quiesce.h
+Quiescing of a table for FLUSH TABLES ... FOR EXPORT
+
+While a table is quiesced, purge is stopped for all tables, so the
+history list of the whole server grows until UNLOCK TABLES; an export
+should therefore be kept short.  The change buffer holds no entries
+for the table and all its pages have been written to its .ibd file,
+so that the file can be copied and imported into another server with
+ALTER TABLE ... IMPORT TABLESPACE.  The table definition is written to
+a .cfg file next to the .ibd file.  All integers in the .cfg file are
+stored most significant byte first, and strings are stored as a 4-byte
+length that includes the terminating NUL, followed by the bytes:
+
+	version			IB_EXPORT_CFG_VERSION_V1
+	page size		UNIV_PAGE_SIZE
+	table flags		dict_table_t::flags
+	autoinc			8 bytes, next AUTO_INCREMENT value or 0
+	table name
+	number of columns	including the system columns
+	for each column:	mtype, prtype, len, name
+	number of indexes
+	for each index:		8-byte id, root page number, type, n_uniq,
+				n_fields, name
+	for each index field:	prefix_len, column name
+*******************************************************/
+
+#ifndef row0quiesce_h
+#define row0quiesce_h
+
+#include "univ.i"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/** Version of the .cfg file format */
+#define IB_EXPORT_CFG_VERSION_V1	1
+
+/*********************************************************************//**
+Quiesces a table for FLUSH TABLES ... FOR EXPORT: stops purge, merges
+the change buffer entries of the table, writes the dirty pages of the
+table to its .ibd file and writes the .cfg file.  The caller must
+prevent writes to the table.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_quiesce_table_start(
+/*====================*/
+	dict_table_t*	table,	/*!< in/out: table */
+	trx_t*		trx);	/*!< in: transaction of the FLUSH TABLES
+				statement */
+/*********************************************************************//**
+Ends the quiesced state of a table at UNLOCK TABLES: deletes the .cfg
+file and resumes purge. */
+UNIV_INTERN
+void
+row_quiesce_table_complete(
+/*=======================*/
+	dict_table_t*	table,	/*!< in/out: quiesced table */
+	trx_t*		trx);	/*!< in: transaction of the FLUSH TABLES
+				statement */
+
+#endif /* row0quiesce_h */
@@ -0,0 +1,284 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/srv0mon.h
+Server monitor counters for INFORMATION_SCHEMA.INNODB_METRICS
+
+Each counter is identified by a monitor_id_t.  Its static description
+is in innodb_counter_info[] and its dynamic value in
+innodb_counter_value[].  The counters are grouped in modules; a module
+is a MONITOR_MODULE entry followed by its counters.  Counters are off
+until they are enabled by innodb_monitor_enable, either one by one or a
+module at a time.
+
+Most counters are MONITOR_EXISTING: they report an InnoDB status
+variable that is maintained anyway, and cost nothing until they are
+read.  The others are incremented by MONITOR_INC() only while they
+are enabled.  Updates are not atomic, so the values are approximate.
+*******************************************************/
+
+#ifndef srv0mon_h
+#define srv0mon_h
+
+#include "univ.i"
+#ifndef UNIV_HOTBACKUP
+
+/** Possible status values for monitor_value_t::mon_status */
+enum monitor_running_status {
+	MONITOR_STARTED = 1,	/*!< the counter is on */
+	MONITOR_STOPPED = 2	/*!< the counter was turned off */
+};
+typedef enum monitor_running_status	monitor_running_t;
+
+/** Value of a monitor counter */
+typedef ib_int64_t			mon_type_t;
+
+/** Dynamic values of a monitor counter */
+struct monitor_value_struct {
+	ib_time_t	mon_start_time;	/*!< when the counter was last
+					turned on, or 0 */
+	ib_time_t	mon_stop_time;	/*!< when the counter was last
+					turned off, or 0 */
+	ib_time_t	mon_reset_time;	/*!< when the counter was last
+					reset, or 0 */
+	mon_type_t	mon_value;	/*!< value since the counter was
+					turned on */
+	mon_type_t	mon_max_value;	/*!< maximum of a
+					MONITOR_DISPLAY_CURRENT counter */
+	mon_type_t	mon_min_value;	/*!< minimum of a
+					MONITOR_DISPLAY_CURRENT counter */
+	mon_type_t	mon_value_reset;/*!< mon_value at the last reset */
+	mon_type_t	mon_start_value;/*!< value of the status variable
+					of a MONITOR_EXISTING counter that
+					corresponds to mon_value == 0 */
+	monitor_running_t mon_status;	/*!< MONITOR_STARTED or
+					MONITOR_STOPPED, or 0 if the
+					counter was never turned on */
+};
+typedef struct monitor_value_struct	monitor_value_t;
+
+/** Flags of monitor_info_t::monitor_type */
+enum monitor_type_enum {
+	MONITOR_NONE = 0,		/*!< an owned counter that is
+					incremented with MONITOR_INC() */
+	MONITOR_MODULE = 1,		/*!< a module, not a counter */
+	MONITOR_EXISTING = 2,		/*!< the counter reports an
+					existing status variable */
+	MONITOR_DISPLAY_CURRENT = 4	/*!< the counter is a gauge: its
+					value is the current value of the
+					status variable, not the increment
+					since the counter was turned on */
+};
+typedef enum monitor_type_enum		monitor_type_t;
+
+/** Monitor counters and modules.  The counters of a module follow the
+MONITOR_MODULE_ entry of the module. */
+enum monitor_id_enum {
+	/* Buffer pool */
+	MONITOR_MODULE_BUFFER = 0,
+	MONITOR_OVLD_BUF_POOL_SIZE,
+	MONITOR_OVLD_BUF_POOL_READS,
+	MONITOR_OVLD_BUF_POOL_READ_REQUESTS,
+	MONITOR_OVLD_BUF_POOL_WRITE_REQUEST,
+	MONITOR_OVLD_BUF_POOL_WAIT_FREE,
+	MONITOR_OVLD_BUF_POOL_READ_AHEAD,
+	MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED,
+	MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL,
+	MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_HITS,
+	MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_EVICTED,
+	MONITOR_OVLD_BUF_POOL_PAGE_TOTAL,
+	MONITOR_OVLD_BUF_POOL_PAGES_DATA,
+	MONITOR_OVLD_BUF_POOL_PAGES_DIRTY,
+	MONITOR_OVLD_BUF_POOL_PAGES_FREE,
+	MONITOR_OVLD_BUF_POOL_PAGES_FLUSHED,
+	MONITOR_OVLD_PAGE_CREATED,
+	MONITOR_OVLD_PAGES_WRITTEN,
+	MONITOR_OVLD_PAGES_READ,
+
+	/* Redo log */
+	MONITOR_MODULE_LOG,
+	MONITOR_OVLD_LSN_CURRENT,
+	MONITOR_OVLD_LSN_FLUSHDISK,
+	MONITOR_OVLD_LSN_CHECKPOINT,
+	MONITOR_OVLD_CHECKPOINT_AGE,
+	MONITOR_OVLD_LOG_WAITS,
+	MONITOR_OVLD_LOG_WRITE_REQUEST,
+	MONITOR_OVLD_LOG_WRITES,
+
+	/* Locks */
+	MONITOR_MODULE_LOCK,
+	MONITOR_OVLD_DEADLOCK,
+	MONITOR_TIMEOUT,
+	MONITOR_OVLD_ROW_LOCK_CURRENT_WAIT,
+	MONITOR_OVLD_ROW_LOCK_WAIT,
+	MONITOR_OVLD_LOCK_WAIT_TIME,
+	MONITOR_OVLD_LOCK_MAX_WAIT_TIME,
+
+	/* Purge */
+	MONITOR_MODULE_PURGE,
+	MONITOR_PURGE_INVOKED,
+	MONITOR_OVLD_PURGE_UNDO_LOG_PAGES,
+	MONITOR_PURGE_DEL_MARK_RECORDS,
+	MONITOR_PURGE_UPD_EXIST_OR_EXTERN,
+	MONITOR_OVLD_RSEG_HISTORY_LEN,
+
+	/* Change buffer */
+	MONITOR_MODULE_IBUF_SYSTEM,
+	MONITOR_OVLD_IBUF_MERGES,
+	MONITOR_OVLD_IBUF_MERGE_INSERT,
+	MONITOR_OVLD_IBUF_MERGE_DELETE,
+	MONITOR_OVLD_IBUF_MERGE_PURGE,
+	MONITOR_OVLD_IBUF_MERGE_DISCARD_INSERT,
+	MONITOR_OVLD_IBUF_MERGE_DISCARD_DELETE,
+	MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE,
+	MONITOR_OVLD_IBUF_SIZE,
+
+	/* Adaptive hash index */
+	MONITOR_MODULE_ADAPTIVE_HASH,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE,
+	MONITOR_ADAPTIVE_HASH_PAGE_ADDED,
+	MONITOR_ADAPTIVE_HASH_PAGE_REMOVED,
+
+	/* File I/O */
+	MONITOR_MODULE_OS,
+	MONITOR_OVLD_OS_FILE_READ,
+	MONITOR_OVLD_OS_FILE_WRITE,
+	MONITOR_OVLD_OS_FSYNC,
+	MONITOR_OVLD_OS_PENDING_READS,
+	MONITOR_OVLD_OS_PENDING_WRITES,
+	MONITOR_OVLD_OS_LOG_WRITTEN,
+	MONITOR_OVLD_OS_LOG_FSYNC,
+	MONITOR_OVLD_OS_LOG_PENDING_FSYNC,
+	MONITOR_OVLD_OS_LOG_PENDING_WRITES,
+
+	/** Number of monitor counters and modules */
+	NUM_MONITOR
+};
+typedef enum monitor_id_enum		monitor_id_t;
+
+/** Static description of a monitor counter */
+struct monitor_info_struct {
+	const char*	monitor_name;	/*!< counter or module name */
+	const char*	monitor_module;	/*!< name of the module that the
+					counter belongs to */
+	const char*	monitor_desc;	/*!< description of the counter */
+	ulint		monitor_type;	/*!< monitor_type_t flags */
+	monitor_id_t	monitor_id;	/*!< id of the counter, equal to
+					its index in innodb_counter_info[] */
+};
+typedef struct monitor_info_struct	monitor_info_t;
+
+/** Operations on monitor counters */
+enum mon_option_enum {
+	MONITOR_TURN_ON = 1,		/*!< turn the counter on */
+	MONITOR_TURN_OFF,		/*!< turn the counter off */
+	MONITOR_RESET_VALUE,		/*!< reset COUNT_RESET */
+	MONITOR_RESET_ALL_VALUE		/*!< reset all the values of a
+					counter that is off */
+};
+typedef enum mon_option_enum		mon_option_t;
+
+/** Number of bits in a ulint */
+#define MONITOR_BITS_ULINT	(sizeof(ulint) * 8)
+
+/** Bitmap of the counters that are on */
+extern ulint		monitor_set_tbl[(NUM_MONITOR + MONITOR_BITS_ULINT - 1)
+					/ MONITOR_BITS_ULINT];
+
+/** Dynamic values of the counters */
+extern monitor_value_t	innodb_counter_value[NUM_MONITOR];
+
+/** Check if a counter is on. */
+#define MONITOR_IS_ON(monitor)						\
+	(monitor_set_tbl[(monitor) / MONITOR_BITS_ULINT]		\
+	 & ((ulint) 1 << ((monitor) % MONITOR_BITS_ULINT)))
+
+/** Value of a counter */
+#define MONITOR_VALUE(monitor)						\
+	(innodb_counter_value[monitor].mon_value)
+
+/** Increment an owned counter if it is on. */
+#define MONITOR_INC(monitor)						\
+	do {								\
+		if (MONITOR_IS_ON(monitor)) {				\
+			MONITOR_VALUE(monitor)++;			\
+		}							\
+	} while (0)
+
+/** Add a value to an owned counter if it is on. */
+#define MONITOR_INC_VALUE(monitor, value)				\
+	do {								\
+		if (MONITOR_IS_ON(monitor)) {				\
+			MONITOR_VALUE(monitor) += (mon_type_t) (value);	\
+		}							\
+	} while (0)
+
+/****************************************************************//**
+Initialize the monitor counters.  All counters are off. */
+UNIV_INTERN
+void
+srv_mon_create(void);
+/*================*/
+
+/****************************************************************//**
+Get the static description of a monitor counter or module.
+@return	description */
+UNIV_INTERN
+const monitor_info_t*
+srv_mon_get_info(
+/*=============*/
+	monitor_id_t	monitor_id);	/*!< in: counter or module */
+
+/****************************************************************//**
+Turn a counter on or off, or reset its values.  A counter must be off
+for MONITOR_RESET_ALL_VALUE to have any effect. */
+UNIV_INTERN
+void
+srv_mon_set_option(
+/*===============*/
+	monitor_id_t	monitor_id,	/*!< in: counter, not a module */
+	mon_option_t	set_option);	/*!< in: operation */
+
+/****************************************************************//**
+Apply an operation to all the counters of a module, or to all the
+counters if module_id is NUM_MONITOR. */
+UNIV_INTERN
+void
+srv_mon_set_module_control(
+/*=======================*/
+	monitor_id_t	module_id,	/*!< in: module, or NUM_MONITOR */
+	mon_option_t	set_option);	/*!< in: operation */
+
+/****************************************************************//**
+Get the value of a counter.  The value of a MONITOR_EXISTING counter
+that is on is refreshed from its status variable.
+@return	value since the counter was turned on, or the current value
+of a MONITOR_DISPLAY_CURRENT counter */
+UNIV_INTERN
+mon_type_t
+srv_mon_get_value(
+/*==============*/
+	monitor_id_t		monitor_id,	/*!< in: counter, not a
+						module */
+	monitor_value_t*	copy);		/*!< out: consistent copy
+						of the values, or NULL */
+
+#endif /* !UNIV_HOTBACKUP */
+#endif /* srv0mon_h */
@@ -117,6 +117,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/* If this flag is TRUE, then we will submit asynchronous reads and writes
+through io_uring if it is supported, instead of native or simulated aio */
+extern my_bool	srv_use_io_uring;
 #endif /* !UNIV_HOTBACKUP */
 #ifdef __WIN__
 extern ibool	srv_use_native_conditions;
@@ -146,7 +149,9 @@ extern ulint	srv_n_log_files;
 extern ulint	srv_log_file_size;
 extern ulint	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
+extern ulong	srv_flush_log_interval;
 extern char	srv_adaptive_flushing;
+extern char	srv_ibuf_background_merge;
 
 /* If this flag is TRUE, then we will load the indexes' (and tables') metadata
 even if they are marked as "corrupted". Mostly it is for DBA to process
@@ -169,8 +174,12 @@ extern my_bool	srv_buf_pool_populate;	/*!< virtual page preallocation */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
 extern my_bool	srv_flush_neighbors;	/*!< whether or not to flush
 					neighbors of a block */
+extern my_bool	srv_lazy_drop_table;	/*!< whether DROP and TRUNCATE
+					leave the pages of the tablespace
+					in the buffer pool */
 extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
+extern ulong	srv_buf_pool_chunk_unit;/*!< buffer pool chunk size in bytes */
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
@@ -230,6 +239,11 @@ extern ibool	srv_innodb_status;
 
 extern unsigned long long	srv_stats_sample_pages;
 
+extern my_bool	srv_stats_persistent;
+extern ulong	srv_stats_persistent_sample_pages;
+
+extern my_bool	srv_bulk_load;
+
 extern ibool	srv_use_doublewrite_buf;
 extern ibool	srv_use_checksums;
 
@@ -240,11 +254,29 @@ extern ulong	srv_replication_delay;
 /*-------------------------------------------*/
 
 extern ulint	srv_n_lock_deadlock_count;
+/** Number of deadlock searches */
+extern ulint	srv_n_lock_deadlock_checks;
+/** Number of transactions visited by all deadlock searches */
+extern ulint	srv_n_lock_deadlock_check_steps;
+/** Most transactions visited by one deadlock search */
+extern ulint	srv_n_lock_deadlock_check_max_steps;
+/** Number of deadlock searches given up as too deep or too long */
+extern ulint	srv_n_lock_deadlock_check_aborts;
+
+/** Number of AUTOINC values reserved without the table AUTO-INC lock
+(innodb_autoinc_lock_mode=2) */
+extern ulint	srv_n_autoinc_reserved;
+/** Number of reserved AUTOINC values that no row was given before the
+end of the statement */
+extern ulint	srv_n_autoinc_unused;
 
 extern ulint	srv_n_rows_inserted;
 extern ulint	srv_n_rows_updated;
 extern ulint	srv_n_rows_deleted;
 extern ulint	srv_n_rows_read;
+/** Number of rows of srv_n_rows_read that were served from the
+prefetch cache of a table handle */
+extern ulint	srv_n_rows_read_cached;
 
 extern ibool	srv_print_innodb_monitor;
 extern ibool	srv_print_innodb_lock_monitor;
@@ -406,6 +438,24 @@ extern my_bool srv_print_all_deadlocks;
 /** Perform deadlock detection check. */
 extern my_bool srv_deadlock_check;
 
+/** The order in which waiting record locks are granted,
+see srv_lock_schedule_enum */
+extern ulong srv_lock_schedule_algorithm;
+
+/** Row lock wait counters: number of waits, number of waits in
+progress, total and maximum wait time in microseconds */
+extern ulint		srv_n_lock_wait_count;
+extern ulint		srv_n_lock_wait_current_count;
+extern ib_int64_t	srv_n_lock_wait_time;
+extern ulint		srv_n_lock_max_wait_time;
+
+/** Number of buckets in the row lock wait time histogram */
+#define SRV_LOCK_WAIT_HIST_SIZE	6
+
+/** Row lock wait time histogram: bucket i counts the lock waits that
+ended in less than 10^i milliseconds, the last bucket the rest */
+extern ulint srv_n_lock_wait_hist[SRV_LOCK_WAIT_HIST_SIZE];
+
 /** Status variables to be passed to MySQL */
 typedef struct export_var_struct export_struc;
 
@@ -427,6 +477,11 @@ extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
+extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	log_flush_thread_key;
+extern mysql_pfs_key_t	buf_resize_thread_key;
+extern mysql_pfs_key_t	ibuf_merge_thread_key;
+extern mysql_pfs_key_t	row_import_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -515,6 +570,19 @@ enum srv_stats_method_name_enum {
 
 typedef enum srv_stats_method_name_enum		srv_stats_method_name_t;
 
+/* Alternatives for srv_lock_schedule_algorithm, which could be changed
+by setting innodb_lock_schedule_algorithm */
+enum srv_lock_schedule_enum {
+	SRV_LOCK_SCHEDULE_FCFS,		/* Grant waiting record locks in
+					the order they were requested.
+					This is the default setting */
+	SRV_LOCK_SCHEDULE_OLDEST,	/* Grant first to the transaction
+					that started first */
+	SRV_LOCK_SCHEDULE_MOST_LOCKS	/* Grant first to the transaction
+					that holds the most locks, and thus
+					most likely blocks others */
+};
+
 #ifndef UNIV_HOTBACKUP
 /** Types of threads existing in the system. */
 enum srv_thread_type {
@@ -770,6 +838,8 @@ srv_get_active_thread_type(void);
 
 /** Status variables to be passed to MySQL */
 struct export_var_struct{
+	ulint innodb_autoinc_values_reserved;	/*!< srv_n_autoinc_reserved */
+	ulint innodb_autoinc_values_unused;	/*!< srv_n_autoinc_unused */
 	ulint innodb_data_pending_reads;	/*!< Pending reads */
 	ulint innodb_data_pending_writes;	/*!< Pending writes */
 	ulint innodb_data_pending_fsyncs;	/*!< Pending fsyncs */
@@ -783,6 +853,8 @@ struct export_var_struct{
 	ulint innodb_buffer_pool_bytes_data;	/*!< File bytes used */
 	ulint innodb_buffer_pool_pages_dirty;	/*!< Dirty data pages */
 	ulint innodb_buffer_pool_bytes_dirty;	/*!< File bytes modified */
+	char  innodb_buffer_pool_resize_status[512];
+						/*!< Buffer pool resize status */
 	ulint innodb_buffer_pool_pages_misc;	/*!< Miscellanous pages */
 	ulint innodb_buffer_pool_pages_free;	/*!< Free pages */
 #ifdef UNIV_DEBUG
@@ -796,6 +868,12 @@ struct export_var_struct{
 	ulint innodb_buffer_pool_read_ahead_rnd;/*!< srv_read_ahead_rnd */
 	ulint innodb_buffer_pool_read_ahead;	/*!< srv_read_ahead */
 	ulint innodb_buffer_pool_read_ahead_evicted;/*!< srv_read_ahead evicted*/
+	ulint innodb_buffer_pool_read_ahead_logical;
+						/*!< n_ra_pages_read_logical */
+	ulint innodb_buffer_pool_read_ahead_logical_hits;
+						/*!< n_ra_pages_logical_hit */
+	ulint innodb_buffer_pool_read_ahead_logical_evicted;
+						/*!< n_ra_pages_logical_evicted */
 	ulint innodb_dblwr_pages_written;	/*!< srv_dblwr_pages_written */
 	ulint innodb_dblwr_writes;		/*!< srv_dblwr_writes */
 	ulint innodb_files_open;		/*!< os_file_acct.n_open_files */
@@ -812,6 +890,11 @@ struct export_var_struct{
 	ulint innodb_ibuf_merged_pages;		/*!< stat->n_merges */
 	ulint innodb_ibuf_pages;		/*!< ibuf->size */
 	ulint innodb_lock_deadlocks;		/*!< srv_n_lock_deadlock_count */
+	ulint innodb_lock_deadlock_checks;	/*!< srv_n_lock_deadlock_checks */
+	ulint innodb_lock_deadlock_check_steps;	/*!< srv_n_lock_deadlock_check_steps */
+	ulint innodb_lock_deadlock_check_max_steps;
+						/*!< srv_n_lock_deadlock_check_max_steps */
+	ulint innodb_lock_deadlock_check_aborts;/*!< srv_n_lock_deadlock_check_aborts */
 	ulint innodb_log_waits;			/*!< srv_log_waits */
 	ulint innodb_log_write_requests;	/*!< srv_log_write_requests */
 	ulint innodb_log_writes;		/*!< srv_log_writes */
@@ -837,7 +920,10 @@ struct export_var_struct{
 						/ srv_n_lock_wait_count */
 	ulint innodb_row_lock_time_max;		/*!< srv_n_lock_max_wait_time
 						/ 1000 */
+	ulint innodb_row_lock_wait_hist[SRV_LOCK_WAIT_HIST_SIZE];
+						/*!< srv_n_lock_wait_hist */
 	ulint innodb_rows_read;			/*!< srv_n_rows_read */
+	ulint innodb_rows_read_cached;		/*!< srv_n_rows_read_cached */
 	ulint innodb_rows_inserted;		/*!< srv_n_rows_inserted */
 	ulint innodb_rows_updated;		/*!< srv_n_rows_updated */
 	ulint innodb_rows_deleted;		/*!< srv_n_rows_deleted */
@@ -885,6 +971,7 @@ struct export_var_struct{
 	ulint innodb_thread_concurrency_waiting;/*!< srv_conc_n_waiting_threads */
 	ulint innodb_btree_row_searches;        /*!< btr_cur_n_non_sea */
 	ulint innodb_hash_row_searches;         /*!< btr_cur_n_sea */
+	ulint innodb_btree_search_restarts;	/*!< btr_cur_n_restarts */
 	ib_int64_t innodb_mysql_master_log_pos;	/*!< Master binlog file position. */
 	char innodb_mysql_master_log_name[TRX_SYS_MYSQL_LOG_NAME_LEN + 1];
 						/*!< Master binlog file name. */
@@ -913,6 +1000,7 @@ extern ulint	srv_n_threads_active[];
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_checksums			TRUE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
 # define srv_is_being_started			0
@@ -54,8 +54,12 @@ smaller than 30 and the order of the numerical values like below! */
 /* We decrement lock_word by this amount for each x_lock. It is also the
 start value for the lock_word, meaning that it limits the maximum number
 of concurrent read locks before the rw_lock breaks. The current value of
-0x00100000 allows 1,048,575 concurrent readers and 2047 recursive writers.*/
+0x00100000 allows 524,287 concurrent readers and 2047 recursive writers.*/
 #define X_LOCK_DECR		0x00100000
+/* We decrement lock_word by this amount for an sx_lock. The readers must
+never bring lock_word below this value on their own, which halves the
+maximum number of concurrent read locks. */
+#define X_LOCK_HALF_DECR	(X_LOCK_DECR / 2)
 
 typedef struct rw_lock_struct		rw_lock_t;
 #ifdef UNIV_SYNC_DEBUG
@@ -118,6 +122,7 @@ extern	mysql_pfs_key_t	buf_block_debug_latch_key;
 # endif /* UNIV_SYNC_DEBUG */
 extern	mysql_pfs_key_t	dict_operation_lock_key;
 extern	mysql_pfs_key_t	fil_space_latch_key;
+extern	mysql_pfs_key_t	ibuf_index_counts_latch_key;
 extern	mysql_pfs_key_t	checkpoint_lock_key;
 extern	mysql_pfs_key_t	trx_i_s_cache_lock_key;
 extern	mysql_pfs_key_t	trx_purge_latch_key;
@@ -191,6 +196,14 @@ unlocking, not the corresponding function. */
 #  define rw_lock_x_unlock_gen(L, P)	rw_lock_x_unlock_func(L)
 # endif
 
+# define rw_lock_sx_lock(M)					\
+	rw_lock_sx_lock_func((M), __FILE__, __LINE__)
+
+# define rw_lock_sx_lock_inline(M, F, L)			\
+	rw_lock_sx_lock_func((M), (F), (L))
+
+# define rw_lock_sx_unlock(L)		rw_lock_sx_unlock_func(L)
+
 # define rw_lock_free(M)		rw_lock_free_func(M)
 
 #else /* !UNIV_PFS_RWLOCK */
@@ -252,6 +265,14 @@ unlocking, not the corresponding function. */
 #  define rw_lock_x_unlock_gen(L, P)	pfs_rw_lock_x_unlock_func(L)
 # endif
 
+# define rw_lock_sx_lock(M)					\
+	pfs_rw_lock_sx_lock_func((M), __FILE__, __LINE__)
+
+# define rw_lock_sx_lock_inline(M, F, L)			\
+	pfs_rw_lock_sx_lock_func((M), (F), (L))
+
+# define rw_lock_sx_unlock(L)		pfs_rw_lock_sx_unlock_func(L)
+
 # define rw_lock_free(M)		pfs_rw_lock_free_func(M)
 
 #endif /* UNIV_PFS_RWLOCK */
@@ -380,7 +401,30 @@ rw_lock_x_unlock_func(
 				been passed to another thread to unlock */
 #endif
 	rw_lock_t*	lock);	/*!< in/out: rw-lock */
-
+/******************************************************************//**
+NOTE! Use the corresponding macro, not directly this function! Lock an
+rw-lock in shared exclusive mode for the current thread. An sx-lock
+excludes other sx-locks and x-locks, but it does not exclude s-locks,
+and it does not wait for the current s-lock holders to exit. If the
+rw-lock is locked in shared exclusive or exclusive mode, or there is an
+exclusive lock request waiting, the function spins a preset time
+(controlled by SYNC_SPIN_ROUNDS), waiting for the lock, before suspending
+the thread. An sx-lock cannot be taken recursively, and a thread that
+holds an sx-lock must not request an x-lock on the same rw-lock. */
+UNIV_INTERN
+void
+rw_lock_sx_lock_func(
+/*=================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line);	/*!< in: line where requested */
+/******************************************************************//**
+Releases a shared exclusive mode lock. */
+UNIV_INLINE
+void
+rw_lock_sx_unlock_func(
+/*===================*/
+	rw_lock_t*	lock);	/*!< in/out: rw-lock */
 
 /******************************************************************//**
 Low-level function which locks an rw-lock in s-mode when we know that it
@@ -454,7 +498,7 @@ rw_lock_get_waiters(
 /******************************************************************//**
 Returns the write-status of the lock - this function made more sense
 with the old rw_lock implementation.
-@return	RW_LOCK_NOT_LOCKED, RW_LOCK_EX, RW_LOCK_WAIT_EX */
+@return	RW_LOCK_NOT_LOCKED, RW_LOCK_EX, RW_LOCK_WAIT_EX, RW_LOCK_SX */
 UNIV_INLINE
 ulint
 rw_lock_get_writer(
@@ -469,15 +513,16 @@ rw_lock_get_reader_count(
 /*=====================*/
 	const rw_lock_t*	lock);	/*!< in: rw-lock */
 /******************************************************************//**
-Decrements lock_word the specified amount if it is greater than 0.
-This is used by both s_lock and x_lock operations.
+Decrements lock_word the specified amount if it is greater than the
+threshold. This is used by s_lock, sx_lock and x_lock operations.
 @return	TRUE if decr occurs */
 UNIV_INLINE
 ibool
 rw_lock_lock_word_decr(
 /*===================*/
 	rw_lock_t*	lock,		/*!< in/out: rw-lock */
-	ulint		amount);	/*!< in: amount to decrement */
+	ulint		amount,		/*!< in: amount to decrement */
+	lint		threshold);	/*!< in: threshold of judgement */
 /******************************************************************//**
 Increments lock_word the specified amount and returns new value.
 @return	lock->lock_word after increment */
@@ -513,7 +558,7 @@ rw_lock_own(
 /*========*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 	__attribute__((warn_unused_result));
 #endif /* UNIV_SYNC_DEBUG */
 /******************************************************************//**
@@ -524,7 +569,7 @@ rw_lock_is_locked(
 /*==============*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type);	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 #ifdef UNIV_SYNC_DEBUG
 /***************************************************************//**
 Prints debug info of an rw-lock. */
@@ -607,8 +652,8 @@ struct rw_lock_struct {
 				/*!< Thread id of writer thread. Is only
 				guaranteed to have sane and non-stale
 				value iff recursive flag is set. */
-	os_event_t	event;	/*!< Used by sync0arr.c for thread queueing */
-	os_event_t	wait_ex_event;
+	sync_event_t	event;	/*!< Used by sync0arr.c for thread queueing */
+	sync_event_t	wait_ex_event;
 				/*!< Event for next-writer to wait on. A thread
 				must decrement lock_word before waiting. */
 #ifndef INNODB_RW_LOCKS_USE_ATOMICS
@@ -658,7 +703,8 @@ struct	rw_lock_debug_struct {
 				locked the rw-lock */
 	ulint	pass;		/*!< Pass value given in the lock operation */
 	ulint	lock_type;	/*!< Type of the lock: RW_LOCK_EX,
-				RW_LOCK_SHARED, RW_LOCK_WAIT_EX */
+				RW_LOCK_SHARED, RW_LOCK_WAIT_EX,
+				RW_LOCK_SX */
 	const char*	file_name;/*!< File name where the lock was obtained */
 	ulint	line;		/*!< Line where the rw-lock was locked */
 	UT_LIST_NODE_T(rw_lock_debug_t) list;
@@ -688,6 +734,8 @@ rw_lock_s_lock()
 rw_lock_s_lock_gen()
 rw_lock_s_lock_nowait()
 rw_lock_s_unlock_gen()
+rw_lock_sx_lock()
+rw_lock_sx_unlock()
 rw_lock_free()
 
 Two function APIs rw_lock_x_unlock_direct() and rw_lock_s_unlock_direct()
@@ -810,6 +858,26 @@ pfs_rw_lock_x_unlock_func(
 #endif
 	rw_lock_t*	lock);	/*!< in/out: rw-lock */
 /******************************************************************//**
+Performance schema instrumented wrap function for rw_lock_sx_lock_func()
+NOTE! Please use the corresponding macro rw_lock_sx_lock(), not directly
+this function! */
+UNIV_INLINE
+void
+pfs_rw_lock_sx_lock_func(
+/*=====================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line);	/*!< in: line where requested */
+/******************************************************************//**
+Performance schema instrumented wrap function for rw_lock_sx_unlock_func()
+NOTE! Please use the corresponding macro rw_lock_sx_unlock(), not directly
+this function! */
+UNIV_INLINE
+void
+pfs_rw_lock_sx_unlock_func(
+/*=======================*/
+	rw_lock_t*	lock);	/*!< in/out: rw-lock */
+/******************************************************************//**
 Performance schema instrumented wrap function for rw_lock_free_func()
 NOTE! Please use the corresponding macro rw_lock_free(), not directly
 this function! */
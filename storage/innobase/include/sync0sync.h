@@ -78,8 +78,10 @@ extern mysql_pfs_key_t	buf_pool_zip_mutex_key;
 extern mysql_pfs_key_t	cache_last_read_mutex_key;
 extern mysql_pfs_key_t	dict_foreign_err_mutex_key;
 extern mysql_pfs_key_t	dict_sys_mutex_key;
+extern mysql_pfs_key_t	dict_stats_queue_mutex_key;
 extern mysql_pfs_key_t	file_format_max_mutex_key;
 extern mysql_pfs_key_t	fil_system_mutex_key;
+extern mysql_pfs_key_t	fil_shard_mutex_key;
 extern mysql_pfs_key_t	flush_list_mutex_key;
 extern mysql_pfs_key_t	hash_table_mutex_key;
 extern mysql_pfs_key_t	ibuf_bitmap_mutex_key;
@@ -99,11 +101,13 @@ extern mysql_pfs_key_t	rseg_mutex_key;
 # ifdef UNIV_SYNC_DEBUG
 extern mysql_pfs_key_t	rw_lock_debug_mutex_key;
 # endif /* UNIV_SYNC_DEBUG */
+extern mysql_pfs_key_t	row_import_mutex_key;
 extern mysql_pfs_key_t	rw_lock_list_mutex_key;
 extern mysql_pfs_key_t	rw_lock_mutex_key;
 extern mysql_pfs_key_t	srv_dict_tmpfile_mutex_key;
 extern mysql_pfs_key_t	srv_innodb_monitor_mutex_key;
 extern mysql_pfs_key_t	srv_misc_tmpfile_mutex_key;
+extern mysql_pfs_key_t	srv_mon_mutex_key;
 extern mysql_pfs_key_t	srv_monitor_file_mutex_key;
 extern mysql_pfs_key_t	syn_arr_mutex_key;
 # ifdef UNIV_SYNC_DEBUG
@@ -683,6 +687,9 @@ or row lock! */
 #define	SYNC_BUF_FLUSH_LIST	145	/* Buffer flush list mutex */
 #define SYNC_DOUBLEWRITE	140
 #define	SYNC_ANY_LATCH		135
+#define	SYNC_FIL_SHARD		133	/* A shard of the tablespace
+					memory cache; acquired after the
+					fil_system mutex */
 #define	SYNC_MEM_HASH		131
 #define	SYNC_MEM_POOL		130
 
@@ -693,6 +700,35 @@ or row lock! */
 #define RW_LOCK_SHARED		352
 #define RW_LOCK_WAIT_EX		353
 #define SYNC_MUTEX		354
+#define RW_LOCK_SX		355
+
+#ifdef LINUX_FUTEX
+/** The event that a mutex or an rw-lock embeds for its waiters. The
+waiters are suspended on the futex directly, without reserving a cell in
+sync_primary_wait_array, so that they do not contend for the mutex of
+the array. */
+typedef os_futex_t		sync_event_t;
+#else /* LINUX_FUTEX */
+/** The event that a mutex or an rw-lock embeds for its waiters */
+typedef os_event_t		sync_event_t;
+#endif /* LINUX_FUTEX */
+
+/** A reservation for suspending a thread until a mutex or an rw-lock
+is released. It is made before the thread announces itself as a waiter
+of the latch, so that a release after that cannot be missed. */
+typedef struct sync_wait_struct	sync_wait_t;
+
+/** A reservation for suspending a thread */
+struct sync_wait_struct {
+#ifdef LINUX_FUTEX
+	sync_event_t*	event;	/*!< event of the latch */
+	ib_uint32_t	value;	/*!< value of the event at the time
+				of the reservation */
+#else /* LINUX_FUTEX */
+	ulint		index;	/*!< reserved cell in
+				sync_primary_wait_array */
+#endif /* LINUX_FUTEX */
+};
 
 /* NOTE! The structure appears here only for the compiler to know its size.
 Do not use its fields directly! The structure used in the spin lock
@@ -700,7 +736,7 @@ implementation of a mutual exclusion semaphore. */
 
 /** InnoDB mutex */
 struct mutex_struct {
-	os_event_t	event;	/*!< Used by sync0arr.c for the wait queue */
+	sync_event_t	event;	/*!< Used by sync0arr.c for the wait queue */
 	volatile lock_word_t	lock_word;	/*!< lock_word is the target
 				of the atomic test-and-set instruction when
 				atomic operations are enabled. */
@@ -752,6 +788,75 @@ mutexes and read-write locks. */
 extern sync_array_t*	sync_primary_wait_array;/* Appears here for
 						debugging purposes only! */
 
+/******************************************************************//**
+Creates the event that a mutex or an rw-lock embeds for its waiters. */
+UNIV_INLINE
+void
+sync_event_create(
+/*==============*/
+	sync_event_t*	event);	/*!< out: event */
+/******************************************************************//**
+Frees the event of a mutex or an rw-lock. */
+UNIV_INLINE
+void
+sync_event_free(
+/*============*/
+	sync_event_t*	event);	/*!< in/out: event */
+/******************************************************************//**
+Resets the event of a mutex or an rw-lock before a thread waits for it.
+@return	value to pass to sync_event_wait() */
+UNIV_INLINE
+ib_int64_t
+sync_event_reset(
+/*=============*/
+	sync_event_t*	event);	/*!< in/out: event */
+/******************************************************************//**
+Waits for the event of a mutex or an rw-lock, unless it was set after
+the sync_event_reset() call that returned signal_count. The caller must
+check its wait condition again. */
+UNIV_INLINE
+void
+sync_event_wait(
+/*============*/
+	sync_event_t*	event,	/*!< in: event */
+	ib_int64_t	signal_count);/*!< in: sync_event_reset() value */
+/******************************************************************//**
+Wakes the threads that wait for the event of a mutex or an rw-lock. */
+UNIV_INLINE
+void
+sync_event_set(
+/*===========*/
+	sync_event_t*	event);	/*!< in/out: event */
+/******************************************************************//**
+Reserves a wait for the event of a mutex or an rw-lock. The caller must
+then announce itself as a waiter of the latch, try to acquire the latch
+once more, and call either sync_wait_cancel() or sync_wait_suspend(). */
+UNIV_INLINE
+void
+sync_wait_reserve(
+/*==============*/
+	sync_wait_t*	wait,	/*!< out: reservation */
+	sync_event_t*	event,	/*!< in/out: event of the latch */
+	void*		object,	/*!< in: mutex or rw-lock */
+	ulint		type,	/*!< in: SYNC_MUTEX, RW_LOCK_SHARED, ... */
+	const char*	file,	/*!< in: file where requested */
+	ulint		line);	/*!< in: line where requested */
+/******************************************************************//**
+Cancels a wait reservation after the latch was acquired. */
+UNIV_INLINE
+void
+sync_wait_cancel(
+/*=============*/
+	sync_wait_t*	wait);	/*!< in: reservation */
+/******************************************************************//**
+Suspends the thread until the latch of a reservation is released. The
+caller must try to acquire the latch again. */
+UNIV_INLINE
+void
+sync_wait_suspend(
+/*==============*/
+	sync_wait_t*	wait);	/*!< in: reservation */
+
 /** Constant determining how long spin wait is continued before suspending
 the thread. A value 600 rounds on a 1995 100 MHz Pentium seems to correspond
 to 20 microseconds. */
@@ -117,6 +117,20 @@ trx_purge(
 /*======*/
 	ulint	limit);		/*!< in: the maximum number of records to
 				purge in one batch */
+/*******************************************************************//**
+Stops purge and waits for a running purge batch to complete.  Purge
+stays stopped until trx_purge_run() has been called once for each call
+of this function. */
+UNIV_INTERN
+void
+trx_purge_stop(void);
+/*================*/
+/*******************************************************************//**
+Resumes purge that was stopped by trx_purge_stop(). */
+UNIV_INTERN
+void
+trx_purge_run(void);
+/*===============*/
 /******************************************************************//**
 Prints information of the purge system to stderr. */
 UNIV_INTERN
@@ -189,6 +203,13 @@ struct trx_purge_struct{
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
 	mutex_t		bh_mutex;	/*!< Mutex protecting ib_bh */
+	/*-----------------------------*/
+	ulint		n_stop;		/*!< Number of pending
+					trx_purge_stop() calls; purge batches
+					are not started while this is
+					nonzero. Protected by kernel_mutex */
+	ibool		running;	/*!< TRUE while a purge batch is
+					running. Protected by kernel_mutex */
 };
 
 #define TRX_PURGE_ON		1	/* purge operation is running */
@@ -217,7 +217,9 @@ trx_undo_report_row_operation(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: in the case of an insert,
 					index entry to insert into the
-					clustered index, otherwise NULL */
+					clustered index, or NULL for a
+					bulk insert into the empty table
+					(TRX_UNDO_EMPTY); otherwise NULL */
 	const upd_t*	update,		/*!< in: in the case of an update,
 					the update vector, otherwise NULL */
 	ulint		cmpl_info,	/*!< in: compiler info on secondary
@@ -310,6 +312,9 @@ trx_undo_parse_erase_page_end(
 compilation info multiplied by 16 is ORed to this value in an undo log
 record */
 
+#define	TRX_UNDO_EMPTY		10	/* bulk insert into an empty table:
+					all its index trees are emptied
+					in a rollback */
 #define	TRX_UNDO_INSERT_REC	11	/* fresh insert into clustered index */
 #define	TRX_UNDO_UPD_EXIST_REC	12	/* update of a non-delete-marked
 					record */
@@ -410,8 +410,19 @@ ibool
 trx_is_strict(
 /*==========*/
 	trx_t*	trx);	/*!< in: transaction */
+/**********************************************************************//**
+Determines if the currently running transaction commits asynchronously,
+that is, writes but does not flush the log at commit although
+innodb_flush_log_at_trx_commit=1.
+@return	TRUE if innodb_async_commit is set for the transaction */
+UNIV_INTERN
+ibool
+trx_is_async_commit(
+/*================*/
+	trx_t*	trx);	/*!< in: transaction */
 #else /* !UNIV_HOTBACKUP */
 #define trx_is_interrupted(trx) FALSE
+#define trx_is_async_commit(trx) FALSE
 #endif /* !UNIV_HOTBACKUP */
 
 /*******************************************************************//**
@@ -529,7 +540,10 @@ struct trx_struct{
 					/* TRUE if this trx has latched the
 					search system latch in S-mode */
 	ulint		deadlock_mark;	/*!< a mark field used in deadlock
-					checking algorithm.  */
+					checking algorithm: equal to
+					lock_deadlock_mark_counter if the
+					current search has visited this
+					transaction */
 	trx_dict_op_t	dict_operation;	/**< @see enum trx_dict_op */
 
 	/* Fields protected by the srv_conc_mutex. */
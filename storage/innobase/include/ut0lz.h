@@ -0,0 +1,71 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/ut0lz.h
+Fast LZ77 block compression
+
+A block is a sequence of (literals, match) pairs, each starting with a
+token byte whose high nibble is the number of literals and whose low nibble
+is the match length minus UT_LZ_MIN_MATCH.  A nibble of 15 is continued by
+bytes of 255 and a final byte less than 255 that are added to it.  The
+literals follow the token, and the 2-byte little-endian distance of the
+match follows the literals.  The last pair of a block has no match.  Blocks
+are at most 64 KiB, and matches are found with a single-entry hash table,
+which trades compression ratio for speed.
+*******************************************************/
+
+#ifndef ut0lz_h
+#define ut0lz_h
+
+#include "univ.i"
+
+/** Maximum size of an uncompressed block */
+#define UT_LZ_MAX_LEN		65535
+
+/** Worst-case size of a compressed block.
+@param len	size of the uncompressed block
+@return		maximum size of the compressed block */
+#define UT_LZ_BOUND(len)	((len) + (len) / 255 + 16)
+
+/**********************************************************************//**
+Compresses a block.
+@return	size of the compressed block, or 0 if it did not fit in dst_len */
+UNIV_INTERN
+ulint
+ut_lz_compress(
+/*===========*/
+	const byte*	src,	/*!< in: uncompressed data */
+	ulint		src_len,/*!< in: size of src, at most UT_LZ_MAX_LEN */
+	byte*		dst,	/*!< out: compressed block */
+	ulint		dst_len);/*!< in: size of dst */
+/**********************************************************************//**
+Decompresses a block.  The input is validated, so that corrupted data
+cannot cause reads or writes outside the buffers.
+@return	size of the uncompressed data, or ULINT_UNDEFINED if the block
+is corrupted or does not fit in dst_len */
+UNIV_INTERN
+ulint
+ut_lz_decompress(
+/*=============*/
+	const byte*	src,	/*!< in: compressed block */
+	ulint		src_len,/*!< in: size of src */
+	byte*		dst,	/*!< out: uncompressed data */
+	ulint		dst_len);/*!< in: size of dst */
+
+#endif /* ut0lz_h */
@@ -39,6 +39,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "dict0mem.h"
 #include "trx0sys.h"
 #include "btr0btr.h"
+#include "ut0sort.h"
 #include "mysql/plugin.h"
 
 /* Restricts the length of search we will do in the waits-for
@@ -60,6 +61,11 @@ bitmap */
 
 #define LOCK_PAGE_BITMAP_MARGIN		64
 
+/* Number of waiting record lock requests on a page that
+lock_rec_grant_by_priority() sorts without allocating memory */
+
+#define LOCK_REC_SCHEDULE_N_STACK	16
+
 /* An explicit record lock affects both the record and the gap before it.
 An implicit x-lock does not affect the gap, it only locks the index
 record from read or update.
@@ -373,11 +379,37 @@ Monitor will then fetch it and print */
 UNIV_INTERN ibool	lock_deadlock_found = FALSE;
 UNIV_INTERN FILE*	lock_latest_err_file;
 
-/* Flags for recursive deadlock search */
+/* Flags for deadlock search */
 #define LOCK_VICTIM_IS_START	1
 #define LOCK_VICTIM_IS_OTHER	2
 #define LOCK_EXCEED_MAX_DEPTH	3
 
+/** A transaction on the current path of the deadlock search, and the
+position of the search in the queue of the lock it is waiting for */
+typedef struct lock_deadlock_frame_struct	lock_deadlock_frame_t;
+struct lock_deadlock_frame_struct {
+	trx_t*		trx;		/*!< a transaction waiting for
+					a lock */
+	lock_t*		wait_lock;	/*!< the lock trx is waiting for */
+	lock_t*		lock;		/*!< the lock ahead of wait_lock in
+					the queue that is examined next,
+					or NULL if all have been examined */
+	ulint		heap_no;	/*!< heap number of the record
+					wait_lock is waiting for, or
+					ULINT_UNDEFINED for a table lock */
+};
+
+/** The path of the deadlock search. The search is done under the kernel
+mutex, so one stack is enough. */
+static lock_deadlock_frame_t
+	lock_deadlock_stack[LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK + 2];
+
+/** Incremented at the start of each deadlock search. A transaction has
+been visited by the current search if its deadlock_mark equals this, so
+that the transactions need not be reset between searches. Protected by
+the kernel mutex. */
+static ulint	lock_deadlock_mark_counter = 0;
+
 /********************************************************************//**
 Checks if a lock request results in a deadlock.
 @return TRUE if a deadlock was detected and we chose trx as a victim;
@@ -390,7 +422,10 @@ lock_deadlock_occurs(
 	lock_t*	lock,	/*!< in: lock the transaction is requesting */
 	trx_t*	trx);	/*!< in: transaction */
 /********************************************************************//**
-Looks recursively for a deadlock.
+Looks for a cycle in the waits-for graph through the transaction that
+requests a lock. The search is iterative, visits each transaction at most
+once, and gives up after LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK transactions
+or LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK levels.
 @return 0 if no deadlock found, LOCK_VICTIM_IS_START if there was a
 deadlock and we chose 'start' as the victim, LOCK_VICTIM_IS_OTHER if a
 deadlock was found and we chose some other trx as a victim: we must do
@@ -399,16 +434,13 @@ deadlock!
 LOCK_EXCEED_MAX_DEPTH if the lock search exceeds max steps or max depth. */
 static
 ulint
-lock_deadlock_recursive(
-/*====================*/
-	trx_t*	start,		/*!< in: recursion starting point */
-	trx_t*	trx,		/*!< in: a transaction waiting for a lock */
-	lock_t*	wait_lock,	/*!< in:  lock that is waiting to be granted */
-	ulint*	cost,		/*!< in/out: number of calculation steps thus
-				far: if this exceeds LOCK_MAX_N_STEPS_...
-				we return LOCK_EXCEED_MAX_DEPTH */
-	ulint	depth);		/*!< in: recursion depth: if this exceeds
-				LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK, we
+lock_deadlock_search(
+/*=================*/
+	trx_t*	start,		/*!< in: transaction requesting the lock */
+	lock_t*	start_lock,	/*!< in: lock that is waiting to be granted */
+	ulint*	cost);		/*!< in/out: number of transactions visited
+				thus far: if this exceeds
+				LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK we
 				return LOCK_EXCEED_MAX_DEPTH */
 
 /*********************************************************************//**
@@ -2286,6 +2318,256 @@ lock_rec_cancel(
 	trx_end_lock_wait(lock->trx);
 }
 
+/*********************************************************************//**
+Checks if a waiting record lock request conflicts with a granted lock
+anywhere in the queue. Unlike lock_rec_has_to_wait_in_queue(), this ignores
+the other waiting requests, so that the request can be granted ahead of
+them.
+@return	TRUE if still has to wait */
+static
+ibool
+lock_rec_has_to_wait_for_granted(
+/*=============================*/
+	const lock_t*	wait_lock)	/*!< in: waiting record lock */
+{
+	const lock_t*	lock;
+	ulint		heap_no;
+
+	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_get_wait(wait_lock));
+	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
+
+	heap_no = lock_rec_find_set_bit(wait_lock);
+
+	for (lock = lock_rec_get_first_on_page_addr(
+		     wait_lock->un_member.rec_lock.space,
+		     wait_lock->un_member.rec_lock.page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page_const(lock)) {
+
+		if (lock != wait_lock
+		    && !lock_get_wait(lock)
+		    && lock_rec_get_nth_bit(lock, heap_no)
+		    && lock_has_to_wait(wait_lock, lock)) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/*********************************************************************//**
+Checks if a waiting record lock request should be granted before another
+one under the current innodb_lock_schedule_algorithm.
+@return	TRUE if lock1 goes first */
+static
+ibool
+lock_rec_schedule_before(
+/*=====================*/
+	const lock_t*	lock1,	/*!< in: waiting record lock */
+	const lock_t*	lock2)	/*!< in: another waiting record lock */
+{
+	const trx_t*	trx1 = lock1->trx;
+	const trx_t*	trx2 = lock2->trx;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	if (srv_lock_schedule_algorithm == SRV_LOCK_SCHEDULE_MOST_LOCKS) {
+		ulint	n_locks1 = UT_LIST_GET_LEN(trx1->trx_locks);
+		ulint	n_locks2 = UT_LIST_GET_LEN(trx2->trx_locks);
+
+		if (n_locks1 != n_locks2) {
+
+			return(n_locks1 > n_locks2);
+		}
+	}
+
+	/* Transaction ids are assigned in the order the transactions
+	start. */
+
+	return(trx1->id < trx2->id);
+}
+
+/*********************************************************************//**
+Compares two waiting record locks for lock_rec_schedule_sort().
+@return	negative if lock1 is to be granted first, positive if lock2 is,
+0 if they have the same priority */
+static
+int
+lock_rec_schedule_cmp(
+/*==================*/
+	const lock_t*	lock1,	/*!< in: waiting record lock */
+	const lock_t*	lock2)	/*!< in: waiting record lock */
+{
+	if (lock_rec_schedule_before(lock1, lock2)) {
+
+		return(-1);
+	} else if (lock_rec_schedule_before(lock2, lock1)) {
+
+		return(1);
+	}
+
+	return(0);
+}
+
+/*********************************************************************//**
+Sorts waiting record locks in the order in which they are to be granted.
+The sort is stable, so requests of the same priority keep their queue
+order. */
+static
+void
+lock_rec_schedule_sort(
+/*===================*/
+	lock_t**	arr,	/*!< in/out: array to be sorted */
+	lock_t**	aux_arr,/*!< in/out: auxiliary array of the same
+				size */
+	ulint		low,	/*!< in: lower bound of the sorting area,
+				inclusive */
+	ulint		high)	/*!< in: upper bound of the sorting area,
+				exclusive */
+{
+	UT_SORT_FUNCTION_BODY(lock_rec_schedule_sort, arr, aux_arr,
+			      low, high, lock_rec_schedule_cmp);
+}
+
+/*********************************************************************//**
+Moves a record lock to the head of its hash chain, which puts it ahead of
+all the other locks on the same page in the lock queue. */
+static
+void
+lock_rec_move_to_front(
+/*===================*/
+	lock_t*	lock)	/*!< in/out: record lock */
+{
+	ulint		fold;
+	hash_cell_t*	cell;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	fold = lock_rec_fold(lock->un_member.rec_lock.space,
+			     lock->un_member.rec_lock.page_no);
+
+	HASH_DELETE(lock_t, hash, lock_sys->rec_hash, fold, lock);
+
+	cell = hash_get_nth_cell(lock_sys->rec_hash,
+				 hash_calc_hash(fold, lock_sys->rec_hash));
+
+	lock->hash = cell->node;
+	cell->node = lock;
+}
+
+/*********************************************************************//**
+Grants the waiting record locks on a page that no granted lock conflicts
+with, highest priority first. Each granted request is moved to the front
+of the queue, so that the requests it passed now wait for it. This lets an
+old transaction (or one that blocks many others) overtake younger waiters
+on a hot row instead of queueing behind them.
+
+Granting a request can only make the others wait longer, so a request
+that has to wait when its turn comes cannot be granted later in the same
+call. The waiting requests are therefore sorted once and visited once. */
+static
+void
+lock_rec_grant_by_priority(
+/*=======================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no)	/*!< in: page number */
+{
+	lock_t*		lock;
+	lock_t*		stack_arr[2 * LOCK_REC_SCHEDULE_N_STACK];
+	lock_t**	arr;
+	ulint		n_wait	= 0;
+	ulint		i;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	for (lock = lock_rec_get_first_on_page_addr(space, page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page(lock)) {
+
+		n_wait += lock_get_wait(lock) != 0;
+	}
+
+	if (n_wait == 0) {
+
+		return;
+	}
+
+	arr = n_wait <= LOCK_REC_SCHEDULE_N_STACK
+		? stack_arr
+		: mem_alloc(2 * n_wait * sizeof *arr);
+
+	i = 0;
+
+	for (lock = lock_rec_get_first_on_page_addr(space, page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page(lock)) {
+
+		if (lock_get_wait(lock)) {
+			arr[i++] = lock;
+		}
+	}
+
+	ut_ad(i == n_wait);
+
+	lock_rec_schedule_sort(arr, arr + n_wait, 0, n_wait);
+
+	for (i = 0; i < n_wait; i++) {
+
+		lock = arr[i];
+
+		if (!lock_rec_has_to_wait_for_granted(lock)) {
+
+			lock_rec_move_to_front(lock);
+
+			lock_grant(lock);
+		}
+	}
+
+	if (arr != stack_arr) {
+		mem_free(arr);
+	}
+}
+
+/*********************************************************************//**
+Grants the waiting record locks on a page that are now entitled to a lock,
+in the order chosen by innodb_lock_schedule_algorithm. Every path that
+releases record locks goes through here. */
+static
+void
+lock_rec_grant(
+/*===========*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no)	/*!< in: page number */
+{
+	lock_t*	lock;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	if (srv_lock_schedule_algorithm != SRV_LOCK_SCHEDULE_FCFS) {
+
+		lock_rec_grant_by_priority(space, page_no);
+
+		return;
+	}
+
+	/* Check if waiting locks in the queue can now be granted: grant
+	locks if there are no conflicting locks ahead. */
+
+	for (lock = lock_rec_get_first_on_page_addr(space, page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page(lock)) {
+
+		if (lock_get_wait(lock)
+		    && !lock_rec_has_to_wait_in_queue(lock)) {
+
+			/* Grant the lock */
+			lock_grant(lock);
+		}
+	}
+}
+
 /*************************************************************//**
 Removes a record lock request, waiting or granted, from the queue and
 grants locks to other transactions in the queue if they now are entitled
@@ -2301,7 +2583,6 @@ lock_rec_dequeue_from_page(
 {
 	ulint	space;
 	ulint	page_no;
-	lock_t*	lock;
 	trx_t*	trx;
 
 	ut_ad(mutex_own(&kernel_mutex));
@@ -2317,21 +2598,7 @@ lock_rec_dequeue_from_page(
 
 	UT_LIST_REMOVE(trx_locks, trx->trx_locks, in_lock);
 
-	/* Check if waiting locks in the queue can now be granted: grant
-	locks if there are no conflicting locks ahead. */
-
-	lock = lock_rec_get_first_on_page_addr(space, page_no);
-
-	while (lock != NULL) {
-		if (lock_get_wait(lock)
-		    && !lock_rec_has_to_wait_in_queue(lock)) {
-
-			/* Grant the lock */
-			lock_grant(lock);
-		}
-
-		lock = lock_rec_get_next_on_page(lock);
-	}
+	lock_rec_grant(space, page_no);
 }
 
 /*************************************************************//**
@@ -2409,6 +2676,7 @@ lock_rec_reset_and_release_wait(
 	ulint			heap_no)/*!< in: heap number of record */
 {
 	lock_t*	lock;
+	ibool	released	= FALSE;
 
 	ut_ad(mutex_own(&kernel_mutex));
 
@@ -2423,10 +2691,23 @@ lock_rec_reset_and_release_wait(
 			lock_reset_lock_and_trx_wait(lock);
 		} else {
 			lock_rec_reset_nth_bit(lock, heap_no);
+			released = TRUE;
 		}
 
 		lock = lock_rec_get_next(heap_no, lock);
 	}
+
+	if (released
+	    && srv_lock_schedule_algorithm != SRV_LOCK_SCHEDULE_FCFS) {
+		/* This is reached from page reorganization, inheritance
+		and discard; let the waiters on the page be granted by
+		the same rules as on a normal release.  The waiters on
+		heap_no were reset above, so FCFS keeps skipping this
+		page scan, which would run once per moved record. */
+
+		lock_rec_grant(buf_block_get_space(block),
+			       buf_block_get_page_no(block));
+	}
 }
 
 /*************************************************************//**
@@ -3396,7 +3677,6 @@ lock_deadlock_occurs(
 	lock_t*	lock,	/*!< in: lock the transaction is requesting */
 	trx_t*	trx)	/*!< in: transaction */
 {
-	trx_t*		mark_trx;
 	ulint		ret;
 	ulint		cost	= 0;
 
@@ -3405,17 +3685,19 @@ lock_deadlock_occurs(
 	ut_ad(mutex_own(&kernel_mutex));
 retry:
 	/* We check that adding this trx to the waits-for graph
-	does not produce a cycle. First mark all active transactions
-	with 0: */
+	does not produce a cycle. */
+
+	srv_n_lock_deadlock_checks++;
 
-	mark_trx = UT_LIST_GET_FIRST(trx_sys->trx_list);
+	ret = lock_deadlock_search(trx, lock, &cost);
 
-	while (mark_trx) {
-		mark_trx->deadlock_mark = 0;
-		mark_trx = UT_LIST_GET_NEXT(trx_list, mark_trx);
+	srv_n_lock_deadlock_check_steps += cost;
+
+	if (cost > srv_n_lock_deadlock_check_max_steps) {
+		srv_n_lock_deadlock_check_max_steps = cost;
 	}
 
-	ret = lock_deadlock_recursive(trx, trx, lock, &cost, 0);
+	cost = 0;
 
 	/* Increment counter if a deadlock was detected. */
 	if (ret) {
@@ -3432,6 +3714,8 @@ retry:
 		/* If the lock search exceeds the max step
 		or the max depth, the current trx will be
 		the victim. Print its information. */
+		srv_n_lock_deadlock_check_aborts++;
+
 		lock_deadlock_start_print();
 
 		lock_deadlock_fputs(
@@ -3464,62 +3748,68 @@ retry:
 }
 
 /********************************************************************//**
-Looks recursively for a deadlock.
-@return 0 if no deadlock found, LOCK_VICTIM_IS_START if there was a
-deadlock and we chose 'start' as the victim, LOCK_VICTIM_IS_OTHER if a
-deadlock was found and we chose some other trx as a victim: we must do
-the search again in this last case because there may be another
-deadlock!
-LOCK_EXCEED_MAX_DEPTH if the lock search exceeds max steps or max depth. */
-static
-ulint
-lock_deadlock_recursive(
-/*====================*/
-	trx_t*	start,		/*!< in: recursion starting point */
-	trx_t*	trx,		/*!< in: a transaction waiting for a lock */
-	lock_t*	wait_lock,	/*!< in: lock that is waiting to be granted */
-	ulint*	cost,		/*!< in/out: number of calculation steps thus
-				far: if this exceeds LOCK_MAX_N_STEPS_...
-				we return LOCK_EXCEED_MAX_DEPTH */
-	ulint	depth)		/*!< in: recursion depth: if this exceeds
-				LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK, we
-				return LOCK_EXCEED_MAX_DEPTH */
+Advances a deadlock search frame to the next lock ahead of its wait_lock
+in the queue: the next record lock on the same record, or the previous
+table lock. Sets frame->lock to NULL when the queue is exhausted. */
+UNIV_INLINE
+void
+lock_deadlock_frame_next(
+/*=====================*/
+	lock_deadlock_frame_t*	frame)	/*!< in/out: search frame */
 {
-	ulint	ret;
-	lock_t*	lock;
-	trx_t*	lock_trx;
-	ulint	heap_no		= ULINT_UNDEFINED;
+	lock_t*	lock = frame->lock;
 
-	ut_a(trx);
-	ut_a(start);
-	ut_a(wait_lock);
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock != NULL);
 
-	if (trx->deadlock_mark == 1) {
-		/* We have already exhaustively searched the subtree starting
-		from this trx */
+	if (frame->heap_no == ULINT_UNDEFINED) {
 
-		return(0);
+		lock = UT_LIST_GET_PREV(un_member.tab_lock.locks, lock);
+	} else {
+		do {
+			lock = lock_rec_get_next_on_page(lock);
+		} while (lock != NULL
+			 && lock != frame->wait_lock
+			 && !lock_rec_get_nth_bit(lock, frame->heap_no));
+
+		if (lock == frame->wait_lock) {
+			lock = NULL;
+		}
 	}
 
-	*cost = *cost + 1;
+	frame->lock = lock;
+}
 
-	if (lock_get_type_low(wait_lock) == LOCK_REC) {
-		ulint		space;
-		ulint		page_no;
+/********************************************************************//**
+Initializes a deadlock search frame and positions it on the first lock
+ahead of wait_lock in the queue. */
+UNIV_INLINE
+void
+lock_deadlock_frame_init(
+/*=====================*/
+	lock_deadlock_frame_t*	frame,		/*!< out: search frame */
+	trx_t*			trx,		/*!< in: waiting transaction */
+	lock_t*			wait_lock)	/*!< in: lock trx is
+						waiting for */
+{
+	ut_a(wait_lock);
+
+	frame->trx = trx;
+	frame->wait_lock = wait_lock;
 
-		heap_no = lock_rec_find_set_bit(wait_lock);
-		ut_a(heap_no != ULINT_UNDEFINED);
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		lock_t*	lock;
 
-		space = wait_lock->un_member.rec_lock.space;
-		page_no = wait_lock->un_member.rec_lock.page_no;
+		frame->heap_no = lock_rec_find_set_bit(wait_lock);
+		ut_a(frame->heap_no != ULINT_UNDEFINED);
 
-		lock = lock_rec_get_first_on_page_addr(space, page_no);
+		lock = lock_rec_get_first_on_page_addr(
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
 
 		/* Position the iterator on the first matching record lock. */
 		while (lock != NULL
 		       && lock != wait_lock
-		       && !lock_rec_get_nth_bit(lock, heap_no)) {
+		       && !lock_rec_get_nth_bit(lock, frame->heap_no)) {
 
 			lock = lock_rec_get_next_on_page(lock);
 		}
@@ -3528,157 +3818,202 @@ lock_deadlock_recursive(
 			lock = NULL;
 		}
 
-		ut_ad(lock == NULL || lock_rec_get_nth_bit(lock, heap_no));
+		ut_ad(lock == NULL
+		      || lock_rec_get_nth_bit(lock, frame->heap_no));
 
+		frame->lock = lock;
 	} else {
-		lock = wait_lock;
+		frame->heap_no = ULINT_UNDEFINED;
+		frame->lock = wait_lock;
+
+		lock_deadlock_frame_next(frame);
 	}
+}
+
+/********************************************************************//**
+Looks for a cycle in the waits-for graph through the transaction that
+requests a lock. The search is iterative, visits each transaction at most
+once, and gives up after LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK transactions
+or LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK levels.
+@return 0 if no deadlock found, LOCK_VICTIM_IS_START if there was a
+deadlock and we chose 'start' as the victim, LOCK_VICTIM_IS_OTHER if a
+deadlock was found and we chose some other trx as a victim: we must do
+the search again in this last case because there may be another
+deadlock!
+LOCK_EXCEED_MAX_DEPTH if the lock search exceeds max steps or max depth. */
+static
+ulint
+lock_deadlock_search(
+/*=================*/
+	trx_t*	start,		/*!< in: transaction requesting the lock */
+	lock_t*	start_lock,	/*!< in: lock that is waiting to be granted */
+	ulint*	cost)		/*!< in/out: number of transactions visited
+				thus far: if this exceeds
+				LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK we
+				return LOCK_EXCEED_MAX_DEPTH */
+{
+	lock_deadlock_frame_t*	frame;
+	ulint			depth	= 0;
 
-	/* Look at the locks ahead of wait_lock in the lock queue */
+	ut_a(start);
+	ut_a(start_lock);
+	ut_ad(mutex_own(&kernel_mutex));
 
-	for (;;) {
-		/* Get previous table lock. */
-		if (heap_no == ULINT_UNDEFINED) {
+	/* A new mark value invalidates the marks left by earlier
+	searches, instead of resetting all active transactions. */
 
-			lock = UT_LIST_GET_PREV(
-				un_member.tab_lock.locks, lock);
-		}
+	lock_deadlock_mark_counter++;
+
+	start->deadlock_mark = lock_deadlock_mark_counter;
+	*cost = *cost + 1;
+
+	frame = lock_deadlock_stack;
+	lock_deadlock_frame_init(frame, start, start_lock);
+
+	for (;;) {
+		lock_t*	lock = frame->lock;
+		lock_t*	wait_lock = frame->wait_lock;
+		trx_t*	lock_trx;
+		ibool	too_far;
 
 		if (lock == NULL) {
-			/* We can mark this subtree as searched */
-			trx->deadlock_mark = 1;
+			/* All the locks ahead of wait_lock have been
+			examined: backtrack. */
 
-			return(FALSE);
+			if (depth == 0) {
+
+				return(0);
+			}
+
+			depth--;
+			frame--;
+
+			lock_deadlock_frame_next(frame);
+
+			continue;
 		}
 
-		if (lock_has_to_wait(wait_lock, lock)) {
+		if (!lock_has_to_wait(wait_lock, lock)) {
+
+			lock_deadlock_frame_next(frame);
 
-			ibool	too_far
-				= depth > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK
-				|| *cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK;
+			continue;
+		}
 
-			lock_trx = lock->trx;
+		too_far = depth > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK
+			|| *cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK;
 
-			if (lock_trx == start) {
+		lock_trx = lock->trx;
 
-				/* We came back to the recursion starting
-				point: a deadlock detected; or we have
-				searched the waits-for graph too long */
+		if (lock_trx == start) {
 
-				lock_deadlock_start_print();
+			/* We came back to the search starting point:
+			a deadlock detected */
 
-				lock_deadlock_fputs("\n*** (1) TRANSACTION:\n");
+			lock_deadlock_start_print();
 
-				lock_deadlock_trx_print(wait_lock->trx, 3000);
+			lock_deadlock_fputs("\n*** (1) TRANSACTION:\n");
 
-				lock_deadlock_fputs(
-					"*** (1) WAITING FOR THIS LOCK"
-					" TO BE GRANTED:\n");
+			lock_deadlock_trx_print(wait_lock->trx, 3000);
 
-				lock_deadlock_lock_print(wait_lock);
+			lock_deadlock_fputs(
+				"*** (1) WAITING FOR THIS LOCK"
+				" TO BE GRANTED:\n");
 
-				lock_deadlock_fputs("*** (2) TRANSACTION:\n");
+			lock_deadlock_lock_print(wait_lock);
 
-				lock_deadlock_trx_print(lock->trx, 3000);
+			lock_deadlock_fputs("*** (2) TRANSACTION:\n");
 
-				lock_deadlock_fputs(
-					"*** (2) HOLDS THE LOCK(S):\n");
+			lock_deadlock_trx_print(lock->trx, 3000);
 
-				lock_deadlock_lock_print(lock);
+			lock_deadlock_fputs(
+				"*** (2) HOLDS THE LOCK(S):\n");
 
-				lock_deadlock_fputs(
-					"*** (2) WAITING FOR THIS LOCK"
-					" TO BE GRANTED:\n");
+			lock_deadlock_lock_print(lock);
 
-				lock_deadlock_lock_print(start->wait_lock);
+			lock_deadlock_fputs(
+				"*** (2) WAITING FOR THIS LOCK"
+				" TO BE GRANTED:\n");
+
+			lock_deadlock_lock_print(start->wait_lock);
 
 #ifdef UNIV_DEBUG
-				if (lock_print_waits) {
-					fputs("Deadlock detected\n",
-					      stderr);
-				}
+			if (lock_print_waits) {
+				fputs("Deadlock detected\n", stderr);
+			}
 #endif /* UNIV_DEBUG */
 
-				if (trx_weight_ge(wait_lock->trx, start)) {
-					/* Our recursion starting point
-					transaction is 'smaller', let us
-					choose 'start' as the victim and roll
-					back it */
+			if (trx_weight_ge(wait_lock->trx, start)) {
+				/* Our search starting point transaction
+				is 'smaller', let us choose 'start' as the
+				victim and roll back it */
 
-					return(LOCK_VICTIM_IS_START);
-				}
+				return(LOCK_VICTIM_IS_START);
+			}
 
-				lock_deadlock_found = TRUE;
+			lock_deadlock_found = TRUE;
 
-				/* Let us choose the transaction of wait_lock
-				as a victim to try to avoid deadlocking our
-				recursion starting point transaction */
+			/* Let us choose the transaction of wait_lock
+			as a victim to try to avoid deadlocking our
+			search starting point transaction */
 
-				lock_deadlock_fputs(
-					"*** WE ROLL BACK TRANSACTION (1)\n");
+			lock_deadlock_fputs(
+				"*** WE ROLL BACK TRANSACTION (1)\n");
 
-				wait_lock->trx->was_chosen_as_deadlock_victim
-					= TRUE;
+			wait_lock->trx->was_chosen_as_deadlock_victim = TRUE;
 
-				lock_cancel_waiting_and_release(wait_lock);
+			lock_cancel_waiting_and_release(wait_lock);
 
-				/* Since trx and wait_lock are no longer
-				in the waits-for graph, we can return FALSE;
-				note that our selective algorithm can choose
-				several transactions as victims, but still
-				we may end up rolling back also the recursion
-				starting point transaction! */
+			/* Since trx and wait_lock are no longer in the
+			waits-for graph, the caller must search again;
+			note that our selective algorithm can choose
+			several transactions as victims, but still we
+			may end up rolling back also the search starting
+			point transaction! */
 
-				return(LOCK_VICTIM_IS_OTHER);
-			}
+			return(LOCK_VICTIM_IS_OTHER);
+		}
 
-			if (too_far) {
+		if (too_far) {
 
 #ifdef UNIV_DEBUG
-				if (lock_print_waits) {
-					fputs("Deadlock search exceeds"
-					      " max steps or depth.\n",
-					      stderr);
-				}
-#endif /* UNIV_DEBUG */
-				/* The information about transaction/lock
-				to be rolled back is available in the top
-				level. Do not print anything here. */
-				return(LOCK_EXCEED_MAX_DEPTH);
+			if (lock_print_waits) {
+				fputs("Deadlock search exceeds"
+				      " max steps or depth.\n", stderr);
 			}
+#endif /* UNIV_DEBUG */
+			/* The information about transaction/lock
+			to be rolled back is available in the top
+			level. Do not print anything here. */
+			return(LOCK_EXCEED_MAX_DEPTH);
+		}
 
-			if (lock_trx->que_state == TRX_QUE_LOCK_WAIT) {
-
-				/* Another trx ahead has requested lock	in an
-				incompatible mode, and is itself waiting for
-				a lock */
+		if (lock_trx->que_state == TRX_QUE_LOCK_WAIT
+		    && lock_trx->deadlock_mark != lock_deadlock_mark_counter) {
 
-				ret = lock_deadlock_recursive(
-					start, lock_trx,
-					lock_trx->wait_lock, cost, depth + 1);
+			/* Another trx ahead has requested lock in an
+			incompatible mode, and is itself waiting for a
+			lock that no search path has examined yet:
+			descend. A transaction that has been visited
+			before either is on the current path or did not
+			lead back to start. */
 
-				if (ret != 0) {
+			lock_trx->deadlock_mark = lock_deadlock_mark_counter;
+			*cost = *cost + 1;
 
-					return(ret);
-				}
-			}
-		}
-		/* Get the next record lock to check. */
-		if (heap_no != ULINT_UNDEFINED) {
+			depth++;
+			frame++;
 
-			ut_a(lock != NULL);
+			ut_ad(depth <= LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK + 1);
 
-			do {
-				lock = lock_rec_get_next_on_page(lock);
-			} while (lock != NULL
-				&& lock != wait_lock
-				&& !lock_rec_get_nth_bit(lock, heap_no));
+			lock_deadlock_frame_init(
+				frame, lock_trx, lock_trx->wait_lock);
 
-			if (lock == wait_lock) {
-				lock = NULL;
-			}
+			continue;
 		}
-	}/* end of the 'for (;;)'-loop */
+
+		lock_deadlock_frame_next(frame);
+	}
 }
 
 /*========================= TABLE LOCKS ==============================*/
@@ -4169,15 +4504,8 @@ lock_rec_unlock(
 released:
 	/* Check if we can now grant waiting lock requests */
 
-	for (lock = first_lock; lock != NULL;
-	     lock = lock_rec_get_next(heap_no, lock)) {
-		if (lock_get_wait(lock)
-		    && !lock_rec_has_to_wait_in_queue(lock)) {
-
-			/* Grant the lock */
-			lock_grant(lock);
-		}
-	}
+	lock_rec_grant(buf_block_get_space(block),
+		       buf_block_get_page_no(block));
 
 	mutex_exit(&kernel_mutex);
 }
@@ -5137,7 +5465,7 @@ lock_rec_block_validate(
 
 	/* Make sure that the tablespace is not deleted while we are
 	trying to access the page. */
-	if (!fil_inc_pending_ops(space)) {
+	if (!fil_inc_pending_ops(space, TRUE)) {
 		mtr_start(&mtr);
 		block = buf_page_get_gen(
 			space, fil_space_get_zip_size(space),
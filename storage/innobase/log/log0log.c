@@ -44,6 +44,8 @@ Created 12/9/1995 Heikki Tuuri
 #include "log0recv.h"
 #include "fil0fil.h"
 #include "dict0boot.h"
+#include "dict0stats.h"
+#include "ibuf0ibuf.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "trx0sys.h"
@@ -82,6 +84,9 @@ UNIV_INTERN ulint	log_fsp_current_free_limit		= 0;
 /* Global log system variable */
 UNIV_INTERN log_t*	log_sys	= NULL;
 
+/* TRUE if log_flush_thread() is running */
+UNIV_INTERN ibool	log_flush_thread_active	= FALSE;
+
 #ifdef UNIV_PFS_RWLOCK
 UNIV_INTERN mysql_pfs_key_t	checkpoint_lock_key;
 # ifdef UNIV_LOG_ARCHIVE
@@ -929,6 +934,8 @@ log_init(void)
 
 	os_event_set(log_sys->one_flushed_event);
 
+	log_sys->flush_timer_event = os_event_create(NULL);
+
 	/*----------------------------*/
 	log_sys->adm_checkpoint_interval = ULINT_MAX;
 
@@ -1701,6 +1708,73 @@ log_buffer_sync_in_background(
 	log_write_up_to(lsn, LOG_NO_WAIT, flush);
 }
 
+/****************************************************************//**
+Writes the log buffer to the log files and flushes them to disk up to
+the given lsn, or up to the current lsn if that is smaller. Waits for
+the flush to complete. */
+UNIV_INTERN
+void
+log_flush_up_to(
+/*============*/
+	ib_uint64_t	lsn)	/*!< in: lsn that must be on disk */
+{
+	mutex_enter(&(log_sys->mutex));
+
+	if (lsn > log_sys->lsn) {
+		lsn = log_sys->lsn;
+	}
+
+	mutex_exit(&(log_sys->mutex));
+
+	log_write_up_to(lsn, LOG_WAIT_ONE_GROUP, TRUE);
+}
+
+/*********************************************************************//**
+A thread which writes and flushes the log buffer every
+innodb_flush_log_interval milliseconds, so that transactions committed
+with innodb_flush_log_at_trx_commit=0 or 2 or with innodb_async_commit
+become durable within that interval.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+log_flush_thread(
+/*=============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ib_int64_t	sig_count;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flush_thread_key);
+#endif
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		sig_count = os_event_reset(log_sys->flush_timer_event);
+
+		os_event_wait_time_low(log_sys->flush_timer_event,
+				       srv_flush_log_interval * 1000,
+				       sig_count);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		log_buffer_sync_in_background(TRUE);
+	}
+
+	/* The master thread flushes the log from now on. */
+	log_flush_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /********************************************************************
 
 Tries to establish a big enough margin of free space in the log buffer, such
@@ -3217,7 +3291,11 @@ loop:
 
 	if (srv_error_monitor_active
 	    || srv_lock_timeout_active
-	    || srv_monitor_active) {
+	    || srv_monitor_active
+	    || dict_stats_thread_active
+	    || log_flush_thread_active
+	    || buf_resize_thread_active
+	    || ibuf_merge_thread_active) {
 		const char*	thread_active = NULL;
 
 		/* Print a message every 60 seconds if we are waiting
@@ -3231,6 +3309,14 @@ loop:
 			       thread_active = "srv_lock_timeout thread";
 		       } else if (srv_monitor_active) {
 			       thread_active = "srv_monitor_thread";
+		       } else if (dict_stats_thread_active) {
+			       thread_active = "dict_stats_thread";
+		       } else if (log_flush_thread_active) {
+			       thread_active = "log_flush_thread";
+		       } else if (buf_resize_thread_active) {
+			       thread_active = "buf_resize_thread";
+		       } else if (ibuf_merge_thread_active) {
+			       thread_active = "ibuf_merge_thread";
 		       }
 		}
 
@@ -3239,6 +3325,10 @@ loop:
 		os_event_set(srv_error_event);
 		os_event_set(srv_monitor_event);
 		os_event_set(srv_timeout_event);
+		os_event_set(dict_stats_event);
+		os_event_set(log_sys->flush_timer_event);
+		os_event_set(buf_resize_event);
+		os_event_set(ibuf_merge_event);
 
 		if (thread_active) {
 			ut_print_timestamp(stderr);
@@ -3656,6 +3746,7 @@ log_shutdown(void)
 
 	os_event_free(log_sys->no_flush_event);
 	os_event_free(log_sys->one_flushed_event);
+	os_event_free(log_sys->flush_timer_event);
 
 	rw_lock_free(&log_sys->checkpoint_lock);
 
@@ -31,6 +31,7 @@ Created 12/7/1995 Heikki Tuuri
 
 #include "buf0buf.h"
 #include "dict0dict.h"
+#include "fsp0fsp.h"
 #include "log0recv.h"
 #include "page0page.h"
 
@@ -477,7 +478,13 @@ mlog_open_and_write_index(
 		log_end = log_ptr + alloc;
 		log_ptr = mlog_write_initial_log_record_fast(rec, type,
 							     log_ptr, mtr);
-		mach_write_to_2(log_ptr, n);
+		ut_ad(n <= MLOG_INDEX_N_MASK);
+		mach_write_to_2(log_ptr,
+				n
+				| index->table->zip_codec
+				<< MLOG_INDEX_POS_ZIP_CODEC
+				| index->table->zip_level
+				<< MLOG_INDEX_POS_ZIP_LEVEL);
 		log_ptr += 2;
 		mach_write_to_2(log_ptr,
 				dict_index_get_n_unique_in_tree(index));
@@ -542,6 +549,8 @@ mlog_parse_index(
 	dict_index_t**	index)	/*!< out, own: dummy index */
 {
 	ulint		i, n, n_uniq;
+	ulint		zip_codec	= PAGE_ZIP_CODEC_ZLIB;
+	ulint		zip_level	= 0;
 	dict_table_t*	table;
 	dict_index_t*	ind;
 
@@ -553,6 +562,10 @@ mlog_parse_index(
 		}
 		n = mach_read_from_2(ptr);
 		ptr += 2;
+		zip_codec = (n >> MLOG_INDEX_POS_ZIP_CODEC)
+			& ~(~0UL << FSP_FLAGS_WIDTH_ZIP_CODEC);
+		zip_level = n >> MLOG_INDEX_POS_ZIP_LEVEL;
+		n &= MLOG_INDEX_N_MASK;
 		n_uniq = mach_read_from_2(ptr);
 		ptr += 2;
 		ut_ad(n_uniq <= n);
@@ -564,6 +577,9 @@ mlog_parse_index(
 	}
 	table = dict_mem_table_create("LOG_DUMMY", DICT_HDR_SPACE, n,
 				      comp ? DICT_TF_COMPACT : 0);
+	/* Recompress the page as it was compressed when logged. */
+	table->zip_codec = (unsigned int) zip_codec;
+	table->zip_level = (unsigned int) zip_level;
 	ind = dict_mem_index_create("LOG_DUMMY", "LOG_DUMMY",
 				    DICT_HDR_SPACE, 0, n);
 	ind->table = table;
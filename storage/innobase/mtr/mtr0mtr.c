@@ -68,6 +68,9 @@ mtr_memo_slot_release_func(
 	case MTR_MEMO_X_LOCK:
 		rw_lock_x_unlock((rw_lock_t*) object);
 		break;
+	case MTR_MEMO_SX_LOCK:
+		rw_lock_sx_unlock((rw_lock_t*) object);
+		break;
 #ifdef UNIV_DEBUG
 	default:
 		ut_ad(slot->type == MTR_MEMO_MODIFY);
@@ -247,6 +250,32 @@ func_exit:
 
 	log_flush_order_mutex_exit();
 }
+
+/************************************************************//**
+Adds the pages that a mini-transaction modified without redo logging
+to the flush list. The pages are stamped with the current lsn, so that
+crash recovery will not apply older log records to their new contents.
+The caller must get the pages written to the data files before they
+are made reachable by a logged modification. */
+static
+void
+mtr_note_unlogged_modifications(
+/*============================*/
+	mtr_t*	mtr)	/*!< in: mtr */
+{
+	ut_ad(mtr->log_mode == MTR_LOG_NONE);
+
+	mutex_enter(&(log_sys->mutex));
+
+	mtr->start_lsn = mtr->end_lsn = log_sys->lsn;
+
+	log_flush_order_mutex_enter();
+	log_release();
+
+	mtr_memo_note_modifications(mtr);
+
+	log_flush_order_mutex_exit();
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /***************************************************************//**
@@ -269,6 +298,8 @@ mtr_commit(
 
 	if (mtr->modifications && mtr->n_log_recs) {
 		mtr_log_reserve_and_write(mtr);
+	} else if (mtr->modifications && mtr->log_mode == MTR_LOG_NONE) {
+		mtr_note_unlogged_modifications(mtr);
 	}
 
 	mtr_memo_pop_all(mtr);
@@ -328,6 +359,83 @@ mtr_memo_release(
 		}
 	}
 }
+
+/**********************************************************//**
+Tries to latch a page that was buffer-fixed without a latch at a
+savepoint, without waiting. On success, the memo slot is converted to
+hold the page latch.
+@return	TRUE if the page was latched */
+UNIV_INTERN
+ibool
+mtr_block_latch_nowait_at_savepoint(
+/*================================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		savepoint,	/*!< in: savepoint of the
+					MTR_MEMO_BUF_FIX slot */
+	buf_block_t*	block,		/*!< in: buffer-fixed block */
+	ulint		rw_latch,	/*!< in: RW_S_LATCH or RW_X_LATCH */
+	const char*	file,		/*!< in: file name */
+	ulint		line)		/*!< in: line where called */
+{
+	mtr_memo_slot_t*	slot;
+	ibool			success;
+
+	ut_ad(mtr->magic_n == MTR_MAGIC_N);
+	ut_ad(mtr->state == MTR_ACTIVE);
+	ut_ad(dyn_array_get_data_size(&mtr->memo) > savepoint);
+
+	slot = (mtr_memo_slot_t*) dyn_array_get_element(&mtr->memo,
+							savepoint);
+
+	ut_ad(slot->object == block);
+	ut_ad(slot->type == MTR_MEMO_BUF_FIX);
+
+	if (rw_latch == RW_S_LATCH) {
+		success = rw_lock_s_lock_nowait(&block->lock, file, line);
+	} else {
+		ut_ad(rw_latch == RW_X_LATCH);
+		success = rw_lock_x_lock_func_nowait_inline(&block->lock,
+							    file, line);
+	}
+
+	if (success) {
+		/* MTR_MEMO_PAGE_S_FIX and MTR_MEMO_PAGE_X_FIX are
+		equal to the latch modes */
+		slot->type = rw_latch;
+	}
+
+	return(success);
+}
+
+/**********************************************************//**
+Releases the latch and the buffer-fix of a page stored in an mtr memo
+at a savepoint. The page must not have been modified by the mtr. */
+UNIV_INTERN
+void
+mtr_release_block_at_savepoint(
+/*===========================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		savepoint,	/*!< in: savepoint */
+	buf_block_t*	block __attribute__((unused)))
+					/*!< in: block to release */
+{
+	mtr_memo_slot_t*	slot;
+
+	ut_ad(mtr->magic_n == MTR_MAGIC_N);
+	ut_ad(mtr->state == MTR_ACTIVE);
+	ut_ad(dyn_array_get_data_size(&mtr->memo) > savepoint);
+
+	slot = (mtr_memo_slot_t*) dyn_array_get_element(&mtr->memo,
+							savepoint);
+
+	ut_ad(slot->object == block);
+	ut_ad(slot->type == MTR_MEMO_PAGE_S_FIX
+	      || slot->type == MTR_MEMO_PAGE_X_FIX
+	      || slot->type == MTR_MEMO_BUF_FIX);
+	ut_ad(!mtr->modifications || slot->type != MTR_MEMO_PAGE_X_FIX);
+
+	mtr_memo_slot_release(mtr, slot);
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /********************************************************//**
@@ -59,6 +59,12 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#if defined(LINUX_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 /* This specifies the file permissions InnoDB uses when it creates files in
 Unix; the value of os_innodb_umask is initialized in ha_innodb.cc to
 my_umask */
@@ -194,6 +200,43 @@ struct os_aio_slot_struct{
 #endif
 };
 
+#if defined(LINUX_IO_URING)
+/** An io_uring instance */
+typedef struct os_aio_uring_struct	os_aio_uring_t;
+
+/** An io_uring instance mapped into the address space of the server.
+Any thread may submit requests while holding sq_mutex. Only the i/o
+handler thread of the segment reaps the completions, so the completion
+queue is read without any mutex. */
+struct os_aio_uring_struct{
+	int			fd;	/*!< file descriptor of the ring,
+					or -1 */
+	os_mutex_t		sq_mutex;/*!< protects the submission
+					queue */
+	unsigned*		sq_head;/*!< head of the submission queue,
+					advanced by the kernel */
+	unsigned*		sq_tail;/*!< tail of the submission queue */
+	unsigned*		sq_mask;/*!< mask of submission queue
+					indexes */
+	unsigned*		sq_array;/*!< submission queue, pointing
+					to sqes[] */
+	struct io_uring_sqe*	sqes;	/*!< submission queue entries */
+	unsigned*		cq_head;/*!< head of the completion queue */
+	unsigned*		cq_tail;/*!< tail of the completion queue,
+					advanced by the kernel */
+	unsigned*		cq_mask;/*!< mask of completion queue
+					indexes */
+	struct io_uring_cqe*	cqes;	/*!< completion queue entries */
+	void*			sq_ptr;	/*!< mapping of the submission
+					queue ring */
+	size_t			sq_size;/*!< size of sq_ptr */
+	void*			cq_ptr;	/*!< mapping of the completion
+					queue ring; may equal sq_ptr */
+	size_t			cq_size;/*!< size of cq_ptr */
+	size_t			sqes_size;/*!< size of sqes */
+};
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 typedef struct os_aio_array_struct	os_aio_array_t;
 
@@ -245,6 +288,14 @@ struct os_aio_array_struct{
 				possible pending IO. The size of the
 				array is equal to n_slots. */
 #endif
+
+#if defined(LINUX_IO_URING)
+	os_aio_uring_t*		urings;
+				/* io_uring instances, one per segment,
+				or NULL if io_uring is not used. The
+				i/o handler thread of each segment reaps
+				the completions of its own ring. */
+#endif
 };
 
 #if defined(LINUX_NATIVE_AIO)
@@ -258,6 +309,15 @@ struct os_aio_array_struct{
 #define OS_AIO_IO_SETUP_RETRY_ATTEMPTS	5
 #endif
 
+#if defined(LINUX_IO_URING)
+/** timeout for each wait for io_uring completions = 500ms. */
+#define OS_AIO_URING_REAP_TIMEOUT	(500000000UL)
+
+/** time to sleep, in microseconds, if io_uring_enter() is short of
+resources */
+#define OS_AIO_URING_SUBMIT_RETRY_SLEEP	(1000UL)
+#endif
+
 /** Array of events used in simulated aio */
 static os_event_t*	os_aio_segment_wait_events	= NULL;
 
@@ -3358,6 +3418,345 @@ os_aio_native_aio_supported(void)
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/******************************************************************//**
+Closes an io_uring instance that has been fully or partially created. */
+static
+void
+os_aio_uring_close(
+/*===============*/
+	os_aio_uring_t*	ring)	/*!< in/out: ring to close */
+{
+	if (ring->sqes != NULL) {
+		munmap(ring->sqes, ring->sqes_size);
+	}
+
+	if (ring->cq_ptr != NULL && ring->cq_ptr != ring->sq_ptr) {
+		munmap(ring->cq_ptr, ring->cq_size);
+	}
+
+	if (ring->sq_ptr != NULL) {
+		munmap(ring->sq_ptr, ring->sq_size);
+	}
+
+	if (ring->fd >= 0) {
+		close(ring->fd);
+	}
+
+	if (ring->sq_mutex != NULL) {
+		os_mutex_free(ring->sq_mutex);
+	}
+
+	memset(ring, 0x0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+/******************************************************************//**
+Creates an io_uring instance. The completions are waited for with a
+timeout, which needs IORING_FEAT_EXT_ARG (Linux 5.11).
+@return	TRUE on success. */
+static
+ibool
+os_aio_uring_create(
+/*================*/
+	ulint		max_events,	/*!< in: number of pending requests */
+	os_aio_uring_t*	ring)		/*!< out: ring to initialize */
+{
+	struct io_uring_params	params;
+	void*			ptr;
+	byte*			sq;
+	byte*			cq;
+
+	memset(ring, 0x0, sizeof(*ring));
+	memset(&params, 0x0, sizeof(params));
+
+	ring->fd = (int) syscall(__NR_io_uring_setup, (unsigned) max_events,
+				 &params);
+
+	if (ring->fd < 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Error: io_uring_setup() failed"
+			" with error %d\n", errno);
+		return(FALSE);
+	}
+
+	if (!(params.features & IORING_FEAT_EXT_ARG)) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Error: io_uring does not support"
+			" timed waits on this kernel\n");
+		goto err_exit;
+	}
+
+	ring->sq_size = params.sq_off.array
+		+ params.sq_entries * sizeof(unsigned);
+	ring->cq_size = params.cq_off.cqes
+		+ params.cq_entries * sizeof(struct io_uring_cqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->sq_size = ring->cq_size
+			= ut_max(ring->sq_size, ring->cq_size);
+	}
+
+	ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+
+	if (ptr == MAP_FAILED) {
+		goto err_mmap;
+	}
+
+	ring->sq_ptr = ptr;
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ptr = ptr;
+	} else {
+		ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE,
+			   MAP_SHARED | MAP_POPULATE, ring->fd,
+			   IORING_OFF_CQ_RING);
+
+		if (ptr == MAP_FAILED) {
+			goto err_mmap;
+		}
+
+		ring->cq_ptr = ptr;
+	}
+
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+	if (ptr == MAP_FAILED) {
+		goto err_mmap;
+	}
+
+	ring->sqes = ptr;
+
+	sq = ring->sq_ptr;
+	cq = ring->cq_ptr;
+
+	ring->sq_head = (unsigned*) (sq + params.sq_off.head);
+	ring->sq_tail = (unsigned*) (sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned*) (sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned*) (sq + params.sq_off.array);
+	ring->cq_head = (unsigned*) (cq + params.cq_off.head);
+	ring->cq_tail = (unsigned*) (cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned*) (cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+
+	ring->sq_mutex = os_mutex_create();
+
+	return(TRUE);
+
+err_mmap:
+	ut_print_timestamp(stderr);
+	fprintf(stderr,
+		"  InnoDB: Error: mapping an io_uring failed"
+		" with error %d\n", errno);
+err_exit:
+	os_aio_uring_close(ring);
+
+	return(FALSE);
+}
+
+/******************************************************************//**
+Submits a read or write to an io_uring.
+@return	0 on success, or an errno value */
+static
+int
+os_aio_uring_submit(
+/*================*/
+	os_aio_uring_t*	ring,	/*!< in/out: ring */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	os_file_t	file,	/*!< in: file handle */
+	void*		buf,	/*!< in: buffer */
+	ulint		len,	/*!< in: number of bytes */
+	ib_uint64_t	offset,	/*!< in: file offset */
+	void*		data)	/*!< in: returned with the completion */
+{
+	struct io_uring_sqe*	sqe;
+	unsigned		tail;
+	unsigned		index;
+	int			ret;
+	int			err = 0;
+
+	os_mutex_enter(ring->sq_mutex);
+
+	tail = *ring->sq_tail;
+	index = tail & *ring->sq_mask;
+	sqe = &ring->sqes[index];
+
+	memset(sqe, 0x0, sizeof(*sqe));
+	sqe->opcode = (type == OS_FILE_READ)
+		? IORING_OP_READ : IORING_OP_WRITE;
+	sqe->fd = file;
+	sqe->addr = (ib_uint64_t) (ulint) buf;
+	sqe->len = (unsigned) len;
+	sqe->off = offset;
+	sqe->user_data = (ib_uint64_t) (ulint) data;
+
+	ring->sq_array[index] = index;
+
+	/* Publish the entry before the tail that makes it visible. */
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	for (;;) {
+		ret = (int) syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0,
+				    NULL, 0);
+
+		if (ret == 1) {
+			break;
+		}
+
+		if (ret < 0 && (errno == EAGAIN || errno == EBUSY)) {
+			/* Short of kernel resources or of room for
+			completions: the i/o handler threads will make
+			room. */
+			os_thread_sleep(OS_AIO_URING_SUBMIT_RETRY_SLEEP);
+		} else if (ret < 0 && errno != EINTR) {
+			err = errno;
+			break;
+		}
+	}
+
+	if (err != 0
+	    && __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == tail) {
+		/* The kernel did not consume the entry. Withdraw it. */
+		*ring->sq_tail = tail;
+	} else {
+		err = 0;
+	}
+
+	os_mutex_exit(ring->sq_mutex);
+
+	return(err);
+}
+
+/******************************************************************//**
+Reaps a completion from an io_uring. Only the i/o handler thread that
+owns the ring may call this. Waits for at most OS_AIO_URING_REAP_TIMEOUT.
+@return	TRUE if a completion was reaped, FALSE on timeout */
+static
+ibool
+os_aio_uring_reap(
+/*==============*/
+	os_aio_uring_t*	ring,	/*!< in/out: ring */
+	void**		data,	/*!< out: data passed to the submit */
+	int*		res)	/*!< out: bytes transferred, or -errno */
+{
+	struct io_uring_cqe*		cqe;
+	struct io_uring_getevents_arg	arg;
+	struct __kernel_timespec	timeout;
+	unsigned			head;
+	int				ret;
+
+	/* Only this thread advances the head. */
+	head = *ring->cq_head;
+
+	if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+
+		memset(&arg, 0x0, sizeof(arg));
+		timeout.tv_sec = 0;
+		timeout.tv_nsec = OS_AIO_URING_REAP_TIMEOUT;
+		arg.ts = (ib_uint64_t) (ulint) &timeout;
+
+		ret = (int) syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+				    IORING_ENTER_GETEVENTS
+				    | IORING_ENTER_EXT_ARG,
+				    &arg, sizeof(arg));
+
+		if (ret < 0 && errno != ETIME && errno != EINTR
+		    && errno != EAGAIN) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: unexpected error %d from"
+				" io_uring_enter()!\n", errno);
+			ut_error;
+		}
+
+		if (head == __atomic_load_n(ring->cq_tail,
+					    __ATOMIC_ACQUIRE)) {
+			return(FALSE);
+		}
+	}
+
+	cqe = &ring->cqes[head & *ring->cq_mask];
+
+	*data = (void*) (ulint) cqe->user_data;
+	*res = cqe->res;
+
+	/* Release the entry to the kernel after reading it. */
+	__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+	return(TRUE);
+}
+
+/******************************************************************//**
+Checks if io_uring can be used for reads and writes of files in tmpdir.
+@return	TRUE if supported, FALSE otherwise. */
+static
+ibool
+os_aio_uring_supported(void)
+/*========================*/
+{
+	os_aio_uring_t	ring;
+	int		fd;
+	byte*		buf;
+	byte*		ptr;
+	void*		data;
+	int		res	= -EIO;
+	int		err;
+	ulint		i;
+
+	if (!os_aio_uring_create(1, &ring)) {
+		return(FALSE);
+	}
+
+	fd = innobase_mysql_tmpfile();
+
+	if (fd < 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, " InnoDB: Error: unable to create "
+			"temp file to check io_uring support.\n");
+		os_aio_uring_close(&ring);
+
+		return(FALSE);
+	}
+
+	buf = (byte*) ut_malloc(UNIV_PAGE_SIZE * 2);
+	ptr = (byte*) ut_align(buf, UNIV_PAGE_SIZE);
+
+	memset(buf, 0x00, UNIV_PAGE_SIZE * 2);
+
+	err = os_aio_uring_submit(&ring, OS_FILE_WRITE, fd, ptr,
+				  UNIV_PAGE_SIZE, 0, ptr);
+
+	/* Wait for at most 10 timeouts. */
+	for (i = 0; err == 0 && i < 10; i++) {
+		if (os_aio_uring_reap(&ring, &data, &res)) {
+			ut_a(data == ptr);
+			break;
+		}
+	}
+
+	ut_free(buf);
+	close(fd);
+	os_aio_uring_close(&ring);
+
+	if (err == 0 && res == (int) UNIV_PAGE_SIZE) {
+		return(TRUE);
+	}
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr,
+		" InnoDB: Error: io_uring write to tmpdir"
+		" returned error[%d]\n", err ? err : -res);
+
+	return(FALSE);
+}
+#endif /* LINUX_IO_URING */
+
 /******************************************************************//**
 Creates an aio wait array. Note that we return NULL in case of failure.
 We don't care about freeing memory here because we assume that a
@@ -3400,6 +3799,27 @@ os_aio_array_create(
 	array->handles		= ut_malloc(n * sizeof(HANDLE));
 #endif
 
+#if defined(LINUX_IO_URING)
+	array->urings = NULL;
+
+	if (srv_use_io_uring) {
+		/* One ring per segment, reaped by the i/o handler
+		thread of the segment. */
+		array->urings = ut_malloc(n_segments
+					  * sizeof(*array->urings));
+
+		for (i = 0; i < n_segments; ++i) {
+			if (!os_aio_uring_create(n / n_segments,
+						 &array->urings[i])) {
+				/* As with native aio, a failure to
+				initialize the io subsystem means that
+				InnoDB will not start up. */
+				return(NULL);
+			}
+		}
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	array->aio_ctx = NULL;
 	array->aio_events = NULL;
@@ -3491,6 +3911,18 @@ os_aio_array_free(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+	if (array->urings != NULL) {
+		ulint	i;
+
+		for (i = 0; i < array->n_segments; i++) {
+			os_aio_uring_close(&array->urings[i]);
+		}
+
+		ut_free(array->urings);
+	}
+#endif /* LINUX_IO_URING */
+
 	ut_free(array->slots);
 	ut_free(array);
 }
@@ -3520,6 +3952,25 @@ os_aio_init(
 
 	os_io_init_simple();
 
+#if defined(LINUX_IO_URING)
+	/* Check if io_uring is supported on this system and tmpfs.
+	If it is, it replaces native aio. */
+	if (srv_use_io_uring) {
+		if (os_aio_uring_supported()) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				" InnoDB: Using io_uring for asynchronous"
+				" i/o\n");
+			srv_use_native_aio = FALSE;
+		} else {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				" InnoDB: Warning: io_uring disabled.\n");
+			srv_use_io_uring = FALSE;
+		}
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	/* Check if native aio is supported on this system and tmpfs */
 	if (srv_use_native_aio
@@ -3666,14 +4117,14 @@ os_aio_wake_all_threads_at_shutdown(void)
 	os_aio_array_wake_win_aio_at_shutdown(os_aio_ibuf_array);
 	os_aio_array_wake_win_aio_at_shutdown(os_aio_log_array);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
-	/* When using native AIO interface the io helper threads
-	wait on io_getevents with a timeout value of 500ms. At
+	/* When using native AIO or io_uring the io helper threads
+	wait for completions with a timeout value of 500ms. At
 	each wake up these threads check the server status.
 	No need to do anything to wake them up. */
 
-	if (srv_use_native_aio) {
+	if (srv_use_native_aio || srv_use_io_uring) {
 		return;
 	}
 	/* Fall through to simulated AIO handler wakeup if we are
@@ -4030,7 +4481,7 @@ os_aio_simulated_wake_handler_threads(void)
 {
 	ulint	i;
 
-	if (srv_use_native_aio) {
+	if (srv_use_native_aio || srv_use_io_uring) {
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -4062,7 +4513,7 @@ readahead requests. */
 	os_aio_array_t*	array;
 	ulint		g;
 
-	if (srv_use_native_aio) {
+	if (srv_use_native_aio || srv_use_io_uring) {
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -4128,6 +4579,44 @@ os_aio_linux_dispatch(
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/*******************************************************************//**
+Submits an aio request to the io_uring of the segment of the slot.
+@return	TRUE on success. */
+static
+ibool
+os_aio_uring_dispatch(
+/*==================*/
+	os_aio_array_t*	array,	/*!< in: io request array. */
+	os_aio_slot_t*	slot)	/*!< in: an already reserved slot. */
+{
+	ulint		ring_index;
+	ib_uint64_t	offset;
+	int		err;
+
+	ut_ad(slot != NULL);
+	ut_ad(array);
+
+	ut_a(slot->reserved);
+
+	/* The ring is one per segment, like the native aio contexts. */
+	ring_index = (slot->pos * array->n_segments) / array->n_slots;
+
+	offset = ((ib_uint64_t) slot->offset_high << 32) | slot->offset;
+
+	err = os_aio_uring_submit(&array->urings[ring_index], slot->type,
+				  slot->file, slot->buf, slot->len, offset,
+				  slot);
+
+	if (UNIV_UNLIKELY(err != 0)) {
+		errno = err;
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+#endif /* LINUX_IO_URING */
+
 
 /*******************************************************************//**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
@@ -4259,6 +4748,24 @@ try_again:
 
 	slot = os_aio_array_reserve_slot(type, array, message1, message2, file,
 					 name, buf, offset, offset_high, n);
+#if defined(LINUX_IO_URING)
+	if (srv_use_io_uring) {
+		if (type == OS_FILE_READ) {
+			os_n_file_reads++;
+			os_bytes_read_since_printout += n;
+		} else {
+			ut_a(type == OS_FILE_WRITE);
+			os_n_file_writes++;
+		}
+
+		if (!os_aio_uring_dispatch(array, slot)) {
+			goto err_exit;
+		}
+
+		return(TRUE);
+	}
+#endif /* LINUX_IO_URING */
+
 	if (type == OS_FILE_READ) {
 		if (srv_use_native_aio) {
 			os_n_file_reads++;
@@ -4332,9 +4839,9 @@ try_again:
 	/* aio was queued successfully! */
 	return(TRUE);
 
-#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
+#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO || defined LINUX_IO_URING
 err_exit:
-#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO || LINUX_IO_URING */
 	os_aio_array_free_slot(array, slot);
 
 	retry = os_file_handle_error(name,
@@ -4779,6 +5286,114 @@ found:
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/**********************************************************************//**
+This function is only used with io_uring. Waits for an aio operation of
+a segment to complete. Each segment has its own ring, and only the i/o
+handler thread of the segment reaps its completions, so the completed
+request is found without scanning the slots of the segment under the
+array mutex. NOTE: this function will also take care of freeing the aio
+slot, therefore no other thread is allowed to do the freeing!
+@return	TRUE if the IO was successful */
+UNIV_INTERN
+ibool
+os_aio_uring_handle(
+/*================*/
+	ulint	global_seg,	/*!< in: segment number in the aio array
+				to wait for; segment 0 is the ibuf
+				i/o thread, segment 1 is log i/o thread,
+				then follow the non-ibuf read threads,
+				and the last are the non-ibuf write
+				threads. */
+	fil_node_t**message1,	/*!< out: the messages passed with the */
+	void**	message2,	/*!< aio request; note that in case the
+				aio operation failed, these output
+				parameters are valid and can be used to
+				restart the operation. */
+	ulint*	type)		/*!< out: OS_FILE_WRITE or ..._READ */
+{
+	ulint		segment;
+	os_aio_array_t*	array;
+	os_aio_slot_t*	slot;
+	void*		data;
+	int		res;
+	ulint		n;
+	ulint		i;
+	ibool		ret;
+
+	/* Should never be doing Sync IO here. */
+	ut_a(global_seg != ULINT_UNDEFINED);
+
+	/* Find the array and the local segment. */
+	segment = os_aio_get_array_and_local_segment(&array, global_seg);
+	n = array->n_slots / array->n_segments;
+
+	srv_set_io_thread_op_info(global_seg,
+				  "waiting for completed aio requests");
+
+	while (!os_aio_uring_reap(&array->urings[segment], &data, &res)) {
+		ibool	any_reserved = FALSE;
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+			continue;
+		}
+
+		/* If there is no pending request at all, and the
+		system is being shut down, exit. */
+		os_mutex_enter(array->mutex);
+
+		for (i = 0; i < n; ++i) {
+			slot = os_aio_array_get_nth_slot(
+				array, i + segment * n);
+
+			if (slot->reserved) {
+				any_reserved = TRUE;
+				break;
+			}
+		}
+
+		os_mutex_exit(array->mutex);
+
+		if (!any_reserved) {
+			*message1 = NULL;
+			*message2 = NULL;
+			return(TRUE);
+		}
+	}
+
+	srv_set_io_thread_op_info(global_seg,
+				  "processing completed aio requests");
+
+	slot = data;
+
+	/* Ensure that the request belongs to our segment. */
+	ut_a(slot != NULL);
+	ut_a(slot->reserved);
+	ut_a(slot->pos / n == segment);
+
+	*message1 = slot->message1;
+	*message2 = slot->message2;
+
+	*type = slot->type;
+
+	if (res >= 0 && (ulint) res == slot->len) {
+		ret = TRUE;
+	} else {
+		/* A short read or write is reported like an i/o error,
+		as with Linux native aio. */
+		errno = res < 0 ? -res : EIO;
+
+		os_file_handle_error(slot->name, "io_uring");
+
+		ret = FALSE;
+	}
+
+	os_aio_array_free_slot(array, slot);
+
+	return(ret);
+}
+#endif /* LINUX_IO_URING */
+
 /**********************************************************************//**
 Does simulated aio. This function should be called by an i/o-handler
 thread.
@@ -239,6 +239,105 @@ page_cur_rec_field_extends(
 }
 #endif /* PAGE_CUR_LE_OR_EXTENDS */
 
+/** Maximum length of the normalized key of a search tuple, in bytes */
+#define PAGE_CUR_NORM_KEY_MAX	128
+
+/****************************************************************//**
+Copies the leading fields of a search tuple that are in
+index->n_norm_prefix into a normalized key, which can be compared to the
+beginning of a record like memcmp().
+@return	number of fields in the normalized key, 0 if none */
+static
+ulint
+page_cur_norm_key_build(
+/*====================*/
+	const dict_index_t*	index,	/*!< in: record descriptor */
+	const dtuple_t*		tuple,	/*!< in: data tuple */
+	byte*			key)	/*!< out: normalized key of
+					PAGE_CUR_NORM_KEY_MAX bytes */
+{
+	ulint	n	= ut_min(index->n_norm_prefix,
+				 dtuple_get_n_fields_cmp(tuple));
+	ulint	start	= 0;
+	ulint	i;
+
+	if (dtuple_get_info_bits(tuple) & REC_INFO_MIN_REC_FLAG) {
+		return(0);
+	}
+
+	for (i = 0; i < n; i++) {
+		const dfield_t*	field	= dtuple_get_nth_field(tuple, i);
+		ulint		end	= index->fixed_offs[i];
+
+		if (end > PAGE_CUR_NORM_KEY_MAX
+		    || dfield_get_len(field) != end - start) {
+			/* SQL NULL or a shorter search key */
+			break;
+		}
+
+		memcpy(key + start, dfield_get_data(field), end - start);
+		start = end;
+	}
+
+	return(i);
+}
+
+/****************************************************************//**
+Compares a normalized key built by page_cur_norm_key_build() to the
+same fields of a record, like cmp_dtuple_rec_with_match() does.
+@return	1, 0, -1, if the key is greater, equal, less than the fields of
+rec; when 0, *matched_fields is n_norm */
+UNIV_INLINE
+int
+page_cur_norm_key_cmp(
+/*==================*/
+	const dict_index_t*	index,	/*!< in: record descriptor */
+	const byte*		key,	/*!< in: normalized key */
+	ulint			n_norm,	/*!< in: number of fields in key */
+	const rec_t*		rec,	/*!< in: physical record */
+	ulint*			matched_fields,
+					/*!< in/out: number of already
+					completely matched fields, less
+					than n_norm */
+	ulint*			matched_bytes)
+					/*!< in/out: number of already
+					matched bytes in the first field
+					not completely matched */
+{
+	ulint	field	= *matched_fields;
+	ulint	start	= field ? index->fixed_offs[field - 1] : 0;
+	ulint	pos	= start + *matched_bytes;
+	ulint	end	= index->fixed_offs[n_norm - 1];
+
+	ut_ad(field < n_norm);
+
+	if (UNIV_UNLIKELY(pos == 0)
+	    && (rec_get_info_bits(rec, TRUE) & REC_INFO_MIN_REC_FLAG)) {
+		/* The predefined minimum record is smaller than any
+		search tuple that page_cur_norm_key_build() accepts. */
+		return(1);
+	}
+
+	while (pos < end && key[pos] == rec[pos]) {
+		pos++;
+	}
+
+	while (index->fixed_offs[field] <= pos && ++field < n_norm) {
+		start = index->fixed_offs[field - 1];
+	}
+
+	if (pos == end) {
+		*matched_fields = n_norm;
+		*matched_bytes = 0;
+		return(0);
+	}
+
+	*matched_fields = field;
+	*matched_bytes = pos - start;
+
+	return(key[pos] > rec[pos] ? 1 : -1);
+}
+
 /****************************************************************//**
 Searches the right position for a page cursor. */
 UNIV_INTERN
@@ -293,7 +392,11 @@ page_cur_search_with_match(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rec_offs_cache_t offs_cache;
+	byte		norm_key[PAGE_CUR_NORM_KEY_MAX];
+	ulint		n_norm;
 	rec_offs_init(offsets_);
+	rec_offs_cache_init(&offs_cache, offsets_);
 
 	ut_ad(block && tuple && iup_matched_fields && iup_matched_bytes
 	      && ilow_matched_fields && ilow_matched_bytes && cursor);
@@ -354,6 +457,11 @@ page_cur_search_with_match(
 	low_matched_fields = *ilow_matched_fields;
 	low_matched_bytes  = *ilow_matched_bytes;
 
+	/* The leading integer and binary fields of the tuple are compared
+	to the records as one byte string, and the rest of the fields only
+	if the records are equal in those. */
+	n_norm = page_cur_norm_key_build(index, tuple, norm_key);
+
 	/* Perform binary search. First the search is done through the page
 	directory, after that as a linear search in the list of records
 	owned by the upper limit directory slot. */
@@ -373,13 +481,19 @@ page_cur_search_with_match(
 			    low_matched_fields, low_matched_bytes,
 			    up_matched_fields, up_matched_bytes);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
-
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields,
-						&cur_matched_bytes);
+		if (cur_matched_fields >= n_norm
+		    || (!(cmp = page_cur_norm_key_cmp(
+				  index, norm_key, n_norm, mid_rec,
+				  &cur_matched_fields, &cur_matched_bytes))
+			&& n_norm < dtuple_get_n_fields_cmp(tuple))) {
+			offsets = rec_get_offsets_cached(
+				mid_rec, index, &offs_cache,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets,
+				&cur_matched_fields, &cur_matched_bytes);
+		}
 		if (UNIV_LIKELY(cmp > 0)) {
 low_slot_match:
 			low = mid;
@@ -430,13 +544,19 @@ up_slot_match:
 			    low_matched_fields, low_matched_bytes,
 			    up_matched_fields, up_matched_bytes);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
-
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields,
-						&cur_matched_bytes);
+		if (cur_matched_fields >= n_norm
+		    || (!(cmp = page_cur_norm_key_cmp(
+				  index, norm_key, n_norm, mid_rec,
+				  &cur_matched_fields, &cur_matched_bytes))
+			&& n_norm < dtuple_get_n_fields_cmp(tuple))) {
+			offsets = rec_get_offsets_cached(
+				mid_rec, index, &offs_cache,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets,
+				&cur_matched_fields, &cur_matched_bytes);
+		}
 		if (UNIV_LIKELY(cmp > 0)) {
 low_rec_match:
 			low_rec = mid_rec;
@@ -36,6 +36,7 @@ Created June 2005 by Marko Makela
 #include "btr0cur.h"
 #include "page0types.h"
 #include "log0recv.h"
+#include "ut0lz.h"
 #include "zlib.h"
 #ifndef UNIV_HOTBACKUP
 # include "buf0lru.h"
@@ -48,10 +49,21 @@ Created June 2005 by Marko Makela
 #endif /* !UNIV_HOTBACKUP */
 
 #ifndef UNIV_HOTBACKUP
-/** Statistics on compression, indexed by page_zip_des_t::ssize - 1 */
-UNIV_INTERN page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE - 1];
+/** Statistics on compression, indexed by page_zip_des_t::ssize - 1
+and by the codec */
+UNIV_INTERN page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE - 1]
+					 [PAGE_ZIP_N_CODECS];
 #endif /* !UNIV_HOTBACKUP */
 
+/** Names of the page compression codecs, indexed by PAGE_ZIP_CODEC_ZLIB,
+..., and terminated by NULL */
+UNIV_INTERN const char* page_zip_codec_names[PAGE_ZIP_N_CODECS + 1] = {
+	"zlib",
+	"lz",
+	"none",
+	NULL
+};
+
 /* Please refer to ../include/page0zip.ic for a description of the
 compressed page format. */
 
@@ -731,6 +743,297 @@ page_zip_set_alloc(
 	strm->opaque = heap;
 }
 
+/** Marker in the low nibble of the first byte of a compressed page
+stream that was not written by zlib.  In a zlib stream, the low nibble
+is the compression method Z_DEFLATED (8); RFC 1950 reserves 15.  The
+high nibble of the byte is the codec. */
+#define PAGE_ZIP_CODEC_MAGIC	15
+/** Size of the header of a compressed page stream that was not written
+by zlib: the marker byte, the size of the compressed data and the size
+of the index information at the start of the uncompressed data */
+#define PAGE_ZIP_CODEC_HDR	5
+
+/** A compressed page stream of a codec other than zlib.  The z_stream
+of such a stream has state == Z_NULL and opaque pointing to this.
+The codecs compress and decompress the whole stream in one go, so that
+deflate() and inflate() are emulated on an uncompressed copy of the
+stream: page_zip_deflate() collects the data until Z_FINISH, and
+page_zip_inflate_init() decompresses all of it, to be handed out piece
+by piece by page_zip_inflate(). */
+typedef struct page_zip_codec_stream_struct {
+	ulint	codec;		/*!< PAGE_ZIP_CODEC_LZ or
+				PAGE_ZIP_CODEC_NONE */
+	byte*	buf;		/*!< uncompressed stream */
+	ulint	size;		/*!< size of buf in bytes */
+	ulint	len;		/*!< length of the uncompressed stream */
+	ulint	pos;		/*!< bytes of buf returned by inflate */
+	ulint	fields_len;	/*!< length of the index information
+				at the start of buf, or ULINT_UNDEFINED */
+} page_zip_codec_stream_t;
+
+/**********************************************************************//**
+Initialize a compressed page stream for page_zip_deflate(). */
+static
+void
+page_zip_deflate_init(
+/*==================*/
+	z_stream*	strm,	/*!< out: compressed stream; its allocator
+				must have been set by page_zip_set_alloc() */
+	ulint		codec,	/*!< in: PAGE_ZIP_CODEC_ZLIB, ... */
+	ulint		level)	/*!< in: zlib compression level,
+				or 0 for the default */
+{
+	page_zip_codec_stream_t*	cs;
+
+	if (codec == PAGE_ZIP_CODEC_ZLIB) {
+		int	err = deflateInit2(strm, level
+					   ? (int) level
+					   : Z_DEFAULT_COMPRESSION,
+					   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
+					   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+		ut_a(err == Z_OK);
+		return;
+	}
+
+	ut_ad(codec < PAGE_ZIP_N_CODECS);
+
+	cs = mem_heap_alloc(strm->opaque, sizeof *cs);
+	cs->codec = codec;
+	/* The index information and the records of one page */
+	cs->size = 2 * UNIV_PAGE_SIZE;
+	cs->buf = mem_heap_alloc(strm->opaque, cs->size);
+	cs->len = 0;
+	cs->pos = 0;
+	cs->fields_len = ULINT_UNDEFINED;
+
+	strm->state = Z_NULL;
+	strm->opaque = cs;
+	strm->msg = Z_NULL;
+	strm->total_in = 0;
+	strm->total_out = 0;
+}
+
+/**********************************************************************//**
+Compress data for a compressed page stream, like deflate().  The flush
+methods used by page_zip_compress() are supported: Z_NO_FLUSH, one
+Z_FULL_FLUSH after the index information, and Z_FINISH.
+@return	Z_OK, Z_STREAM_END on Z_FINISH, or Z_BUF_ERROR if the
+compressed data did not fit */
+static
+int
+page_zip_deflate(
+/*=============*/
+	z_streamp	strm,	/*!< in/out: compressed stream */
+	int		flush)	/*!< in: deflate() flushing method */
+{
+	page_zip_codec_stream_t*	cs;
+	ulint				len;
+
+	if (strm->state != Z_NULL) {
+		return(deflate(strm, flush));
+	}
+
+	cs = strm->opaque;
+
+	ut_a(cs->len + strm->avail_in <= cs->size);
+	memcpy(cs->buf + cs->len, strm->next_in, strm->avail_in);
+	cs->len += strm->avail_in;
+	strm->next_in += strm->avail_in;
+	strm->total_in += strm->avail_in;
+	strm->avail_in = 0;
+
+	switch (flush) {
+	case Z_NO_FLUSH:
+		return(Z_OK);
+	case Z_FULL_FLUSH:
+		ut_ad(cs->fields_len == ULINT_UNDEFINED);
+		cs->fields_len = cs->len;
+		return(Z_OK);
+	}
+
+	ut_ad(flush == Z_FINISH);
+	ut_ad(cs->fields_len != ULINT_UNDEFINED);
+
+	if (strm->avail_out <= PAGE_ZIP_CODEC_HDR) {
+		return(Z_BUF_ERROR);
+	}
+
+	if (cs->codec == PAGE_ZIP_CODEC_LZ) {
+		len = ut_lz_compress(cs->buf, cs->len,
+				     strm->next_out + PAGE_ZIP_CODEC_HDR,
+				     strm->avail_out - PAGE_ZIP_CODEC_HDR);
+		if (!len) {
+			return(Z_BUF_ERROR);
+		}
+	} else {
+		ut_ad(cs->codec == PAGE_ZIP_CODEC_NONE);
+		len = cs->len;
+
+		if (len > strm->avail_out - PAGE_ZIP_CODEC_HDR) {
+			return(Z_BUF_ERROR);
+		}
+
+		memcpy(strm->next_out + PAGE_ZIP_CODEC_HDR, cs->buf, len);
+	}
+
+	strm->next_out[0] = (byte) (cs->codec << 4 | PAGE_ZIP_CODEC_MAGIC);
+	mach_write_to_2(strm->next_out + 1, len);
+	mach_write_to_2(strm->next_out + 3, cs->fields_len);
+
+	len += PAGE_ZIP_CODEC_HDR;
+	strm->next_out += len;
+	strm->avail_out -= len;
+	strm->total_out += len;
+
+	return(Z_STREAM_END);
+}
+
+/**********************************************************************//**
+Free a compressed page stream that was initialized by
+page_zip_deflate_init().
+@return	Z_OK, or a zlib error code */
+static
+int
+page_zip_deflate_end(
+/*=================*/
+	z_streamp	strm)	/*!< in/out: compressed stream */
+{
+	/* Any memory is freed with the heap. */
+	return(strm->state != Z_NULL ? deflateEnd(strm) : Z_OK);
+}
+
+/**********************************************************************//**
+Initialize a compressed page stream for page_zip_inflate(), determining
+the codec from the start of the stream.  The data of a codec other than
+zlib is decompressed here.
+@return	Z_OK, or a zlib error code */
+static
+int
+page_zip_inflate_init(
+/*==================*/
+	z_stream*	strm,	/*!< in/out: compressed stream; its input
+				and allocator must have been set */
+	ulint*		codec)	/*!< out: PAGE_ZIP_CODEC_ZLIB, ... */
+{
+	const byte*			hdr	= strm->next_in;
+	page_zip_codec_stream_t*	cs;
+	ulint				len;
+	ulint				fields_len;
+
+	if (strm->avail_in <= PAGE_ZIP_CODEC_HDR
+	    || (hdr[0] & 15) != PAGE_ZIP_CODEC_MAGIC) {
+		*codec = PAGE_ZIP_CODEC_ZLIB;
+		return(inflateInit2(strm, UNIV_PAGE_SIZE_SHIFT));
+	}
+
+	*codec = hdr[0] >> 4;
+	len = mach_read_from_2(hdr + 1);
+	fields_len = mach_read_from_2(hdr + 3);
+
+	if (*codec == PAGE_ZIP_CODEC_ZLIB || *codec >= PAGE_ZIP_N_CODECS
+	    || len > strm->avail_in - PAGE_ZIP_CODEC_HDR) {
+		*codec = PAGE_ZIP_CODEC_ZLIB;
+		return(Z_DATA_ERROR);
+	}
+
+	cs = mem_heap_alloc(strm->opaque, sizeof *cs);
+	cs->codec = *codec;
+
+	if (*codec == PAGE_ZIP_CODEC_LZ) {
+		cs->size = 2 * UNIV_PAGE_SIZE;
+		cs->buf = mem_heap_alloc(strm->opaque, cs->size);
+		cs->len = ut_lz_decompress(hdr + PAGE_ZIP_CODEC_HDR, len,
+					   cs->buf, cs->size);
+		if (cs->len == ULINT_UNDEFINED) {
+			return(Z_DATA_ERROR);
+		}
+	} else {
+		ut_ad(*codec == PAGE_ZIP_CODEC_NONE);
+		/* Hand out the data from the compressed page. */
+		cs->buf = (byte*) hdr + PAGE_ZIP_CODEC_HDR;
+		cs->size = cs->len = len;
+	}
+
+	if (fields_len > cs->len) {
+		return(Z_DATA_ERROR);
+	}
+
+	cs->pos = 0;
+	cs->fields_len = fields_len;
+
+	len += PAGE_ZIP_CODEC_HDR;
+	strm->next_in += len;
+	strm->avail_in -= len;
+	strm->total_in = len;
+	strm->total_out = 0;
+	strm->state = Z_NULL;
+	strm->opaque = cs;
+	strm->msg = Z_NULL;
+
+	return(Z_OK);
+}
+
+/**********************************************************************//**
+Decompress data from a compressed page stream, like inflate().
+Z_BLOCK returns the index information, which page_zip_compress()
+terminated with Z_FULL_FLUSH.
+@return	Z_OK, Z_STREAM_END, or a zlib error code */
+static
+int
+page_zip_inflate(
+/*=============*/
+	z_streamp	strm,	/*!< in/out: compressed stream */
+	int		flush)	/*!< in: inflate() flushing method */
+{
+	page_zip_codec_stream_t*	cs;
+	ulint				len;
+
+	if (strm->state != Z_NULL) {
+		return(inflate(strm, flush));
+	}
+
+	cs = strm->opaque;
+
+	if (flush == Z_BLOCK) {
+		ut_ad(cs->pos <= cs->fields_len);
+		len = cs->fields_len - cs->pos;
+	} else {
+		len = cs->len - cs->pos;
+	}
+
+	if (len > strm->avail_out) {
+		len = strm->avail_out;
+	}
+
+	memcpy(strm->next_out, cs->buf + cs->pos, len);
+	cs->pos += len;
+	strm->next_out += len;
+	strm->avail_out -= len;
+	strm->total_out += len;
+
+	if (flush == Z_BLOCK) {
+		return(Z_OK);
+	} else if (cs->pos == cs->len) {
+		return(Z_STREAM_END);
+	}
+
+	return(len ? Z_OK : Z_BUF_ERROR);
+}
+
+/**********************************************************************//**
+Free a compressed page stream that was initialized by
+page_zip_inflate_init().
+@return	Z_OK, or a zlib error code */
+static
+int
+page_zip_inflate_end(
+/*=================*/
+	z_streamp	strm)	/*!< in/out: compressed stream */
+{
+	/* Any memory is freed with the heap. */
+	return(strm->state != Z_NULL ? inflateEnd(strm) : Z_OK);
+}
+
 #if 0 || defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
 /** Symbol for enabling compression and decompression diagnostics */
 # define PAGE_ZIP_COMPRESS_DBG
@@ -747,7 +1050,8 @@ as a log file name generator. */
 UNIV_INTERN unsigned	page_zip_compress_log;
 
 /**********************************************************************//**
-Wrapper for deflate().  Log the operation if page_zip_compress_dbg is set.
+Wrapper for page_zip_deflate().  Log the operation if page_zip_compress_dbg
+is set.
 @return	deflate() status: Z_OK, Z_BUF_ERROR, ... */
 static
 int
@@ -764,21 +1068,21 @@ page_zip_compress_deflate(
 	if (UNIV_LIKELY_NULL(logfile)) {
 		fwrite(strm->next_in, 1, strm->avail_in, logfile);
 	}
-	status = deflate(strm, flush);
+	status = page_zip_deflate(strm, flush);
 	if (UNIV_UNLIKELY(page_zip_compress_dbg)) {
 		fprintf(stderr, " -> %d\n", status);
 	}
 	return(status);
 }
 
-/* Redefine deflate(). */
-# undef deflate
-/** Debug wrapper for the zlib compression routine deflate().
+/* Redefine page_zip_deflate(). */
+/** Debug wrapper for the compression routine page_zip_deflate().
 Log the operation if page_zip_compress_dbg is set.
 @param strm	in/out: compressed stream
 @param flush	in: flushing method
 @return		deflate() status: Z_OK, Z_BUF_ERROR, ... */
-# define deflate(strm, flush) page_zip_compress_deflate(logfile, strm, flush)
+# define page_zip_deflate(strm, flush)				\
+	page_zip_compress_deflate(logfile, strm, flush)
 /** Declaration of the logfile parameter */
 # define FILE_LOGFILE FILE* logfile,
 /** The logfile parameter */
@@ -826,7 +1130,7 @@ page_zip_compress_node_ptrs(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -839,7 +1143,7 @@ page_zip_compress_node_ptrs(
 			- REC_NODE_PTR_SIZE;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -883,7 +1187,7 @@ page_zip_compress_sec(
 		if (UNIV_LIKELY(c_stream->avail_in)) {
 			UNIV_MEM_ASSERT_RW(c_stream->next_in,
 					   c_stream->avail_in);
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -947,7 +1251,7 @@ page_zip_compress_clust_ext(
 				= src - c_stream->next_in;
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -976,7 +1280,7 @@ page_zip_compress_clust_ext(
 			c_stream->avail_in = src
 				- c_stream->next_in;
 			if (UNIV_LIKELY(c_stream->avail_in)) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1073,7 +1377,7 @@ page_zip_compress_clust(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1120,7 +1424,7 @@ page_zip_compress_clust(
 			c_stream->avail_in = src - c_stream->next_in;
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1148,7 +1452,7 @@ page_zip_compress_clust(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1189,6 +1493,7 @@ page_zip_compress(
 	ulint*		offsets	= NULL;
 	ulint		n_blobs	= 0;
 	byte*		storage;/* storage of uncompressed columns */
+	ulint		codec	= index->table->zip_codec;
 #ifndef UNIV_HOTBACKUP
 	ullint		usec = ut_time_us(NULL);
 #endif /* !UNIV_HOTBACKUP */
@@ -1256,7 +1561,7 @@ page_zip_compress(
 	}
 #endif /* PAGE_ZIP_COMPRESS_DBG */
 #ifndef UNIV_HOTBACKUP
-	page_zip_stat[page_zip->ssize - 1].compressed++;
+	page_zip_stat[page_zip->ssize - 1][codec].compressed++;
 #endif /* !UNIV_HOTBACKUP */
 
 	if (UNIV_UNLIKELY(n_dense * PAGE_ZIP_DIR_SLOT_SIZE
@@ -1282,10 +1587,7 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, Z_DEFAULT_COMPRESSION,
-			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
-	ut_a(err == Z_OK);
+	page_zip_deflate_init(&c_stream, codec, index->table->zip_level);
 
 	c_stream.next_out = buf;
 	/* Subtract the space reserved for uncompressed data. */
@@ -1328,7 +1630,7 @@ page_zip_compress(
 	}
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FULL_FLUSH);
+	err = page_zip_deflate(&c_stream, Z_FULL_FLUSH);
 	if (err != Z_OK) {
 		goto zlib_error;
 	}
@@ -1382,11 +1684,11 @@ page_zip_compress(
 	ut_a(c_stream.avail_in <= UNIV_PAGE_SIZE - PAGE_ZIP_START - PAGE_DIR);
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FINISH);
+	err = page_zip_deflate(&c_stream, Z_FINISH);
 
 	if (UNIV_UNLIKELY(err != Z_STREAM_END)) {
 zlib_error:
-		deflateEnd(&c_stream);
+		page_zip_deflate_end(&c_stream);
 		mem_heap_free(heap);
 err_exit:
 #ifdef PAGE_ZIP_COMPRESS_DBG
@@ -1395,13 +1697,13 @@ err_exit:
 		}
 #endif /* PAGE_ZIP_COMPRESS_DBG */
 #ifndef UNIV_HOTBACKUP
-		page_zip_stat[page_zip->ssize - 1].compressed_usec
+		page_zip_stat[page_zip->ssize - 1][codec].compressed_usec
 			+= ut_time_us(NULL) - usec;
 #endif /* !UNIV_HOTBACKUP */
 		return(FALSE);
 	}
 
-	err = deflateEnd(&c_stream);
+	err = page_zip_deflate_end(&c_stream);
 	ut_a(err == Z_OK);
 
 	ut_ad(buf + c_stream.total_out == c_stream.next_out);
@@ -1458,7 +1760,7 @@ err_exit:
 #ifndef UNIV_HOTBACKUP
 	{
 		page_zip_stat_t*	zip_stat
-			= &page_zip_stat[page_zip->ssize - 1];
+			= &page_zip_stat[page_zip->ssize - 1][codec];
 		zip_stat->compressed_ok++;
 		zip_stat->compressed_usec += ut_time_us(NULL) - usec;
 	}
@@ -2146,7 +2448,7 @@ page_zip_decompress_node_ptrs(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			if (d_stream->next_out
 			    != rec - REC_N_NEW_EXTRA_BYTES) {
@@ -2194,7 +2496,7 @@ page_zip_decompress_node_ptrs(
 		d_stream->avail_out = rec_offs_data_size(offsets)
 			- REC_NODE_PTR_SIZE;
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			goto zlib_done;
 		case Z_OK:
@@ -2233,12 +2535,12 @@ page_zip_decompress_node_ptrs(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_node_ptrs:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2246,7 +2548,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2346,7 +2648,7 @@ page_zip_decompress_sec(
 			- d_stream->next_out;
 
 		if (UNIV_LIKELY(d_stream->avail_out)) {
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 				if (d_stream->next_out
 				    != rec - REC_N_NEW_EXTRA_BYTES) {
@@ -2402,12 +2704,12 @@ page_zip_decompress_sec(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_sec:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2415,7 +2717,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2507,7 +2809,7 @@ page_zip_decompress_clust_ext(
 
 			d_stream->avail_out = dst - d_stream->next_out;
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2537,7 +2839,7 @@ page_zip_decompress_clust_ext(
 			dst += len - BTR_EXTERN_FIELD_REF_SIZE;
 
 			d_stream->avail_out = dst - d_stream->next_out;
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2615,7 +2917,7 @@ page_zip_decompress_clust(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		err = inflate(d_stream, Z_SYNC_FLUSH);
+		err = page_zip_inflate(d_stream, Z_SYNC_FLUSH);
 		switch (err) {
 		case Z_STREAM_END:
 			if (d_stream->next_out
@@ -2684,7 +2986,7 @@ page_zip_decompress_clust(
 
 			d_stream->avail_out = dst - d_stream->next_out;
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2714,7 +3016,7 @@ page_zip_decompress_clust(
 		d_stream->avail_out = rec_get_end(rec, offsets)
 			- d_stream->next_out;
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 		case Z_OK:
 		case Z_BUF_ERROR:
@@ -2744,12 +3046,12 @@ page_zip_decompress_clust(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_clust:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2757,7 +3059,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2908,6 +3210,7 @@ page_zip_decompress(
 	ulint		trx_id_col = ULINT_UNDEFINED;
 	mem_heap_t*	heap;
 	ulint*		offsets;
+	ulint		codec;
 #ifndef UNIV_HOTBACKUP
 	ullint		usec = ut_time_us(NULL);
 #endif /* !UNIV_HOTBACKUP */
@@ -2992,20 +3295,23 @@ zlib_error:
 	d_stream.next_out = page + PAGE_ZIP_START;
 	d_stream.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
 
-	if (UNIV_UNLIKELY(inflateInit2(&d_stream, UNIV_PAGE_SIZE_SHIFT)
+	if (UNIV_UNLIKELY(page_zip_inflate_init(&d_stream, &codec)
 			  != Z_OK)) {
-		ut_error;
+
+		page_zip_fail(("page_zip_decompress:"
+			       " inflateInit2()=%s\n", d_stream.msg));
+		goto zlib_error;
 	}
 
 	/* Decode the zlib header and the index information. */
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 1 inflate(Z_BLOCK)=%s\n", d_stream.msg));
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 2 inflate(Z_BLOCK)=%s\n", d_stream.msg));
@@ -3091,7 +3397,7 @@ err_exit:
 #ifndef UNIV_HOTBACKUP
 	{
 		page_zip_stat_t*	zip_stat
-			= &page_zip_stat[page_zip->ssize - 1];
+			= &page_zip_stat[page_zip->ssize - 1][codec];
 		zip_stat->decompressed++;
 		zip_stat->decompressed_usec += ut_time_us(NULL) - usec;
 	}
@@ -255,6 +255,7 @@ rec_init_offsets_comp_ordinary(
 	ulint		i		= 0;
 	ulint		offs		= 0;
 	ulint		any_ext		= 0;
+	ulint		n		= rec_offs_n_fields(offsets);
 	const byte*	nulls		= temp
 		? rec - 1
 		: rec - (1 + REC_N_NEW_EXTRA_BYTES);
@@ -278,8 +279,17 @@ rec_init_offsets_comp_ordinary(
 		temp = FALSE;
 	}
 
-	/* read the lengths of fields 0..n */
-	do {
+	/* The leading NOT NULL fixed-length fields have no null flags
+	or lengths in the record, and are at the same offsets in every
+	record. The offsets are only known for ROW_FORMAT=COMPACT. */
+	ut_ad(!index->n_fixed_prefix || !temp);
+
+	for (; i < index->n_fixed_prefix && i < n; i++) {
+		rec_offs_base(offsets)[i + 1] = offs = index->fixed_offs[i];
+	}
+
+	/* read the lengths of fields i..n */
+	for (; i < n; i++) {
 		const dict_field_t*	field
 			= dict_index_get_nth_field(index, i);
 		const dict_col_t*	col
@@ -347,7 +357,7 @@ rec_init_offsets_comp_ordinary(
 		}
 resolved:
 		rec_offs_base(offsets)[i + 1] = len;
-	} while (++i < rec_offs_n_fields(offsets));
+	}
 
 	*rec_offs_base(offsets)
 		= (rec - (lens + 1)) | REC_OFFS_COMPACT | any_ext;
@@ -412,8 +422,17 @@ rec_init_offsets(
 		offs = 0;
 		null_mask = 1;
 
-		/* read the lengths of fields 0..n */
-		do {
+		/* The leading NOT NULL fixed-length fields are at the
+		same offsets in every record */
+		for (; i < index->n_fixed_prefix
+		       && i < n_node_ptr_field
+		       && i < rec_offs_n_fields(offsets); i++) {
+			rec_offs_base(offsets)[i + 1] = offs
+				= index->fixed_offs[i];
+		}
+
+		/* read the lengths of fields i..n */
+		for (; i < rec_offs_n_fields(offsets); i++) {
 			ulint	len;
 			if (UNIV_UNLIKELY(i == n_node_ptr_field)) {
 				len = offs += REC_NODE_PTR_SIZE;
@@ -483,7 +502,7 @@ rec_init_offsets(
 			}
 resolved:
 			rec_offs_base(offsets)[i + 1] = len;
-		} while (++i < rec_offs_n_fields(offsets));
+		}
 
 		*rec_offs_base(offsets)
 			= (rec - (lens + 1)) | REC_OFFS_COMPACT;
@@ -0,0 +1,1645 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0import.c
+ALTER TABLE ... IMPORT TABLESPACE
+*******************************************************/
+
+#include "row0import.h"
+#include "row0quiesce.h"
+#include "row0mysql.h"
+#include "row0row.h"
+#include "btr0btr.h"
+#include "btr0cur.h"
+#include "btr0pcur.h"
+#include "buf0buf.h"
+#include "buf0flu.h"
+#include "dict0dict.h"
+#include "fil0fil.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
+#include "log0log.h"
+#include "mach0data.h"
+#include "os0file.h"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "page0page.h"
+#include "page0zip.h"
+#include "pars0pars.h"
+#include "que0que.h"
+#include "rem0rec.h"
+#include "srv0srv.h"
+#include "sync0sync.h"
+#include "trx0trx.h"
+#include "trx0undo.h"
+
+#include <errno.h>
+
+#ifdef UNIV_PFS_MUTEX
+/** Key to register row_import_t::mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	row_import_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
+/** Maximum length of a string in the .cfg file, including the NUL */
+#define ROW_IMPORT_MAX_STRING_LEN	4096
+
+/** Maximum number of indexes in the .cfg file */
+#define ROW_IMPORT_MAX_INDEXES		1024
+
+/** A field of an index in the .cfg file */
+typedef struct row_import_field_struct	row_import_field_t;
+
+/** A field of an index in the .cfg file */
+struct row_import_field_struct {
+	ulint		prefix_len;	/*!< column prefix length, or 0 */
+	const char*	name;		/*!< column name */
+};
+
+/** A column in the .cfg file */
+typedef struct row_import_col_struct	row_import_col_t;
+
+/** A column in the .cfg file */
+struct row_import_col_struct {
+	ulint		mtype;		/*!< main data type */
+	ulint		prtype;		/*!< precise type */
+	ulint		len;		/*!< length */
+	const char*	name;		/*!< column name */
+};
+
+/** An index in the tablespace file */
+typedef struct row_import_index_struct	row_import_index_t;
+
+/** An index in the tablespace file */
+struct row_import_index_struct {
+	index_id_t	id;		/*!< index id in the file */
+	ulint		page;		/*!< root page number in the file */
+	ulint		type;		/*!< DICT_CLUSTERED, ... */
+	ulint		n_uniq;		/*!< number of fields that identify
+					a record */
+	ulint		n_fields;	/*!< number of fields */
+	row_import_field_t* fields;	/*!< fields, from the .cfg file */
+	const char*	name;		/*!< index name */
+	dict_index_t*	index;		/*!< matching index of the table */
+	ulint		dict_page;	/*!< root page number of index
+					before the import */
+	ibool		purge;		/*!< TRUE if a leaf page holds
+					delete-marked records */
+};
+
+/** State of an IMPORT TABLESPACE */
+typedef struct row_import_struct	row_import_t;
+
+/** State of an IMPORT TABLESPACE */
+struct row_import_struct {
+	dict_table_t*	table;		/*!< table being imported */
+	trx_t*		trx;		/*!< transaction of the import */
+	mem_heap_t*	heap;		/*!< memory heap for the .cfg data */
+	/*-----------------------------*/
+	ibool		has_cfg;	/*!< TRUE if a .cfg file was read */
+	ulint		flags;		/*!< table flags in the .cfg file */
+	ib_uint64_t	autoinc;	/*!< AUTO_INCREMENT in the .cfg file */
+	ulint		n_cols;		/*!< number of columns */
+	row_import_col_t* cols;		/*!< columns in the .cfg file */
+	ulint		n_indexes;	/*!< number of indexes */
+	row_import_index_t* indexes;	/*!< indexes in the file */
+	/*-----------------------------*/
+	char*		filepath;	/*!< path of the .ibd file */
+	os_file_t	file;		/*!< the .ibd file */
+	ibool		file_open;	/*!< TRUE if file is open */
+	ulint		zip_size;	/*!< compressed page size, or 0 */
+	ulint		page_size;	/*!< page size in the file */
+	ulint		n_pages;	/*!< number of pages in the file */
+	byte*		descr;		/*!< the extent descriptor pages of
+					the file */
+	ulint		space;		/*!< space id of the table */
+	trx_id_t	trx_id;		/*!< DB_TRX_ID of the imported
+					records */
+	roll_ptr_t	roll_ptr;	/*!< DB_ROLL_PTR of the imported
+					records */
+	ib_uint64_t	lsn;		/*!< LSN of the converted pages */
+	/*-----------------------------*/
+	mutex_t		mutex;		/*!< protects the fields below */
+	ulint		next_page;	/*!< first page that has not been
+					claimed by a conversion thread */
+	ulint		n_threads;	/*!< number of running conversion
+					threads */
+	ulint		err;		/*!< DB_SUCCESS, or the first error
+					of a conversion thread */
+	os_event_t	done;		/*!< set when the last conversion
+					thread exits */
+};
+
+/*********************************************************************//**
+Prints an error about the table being imported. */
+static
+void
+row_import_error(
+/*=============*/
+	const row_import_t*	import,	/*!< in: import */
+	const char*		msg,	/*!< in: error message */
+	const char*		name)	/*!< in: name of the mismatching
+					object, or NULL */
+{
+	ut_print_timestamp(stderr);
+	fputs("  InnoDB: Error: cannot import table ", stderr);
+	ut_print_name(stderr, import->trx, TRUE, import->table->name);
+	fprintf(stderr, ": %s%s\n", msg, name ? name : "");
+}
+
+/*********************************************************************//**
+Reads a 4-byte integer from the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_import_read_4(
+/*==============*/
+	FILE*	file,	/*!< in: .cfg file */
+	ulint*	val)	/*!< out: value */
+{
+	byte	buf[4];
+
+	if (fread(buf, 1, sizeof buf, file) != sizeof buf) {
+
+		return(FALSE);
+	}
+
+	*val = mach_read_from_4(buf);
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Reads an 8-byte integer from the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_import_read_8(
+/*==============*/
+	FILE*		file,	/*!< in: .cfg file */
+	ib_uint64_t*	val)	/*!< out: value */
+{
+	byte	buf[8];
+
+	if (fread(buf, 1, sizeof buf, file) != sizeof buf) {
+
+		return(FALSE);
+	}
+
+	*val = mach_read_from_8(buf);
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Reads a string from the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_import_read_string(
+/*===================*/
+	FILE*		file,	/*!< in: .cfg file */
+	mem_heap_t*	heap,	/*!< in: memory heap */
+	const char**	str)	/*!< out: NUL-terminated string */
+{
+	ulint	len;
+	char*	s;
+
+	if (!row_import_read_4(file, &len)
+	    || len == 0 || len > ROW_IMPORT_MAX_STRING_LEN) {
+
+		return(FALSE);
+	}
+
+	s = mem_heap_alloc(heap, len);
+
+	if (fread(s, 1, len, file) != len || s[len - 1] != '\0') {
+
+		return(FALSE);
+	}
+
+	*str = s;
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Reads the definition of an index from the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_import_read_index(
+/*==================*/
+	FILE*			file,	/*!< in: .cfg file */
+	mem_heap_t*		heap,	/*!< in: memory heap */
+	row_import_index_t*	index)	/*!< out: index */
+{
+	ulint	i;
+
+	if (!row_import_read_8(file, &index->id)
+	    || !row_import_read_4(file, &index->page)
+	    || !row_import_read_4(file, &index->type)
+	    || !row_import_read_4(file, &index->n_uniq)
+	    || !row_import_read_4(file, &index->n_fields)
+	    || index->n_fields > REC_MAX_N_FIELDS
+	    || !row_import_read_string(file, heap, &index->name)) {
+
+		return(FALSE);
+	}
+
+	index->fields = mem_heap_zalloc(
+		heap, (index->n_fields + 1) * sizeof *index->fields);
+
+	for (i = 0; i < index->n_fields; i++) {
+		if (!row_import_read_4(file, &index->fields[i].prefix_len)
+		    || !row_import_read_string(file, heap,
+					       &index->fields[i].name)) {
+
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Reads the .cfg file of the table, if there is one.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_read_cfg(
+/*================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	char*		name;
+	FILE*		file;
+	ulint		version;
+	ulint		page_size;
+	const char*	table_name;
+	ulint		err = DB_SUCCESS;
+	ulint		i;
+
+	name = fil_make_cfg_name(import->table->name);
+
+	file = fopen(name, "rb");
+
+	if (file == NULL) {
+		if (errno != ENOENT) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: Error: cannot open %s: %s\n",
+				name, strerror(errno));
+			err = DB_IO_ERROR;
+		}
+
+		mem_free(name);
+
+		return(err);
+	}
+
+	if (!row_import_read_4(file, &version)) {
+
+		goto read_error;
+	}
+
+	if (version != IB_EXPORT_CFG_VERSION_V1) {
+		row_import_error(import, "unsupported version of ", name);
+		err = DB_SCHEMA_MISMATCH;
+
+		goto func_exit;
+	}
+
+	if (!row_import_read_4(file, &page_size)
+	    || !row_import_read_4(file, &import->flags)
+	    || !row_import_read_8(file, &import->autoinc)
+	    || !row_import_read_string(file, import->heap, &table_name)
+	    || !row_import_read_4(file, &import->n_cols)
+	    || import->n_cols > REC_MAX_N_FIELDS) {
+
+		goto read_error;
+	}
+
+	if (page_size != UNIV_PAGE_SIZE) {
+		row_import_error(import,
+				 "the page size differs in ", name);
+		err = DB_SCHEMA_MISMATCH;
+
+		goto func_exit;
+	}
+
+	import->cols = mem_heap_zalloc(
+		import->heap, (import->n_cols + 1) * sizeof *import->cols);
+
+	for (i = 0; i < import->n_cols; i++) {
+		row_import_col_t*	col = &import->cols[i];
+
+		if (!row_import_read_4(file, &col->mtype)
+		    || !row_import_read_4(file, &col->prtype)
+		    || !row_import_read_4(file, &col->len)
+		    || !row_import_read_string(file, import->heap,
+					       &col->name)) {
+
+			goto read_error;
+		}
+	}
+
+	if (!row_import_read_4(file, &import->n_indexes)
+	    || import->n_indexes > ROW_IMPORT_MAX_INDEXES) {
+
+		goto read_error;
+	}
+
+	import->indexes = mem_heap_zalloc(
+		import->heap,
+		(import->n_indexes + 1) * sizeof *import->indexes);
+
+	for (i = 0; i < import->n_indexes; i++) {
+		if (!row_import_read_index(file, import->heap,
+					   &import->indexes[i])) {
+
+			goto read_error;
+		}
+	}
+
+	import->has_cfg = TRUE;
+
+	ut_print_timestamp(stderr);
+	fputs("  InnoDB: Importing table ", stderr);
+	ut_print_name(stderr, import->trx, TRUE, import->table->name);
+	fputs(" with the metadata of table ", stderr);
+	ut_print_name(stderr, import->trx, TRUE, table_name);
+	fprintf(stderr, " from %s\n", name);
+
+	goto func_exit;
+
+read_error:
+	row_import_error(import, "cannot read ", name);
+	err = DB_IO_ERROR;
+
+func_exit:
+	fclose(file);
+	mem_free(name);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Checks that the table definition in the .cfg file matches the table,
+and maps the indexes of the file to the indexes of the table.
+@return	DB_SUCCESS or DB_SCHEMA_MISMATCH */
+static
+ulint
+row_import_match_cfg(
+/*=================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	dict_table_t*	table = import->table;
+	dict_index_t*	index;
+	ulint		i;
+
+	if ((import->flags ^ table->flags) & ((1U << DICT_TF_BITS) - 1)) {
+		row_import_error(import, "ROW_FORMAT or KEY_BLOCK_SIZE"
+				 " differs", NULL);
+
+		return(DB_SCHEMA_MISMATCH);
+	}
+
+	if (import->n_cols != dict_table_get_n_cols(table)) {
+		row_import_error(import, "the number of columns differs",
+				 NULL);
+
+		return(DB_SCHEMA_MISMATCH);
+	}
+
+	for (i = 0; i < import->n_cols; i++) {
+		const row_import_col_t*	cfg_col = &import->cols[i];
+		const dict_col_t*	col = dict_table_get_nth_col(table, i);
+
+		if (strcmp(cfg_col->name, dict_table_get_col_name(table, i))
+		    || cfg_col->mtype != col->mtype
+		    || cfg_col->prtype != col->prtype
+		    || cfg_col->len != col->len) {
+
+			row_import_error(import, "definition differs"
+					 " for column ", cfg_col->name);
+
+			return(DB_SCHEMA_MISMATCH);
+		}
+	}
+
+	if (import->n_indexes != UT_LIST_GET_LEN(table->indexes)) {
+		row_import_error(import, "the number of indexes differs",
+				 NULL);
+
+		return(DB_SCHEMA_MISMATCH);
+	}
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		row_import_index_t*	cfg_index = NULL;
+
+		for (i = 0; i < import->n_indexes; i++) {
+			if (!strcmp(import->indexes[i].name, index->name)) {
+				cfg_index = &import->indexes[i];
+
+				break;
+			}
+		}
+
+		if (cfg_index == NULL || cfg_index->index != NULL
+		    || cfg_index->type != index->type
+		    || cfg_index->n_uniq != index->n_uniq
+		    || cfg_index->n_fields != index->n_fields) {
+
+			row_import_error(import, "definition differs"
+					 " for index ", index->name);
+
+			return(DB_SCHEMA_MISMATCH);
+		}
+
+		for (i = 0; i < index->n_fields; i++) {
+			const dict_field_t*	field
+				= dict_index_get_nth_field(index, i);
+
+			if (strcmp(cfg_index->fields[i].name, field->name)
+			    || cfg_index->fields[i].prefix_len
+			    != field->prefix_len) {
+
+				row_import_error(import, "definition differs"
+						 " for index ", index->name);
+
+				return(DB_SCHEMA_MISMATCH);
+			}
+		}
+
+		cfg_index->index = index;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Without a .cfg file, assumes that the root pages of the indexes in the
+file are the root pages of the indexes of the table.  The index ids of
+the file are read from the root pages later. */
+static
+void
+row_import_match_dict(
+/*==================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	dict_index_t*	index;
+	ulint		i = 0;
+
+	import->n_indexes = UT_LIST_GET_LEN(import->table->indexes);
+
+	import->indexes = mem_heap_zalloc(
+		import->heap,
+		(import->n_indexes + 1) * sizeof *import->indexes);
+
+	for (index = dict_table_get_first_index(import->table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		import->indexes[i].page = index->page;
+		import->indexes[i].name = index->name;
+		import->indexes[i].index = index;
+	}
+}
+
+/*********************************************************************//**
+Finds an index of the file by its index id in the file.
+@return	index, or NULL if not found */
+static
+const row_import_index_t*
+row_import_find_index(
+/*==================*/
+	const row_import_t*	import,	/*!< in: import */
+	index_id_t		id)	/*!< in: index id in the file */
+{
+	ulint	i;
+
+	for (i = 0; i < import->n_indexes; i++) {
+		if (import->indexes[i].id == id) {
+
+			return(&import->indexes[i]);
+		}
+	}
+
+	return(NULL);
+}
+
+/*********************************************************************//**
+Reads a page of the file.
+@return	TRUE on success */
+static
+ibool
+row_import_read_page(
+/*=================*/
+	const row_import_t*	import,	/*!< in: import */
+	byte*			buf,	/*!< out: page */
+	ulint			page_no)/*!< in: page number */
+{
+	ib_uint64_t	offset = (ib_uint64_t) page_no * import->page_size;
+
+	return(os_file_read(import->file, buf,
+			    (ulint) (offset & 0xFFFFFFFFUL),
+			    (ulint) (offset >> 32), import->page_size));
+}
+
+/*********************************************************************//**
+Opens the file and checks its first page, the root pages of its indexes
+and reads its extent descriptor pages.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_open_file(
+/*=================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	byte*		buf;
+	byte*		page;
+	ib_int64_t	file_size;
+	ulint		n_descr;
+	ulint		err = DB_SUCCESS;
+	ulint		i;
+	ibool		success;
+
+	import->filepath = fil_make_ibd_name(import->table->name, FALSE);
+
+	import->file = os_file_create_simple_no_error_handling(
+		innodb_file_data_key, import->filepath, OS_FILE_OPEN,
+		OS_FILE_READ_WRITE, &success);
+
+	if (!success) {
+		/* The following call prints an error message */
+		os_file_get_last_error(TRUE);
+
+		row_import_error(import, "cannot open ", import->filepath);
+
+		return(DB_ERROR);
+	}
+
+	import->file_open = TRUE;
+
+	import->zip_size = dict_table_zip_size(import->table);
+	import->page_size = import->zip_size
+		? import->zip_size : UNIV_PAGE_SIZE;
+
+	file_size = os_file_get_size_as_iblonglong(import->file);
+
+	import->n_pages = (ulint) (file_size / import->page_size);
+
+	if (import->n_pages < FIL_IBD_FILE_INITIAL_SIZE) {
+		row_import_error(import, "the file is too small: ",
+				 import->filepath);
+
+		return(DB_CORRUPTION);
+	}
+
+	buf = ut_malloc(2 * UNIV_PAGE_SIZE);
+	page = ut_align(buf, UNIV_PAGE_SIZE);
+
+	if (!row_import_read_page(import, page, 0)) {
+		err = DB_IO_ERROR;
+
+		goto func_exit;
+	}
+
+	if (buf_page_is_corrupted(FALSE, page, import->zip_size)
+	    || fsp_header_get_space_id(page) == ULINT_UNDEFINED) {
+
+		row_import_error(import, "the first page is corrupted in ",
+				 import->filepath);
+		err = DB_CORRUPTION;
+
+		goto func_exit;
+	}
+
+	if (fsp_header_get_zip_size(page) != import->zip_size) {
+		row_import_error(import, "KEY_BLOCK_SIZE differs in ",
+				 import->filepath);
+		err = DB_SCHEMA_MISMATCH;
+
+		goto func_exit;
+	}
+
+	/* Check the root pages, and read the index ids from them if
+	there is no .cfg file. */
+
+	for (i = 0; i < import->n_indexes; i++) {
+		row_import_index_t*	index = &import->indexes[i];
+
+		if (index->page >= import->n_pages
+		    || !row_import_read_page(import, page, index->page)
+		    || fil_page_get_type(page) != FIL_PAGE_INDEX
+		    || fil_page_get_prev(page) != FIL_NULL
+		    || fil_page_get_next(page) != FIL_NULL
+		    || (import->has_cfg
+			&& btr_page_get_index_id(page) != index->id)) {
+
+			row_import_error(import, "the root page was not"
+					 " found for index ", index->name);
+			err = DB_SCHEMA_MISMATCH;
+
+			goto func_exit;
+		}
+
+		index->id = btr_page_get_index_id(page);
+
+		if (row_import_find_index(import, index->id) != index) {
+			row_import_error(import, "the same root page is"
+					 " used by index ", index->name);
+			err = DB_SCHEMA_MISMATCH;
+
+			goto func_exit;
+		}
+	}
+
+	/* An extent descriptor page describes the page_size pages
+	that start from it. */
+
+	n_descr = (import->n_pages + import->page_size - 1)
+		/ import->page_size;
+
+	import->descr = ut_malloc(n_descr * import->page_size);
+
+	for (i = 0; i < n_descr; i++) {
+		if (!row_import_read_page(import,
+					  import->descr
+					  + i * import->page_size,
+					  i * import->page_size)) {
+			err = DB_IO_ERROR;
+
+			goto func_exit;
+		}
+	}
+
+func_exit:
+	ut_free(buf);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Writes a 4-byte field of an uncompressed page, and on a compressed page
+also the uncompressed copy of the field in the compressed page. */
+static
+void
+row_import_write_4(
+/*===============*/
+	page_t*		page,		/*!< in/out: page */
+	page_zip_des_t*	page_zip,	/*!< in/out: compressed page,
+					or NULL */
+	ulint		offset,		/*!< in: offset of the field */
+	ulint		val)		/*!< in: value */
+{
+	mach_write_to_4(page + offset, val);
+
+	if (page_zip != NULL) {
+		mach_write_to_4(page_zip->data + offset, val);
+	}
+}
+
+/*********************************************************************//**
+Writes an 8-byte field of an uncompressed page, and on a compressed page
+also the uncompressed copy of the field in the compressed page. */
+static
+void
+row_import_write_8(
+/*===============*/
+	page_t*		page,		/*!< in/out: page */
+	page_zip_des_t*	page_zip,	/*!< in/out: compressed page,
+					or NULL */
+	ulint		offset,		/*!< in: offset of the field */
+	ib_uint64_t	val)		/*!< in: value */
+{
+	mach_write_to_8(page + offset, val);
+
+	if (page_zip != NULL) {
+		mach_write_to_8(page_zip->data + offset, val);
+	}
+}
+
+/*********************************************************************//**
+Sets the system columns and the BLOB pointers of the records on a leaf
+page of the clustered index.
+@return	TRUE if the page holds delete-marked records */
+static
+ibool
+row_import_convert_clust_recs(
+/*==========================*/
+	const row_import_t*	import,	/*!< in: import */
+	dict_index_t*		index,	/*!< in: clustered index */
+	page_t*			page,	/*!< in/out: leaf page */
+	page_zip_des_t*		page_zip)/*!< in/out: compressed page,
+					or NULL */
+{
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	ulint		trx_id_col;
+	rec_t*		rec;
+	ibool		deleted		= FALSE;
+
+	rec_offs_init(offsets_);
+
+	trx_id_col = dict_index_get_sys_col_pos(index, DATA_TRX_ID);
+
+	for (rec = page_rec_get_next(page_get_infimum_rec(page));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next(rec)) {
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		if (rec_get_deleted_flag(rec, page_is_comp(page))) {
+			deleted = TRUE;
+		}
+
+		if (rec_offs_any_extern(offsets)) {
+			ulint	i;
+
+			for (i = 0; i < rec_offs_n_fields(offsets); i++) {
+				byte*	field;
+				ulint	len;
+
+				if (!rec_offs_nth_extern(offsets, i)) {
+
+					continue;
+				}
+
+				field = rec_get_nth_field(rec, offsets, i,
+							  &len);
+				ut_a(len >= BTR_EXTERN_FIELD_REF_SIZE);
+
+				mach_write_to_4(field + len
+						- BTR_EXTERN_FIELD_REF_SIZE
+						+ BTR_EXTERN_SPACE_ID,
+						import->space);
+
+				if (page_zip != NULL) {
+					page_zip_write_blob_ptr(
+						page_zip, rec, index,
+						offsets, i, NULL);
+				}
+			}
+		}
+
+		/* Nothing older than the import can be visible: the
+		roll pointer refers to an empty insert undo log.  A
+		delete-marked record is thus never reached by purge;
+		row_import_purge_index() removes it. */
+
+		if (page_zip != NULL) {
+			page_zip_write_trx_id_and_roll_ptr(
+				page_zip, rec, offsets, trx_id_col,
+				import->trx_id, import->roll_ptr);
+		} else {
+			byte*	field = rec + row_get_trx_id_offset(
+				index, offsets);
+
+			trx_write_trx_id(field, import->trx_id);
+			trx_write_roll_ptr(field + DATA_TRX_ID_LEN,
+					   import->roll_ptr);
+		}
+	}
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	return(deleted);
+}
+
+/*********************************************************************//**
+Checks if a leaf page of a secondary index holds delete-marked records.
+@return	TRUE if the page holds delete-marked records */
+static
+ibool
+row_import_sec_page_has_deleted(
+/*============================*/
+	const page_t*	page)	/*!< in: leaf page */
+{
+	const rec_t*	rec;
+	ulint		comp	= page_is_comp(page);
+
+	for (rec = page_rec_get_next_const(page_get_infimum_rec(page));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next_const(rec)) {
+
+		if (rec_get_deleted_flag(rec, comp)) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/*********************************************************************//**
+Converts a B-tree page to the index ids and the space id of the table.
+@return	DB_SUCCESS or DB_SCHEMA_MISMATCH */
+static
+ulint
+row_import_convert_index_page(
+/*==========================*/
+	const row_import_t*	import,	/*!< in: import */
+	page_t*			page,	/*!< in/out: uncompressed page */
+	page_zip_des_t*		page_zip,/*!< in/out: compressed page,
+					or NULL */
+	ulint			page_no,/*!< in: page number */
+	ibool*			purge)	/*!< in/out: purge[i] is set to
+					TRUE if the page belongs to
+					import->indexes[i] and holds
+					delete-marked records */
+{
+	const row_import_index_t*	map;
+	dict_index_t*			index;
+	ibool				deleted;
+
+	map = row_import_find_index(import, btr_page_get_index_id(page));
+
+	if (map == NULL) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: page %lu of %s belongs to"
+			" index %llu, which is not in the table\n",
+			(ulong) page_no, import->filepath,
+			(ullint) btr_page_get_index_id(page));
+
+		return(DB_SCHEMA_MISMATCH);
+	}
+
+	index = map->index;
+
+	if (!page_is_comp(page) != !dict_table_is_comp(import->table)) {
+		row_import_error(import, "ROW_FORMAT differs in ",
+				 import->filepath);
+
+		return(DB_SCHEMA_MISMATCH);
+	}
+
+	row_import_write_8(page, page_zip, PAGE_HEADER + PAGE_INDEX_ID,
+			   index->id);
+
+	if (page_no == map->page) {
+		/* The root page holds the segment headers of the
+		index. */
+
+		row_import_write_4(page, page_zip,
+				   PAGE_HEADER + PAGE_BTR_SEG_LEAF
+				   + FSEG_HDR_SPACE, import->space);
+		row_import_write_4(page, page_zip,
+				   PAGE_HEADER + PAGE_BTR_SEG_TOP
+				   + FSEG_HDR_SPACE, import->space);
+	}
+
+	if (!page_is_leaf(page)) {
+
+		return(DB_SUCCESS);
+	}
+
+	if (dict_index_is_clust(index)) {
+		deleted = row_import_convert_clust_recs(
+			import, index, page, page_zip);
+	} else {
+		/* Make the records of the secondary index visible to
+		the read views that can see the import. */
+
+		row_import_write_8(page, page_zip,
+				   PAGE_HEADER + PAGE_MAX_TRX_ID,
+				   import->trx_id);
+
+		deleted = row_import_sec_page_has_deleted(page);
+	}
+
+	if (deleted) {
+		purge[map - import->indexes] = TRUE;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Converts a used page of the file.  A compressed B-tree page is
+decompressed to the frame of block for the conversion.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_convert_page(
+/*====================*/
+	const row_import_t*	import,	/*!< in: import */
+	buf_block_t*		block,	/*!< in/out: block for compressed
+					pages, or NULL */
+	byte*			page,	/*!< in/out: page in the file */
+	ulint			page_no,/*!< in: page number */
+	ibool*			purge)	/*!< in/out: indexes with
+					delete-marked records, see
+					row_import_convert_index_page() */
+{
+	page_t*		frame;
+	page_zip_des_t*	page_zip;
+	ulint		err = DB_SUCCESS;
+
+	if (buf_page_is_corrupted(FALSE, page, import->zip_size)) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: page %lu of %s is"
+			" corrupted\n", (ulong) page_no, import->filepath);
+
+		return(DB_CORRUPTION);
+	}
+
+	if (import->zip_size) {
+		page_zip = &block->page.zip;
+		page_zip->data = page;
+		frame = block->frame;
+
+		if (fil_page_get_type(page) == FIL_PAGE_INDEX) {
+			if (!page_zip_decompress(page_zip, frame, TRUE)) {
+				ut_print_timestamp(stderr);
+				fprintf(stderr, "  InnoDB: Error: page %lu"
+					" of %s cannot be decompressed\n",
+					(ulong) page_no, import->filepath);
+
+				return(DB_CORRUPTION);
+			}
+		} else {
+			memcpy(frame, page, import->zip_size);
+		}
+	} else {
+		page_zip = NULL;
+		frame = page;
+	}
+
+	row_import_write_4(frame, page_zip, FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
+			   import->space);
+
+	switch (fil_page_get_type(frame)) {
+	case FIL_PAGE_TYPE_FSP_HDR:
+		if (page_no == 0) {
+			row_import_write_4(frame, page_zip,
+					   FSP_HEADER_OFFSET + FSP_SPACE_ID,
+					   import->space);
+		}
+		break;
+	case FIL_PAGE_IBUF_BITMAP:
+		/* The change buffer of this server has no entries
+		for the pages. */
+		ibuf_bitmap_page_reset(frame, import->zip_size);
+		break;
+	case FIL_PAGE_INDEX:
+		err = row_import_convert_index_page(import, frame, page_zip,
+						    page_no, purge);
+		break;
+	}
+
+	if (err != DB_SUCCESS) {
+
+		return(err);
+	}
+
+	buf_flush_init_for_writing(frame, page_zip, import->lsn);
+
+	if (page_no == 0) {
+		/* The field is not covered by the checksums. */
+		mach_write_to_8(page + FIL_PAGE_FILE_FLUSH_LSN, import->lsn);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Converts the used pages of a range of pages of the file.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_convert_pages(
+/*=====================*/
+	const row_import_t*	import,	/*!< in: import */
+	buf_block_t*		block,	/*!< in/out: block for compressed
+					pages, or NULL */
+	byte*			buf,	/*!< out: buffer for n pages */
+	ulint			first,	/*!< in: first page number */
+	ulint			n,	/*!< in: number of pages */
+	ibool*			purge)	/*!< in/out: indexes with
+					delete-marked records, see
+					row_import_convert_index_page() */
+{
+	ib_uint64_t	offset = (ib_uint64_t) first * import->page_size;
+	ibool		modified = FALSE;
+	ulint		i;
+
+	if (!os_file_read(import->file, buf,
+			  (ulint) (offset & 0xFFFFFFFFUL),
+			  (ulint) (offset >> 32), n * import->page_size)) {
+
+		return(DB_IO_ERROR);
+	}
+
+	for (i = 0; i < n; i++) {
+		ulint	page_no = first + i;
+		ulint	err;
+
+		if (fsp_descr_page_is_free(
+			    import->descr
+			    + (page_no / import->page_size)
+			    * import->page_size,
+			    import->zip_size, page_no)) {
+
+			/* A free page is not read before it is
+			reinitialized. */
+
+			continue;
+		}
+
+		err = row_import_convert_page(
+			import, block, buf + i * import->page_size, page_no,
+			purge);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		modified = TRUE;
+	}
+
+	if (modified
+	    && !os_file_write(import->filepath, import->file, buf,
+			      (ulint) (offset & 0xFFFFFFFFUL),
+			      (ulint) (offset >> 32),
+			      n * import->page_size)) {
+
+		return(DB_IO_ERROR);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+A thread that converts the file one extent at a time, until all pages
+have been claimed or a thread has failed.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+row_import_thread(
+/*==============*/
+	void*	arg)	/*!< in/out: row_import_t */
+{
+	row_import_t*	import	= arg;
+	buf_block_t*	block	= NULL;
+	byte*		buf;
+	byte*		ptr;
+	ibool*		purge;
+	ibool		last;
+	ulint		i;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_import_thread_key);
+#endif
+
+	ptr = ut_malloc((FSP_EXTENT_SIZE + 1) * import->page_size);
+	buf = ut_align(ptr, import->page_size);
+	purge = mem_zalloc(import->n_indexes * sizeof *purge);
+
+	if (import->zip_size) {
+		/* Compressed B-tree pages are decompressed to a buffer
+		pool frame, as the page_zip functions expect. */
+
+		block = buf_block_alloc(NULL);
+		page_zip_set_size(&block->page.zip, import->zip_size);
+	}
+
+	for (;;) {
+		ulint	first;
+		ulint	n;
+		ulint	err;
+
+		mutex_enter(&import->mutex);
+
+		if (import->err != DB_SUCCESS
+		    || import->next_page >= import->n_pages) {
+
+			mutex_exit(&import->mutex);
+
+			break;
+		}
+
+		first = import->next_page;
+		n = ut_min(FSP_EXTENT_SIZE, import->n_pages - first);
+		import->next_page += n;
+
+		mutex_exit(&import->mutex);
+
+		err = row_import_convert_pages(import, block, buf, first, n,
+					       purge);
+
+		if (err != DB_SUCCESS) {
+			mutex_enter(&import->mutex);
+
+			if (import->err == DB_SUCCESS) {
+				import->err = err;
+			}
+
+			mutex_exit(&import->mutex);
+
+			break;
+		}
+	}
+
+	if (block != NULL) {
+		page_zip_des_init(&block->page.zip);
+		buf_block_free(block);
+	}
+
+	ut_free(ptr);
+
+	mutex_enter(&import->mutex);
+
+	for (i = 0; i < import->n_indexes; i++) {
+		if (purge[i]) {
+			import->indexes[i].purge = TRUE;
+		}
+	}
+
+	last = --import->n_threads == 0;
+
+	mutex_exit(&import->mutex);
+
+	mem_free(purge);
+
+	/* The waiting thread frees import->mutex as soon as the event
+	is set. */
+
+	if (last) {
+		os_event_set(import->done);
+	}
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Converts the file with innodb_read_io_threads threads.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_convert_file(
+/*====================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	ulint	n_threads;
+	ulint	i;
+
+	import->space = import->table->space;
+	import->trx_id = import->trx->id;
+	import->roll_ptr = trx_undo_build_roll_ptr(TRUE, 0, 0, 0);
+	import->lsn = log_get_lsn();
+
+	n_threads = (import->n_pages + FSP_EXTENT_SIZE - 1) / FSP_EXTENT_SIZE;
+	n_threads = ut_max(1, ut_min(n_threads, srv_n_read_io_threads));
+
+	mutex_create(row_import_mutex_key, &import->mutex,
+		     SYNC_NO_ORDER_CHECK);
+	import->done = os_event_create(NULL);
+	import->next_page = 0;
+	import->n_threads = n_threads;
+	import->err = DB_SUCCESS;
+
+	for (i = 0; i < n_threads; i++) {
+		os_thread_create(row_import_thread, import, NULL);
+	}
+
+	os_event_wait(import->done);
+
+	os_event_free(import->done);
+	mutex_free(&import->mutex);
+
+	if (import->err == DB_SUCCESS && !os_file_flush(import->file)) {
+
+		import->err = DB_IO_ERROR;
+	}
+
+	if (import->err == DB_SUCCESS) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Converted %lu pages of %s"
+			" with %lu threads\n", (ulong) import->n_pages,
+			import->filepath, (ulong) n_threads);
+	}
+
+	return(import->err);
+}
+
+/*********************************************************************//**
+Sets the root page of an index in SYS_INDEXES.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_update_root(
+/*===================*/
+	trx_t*			trx,	/*!< in: transaction */
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			page_no)/*!< in: root page number */
+{
+	pars_info_t*	info = pars_info_create();
+
+	pars_info_add_ull_literal(info, "table_id", index->table->id);
+	pars_info_add_ull_literal(info, "index_id", index->id);
+	pars_info_add_int4_literal(info, "page_no", page_no);
+
+	return(que_eval_sql(info,
+			    "PROCEDURE UPDATE_INDEX_ROOT_PROC () IS\n"
+			    "BEGIN\n"
+			    "UPDATE SYS_INDEXES SET PAGE_NO = :page_no\n"
+			    " WHERE TABLE_ID = :table_id"
+			    " AND ID = :index_id;\n"
+			    "END;\n", FALSE, trx));
+}
+
+/*********************************************************************//**
+Sets the root pages of the indexes of the table to the root pages in the
+file, if they differ.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_import_update_roots(
+/*====================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	ulint	i;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	for (i = 0; i < import->n_indexes; i++) {
+		row_import_index_t*	map = &import->indexes[i];
+		ulint			err;
+
+		map->dict_page = map->index->page;
+
+		if (map->page == map->dict_page) {
+
+			continue;
+		}
+
+		err = row_import_update_root(import->trx, map->index,
+					     map->page);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		map->index->page = map->page;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Restores the root pages of the indexes in the dictionary cache after the
+changes of row_import_update_roots() were rolled back. */
+static
+void
+row_import_restore_roots(
+/*=====================*/
+	row_import_t*	import)	/*!< in/out: import */
+{
+	ulint	i;
+
+	for (i = 0; i < import->n_indexes; i++) {
+		row_import_index_t*	map = &import->indexes[i];
+
+		if (map->dict_page) {
+			map->index->page = map->dict_page;
+		}
+	}
+}
+
+/*********************************************************************//**
+Removes the delete-marked records of an imported index.  The records
+were converted to the transaction of the import without any undo log,
+so purge would never remove them. */
+static
+void
+row_import_purge_index(
+/*===================*/
+	const row_import_t*	import,	/*!< in: import */
+	dict_index_t*		index)	/*!< in: index */
+{
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	ulint		comp		= dict_table_is_comp(index->table);
+	ulint		n_purged	= 0;
+	ulint		err		= DB_SUCCESS;
+
+	mtr_start(&mtr);
+
+	btr_pcur_open_at_index_side(TRUE, index, BTR_MODIFY_LEAF, &pcur,
+				    TRUE, &mtr);
+
+	for (;;) {
+		btr_pcur_move_to_next_on_page(&pcur);
+
+		if (btr_pcur_is_after_last_on_page(&pcur)) {
+			/* Release the latch on the page before moving
+			to the next one. */
+
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr_commit(&mtr);
+
+			mtr_start(&mtr);
+			btr_pcur_restore_position(BTR_MODIFY_LEAF, &pcur,
+						  &mtr);
+
+			if (!btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+				break;
+			}
+		}
+
+		if (!rec_get_deleted_flag(btr_pcur_get_rec(&pcur), comp)) {
+
+			continue;
+		}
+
+		/* A pessimistic delete also frees the externally stored
+		columns of a clustered index record. */
+
+		btr_pcur_store_position(&pcur, &mtr);
+		mtr_commit(&mtr);
+
+		mtr_start(&mtr);
+		ut_a(btr_pcur_restore_position(BTR_MODIFY_TREE, &pcur,
+					       &mtr));
+
+		btr_cur_pessimistic_delete(&err, FALSE,
+					   btr_pcur_get_btr_cur(&pcur),
+					   RB_NONE, &mtr);
+		mtr_commit(&mtr);
+
+		if (err != DB_SUCCESS) {
+			mtr_start(&mtr);
+
+			break;
+		}
+
+		n_purged++;
+
+		/* The cursor is restored to the predecessor of the
+		removed record. */
+
+		mtr_start(&mtr);
+		btr_pcur_restore_position(BTR_MODIFY_LEAF, &pcur, &mtr);
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	ut_print_timestamp(stderr);
+
+	if (err != DB_SUCCESS) {
+		fprintf(stderr, "  InnoDB: Warning: out of space in %s;"
+			" delete-marked records are left in index ",
+			import->filepath);
+	} else {
+		fprintf(stderr, "  InnoDB: Removed %lu delete-marked"
+			" records from index ", (ulong) n_purged);
+	}
+
+	ut_print_name(stderr, import->trx, FALSE, index->name);
+	fputs(" of table ", stderr);
+	ut_print_name(stderr, import->trx, TRUE, index->table_name);
+	putc('\n', stderr);
+}
+
+/*********************************************************************//**
+Removes the delete-marked records of the indexes whose leaf pages held
+such records when the file was converted. */
+static
+void
+row_import_purge(
+/*=============*/
+	const row_import_t*	import)	/*!< in: import */
+{
+	ulint	i;
+
+	for (i = 0; i < import->n_indexes; i++) {
+		if (import->indexes[i].purge) {
+			row_import_purge_index(import,
+					       import->indexes[i].index);
+		}
+	}
+}
+
+/*****************************************************************//**
+Imports a tablespace. The .ibd file can come from another server; it
+is converted to the space id and the index ids of the table.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_import_tablespace_for_mysql(
+/*============================*/
+	const char*	name,	/*!< in: table name */
+	trx_t*		trx)	/*!< in: transaction handle */
+{
+	dict_table_t*	table;
+	row_import_t	import;
+	ibool		success;
+	ulint		err		= DB_SUCCESS;
+
+	memset(&import, 0, sizeof import);
+
+	trx_start_if_not_started(trx);
+
+	trx->op_info = "importing tablespace";
+
+	/* Serialize data dictionary operations with dictionary mutex:
+	no deadlocks can occur then in these operations */
+
+	row_mysql_lock_data_dictionary(trx);
+
+	table = dict_table_get_low(name, DICT_ERR_IGNORE_NONE);
+
+	if (!table) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: table ", stderr);
+		ut_print_name(stderr, trx, TRUE, name);
+		fputs("\n"
+		      "InnoDB: does not exist in the InnoDB data dictionary\n"
+		      "InnoDB: in ALTER TABLE ... IMPORT TABLESPACE\n",
+		      stderr);
+
+		err = DB_TABLE_NOT_FOUND;
+
+		goto funct_exit;
+	}
+
+	if (table->space == 0) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: Error: table ", stderr);
+		ut_print_name(stderr, trx, TRUE, name);
+		fputs("\n"
+		      "InnoDB: is in the system tablespace 0"
+		      " which cannot be imported\n", stderr);
+		err = DB_ERROR;
+
+		goto funct_exit;
+	}
+
+	if (!table->tablespace_discarded) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: Error: you are trying to"
+		      " IMPORT a tablespace\n"
+		      "InnoDB: ", stderr);
+		ut_print_name(stderr, trx, TRUE, name);
+		fputs(", though you have not called DISCARD on it yet\n"
+		      "InnoDB: during the lifetime of the mysqld process!\n",
+		      stderr);
+
+		err = DB_ERROR;
+
+		goto funct_exit;
+	}
+
+	/* The table is open in MySQL, which keeps it in the dictionary
+	cache and prevents other DDL on it while the file is converted
+	without the dictionary latch. */
+
+	row_mysql_unlock_data_dictionary(trx);
+
+	import.table = table;
+	import.trx = trx;
+	import.heap = mem_heap_create(1024);
+
+	err = row_import_read_cfg(&import);
+
+	if (err == DB_SUCCESS) {
+		if (import.has_cfg) {
+			err = row_import_match_cfg(&import);
+		} else {
+			row_import_match_dict(&import);
+		}
+	}
+
+	if (err == DB_SUCCESS) {
+		err = row_import_open_file(&import);
+	}
+
+	if (err == DB_SUCCESS) {
+		err = row_import_convert_file(&import);
+	}
+
+	if (import.file_open) {
+		os_file_close(import.file);
+	}
+
+	row_mysql_lock_data_dictionary(trx);
+
+	if (err != DB_SUCCESS) {
+
+		goto funct_exit;
+	}
+
+	err = row_import_update_roots(&import);
+
+	if (err != DB_SUCCESS) {
+		trx->error_state = DB_SUCCESS;
+		trx_general_rollback_for_mysql(trx, NULL);
+		trx->error_state = DB_SUCCESS;
+		row_import_restore_roots(&import);
+
+		goto funct_exit;
+	}
+
+	/* Play safe and remove all insert buffer entries, though we should
+	have removed them already when DISCARD TABLESPACE was called */
+
+	ibuf_delete_for_discarded_space(table->space);
+
+	success = fil_open_single_table_tablespace(
+		TRUE, table->space,
+		table->flags == DICT_TF_COMPACT ? 0 : table->flags,
+		table->name);
+	if (success) {
+		/* The table cannot be used before ibd_file_missing is
+		cleared. */
+
+		row_mysql_unlock_data_dictionary(trx);
+
+		row_import_purge(&import);
+
+		row_mysql_lock_data_dictionary(trx);
+
+		table->ibd_file_missing = FALSE;
+		table->tablespace_discarded = FALSE;
+		/* Compress with the codec of the imported file. */
+		dict_table_set_zip_compression(
+			table, fil_space_get_flags(table->space));
+
+		if (import.has_cfg && import.autoinc) {
+			dict_table_autoinc_lock(table);
+			dict_table_autoinc_initialize(table, import.autoinc);
+			dict_table_autoinc_unlock(table);
+		}
+	} else {
+		if (table->ibd_file_missing) {
+			ut_print_timestamp(stderr);
+			fputs("  InnoDB: cannot find or open in the"
+			      " database directory the .ibd file of\n"
+			      "InnoDB: table ", stderr);
+			ut_print_name(stderr, trx, TRUE, name);
+			fputs("\n"
+			      "InnoDB: in ALTER TABLE ... IMPORT TABLESPACE\n",
+			      stderr);
+		}
+
+		trx->error_state = DB_SUCCESS;
+		trx_general_rollback_for_mysql(trx, NULL);
+		trx->error_state = DB_SUCCESS;
+		row_import_restore_roots(&import);
+
+		err = DB_ERROR;
+	}
+
+funct_exit:
+	if (import.heap != NULL) {
+		mem_heap_free(import.heap);
+	}
+
+	if (import.filepath != NULL) {
+		mem_free(import.filepath);
+	}
+
+	if (import.descr != NULL) {
+		ut_free(import.descr);
+	}
+
+	trx_commit_for_mysql(trx);
+
+	row_mysql_unlock_data_dictionary(trx);
+
+	trx->op_info = "";
+
+	return((int) err);
+}
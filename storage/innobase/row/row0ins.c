@@ -2178,6 +2178,11 @@ row_ins_index_entry_low(
 				n_ext, thr, &mtr);
 
 			if (err == DB_FAIL) {
+				if (thr_get_trx(thr)->mysql_thd != 0) {
+					DEBUG_SYNC_C(
+						"before_btr_cur_pessimistic_insert");
+				}
+
 				err = btr_cur_pessimistic_insert(
 					0, &cursor, entry, &insert_rec,
 					&big_rec, n_ext, thr, &mtr);
@@ -35,7 +35,9 @@ Completed by Sunny Bains and Marko Makela
 #include "dict0boot.h"
 #include "dict0crea.h"
 #include "dict0load.h"
+#include "dict0stats.h"
 #include "btr0btr.h"
+#include "btr0bulk.h"
 #include "mach0data.h"
 #include "trx0rseg.h"
 #include "trx0trx.h"
@@ -1853,6 +1855,40 @@ row_merge_copy_blobs(
 	}
 }
 
+/********************************************************************//**
+Sets DB_TRX_ID and DB_ROLL_PTR of a clustered index entry that is inserted
+without an undo log record of its own. The roll pointer is that of a fresh
+insert, so that a read view that does not see the transaction does not see
+the record. */
+static
+void
+row_merge_set_sys_fields(
+/*=====================*/
+	dtuple_t*		entry,	/*!< in/out: clustered index entry */
+	const dict_index_t*	index,	/*!< in: clustered index */
+	trx_id_t		trx_id,	/*!< in: transaction id */
+	mem_heap_t*		heap)	/*!< in/out: memory heap */
+{
+	byte*	buf = mem_heap_alloc(heap, DATA_TRX_ID_LEN
+				     + DATA_ROLL_PTR_LEN);
+
+	ut_ad(dict_index_is_clust(index));
+
+	trx_write_trx_id(buf, trx_id);
+	dfield_set_data(dtuple_get_nth_field(
+				entry, dict_index_get_sys_col_pos(
+					index, DATA_TRX_ID)),
+			buf, DATA_TRX_ID_LEN);
+
+	buf += DATA_TRX_ID_LEN;
+
+	trx_write_roll_ptr(buf, trx_undo_build_roll_ptr(TRUE, 0, 0, 0));
+	dfield_set_data(dtuple_get_nth_field(
+				entry, dict_index_get_sys_col_pos(
+					index, DATA_ROLL_PTR)),
+			buf, DATA_ROLL_PTR_LEN);
+}
+
 /********************************************************************//**
 Read sorted file containing index data tuples and insert these data
 tuples to the index
@@ -1867,7 +1903,10 @@ row_merge_insert_index_tuples(
 	ulint			zip_size,/*!< in: compressed page size of
 					 the old table, or 0 if uncompressed */
 	int			fd,	/*!< in: file descriptor */
-	row_merge_block_t*	block)	/*!< in/out: file buffer */
+	row_merge_block_t*	block,	/*!< in/out: file buffer */
+	btr_bulk_t*		bulk)	/*!< in/out: bottom-up build of the
+					empty index tree, or NULL to insert
+					the tuples one by one */
 {
 	const byte*		b;
 	que_thr_t*		thr;
@@ -1940,6 +1979,24 @@ row_merge_insert_index_tuples(
 
 			ut_ad(dtuple_validate(dtuple));
 
+			if (bulk) {
+				/* The entries of an empty index tree
+				are not undo logged one by one. */
+				if (dict_index_is_clust(index)) {
+					row_merge_set_sys_fields(
+						dtuple, index, trx->id,
+						tuple_heap);
+				}
+
+				error = btr_bulk_insert(bulk, dtuple);
+
+				if (UNIV_UNLIKELY(error != DB_SUCCESS)) {
+					break;
+				}
+
+				goto next_rec;
+			}
+
 			do {
 				thr->run_node = thr;
 				thr->prev_node = thr->common.parent;
@@ -2098,8 +2155,14 @@ row_merge_drop_index(
 
 	ut_a(trx->dict_operation_lock_mode == RW_X_LATCH);
 
+	dict_stats_wait_bg_to_stop_using_table(table, trx);
+
 	err = que_eval_sql(info, sql, FALSE, trx);
 
+	if (err == DB_SUCCESS) {
+		err = dict_stats_delete_index_stats(index, trx);
+	}
+
 
 	if (err != DB_SUCCESS) {
 		/* Even though we ensure that DDL transactions are WAIT
@@ -2780,10 +2843,31 @@ row_merge_build_indexes(
 				       block, &tmpfd, table);
 
 		if (error == DB_SUCCESS) {
+			btr_bulk_t*	bulk = NULL;
+
+			/* The new index trees are empty and not
+			visible to other transactions yet. */
+			if (srv_bulk_load
+			    && btr_bulk_is_applicable(indexes[i])) {
+				bulk = btr_bulk_create(indexes[i], trx->id);
+			}
+
 			error = row_merge_insert_index_tuples(
 				trx, indexes[i], new_table,
 				dict_table_zip_size(old_table),
-				merge_files[i].fd, block);
+				merge_files[i].fd, block, bulk);
+
+			if (bulk) {
+				if (error == DB_SUCCESS) {
+					error = btr_bulk_end(bulk);
+				}
+
+				if (error == DB_SUCCESS) {
+					btr_bulk_publish(&bulk, 1);
+				} else {
+					btr_bulk_abort(bulk);
+				}
+			}
 		}
 
 		/* Close the temporary file to free up space. */
@@ -2807,3 +2891,321 @@ func_exit:
 
 	return(error);
 }
+
+/** Bulk insert into an empty table */
+struct row_merge_bulk_struct {
+	trx_t*			trx;	/*!< transaction */
+	dict_table_t*		table;	/*!< table */
+	struct TABLE*		mysql_table;/*!< MySQL table, for reporting
+					duplicate key values */
+	ulint			n_index;/*!< number of indexes */
+	row_merge_buf_t**	buf;	/*!< sort buffer of each index */
+	merge_file_t*		files;	/*!< sorted runs of each index */
+	int			tmpfd;	/*!< temporary file for merging */
+	row_merge_block_t*	block;	/*!< 3 buffers */
+	ulint			block_size;/*!< size of block */
+	ulint			n_rows;	/*!< number of rows added */
+};
+
+/*********************************************************************//**
+Checks whether the rows of an insert statement can be sorted and loaded
+into the index trees of a table bottom-up. The table must be empty, and
+an exclusive lock on it must be held.
+@return	TRUE if row_merge_bulk_create() can be used */
+UNIV_INTERN
+ibool
+row_merge_bulk_is_applicable(
+/*=========================*/
+	dict_table_t*	table)	/*!< in: table */
+{
+	dict_index_t*	index;
+
+	if (table->ibd_file_missing
+	    || UT_LIST_GET_LEN(table->foreign_list) > 0) {
+
+		return(FALSE);
+	}
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (!btr_bulk_is_applicable(index)) {
+
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Starts a bulk insert into an empty table.
+@return	own: bulk insert, or NULL if the temporary files could not be
+created */
+UNIV_INTERN
+row_merge_bulk_t*
+row_merge_bulk_create(
+/*==================*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_table_t*	table,		/*!< in: table,
+					row_merge_bulk_is_applicable() */
+	struct TABLE*	mysql_table)	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+{
+	row_merge_bulk_t*	bulk;
+	dict_index_t*		index;
+	ulint			i;
+
+	bulk = mem_zalloc(sizeof *bulk);
+	bulk->trx = trx;
+	bulk->table = table;
+	bulk->mysql_table = mysql_table;
+	bulk->n_index = UT_LIST_GET_LEN(table->indexes);
+	bulk->tmpfd = -1;
+
+	bulk->buf = mem_zalloc(bulk->n_index * sizeof *bulk->buf);
+	bulk->files = mem_alloc(bulk->n_index * sizeof *bulk->files);
+
+	for (i = 0; i < bulk->n_index; i++) {
+		bulk->files[i].fd = -1;
+	}
+
+	bulk->block_size = 3 * sizeof *bulk->block;
+	bulk->block = os_mem_alloc_large(&bulk->block_size, FALSE);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		bulk->buf[i] = row_merge_buf_create(index);
+
+		if (row_merge_file_create(&bulk->files[i]) < 0) {
+			goto err_exit;
+		}
+	}
+
+	bulk->tmpfd = row_merge_file_create_low();
+
+	if (bulk->tmpfd < 0) {
+err_exit:
+		row_merge_bulk_end(bulk, FALSE);
+		return(NULL);
+	}
+
+	return(bulk);
+}
+
+/*********************************************************************//**
+Sorts the buffered entries of an index and writes them to its merge file
+as one sorted run.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_merge_bulk_write(
+/*=================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk insert */
+	ulint			i)	/*!< in: index number */
+{
+	row_merge_buf_t*	buf	= bulk->buf[i];
+	merge_file_t*		file	= &bulk->files[i];
+
+	if (buf->n_tuples) {
+		if (dict_index_is_unique(buf->index)) {
+			row_merge_dup_t	dup;
+			dup.index = buf->index;
+			dup.table = bulk->mysql_table;
+			dup.n_dup = 0;
+
+			row_merge_buf_sort(buf, &dup);
+
+			if (dup.n_dup) {
+				bulk->trx->error_info = buf->index;
+				return(DB_DUPLICATE_KEY);
+			}
+		} else {
+			row_merge_buf_sort(buf, NULL);
+		}
+	}
+
+	row_merge_buf_write(buf, file, bulk->block);
+
+	if (!row_merge_write(file->fd, file->offset++, bulk->block)) {
+
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	UNIV_MEM_INVALID(bulk->block[0], sizeof bulk->block[0]);
+	bulk->buf[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Adds a row to a bulk insert. The entries of every index are buffered and
+written to the merge files in sorted runs.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_add(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk insert */
+	const dtuple_t*		row)	/*!< in: row, including the system
+					columns */
+{
+	ulint	i;
+
+	for (i = 0; i < bulk->n_index; i++) {
+		ulint	err;
+
+		if (row_merge_buf_add(bulk->buf[i], row, NULL)) {
+			bulk->files[i].n_rec++;
+			continue;
+		}
+
+		err = row_merge_bulk_write(bulk, i);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		if (UNIV_UNLIKELY(!row_merge_buf_add(bulk->buf[i],
+						     row, NULL))) {
+			/* An empty buffer should have enough
+			room for at least one record. */
+			ut_error;
+		}
+
+		bulk->files[i].n_rec++;
+	}
+
+	bulk->n_rows++;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Ends a bulk insert and frees it. If the rows are to be loaded, the
+entries of every index are merge sorted first, so that a duplicate key
+is found before any index tree is built, and then every index tree is
+built bottom-up. The trees are made visible together in one
+mini-transaction, after their pages have been written to disk.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_end(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in,own: bulk insert */
+	ibool			load)	/*!< in: TRUE to load the rows,
+					FALSE to discard them */
+{
+	trx_t*		trx	= bulk->trx;
+	btr_bulk_t**	btr_bulk;
+	dict_index_t*	index;
+	ulint		i;
+	ulint		err	= DB_SUCCESS;
+
+	if (!load) {
+		goto func_exit;
+	}
+
+	trx->op_info = "sorting bulk insert";
+
+	/* Reset the MySQL row buffer that is used when reporting
+	duplicate keys. */
+	innobase_rec_reset(bulk->mysql_table);
+
+	for (index = dict_table_get_first_index(bulk->table), i = 0;
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		err = row_merge_bulk_write(bulk, i);
+
+		if (err == DB_SUCCESS) {
+			err = row_merge_sort(trx, index, &bulk->files[i],
+					     bulk->block, &bulk->tmpfd,
+					     bulk->mysql_table);
+		}
+
+		if (err != DB_SUCCESS) {
+			trx->error_info = index;
+			goto func_exit;
+		}
+	}
+
+	btr_bulk = mem_zalloc(bulk->n_index * sizeof *btr_bulk);
+
+	for (index = dict_table_get_first_index(bulk->table), i = 0;
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		btr_bulk[i] = btr_bulk_create(index, trx->id);
+
+		err = row_merge_insert_index_tuples(
+			trx, index, bulk->table, 0, bulk->files[i].fd,
+			bulk->block, btr_bulk[i]);
+
+		if (err == DB_SUCCESS) {
+			err = btr_bulk_end(btr_bulk[i]);
+		}
+
+		/* Close the temporary file to free up space. */
+		row_merge_file_destroy(&bulk->files[i]);
+
+		if (err != DB_SUCCESS) {
+			trx->error_info = index;
+			break;
+		}
+	}
+
+	if (err == DB_SUCCESS) {
+		btr_bulk_publish(btr_bulk, bulk->n_index);
+	} else {
+		for (i = 0; i < bulk->n_index && btr_bulk[i] != NULL; i++) {
+			btr_bulk_abort(btr_bulk[i]);
+		}
+	}
+
+	mem_free(btr_bulk);
+
+	if (err == DB_SUCCESS) {
+		dict_table_t*	table = bulk->table;
+
+		srv_n_rows_inserted += bulk->n_rows;
+
+		table->stat_n_rows += bulk->n_rows;
+		table->stat_modified_counter += bulk->n_rows;
+
+		if (DICT_TABLE_CHANGED_TOO_MUCH(table)) {
+			dict_update_statistics(
+				table,
+				FALSE, /* update even if stats are
+				       initialized */
+				TRUE /* only update if stats changed
+				     too much */);
+		}
+	}
+
+func_exit:
+	trx->op_info = "";
+
+	if (bulk->tmpfd >= 0) {
+		row_merge_file_destroy_low(bulk->tmpfd);
+	}
+
+	for (i = 0; i < bulk->n_index; i++) {
+		if (bulk->buf[i] != NULL) {
+			row_merge_buf_free(bulk->buf[i]);
+		}
+
+		row_merge_file_destroy(&bulk->files[i]);
+	}
+
+	os_mem_free_large(bulk->block, bulk->block_size);
+	mem_free(bulk->files);
+	mem_free(bulk->buf);
+	mem_free(bulk);
+
+	return(err);
+}
@@ -41,6 +41,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "dict0crea.h"
 #include "dict0load.h"
 #include "dict0boot.h"
+#include "dict0stats.h"
 #include "trx0roll.h"
 #include "trx0purge.h"
 #include "trx0rec.h"
@@ -758,8 +759,12 @@ row_create_prebuilt(
 
 	prebuilt->autoinc_last_value = 0;
 
+	prebuilt->autoinc_n_reserved = 0;
+
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+
 	return(prebuilt);
 }
 
@@ -795,6 +800,10 @@ row_prebuilt_free(
 	prebuilt->magic_n = ROW_PREBUILT_FREED;
 	prebuilt->magic_n2 = ROW_PREBUILT_FREED;
 
+	if (prebuilt->bulk) {
+		row_merge_bulk_end(prebuilt->bulk, FALSE);
+	}
+
 	btr_pcur_reset(&prebuilt->pcur);
 	btr_pcur_reset(&prebuilt->clust_pcur);
 
@@ -822,25 +831,26 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-		if (prebuilt->fetch_cache[i] != NULL) {
-
-			if ((ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
-				     (prebuilt->fetch_cache[i]) - 4))
-			    || (ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
-					(prebuilt->fetch_cache[i])
-					+ prebuilt->mysql_row_len))) {
-				fputs("InnoDB: Error: trying to free"
-				      " a corrupt fetch buffer.\n", stderr);
+	for (i = 0; i < prebuilt->fetch_cache_allocated; i++) {
 
-				mem_analyze_corruption(
-					prebuilt->fetch_cache[i]);
+		if ((ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
+			     (prebuilt->fetch_cache[i]) - 4))
+		    || (ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
+				(prebuilt->fetch_cache[i])
+				+ prebuilt->mysql_row_len))) {
+			fputs("InnoDB: Error: trying to free"
+			      " a corrupt fetch buffer.\n", stderr);
 
-				ut_error;
-			}
+			mem_analyze_corruption(prebuilt->fetch_cache[i]);
 
-			mem_free((prebuilt->fetch_cache[i]) - 4);
+			ut_error;
 		}
+
+		mem_free((prebuilt->fetch_cache[i]) - 4);
+	}
+
+	if (prebuilt->fetch_cache != NULL) {
+		mem_free(prebuilt->fetch_cache);
 	}
 
 	dict_table_decrement_handle_count(prebuilt->table, dict_locked);
@@ -1276,6 +1286,138 @@ run_again:
 	return((int) err);
 }
 
+/*********************************************************************//**
+Decides at the first row of an insert statement with
+prebuilt->bulk_requested whether its rows are loaded bottom-up. The table
+is locked in exclusive mode, and if it is empty and its indexes allow it,
+prebuilt->bulk is created. The rows are not undo logged one by one: a
+single TRX_UNDO_EMPTY record makes a rollback empty the table again.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_start_for_mysql(
+/*=====================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	struct TABLE*	mysql_table)	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+{
+	trx_t*		trx	= prebuilt->trx;
+	roll_ptr_t	roll_ptr;
+	int		err;
+
+	ut_ad(prebuilt->bulk_requested);
+	ut_ad(!prebuilt->bulk);
+
+	prebuilt->bulk_requested = FALSE;
+
+	if (srv_created_new_raw || srv_force_recovery
+	    || prebuilt->table->ibd_file_missing) {
+		/* Let row_insert_for_mysql() report the error. */
+		return(DB_SUCCESS);
+	}
+
+	/* No other transaction may have inserted rows that are not
+	visible yet, or insert rows into the table before the end of
+	the statement. */
+	err = row_lock_table_for_mysql(prebuilt, prebuilt->table, LOCK_X);
+
+	if (err != DB_SUCCESS
+	    || !row_merge_bulk_is_applicable(prebuilt->table)) {
+
+		return(err);
+	}
+
+	if (prebuilt->ins_node == NULL) {
+		row_get_prebuilt_insert_row(prebuilt);
+	}
+
+	prebuilt->bulk = row_merge_bulk_create(trx, prebuilt->table,
+					       mysql_table);
+
+	if (prebuilt->bulk == NULL) {
+		/* Insert the rows one by one. */
+		return(DB_SUCCESS);
+	}
+
+	err = trx_undo_report_row_operation(
+		0, TRX_UNDO_INSERT_OP,
+		que_fork_get_first_thr(prebuilt->ins_graph),
+		dict_table_get_first_index(prebuilt->table),
+		NULL, NULL, 0, NULL, &roll_ptr);
+
+	if (err != DB_SUCCESS) {
+		row_merge_bulk_end(prebuilt->bulk, FALSE);
+		prebuilt->bulk = NULL;
+	}
+
+	return(err);
+}
+
+/*********************************************************************//**
+Buffers a row of an insert statement in prebuilt->bulk. The row becomes
+visible only in row_bulk_end_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_insert_for_mysql(
+/*======================*/
+	byte*		mysql_rec,	/*!< in: row in the MySQL format */
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct in
+					MySQL handle */
+{
+	ins_node_t*	node	= prebuilt->ins_node;
+	trx_t*		trx	= prebuilt->trx;
+	dict_index_t*	clust_index;
+	ulint		err;
+
+	ut_ad(prebuilt->bulk);
+
+	trx->op_info = "inserting";
+
+	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec);
+
+	clust_index = dict_table_get_first_index(prebuilt->table);
+
+	if (!dict_index_is_unique(clust_index)) {
+		dict_sys_write_row_id(node->row_id_buf,
+				      dict_sys_get_new_row_id());
+	}
+
+	err = row_merge_bulk_add(prebuilt->bulk, node->row);
+
+	trx->op_info = "";
+
+	return((int) err);
+}
+
+/*********************************************************************//**
+Ends the bulk insert of an insert statement, if one was started, by
+loading the buffered rows into the index trees, or by discarding them if
+the statement failed.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_end_for_mysql(
+/*===================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	ibool		load)		/*!< in: FALSE to discard the rows */
+{
+	row_merge_bulk_t*	bulk	= prebuilt->bulk;
+
+	prebuilt->bulk_requested = FALSE;
+
+	if (bulk == NULL) {
+
+		return(DB_SUCCESS);
+	}
+
+	prebuilt->bulk = NULL;
+
+	return((int) row_merge_bulk_end(bulk, load));
+}
+
 /*********************************************************************//**
 Builds a dummy query graph used in selects. */
 UNIV_INTERN
@@ -1997,8 +2139,9 @@ err_exit:
 	case DB_TOO_MANY_CONCURRENT_TRXS:
 		/* We already have .ibd file here. it should be deleted. */
 
-		if (table->space && !fil_delete_tablespace(table->space,
-							   FALSE)) {
+		if (table->space
+		    && !fil_delete_tablespace(table->space,
+					      BUF_REMOVE_FLUSH_NO_WRITE)) {
 			ut_print_timestamp(stderr);
 			fprintf(stderr,
 				"  InnoDB: Error: not able to"
@@ -2455,6 +2598,8 @@ row_discard_tablespace_for_mysql(
 		goto funct_exit;
 	}
 
+	dict_stats_wait_bg_to_stop_using_table(table, trx);
+
 	if (table->space == 0) {
 		ut_print_timestamp(stderr);
 		fputs("  InnoDB: Error: table ", stderr);
@@ -2555,7 +2700,10 @@ row_discard_tablespace_for_mysql(
 	} else {
 		dict_table_change_id_in_cache(table, new_id);
 
-		success = fil_discard_tablespace(table->space);
+		/* IMPORT TABLESPACE will reuse the space id:
+		evict all the pages now. */
+		success = fil_discard_tablespace(table->space,
+						 BUF_REMOVE_ALL_NO_WRITE);
 
 		if (!success) {
 			trx->error_state = DB_SUCCESS;
@@ -2581,142 +2729,6 @@ funct_exit:
 	return((int) err);
 }
 
-/*****************************************************************//**
-Imports a tablespace. The space id in the .ibd file must match the space id
-of the table in the data dictionary.
-@return	error code or DB_SUCCESS */
-UNIV_INTERN
-int
-row_import_tablespace_for_mysql(
-/*============================*/
-	const char*	name,	/*!< in: table name */
-	trx_t*		trx)	/*!< in: transaction handle */
-{
-	dict_table_t*	table;
-	ibool		success;
-	ib_uint64_t	current_lsn;
-	ulint		err		= DB_SUCCESS;
-
-	trx_start_if_not_started(trx);
-
-	trx->op_info = "importing tablespace";
-
-	current_lsn = log_get_lsn();
-
-	/* It is possible, though very improbable, that the lsn's in the
-	tablespace to be imported have risen above the current system lsn, if
-	a lengthy purge, ibuf merge, or rollback was performed on a backup
-	taken with ibbackup. If that is the case, reset page lsn's in the
-	file. We assume that mysqld was shut down after it performed these
-	cleanup operations on the .ibd file, so that it stamped the latest lsn
-	to the FIL_PAGE_FILE_FLUSH_LSN in the first page of the .ibd file.
-
-	TODO: reset also the trx id's in clustered index records and write
-	a new space id to each data page. That would allow us to import clean
-	.ibd files from another MySQL installation. */
-
-	success = fil_reset_too_high_lsns(name, current_lsn);
-
-	if (!success) {
-		ut_print_timestamp(stderr);
-		fputs("  InnoDB: Error: cannot reset lsn's in table ", stderr);
-		ut_print_name(stderr, trx, TRUE, name);
-		fputs("\n"
-		      "InnoDB: in ALTER TABLE ... IMPORT TABLESPACE\n",
-		      stderr);
-
-		err = DB_ERROR;
-
-		row_mysql_lock_data_dictionary(trx);
-
-		goto funct_exit;
-	}
-
-	/* Serialize data dictionary operations with dictionary mutex:
-	no deadlocks can occur then in these operations */
-
-	row_mysql_lock_data_dictionary(trx);
-
-	table = dict_table_get_low(name, DICT_ERR_IGNORE_NONE);
-
-	if (!table) {
-		ut_print_timestamp(stderr);
-		fputs("  InnoDB: table ", stderr);
-		ut_print_name(stderr, trx, TRUE, name);
-		fputs("\n"
-		      "InnoDB: does not exist in the InnoDB data dictionary\n"
-		      "InnoDB: in ALTER TABLE ... IMPORT TABLESPACE\n",
-		      stderr);
-
-		err = DB_TABLE_NOT_FOUND;
-
-		goto funct_exit;
-	}
-
-	if (table->space == 0) {
-		ut_print_timestamp(stderr);
-		fputs("  InnoDB: Error: table ", stderr);
-		ut_print_name(stderr, trx, TRUE, name);
-		fputs("\n"
-		      "InnoDB: is in the system tablespace 0"
-		      " which cannot be imported\n", stderr);
-		err = DB_ERROR;
-
-		goto funct_exit;
-	}
-
-	if (!table->tablespace_discarded) {
-		ut_print_timestamp(stderr);
-		fputs("  InnoDB: Error: you are trying to"
-		      " IMPORT a tablespace\n"
-		      "InnoDB: ", stderr);
-		ut_print_name(stderr, trx, TRUE, name);
-		fputs(", though you have not called DISCARD on it yet\n"
-		      "InnoDB: during the lifetime of the mysqld process!\n",
-		      stderr);
-
-		err = DB_ERROR;
-
-		goto funct_exit;
-	}
-
-	/* Play safe and remove all insert buffer entries, though we should
-	have removed them already when DISCARD TABLESPACE was called */
-
-	ibuf_delete_for_discarded_space(table->space);
-
-	success = fil_open_single_table_tablespace(
-		TRUE, table->space,
-		table->flags == DICT_TF_COMPACT ? 0 : table->flags,
-		table->name);
-	if (success) {
-		table->ibd_file_missing = FALSE;
-		table->tablespace_discarded = FALSE;
-	} else {
-		if (table->ibd_file_missing) {
-			ut_print_timestamp(stderr);
-			fputs("  InnoDB: cannot find or open in the"
-			      " database directory the .ibd file of\n"
-			      "InnoDB: table ", stderr);
-			ut_print_name(stderr, trx, TRUE, name);
-			fputs("\n"
-			      "InnoDB: in ALTER TABLE ... IMPORT TABLESPACE\n",
-			      stderr);
-		}
-
-		err = DB_ERROR;
-	}
-
-funct_exit:
-	trx_commit_for_mysql(trx);
-
-	row_mysql_unlock_data_dictionary(trx);
-
-	trx->op_info = "";
-
-	return((int) err);
-}
-
 /*********************************************************************//**
 Truncates a table for MySQL.
 @return	error code or DB_SUCCESS */
@@ -2810,6 +2822,8 @@ row_truncate_table_for_mysql(
 	ut_ad(rw_lock_own(&dict_operation_lock, RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
+	dict_stats_wait_bg_to_stop_using_table(table, trx);
+
 	/* Check if the table is referenced by foreign key constraints from
 	some other table (not the table itself) */
 
@@ -2870,8 +2884,19 @@ row_truncate_table_for_mysql(
 		ulint	space	= table->space;
 		ulint	flags	= fil_space_get_flags(space);
 
+		if (flags != ULINT_UNDEFINED && srv_lazy_drop_table) {
+			/* The index trees are not freed page by page,
+			and the dictionary objects survive: remove
+			the pages from the adaptive hash index before
+			leaving them in the buffer pool. */
+			btr_search_drop_page_hash_for_table(table);
+		}
+
 		if (flags != ULINT_UNDEFINED
-		    && fil_discard_tablespace(space)) {
+		    && fil_discard_tablespace(
+			    space, srv_lazy_drop_table
+			    ? BUF_REMOVE_NONE
+			    : BUF_REMOVE_ALL_NO_WRITE)) {
 
 			dict_index_t*	index;
 
@@ -3040,6 +3065,14 @@ next_rec:
 		err = DB_ERROR;
 	} else {
 		dict_table_change_id_in_cache(table, new_id);
+
+		/* The indexes are empty now. Do not let the old
+		statistics be loaded from SYS_STATS; the statistics
+		calculated below are stored by the background thread.
+		A failure was reported by dict_stats_eval_sql() and
+		only leaves stale rows behind. */
+
+		dict_stats_delete_table_stats(table, trx);
 	}
 
 	/* Reset auto-increment. */
@@ -3183,6 +3216,8 @@ row_drop_table_for_mysql(
 		goto funct_exit;
 	}
 
+	dict_stats_wait_bg_to_stop_using_table(table, trx);
+
 	/* Check if the table is referenced by foreign key constraints from
 	some other table (not the table itself) */
 
@@ -3391,6 +3426,10 @@ check_next_foreign:
 			   "END;\n"
 			   , FALSE, trx);
 
+	if (err == DB_SUCCESS) {
+		err = dict_stats_delete_table_stats(table, trx);
+	}
+
 	switch (err) {
 		ibool		is_temp;
 		const char*	name_or_path;
@@ -3443,7 +3482,10 @@ check_next_foreign:
 					"InnoDB: of table ");
 				ut_print_name(stderr, trx, TRUE, name);
 				fprintf(stderr, ".\n");
-			} else if (!fil_delete_tablespace(space_id, FALSE)) {
+			} else if (!fil_delete_tablespace(
+					   space_id, srv_lazy_drop_table
+					   ? BUF_REMOVE_NONE
+					   : BUF_REMOVE_FLUSH_NO_WRITE)) {
 				fprintf(stderr,
 					"InnoDB: We removed now the InnoDB"
 					" internal data dictionary entry\n"
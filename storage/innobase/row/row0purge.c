@@ -43,6 +43,7 @@ Created 3/14/1997 Heikki Tuuri
 #include "row0vers.h"
 #include "row0mysql.h"
 #include "log0log.h"
+#include "srv0mon.h"
 
 /*************************************************************************
 IMPORTANT NOTE: Any operation that generates redo MUST check that there
@@ -764,10 +765,14 @@ row_purge(
 		if (node->rec_type == TRX_UNDO_DEL_MARK_REC) {
 			row_purge_del_mark(node);
 
+			MONITOR_INC(MONITOR_PURGE_DEL_MARK_RECORDS);
+
 		} else if (updated_extern
 			   || node->rec_type == TRX_UNDO_UPD_EXIST_REC) {
 
 			row_purge_upd_exist_or_extern(thr, node);
+
+			MONITOR_INC(MONITOR_PURGE_UPD_EXIST_OR_EXTERN);
 		}
 
 		if (node->found_clust) {
@@ -0,0 +1,301 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0quiesce.c
+Quiescing of a table for FLUSH TABLES ... FOR EXPORT
+*******************************************************/
+
+#include "row0quiesce.h"
+#include "dict0dict.h"
+#include "ibuf0ibuf.h"
+#include "buf0lru.h"
+#include "fil0fil.h"
+#include "trx0purge.h"
+#include "mach0data.h"
+#include "os0file.h"
+#include "ut0ut.h"
+
+#include <errno.h>
+
+/*********************************************************************//**
+Writes a 4-byte integer to the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_quiesce_write_4(
+/*================*/
+	FILE*	file,	/*!< in: .cfg file */
+	ulint	val)	/*!< in: value */
+{
+	byte	buf[4];
+
+	mach_write_to_4(buf, val);
+
+	return(fwrite(buf, 1, sizeof buf, file) == sizeof buf);
+}
+
+/*********************************************************************//**
+Writes an 8-byte integer to the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_quiesce_write_8(
+/*================*/
+	FILE*		file,	/*!< in: .cfg file */
+	ib_uint64_t	val)	/*!< in: value */
+{
+	byte	buf[8];
+
+	mach_write_to_8(buf, val);
+
+	return(fwrite(buf, 1, sizeof buf, file) == sizeof buf);
+}
+
+/*********************************************************************//**
+Writes a string to the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_quiesce_write_string(
+/*=====================*/
+	FILE*		file,	/*!< in: .cfg file */
+	const char*	str)	/*!< in: NUL-terminated string */
+{
+	ulint	len = strlen(str) + 1;
+
+	return(row_quiesce_write_4(file, len)
+	       && fwrite(str, 1, len, file) == len);
+}
+
+/*********************************************************************//**
+Writes the definition of an index to the .cfg file.
+@return	TRUE on success */
+static
+ibool
+row_quiesce_write_index(
+/*====================*/
+	FILE*			file,	/*!< in: .cfg file */
+	const dict_index_t*	index)	/*!< in: index */
+{
+	ulint	i;
+
+	if (!row_quiesce_write_8(file, index->id)
+	    || !row_quiesce_write_4(file, index->page)
+	    || !row_quiesce_write_4(file, index->type)
+	    || !row_quiesce_write_4(file, index->n_uniq)
+	    || !row_quiesce_write_4(file, index->n_fields)
+	    || !row_quiesce_write_string(file, index->name)) {
+
+		return(FALSE);
+	}
+
+	for (i = 0; i < index->n_fields; i++) {
+		const dict_field_t*	field
+			= dict_index_get_nth_field(index, i);
+
+		if (!row_quiesce_write_4(file, field->prefix_len)
+		    || !row_quiesce_write_string(file, field->name)) {
+
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Writes the .cfg file of a table.
+@return	DB_SUCCESS or DB_IO_ERROR */
+static
+ulint
+row_quiesce_write_cfg(
+/*==================*/
+	dict_table_t*	table,	/*!< in: table */
+	trx_t*		trx)	/*!< in: transaction */
+{
+	char*			name;
+	FILE*			file;
+	ib_uint64_t		autoinc;
+	const dict_index_t*	index;
+	ulint			i;
+	ibool			success;
+
+	name = fil_make_cfg_name(table->name);
+
+	file = fopen(name, "w+b");
+
+	if (file == NULL) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: cannot create %s: %s\n",
+			name, strerror(errno));
+		mem_free(name);
+
+		return(DB_IO_ERROR);
+	}
+
+	dict_table_autoinc_lock(table);
+	autoinc = dict_table_autoinc_read(table);
+	dict_table_autoinc_unlock(table);
+
+	success = row_quiesce_write_4(file, IB_EXPORT_CFG_VERSION_V1)
+		&& row_quiesce_write_4(file, UNIV_PAGE_SIZE)
+		&& row_quiesce_write_4(file, table->flags)
+		&& row_quiesce_write_8(file, autoinc)
+		&& row_quiesce_write_string(file, table->name)
+		&& row_quiesce_write_4(file, dict_table_get_n_cols(table));
+
+	for (i = 0; success && i < dict_table_get_n_cols(table); i++) {
+		const dict_col_t*	col = dict_table_get_nth_col(table, i);
+
+		success = row_quiesce_write_4(file, col->mtype)
+			&& row_quiesce_write_4(file, col->prtype)
+			&& row_quiesce_write_4(file, col->len)
+			&& row_quiesce_write_string(
+				file, dict_table_get_col_name(table, i));
+	}
+
+	success = success
+		&& row_quiesce_write_4(file, UT_LIST_GET_LEN(table->indexes));
+
+	for (index = dict_table_get_first_index(table);
+	     success && index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		success = row_quiesce_write_index(file, index);
+	}
+
+	success = success && fflush(file) == 0;
+
+	if (fclose(file) != 0) {
+		success = FALSE;
+	}
+
+	if (!success) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: cannot write %s: %s\n",
+			name, strerror(errno));
+		os_file_delete_if_exists(name);
+		mem_free(name);
+
+		return(DB_IO_ERROR);
+	}
+
+	ut_print_timestamp(stderr);
+	fputs("  InnoDB: Wrote the metadata of table ", stderr);
+	ut_print_name(stderr, trx, TRUE, table->name);
+	fprintf(stderr, " to %s\n", name);
+
+	mem_free(name);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Quiesces a table for FLUSH TABLES ... FOR EXPORT: stops purge, merges
+the change buffer entries of the table, writes the dirty pages of the
+table to its .ibd file and writes the .cfg file.  The caller must
+prevent writes to the table.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_quiesce_table_start(
+/*====================*/
+	dict_table_t*	table,	/*!< in/out: table */
+	trx_t*		trx)	/*!< in: transaction of the FLUSH TABLES
+				statement */
+{
+	ulint	err;
+
+	ut_a(table->quiesce == DICT_QUIESCE_NONE);
+
+	if (table->space == 0) {
+		/* Only tables in their own tablespace can be
+		exported. */
+
+		return(DB_UNSUPPORTED);
+	}
+
+	table->quiesce = DICT_QUIESCE_START;
+
+	/* Purge could still modify the table through delete-marked
+	records that are waiting for it.  The 5.5 purge cannot skip a
+	table, so purge stops for all tables until UNLOCK TABLES and
+	the history list grows meanwhile. */
+
+	trx_purge_stop();
+
+	ut_print_timestamp(stderr);
+	fputs("  InnoDB: Export of table ", stderr);
+	ut_print_name(stderr, trx, TRUE, table->name);
+	fputs(" started, purge stopped until UNLOCK TABLES\n", stderr);
+
+	/* The change buffer must not hold entries for the pages of
+	the file that is copied. */
+
+	ibuf_merge_space(table->space);
+
+	buf_LRU_flush_or_remove_pages(table->space, BUF_REMOVE_FLUSH_WRITE);
+
+	fil_flush(table->space);
+
+	err = row_quiesce_write_cfg(table, trx);
+
+	if (err != DB_SUCCESS) {
+		trx_purge_run();
+
+		table->quiesce = DICT_QUIESCE_NONE;
+
+		return(err);
+	}
+
+	table->quiesce = DICT_QUIESCE_COMPLETE;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Ends the quiesced state of a table at UNLOCK TABLES: deletes the .cfg
+file and resumes purge. */
+UNIV_INTERN
+void
+row_quiesce_table_complete(
+/*=======================*/
+	dict_table_t*	table,	/*!< in/out: quiesced table */
+	trx_t*		trx)	/*!< in: transaction of the FLUSH TABLES
+				statement */
+{
+	char*	name;
+
+	ut_a(table->quiesce == DICT_QUIESCE_COMPLETE);
+
+	name = fil_make_cfg_name(table->name);
+
+	os_file_delete_if_exists(name);
+
+	mem_free(name);
+
+	trx_purge_run();
+
+	table->quiesce = DICT_QUIESCE_NONE;
+
+	ut_print_timestamp(stderr);
+	fputs("  InnoDB: Export of table ", stderr);
+	ut_print_name(stderr, trx, TRUE, table->name);
+	fputs(" completed, purge resumed\n", stderr);
+}
@@ -56,6 +56,7 @@ Created 12/19/1997 Heikki Tuuri
 #include "row0mysql.h"
 #include "read0read.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "ha_prototypes.h"
 #include "m_string.h" /* for my_sys.h */
 #include "my_sys.h" /* DEBUG_SYNC_C */
@@ -2693,6 +2694,49 @@ row_sel_field_store_in_mysql_format(
 	}
 }
 
+/**************************************************************//**
+Stores a column value and its SQL NULL flag in a row in the MySQL
+format. */
+UNIV_INLINE
+void
+row_sel_store_mysql_field(
+/*======================*/
+	byte*			mysql_rec,	/*!< out: row in the MySQL
+						format */
+	const row_prebuilt_t*	prebuilt,	/*!< in: prebuilt struct */
+	const mysql_row_templ_t*templ,		/*!< in: template of the
+						column */
+	const byte*		data,		/*!< in: column data */
+	ulint			len)		/*!< in: length of data, or
+						UNIV_SQL_NULL */
+{
+	if (len != UNIV_SQL_NULL) {
+		row_sel_field_store_in_mysql_format(
+			mysql_rec + templ->mysql_col_offset,
+			templ, data, len);
+
+		if (templ->mysql_null_bit_mask) {
+			/* It is a nullable column with a non-NULL
+			value */
+			mysql_rec[templ->mysql_null_byte_offset]
+				&= ~(byte) templ->mysql_null_bit_mask;
+		}
+	} else {
+		/* MySQL assumes that the field for an SQL
+		NULL value is set to the default value. */
+
+		UNIV_MEM_ASSERT_RW(prebuilt->default_rec
+				   + templ->mysql_col_offset,
+				   templ->mysql_col_len);
+		mysql_rec[templ->mysql_null_byte_offset]
+			|= (byte) templ->mysql_null_bit_mask;
+		memcpy(mysql_rec + templ->mysql_col_offset,
+		       (const byte*) prebuilt->default_rec
+		       + templ->mysql_col_offset,
+		       templ->mysql_col_len);
+	}
+}
+
 /**************************************************************//**
 Convert a row in the Innobase format to a row in the MySQL format.
 Note that the template in prebuilt may advise us to copy only a few
@@ -2810,40 +2854,68 @@ row_sel_store_mysql_rec(
 			}
 		}
 
-		if (len != UNIV_SQL_NULL) {
-			row_sel_field_store_in_mysql_format(
-				mysql_rec + templ->mysql_col_offset,
-				templ, data, len);
+		row_sel_store_mysql_field(mysql_rec, prebuilt, templ,
+					  data, len);
 
-			/* Cleanup */
-			if (extern_field_heap) {
-				mem_heap_free(extern_field_heap);
-				extern_field_heap = NULL;
-			}
+		/* Cleanup */
+		if (extern_field_heap) {
+			mem_heap_free(extern_field_heap);
+			extern_field_heap = NULL;
+		}
+	}
 
-			if (templ->mysql_null_bit_mask) {
-				/* It is a nullable column with a non-NULL
-				value */
-				mysql_rec[templ->mysql_null_byte_offset]
-					&= ~(byte) templ->mysql_null_bit_mask;
-			}
-		} else {
-			/* MySQL assumes that the field for an SQL
-			NULL value is set to the default value. */
+	return(TRUE);
+}
 
-			UNIV_MEM_ASSERT_RW(prebuilt->default_rec
-					   + templ->mysql_col_offset,
-					   templ->mysql_col_len);
-			mysql_rec[templ->mysql_null_byte_offset]
-				|= (byte) templ->mysql_null_bit_mask;
-			memcpy(mysql_rec + templ->mysql_col_offset,
-			       (const byte*) prebuilt->default_rec
-			       + templ->mysql_col_offset,
-			       templ->mysql_col_len);
+/**************************************************************//**
+Checks the index condition that was pushed down by MySQL on a secondary
+index record. The columns of the index that the template asks for are
+stored in mysql_rec first, because the condition is evaluated on them.
+@return	ICP_NO_MATCH, ICP_MATCH or ICP_OUT_OF_RANGE */
+static
+enum icp_result
+row_search_idx_cond_check(
+/*======================*/
+	byte*		mysql_rec,	/*!< out: row in the MySQL format,
+					with the index columns filled in */
+	row_prebuilt_t*	prebuilt,	/*!< in: prebuilt struct */
+	const rec_t*	rec,		/*!< in: record in prebuilt->index;
+					must be protected by a page latch */
+	const ulint*	offsets)	/*!< in: array returned by
+					rec_get_offsets(rec) */
+{
+	ulint	i;
+
+	if (!prebuilt->idx_cond) {
+
+		return(ICP_MATCH);
+	}
+
+	ut_ad(rec_offs_validate(rec, prebuilt->index, offsets));
+	ut_ad(!dict_index_is_clust(prebuilt->index));
+
+	for (i = 0; i < prebuilt->n_template; i++) {
+		const mysql_row_templ_t*templ = prebuilt->mysql_template + i;
+		const byte*		data;
+		ulint			len;
+
+		if (templ->icp_rec_field_no == ULINT_UNDEFINED) {
+
+			continue;
 		}
+
+		/* Secondary index records never contain externally
+		stored columns */
+		ut_ad(!rec_offs_nth_extern(offsets, templ->icp_rec_field_no));
+
+		data = rec_get_nth_field(rec, offsets,
+					 templ->icp_rec_field_no, &len);
+
+		row_sel_store_mysql_field(mysql_rec, prebuilt, templ,
+					  data, len);
 	}
 
-	return(TRUE);
+	return(innobase_index_cond(prebuilt->idx_cond));
 }
 
 /*********************************************************************//**
@@ -3286,28 +3358,39 @@ row_sel_push_cache_row_for_mysql(
 	byte*	buf;
 	ulint	i;
 
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
+	ut_ad(prebuilt->fetch_cache_limit <= MYSQL_FETCH_CACHE_MAX_SIZE);
 	ut_ad(rec_offs_validate(rec, NULL, offsets));
 	ut_ad(!rec_get_deleted_flag(rec, rec_offs_comp(offsets)));
 	ut_a(!prebuilt->templ_contains_blob);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache == NULL) {
+		prebuilt->fetch_cache = mem_alloc(
+			MYSQL_FETCH_CACHE_MAX_SIZE
+			* sizeof *prebuilt->fetch_cache);
+	}
+
+	/* Allocate the row buffers of the fetch cache as the batches
+	grow, so that short scans do not pay for the long ones */
 
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
+	for (i = prebuilt->fetch_cache_allocated;
+	     i < prebuilt->fetch_cache_limit; i++) {
 
-			/* A user has reported memory corruption in these
-			buffers in Linux. Put magic numbers there to help
-			to track a possible bug. */
+		/* A user has reported memory corruption in these
+		buffers in Linux. Put magic numbers there to help
+		to track a possible bug. */
 
-			buf = mem_alloc(prebuilt->mysql_row_len + 8);
+		buf = mem_alloc(prebuilt->mysql_row_len + 8);
 
-			prebuilt->fetch_cache[i] = buf + 4;
+		prebuilt->fetch_cache[i] = buf + 4;
 
-			mach_write_to_4(buf, ROW_PREBUILT_FETCH_MAGIC_N);
-			mach_write_to_4(buf + 4 + prebuilt->mysql_row_len,
-					ROW_PREBUILT_FETCH_MAGIC_N);
-		}
+		mach_write_to_4(buf, ROW_PREBUILT_FETCH_MAGIC_N);
+		mach_write_to_4(buf + 4 + prebuilt->mysql_row_len,
+				ROW_PREBUILT_FETCH_MAGIC_N);
+	}
+
+	if (prebuilt->fetch_cache_allocated < prebuilt->fetch_cache_limit) {
+		prebuilt->fetch_cache_allocated = prebuilt->fetch_cache_limit;
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
@@ -3325,6 +3408,32 @@ row_sel_push_cache_row_for_mysql(
 	return(TRUE);
 }
 
+/********************************************************************//**
+Doubles the number of rows to cache in the next batch of the fetch cache
+after a batch filled it, up to MYSQL_FETCH_CACHE_MAX_SIZE rows or
+MYSQL_FETCH_CACHE_MAX_BYTES bytes. A long scan thus converts its rows
+in batches of hundreds under one page latch and mini-transaction, while
+a short one keeps using little memory. */
+UNIV_INLINE
+void
+row_sel_grow_fetch_cache(
+/*=====================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	max_size;
+
+	max_size = MYSQL_FETCH_CACHE_MAX_BYTES / (prebuilt->mysql_row_len + 8);
+
+	if (max_size > MYSQL_FETCH_CACHE_MAX_SIZE) {
+		max_size = MYSQL_FETCH_CACHE_MAX_SIZE;
+	}
+
+	if (prebuilt->fetch_cache_limit < max_size) {
+		prebuilt->fetch_cache_limit = ut_min(
+			2 * prebuilt->fetch_cache_limit, max_size);
+	}
+}
+
 /*********************************************************************//**
 Tries to do a shortcut to fetch a clustered index record with a unique key,
 using the hash index if possible (not always). We assume that the search
@@ -3399,6 +3508,56 @@ row_sel_try_search_shortcut_for_mysql(
 	return(SEL_FOUND);
 }
 
+/********************************************************************//**
+Reads ahead the leaf pages that a scan will visit next, in key order, when
+the scan has entered a new leaf page and has consumed half of the pages
+that were read ahead before.  See innodb_logical_read_ahead. */
+static
+void
+row_sel_read_ahead_logical(
+/*=======================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct; the
+					cursor position must be stored */
+	ibool		moves_up,	/*!< in: TRUE if the scan moves to
+					the next records */
+	ulint		page_no,	/*!< in: leaf page of the cursor */
+	ulint		n_pages)	/*!< in: innodb_logical_read_ahead */
+{
+	dict_index_t*	index	= prebuilt->index;
+	ulint*		page_nos;
+	ulint		n;
+
+	if (page_no == prebuilt->lra_page_no) {
+
+		return;
+	}
+
+	prebuilt->lra_page_no = page_no;
+
+	if (prebuilt->lra_n_pages > 0) {
+		prebuilt->lra_n_pages--;
+	}
+
+	if (prebuilt->lra_n_pages > n_pages / 2) {
+
+		return;
+	}
+
+	page_nos = mem_alloc(n_pages * sizeof *page_nos);
+
+	n = btr_pcur_get_next_leaves(&prebuilt->pcur, moves_up,
+				     page_nos, n_pages);
+
+	buf_read_ahead_logical(dict_index_get_space(index),
+			       dict_table_zip_size(index->table),
+			       page_nos, n);
+
+	/* The pages that were already in the buffer pool count, too */
+	prebuilt->lra_n_pages = n;
+
+	mem_free(page_nos);
+}
+
 /********************************************************************//**
 Searches for rows in the database. This is used in the interface to
 MySQL. This function opens a cursor, and also implements fetch next
@@ -3461,6 +3620,8 @@ row_search_for_mysql(
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets				= offsets_;
 	ibool		table_lock_waited		= FALSE;
+	ulint		lra_n_pages;
+	ulint		lra_page_no			= FIL_NULL;
 
 	rec_offs_init(offsets_);
 
@@ -3576,6 +3737,9 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+		prebuilt->lra_page_no = FIL_NULL;
+		prebuilt->lra_n_pages = 0;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3600,6 +3764,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_pop_cached_row_for_mysql(buf, prebuilt);
@@ -3607,12 +3772,14 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched++;
 
 			srv_n_rows_read++;
+			srv_n_rows_read_cached++;
 			err = DB_SUCCESS;
 			goto func_exit;
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -4393,7 +4560,24 @@ no_gap_lock:
 
 			if (!lock_sec_rec_cons_read_sees(
 				    rec, trx->read_view)) {
-				goto requires_clust_rec;
+				/* The version of the row that the read
+				view sees has an index record of its own,
+				so we may skip the clustered index lookup
+				when this one does not match the index
+				condition. */
+				switch (row_search_idx_cond_check(
+						buf, prebuilt,
+						rec, offsets)) {
+				case ICP_NO_MATCH:
+					goto next_rec;
+				case ICP_OUT_OF_RANGE:
+					err = DB_RECORD_NOT_FOUND;
+					goto idx_cond_failed;
+				case ICP_MATCH:
+					goto requires_clust_rec;
+				}
+
+				ut_error;
 			}
 		}
 	}
@@ -4440,6 +4624,30 @@ no_gap_lock:
 		goto next_rec;
 	}
 
+	/* Check the pushed index condition before looking up the
+	clustered index record. */
+
+	switch (row_search_idx_cond_check(buf, prebuilt, rec, offsets)) {
+	case ICP_NO_MATCH:
+		if ((srv_locks_unsafe_for_binlog
+		     || trx->isolation_level <= TRX_ISO_READ_COMMITTED)
+		    && prebuilt->select_lock_type != LOCK_NONE
+		    && !did_semi_consistent_read) {
+
+			/* No need to keep a lock on a record that does
+			not match if we do not want to use next-key
+			locking. */
+
+			row_unlock_for_mysql(prebuilt, TRUE);
+		}
+		goto next_rec;
+	case ICP_OUT_OF_RANGE:
+		err = DB_RECORD_NOT_FOUND;
+		goto idx_cond_failed;
+	case ICP_MATCH:
+		break;
+	}
+
 	/* Get the clustered index record if needed, if we did not do the
 	search using the clustered index. */
 
@@ -4554,7 +4762,11 @@ requires_clust_rec:
 			level, not here. */
 			ut_a(trx->isolation_level == TRX_ISO_READ_UNCOMMITTED);
 		} else if (prebuilt->n_fetch_cached
-			   == MYSQL_FETCH_CACHE_SIZE) {
+			   == prebuilt->fetch_cache_limit) {
+
+			/* The scan goes on past a full batch: make the
+			next one bigger. */
+			row_sel_grow_fetch_cache(prebuilt);
 
 			goto got_row;
 		}
@@ -4614,6 +4826,9 @@ requires_clust_rec:
 	/* From this point on, 'offsets' are invalid. */
 
 got_row:
+	err = DB_SUCCESS;
+
+idx_cond_failed:
 	/* We have an optimization to save CPU time: if this is a consistent
 	read on a unique condition on the clustered index, then we do not
 	store the pcur position, because any fetch next or prev will anyway
@@ -4630,8 +4845,6 @@ got_row:
 		btr_pcur_store_position(pcur, &mtr);
 	}
 
-	err = DB_SUCCESS;
-
 	goto normal_return;
 
 next_rec:
@@ -4777,6 +4990,17 @@ normal_return:
 	/*-------------------------------------------------------------*/
 	que_thr_stop_for_mysql_no_error(thr, trx);
 
+	lra_n_pages = unique_search
+		? 0 : thd_logical_read_ahead(trx->mysql_thd);
+
+	if (lra_n_pages > 0) {
+		/* The position was stored above: remember the leaf page
+		while it is still latched */
+		ut_ad(pcur->old_stored == BTR_PCUR_OLD_STORED);
+
+		lra_page_no = buf_block_get_page_no(btr_pcur_get_block(pcur));
+	}
+
 	mtr_commit(&mtr);
 
 	if (prebuilt->n_fetch_cached > 0) {
@@ -4786,6 +5010,11 @@ normal_return:
 		err = DB_SUCCESS;
 	}
 
+	if (lra_n_pages > 0 && err == DB_SUCCESS) {
+		row_sel_read_ahead_logical(prebuilt, moves_up,
+					   lra_page_no, lra_n_pages);
+	}
+
 #ifdef UNIV_SEARCH_DEBUG
 	/*	fputs("Using ", stderr);
 	dict_index_name_print(stderr, index);
@@ -35,6 +35,7 @@ Created 2/25/1997 Heikki Tuuri
 #include "trx0undo.h"
 #include "trx0roll.h"
 #include "btr0btr.h"
+#include "btr0bulk.h"
 #include "mach0data.h"
 #include "row0undo.h"
 #include "row0vers.h"
@@ -250,7 +251,8 @@ retry:
 }
 
 /***********************************************************//**
-Parses the row reference and other info in a fresh insert undo record. */
+Parses the row reference and other info in a fresh insert undo record,
+or the table of a bulk insert undo record, which has no row reference. */
 static
 void
 row_undo_ins_parse_undo_rec(
@@ -269,7 +271,7 @@ row_undo_ins_parse_undo_rec(
 
 	ptr = trx_undo_rec_get_pars(node->undo_rec, &type, &dummy,
 				    &dummy_extern, &undo_no, &table_id);
-	ut_ad(type == TRX_UNDO_INSERT_REC);
+	ut_ad(type == TRX_UNDO_INSERT_REC || type == TRX_UNDO_EMPTY);
 	node->rec_type = type;
 
 	node->update = NULL;
@@ -279,6 +281,7 @@ row_undo_ins_parse_undo_rec(
 	if (UNIV_UNLIKELY(node->table == NULL)) {
 	} else if (UNIV_UNLIKELY(node->table->ibd_file_missing)) {
 		node->table = NULL;
+	} else if (type == TRX_UNDO_EMPTY) {
 	} else {
 		clust_index = dict_table_get_first_index(node->table);
 
@@ -303,7 +306,8 @@ Undoes a fresh insert of a row to a table. A fresh insert means that
 the same clustered index unique key did not have any record, even delete
 marked, at the time of the insert.  InnoDB is eager in a rollback:
 if it figures out that an index record will be removed in the purge
-anyway, it will remove it in the rollback.
+anyway, it will remove it in the rollback. A bulk insert into an empty
+table is undone by emptying every index tree of the table.
 @return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
 UNIV_INTERN
 ulint
@@ -316,6 +320,25 @@ row_undo_ins(
 
 	row_undo_ins_parse_undo_rec(node);
 
+	if (node->table && node->rec_type == TRX_UNDO_EMPTY) {
+		/* The table was empty before the bulk insert, and
+		the rows inserted after it have been rolled back. */
+		node->index = dict_table_get_first_index(node->table);
+
+		dict_table_skip_corrupt_index(node->index);
+
+		while (node->index != NULL) {
+			log_free_check();
+			btr_bulk_empty(node->index);
+
+			dict_table_next_uncorrupted_index(node->index);
+		}
+
+		trx_undo_rec_release(node->trx, node->undo_no);
+
+		return(DB_SUCCESS);
+	}
+
 	if (!node->table || !row_undo_search_clust_to_pcur(node)) {
 		trx_undo_rec_release(node->trx, node->undo_no);
 
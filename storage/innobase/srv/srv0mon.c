@@ -0,0 +1,720 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file srv/srv0mon.c
+Server monitor counters for INFORMATION_SCHEMA.INNODB_METRICS
+*******************************************************/
+
+#ifndef UNIV_HOTBACKUP
+#include "srv0mon.h"
+#include "srv0srv.h"
+#include "buf0buf.h"
+#include "btr0cur.h"
+#include "ibuf0ibuf.h"
+#include "log0log.h"
+#include "trx0sys.h"
+#include "trx0purge.h"
+#include "os0file.h"
+#include "fil0fil.h"
+#include "ut0ut.h"
+
+/** Static descriptions of the counters, indexed by monitor_id_t */
+static const monitor_info_t	innodb_counter_info[] =
+{
+	/* ========== Buffer pool ========== */
+	{"module_buffer", "buffer", "Buffer Manager Module",
+	 MONITOR_MODULE, MONITOR_MODULE_BUFFER},
+
+	{"buffer_pool_size", "buffer",
+	 "Buffer pool size in bytes",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_BUF_POOL_SIZE},
+
+	{"buffer_pool_reads", "buffer",
+	 "Number of reads directly from disk (innodb_buffer_pool_reads)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READS},
+
+	{"buffer_pool_read_requests", "buffer",
+	 "Number of logical read requests"
+	 " (innodb_buffer_pool_read_requests)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_REQUESTS},
+
+	{"buffer_pool_write_requests", "buffer",
+	 "Number of write requests (innodb_buffer_pool_write_requests)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_WRITE_REQUEST},
+
+	{"buffer_pool_wait_free", "buffer",
+	 "Number of times waited for free buffer"
+	 " (innodb_buffer_pool_wait_free)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_WAIT_FREE},
+
+	{"buffer_pool_read_ahead", "buffer",
+	 "Number of pages read as read ahead"
+	 " (innodb_buffer_pool_read_ahead)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_AHEAD},
+
+	{"buffer_pool_read_ahead_evicted", "buffer",
+	 "Read-ahead pages evicted without being accessed"
+	 " (innodb_buffer_pool_read_ahead_evicted)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED},
+
+	{"buffer_pool_read_ahead_logical", "buffer",
+	 "Number of pages read as logical read ahead"
+	 " (innodb_buffer_pool_read_ahead_logical)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL},
+
+	{"buffer_pool_read_ahead_logical_hits", "buffer",
+	 "Logical read-ahead pages that were accessed"
+	 " (innodb_buffer_pool_read_ahead_logical_hits)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_HITS},
+
+	{"buffer_pool_read_ahead_logical_evicted", "buffer",
+	 "Logical read-ahead pages evicted without being accessed"
+	 " (innodb_buffer_pool_read_ahead_logical_evicted)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_EVICTED},
+
+	{"buffer_pool_pages_total", "buffer",
+	 "Total buffer pool size in pages (innodb_buffer_pool_pages_total)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_BUF_POOL_PAGE_TOTAL},
+
+	{"buffer_pool_pages_data", "buffer",
+	 "Buffer pages containing data (innodb_buffer_pool_pages_data)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_BUF_POOL_PAGES_DATA},
+
+	{"buffer_pool_pages_dirty", "buffer",
+	 "Buffer pages currently dirty (innodb_buffer_pool_pages_dirty)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_BUF_POOL_PAGES_DIRTY},
+
+	{"buffer_pool_pages_free", "buffer",
+	 "Buffer pages currently free (innodb_buffer_pool_pages_free)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_BUF_POOL_PAGES_FREE},
+
+	{"buffer_pool_pages_flushed", "buffer",
+	 "Number of pages flushed (innodb_buffer_pool_pages_flushed)",
+	 MONITOR_EXISTING, MONITOR_OVLD_BUF_POOL_PAGES_FLUSHED},
+
+	{"buffer_pages_created", "buffer",
+	 "Number of pages created (innodb_pages_created)",
+	 MONITOR_EXISTING, MONITOR_OVLD_PAGE_CREATED},
+
+	{"buffer_pages_written", "buffer",
+	 "Number of pages written (innodb_pages_written)",
+	 MONITOR_EXISTING, MONITOR_OVLD_PAGES_WRITTEN},
+
+	{"buffer_pages_read", "buffer",
+	 "Number of pages read (innodb_pages_read)",
+	 MONITOR_EXISTING, MONITOR_OVLD_PAGES_READ},
+
+	/* ========== Redo log ========== */
+	{"module_log", "recovery", "Recovery Module",
+	 MONITOR_MODULE, MONITOR_MODULE_LOG},
+
+	{"log_lsn_current", "recovery",
+	 "Current LSN value",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_LSN_CURRENT},
+
+	{"log_lsn_last_flush", "recovery",
+	 "LSN of the last log flush to disk",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_LSN_FLUSHDISK},
+
+	{"log_lsn_last_checkpoint", "recovery",
+	 "LSN at the last checkpoint",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_LSN_CHECKPOINT},
+
+	{"log_lsn_checkpoint_age", "recovery",
+	 "Current LSN value minus LSN at the last checkpoint",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_CHECKPOINT_AGE},
+
+	{"log_waits", "recovery",
+	 "Number of log waits due to small log buffer (innodb_log_waits)",
+	 MONITOR_EXISTING, MONITOR_OVLD_LOG_WAITS},
+
+	{"log_write_requests", "recovery",
+	 "Number of log write requests (innodb_log_write_requests)",
+	 MONITOR_EXISTING, MONITOR_OVLD_LOG_WRITE_REQUEST},
+
+	{"log_writes", "recovery",
+	 "Number of log writes (innodb_log_writes)",
+	 MONITOR_EXISTING, MONITOR_OVLD_LOG_WRITES},
+
+	/* ========== Locks ========== */
+	{"module_lock", "lock", "Lock Module",
+	 MONITOR_MODULE, MONITOR_MODULE_LOCK},
+
+	{"lock_deadlocks", "lock",
+	 "Number of deadlocks",
+	 MONITOR_EXISTING, MONITOR_OVLD_DEADLOCK},
+
+	{"lock_timeouts", "lock",
+	 "Number of lock timeouts",
+	 MONITOR_NONE, MONITOR_TIMEOUT},
+
+	{"lock_row_lock_current_waits", "lock",
+	 "Number of row locks currently being waited for"
+	 " (innodb_row_lock_current_waits)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_ROW_LOCK_CURRENT_WAIT},
+
+	{"lock_row_lock_waits", "lock",
+	 "Number of times a row lock had to be waited for"
+	 " (innodb_row_lock_waits)",
+	 MONITOR_EXISTING, MONITOR_OVLD_ROW_LOCK_WAIT},
+
+	{"lock_row_lock_time", "lock",
+	 "Time spent in acquiring row locks, in milliseconds"
+	 " (innodb_row_lock_time)",
+	 MONITOR_EXISTING, MONITOR_OVLD_LOCK_WAIT_TIME},
+
+	{"lock_row_lock_time_max", "lock",
+	 "The maximum time to acquire a row lock, in milliseconds"
+	 " (innodb_row_lock_time_max)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_LOCK_MAX_WAIT_TIME},
+
+	/* ========== Purge ========== */
+	{"module_purge", "purge", "Purge Module",
+	 MONITOR_MODULE, MONITOR_MODULE_PURGE},
+
+	{"purge_invoked", "purge",
+	 "Number of times purge was invoked",
+	 MONITOR_NONE, MONITOR_PURGE_INVOKED},
+
+	{"purge_undo_log_pages", "purge",
+	 "Number of undo log pages handled by the purge",
+	 MONITOR_EXISTING, MONITOR_OVLD_PURGE_UNDO_LOG_PAGES},
+
+	{"purge_del_mark_records", "purge",
+	 "Number of delete-marked rows purged",
+	 MONITOR_NONE, MONITOR_PURGE_DEL_MARK_RECORDS},
+
+	{"purge_upd_exist_or_extern_records", "purge",
+	 "Number of purges on updates of existing records and"
+	 " updates on delete marked record with externally stored field",
+	 MONITOR_NONE, MONITOR_PURGE_UPD_EXIST_OR_EXTERN},
+
+	{"trx_rseg_history_len", "transaction",
+	 "Length of the TRX_RSEG_HISTORY list",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_RSEG_HISTORY_LEN},
+
+	/* ========== Change buffer ========== */
+	{"module_ibuf_system", "change_buffer", "InnoDB Change Buffer",
+	 MONITOR_MODULE, MONITOR_MODULE_IBUF_SYSTEM},
+
+	{"ibuf_merges", "change_buffer",
+	 "Number of change buffer merges",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGES},
+
+	{"ibuf_merges_insert", "change_buffer",
+	 "Number of inserted records merged by change buffering",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_INSERT},
+
+	{"ibuf_merges_delete_mark", "change_buffer",
+	 "Number of deleted records merged by change buffering",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_DELETE},
+
+	{"ibuf_merges_delete", "change_buffer",
+	 "Number of purge records merged by change buffering",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_PURGE},
+
+	{"ibuf_merges_discard_insert", "change_buffer",
+	 "Number of insert merged operations discarded",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_DISCARD_INSERT},
+
+	{"ibuf_merges_discard_delete_mark", "change_buffer",
+	 "Number of deleted merged operations discarded",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_DISCARD_DELETE},
+
+	{"ibuf_merges_discard_delete", "change_buffer",
+	 "Number of purge merged  operations discarded",
+	 MONITOR_EXISTING, MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE},
+
+	{"ibuf_size", "change_buffer",
+	 "Change buffer size in pages",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_IBUF_SIZE},
+
+	/* ========== Adaptive hash index ========== */
+	{"module_adaptive_hash", "adaptive_hash_index", "Adaptive Hash Index",
+	 MONITOR_MODULE, MONITOR_MODULE_ADAPTIVE_HASH},
+
+	{"adaptive_hash_searches", "adaptive_hash_index",
+	 "Number of successful searches using Adaptive Hash Index",
+	 MONITOR_EXISTING, MONITOR_OVLD_ADAPTIVE_HASH_SEARCH},
+
+	{"adaptive_hash_searches_btree", "adaptive_hash_index",
+	 "Number of searches using B-tree on an index search",
+	 MONITOR_EXISTING, MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE},
+
+	{"adaptive_hash_pages_added", "adaptive_hash_index",
+	 "Number of index pages on which the Adaptive Hash Index is built",
+	 MONITOR_NONE, MONITOR_ADAPTIVE_HASH_PAGE_ADDED},
+
+	{"adaptive_hash_pages_removed", "adaptive_hash_index",
+	 "Number of index pages whose corresponding Adaptive Hash Index"
+	 " entries were removed",
+	 MONITOR_NONE, MONITOR_ADAPTIVE_HASH_PAGE_REMOVED},
+
+	/* ========== File I/O ========== */
+	{"module_os", "os", "OS Level Operation",
+	 MONITOR_MODULE, MONITOR_MODULE_OS},
+
+	{"os_data_reads", "os",
+	 "Number of reads initiated (innodb_data_reads)",
+	 MONITOR_EXISTING, MONITOR_OVLD_OS_FILE_READ},
+
+	{"os_data_writes", "os",
+	 "Number of writes initiated (innodb_data_writes)",
+	 MONITOR_EXISTING, MONITOR_OVLD_OS_FILE_WRITE},
+
+	{"os_data_fsyncs", "os",
+	 "Number of fsync() calls (innodb_data_fsyncs)",
+	 MONITOR_EXISTING, MONITOR_OVLD_OS_FSYNC},
+
+	{"os_pending_reads", "os",
+	 "Number of reads pending",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_OS_PENDING_READS},
+
+	{"os_pending_writes", "os",
+	 "Number of writes pending",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_OS_PENDING_WRITES},
+
+	{"os_log_bytes_written", "os",
+	 "Bytes of log written (innodb_os_log_written)",
+	 MONITOR_EXISTING, MONITOR_OVLD_OS_LOG_WRITTEN},
+
+	{"os_log_fsyncs", "os",
+	 "Number of fsync log writes (innodb_os_log_fsyncs)",
+	 MONITOR_EXISTING, MONITOR_OVLD_OS_LOG_FSYNC},
+
+	{"os_log_pending_fsyncs", "os",
+	 "Number of pending fsync write (innodb_os_log_pending_fsyncs)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_OS_LOG_PENDING_FSYNC},
+
+	{"os_log_pending_writes", "os",
+	 "Number of pending log file writes (innodb_os_log_pending_writes)",
+	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT,
+	 MONITOR_OVLD_OS_LOG_PENDING_WRITES}
+};
+
+/** Bitmap of the counters that are on */
+UNIV_INTERN ulint	monitor_set_tbl[(NUM_MONITOR + MONITOR_BITS_ULINT - 1)
+				/ MONITOR_BITS_ULINT];
+
+/** Dynamic values of the counters */
+UNIV_INTERN monitor_value_t	innodb_counter_value[NUM_MONITOR];
+
+/** Mutex protecting the innodb_counter_value[] fields that
+srv_mon_get_value() and srv_mon_set_option() update.  No other latch
+is acquired while it is held. */
+static mutex_t			srv_mon_mutex;
+
+#ifdef UNIV_PFS_MUTEX
+/* Key to register srv_mon_mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	srv_mon_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
+/****************************************************************//**
+Initialize the monitor counters.  All counters are off. */
+UNIV_INTERN
+void
+srv_mon_create(void)
+/*================*/
+{
+	ulint	i;
+
+	/* The table must list every monitor_id_t in order. */
+	ut_a(UT_ARR_SIZE(innodb_counter_info) == NUM_MONITOR);
+
+	for (i = 0; i < NUM_MONITOR; i++) {
+		ut_a(innodb_counter_info[i].monitor_id == (monitor_id_t) i);
+	}
+
+	memset(monitor_set_tbl, 0, sizeof monitor_set_tbl);
+	memset(innodb_counter_value, 0, sizeof innodb_counter_value);
+
+	mutex_create(srv_mon_mutex_key, &srv_mon_mutex, SYNC_NO_ORDER_CHECK);
+}
+
+/****************************************************************//**
+Get the static description of a monitor counter or module.
+@return	description */
+UNIV_INTERN
+const monitor_info_t*
+srv_mon_get_info(
+/*=============*/
+	monitor_id_t	monitor_id)	/*!< in: counter or module */
+{
+	ut_a(monitor_id < NUM_MONITOR);
+
+	return(&innodb_counter_info[monitor_id]);
+}
+
+/****************************************************************//**
+Read the status variable that a MONITOR_EXISTING counter reports.
+@return	current value of the status variable */
+static
+mon_type_t
+srv_mon_get_existing(
+/*=================*/
+	monitor_id_t	monitor_id)	/*!< in: MONITOR_EXISTING counter */
+{
+	buf_pool_stat_t	stat;
+	ibuf_stat_t	ibuf_stat;
+	ulint		LRU_len;
+	ulint		free_len;
+	ulint		flush_list_len;
+
+	switch (monitor_id) {
+	case MONITOR_OVLD_BUF_POOL_SIZE:
+		return((mon_type_t) srv_buf_pool_curr_size);
+	case MONITOR_OVLD_BUF_POOL_READS:
+		return((mon_type_t) srv_buf_pool_reads);
+	case MONITOR_OVLD_BUF_POOL_READ_REQUESTS:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_page_gets);
+	case MONITOR_OVLD_BUF_POOL_WRITE_REQUEST:
+		return((mon_type_t) srv_buf_pool_write_requests);
+	case MONITOR_OVLD_BUF_POOL_WAIT_FREE:
+		return((mon_type_t) srv_buf_pool_wait_free);
+	case MONITOR_OVLD_BUF_POOL_READ_AHEAD:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_ra_pages_read);
+	case MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_ra_pages_evicted);
+	case MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_ra_pages_read_logical);
+	case MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_HITS:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_ra_pages_logical_hit);
+	case MONITOR_OVLD_BUF_POOL_READ_AHEAD_LOGICAL_EVICTED:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_ra_pages_logical_evicted);
+	case MONITOR_OVLD_BUF_POOL_PAGE_TOTAL:
+		return((mon_type_t) buf_pool_get_n_pages());
+	case MONITOR_OVLD_BUF_POOL_PAGES_DATA:
+		buf_get_total_list_len(&LRU_len, &free_len, &flush_list_len);
+		return((mon_type_t) LRU_len);
+	case MONITOR_OVLD_BUF_POOL_PAGES_DIRTY:
+		buf_get_total_list_len(&LRU_len, &free_len, &flush_list_len);
+		return((mon_type_t) flush_list_len);
+	case MONITOR_OVLD_BUF_POOL_PAGES_FREE:
+		buf_get_total_list_len(&LRU_len, &free_len, &flush_list_len);
+		return((mon_type_t) free_len);
+	case MONITOR_OVLD_BUF_POOL_PAGES_FLUSHED:
+		return((mon_type_t) srv_buf_pool_flushed);
+	case MONITOR_OVLD_PAGE_CREATED:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_pages_created);
+	case MONITOR_OVLD_PAGES_WRITTEN:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_pages_written);
+	case MONITOR_OVLD_PAGES_READ:
+		buf_get_total_stat(&stat);
+		return((mon_type_t) stat.n_pages_read);
+
+	case MONITOR_OVLD_LSN_CURRENT:
+		return((mon_type_t) log_sys->lsn);
+	case MONITOR_OVLD_LSN_FLUSHDISK:
+		return((mon_type_t) log_sys->flushed_to_disk_lsn);
+	case MONITOR_OVLD_LSN_CHECKPOINT:
+		return((mon_type_t) log_sys->last_checkpoint_lsn);
+	case MONITOR_OVLD_CHECKPOINT_AGE:
+		return((mon_type_t) (log_sys->lsn
+				     - log_sys->last_checkpoint_lsn));
+	case MONITOR_OVLD_LOG_WAITS:
+		return((mon_type_t) srv_log_waits);
+	case MONITOR_OVLD_LOG_WRITE_REQUEST:
+		return((mon_type_t) srv_log_write_requests);
+	case MONITOR_OVLD_LOG_WRITES:
+		return((mon_type_t) srv_log_writes);
+
+	case MONITOR_OVLD_DEADLOCK:
+		return((mon_type_t) srv_n_lock_deadlock_count);
+	case MONITOR_OVLD_ROW_LOCK_CURRENT_WAIT:
+		return((mon_type_t) srv_n_lock_wait_current_count);
+	case MONITOR_OVLD_ROW_LOCK_WAIT:
+		return((mon_type_t) srv_n_lock_wait_count);
+	case MONITOR_OVLD_LOCK_WAIT_TIME:
+		return((mon_type_t) (srv_n_lock_wait_time / 1000));
+	case MONITOR_OVLD_LOCK_MAX_WAIT_TIME:
+		return((mon_type_t) (srv_n_lock_max_wait_time / 1000));
+
+	case MONITOR_OVLD_PURGE_UNDO_LOG_PAGES:
+		return((mon_type_t) purge_sys->n_pages_handled);
+	case MONITOR_OVLD_RSEG_HISTORY_LEN:
+		return((mon_type_t) trx_sys->rseg_history_len);
+
+	case MONITOR_OVLD_IBUF_MERGES:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t) ibuf_stat.n_merges);
+	case MONITOR_OVLD_IBUF_MERGE_INSERT:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t) ibuf_stat.n_merged_ops[IBUF_OP_INSERT]);
+	case MONITOR_OVLD_IBUF_MERGE_DELETE:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t)
+		       ibuf_stat.n_merged_ops[IBUF_OP_DELETE_MARK]);
+	case MONITOR_OVLD_IBUF_MERGE_PURGE:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t) ibuf_stat.n_merged_ops[IBUF_OP_DELETE]);
+	case MONITOR_OVLD_IBUF_MERGE_DISCARD_INSERT:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t)
+		       ibuf_stat.n_discarded_ops[IBUF_OP_INSERT]);
+	case MONITOR_OVLD_IBUF_MERGE_DISCARD_DELETE:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t)
+		       ibuf_stat.n_discarded_ops[IBUF_OP_DELETE_MARK]);
+	case MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t)
+		       ibuf_stat.n_discarded_ops[IBUF_OP_DELETE]);
+	case MONITOR_OVLD_IBUF_SIZE:
+		ibuf_get_stats(&ibuf_stat);
+		return((mon_type_t) ibuf_stat.size);
+
+	case MONITOR_OVLD_ADAPTIVE_HASH_SEARCH:
+		return((mon_type_t) btr_cur_n_sea);
+	case MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE:
+		return((mon_type_t) btr_cur_n_non_sea);
+
+	case MONITOR_OVLD_OS_FILE_READ:
+		return((mon_type_t) os_n_file_reads);
+	case MONITOR_OVLD_OS_FILE_WRITE:
+		return((mon_type_t) os_n_file_writes);
+	case MONITOR_OVLD_OS_FSYNC:
+		return((mon_type_t) os_n_fsyncs);
+	case MONITOR_OVLD_OS_PENDING_READS:
+		return((mon_type_t) os_n_pending_reads);
+	case MONITOR_OVLD_OS_PENDING_WRITES:
+		return((mon_type_t) os_n_pending_writes);
+	case MONITOR_OVLD_OS_LOG_WRITTEN:
+		return((mon_type_t) srv_os_log_written);
+	case MONITOR_OVLD_OS_LOG_FSYNC:
+		return((mon_type_t) fil_n_log_flushes);
+	case MONITOR_OVLD_OS_LOG_PENDING_FSYNC:
+		return((mon_type_t) fil_n_pending_log_flushes);
+	case MONITOR_OVLD_OS_LOG_PENDING_WRITES:
+		return((mon_type_t) srv_os_log_pending_writes);
+
+	default:
+		ut_error;
+	}
+
+	return(0);
+}
+
+/****************************************************************//**
+Get the value of a counter.  The value of a MONITOR_EXISTING counter
+that is on is refreshed from its status variable.
+@return	value since the counter was turned on, or the current value
+of a MONITOR_DISPLAY_CURRENT counter */
+UNIV_INTERN
+mon_type_t
+srv_mon_get_value(
+/*==============*/
+	monitor_id_t		monitor_id,	/*!< in: counter, not a
+						module */
+	monitor_value_t*	copy)		/*!< out: consistent copy
+						of the values, or NULL */
+{
+	const monitor_info_t*	info = srv_mon_get_info(monitor_id);
+	monitor_value_t*	mon = &innodb_counter_value[monitor_id];
+	ibool			refresh;
+	mon_type_t		existing = 0;
+	mon_type_t		value;
+
+	ut_ad(!(info->monitor_type & MONITOR_MODULE));
+
+	/* Read the status variable before acquiring srv_mon_mutex,
+	because that may acquire other latches. */
+	refresh = (info->monitor_type & MONITOR_EXISTING)
+		&& MONITOR_IS_ON(monitor_id);
+
+	if (refresh) {
+		existing = srv_mon_get_existing(monitor_id);
+	}
+
+	mutex_enter(&srv_mon_mutex);
+
+	if (refresh && MONITOR_IS_ON(monitor_id)) {
+		mon->mon_value = existing - mon->mon_start_value;
+	}
+
+	if (info->monitor_type & MONITOR_DISPLAY_CURRENT) {
+		if (mon->mon_value > mon->mon_max_value) {
+			mon->mon_max_value = mon->mon_value;
+		}
+
+		if (mon->mon_value < mon->mon_min_value) {
+			mon->mon_min_value = mon->mon_value;
+		}
+	}
+
+	value = mon->mon_value;
+
+	if (copy) {
+		*copy = *mon;
+	}
+
+	mutex_exit(&srv_mon_mutex);
+
+	return(value);
+}
+
+/****************************************************************//**
+Turn a counter on or off, or reset its values.  A counter must be off
+for MONITOR_RESET_ALL_VALUE to have any effect. */
+UNIV_INTERN
+void
+srv_mon_set_option(
+/*===============*/
+	monitor_id_t	monitor_id,	/*!< in: counter, not a module */
+	mon_option_t	set_option)	/*!< in: operation */
+{
+	const monitor_info_t*	info = srv_mon_get_info(monitor_id);
+	monitor_value_t*	mon = &innodb_counter_value[monitor_id];
+	mon_type_t		existing = 0;
+	ulint*			bits;
+	ulint			mask;
+
+	ut_a(!(info->monitor_type & MONITOR_MODULE));
+
+	bits = &monitor_set_tbl[monitor_id / MONITOR_BITS_ULINT];
+	mask = (ulint) 1 << (monitor_id % MONITOR_BITS_ULINT);
+
+	/* Read the status variable, or take the final value of an
+	existing counter, before acquiring srv_mon_mutex. */
+	switch (set_option) {
+	case MONITOR_TURN_ON:
+		if (info->monitor_type
+		    & (MONITOR_DISPLAY_CURRENT | MONITOR_EXISTING)) {
+			existing = srv_mon_get_existing(monitor_id);
+		}
+		break;
+	case MONITOR_TURN_OFF:
+	case MONITOR_RESET_VALUE:
+		srv_mon_get_value(monitor_id, NULL);
+		break;
+	case MONITOR_RESET_ALL_VALUE:
+		break;
+	}
+
+	mutex_enter(&srv_mon_mutex);
+
+	switch (set_option) {
+	case MONITOR_TURN_ON:
+		if (*bits & mask) {
+			break;
+		}
+
+		if (info->monitor_type & MONITOR_DISPLAY_CURRENT) {
+			/* A gauge shows the current value. */
+			mon->mon_start_value = 0;
+			mon->mon_value = existing;
+			mon->mon_max_value = mon->mon_value;
+			mon->mon_min_value = mon->mon_value;
+		} else if (info->monitor_type & MONITOR_EXISTING) {
+			/* Continue counting from mon_value. */
+			mon->mon_start_value = existing - mon->mon_value;
+		}
+
+		mon->mon_start_time = ut_time();
+		mon->mon_stop_time = 0;
+		mon->mon_status = MONITOR_STARTED;
+		*bits |= mask;
+		break;
+
+	case MONITOR_TURN_OFF:
+		if (!(*bits & mask)) {
+			break;
+		}
+
+		*bits &= ~mask;
+		mon->mon_stop_time = ut_time();
+		mon->mon_status = MONITOR_STOPPED;
+		break;
+
+	case MONITOR_RESET_VALUE:
+		mon->mon_value_reset = mon->mon_value;
+		mon->mon_max_value = mon->mon_value;
+		mon->mon_min_value = mon->mon_value;
+		mon->mon_reset_time = ut_time();
+		break;
+
+	case MONITOR_RESET_ALL_VALUE:
+		if (*bits & mask) {
+			break;
+		}
+
+		memset(mon, 0, sizeof *mon);
+		break;
+	}
+
+	mutex_exit(&srv_mon_mutex);
+}
+
+/****************************************************************//**
+Apply an operation to all the counters of a module, or to all the
+counters if module_id is NUM_MONITOR. */
+UNIV_INTERN
+void
+srv_mon_set_module_control(
+/*=======================*/
+	monitor_id_t	module_id,	/*!< in: module, or NUM_MONITOR */
+	mon_option_t	set_option)	/*!< in: operation */
+{
+	ulint	i;
+
+	if (module_id == NUM_MONITOR) {
+		i = 0;
+	} else {
+		ut_a(innodb_counter_info[module_id].monitor_type
+		     & MONITOR_MODULE);
+		i = module_id + 1;
+	}
+
+	for (; i < NUM_MONITOR; i++) {
+		if (innodb_counter_info[i].monitor_type & MONITOR_MODULE) {
+			if (module_id != NUM_MONITOR) {
+				/* The next module starts here. */
+				break;
+			}
+
+			continue;
+		}
+
+		srv_mon_set_option((monitor_id_t) i, set_option);
+	}
+}
+#endif /* !UNIV_HOTBACKUP */
@@ -61,6 +61,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "m_string.h" /* for my_sys.h */
 #include "my_sys.h" /* DEBUG_SYNC_C */
 #include "srv0srv.h"
+#include "srv0mon.h"
 
 #include "ut0mem.h"
 #include "ut0ut.h"
@@ -143,6 +144,10 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 UNIV_INTERN my_bool	srv_use_native_aio = TRUE;
 
+/* If this flag is TRUE, then we will submit asynchronous reads and writes
+through io_uring if it is supported, instead of native or simulated aio */
+UNIV_INTERN my_bool	srv_use_io_uring = FALSE;
+
 #ifdef __WIN__
 /* Windows native condition variables. We use runtime loading / function
 pointers, because they are not available on Windows Server 2003 and
@@ -209,11 +214,18 @@ UNIV_INTERN ulint	srv_log_file_size	= ULINT_MAX;
 /* size in database pages */
 UNIV_INTERN ulint	srv_log_buffer_size	= ULINT_MAX;
 UNIV_INTERN ulong	srv_flush_log_at_trx_commit = 1;
+/* Interval in milliseconds at which log_flush_thread() writes and flushes
+the log buffer */
+UNIV_INTERN ulong	srv_flush_log_interval = 1000;
 
 /* Try to flush dirty pages so as to avoid IO bursts at
 the checkpoints. */
 UNIV_INTERN char	srv_adaptive_flushing	= TRUE;
 
+/* Merge the change buffer in ibuf_merge_thread() instead of in the
+master thread. */
+UNIV_INTERN char	srv_ibuf_background_merge = TRUE;
+
 /** Maximum number of times allowed to conditionally acquire
 mutex before switching to blocking wait on the mutex */
 #define MAX_MUTEX_NOWAIT	20
@@ -238,10 +250,15 @@ UNIV_INTERN my_bool	srv_buf_pool_populate	= FALSE;
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
 /** whether or not to flush neighbors of a block */
 UNIV_INTERN my_bool	srv_flush_neighbors	= TRUE;
+/** whether DROP TABLE and TRUNCATE TABLE leave the pages of the dropped
+tablespace in the buffer pool instead of scanning the buffer pool for them */
+UNIV_INTERN my_bool	srv_lazy_drop_table	= TRUE;
 /* previously requested size */
 UNIV_INTERN ulint	srv_buf_pool_old_size;
 /* current size in kilobytes */
 UNIV_INTERN ulint	srv_buf_pool_curr_size	= 0;
+/* size in bytes of the chunks that the buffer pool is resized in */
+UNIV_INTERN ulong	srv_buf_pool_chunk_unit	= 128 * 1024 * 1024;
 /* size in bytes */
 UNIV_INTERN ulint	srv_mem_pool_size	= ULINT_MAX;
 UNIV_INTERN ulint	srv_lock_table_size	= ULINT_MAX;
@@ -439,6 +456,10 @@ UNIV_INTERN my_bool	srv_print_all_deadlocks = FALSE;
 /* Perform deadlock detection check */
 UNIV_INTERN my_bool	srv_deadlock_check = TRUE;
 
+/* The order in which waiting record locks are granted
+(innodb_lock_schedule_algorithm) */
+UNIV_INTERN ulong	srv_lock_schedule_algorithm = SRV_LOCK_SCHEDULE_FCFS;
+
 typedef struct srv_conc_slot_struct	srv_conc_slot_t;
 struct srv_conc_slot_struct{
 	os_event_t			event;		/*!< event to wait */
@@ -477,6 +498,19 @@ UNIV_INTERN ibool	srv_innodb_status	= FALSE;
 this many index pages */
 UNIV_INTERN unsigned long long	srv_stats_sample_pages = 8;
 
+/* If this is TRUE, the index statistics are stored in SYS_STATS and
+recalculated in the background instead of at table open and on row
+changes */
+UNIV_INTERN my_bool	srv_stats_persistent = FALSE;
+
+/* Number of index pages the background statistics thread samples for
+the statistics stored in SYS_STATS */
+UNIV_INTERN ulong	srv_stats_persistent_sample_pages = 20;
+
+/* If this is TRUE, LOAD DATA and INSERT...SELECT into an empty table
+sort the rows and build the index trees bottom-up */
+UNIV_INTERN my_bool	srv_bulk_load = FALSE;
+
 UNIV_INTERN ibool	srv_use_doublewrite_buf	= TRUE;
 UNIV_INTERN ibool	srv_use_checksums = TRUE;
 
@@ -497,10 +531,20 @@ UNIV_INTERN ibool	srv_print_log_io		= FALSE;
 UNIV_INTERN ibool	srv_print_latch_waits		= FALSE;
 #endif /* UNIV_DEBUG */
 
+/** Number of AUTOINC values reserved without the table AUTO-INC lock
+(innodb_autoinc_lock_mode=2) */
+UNIV_INTERN ulint		srv_n_autoinc_reserved		= 0;
+/** Number of reserved AUTOINC values that no row was given before the
+end of the statement */
+UNIV_INTERN ulint		srv_n_autoinc_unused		= 0;
+
 UNIV_INTERN ulint		srv_n_rows_inserted		= 0;
 UNIV_INTERN ulint		srv_n_rows_updated		= 0;
 UNIV_INTERN ulint		srv_n_rows_deleted		= 0;
 UNIV_INTERN ulint		srv_n_rows_read			= 0;
+/** Number of rows of srv_n_rows_read that were served from the
+prefetch cache of a table handle */
+UNIV_INTERN ulint		srv_n_rows_read_cached		= 0;
 
 static ulint	srv_n_rows_inserted_old		= 0;
 static ulint	srv_n_rows_updated_old		= 0;
@@ -511,7 +555,12 @@ UNIV_INTERN ulint		srv_n_lock_wait_count		= 0;
 UNIV_INTERN ulint		srv_n_lock_wait_current_count	= 0;
 UNIV_INTERN ib_int64_t	srv_n_lock_wait_time		= 0;
 UNIV_INTERN ulint		srv_n_lock_max_wait_time	= 0;
+UNIV_INTERN ulint		srv_n_lock_wait_hist[SRV_LOCK_WAIT_HIST_SIZE];
 UNIV_INTERN ulint		srv_n_lock_deadlock_count	= 0;
+UNIV_INTERN ulint		srv_n_lock_deadlock_checks	= 0;
+UNIV_INTERN ulint		srv_n_lock_deadlock_check_steps	= 0;
+UNIV_INTERN ulint		srv_n_lock_deadlock_check_max_steps = 0;
+UNIV_INTERN ulint		srv_n_lock_deadlock_check_aborts = 0;
 
 UNIV_INTERN ulint		srv_truncated_status_writes	= 0;
 
@@ -1587,6 +1636,10 @@ srv_boot(void)
 
 	srv_init();
 
+	/* Initialize the INFORMATION_SCHEMA.INNODB_METRICS counters */
+
+	srv_mon_create();
+
 	return(DB_SUCCESS);
 }
 
@@ -1835,6 +1888,21 @@ srv_suspend_mysql_thread(
 			srv_n_lock_max_wait_time = diff_time;
 		}
 
+		if (start_time != -1 && finish_time != -1) {
+			ulint	i;
+			ulint	limit = 1000;
+
+			for (i = 0; i < SRV_LOCK_WAIT_HIST_SIZE - 1; i++) {
+				if (diff_time < limit) {
+					break;
+				}
+
+				limit *= 10;
+			}
+
+			srv_n_lock_wait_hist[i]++;
+		}
+
 		/* Record the lock wait time for this thread */
 		thd_set_lock_wait_time(trx->mysql_thd, diff_time);
 	}
@@ -1857,6 +1925,8 @@ srv_suspend_mysql_thread(
 	    && wait_time > (double) lock_wait_timeout) {
 
 		trx->error_state = DB_LOCK_WAIT_TIMEOUT;
+
+		MONITOR_INC(MONITOR_TIMEOUT);
 	}
 
 	if (trx_is_interrupted(trx)) {
@@ -2172,6 +2242,12 @@ srv_export_innodb_status(void)
 		= stat.n_ra_pages_read;
 	export_vars.innodb_buffer_pool_read_ahead_evicted
 		= stat.n_ra_pages_evicted;
+	export_vars.innodb_buffer_pool_read_ahead_logical
+		= stat.n_ra_pages_read_logical;
+	export_vars.innodb_buffer_pool_read_ahead_logical_hits
+		= stat.n_ra_pages_logical_hit;
+	export_vars.innodb_buffer_pool_read_ahead_logical_evicted
+		= stat.n_ra_pages_logical_evicted;
 	export_vars.innodb_buffer_pool_pages_data = LRU_len;
 	export_vars.innodb_buffer_pool_bytes_data =
 		buf_pools_list_size.LRU_bytes
@@ -2217,9 +2293,21 @@ srv_export_innodb_status(void)
 		export_vars.innodb_row_lock_time_avg = 0;
 	}
 	export_vars.innodb_lock_deadlocks = srv_n_lock_deadlock_count;
+	export_vars.innodb_lock_deadlock_checks = srv_n_lock_deadlock_checks;
+	export_vars.innodb_lock_deadlock_check_steps
+		= srv_n_lock_deadlock_check_steps;
+	export_vars.innodb_lock_deadlock_check_max_steps
+		= srv_n_lock_deadlock_check_max_steps;
+	export_vars.innodb_lock_deadlock_check_aborts
+		= srv_n_lock_deadlock_check_aborts;
 	export_vars.innodb_row_lock_time_max
 		= srv_n_lock_max_wait_time / 1000;
+	memcpy(export_vars.innodb_row_lock_wait_hist, srv_n_lock_wait_hist,
+	       sizeof export_vars.innodb_row_lock_wait_hist);
+	export_vars.innodb_autoinc_values_reserved = srv_n_autoinc_reserved;
+	export_vars.innodb_autoinc_values_unused = srv_n_autoinc_unused;
 	export_vars.innodb_rows_read = srv_n_rows_read;
+	export_vars.innodb_rows_read_cached = srv_n_rows_read_cached;
 	export_vars.innodb_rows_inserted = srv_n_rows_inserted;
 	export_vars.innodb_rows_updated = srv_n_rows_updated;
 	export_vars.innodb_rows_deleted = srv_n_rows_deleted;
@@ -2264,6 +2352,10 @@ srv_export_innodb_status(void)
 	export_vars.innodb_buffer_pool_LRU_get_free_search
 		= srv_buf_pool_LRU_get_free_search;
 
+	ut_strlcpy(export_vars.innodb_buffer_pool_resize_status,
+		   buf_pool_resize_status,
+		   sizeof(export_vars.innodb_buffer_pool_resize_status));
+
 	export_vars.innodb_mysql_master_log_pos
 		= mysql_master_log_pos;
 	memcpy(export_vars.innodb_mysql_master_log_name,
@@ -2306,6 +2398,7 @@ srv_export_innodb_status(void)
 		srv_conc_n_waiting_threads;
 	export_vars.innodb_btree_row_searches = btr_cur_n_non_sea;
 	export_vars.innodb_hash_row_searches = btr_cur_n_sea;
+	export_vars.innodb_btree_search_restarts = btr_cur_n_restarts;
 
 #ifdef UNIV_DEBUG
 	{
@@ -2901,13 +2994,20 @@ srv_wake_purge_thread(void)
 The master thread is tasked to ensure that flush of log file happens
 once every second in the background. This is to ensure that not more
 than one second of trxs are lost in case of crash when
-innodb_flush_logs_at_trx_commit != 1 */
+innodb_flush_logs_at_trx_commit != 1. While log_flush_thread() runs,
+it does this every innodb_flush_log_interval milliseconds instead. */
 static
 void
 srv_sync_log_buffer_in_background(void)
 /*===================================*/
 {
-	time_t	current_time = time(NULL);
+	time_t	current_time;
+
+	if (log_flush_thread_active) {
+		return;
+	}
+
+	current_time = time(NULL);
 
 	srv_main_thread_op_info = "flushing log";
 	if (difftime(current_time, srv_last_log_flush_time) >= 1) {
@@ -3102,7 +3202,8 @@ loop:
 			+ log_sys->n_pending_writes;
 		n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
 			+ buf_stat.n_pages_written;
-		if (n_pend_ios < SRV_PEND_IO_THRESHOLD
+		if (!srv_ibuf_background_merge
+		    && n_pend_ios < SRV_PEND_IO_THRESHOLD
 		    && (n_ios - n_ios_old < SRV_RECENT_IO_ACTIVITY)) {
 			srv_main_thread_op_info = "doing insert buffer merge";
 			ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
@@ -3218,13 +3319,16 @@ loop:
 	}
 
 	/* We run a batch of insert buffer merge every 10 seconds,
-	even if the server were active */
+	even if the server were active, unless ibuf_merge_thread()
+	does it */
 
-	srv_main_thread_op_info = "doing insert buffer merge";
-	ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
+	if (!srv_ibuf_background_merge) {
+		srv_main_thread_op_info = "doing insert buffer merge";
+		ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
 
-	/* Flush logs if needed */
-	srv_sync_log_buffer_in_background();
+		/* Flush logs if needed */
+		srv_sync_log_buffer_in_background();
+	}
 
 	if (srv_n_purge_threads == 0) {
 		srv_main_thread_op_info = "master purging";
@@ -79,6 +79,7 @@ Created 2/16/1996 Heikki Tuuri
 # include "btr0sea.h"
 # include "rem0cmp.h"
 # include "dict0crea.h"
+# include "dict0stats.h"
 # include "row0ins.h"
 # include "row0sel.h"
 # include "row0upd.h"
@@ -144,6 +145,11 @@ UNIV_INTERN mysql_pfs_key_t	srv_error_monitor_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_monitor_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_master_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_purge_thread_key;
+UNIV_INTERN mysql_pfs_key_t	dict_stats_thread_key;
+UNIV_INTERN mysql_pfs_key_t	log_flush_thread_key;
+UNIV_INTERN mysql_pfs_key_t	buf_resize_thread_key;
+UNIV_INTERN mysql_pfs_key_t	ibuf_merge_thread_key;
+UNIV_INTERN mysql_pfs_key_t	row_import_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 /*********************************************************************//**
@@ -1153,6 +1159,12 @@ innobase_start_or_create_for_mysql(void)
 	ut_print_timestamp(stderr);
 	fputs(" InnoDB: " IB_ATOMICS_STARTUP_MSG "\n", stderr);
 
+#ifdef LINUX_FUTEX
+	ut_print_timestamp(stderr);
+	fputs(" InnoDB: Mutexes and rw_locks wait on Linux futexes\n",
+	      stderr);
+#endif /* LINUX_FUTEX */
+
 	ut_print_timestamp(stderr);
 	fputs(" InnoDB: Compressed tables use zlib " ZLIB_VERSION
 #ifdef UNIV_ZIP_DEBUG
@@ -1234,6 +1246,11 @@ innobase_start_or_create_for_mysql(void)
 
 #endif
 
+#ifndef LINUX_IO_URING
+	/* io_uring is only used when the support is compiled in. */
+	srv_use_io_uring = FALSE;
+#endif /* !LINUX_IO_URING */
+
 	if (srv_file_flush_method_str == NULL) {
 		/* These are the default options */
 
@@ -1868,6 +1885,33 @@ innobase_start_or_create_for_mysql(void)
 		return((int)DB_ERROR);
 	}
 
+	dict_stats_init();
+
+	err = dict_stats_create_or_check_sys_table(srv_stats_persistent);
+
+	if (err != DB_SUCCESS) {
+		return((int)DB_ERROR);
+	}
+
+	/* Create the thread which recalculates persistent statistics */
+	dict_stats_thread_active = TRUE;
+	os_thread_create(&dict_stats_thread, NULL, NULL);
+
+	/* Create the thread which flushes the log at
+	innodb_flush_log_interval */
+	log_flush_thread_active = TRUE;
+	os_thread_create(&log_flush_thread, NULL, NULL);
+
+	/* Create the thread which resizes the buffer pool when
+	innodb_buffer_pool_size is changed */
+	buf_resize_thread_active = TRUE;
+	os_thread_create(&buf_resize_thread, NULL, NULL);
+
+	/* Create the thread which merges the change buffer in the
+	background */
+	ibuf_merge_thread_active = TRUE;
+	os_thread_create(&ibuf_merge_thread, NULL, NULL);
+
 	/* Create the master thread which does purge and other utility
 	operations */
 
@@ -2238,6 +2282,7 @@ innobase_shutdown_for_mysql(void)
 	mutex_free(&srv_monitor_file_mutex);
 	mutex_free(&srv_dict_tmpfile_mutex);
 	mutex_free(&srv_misc_tmpfile_mutex);
+	dict_stats_close();
 	dict_close();
 	btr_search_sys_free();
 
@@ -73,7 +73,11 @@ Instead, now the event that a thread wants to wait on is embedded
 in the wait object (mutex or rw_lock). We still keep the global
 wait array for the sake of diagnostics and also to avoid infinite
 wait The error_monitor thread scans the global wait array to signal
-any waiting threads who have missed the signal. */
+any waiting threads who have missed the signal.
+
+When InnoDB is built with LINUX_FUTEX, the embedded event is a futex,
+and the waiters are suspended on it without reserving a cell in the
+primary wait array, which then stays empty. */
 
 /** A cell where an individual thread may wait suspended
 until a resource is released. The suspending is implemented
@@ -322,7 +326,7 @@ sync_array_validate(
 /*******************************************************************//**
 Returns the event that the thread owning the cell waits for. */
 static
-os_event_t
+sync_event_t*
 sync_cell_get_event(
 /*================*/
 	sync_cell_t*	cell) /*!< in: non-empty sync array cell */
@@ -330,11 +334,12 @@ sync_cell_get_event(
 	ulint type = cell->request_type;
 
 	if (type == SYNC_MUTEX) {
-		return(((mutex_t *) cell->wait_object)->event);
+		return(&((mutex_t *) cell->wait_object)->event);
 	} else if (type == RW_LOCK_WAIT_EX) {
-		return(((rw_lock_t *) cell->wait_object)->wait_ex_event);
-	} else { /* RW_LOCK_SHARED and RW_LOCK_EX wait on the same event */
-		return(((rw_lock_t *) cell->wait_object)->event);
+		return(&((rw_lock_t *) cell->wait_object)->wait_ex_event);
+	} else { /* RW_LOCK_SHARED, RW_LOCK_EX and RW_LOCK_SX wait on the
+		 same event */
+		return(&((rw_lock_t *) cell->wait_object)->event);
 	}
 }
 
@@ -353,7 +358,7 @@ sync_array_reserve_cell(
 	ulint*		index)	/*!< out: index of the reserved cell */
 {
 	sync_cell_t*	cell;
-	os_event_t      event;
+	sync_event_t*	event;
 	ulint		i;
 
 	ut_a(object);
@@ -393,7 +398,7 @@ sync_array_reserve_cell(
 			the value of signal_count at which the event
 			was reset. */
                         event = sync_cell_get_event(cell);
-			cell->signal_count = os_event_reset(event);
+			cell->signal_count = sync_event_reset(event);
 
 			cell->reservation_time = time(NULL);
 
@@ -421,7 +426,7 @@ sync_array_wait_event(
 	ulint		index)	/*!< in: index of the reserved cell */
 {
 	sync_cell_t*	cell;
-	os_event_t	event;
+	sync_event_t*	event;
 
 	ut_a(arr);
 
@@ -455,7 +460,7 @@ sync_array_wait_event(
 #endif
 	sync_array_exit(arr);
 
-	os_event_wait_low(event, cell->signal_count);
+	sync_event_wait(event, cell->signal_count);
 
 	sync_array_free_cell(arr, index);
 }
@@ -504,10 +509,12 @@ sync_array_cell_print(
 
 	} else if (type == RW_LOCK_EX
 		   || type == RW_LOCK_WAIT_EX
+		   || type == RW_LOCK_SX
 		   || type == RW_LOCK_SHARED) {
 
 		fputs(type == RW_LOCK_EX ? "X-lock on"
 		      : type == RW_LOCK_WAIT_EX ? "X-lock (wait_ex) on"
+		      : type == RW_LOCK_SX ? "SX-lock on"
 		      : "S-lock on", file);
 
 		rwlock = cell->old_wait_rw_lock;
@@ -517,7 +524,11 @@ sync_array_cell_print(
 			(void*) rwlock, innobase_basename(rwlock->cfile_name),
 			(ulong) rwlock->cline);
 		writer = rw_lock_get_writer(rwlock);
-		if (writer != RW_LOCK_NOT_LOCKED) {
+		if (writer == RW_LOCK_SX) {
+			/* The sx-lock holder is not recorded */
+			fputs("a writer has reserved it in mode"
+			      " shared exclusive\n", file);
+		} else if (writer != RW_LOCK_NOT_LOCKED) {
 			fprintf(file,
 				"a writer (thread id %lu) has"
 				" reserved it in mode %s",
@@ -696,13 +707,15 @@ sync_array_detect_deadlock(
 			     && !os_thread_eq(thread, cell->thread))
 			    || ((debug->lock_type == RW_LOCK_WAIT_EX)
 				&& !os_thread_eq(thread, cell->thread))
+			    || ((debug->lock_type == RW_LOCK_SX)
+				&& cell->request_type == RW_LOCK_EX)
 			    || (debug->lock_type == RW_LOCK_SHARED)) {
 
 				/* The (wait) x-lock request can block
 				infinitely only if someone (can be also cell
-				thread) is holding s-lock, or someone
-				(cannot be cell thread) (wait) x-lock, and
-				he is blocked by start thread */
+				thread) is holding s-lock or sx-lock, or
+				someone (cannot be cell thread) (wait) x-lock,
+				and he is blocked by start thread */
 
 				ret = sync_array_deadlock_step(
 					arr, start, thread, debug->pass,
@@ -722,6 +735,37 @@ print:
 
 		return(FALSE);
 
+	} else if (cell->request_type == RW_LOCK_SX) {
+
+		lock = cell->wait_object;
+		debug = UT_LIST_GET_FIRST(lock->debug_list);
+
+		while (debug != NULL) {
+
+			thread = debug->thread_id;
+
+			if ((debug->lock_type == RW_LOCK_EX)
+			    || (debug->lock_type == RW_LOCK_WAIT_EX)
+			    || (debug->lock_type == RW_LOCK_SX)) {
+
+				/* The sx-lock request can block infinitely
+				only if someone (can also be cell thread) is
+				holding (wait) x-lock or sx-lock, and he is
+				blocked by start thread */
+
+				ret = sync_array_deadlock_step(
+					arr, start, thread, debug->pass,
+					depth);
+				if (ret) {
+					goto print;
+				}
+			}
+
+			debug = UT_LIST_GET_NEXT(list, debug);
+		}
+
+		return(FALSE);
+
 	} else if (cell->request_type == RW_LOCK_SHARED) {
 
 		lock = cell->wait_object;
@@ -781,11 +825,12 @@ sync_arr_cell_can_wake_up(
 			return(TRUE);
 		}
 
-	} else if (cell->request_type == RW_LOCK_EX) {
+	} else if (cell->request_type == RW_LOCK_EX
+		   || cell->request_type == RW_LOCK_SX) {
 
 		lock = cell->wait_object;
 
-		if (lock->lock_word > 0) {
+		if (lock->lock_word > X_LOCK_HALF_DECR) {
 		/* Either unlocked or only read locked. */
 
 			return(TRUE);
@@ -877,7 +922,7 @@ sync_arr_wake_threads_if_sema_free(void)
 	sync_cell_t*	cell;
 	ulint		count;
 	ulint		i;
-	os_event_t      event;
+	sync_event_t*	event;
 
 	sync_array_enter(arr);
 
@@ -898,7 +943,7 @@ sync_arr_wake_threads_if_sema_free(void)
 
 			event = sync_cell_get_event(cell);
 
-			os_event_set(event);
+			sync_event_set(event);
 		}
 
 	}
@@ -45,15 +45,23 @@ Created 9/11/1995 Heikki Tuuri
 	IMPLEMENTATION OF THE RW_LOCK
 	=============================
 The status of a rw_lock is held in lock_word. The initial value of lock_word is
-X_LOCK_DECR. lock_word is decremented by 1 for each s-lock and by X_LOCK_DECR
-for each x-lock. This describes the lock state for each value of lock_word:
+X_LOCK_DECR. lock_word is decremented by 1 for each s-lock, by X_LOCK_HALF_DECR
+for an sx-lock and by X_LOCK_DECR for each x-lock. This describes the lock
+state for each value of lock_word:
 
 lock_word == X_LOCK_DECR:      Unlocked.
-0 < lock_word < X_LOCK_DECR:   Read locked, no waiting writers.
+X_LOCK_HALF_DECR < lock_word < X_LOCK_DECR:
+			       Read locked, no waiting writers.
 			       (X_LOCK_DECR - lock_word) is the
 			       number of readers that hold the lock.
+lock_word == X_LOCK_HALF_DECR: Shared exclusive locked, no readers.
+0 < lock_word < X_LOCK_HALF_DECR:
+			       Shared exclusive locked, and read locked.
+			       (X_LOCK_HALF_DECR - lock_word) is the
+			       number of readers that hold the lock.
 lock_word == 0:		       Write locked
--X_LOCK_DECR < lock_word < 0:  Read locked, with a waiting writer.
+-X_LOCK_HALF_DECR < lock_word < 0:
+			       Read locked, with a waiting writer.
 			       (-lock_word) is the number of readers
 			       that hold the lock.
 lock_word <= -X_LOCK_DECR:     Recursively write locked. lock_word has been
@@ -108,23 +116,26 @@ waiters:	May be set to 1 anytime, but to avoid unnecessary wake-up
 		verifying lock_word is still held, to ensure some unlocker
 		really does see the flags new value.
 event:		Threads wait on event for read or writer lock when another
-		thread has an x-lock or an x-lock reservation (wait_ex). A
+		thread has an x-lock or an x-lock reservation (wait_ex), and
+		for writer lock when another thread has an sx-lock. A
 		thread may only	wait on event after performing the following
 		actions in order:
-		   (1) Record the counter value of event (with os_event_reset).
+		   (1) Record the counter value of event (with sync_event_reset).
 		   (2) Set waiters to 1.
-		   (3) Verify lock_word <= 0.
+		   (3) Verify lock_word <= 0 for a read lock, or
+		       lock_word <= X_LOCK_HALF_DECR for a writer lock.
 		(1) must come before (2) to ensure signal is not missed.
 		(2) must come before (3) to ensure a signal is sent.
 		These restrictions force the above ordering.
 		Immediately before sending the wake-up signal, we should:
-		   (1) Verify lock_word == X_LOCK_DECR (unlocked)
+		   (1) Verify lock_word == X_LOCK_DECR (unlocked), or
+		       lock_word > X_LOCK_HALF_DECR after an sx-unlock
 		   (2) Reset waiters to 0.
 wait_ex_event:	A thread may only wait on the wait_ex_event after it has
 		performed the following actions in order:
 		   (1) Decrement lock_word by X_LOCK_DECR.
-		   (2) Record counter value of wait_ex_event (os_event_reset,
-                       called from sync_array_reserve_cell).
+		   (2) Record counter value of wait_ex_event (sync_event_reset,
+                       called from sync_wait_reserve).
 		   (3) Verify that lock_word < 0.
 		(1) must come first to ensures no other threads become reader
                 or next writer, and notifies unlocker that signal must be sent.
@@ -292,8 +303,8 @@ rw_lock_create_func(
 	lock->last_x_file_name = "not yet reserved";
 	lock->last_s_line = 0;
 	lock->last_x_line = 0;
-	lock->event = os_event_create(NULL);
-	lock->wait_ex_event = os_event_create(NULL);
+	sync_event_create(&lock->event);
+	sync_event_create(&lock->wait_ex_event);
 
 	mutex_enter(&rw_lock_list_mutex);
 
@@ -323,9 +334,9 @@ rw_lock_free_func(
 #endif /* INNODB_RW_LOCKS_USE_ATOMICS */
 
 	mutex_enter(&rw_lock_list_mutex);
-	os_event_free(lock->event);
+	sync_event_free(&lock->event);
 
-	os_event_free(lock->wait_ex_event);
+	sync_event_free(&lock->wait_ex_event);
 
 	ut_ad(UT_LIST_GET_PREV(list, lock) == NULL
 	      || UT_LIST_GET_PREV(list, lock)->magic_n == RW_LOCK_MAGIC_N);
@@ -360,7 +371,8 @@ rw_lock_validate(
 
 	ut_ad(lock->magic_n == RW_LOCK_MAGIC_N);
 	ut_a(waiters == 0 || waiters == 1);
-	ut_a(lock_word > -X_LOCK_DECR ||(-lock_word) % X_LOCK_DECR == 0);
+	ut_a(lock_word > -X_LOCK_HALF_DECR
+	     || (-lock_word) % X_LOCK_DECR == 0);
 
 	return(TRUE);
 }
@@ -381,7 +393,7 @@ rw_lock_s_lock_spin(
 	const char*	file_name, /*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	ulint	 index;	/* index of the reserved wait cell */
+	sync_wait_t wait;	/* reservation for suspending the thread */
 	ulint	 i = 0;	/* spin round count */
 
 	ut_ad(rw_lock_validate(lock));
@@ -425,17 +437,15 @@ lock_loop:
 
 		rw_s_spin_round_count += i;
 
-		sync_array_reserve_cell(sync_primary_wait_array,
-					lock, RW_LOCK_SHARED,
-					file_name, line,
-					&index);
+		sync_wait_reserve(&wait, &lock->event, lock,
+				  RW_LOCK_SHARED, file_name, line);
 
 		/* Set waiters before checking lock_word to ensure wake-up
                 signal is sent. This may lead to some unnecessary signals. */
 		rw_lock_set_waiter_flag(lock);
 
 		if (TRUE == rw_lock_s_lock_low(lock, pass, file_name, line)) {
-			sync_array_free_cell(sync_primary_wait_array, index);
+			sync_wait_cancel(&wait);
 			return; /* Success */
 		}
 
@@ -453,7 +463,7 @@ lock_loop:
 		lock->count_os_wait++;
 		rw_s_os_wait_count++;
 
-		sync_array_wait_event(sync_primary_wait_array, index);
+		sync_wait_suspend(&wait);
 
 		i = 0;
 		goto lock_loop;
@@ -495,7 +505,7 @@ rw_lock_x_lock_wait(
 	const char*	file_name,/*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	ulint index;
+	sync_wait_t wait;
 	ulint i = 0;
 
 	ut_ad(lock->lock_word <= 0);
@@ -512,11 +522,8 @@ rw_lock_x_lock_wait(
 		/* If there is still a reader, then go to sleep.*/
 		rw_x_spin_round_count += i;
 		i = 0;
-		sync_array_reserve_cell(sync_primary_wait_array,
-					lock,
-					RW_LOCK_WAIT_EX,
-					file_name, line,
-					&index);
+		sync_wait_reserve(&wait, &lock->wait_ex_event, lock,
+				  RW_LOCK_WAIT_EX, file_name, line);
 		/* Check lock_word to ensure wake-up isn't missed.*/
 		if(lock->lock_word < 0) {
 
@@ -532,8 +539,7 @@ rw_lock_x_lock_wait(
 					       file_name, line);
 #endif
 
-			sync_array_wait_event(sync_primary_wait_array,
-					      index);
+			sync_wait_suspend(&wait);
 #ifdef UNIV_SYNC_DEBUG
 			rw_lock_remove_debug_info(lock, pass,
 					       RW_LOCK_WAIT_EX);
@@ -541,8 +547,7 @@ rw_lock_x_lock_wait(
                         /* It is possible to wake when lock_word < 0.
                         We must pass the while-loop check to proceed.*/
 		} else {
-			sync_array_free_cell(sync_primary_wait_array,
-					     index);
+			sync_wait_cancel(&wait);
 		}
 	}
 	rw_x_spin_round_count += i;
@@ -563,7 +568,7 @@ rw_lock_x_lock_low(
 {
 	os_thread_id_t	curr_thread	= os_thread_get_curr_id();
 
-	if (rw_lock_lock_word_decr(lock, X_LOCK_DECR)) {
+	if (rw_lock_lock_word_decr(lock, X_LOCK_DECR, X_LOCK_HALF_DECR)) {
 
 		/* lock->recursive also tells us if the writer_thread
 		field is stale or active. As we are going to write
@@ -621,13 +626,14 @@ rw_lock_x_lock_func(
 	const char*	file_name,/*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	ulint	index;	/*!< index of the reserved wait cell */
+	sync_wait_t wait;	/*!< reservation for suspending the thread */
 	ulint	i;	/*!< spin round count */
 	ibool	spinning = FALSE;
 
 	ut_ad(rw_lock_validate(lock));
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(!rw_lock_own(lock, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SX));
 #endif /* UNIV_SYNC_DEBUG */
 
 	i = 0;
@@ -648,7 +654,7 @@ lock_loop:
 
 		/* Spin waiting for the lock_word to become free */
 		while (i < SYNC_SPIN_ROUNDS
-		       && lock->lock_word <= 0) {
+		       && lock->lock_word <= X_LOCK_HALF_DECR) {
 			if (srv_spin_wait_delay) {
 				ut_delay(ut_rnd_interval(0,
 							 srv_spin_wait_delay));
@@ -674,18 +680,15 @@ lock_loop:
 			(ulong) lock->cline, (ulong) i);
 	}
 
-	sync_array_reserve_cell(sync_primary_wait_array,
-				lock,
-				RW_LOCK_EX,
-				file_name, line,
-				&index);
+	sync_wait_reserve(&wait, &lock->event, lock, RW_LOCK_EX,
+			  file_name, line);
 
 	/* Waiters must be set before checking lock_word, to ensure signal
 	is sent. This could lead to a few unnecessary wake-up signals. */
 	rw_lock_set_waiter_flag(lock);
 
 	if (rw_lock_x_lock_low(lock, pass, file_name, line)) {
-		sync_array_free_cell(sync_primary_wait_array, index);
+		sync_wait_cancel(&wait);
 		return; /* Locking succeeded */
 	}
 
@@ -702,7 +705,140 @@ lock_loop:
 	lock->count_os_wait++;
 	rw_x_os_wait_count++;
 
-	sync_array_wait_event(sync_primary_wait_array, index);
+	sync_wait_suspend(&wait);
+
+	i = 0;
+	goto lock_loop;
+}
+
+/******************************************************************//**
+Low-level function for acquiring a shared exclusive lock. Unlike the
+x-lock, the sx-lock does not wait for the readers to exit, so that no
+wait_ex reservation is made.
+@return	TRUE if success */
+UNIV_INLINE
+ibool
+rw_lock_sx_lock_low(
+/*================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line)	/*!< in: line where requested */
+{
+	if (!rw_lock_lock_word_decr(lock, X_LOCK_HALF_DECR,
+				    X_LOCK_HALF_DECR)) {
+		/* Another thread holds an x-lock or an sx-lock, or is
+		waiting for the readers to exit with an x-lock request */
+		return(FALSE);
+	}
+
+#ifdef UNIV_SYNC_DEBUG
+	rw_lock_add_debug_info(lock, 0, RW_LOCK_SX, file_name, line);
+#endif
+	lock->last_x_file_name = file_name;
+	lock->last_x_line = (unsigned int) line;
+
+	return(TRUE);
+}
+
+/******************************************************************//**
+NOTE! Use the corresponding macro, not directly this function! Lock an
+rw-lock in shared exclusive mode for the current thread. An sx-lock
+excludes other sx-locks and x-locks, but it does not exclude s-locks,
+and it does not wait for the current s-lock holders to exit. If the
+rw-lock is locked in shared exclusive or exclusive mode, or there is an
+exclusive lock request waiting, the function spins a preset time
+(controlled by SYNC_SPIN_ROUNDS), waiting for the lock, before suspending
+the thread. An sx-lock cannot be taken recursively, and a thread that
+holds an sx-lock must not request an x-lock on the same rw-lock. */
+UNIV_INTERN
+void
+rw_lock_sx_lock_func(
+/*=================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line)	/*!< in: line where requested */
+{
+	sync_wait_t wait;	/*!< reservation for suspending the thread */
+	ulint	i;	/*!< spin round count */
+	ibool	spinning = FALSE;
+
+	ut_ad(rw_lock_validate(lock));
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	i = 0;
+
+lock_loop:
+
+	if (rw_lock_sx_lock_low(lock, file_name, line)) {
+		rw_x_spin_round_count += i;
+
+		return;	/* Locking succeeded */
+
+	} else {
+
+		if (!spinning) {
+			spinning = TRUE;
+			rw_x_spin_wait_count++;
+		}
+
+		/* Spin waiting for the writers to exit */
+		while (i < SYNC_SPIN_ROUNDS
+		       && lock->lock_word <= X_LOCK_HALF_DECR) {
+			if (srv_spin_wait_delay) {
+				ut_delay(ut_rnd_interval(0,
+							 srv_spin_wait_delay));
+			}
+
+			i++;
+		}
+		if (i == SYNC_SPIN_ROUNDS) {
+			os_thread_yield();
+		} else {
+			goto lock_loop;
+		}
+	}
+
+	rw_x_spin_round_count += i;
+
+	if (srv_print_latch_waits) {
+		fprintf(stderr,
+			"Thread %lu spin wait rw-sx-lock at %p"
+			" cfile %s cline %lu rnds %lu\n",
+			os_thread_pf(os_thread_get_curr_id()), (void*) lock,
+			innobase_basename(lock->cfile_name),
+			(ulong) lock->cline, (ulong) i);
+	}
+
+	sync_wait_reserve(&wait, &lock->event, lock, RW_LOCK_SX,
+			  file_name, line);
+
+	/* Waiters must be set before checking lock_word, to ensure signal
+	is sent. This could lead to a few unnecessary wake-up signals. */
+	rw_lock_set_waiter_flag(lock);
+
+	if (rw_lock_sx_lock_low(lock, file_name, line)) {
+		sync_wait_cancel(&wait);
+		return; /* Locking succeeded */
+	}
+
+	if (srv_print_latch_waits) {
+		fprintf(stderr,
+			"Thread %lu OS wait for rw-sx-lock at %p"
+			" cfile %s cline %lu\n",
+			os_thread_pf(os_thread_get_curr_id()), (void*) lock,
+			innobase_basename(lock->cfile_name),
+			(ulong) lock->cline);
+	}
+
+	/* these stats may not be accurate */
+	lock->count_os_wait++;
+	rw_x_os_wait_count++;
+
+	sync_wait_suspend(&wait);
 
 	i = 0;
 	goto lock_loop;
@@ -847,7 +983,7 @@ rw_lock_own(
 /*========*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 {
 	rw_lock_debug_t*	info;
 
@@ -887,7 +1023,7 @@ rw_lock_is_locked(
 /*==============*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 {
 	ibool	ret	= FALSE;
 
@@ -902,6 +1038,10 @@ rw_lock_is_locked(
 		if (rw_lock_get_writer(lock) == RW_LOCK_EX) {
 			ret = TRUE;
 		}
+	} else if (lock_type == RW_LOCK_SX) {
+		if (rw_lock_get_writer(lock) == RW_LOCK_SX) {
+			ret = TRUE;
+		}
 	} else {
 		ut_error;
 	}
@@ -1027,6 +1167,8 @@ rw_lock_debug_print(
 		fputs("S-LOCK", f);
 	} else if (rwt == RW_LOCK_EX) {
 		fputs("X-LOCK", f);
+	} else if (rwt == RW_LOCK_SX) {
+		fputs("SX-LOCK", f);
 	} else if (rwt == RW_LOCK_WAIT_EX) {
 		fputs("WAIT X-LOCK", f);
 	} else {
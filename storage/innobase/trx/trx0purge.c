@@ -42,6 +42,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "row0upd.h"
 #include "trx0rec.h"
 #include "srv0srv.h"
+#include "srv0mon.h"
 #include "os0thread.h"
 
 /** The global data structure coordinating a purge */
@@ -1147,6 +1148,17 @@ trx_purge(
 
 	mutex_enter(&kernel_mutex);
 
+	if (purge_sys->n_stop > 0) {
+		/* Purge was stopped by trx_purge_stop() */
+		mutex_exit(&kernel_mutex);
+
+		rw_lock_x_unlock(&purge_sys->latch);
+
+		return(0);
+	}
+
+	purge_sys->running = TRUE;
+
 	/* Close and free the old purge view */
 
 	read_view_close(purge_sys->view);
@@ -1186,12 +1198,18 @@ trx_purge(
 
 #ifdef UNIV_DEBUG
 	if (srv_purge_view_update_only_debug) {
+		mutex_enter(&kernel_mutex);
+		purge_sys->running = FALSE;
+		mutex_exit(&kernel_mutex);
+
 		return(0);
 	}
 #endif
 
 	purge_sys->state = TRX_PURGE_ON;
 
+	MONITOR_INC(MONITOR_PURGE_INVOKED);
+
 	purge_sys->handle_limit = purge_sys->n_pages_handled + limit;
 
 	old_pages_handled = purge_sys->n_pages_handled;
@@ -1212,6 +1230,10 @@ trx_purge(
 
 	que_run_threads(thr);
 
+	mutex_enter(&kernel_mutex);
+	purge_sys->running = FALSE;
+	mutex_exit(&kernel_mutex);
+
 	if (srv_print_thread_releases) {
 
 		fprintf(stderr,
@@ -1222,6 +1244,51 @@ trx_purge(
 	return((ulint) (purge_sys->n_pages_handled - old_pages_handled));
 }
 
+/*******************************************************************//**
+Stops purge and waits for a running purge batch to complete.  Purge
+stays stopped until trx_purge_run() has been called once for each call
+of this function. */
+UNIV_INTERN
+void
+trx_purge_stop(void)
+/*================*/
+{
+	ut_ad(!mutex_own(&kernel_mutex));
+
+	mutex_enter(&kernel_mutex);
+
+	purge_sys->n_stop++;
+
+	while (purge_sys->running) {
+		mutex_exit(&kernel_mutex);
+
+		os_thread_sleep(10000);
+
+		mutex_enter(&kernel_mutex);
+	}
+
+	mutex_exit(&kernel_mutex);
+}
+
+/*******************************************************************//**
+Resumes purge that was stopped by trx_purge_stop(). */
+UNIV_INTERN
+void
+trx_purge_run(void)
+/*===============*/
+{
+	ut_ad(!mutex_own(&kernel_mutex));
+
+	mutex_enter(&kernel_mutex);
+
+	ut_a(purge_sys->n_stop > 0);
+	purge_sys->n_stop--;
+
+	mutex_exit(&kernel_mutex);
+
+	srv_wake_purge_thread();
+}
+
 /******************************************************************//**
 Prints information of the purge system to stderr. */
 UNIV_INTERN
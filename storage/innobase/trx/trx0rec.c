@@ -204,7 +204,9 @@ trx_undo_page_set_next_prev_and_add(
 }
 
 /**********************************************************************//**
-Reports in the undo log of an insert of a clustered index record.
+Reports in the undo log of an insert of a clustered index record, or of
+a bulk insert into an empty table. The latter is one TRX_UNDO_EMPTY record
+without a row reference.
 @return	offset of the inserted entry on the page if succeed, 0 if fail */
 static
 ulint
@@ -214,7 +216,8 @@ trx_undo_page_report_insert(
 	trx_t*		trx,		/*!< in: transaction */
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: index entry which will be
-					inserted to the clustered index */
+					inserted to the clustered index,
+					or NULL for a bulk insert */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	ulint		first_free;
@@ -242,9 +245,16 @@ trx_undo_page_report_insert(
 	ptr += 2;
 
 	/* Store first some general parameters to the undo log */
-	*ptr++ = TRX_UNDO_INSERT_REC;
+	*ptr++ = clust_entry ? TRX_UNDO_INSERT_REC : TRX_UNDO_EMPTY;
 	ptr += mach_ull_write_much_compressed(ptr, trx->undo_no);
 	ptr += mach_ull_write_much_compressed(ptr, index->table->id);
+
+	if (clust_entry == NULL) {
+
+		return(trx_undo_page_set_next_prev_and_add(undo_page, ptr,
+							   mtr));
+	}
+
 	/*----------------------------------------*/
 	/* Store then the fields required to uniquely determine the record
 	to be inserted in the clustered index */
@@ -1183,7 +1193,9 @@ trx_undo_report_row_operation(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: in the case of an insert,
 					index entry to insert into the
-					clustered index, otherwise NULL */
+					clustered index, or NULL for a
+					bulk insert into the empty table
+					(TRX_UNDO_EMPTY); otherwise NULL */
 	const upd_t*	update,		/*!< in: in the case of an update,
 					the update vector, otherwise NULL */
 	ulint		cmpl_info,	/*!< in: compiler info on secondary
@@ -1222,7 +1234,7 @@ trx_undo_report_row_operation(
 
 	ut_ad(thr);
 	ut_ad((op_type != TRX_UNDO_INSERT_OP)
-	      || (clust_entry && !update && !rec));
+	      || (!update && !rec));
 
 	trx = thr_get_trx(thr);
 	rseg = trx->rseg;
@@ -126,8 +126,11 @@ trx_create(
 
 	trx->flush_log_later = FALSE;
 	trx->must_flush_log_later = FALSE;
+	trx->commit_lsn = 0;
 
 	trx->dict_operation = TRX_DICT_OP_NONE;
+
+	trx->deadlock_mark = 0;
 	trx->table_id = 0;
 
 	trx->mysql_thd = NULL;
@@ -1085,7 +1088,8 @@ trx_commit_off_kernel(
 		} else if (srv_flush_log_at_trx_commit == 0) {
 			/* Do nothing */
 		} else if (srv_flush_log_at_trx_commit == 1) {
-			if (srv_unix_file_flush_method == SRV_UNIX_NOSYNC) {
+			if (srv_unix_file_flush_method == SRV_UNIX_NOSYNC
+			    || trx_is_async_commit(trx)) {
 				/* Write the log but do not flush it to disk */
 
 				log_write_up_to(lsn, LOG_WAIT_ONE_GROUP,
@@ -1772,7 +1776,8 @@ trx_commit_complete_for_mysql(
 	} else if (srv_flush_log_at_trx_commit == 0) {
 		/* Do nothing */
 	} else if (srv_flush_log_at_trx_commit == 1) {
-		if (srv_unix_file_flush_method == SRV_UNIX_NOSYNC) {
+		if (srv_unix_file_flush_method == SRV_UNIX_NOSYNC
+		    || trx_is_async_commit(trx)) {
 			/* Write the log but do not flush it to disk */
 
 			log_write_up_to(lsn, LOG_WAIT_ONE_GROUP, FALSE);
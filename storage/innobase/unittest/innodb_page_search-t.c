@@ -0,0 +1,580 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file unittest/innodb_page_search-t.c
+Microbenchmark of page_cur_search_with_match()
+
+An index page is filled in memory with the page and record formats of
+the server, and is searched for random keys with the normalized key of
+the leading integer and binary fields, with the precomputed offsets of
+the leading fixed-length fields, and with neither, so that the
+throughput that they report can be compared.  The page is also scanned
+with and without the precomputed offsets.  The offsets and the search
+results are checked to be the same every way.
+*******************************************************/
+
+#include "univ.i"
+#include "buf0buf.h"
+#include "data0data.h"
+#include "dict0dict.h"
+#include "dict0mem.h"
+#include "mach0data.h"
+#include "mem0mem.h"
+#include "mtr0mtr.h"
+#include "os0sync.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "rem0cmp.h"
+#include "rem0rec.h"
+#include "sync0sync.h"
+#include "ut0mem.h"
+#include "ut0rnd.h"
+#include "ut0ut.h"
+
+#include <tap.h>
+
+/** Number of records on the page */
+#define N_RECS		300
+/** Number of searches of each search benchmark */
+#define N_SEARCHES	2000000
+/** Number of passes over the page of each scan benchmark */
+#define N_SCANS		5000
+/** Number of INT NOT NULL columns after the first three */
+#define N_INT_COLS	8
+
+/** The table of the indexes under test: (a INT NOT NULL, b INT,
+c VARBINARY(20), N_INT_COLS more INT NOT NULL, and f BINARY(8) NOT NULL) */
+static dict_table_t*	test_table;
+
+/*********************************************************************//**
+Creates an index on the columns of test_table.
+@return	index with its fixed-length field offsets computed */
+static
+dict_index_t*
+test_index_create(
+/*==============*/
+	const char*	name,	/*!< in: index name */
+	const ulint*	cols,	/*!< in: column numbers */
+	ulint		n_cols)	/*!< in: number of columns */
+{
+	dict_index_t*	index;
+	ulint		i;
+
+	index = dict_mem_index_create(test_table->name, name, 0,
+				      DICT_UNIQUE, n_cols);
+	index->table = test_table;
+
+	for (i = 0; i < n_cols; i++) {
+		dict_index_add_col(index, test_table,
+				   dict_table_get_nth_col(test_table, cols[i]),
+				   0);
+	}
+
+	index->n_fields = index->n_def;
+	index->n_uniq = 1;
+	/* It is used like an index of the dictionary cache */
+	index->cached = TRUE;
+
+	dict_index_build_fixed_offs(index);
+
+	return(index);
+}
+
+/*********************************************************************//**
+Stores an integer in the stored format of a field of test_table.
+@return	the stored value */
+static
+byte*
+test_field_val(
+/*===========*/
+	const dict_col_t*	col,	/*!< in: INT or BINARY(8) column */
+	ulint			val,	/*!< in: value */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	byte*	buf = mem_heap_alloc(heap, 8);
+
+	if (col->mtype == DATA_INT) {
+		mach_write_to_4(buf, val);
+	} else {
+		mach_write_to_8(buf, ut_ull_create(0, val));
+	}
+
+	return(buf);
+}
+
+/*********************************************************************//**
+Reads the integer that test_field_val() stored in the first field of a
+record.
+@return	the value */
+static
+ulint
+test_rec_val(
+/*=========*/
+	const rec_t*		rec,	/*!< in: record */
+	const dict_index_t*	index)	/*!< in: index */
+{
+	if (dict_index_get_nth_col(index, 0)->mtype == DATA_INT) {
+		return(mach_read_from_4(rec));
+	}
+
+	return((ulint) mach_read_from_8(rec));
+}
+
+/*********************************************************************//**
+Fills a page with N_RECS records of an index, with 2 * i in the first
+field and i in the other INT and BINARY(8) fields. */
+static
+void
+test_page_fill(
+/*===========*/
+	buf_block_t*	block,	/*!< in/out: block of the page */
+	dict_index_t*	index,	/*!< in: index */
+	mem_heap_t*	heap)	/*!< in: memory heap */
+{
+	static const byte	pad[20] = "abcdefghijklmnopqrst";
+	mtr_t		mtr;
+	page_cur_t	cur;
+	ulint		i;
+
+	mtr_start(&mtr);
+	mtr_set_log_mode(&mtr, MTR_LOG_NONE);
+	page_create(block, &mtr, TRUE);
+
+	page_cur_set_before_first(block, &cur);
+
+	for (i = 0; i < N_RECS; i++) {
+		dtuple_t*	tuple;
+		byte*		buf;
+		rec_t*		rec;
+		ulint*		offsets;
+		ulint		j;
+
+		tuple = dtuple_create(heap, dict_index_get_n_fields(index));
+		dict_index_copy_types(tuple, index,
+				      dict_index_get_n_fields(index));
+
+		for (j = 0; j < dict_index_get_n_fields(index); j++) {
+			dfield_t*	field = dtuple_get_nth_field(tuple, j);
+			const dict_col_t* col = dict_index_get_nth_col(
+				index, j);
+
+			if (!(col->prtype & DATA_NOT_NULL) && i % 3 == 0) {
+				dfield_set_null(field);
+			} else if (col->len == 4 || col->len == 8) {
+				dfield_set_data(field, test_field_val(
+							col, j ? i : 2 * i,
+							heap), col->len);
+			} else {
+				dfield_set_data(field, pad, i % 20);
+			}
+		}
+
+		buf = mem_heap_alloc(heap, rec_get_converted_size(
+					     index, tuple, 0));
+		rec = rec_convert_dtuple_to_rec(buf, index, tuple, 0);
+		offsets = rec_get_offsets(rec, index, NULL,
+					  ULINT_UNDEFINED, &heap);
+
+		cur.rec = page_cur_insert_rec_low(cur.rec, index, rec,
+						  offsets, NULL);
+		ut_a(cur.rec);
+	}
+
+	ut_a(page_get_n_recs(buf_block_get_frame(block)) == N_RECS);
+}
+
+/*********************************************************************//**
+Checks that rec_get_offsets() computes the same offsets with and without
+the precomputed offsets of the leading fixed-length fields.
+@return	TRUE if all the offsets were the same */
+static
+ibool
+test_offsets_same(
+/*==============*/
+	const buf_block_t*	block,	/*!< in: page */
+	dict_index_t*		index,	/*!< in/out: index */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	const rec_t*	rec;
+	ulint		n_fixed_prefix = index->n_fixed_prefix;
+
+	for (rec = page_rec_get_next_const(
+		     page_get_infimum_rec(buf_block_get_frame(block)));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next_const(rec)) {
+		ulint*	fast;
+		ulint*	slow;
+
+		fast = rec_get_offsets(rec, index, NULL,
+				       ULINT_UNDEFINED, &heap);
+		index->n_fixed_prefix = 0;
+		slow = rec_get_offsets(rec, index, NULL,
+				       ULINT_UNDEFINED, &heap);
+		index->n_fixed_prefix = (unsigned) n_fixed_prefix;
+
+		if (memcmp(rec_offs_base(fast), rec_offs_base(slow),
+			   (1 + rec_offs_n_fields(fast)) * sizeof *fast)) {
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Creates a search tuple for the first fields of an index.
+@return	search tuple */
+static
+dtuple_t*
+test_tuple_create(
+/*==============*/
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			n_key,	/*!< in: number of fields */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	dtuple_t*	tuple = dtuple_create(heap, n_key);
+	ulint		i;
+
+	dict_index_copy_types(tuple, index, n_key);
+
+	for (i = 0; i < n_key; i++) {
+		const dict_col_t* col = dict_index_get_nth_col(index, i);
+
+		dfield_set_data(dtuple_get_nth_field(tuple, i),
+				mem_heap_alloc(heap, col->len), col->len);
+	}
+
+	return(tuple);
+}
+
+/*********************************************************************//**
+Sets the fields of a search tuple created by test_tuple_create(): k to
+the first field, k / 2 to the others. */
+static
+void
+test_tuple_set(
+/*===========*/
+	dtuple_t*		tuple,	/*!< in/out: search tuple */
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			k)	/*!< in: key */
+{
+	ulint	i;
+
+	for (i = 0; i < dtuple_get_n_fields(tuple); i++) {
+		dfield_t*		field = dtuple_get_nth_field(tuple, i);
+		const dict_col_t*	col = dict_index_get_nth_col(index, i);
+		ulint			val = i ? k / 2 : k;
+
+		if (col->mtype == DATA_INT) {
+			mach_write_to_4(dfield_get_data(field), val);
+		} else {
+			mach_write_to_8(dfield_get_data(field),
+					ut_ull_create(0, val));
+		}
+	}
+}
+
+/*********************************************************************//**
+Searches a page filled by test_page_fill() for random keys, half of
+which are on the page, and reports the throughput.
+@return	TRUE if every search found the right record */
+static
+ibool
+test_search(
+/*========*/
+	const buf_block_t*	block,	/*!< in: page */
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			n_key,	/*!< in: number of fields
+					to search for */
+	const char*		name,	/*!< in: name of the benchmark */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	dtuple_t*	tuple;
+	ibool		found = TRUE;
+	ullint		start;
+	ullint		elapsed;
+	ulint		i;
+
+	tuple = test_tuple_create(index, n_key, heap);
+
+	ut_rnd_set_seed(42);
+
+	start = ut_time_us(NULL);
+
+	for (i = 0; i < N_SEARCHES; i++) {
+		ulint		k = ut_rnd_gen_ulint() % (2 * N_RECS);
+		ulint		up_fields = 0;
+		ulint		up_bytes = 0;
+		ulint		low_fields = 0;
+		ulint		low_bytes = 0;
+		page_cur_t	cur;
+
+		test_tuple_set(tuple, index, k);
+
+		page_cur_search_with_match(block, index, tuple, PAGE_CUR_LE,
+					   &up_fields, &up_bytes,
+					   &low_fields, &low_bytes, &cur);
+
+		if (test_rec_val(page_cur_get_rec(&cur), index)
+		    != (k & ~1UL)) {
+			found = FALSE;
+		}
+	}
+
+	elapsed = ut_time_us(NULL) - start;
+
+	diag("%s: %d searches of a page of %d records in %lu ms,"
+	     " %.0f searches/s",
+	     name, N_SEARCHES, N_RECS, (ulong) (elapsed / 1000),
+	     (double) N_SEARCHES * 1000000 / (elapsed + 1));
+
+	return(found);
+}
+
+/*********************************************************************//**
+Checks that page_cur_search_with_match() positions the cursor on the same
+record and returns the same matched fields and bytes with and without
+the normalized key, for every key on the page and between them, in every
+search mode.
+@return	TRUE if all the searches were the same */
+static
+ibool
+test_norm_same(
+/*===========*/
+	const buf_block_t*	block,	/*!< in: page */
+	dict_index_t*		index,	/*!< in/out: index */
+	ulint			n_key,	/*!< in: number of fields
+					to search for */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	static const ulint	modes[] = {
+		PAGE_CUR_L, PAGE_CUR_LE, PAGE_CUR_G, PAGE_CUR_GE
+	};
+	ulint			n_norm_prefix = index->n_norm_prefix;
+	dtuple_t*		tuple;
+	ulint			k;
+	ulint			m;
+
+	tuple = test_tuple_create(index, n_key, heap);
+
+	for (k = 0; k < 2 * N_RECS + 2; k++) {
+		test_tuple_set(tuple, index, k);
+
+		for (m = 0; m < UT_ARR_SIZE(modes); m++) {
+			ulint		match[2][4];
+			page_cur_t	cur[2];
+			ulint		j;
+
+			for (j = 0; j < 2; j++) {
+				memset(match[j], 0, sizeof match[j]);
+				index->n_norm_prefix = j
+					? 0 : (unsigned) n_norm_prefix;
+
+				page_cur_search_with_match(
+					block, index, tuple, modes[m],
+					&match[j][0], &match[j][1],
+					&match[j][2], &match[j][3],
+					&cur[j]);
+			}
+
+			index->n_norm_prefix = (unsigned) n_norm_prefix;
+
+			if (cur[0].rec != cur[1].rec
+			    || memcmp(match[0], match[1], sizeof match[0])) {
+				return(FALSE);
+			}
+		}
+	}
+
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Determines the offsets of all the fields of every record of a page filled
+by test_page_fill() N_SCANS times, as a scan that converts the records
+does, and reports the throughput.
+@return	sum of the offsets, to compare with another scan */
+static
+ulint
+test_scan(
+/*======*/
+	const buf_block_t*	block,	/*!< in: page */
+	const dict_index_t*	index,	/*!< in: index */
+	const char*		name,	/*!< in: name of the benchmark */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	ulint			offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs_cache_t	offs_cache;
+	ulint			sum = 0;
+	ullint			start;
+	ullint			elapsed;
+	ulint			i;
+
+	rec_offs_init(offsets_);
+	rec_offs_cache_init(&offs_cache, offsets_);
+
+	start = ut_time_us(NULL);
+
+	for (i = 0; i < N_SCANS; i++) {
+		const rec_t*	rec;
+
+		for (rec = page_rec_get_next_const(
+			     page_get_infimum_rec(buf_block_get_frame(block)));
+		     !page_rec_is_supremum(rec);
+		     rec = page_rec_get_next_const(rec)) {
+			const ulint*	offsets;
+
+			offsets = rec_get_offsets_cached(
+				rec, index, &offs_cache,
+				ULINT_UNDEFINED, &heap);
+
+			sum += rec_offs_data_size(offsets);
+		}
+	}
+
+	elapsed = ut_time_us(NULL) - start;
+
+	diag("%s: %d scans of a page of %d records in %lu ms,"
+	     " %.0f records/s",
+	     name, N_SCANS, N_RECS, (ulong) (elapsed / 1000),
+	     (double) N_SCANS * N_RECS * 1000000 / (elapsed + 1));
+
+	return(sum);
+}
+
+/*********************************************************************//**
+Runs the benchmarks of one index with and without the normalized key and
+the precomputed offsets of its leading fixed-length fields. */
+static
+void
+test_index(
+/*=======*/
+	const char*	name,	/*!< in: index name */
+	const ulint*	cols,	/*!< in: column numbers */
+	ulint		n_cols,	/*!< in: number of columns */
+	ulint		n_key,	/*!< in: number of fields to
+				search for */
+	ulint		n_fixed,/*!< in: expected n_fixed_prefix */
+	ulint		n_norm)	/*!< in: expected n_norm_prefix */
+{
+	dict_index_t*	index;
+	mem_heap_t*	heap;
+	byte*		buf;
+	buf_block_t	block;
+	char		bench[80];
+	ulint		sum;
+
+	index = test_index_create(name, cols, n_cols);
+
+	ok(index->n_fixed_prefix == n_fixed && index->n_norm_prefix == n_norm,
+	   "%s: %lu leading fixed-length fields, %lu in the normalized key",
+	   name, (ulong) index->n_fixed_prefix,
+	   (ulong) index->n_norm_prefix);
+
+	heap = mem_heap_create(UNIV_PAGE_SIZE);
+	buf = ut_malloc(2 * UNIV_PAGE_SIZE);
+
+	/* A page outside the buffer pool, like a page of a sort buffer */
+	memset(&block, 0, sizeof block);
+	block.page.state = BUF_BLOCK_MEMORY;
+	block.frame = ut_align(buf, UNIV_PAGE_SIZE);
+	memset(block.frame, 0, UNIV_PAGE_SIZE);
+
+	test_page_fill(&block, index, heap);
+
+	ok(test_offsets_same(&block, index, heap),
+	   "%s: precomputed offsets are the same as computed ones", name);
+
+	ok(test_norm_same(&block, index, n_key, heap),
+	   "%s: searches with the normalized key are the same", name);
+
+	ut_snprintf(bench, sizeof bench, "%s, normalized key", name);
+	ok(test_search(&block, index, n_key, bench, heap),
+	   "%s: all keys found with the normalized key", name);
+
+	index->n_norm_prefix = 0;
+	ut_snprintf(bench, sizeof bench, "%s, precomputed offsets", name);
+	ok(test_search(&block, index, n_key, bench, heap),
+	   "%s: all keys found with precomputed offsets", name);
+	sum = test_scan(&block, index, bench, heap);
+
+	index->n_fixed_prefix = 0;
+	ut_snprintf(bench, sizeof bench, "%s, computed offsets", name);
+	ok(test_search(&block, index, n_key, bench, heap),
+	   "%s: all keys found with computed offsets", name);
+	ok(test_scan(&block, index, bench, heap) == sum,
+	   "%s: scans saw the same record sizes", name);
+
+	ut_free(buf);
+	mem_heap_free(heap);
+	dict_mem_index_free(index);
+}
+
+int
+main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
+{
+	static const ulint	fixed_cols[] = {3 + N_INT_COLS, 3, 4, 5, 6, 7, 8, 9, 10};
+	static const ulint	mixed_cols[] = {0, 1, 2, 3};
+	mem_heap_t*		heap;
+	ulint			i;
+
+	plan(14);
+
+	ut_mem_init();
+	os_sync_init();
+	sync_init();
+	mem_init(1024 * 1024);
+	dict_ind_init();
+
+	/* The column names are allocated from heap */
+	heap = mem_heap_create(256);
+
+	test_table = dict_mem_table_create("test/t", 0, 4 + N_INT_COLS,
+					   DICT_TF_COMPACT);
+	dict_mem_table_add_col(test_table, heap, "a", DATA_INT,
+			       DATA_NOT_NULL | DATA_UNSIGNED, 4);
+	dict_mem_table_add_col(test_table, heap, "b", DATA_INT,
+			       DATA_UNSIGNED, 4);
+	dict_mem_table_add_col(test_table, heap, "c", DATA_BINARY, 0, 20);
+
+	for (i = 0; i < N_INT_COLS; i++) {
+		char	col_name[8];
+
+		ut_snprintf(col_name, sizeof col_name, "i%lu", (ulong) i);
+		dict_mem_table_add_col(test_table, heap, col_name, DATA_INT,
+				       DATA_NOT_NULL | DATA_UNSIGNED, 4);
+	}
+
+	dict_mem_table_add_col(test_table, heap, "f", DATA_FIXBINARY,
+			       DATA_NOT_NULL, 8);
+
+	/* Only fixed-length binary and integer fields: the offsets of
+	all the records of the page are the same, and the whole key is
+	compared as one byte string */
+	test_index("fixed", fixed_cols, 1 + N_INT_COLS, 1 + N_INT_COLS,
+		   1 + N_INT_COLS, 1 + N_INT_COLS);
+	/* A fixed-length field followed by a nullable and a
+	variable-length one */
+	test_index("mixed", mixed_cols, 4, 1, 1, 1);
+
+	dict_mem_table_free(test_table);
+	mem_heap_free(heap);
+
+	return(exit_status());
+}
@@ -0,0 +1,267 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file unittest/innodb_sync-t.c
+Microbenchmark of contended InnoDB mutexes and rw-locks
+
+The test is built once for the sync wait array and once for Linux futexes,
+so that the throughput that they report can be compared.  The latches are
+held by the main thread while the worker threads start, so that the workers
+also go through the suspend and wake-up path.
+*******************************************************/
+
+#include "univ.i"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "sync0rw.h"
+#include "sync0sync.h"
+#include "ut0mem.h"
+#include "ut0ut.h"
+
+#include <tap.h>
+
+/** Number of worker threads */
+#define N_THREADS	8
+/** Number of latch acquisitions of each worker thread */
+#define N_ROUNDS	200000
+/** Every how many rw-lock acquisitions are exclusive */
+#define X_EVERY		8
+/** Every how many rw-lock acquisitions are shared exclusive */
+#define SX_EVERY	16
+
+/** The mutex under test */
+static mutex_t		test_mutex;
+/** The rw-lock under test */
+static rw_lock_t	test_lock;
+/** Counter protected by test_mutex or by an x-latch on test_lock */
+static ulint		test_count;
+/** Counter protected by an sx-latch on test_lock */
+static ulint		test_sx_count;
+/** Sum of test_count values seen under an s-latch, to keep the reads */
+static ulint		test_s_sum;
+
+/** Wait primitive that the latches were built with */
+#ifdef LINUX_FUTEX
+# define TEST_WAIT_NAME	"futex"
+#else /* LINUX_FUTEX */
+# define TEST_WAIT_NAME	"sync array"
+#endif /* LINUX_FUTEX */
+
+/*********************************************************************//**
+Acquires and releases test_mutex N_ROUNDS times.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+test_mutex_thread(
+/*==============*/
+	void*	arg)	/*!< in: unused */
+{
+	ulint	i;
+
+	UT_NOT_USED(arg);
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		mutex_enter(&test_mutex);
+		test_count++;
+		mutex_exit(&test_mutex);
+	}
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Acquires and releases test_lock N_ROUNDS times, in a mix of s, sx and x
+modes.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+test_rw_lock_thread(
+/*================*/
+	void*	arg)	/*!< in: unused */
+{
+	ulint	i;
+	ulint	sum	= 0;
+
+	UT_NOT_USED(arg);
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		if (i % X_EVERY == 0) {
+			rw_lock_x_lock(&test_lock);
+			test_count++;
+			rw_lock_x_unlock(&test_lock);
+		} else if (i % SX_EVERY == 1) {
+			rw_lock_sx_lock(&test_lock);
+			test_sx_count++;
+			rw_lock_sx_unlock(&test_lock);
+		} else {
+			rw_lock_s_lock(&test_lock);
+			sum += test_count;
+			rw_lock_s_unlock(&test_lock);
+		}
+	}
+
+	mutex_enter(&test_mutex);
+	test_s_sum += sum;
+	mutex_exit(&test_mutex);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Starts the worker threads. */
+static
+void
+test_start_threads(
+/*===============*/
+	os_posix_f_t	func)	/*!< in: thread function */
+{
+	ulint	i;
+
+	for (i = 0; i < N_THREADS; i++) {
+		os_thread_create(func, NULL, NULL);
+	}
+
+	/* Let the workers spin and suspend themselves. */
+	os_thread_sleep(100000);
+}
+
+/*********************************************************************//**
+Waits for the worker threads to exit and reports their throughput.
+@return	elapsed time in microseconds */
+static
+ullint
+test_wait_threads(
+/*==============*/
+	const char*	name,	/*!< in: name of the latch */
+	ullint		start)	/*!< in: ut_time_us() when released */
+{
+	ullint	elapsed;
+
+	for (;;) {
+		ulint	n;
+
+		os_mutex_enter(os_sync_mutex);
+		n = os_thread_count;
+		os_mutex_exit(os_sync_mutex);
+
+		if (n == 0) {
+			break;
+		}
+
+		os_thread_sleep(1000);
+	}
+
+	elapsed = ut_time_us(NULL) - start;
+
+	diag("%s (%s): %d threads x %d rounds in %lu ms, %.0f ops/s",
+	     name, TEST_WAIT_NAME, N_THREADS, N_ROUNDS,
+	     (ulong) (elapsed / 1000),
+	     (double) N_THREADS * N_ROUNDS * 1000000 / (elapsed + 1));
+
+	return(elapsed);
+}
+
+/*********************************************************************//**
+Runs the contended mutex benchmark. */
+static
+void
+test_mutex_throughput(void)
+/*=======================*/
+{
+	ullint	start;
+
+	mutex_create(PFS_NOT_INSTRUMENTED, &test_mutex, SYNC_NO_ORDER_CHECK);
+	test_count = 0;
+
+	mutex_enter(&test_mutex);
+	test_start_threads(test_mutex_thread);
+	start = ut_time_us(NULL);
+	mutex_exit(&test_mutex);
+
+	test_wait_threads("mutex", start);
+
+	ok(test_count == (ulint) N_THREADS * N_ROUNDS,
+	   "mutex: all %lu acquisitions were exclusive", (ulong) test_count);
+	ok(test_mutex.count_os_wait > 0,
+	   "mutex: waiters were suspended and woken");
+}
+
+/*********************************************************************//**
+Runs the contended rw-lock benchmark. */
+static
+void
+test_rw_lock_throughput(void)
+/*=========================*/
+{
+	ullint		start;
+	ib_int64_t	os_waits = rw_s_os_wait_count + rw_x_os_wait_count;
+	ulint		n_x = (N_ROUNDS + X_EVERY - 1) / X_EVERY;
+	ulint		n_sx = 0;
+	ulint		i;
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		n_sx += i % X_EVERY != 0 && i % SX_EVERY == 1;
+	}
+
+	rw_lock_create(PFS_NOT_INSTRUMENTED, &test_lock, SYNC_NO_ORDER_CHECK);
+	test_count = 0;
+	test_sx_count = 0;
+	test_s_sum = 0;
+
+	rw_lock_x_lock(&test_lock);
+	test_start_threads(test_rw_lock_thread);
+	start = ut_time_us(NULL);
+	rw_lock_x_unlock(&test_lock);
+
+	test_wait_threads("rw_lock", start);
+
+	ok(test_count == N_THREADS * n_x,
+	   "rw_lock: all %lu x-latches were exclusive", (ulong) test_count);
+	ok(test_sx_count == N_THREADS * n_sx,
+	   "rw_lock: all %lu sx-latches were exclusive",
+	   (ulong) test_sx_count);
+	ok(rw_s_os_wait_count + rw_x_os_wait_count > os_waits,
+	   "rw_lock: waiters were suspended and woken");
+
+	rw_lock_free(&test_lock);
+}
+
+int
+main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
+{
+	plan(5);
+
+	ut_mem_init();
+	os_sync_init();
+	sync_init();
+
+	test_mutex_throughput();
+	test_rw_lock_throughput();
+
+	mutex_free(&test_mutex);
+
+	sync_close();
+	os_sync_free();
+
+	return(exit_status());
+}
@@ -0,0 +1,229 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file unittest/stub_innodb_page.c
+Definitions that the page search code needs from the rest of InnoDB
+and from the server, for innodb_page_search-t.c
+*******************************************************/
+
+#include "univ.i"
+#include "buf0buf.h"
+#include "buf0lru.h"
+#include "fil0fil.h"
+#include "ha_prototypes.h"
+#include "lock0lock.h"
+#include "mach0data.h"
+#include "os0proc.h"
+#include "page0zip.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "trx0sys.h"
+
+#include <string.h>
+#include <unistd.h>
+
+UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
+UNIV_INTERN ulint	srv_max_n_threads	= 1000;
+UNIV_INTERN ulong	srv_n_spin_wait_rounds	= 30;
+UNIV_INTERN ulong	srv_spin_wait_delay	= 6;
+UNIV_INTERN enum srv_shutdown_state	srv_shutdown_state = SRV_SHUTDOWN_NONE;
+UNIV_INTERN const byte*	srv_latin1_ordering;
+UNIV_INTERN ibool	trx_doublewrite_buf_is_being_created = FALSE;
+UNIV_INTERN buf_pool_t*	buf_pool_ptr;
+#ifdef UNIV_DEBUG
+UNIV_INTERN ulint	srv_buf_pool_instances	= 1;
+#endif /* UNIV_DEBUG */
+
+UNIV_INTERN
+ulint
+os_proc_get_number(void)
+/*====================*/
+{
+	return((ulint) getpid());
+}
+
+const char*
+innobase_basename(
+/*==============*/
+	const char*	path_name)
+{
+	const char*	name = strrchr(path_name, '/');
+
+	return(name ? name + 1 : path_name);
+}
+
+/* Only binary strings and integers are used: they have no character set. */
+UNIV_INTERN
+void
+innobase_get_cset_width(
+/*====================*/
+	ulint	cset,
+	ulint*	mbminlen,
+	ulint*	mbmaxlen)
+{
+	UT_NOT_USED(cset);
+
+	*mbminlen = *mbmaxlen = 0;
+}
+
+UNIV_INTERN
+int
+innobase_mysql_cmp(
+/*===============*/
+	int			mysql_type,
+	uint			charset_number,
+	const unsigned char*	a,
+	unsigned int		a_length,
+	const unsigned char*	b,
+	unsigned int		b_length)
+{
+	UT_NOT_USED(mysql_type);
+	UT_NOT_USED(charset_number);
+	UT_NOT_USED(a);
+	UT_NOT_USED(a_length);
+	UT_NOT_USED(b);
+	UT_NOT_USED(b_length);
+
+	ut_error;
+
+	return(0);
+}
+
+UNIV_INTERN
+ulint
+lock_get_size(void)
+/*===============*/
+{
+	return(256);
+}
+
+UNIV_INTERN
+void
+fil_page_set_type(
+/*==============*/
+	byte*	page,
+	ulint	type)
+{
+	mach_write_to_2(page + FIL_PAGE_TYPE, type);
+}
+
+/* The pages are not compressed, and the memory heaps are not of the
+buffer pool type. */
+
+UNIV_INTERN
+void
+page_zip_rec_set_owned(
+/*===================*/
+	page_zip_des_t*	page_zip,
+	const byte*	rec,
+	ulint		flag)
+{
+	UT_NOT_USED(page_zip);
+	UT_NOT_USED(rec);
+	UT_NOT_USED(flag);
+
+	ut_error;
+}
+
+UNIV_INTERN
+void
+page_zip_write_header_log(
+/*======================*/
+	const byte*	data,
+	ulint		length,
+	mtr_t*		mtr)
+{
+	UT_NOT_USED(data);
+	UT_NOT_USED(length);
+	UT_NOT_USED(mtr);
+
+	ut_error;
+}
+
+#if defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
+/* Only buf_frame_get_page_zip() asks, and no page has a compressed
+copy. */
+UNIV_INTERN
+buf_block_t*
+buf_block_align(
+/*============*/
+	const byte*	ptr)
+{
+	static buf_block_t	block;
+
+	UT_NOT_USED(ptr);
+
+	return(&block);
+}
+#endif /* UNIV_DEBUG || UNIV_ZIP_DEBUG */
+
+#ifdef UNIV_DEBUG
+/* The mini-transactions are not logged. */
+UNIV_INTERN
+ibool
+mtr_memo_contains_page(
+/*===================*/
+	mtr_t*		mtr,
+	const byte*	ptr,
+	ulint		type)
+{
+	UT_NOT_USED(mtr);
+	UT_NOT_USED(ptr);
+	UT_NOT_USED(type);
+
+	return(TRUE);
+}
+#endif /* UNIV_DEBUG */
+
+UNIV_INTERN
+buf_block_t*
+buf_block_alloc(
+/*============*/
+	buf_pool_t*	buf_pool)
+{
+	UT_NOT_USED(buf_pool);
+
+	ut_error;
+
+	return(NULL);
+}
+
+UNIV_INTERN
+void
+buf_LRU_block_free_non_file_page(
+/*=============================*/
+	buf_block_t*	block)
+{
+	UT_NOT_USED(block);
+
+	ut_error;
+}
+
+UNIV_INTERN
+void
+buf_page_print(
+/*===========*/
+	const byte*	read_buf,
+	ulint		zip_size,
+	ulint		flags)
+{
+	UT_NOT_USED(read_buf);
+	UT_NOT_USED(zip_size);
+	UT_NOT_USED(flags);
+}
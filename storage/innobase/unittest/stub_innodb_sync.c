@@ -0,0 +1,134 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file unittest/stub_innodb_sync.c
+Definitions that the latch implementation needs from the rest of InnoDB
+and from the server, for innodb_sync-t.c
+*******************************************************/
+
+#include "univ.i"
+#include "ha_prototypes.h"
+#include "mem0mem.h"
+#include "os0file.h"
+#include "os0proc.h"
+#include "srv0srv.h"
+
+#include <string.h>
+#include <unistd.h>
+
+UNIV_INTERN ulint	srv_fatal_semaphore_wait_threshold = 600;
+UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
+UNIV_INTERN ulint	srv_max_n_threads	= 1000;
+UNIV_INTERN ulong	srv_n_spin_wait_rounds	= 30;
+UNIV_INTERN ulong	srv_spin_wait_delay	= 6;
+UNIV_INTERN ibool	srv_print_innodb_monitor = FALSE;
+UNIV_INTERN os_event_t	srv_lock_timeout_thread_event;
+#ifdef UNIV_DEBUG
+UNIV_INTERN ibool	srv_print_latch_waits	= FALSE;
+#endif /* UNIV_DEBUG */
+
+UNIV_INTERN ulint	os_file_n_pending_preads  = 0;
+UNIV_INTERN ulint	os_file_n_pending_pwrites = 0;
+
+UNIV_INTERN
+ulint
+os_proc_get_number(void)
+/*====================*/
+{
+	return((ulint) getpid());
+}
+
+UNIV_INTERN
+mem_block_t*
+mem_heap_create_block(
+/*==================*/
+	mem_heap_t*	heap,
+	ulint		n,
+	ulint		type,
+	const char*	file_name,
+	ulint		line)
+{
+	UT_NOT_USED(heap);
+	UT_NOT_USED(n);
+	UT_NOT_USED(type);
+	UT_NOT_USED(file_name);
+	UT_NOT_USED(line);
+
+	ut_error;
+
+	return(NULL);
+}
+
+UNIV_INTERN
+mem_block_t*
+mem_heap_add_block(
+/*===============*/
+	mem_heap_t*	heap,
+	ulint		n)
+{
+	UT_NOT_USED(heap);
+	UT_NOT_USED(n);
+
+	ut_error;
+
+	return(NULL);
+}
+
+#ifdef UNIV_DEBUG
+UNIV_INTERN
+ibool
+mem_heap_check(
+/*===========*/
+	mem_heap_t*	heap)
+{
+	ut_a(heap->magic_n == MEM_BLOCK_MAGIC_N);
+
+	return(TRUE);
+}
+#endif /* UNIV_DEBUG */
+
+const char*
+innobase_basename(
+/*==============*/
+	const char*	path_name)
+{
+	const char*	name = strrchr(path_name, '/');
+
+	return(name ? name + 1 : path_name);
+}
+
+char*
+innobase_convert_name(
+/*==================*/
+	char*		buf,
+	ulint		buflen,
+	const char*	id,
+	ulint		idlen,
+	void*		thd,
+	ibool		table_id)
+{
+	ulint	len = ut_min(buflen, idlen);
+
+	UT_NOT_USED(thd);
+	UT_NOT_USED(table_id);
+
+	memcpy(buf, id, len);
+
+	return(buf + len);
+}
@@ -0,0 +1,320 @@
+/*****************************************************************************
+
+Copyright (c) 2014, Twitter, Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file ut/ut0lz.c
+Fast LZ77 block compression
+*******************************************************/
+
+#include "ut0lz.h"
+#include "ut0mem.h"
+
+/** Minimum length of a match */
+#define UT_LZ_MIN_MATCH		4
+
+/** Number of bits in the hash of UT_LZ_MIN_MATCH bytes */
+#define UT_LZ_HASH_BITS		12
+
+/** A nibble value that is continued in the following bytes */
+#define UT_LZ_NIBBLE_MAX	15
+
+/** Position in a block; blocks are at most UT_LZ_MAX_LEN bytes */
+typedef unsigned short	ut_lz_pos_t;
+
+/**********************************************************************//**
+Reads UT_LZ_MIN_MATCH bytes.
+@return	the bytes as an integer */
+UNIV_INLINE
+ib_uint32_t
+ut_lz_read(
+/*=======*/
+	const byte*	p)	/*!< in: pointer to the bytes */
+{
+	ib_uint32_t	v;
+
+	memcpy(&v, p, sizeof v);
+
+	return(v);
+}
+
+/**********************************************************************//**
+Hashes UT_LZ_MIN_MATCH bytes.
+@return	hash value */
+UNIV_INLINE
+ulint
+ut_lz_hash(
+/*=======*/
+	const byte*	p)	/*!< in: pointer to the bytes */
+{
+	ib_uint32_t	v = ut_lz_read(p) * 2654435761U;
+
+	return((v >> (32 - UT_LZ_HASH_BITS)) & ((1 << UT_LZ_HASH_BITS) - 1));
+}
+
+/**********************************************************************//**
+Writes the continuation bytes of a length that did not fit in a nibble.
+@return	end of the written bytes, or NULL if they did not fit */
+UNIV_INLINE
+byte*
+ut_lz_write_len(
+/*============*/
+	byte*		op,	/*!< out: output buffer */
+	const byte*	oend,	/*!< in: end of the output buffer */
+	ulint		len)	/*!< in: length minus UT_LZ_NIBBLE_MAX */
+{
+	for (; len >= 255; len -= 255) {
+		if (op >= oend) {
+			return(NULL);
+		}
+		*op++ = 255;
+	}
+
+	if (op >= oend) {
+		return(NULL);
+	}
+
+	*op++ = (byte) len;
+
+	return(op);
+}
+
+/**********************************************************************//**
+Writes a sequence of literals, optionally followed by a match.
+@return	end of the written sequence, or NULL if it did not fit */
+static
+byte*
+ut_lz_write_seq(
+/*============*/
+	byte*		op,	/*!< out: output buffer */
+	const byte*	oend,	/*!< in: end of the output buffer */
+	const byte*	lit,	/*!< in: literals */
+	ulint		n_lit,	/*!< in: number of literals */
+	ulint		dist,	/*!< in: distance of the match,
+				or 0 if none */
+	ulint		match)	/*!< in: length of the match */
+{
+	byte*	token;
+	ulint	m;
+
+	if (op >= oend) {
+		return(NULL);
+	}
+
+	token = op++;
+
+	if (n_lit >= UT_LZ_NIBBLE_MAX) {
+		*token = UT_LZ_NIBBLE_MAX << 4;
+		op = ut_lz_write_len(op, oend, n_lit - UT_LZ_NIBBLE_MAX);
+
+		if (op == NULL) {
+			return(NULL);
+		}
+	} else {
+		*token = (byte) (n_lit << 4);
+	}
+
+	if ((ulint) (oend - op) < n_lit) {
+		return(NULL);
+	}
+
+	memcpy(op, lit, n_lit);
+	op += n_lit;
+
+	if (!dist) {
+		return(op);
+	}
+
+	if (oend - op < 2) {
+		return(NULL);
+	}
+
+	*op++ = (byte) dist;
+	*op++ = (byte) (dist >> 8);
+
+	m = match - UT_LZ_MIN_MATCH;
+
+	if (m >= UT_LZ_NIBBLE_MAX) {
+		*token |= UT_LZ_NIBBLE_MAX;
+		op = ut_lz_write_len(op, oend, m - UT_LZ_NIBBLE_MAX);
+	} else {
+		*token |= (byte) m;
+	}
+
+	return(op);
+}
+
+/**********************************************************************//**
+Compresses a block.
+@return	size of the compressed block, or 0 if it did not fit in dst_len */
+UNIV_INTERN
+ulint
+ut_lz_compress(
+/*===========*/
+	const byte*	src,	/*!< in: uncompressed data */
+	ulint		src_len,/*!< in: size of src, at most UT_LZ_MAX_LEN */
+	byte*		dst,	/*!< out: compressed block */
+	ulint		dst_len)/*!< in: size of dst */
+{
+	ut_lz_pos_t	table[1 << UT_LZ_HASH_BITS];
+	const byte*	ip	= src;
+	const byte*	anchor	= src;
+	const byte*	iend	= src + src_len;
+	byte*		op	= dst;
+	const byte*	oend	= dst + dst_len;
+
+	ut_ad(src_len <= UT_LZ_MAX_LEN);
+
+	/* A zero entry may point to a mismatch or to itself;
+	both cases are rejected below. */
+	memset(table, 0, sizeof table);
+
+	while (iend - ip >= UT_LZ_MIN_MATCH) {
+		ulint		h	= ut_lz_hash(ip);
+		const byte*	ref	= src + table[h];
+		const byte*	p;
+
+		table[h] = (ut_lz_pos_t) (ip - src);
+
+		if (ref >= ip || ut_lz_read(ref) != ut_lz_read(ip)) {
+			ip++;
+			continue;
+		}
+
+		for (p = ip + UT_LZ_MIN_MATCH;
+		     p < iend && *p == ref[p - ip]; p++) {
+		}
+
+		op = ut_lz_write_seq(op, oend, anchor, ip - anchor,
+				     ip - ref, p - ip);
+
+		if (op == NULL) {
+			return(0);
+		}
+
+		ip = anchor = p;
+
+		/* Index a position inside the match, so that
+		repeated patterns are found again. */
+		if (iend - ip >= UT_LZ_MIN_MATCH) {
+			table[ut_lz_hash(ip - 2)]
+				= (ut_lz_pos_t) (ip - 2 - src);
+		}
+	}
+
+	op = ut_lz_write_seq(op, oend, anchor, iend - anchor, 0, 0);
+
+	return(op ? (ulint) (op - dst) : 0);
+}
+
+/**********************************************************************//**
+Reads the continuation bytes of a length.
+@return	FALSE if the input ended */
+UNIV_INLINE
+ibool
+ut_lz_read_len(
+/*===========*/
+	const byte**	ip,	/*!< in/out: input */
+	const byte*	iend,	/*!< in: end of input */
+	ulint*		len)	/*!< in/out: length */
+{
+	ulint	b;
+
+	do {
+		if (*ip >= iend) {
+			return(FALSE);
+		}
+
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return(TRUE);
+}
+
+/**********************************************************************//**
+Decompresses a block.  The input is validated, so that corrupted data
+cannot cause reads or writes outside the buffers.
+@return	size of the uncompressed data, or ULINT_UNDEFINED if the block
+is corrupted or does not fit in dst_len */
+UNIV_INTERN
+ulint
+ut_lz_decompress(
+/*=============*/
+	const byte*	src,	/*!< in: compressed block */
+	ulint		src_len,/*!< in: size of src */
+	byte*		dst,	/*!< out: uncompressed data */
+	ulint		dst_len)/*!< in: size of dst */
+{
+	const byte*	ip	= src;
+	const byte*	iend	= src + src_len;
+	byte*		op	= dst;
+	const byte*	oend	= dst + dst_len;
+
+	while (ip < iend) {
+		ulint		token	= *ip++;
+		ulint		len	= token >> 4;
+		ulint		dist;
+		const byte*	ref;
+
+		if (len == UT_LZ_NIBBLE_MAX
+		    && !ut_lz_read_len(&ip, iend, &len)) {
+			return(ULINT_UNDEFINED);
+		}
+
+		if ((ulint) (iend - ip) < len || (ulint) (oend - op) < len) {
+			return(ULINT_UNDEFINED);
+		}
+
+		memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		if (ip == iend) {
+			/* The last sequence has no match. */
+			break;
+		}
+
+		if (iend - ip < 2) {
+			return(ULINT_UNDEFINED);
+		}
+
+		dist = ip[0] | (ulint) ip[1] << 8;
+		ip += 2;
+
+		len = token & UT_LZ_NIBBLE_MAX;
+
+		if (len == UT_LZ_NIBBLE_MAX
+		    && !ut_lz_read_len(&ip, iend, &len)) {
+			return(ULINT_UNDEFINED);
+		}
+
+		len += UT_LZ_MIN_MATCH;
+
+		if (!dist || dist > (ulint) (op - dst)
+		    || (ulint) (oend - op) < len) {
+			return(ULINT_UNDEFINED);
+		}
+
+		/* The match may overlap the output. */
+		for (ref = op - dist; len--; ) {
+			*op++ = *ref++;
+		}
+	}
+
+	return(op - dst);
+}
@@ -736,6 +736,10 @@ ut_get_strerr(
 		return("Table is being used in foreign key check");
 	case DB_IDENTIFIER_TOO_LONG:
 		return("Identifier name is too long");
+	case DB_SCHEMA_MISMATCH:
+		return("Schema mismatch");
+	case DB_IO_ERROR:
+		return("I/O error");
 	/* do not add default: in order to produce a warning if new code
 	is added to the enum but not added here */
 	}